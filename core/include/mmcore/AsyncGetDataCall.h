@@ -0,0 +1,148 @@
+/*
+ * AsyncGetDataCall.h
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "mmcore/AbstractGetDataCall.h"
+#include "mmcore/api/MegaMolCore.std.h"
+#include "mmcore/factories/CallDescription.h"
+
+namespace megamol {
+namespace core {
+
+/**
+ * Non-blocking execution of a call function of an AbstractGetDataCall.
+ *
+ * Request() starts the call functions and returns immediately. Calls which
+ * may leave the graph thread (see CallScheduler::IsBackgroundSafe) are
+ * executed on a worker thread owned by this object, all others are executed
+ * synchronously, so OpenGL calls and sources which are not prepared for
+ * concurrent access stay on the calling thread. Update() collects a finished
+ * request: the answer of the call is copied into a snapshot call, which is
+ * available via LastComplete() until the next request completes. The
+ * snapshot takes over the unlocker of the answer, and the unlocker of the
+ * replaced snapshot is called, so sources using unlockers keep the data of
+ * the snapshot alive while newer data is computed.
+ */
+class MEGAMOLCORE_API AsyncGetDataCall {
+public:
+    /** Ctor. */
+    AsyncGetDataCall(void);
+
+    /** Dtor. Waits for a pending request and stops the worker thread. */
+    ~AsyncGetDataCall(void);
+
+    /**
+     * Answer whether a request has been started which has not been collected
+     * by Update() yet.
+     *
+     * @return 'true' if a request is pending.
+     */
+    inline bool IsPending(void) const {
+        return this->result.valid();
+    }
+
+    /**
+     * Answer whether a pending request has finished and can be collected by
+     * Update() without blocking.
+     *
+     * @return 'true' if the pending request is ready.
+     */
+    bool IsReady(void) const;
+
+    /**
+     * Answer the snapshot of the last successfully completed request.
+     *
+     * @return The snapshot or 'nullptr' if no request completed yet.
+     */
+    inline AbstractGetDataCall* LastComplete(void) const {
+        return this->lastComplete.get();
+    }
+
+    /**
+     * Starts call functions, which are executed in the given order until
+     * one fails. The call must be prepared (frame ID, etc.) beforehand and
+     * must not be used by the caller until the request has been collected
+     * by Update().
+     *
+     * @param call The call to execute. Must be owned by a shared pointer,
+     *             which is kept while the request is pending, for the
+     *             request to run in the background.
+     * @param funcs The indices of the call functions.
+     * @param desc The description of the call class, used to create the
+     *             snapshot.
+     *
+     * @return 'true' if the request was started, 'false' if a request is
+     *         still pending.
+     */
+    bool Request(
+        AbstractGetDataCall& call, const std::vector<unsigned int>& funcs, factories::CallDescription::ptr desc);
+
+    /**
+     * Releases the snapshot after waiting for a pending request, which is
+     * discarded.
+     */
+    void Reset(void);
+
+    /**
+     * Collects the pending request if it has finished.
+     *
+     * @return 'true' if a request completed successfully and the snapshot
+     *         has been replaced.
+     */
+    bool Update(void);
+
+    /**
+     * Waits for the pending request and collects it.
+     *
+     * @return 'true' if a request completed successfully and the snapshot
+     *         has been replaced.
+     */
+    bool Wait(void);
+
+private:
+    /** The loop of the worker thread */
+    void work(void);
+
+    /** The return value of the pending call functions */
+    std::future<bool> result;
+
+    /** The call of the pending request */
+    std::shared_ptr<Call> call;
+
+    /** The description of the call class */
+    factories::CallDescription::ptr desc;
+
+    /** The answer of the last completed request */
+    std::unique_ptr<AbstractGetDataCall> lastComplete;
+
+    /** The background request to be picked up by the worker thread */
+    std::packaged_task<bool(void)> job;
+
+    /** Guards 'job' and 'terminate' */
+    std::mutex jobLock;
+
+    /** Wakes the worker thread */
+    std::condition_variable jobReady;
+
+    /** Flag stopping the worker thread */
+    bool terminate;
+
+    /** The worker thread, started with the first background request */
+    std::thread worker;
+};
+
+} /* end namespace core */
+} /* end namespace megamol */
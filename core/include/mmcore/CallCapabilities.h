@@ -19,7 +19,8 @@ public:
         REQUIRES_OPENCL = 1 << 2,
         REQUIRES_OPTIX = 1 << 3,
         REQUIRES_OSPRAY = 1 << 4,
-        REQUIRES_VULKAN = 1 << 5
+        REQUIRES_VULKAN = 1 << 5,
+        REQUIRES_THREAD_AFFINITY = 1 << 6 // must be called on the thread that created the graph
     };
 
     void RequireOpenGL();
@@ -28,6 +29,7 @@ public:
     void RequireOptiX();
     void RequireOSPRay();
     void RequireVulkan();
+    void RequireThreadAffinity();
 
     bool OpenGLRequired() const;
     bool CUDARequired() const;
@@ -35,6 +37,10 @@ public:
     bool OptiXRequired() const;
     bool OSPRayRequired() const;
     bool VulkanRequired() const;
+    bool ThreadAffinityRequired() const;
+
+    // no requirements at all, i.e. the call may be executed on any thread
+    bool CPUOnly() const;
 
 private:
     uint64_t cap_bits = 0;
@@ -0,0 +1,97 @@
+/*
+ * CallScheduler.h
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "mmcore/api/MegaMolCore.std.h"
+
+namespace megamol {
+namespace core {
+
+class Call;
+
+/**
+ * Executes a batch of upstream calls of a module, e.g. the GetData calls of
+ * several data inputs, concurrently where this is safe.
+ *
+ * The part of the module graph upstream of each call is collected by
+ * following the caller slots of the called modules. Calls whose subtrees
+ * only contain calls without capability requirements (see CallCapabilities)
+ * and modules which support background calls (see
+ * Module::SupportsBackgroundCalls), which share no module with the subtree
+ * of any other call of the batch, and which do not lead back to a calling
+ * module, run as tasks of a work-stealing thread pool. The OpenMP threads
+ * are split between these tasks. All other calls run in order on the
+ * calling thread, so OpenGL and other thread-bound calls stay where they
+ * were, and stop at the first failing call.
+ * Threads waiting for a batch execute pending tasks meanwhile and sleep
+ * otherwise, so batches issued from inside concurrently executed subtrees
+ * cannot deadlock.
+ *
+ * Concurrent execution is opt-in. While disabled, Run() issues the calls
+ * one after the other, exactly like calling them directly.
+ */
+class MEGAMOLCORE_API CallScheduler {
+public:
+    /** A call function to be executed */
+    struct Request {
+        /** The call to execute */
+        Call* call = nullptr;
+
+        /** The index of the call function */
+        unsigned int func = 0;
+
+        /** Receives the return value of the call function */
+        bool result = false;
+    };
+
+    /**
+     * Answer whether calls are executed concurrently.
+     *
+     * @return 'true' if concurrent execution is enabled.
+     */
+    static bool IsEnabled(void);
+
+    /**
+     * Answer whether a call may be executed on a worker thread, i.e. the
+     * call and all calls upstream of it have no capability requirements and
+     * all modules upstream of it support background calls.
+     *
+     * @param call The call to test.
+     *
+     * @return 'true' if the call may leave the graph thread.
+     */
+    static bool IsBackgroundSafe(Call& call);
+
+    /**
+     * Executes all requested call functions and waits for them to finish.
+     * The calls must be prepared (frame ID, etc.) beforehand, exactly as for
+     * calling them directly.
+     *
+     * @param requests The call functions to execute. Receive the results.
+     *
+     * @return 'true' if all call functions returned 'true'.
+     */
+    static bool Run(std::vector<Request>& requests);
+
+    /**
+     * Enables or disables concurrent execution.
+     *
+     * @param enabled The new state.
+     */
+    static void SetEnabled(bool enabled);
+
+private:
+    /** Forbidden ctor. */
+    CallScheduler(void) = delete;
+};
+
+} /* end namespace core */
+} /* end namespace megamol */
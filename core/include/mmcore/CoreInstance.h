@@ -52,6 +52,7 @@
 #include "vislib/sys/DynamicLinkLibrary.h"
 #include "vislib/sys/Lockable.h"
 
+#include <atomic>
 #include <filesystem>
 #include <functional>
 #include <memory>
@@ -1330,8 +1331,8 @@ private:
     /** the time offset */
     double timeOffset;
 
-    /** the count of rendered frames */
-    uint32_t frameID;
+    /** the count of rendered frames, read by calls executed in the background */
+    std::atomic<uint32_t> frameID{0};
 
 #ifdef REMOVE_GRAPH
     /** List of registered param update listeners */
@@ -3,6 +3,8 @@
 #include <functional>
 #include <list>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "CommandRegistry.h"
@@ -116,6 +118,9 @@ private:
 
     bool delete_call(CallDeletionRequest_t const& request);
 
+    // keeps call_index_ in sync with call_list_, e.g. after renaming call endpoints
+    void rebuild_call_index();
+
 
     // the dummy_namespace must be above the call_list_ and module_list_ because it needs to be destroyed AFTER all
     // calls and modules during ~MegaMolGraph()
@@ -127,6 +132,13 @@ private:
     /** List of call that this graph owns */
     CallList_t call_list_;
 
+    // name lookup indices into module_list_ and call_list_, updated on add, delete and rename.
+    // calls are keyed by lower case "from\nto", parameters by their full name as requested.
+    // the parameter index is a cache filled on lookup and dropped when modules are deleted or renamed.
+    std::unordered_map<std::string, ModuleList_t::iterator> module_index_;
+    std::unordered_map<std::string, CallList_t::iterator> call_index_;
+    mutable std::unordered_map<std::string, std::pair<Module*, param::ParamSlot*>> param_index_;
+
     megamol::frontend_resources::FrontendResourcesLookup provided_resources_lookup;
 
     // for each View in the MegaMol graph we create a EntryPoint
@@ -129,6 +129,23 @@ public:
      */
     AbstractSlot* FindSlot(const vislib::StringA& name);
 
+    /**
+     * Answer whether the call functions of this module may be executed on
+     * a worker thread while the graph thread continues, i.e. concurrently
+     * to parameter updates and to calls of other callers. Overwrite if
+     * your module guards its state accordingly and uses no thread bound
+     * resources. Parameters must then only be read by their update
+     * callbacks, which run on the thread setting the value, e.g. to copy
+     * the values for the call functions under a lock.
+     *
+     * This default implementation returns 'false'
+     *
+     * @return Whether or not this module supports background calls.
+     */
+    virtual bool SupportsBackgroundCalls(void) const {
+        return false;
+    }
+
     template<class S>
     std::vector<S*> GetSlots();
 
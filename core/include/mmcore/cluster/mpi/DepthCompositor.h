@@ -0,0 +1,98 @@
+/*
+ * DepthCompositor.h
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#ifdef WITH_MPI
+#include <mpi.h>
+#endif /* WITH_MPI */
+
+#include <cstddef>
+#include <cstdint>
+
+#include "mmcore/api/MegaMolCore.std.h"
+#include "mmcore/view/CPUFramebuffer.h"
+
+namespace megamol {
+namespace core {
+namespace cluster {
+namespace mpi {
+
+/**
+ * Sort-last depth compositing of opaque RGBA8 colour and float depth images
+ * on the CPU.
+ *
+ * The images of all ranks are composited with binary-swap: in each of the
+ * log2(p) rounds every rank exchanges half of its current image span with a
+ * partner and keeps the nearer pixels of the other half. Each rank sends
+ * and receives roughly one image in total, independent of the number of
+ * ranks. If the number of ranks is no power of two, pairs of neighbouring
+ * ranks first fold their images until a power of two remains. Finally, the
+ * spans are gathered at the root, so only one composited image leaves the
+ * communicator.
+ *
+ * Pixels of equal depth are taken from the lowest rank, so the result does
+ * not depend on the timing of the ranks. utils/depthcompositor checks the
+ * result against a brute-force reference.
+ */
+class MEGAMOLCORE_API DepthCompositor {
+public:
+    /**
+     * Composites the pixels of a second image into a first one, keeping the
+     * pixels with the smaller depth.
+     *
+     * @param color       The colours of the first image, receives the result.
+     * @param depth       The depths of the first image, receives the result.
+     * @param otherColor  The colours of the second image.
+     * @param otherDepth  The depths of the second image.
+     * @param count       The number of pixels.
+     * @param otherOnTies Take the pixel of the second image if the depths are equal.
+     */
+    static void Blend(uint32_t* color, float* depth, uint32_t const* otherColor, float const* otherDepth,
+        size_t count, bool otherOnTies);
+
+#ifdef WITH_MPI
+    /**
+     * Composites the images of all ranks of a communicator. Must be called
+     * collectively with images of the same size.
+     *
+     * @param comm   The communicator.
+     * @param color  The colours of the local image, receives the composited
+     *               image at the root. The content is undefined on the other
+     *               ranks afterwards.
+     * @param depth  The depths of the local image, receives the composited
+     *               depths at the root.
+     * @param count  The number of pixels.
+     * @param root   The rank receiving the composited image.
+     *
+     * @return 'true' on success, 'false' if an MPI operation failed.
+     */
+    static bool Composite(MPI_Comm comm, uint32_t* color, float* depth, size_t count, int root = 0);
+
+    /**
+     * Composites the framebuffers of all ranks of a communicator. Must be
+     * called collectively with framebuffers of the same size.
+     *
+     * @param comm The communicator.
+     * @param fb   The local framebuffer, receives the composited image at
+     *             the root.
+     * @param root The rank receiving the composited image.
+     *
+     * @return 'true' on success, 'false' if an MPI operation failed or the
+     *         framebuffer is incomplete.
+     */
+    static bool Composite(MPI_Comm comm, view::CPUFramebuffer& fb, int root = 0);
+#endif /* WITH_MPI */
+
+    DepthCompositor(void) = delete;
+};
+
+} /* end namespace mpi */
+} /* end namespace cluster */
+} /* end namespace core */
+} /* end namespace megamol */
@@ -0,0 +1,214 @@
+/*
+ * BlockBitPacker.h
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace megamol {
+namespace core {
+namespace utility {
+
+/**
+ * Bit packer for streams of mostly small unsigned values, e.g. zigzag coded
+ * residuals of a predictor.
+ *
+ * The values of each stream are split into blocks of 'BlockSize' values,
+ * and every value of a block is stored with the bit width of the largest
+ * one. Blocks never span two streams. As each block only needs its width
+ * and its offset, the blocks are unpacked with vectorized loops.
+ *
+ * Layout of 's' streams of 'n' values each:
+ *   uint8    bit widths of the blocks of all streams [s * BlockCount(n)]
+ *   ...      packed values of all streams, padded by 'Padding' zero bytes
+ *
+ * The padding lets every value be read and written as one unaligned 64 bit
+ * word.
+ */
+class BlockBitPacker {
+public:
+    /** The number of values sharing one bit width */
+    static constexpr size_t BlockSize = 16;
+
+    /** The zero bytes after the packed values */
+    static constexpr size_t Padding = 8;
+
+    /** The largest bit width, the zigzag code of a difference of two 32 bit values */
+    static constexpr uint8_t MaxWidth = 33;
+
+    /**
+     * Maps a signed value to an unsigned one, small magnitudes to small
+     * values.
+     *
+     * @param v The signed value.
+     *
+     * @return The zigzag code of 'v'.
+     */
+    static inline uint64_t ZigZag(int64_t v) {
+        return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+    }
+
+    /**
+     * Inverse of 'ZigZag'.
+     *
+     * @param z The zigzag code.
+     *
+     * @return The signed value.
+     */
+    static inline int64_t UnZigZag(uint64_t z) {
+        return static_cast<int64_t>(z >> 1) ^ -static_cast<int64_t>(z & 1);
+    }
+
+    /**
+     * Answer the number of blocks of a stream.
+     *
+     * @param count The number of values of the stream.
+     *
+     * @return The number of blocks.
+     */
+    static inline size_t BlockCount(size_t count) {
+        return (count + BlockSize - 1) / BlockSize;
+    }
+
+    /**
+     * Computes the bit widths of the blocks.
+     *
+     * @param values  The values of all streams, one stream after the other.
+     *                Each value must fit into 'MaxWidth' bits.
+     * @param count   The number of values per stream.
+     * @param streams The number of streams.
+     * @param widths  Receives the widths of the blocks, must hold
+     *                'streams * BlockCount(count)' bytes.
+     *
+     * @return The size of the packed data in bytes, including the widths and
+     *         the padding.
+     */
+    static size_t Measure(uint64_t const* values, size_t count, size_t streams, uint8_t* widths) {
+        const size_t blocks = BlockCount(count);
+        size_t bits = 0;
+        for (size_t b = 0; b < streams * blocks; ++b) {
+            const size_t first = (b / blocks) * count + (b % blocks) * BlockSize;
+            const size_t n = blockLength(b % blocks, count);
+            uint64_t all = 0;
+            for (size_t i = first; i < first + n; ++i) {
+                all |= values[i];
+            }
+            widths[b] = bitWidth(all);
+            bits += widths[b] * n;
+        }
+        return streams * blocks + (bits + 7) / 8 + Padding;
+    }
+
+    /**
+     * Packs the values.
+     *
+     * @param values  The values of all streams, one stream after the other.
+     * @param count   The number of values per stream.
+     * @param streams The number of streams.
+     * @param widths  The widths of the blocks as computed by 'Measure'.
+     * @param size    The size answered by 'Measure'.
+     * @param out     Receives the packed data, must hold 'size' bytes.
+     */
+    static void Pack(
+        uint64_t const* values, size_t count, size_t streams, uint8_t const* widths, size_t size, char* out) {
+        const size_t blocks = BlockCount(count);
+        std::memcpy(out, widths, streams * blocks);
+        char* packed = out + streams * blocks;
+        std::memset(packed, 0, size - streams * blocks);
+        size_t pos = 0;
+        for (size_t b = 0; b < streams * blocks; ++b) {
+            const size_t first = (b / blocks) * count + (b % blocks) * BlockSize;
+            const size_t n = blockLength(b % blocks, count);
+            for (size_t i = first; i < first + n; ++i) {
+                // at most 33 + 7 bit, one unaligned 64 bit word
+                uint64_t word;
+                std::memcpy(&word, packed + pos / 8, sizeof(word));
+                word |= values[i] << (pos % 8);
+                std::memcpy(packed + pos / 8, &word, sizeof(word));
+                pos += widths[b];
+            }
+        }
+    }
+
+    /**
+     * Unpacks the values and reverses the zigzag code.
+     *
+     * @param in      The packed data.
+     * @param size    The number of bytes available at 'in'.
+     * @param count   The number of values per stream.
+     * @param streams The number of streams.
+     * @param values  Receives the values of all streams, one stream after
+     *                the other, must hold 'streams * count' values.
+     *
+     * @return The size of the packed data in bytes, 0 if the widths are
+     *         invalid or the data is truncated.
+     */
+    template<class T>
+    static size_t Unpack(char const* in, size_t size, size_t count, size_t streams, T* values) {
+        const size_t blocks = BlockCount(count);
+        if (size < streams * blocks + Padding) {
+            return 0;
+        }
+        auto const widths = reinterpret_cast<uint8_t const*>(in);
+        size_t bits = 0;
+        for (size_t b = 0; b < streams * blocks; ++b) {
+            if (widths[b] > MaxWidth) {
+                return 0;
+            }
+            bits += widths[b] * blockLength(b % blocks, count);
+        }
+        const size_t total = streams * blocks + (bits + 7) / 8 + Padding;
+        if (total > size) {
+            return 0;
+        }
+
+        char const* packed = in + streams * blocks;
+        size_t pos = 0;
+        for (size_t b = 0; b < streams * blocks; ++b) {
+            const uint8_t w = widths[b];
+            const uint64_t mask = (uint64_t(1) << w) - 1;
+            const size_t n = blockLength(b % blocks, count);
+            T* block = values + (b / blocks) * count + (b % blocks) * BlockSize;
+#pragma omp simd
+            for (size_t i = 0; i < n; ++i) {
+                const size_t p = pos + i * w;
+                uint64_t word;
+                std::memcpy(&word, packed + p / 8, sizeof(word));
+                block[i] = static_cast<T>(UnZigZag((word >> (p % 8)) & mask));
+            }
+            pos += w * n;
+        }
+        return total;
+    }
+
+private:
+    /** Answer the number of values in block 'b' of a stream with 'count' values */
+    static inline size_t blockLength(size_t b, size_t count) {
+        return std::min(BlockSize, count - b * BlockSize);
+    }
+
+    /** Answer the number of significant bits of 'v' */
+    static inline uint8_t bitWidth(uint64_t v) {
+        uint8_t w = 0;
+        while (v != 0) {
+            v >>= 1;
+            ++w;
+        }
+        return w;
+    }
+
+    /** Forbidden ctor, the packer only has static members */
+    BlockBitPacker(void) = delete;
+};
+
+} // namespace utility
+} // namespace core
+} // namespace megamol
@@ -315,7 +315,8 @@ public:
      * Loads the whole file as ASCII text into the buffer and builds up
      * the array of lines for accessing the data. The current position in
      * 'file' is irrelevant. The file will not be closed, but the position
-     * within will be undefined.
+     * within will be undefined. A MemmappedFile is copied from a single
+     * sequential view (see MemmappedFile::View).
      *
      * @param file The file to be loaded
      * @param elements The elements to be parsed.
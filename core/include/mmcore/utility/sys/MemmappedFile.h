@@ -38,6 +38,140 @@ namespace sys {
  */
 class MEGAMOLCORE_API MemmappedFile : public File {
 public:
+    /**
+     * Possible access pattern hints forwarded to the operating system for
+     * mapped regions (madvise on linux, PrefetchVirtualMemory on Windows).
+     */
+    enum AccessHint {
+        HINT_NORMAL,     // no special treatment
+        HINT_SEQUENTIAL, // the region will be read front to back (aggressive readahead)
+        HINT_RANDOM,     // the region will be accessed randomly (no readahead)
+        HINT_WILLNEED    // the region will be needed soon (prefetch immediately)
+    };
+
+    /**
+     * A read-only, contiguous range of the file contents that directly points
+     * into a mapping of its own. The range stays valid ("pinned") until the
+     * view is destroyed or released, independent of any subsequent Read,
+     * Seek, or SetViewSize calls on the file object, and even after the file
+     * has been closed. Views can only be moved, not copied.
+     */
+    class MEGAMOLCORE_API ConstView {
+    public:
+        /** Ctor. Creates an empty view. */
+        ConstView(void);
+
+        /**
+         * Move ctor.
+         *
+         * @param rhs The view to take over. It will be empty afterwards.
+         */
+        ConstView(ConstView&& rhs);
+
+        /** Dtor. Unmaps the underlying region. */
+        ~ConstView(void);
+
+        /**
+         * Move assignment.
+         *
+         * @param rhs The view to take over. It will be empty afterwards.
+         *
+         * @return *this.
+         */
+        ConstView& operator=(ConstView&& rhs);
+
+        /**
+         * Answer the first byte of the view.
+         *
+         * @return Pointer to the first byte, NULL if the view is empty.
+         */
+        inline const char* Data(void) const {
+            return this->data;
+        }
+
+        /**
+         * Answer whether the view does not contain any data.
+         *
+         * @return true if the view is empty, false otherwise.
+         */
+        inline bool IsEmpty(void) const {
+            return (this->size == 0);
+        }
+
+        /**
+         * Answer the position of the first byte of the view in the file.
+         *
+         * @return The file offset of the view in bytes.
+         */
+        inline File::FileSize Offset(void) const {
+            return this->offset;
+        }
+
+        /**
+         * Answer the number of bytes in the view.
+         *
+         * @return The size of the view in bytes.
+         */
+        inline File::FileSize Size(void) const {
+            return this->size;
+        }
+
+        /**
+         * Apply an access hint to the whole view.
+         *
+         * @param hint The expected access pattern.
+         */
+        void Advise(const AccessHint hint) const;
+
+        /** Unmaps the region. The view is empty afterwards. */
+        void Release(void);
+
+        /** Begin iterator for range-based for loops. */
+        inline const char* begin(void) const {
+            return this->data;
+        }
+
+        /** End iterator for range-based for loops. */
+        inline const char* end(void) const {
+            return this->data + this->size;
+        }
+
+    private:
+        /** MemmappedFile is the only one creating non-empty views. */
+        friend class MemmappedFile;
+
+        /**
+         * Ctor.
+         *
+         * @param base       The start of the (aligned) mapping.
+         * @param mappedSize The size of the mapping in bytes.
+         * @param offset     The file offset of the first visible byte.
+         * @param size       The number of visible bytes.
+         */
+        ConstView(char* base, SIZE_T mappedSize, File::FileSize offset, File::FileSize size);
+
+        /** Forbidden copy ctor. */
+        ConstView(const ConstView& rhs) = delete;
+
+        /** Forbidden copy assignment. */
+        ConstView& operator=(const ConstView& rhs) = delete;
+
+        /** The aligned start of the mapping */
+        char* base;
+
+        /** The size of the mapping starting at base */
+        SIZE_T mappedSize;
+
+        /** The first visible byte */
+        const char* data;
+
+        /** The file offset of the first visible byte */
+        File::FileSize offset;
+
+        /** The number of visible bytes */
+        File::FileSize size;
+    };
+
     /** Ctor. */
     MemmappedFile(void);
 
@@ -106,6 +240,14 @@ public:
      */
     virtual File::FileSize Read(void* outBuf, const File::FileSize bufSize);
 
+    /**
+     * Sets the access hint applied to every view the sliding window of Read
+     * and Write maps from now on. This also affects the current view.
+     *
+     * @param hint The expected access pattern.
+     */
+    void SetAccessHint(const AccessHint hint);
+
     /**
      * behaves like File::Seek
      * If the destination is beyond file extents, it is cropped.
@@ -144,6 +286,28 @@ public:
      */
     virtual File::FileSize Write(const void* buf, const File::FileSize bufSize);
 
+    /**
+     * Maps the range [offset, offset + length) of the file as a read-only
+     * view that can be accessed without copying. The range is cropped to the
+     * end of the file. The view is independent of the sliding window used by
+     * Read and Write, i.e. it does neither change nor invalidate the file
+     * pointer or the current view, and it is not limited by the view size.
+     * Ranges beyond 4 GB are supported if the address space is large enough;
+     * on 32 bit systems larger files must be processed in several views.
+     * Dirty data of the current view is flushed before the range is mapped.
+     *
+     * @param offset The file offset of the first byte of the view.
+     * @param length The number of bytes to map.
+     * @param hint   The expected access pattern for the view.
+     *
+     * @return The view. It is empty if the range is empty.
+     *
+     * @throws IllegalStateException if the file is not open or write-only
+     * @throws IllegalParamException if the range cannot be addressed
+     * @throws IOException on mapping failures. Use GetLastError().
+     */
+    ConstView View(const File::FileSize offset, const File::FileSize length, const AccessHint hint = HINT_SEQUENTIAL);
+
 private:
     /**
      * Generate a valid view size in relation to a file pointer position
@@ -208,6 +372,15 @@ private:
      */
     inline char* SafeMapView();
 
+    /**
+     * Applies an access hint to a mapped region.
+     *
+     * @param addr The (aligned) start of the region.
+     * @param size The size of the region in bytes.
+     * @param hint The expected access pattern.
+     */
+    static void ApplyAccessHint(char* addr, SIZE_T size, const AccessHint hint);
+
     /**
      * Forbidden copy-ctor.
      *
@@ -284,6 +457,9 @@ private:
 
     /** does a writable view have to be written back to disk */
     bool viewDirty;
+
+    /** the access hint applied to the views of the sliding window */
+    AccessHint accessHint;
 };
 
 } /* end namespace sys */
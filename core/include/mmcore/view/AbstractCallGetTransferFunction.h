@@ -10,6 +10,7 @@
 
 #include <array>
 #include <cassert>
+#include <cstring>
 #include <memory>
 
 #include "mmcore/Call.h"
@@ -0,0 +1,169 @@
+/*
+ * TransferFunctionLUT.h
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "mmcore/api/MegaMolCore.std.h"
+#include "mmcore/view/AbstractCallGetTransferFunction.h"
+
+namespace megamol {
+namespace core {
+namespace view {
+
+
+/**
+ * Lookup table of a transfer function for colouring data on the CPU.
+ *
+ * The texture of the transfer function is resampled into a finer table,
+ * sampled like a linearly filtered, edge clamped texture on the GPU. Mapping
+ * a value is then a clamped index computation and a table read, which is
+ * vectorized and runs in parallel for large batches.
+ *
+ * Tables are shared through a process wide cache keyed by the hash of the
+ * transfer function and the resolution, so several modules using the same
+ * transfer function sample it only once.
+ */
+class MEGAMOLCORE_API TransferFunctionLUT {
+public:
+    /** The default number of table entries */
+    static const unsigned int DefaultResolution = 4096;
+
+    /**
+     * Answer the table of the transfer function currently set in a call.
+     * The call must have been executed before.
+     *
+     * @param call       The call providing the transfer function.
+     * @param resolution The number of table entries.
+     *
+     * @return The table or nullptr if the call holds no texture.
+     */
+    static std::shared_ptr<const TransferFunctionLUT> Get(
+        const AbstractCallGetTransferFunction& call, unsigned int resolution = DefaultResolution);
+
+    /**
+     * Answer the table of a transfer function texture.
+     *
+     * @param texture    The RGBA texture, 'texSize' * 4 floats.
+     * @param texSize    The number of texels.
+     * @param format     The format, alpha is set to one for RGB textures.
+     * @param range      The value range of the transfer function.
+     * @param resolution The number of table entries.
+     *
+     * @return The table or nullptr if there is no texture.
+     */
+    static std::shared_ptr<const TransferFunctionLUT> Get(float const* texture, unsigned int texSize,
+        AbstractCallGetTransferFunction::TextureFormat format, std::array<float, 2> range,
+        unsigned int resolution = DefaultResolution);
+
+    /**
+     * Drops all cached tables. Tables still referenced stay valid.
+     */
+    static void ClearCache(void);
+
+    /**
+     * Answer the RGBA table entries.
+     *
+     * @return 'Resolution' * 4 floats.
+     */
+    inline float const* Data(void) const {
+        return this->table.data();
+    }
+
+    /**
+     * Answer the hash identifying the transfer function and the resolution.
+     *
+     * @return The hash.
+     */
+    inline uint64_t Hash(void) const {
+        return this->hash;
+    }
+
+    /**
+     * Maps values to RGBA colours. Values outside of 'range' are clamped.
+     *
+     * @param values The values.
+     * @param count  The number of values.
+     * @param range  The value range mapped onto the transfer function.
+     * @param rgba   Receives 'count' * 4 floats.
+     * @param stride The distance between two values in bytes, 0 for packed values.
+     */
+    void Map(float const* values, size_t count, std::array<float, 2> range, float* rgba, size_t stride = 0) const;
+
+    /**
+     * Maps values to RGBA colours. Values outside of 'range' are clamped.
+     *
+     * @param values The values.
+     * @param count  The number of values.
+     * @param range  The value range mapped onto the transfer function.
+     * @param rgba   Receives 'count' * 4 floats.
+     * @param stride The distance between two values in bytes, 0 for packed values.
+     */
+    void Map(double const* values, size_t count, std::array<float, 2> range, float* rgba, size_t stride = 0) const;
+
+    /**
+     * Answer the value range of the transfer function.
+     *
+     * @return The (min, max) pair.
+     */
+    inline std::array<float, 2> Range(void) const {
+        return this->range;
+    }
+
+    /**
+     * Answer the number of table entries.
+     *
+     * @return The number of entries.
+     */
+    inline unsigned int Resolution(void) const {
+        return static_cast<unsigned int>(this->table.size() / 4);
+    }
+
+    /**
+     * Maps a single value to an RGBA colour.
+     *
+     * @param value The value.
+     * @param range The value range mapped onto the transfer function.
+     *
+     * @return The colour.
+     */
+    std::array<float, 4> Sample(float value, std::array<float, 2> range) const;
+
+private:
+    /**
+     * Ctor. Resamples the texture.
+     */
+    TransferFunctionLUT(float const* texture, unsigned int texSize,
+        AbstractCallGetTransferFunction::TextureFormat format, std::array<float, 2> range, unsigned int resolution,
+        uint64_t hash);
+
+    /**
+     * Maps values of type T.
+     */
+    template<class T>
+    void map(T const* values, size_t count, std::array<float, 2> range, float* rgba, size_t stride) const;
+
+    /** The RGBA entries */
+    std::vector<float> table;
+
+    /** The value range of the transfer function */
+    std::array<float, 2> range;
+
+    /** The hash of the transfer function and the resolution */
+    uint64_t hash;
+};
+
+
+} /* end namespace view */
+} /* end namespace core */
+} /* end namespace megamol */
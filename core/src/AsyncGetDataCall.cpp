@@ -0,0 +1,204 @@
+/*
+ * AsyncGetDataCall.cpp
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "mmcore/AsyncGetDataCall.h"
+#include "mmcore/CallScheduler.h"
+#include "mmcore/utility/log/Log.h"
+#include "stdafx.h"
+
+#include <chrono>
+#include <exception>
+
+using namespace megamol::core;
+
+
+/*
+ * AsyncGetDataCall::AsyncGetDataCall
+ */
+AsyncGetDataCall::AsyncGetDataCall(void)
+        : result()
+        , call()
+        , desc()
+        , lastComplete()
+        , job()
+        , jobLock()
+        , jobReady()
+        , terminate(false)
+        , worker() {
+    // intentionally empty
+}
+
+
+/*
+ * AsyncGetDataCall::~AsyncGetDataCall
+ */
+AsyncGetDataCall::~AsyncGetDataCall(void) {
+    this->Reset();
+    {
+        std::lock_guard<std::mutex> lock(this->jobLock);
+        this->terminate = true;
+    }
+    this->jobReady.notify_all();
+    if (this->worker.joinable()) {
+        this->worker.join();
+    }
+}
+
+
+/*
+ * AsyncGetDataCall::IsReady
+ */
+bool AsyncGetDataCall::IsReady(void) const {
+    return this->result.valid() && (this->result.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+}
+
+
+/*
+ * AsyncGetDataCall::Request
+ */
+bool AsyncGetDataCall::Request(
+    AbstractGetDataCall& call, const std::vector<unsigned int>& funcs, factories::CallDescription::ptr desc) {
+    if (this->IsPending() || (desc == nullptr)) {
+        return false;
+    }
+    this->desc = desc;
+
+    auto execute = [funcs](Call& c) {
+        for (unsigned int func : funcs) {
+            if (!c(func)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    std::shared_ptr<Call> keep;
+    if (CallScheduler::IsBackgroundSafe(call)) {
+        try {
+            keep = call.shared_from_this();
+        } catch (std::bad_weak_ptr&) {
+            keep.reset(); // not owned by the graph, run synchronously
+        }
+    }
+
+    if (keep != nullptr) {
+        this->call = keep;
+        std::packaged_task<bool(void)> task([keep, execute]() { return execute(*keep); });
+        this->result = task.get_future();
+        {
+            std::lock_guard<std::mutex> lock(this->jobLock);
+            this->job = std::move(task);
+        }
+        if (!this->worker.joinable()) {
+            this->worker = std::thread(&AsyncGetDataCall::work, this);
+        }
+        this->jobReady.notify_one();
+    } else {
+        // non-owning, the caller keeps the call alive until Update()
+        this->call = std::shared_ptr<Call>(std::shared_ptr<Call>(), &call);
+        std::promise<bool> answer;
+        try {
+            answer.set_value(execute(call));
+        } catch (...) {
+            answer.set_exception(std::current_exception());
+        }
+        this->result = answer.get_future();
+    }
+    return true;
+}
+
+
+/*
+ * AsyncGetDataCall::Reset
+ */
+void AsyncGetDataCall::Reset(void) {
+    if (this->IsPending()) {
+        this->result.wait();
+        this->result = std::future<bool>();
+        AbstractGetDataCall* answer = dynamic_cast<AbstractGetDataCall*>(this->call.get());
+        if (answer != nullptr) {
+            answer->Unlock();
+        }
+        this->call.reset();
+    }
+    this->lastComplete.reset(); // unlocks the snapshot
+}
+
+
+/*
+ * AsyncGetDataCall::Update
+ */
+bool AsyncGetDataCall::Update(void) {
+    if (!this->IsReady()) {
+        return false;
+    }
+
+    bool ok = false;
+    try {
+        ok = this->result.get();
+    } catch (std::exception& e) {
+        utility::log::Log::DefaultLog.WriteError(
+            "AsyncGetDataCall: call %s failed: %s", this->call->ClassName(), e.what());
+    } catch (...) {
+        utility::log::Log::DefaultLog.WriteError(
+            "AsyncGetDataCall: call %s failed with unknown exception", this->call->ClassName());
+    }
+
+    const std::shared_ptr<Call> keep = std::move(this->call); // alive until returning
+    AbstractGetDataCall* answer = dynamic_cast<AbstractGetDataCall*>(keep.get());
+    if (answer == nullptr) {
+        return false;
+    }
+    if (!ok) {
+        answer->Unlock();
+        return false;
+    }
+
+    if ((this->lastComplete == nullptr) || !this->desc->IsDescribing(this->lastComplete.get())) {
+        this->lastComplete.reset(dynamic_cast<AbstractGetDataCall*>(this->desc->CreateCall()));
+        if (this->lastComplete == nullptr) {
+            answer->Unlock();
+            return false;
+        }
+    } else {
+        this->lastComplete->Unlock();
+    }
+    this->desc->AssignmentCrowbar(this->lastComplete.get(), answer);
+    answer->SetUnlocker(nullptr, false); // the snapshot owns the unlocker now
+    return true;
+}
+
+
+/*
+ * AsyncGetDataCall::Wait
+ */
+bool AsyncGetDataCall::Wait(void) {
+    if (!this->IsPending()) {
+        return false;
+    }
+    this->result.wait();
+    return this->Update();
+}
+
+
+/*
+ * AsyncGetDataCall::work
+ */
+void AsyncGetDataCall::work(void) {
+    std::unique_lock<std::mutex> lock(this->jobLock);
+    while (true) {
+        this->jobReady.wait(lock, [this]() { return this->terminate || this->job.valid(); });
+        if (!this->job.valid()) {
+            return; // terminated
+        }
+        std::packaged_task<bool(void)> task = std::move(this->job);
+        lock.unlock();
+        task(); // exceptions are stored in the future
+        lock.lock();
+    }
+}
@@ -26,6 +26,10 @@ void CallCapabilities::RequireVulkan() {
     cap_bits |= REQUIRES_VULKAN;
 }
 
+void CallCapabilities::RequireThreadAffinity() {
+    cap_bits |= REQUIRES_THREAD_AFFINITY;
+}
+
 bool CallCapabilities::OpenGLRequired() const {
     return (cap_bits & REQUIRES_OPENGL) > 0;
 }
@@ -49,3 +53,11 @@ bool CallCapabilities::OSPRayRequired() const {
 bool CallCapabilities::VulkanRequired() const {
     return (cap_bits & REQUIRES_VULKAN) > 0;
 }
+
+bool CallCapabilities::ThreadAffinityRequired() const {
+    return (cap_bits & REQUIRES_THREAD_AFFINITY) > 0;
+}
+
+bool CallCapabilities::CPUOnly() const {
+    return cap_bits == 0;
+}
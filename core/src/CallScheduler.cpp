@@ -0,0 +1,358 @@
+/*
+ * CallScheduler.cpp
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "mmcore/CallScheduler.h"
+#include "mmcore/Call.h"
+#include "mmcore/CalleeSlot.h"
+#include "mmcore/CallerSlot.h"
+#include "mmcore/Module.h"
+#include "mmcore/utility/log/Log.h"
+#include "stdafx.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif /* _OPENMP */
+
+using namespace megamol::core;
+
+
+namespace {
+
+/**
+ * Thread pool with one task queue per worker. Workers take their own newest
+ * task first and steal the oldest tasks of the other workers when idle.
+ * Tasks submitted from a worker go to its own queue, so nested batches stay
+ * local as long as possible.
+ */
+class WorkStealingPool {
+public:
+    typedef std::function<void(void)> Task;
+
+    /** Answer the pool shared by all batches */
+    static WorkStealingPool& Instance(void) {
+        static WorkStealingPool pool(std::max(1u, std::thread::hardware_concurrency()));
+        return pool;
+    }
+
+    explicit WorkStealingPool(unsigned int threadCount) : pending(0), nextQueue(0), terminate(false) {
+        for (unsigned int i = 0; i < threadCount; ++i) {
+            this->queues.push_back(std::make_unique<Queue>());
+        }
+        for (unsigned int i = 0; i < threadCount; ++i) {
+            this->threads.emplace_back(&WorkStealingPool::work, this, i);
+        }
+    }
+
+    ~WorkStealingPool(void) {
+        {
+            std::lock_guard<std::mutex> lock(this->sleepLock);
+            this->terminate = true;
+        }
+        this->wakeUp.notify_all();
+        for (auto& t : this->threads) {
+            t.join();
+        }
+    }
+
+    /** Queues a task for execution */
+    void Submit(Task task) {
+        const size_t idx = (workerIndex >= 0) ? static_cast<size_t>(workerIndex)
+                                              : (this->nextQueue++ % this->queues.size());
+        {
+            std::lock_guard<std::mutex> lock(this->queues[idx]->lock);
+            this->queues[idx]->tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(this->sleepLock);
+            ++this->pending;
+        }
+        this->wakeUp.notify_one();
+    }
+
+    /**
+     * Executes one pending task on the calling thread.
+     *
+     * @return 'false' if there was no task to execute.
+     */
+    bool RunPending(void) {
+        Task task;
+        if (!this->pop((workerIndex >= 0) ? static_cast<size_t>(workerIndex) : 0, task)) {
+            return false;
+        }
+        task();
+        return true;
+    }
+
+    /**
+     * Executes pending tasks on the calling thread until 'finished' holds,
+     * and sleeps while there is nothing to execute.
+     *
+     * @param finished The condition to wait for. Call 'Notify' whenever it
+     *                 may have changed.
+     */
+    void Help(const std::function<bool(void)>& finished) {
+        while (!finished()) {
+            if (this->RunPending()) {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(this->sleepLock);
+            this->wakeUp.wait(lock, [this, &finished]() { return finished() || (this->pending > 0); });
+        }
+    }
+
+    /** Wakes all threads waiting in 'Help' to test their condition */
+    void Notify(void) {
+        {
+            std::lock_guard<std::mutex> lock(this->sleepLock);
+        }
+        this->wakeUp.notify_all();
+    }
+
+private:
+    /** The tasks of one worker */
+    struct Queue {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    /** Takes a task, from the own queue if possible */
+    bool pop(size_t idx, Task& outTask) {
+        const size_t cnt = this->queues.size();
+        for (size_t i = 0; i < cnt; ++i) {
+            Queue& q = *this->queues[(idx + i) % cnt];
+            std::lock_guard<std::mutex> lock(q.lock);
+            if (q.tasks.empty()) {
+                continue;
+            }
+            if (i == 0) {
+                outTask = std::move(q.tasks.back());
+                q.tasks.pop_back();
+            } else {
+                outTask = std::move(q.tasks.front());
+                q.tasks.pop_front();
+            }
+            --this->pending;
+            return true;
+        }
+        return false;
+    }
+
+    /** The worker loop */
+    void work(unsigned int idx) {
+        workerIndex = static_cast<int>(idx);
+        while (true) {
+            Task task;
+            if (this->pop(idx, task)) {
+                task();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(this->sleepLock);
+            this->wakeUp.wait(lock, [this]() { return this->terminate || (this->pending > 0); });
+            if (this->terminate && (this->pending == 0)) {
+                return;
+            }
+        }
+    }
+
+    /** The index of the worker running on this thread, -1 for other threads */
+    static thread_local int workerIndex;
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+    std::atomic<size_t> pending;
+    std::atomic<size_t> nextQueue;
+    std::mutex sleepLock;
+    std::condition_variable wakeUp;
+    bool terminate;
+};
+
+thread_local int WorkStealingPool::workerIndex = -1;
+
+
+/** Flag whether calls are executed concurrently */
+std::atomic<bool> schedulerEnabled{false};
+
+
+/**
+ * Collects the modules upstream of a call, including the called module.
+ *
+ * @return 'true' if none of the calls in the subtree has capability
+ *         requirements and all modules of the subtree support background
+ *         calls.
+ */
+bool collectUpstream(Call* call, std::unordered_set<Module*>& outModules) {
+    bool cpuOnly = true;
+    std::unordered_set<Call*> visited;
+    std::vector<Call*> stack(1, call);
+    while (!stack.empty()) {
+        Call* c = stack.back();
+        stack.pop_back();
+        if ((c == nullptr) || !visited.insert(c).second) {
+            continue;
+        }
+        cpuOnly = cpuOnly && c->GetCapabilities().CPUOnly();
+        CalleeSlot* callee = c->PeekCalleeSlotNoConst();
+        if (callee == nullptr) {
+            continue;
+        }
+        Module* mod = dynamic_cast<Module*>(callee->Parent().get());
+        if (mod == nullptr) {
+            // nothing is known about the called object
+            cpuOnly = false;
+            continue;
+        }
+        if (!outModules.insert(mod).second) {
+            continue;
+        }
+        cpuOnly = cpuOnly && mod->SupportsBackgroundCalls();
+        for (auto caller : mod->GetSlots<CallerSlot>()) {
+            stack.push_back(caller->CallAs<Call>());
+        }
+    }
+    return cpuOnly;
+}
+
+
+/** Executes one request, reporting exceptions as failure */
+void execute(CallScheduler::Request& request) {
+    try {
+        request.result = (request.call != nullptr) && (*request.call)(request.func);
+    } catch (std::exception& e) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(
+            "CallScheduler: call %s failed: %s", request.call->ClassName(), e.what());
+        request.result = false;
+    } catch (...) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(
+            "CallScheduler: call %s failed with unknown exception", request.call->ClassName());
+        request.result = false;
+    }
+}
+
+} /* end anonymous namespace */
+
+
+/*
+ * CallScheduler::IsEnabled
+ */
+bool CallScheduler::IsEnabled(void) {
+    return schedulerEnabled;
+}
+
+
+/*
+ * CallScheduler::IsBackgroundSafe
+ */
+bool CallScheduler::IsBackgroundSafe(Call& call) {
+    std::unordered_set<Module*> modules;
+    return collectUpstream(&call, modules);
+}
+
+
+/*
+ * CallScheduler::Run
+ */
+bool CallScheduler::Run(std::vector<Request>& requests) {
+    const size_t cnt = requests.size();
+
+    // which requests may run in the pool
+    std::vector<bool> concurrent(cnt, false);
+    if (schedulerEnabled && (cnt > 1)) {
+        std::vector<std::unordered_set<Module*>> subtrees(cnt);
+        std::unordered_set<Module*> callers;
+        for (size_t i = 0; i < cnt; ++i) {
+            concurrent[i] = (requests[i].call != nullptr) && collectUpstream(requests[i].call, subtrees[i]);
+            CallerSlot* caller = (requests[i].call != nullptr) ? requests[i].call->PeekCallerSlotNoConst() : nullptr;
+            if (caller != nullptr) {
+                callers.insert(dynamic_cast<Module*>(caller->Parent().get()));
+            }
+        }
+        for (size_t i = 0; i < cnt; ++i) {
+            // a subtree reaching back to a calling module closes a cycle in the graph
+            concurrent[i] = concurrent[i] && std::none_of(subtrees[i].begin(), subtrees[i].end(),
+                                                 [&callers](Module* m) { return callers.count(m) > 0; });
+            for (size_t j = 0; concurrent[i] && (j < cnt); ++j) {
+                if (i == j) {
+                    continue;
+                }
+                const bool shared = std::any_of(subtrees[i].begin(), subtrees[i].end(),
+                    [&subtrees, j](Module* m) { return subtrees[j].count(m) > 0; });
+                concurrent[i] = !shared;
+            }
+        }
+    }
+
+    // the requests still being executed by the pool
+    std::atomic<size_t> open(std::count(concurrent.begin(), concurrent.end(), true));
+    WorkStealingPool& pool = WorkStealingPool::Instance();
+    if (open > 0) {
+#ifdef _OPENMP
+        // share the OpenMP threads between the subtrees instead of oversubscribing
+        const int teams = static_cast<int>(open) + ((open < cnt) ? 1 : 0);
+        const int ompThreads = std::max(1, omp_get_max_threads() / teams);
+#endif /* _OPENMP */
+        for (size_t i = 0; i < cnt; ++i) {
+            if (!concurrent[i]) {
+                continue;
+            }
+            Request* request = &requests[i];
+            pool.Submit([=, &open, &pool]() {
+#ifdef _OPENMP
+                const int prevThreads = omp_get_max_threads();
+                omp_set_num_threads(ompThreads);
+                execute(*request);
+                omp_set_num_threads(prevThreads);
+#else /* _OPENMP */
+                execute(*request);
+#endif /* _OPENMP */
+                // 'open' must not be touched after the last decrement, the batch may be gone already
+                if (--open == 0) {
+                    pool.Notify();
+                }
+            });
+        }
+    }
+
+    // the remaining requests run in order on this thread and stop at the first failure, like direct calls
+    bool ok = true;
+    for (size_t i = 0; i < cnt; ++i) {
+        if (concurrent[i]) {
+            continue;
+        }
+        if (ok) {
+            execute(requests[i]);
+            ok = requests[i].result;
+        } else {
+            requests[i].result = false;
+        }
+    }
+
+    // help the pool instead of just waiting
+    pool.Help([&open]() { return open == 0; });
+
+    return std::all_of(requests.begin(), requests.end(), [](const Request& r) { return r.result; });
+}
+
+
+/*
+ * CallScheduler::SetEnabled
+ */
+void CallScheduler::SetEnabled(bool enabled) {
+    schedulerEnabled = enabled;
+    megamol::core::utility::log::Log::DefaultLog.WriteInfo(
+        "CallScheduler: concurrent execution of independent calls %s", enabled ? "enabled" : "disabled");
+}
@@ -43,6 +43,20 @@ static std::string clean(std::string const& path) {
     return "::" + path.substr(begin);
 }
 
+// key of a call in the call index, compared case insensitive like the slots
+static std::string call_key(std::string const& from, std::string const& to) {
+    return tolower(from) + "\n" + tolower(to);
+}
+
+// whether slot is (still) a child of module. compares pointers only, so a stale slot is never dereferenced
+static bool has_child_slot(megamol::core::Module& module, megamol::core::AbstractSlot const* slot) {
+    for (auto child = module.ChildList_Begin(); child != module.ChildList_End(); ++child) {
+        if (child->get() == slot)
+            return true;
+    }
+    return false;
+}
+
 static std::string cut_off_prefix(std::string const& name, std::string const& prefix) {
     return name.substr(prefix.size());
 }
@@ -127,9 +141,17 @@ bool megamol::core::MegaMolGraph::RenameModule(std::string const& old, std::stri
         return false;
     }
 
+    if (module_index_.count(newId) != 0) {
+        log_error("error. could not rename module. module name already in use: " + newId);
+        return false;
+    }
+
     log("rename module " + module_it->request.id + " to " + newId);
+    module_index_.erase(module_it->request.id);
     module_it->request.id = newId;
     module_it->modulePtr->setName(newId.c_str());
+    module_index_[newId] = module_it;
+    param_index_.clear();
 
     for (auto child = module_it->modulePtr->ChildList_Begin(); child != module_it->modulePtr->ChildList_End();
          ++child) {
@@ -167,6 +189,7 @@ bool megamol::core::MegaMolGraph::RenameModule(std::string const& old, std::stri
             put_new_prefix(call.request.to);
         }
     }
+    rebuild_call_index();
 
     // dont know what we are supposed to do when entry point renaming fails... how can it fail?
     if (module_it->isGraphEntryPoint) {
@@ -222,6 +245,15 @@ megamol::core::param::AbstractParam* megamol::core::MegaMolGraph::FindParameter(
 
 megamol::core::param::ParamSlot* megamol::core::MegaMolGraph::FindParameterSlot(std::string const& param) const {
     auto paramName = clean(param);
+
+    // fast path for repeated lookups, e.g. remote clients setting parameter values
+    auto cached = param_index_.find(paramName);
+    if (cached != param_index_.end()) {
+        if (has_child_slot(*cached->second.first, cached->second.second))
+            return cached->second.second;
+        param_index_.erase(cached);
+    }
+
     // match module where module name is prefix of parameter slot name
     auto module_it = find_module_by_prefix(paramName);
 
@@ -242,6 +274,8 @@ megamol::core::param::ParamSlot* megamol::core::MegaMolGraph::FindParameterSlot(
         return nullptr;
     }
 
+    param_index_[paramName] = {module_it->modulePtr.get(), param_slot_ptr};
+
     return param_slot_ptr;
 }
 
@@ -423,9 +457,12 @@ megamol::core::MegaMolGraph_Convenience& megamol::core::MegaMolGraph::Convenienc
 void megamol::core::MegaMolGraph::Clear() {
     // currently entry points are expected to be graph modules, i.e. views
     // therefore it is ok for us to clear all entry points if the graph shuts down
+    param_index_.clear();
+    call_index_.clear();
     call_list_.clear();
     m_image_presentation->clear_entry_points();
     graph_entry_points.clear();
+    module_index_.clear();
     module_list_.clear();
 }
 
@@ -435,41 +472,34 @@ void megamol::core::MegaMolGraph::Clear() {
 
 
 megamol::core::ModuleList_t::iterator megamol::core::MegaMolGraph::find_module(std::string const& name) {
-    auto it = std::find_if(this->module_list_.begin(), this->module_list_.end(),
-        [&name](megamol::core::ModuleInstance_t const& el) { return el.request.id == name; });
-
-    return it;
+    auto it = module_index_.find(name);
+    return (it != module_index_.end()) ? it->second : module_list_.end();
 }
 
 megamol::core::ModuleList_t::const_iterator megamol::core::MegaMolGraph::find_module(std::string const& name) const {
-
-    auto it = std::find_if(this->module_list_.cbegin(), this->module_list_.cend(),
-        [&name](megamol::core::ModuleInstance_t const& el) { return el.request.id == name; });
-
-    return it;
+    auto it = module_index_.find(name);
+    return (it != module_index_.end()) ? ModuleList_t::const_iterator{it->second} : module_list_.cend();
 }
 
 megamol::core::CallList_t::iterator megamol::core::MegaMolGraph::find_call(
     std::string const& from, std::string const& to) {
-    auto it =
-        std::find_if(this->call_list_.begin(), this->call_list_.end(), [&](megamol::core::CallInstance_t const& el) {
-            // tolower emulates case insensitive comparison in Module::FindSlot() during add_call
-            return tolower(el.request.from) == tolower(from) && tolower(el.request.to) == tolower(to);
-        });
-
-    return it;
+    // the key uses tolower to emulate case insensitive comparison in Module::FindSlot() during add_call
+    auto it = call_index_.find(call_key(from, to));
+    return (it != call_index_.end()) ? it->second : call_list_.end();
 }
 
 megamol::core::CallList_t::const_iterator megamol::core::MegaMolGraph::find_call(
     std::string const& from, std::string const& to) const {
+    auto it = call_index_.find(call_key(from, to));
+    return (it != call_index_.end()) ? CallList_t::const_iterator{it->second} : call_list_.cend();
+}
 
-    auto it =
-        std::find_if(this->call_list_.cbegin(), this->call_list_.cend(), [&](megamol::core::CallInstance_t const& el) {
-            // tolower emulates case insensitive comparison in Module::FindSlot() during add_call
-            return tolower(el.request.from) == tolower(from) && tolower(el.request.to) == tolower(to);
-        });
-
-    return it;
+void megamol::core::MegaMolGraph::rebuild_call_index() {
+    call_index_.clear();
+    // call_list_ holds the newest call first, which wins for duplicate keys like in a linear search
+    for (auto it = call_list_.begin(); it != call_list_.end(); ++it) {
+        call_index_.emplace(call_key(it->request.from, it->request.to), it);
+    }
 }
 
 
@@ -529,6 +559,8 @@ bool megamol::core::MegaMolGraph::add_module(ModuleInstantiationRequest_t const&
     if (!isCreateOk) {
         this->module_list_.pop_front();
     } else {
+        module_index_[request.id] = this->module_list_.begin();
+
         // iterate parameters, add hotkeys to CommandRegistry
         for (auto child = module_ptr->ChildList_Begin(); child != module_ptr->ChildList_End(); ++child) {
             auto ps = dynamic_cast<param::ParamSlot*>((*child).get());
@@ -659,6 +691,7 @@ bool megamol::core::MegaMolGraph::add_call(CallInstantiationRequest_t const& req
 
     log("create call: " + request.from + " -> " + request.to + " (" + std::string(call_description->ClassName()) + ")");
     this->call_list_.emplace_front(CallInstance_t{call, request});
+    call_index_[call_key(request.from, request.to)] = this->call_list_.begin();
 #ifdef PROFILING
     auto the_call = call.get();
     //printf("adding timers for @ %p = %s \n", reinterpret_cast<void*>(the_call), the_call->GetDescriptiveText().c_str());
@@ -736,6 +769,8 @@ bool megamol::core::MegaMolGraph::delete_module(ModuleDeletionRequest_t const& r
 
     release_module(module_it->lifetime_resources);
 
+    param_index_.clear();
+    module_index_.erase(module_it->request.id);
     this->module_list_.erase(module_it);
 
     return true;
@@ -773,28 +808,35 @@ bool megamol::core::MegaMolGraph::delete_call(CallDeletionRequest_t const& reque
     source->PerformCleanup();  // does nothing
     target->DisconnectCalls(); // does nothing
 
+    const auto key = call_key(call_it->request.from, call_it->request.to);
     this->call_list_.erase(call_it);
+    call_index_.erase(key);
+    // another call between the same slots becomes visible again
+    auto next = std::find_if(this->call_list_.begin(), this->call_list_.end(),
+        [&](CallInstance_t const& el) { return call_key(el.request.from, el.request.to) == key; });
+    if (next != this->call_list_.end())
+        call_index_[key] = next;
 
     return true;
 }
 
-static const auto check_module_is_prefix = [](std::string const& request, auto const& module) {
-    const auto& module_name = module.request.id;
-    const auto substring = request.substr(0, module_name.size());
-    return (module_name == substring) &&         // module name is prefix of request
-           (request.size() == module_name.size() // module name matches whole request
-               || (request.size() >= module_name.size() + 2 &&
-                      request.substr(module_name.size(), 2) == "::")); // OR request has :: after module name
-};
-
-// find module where module name is prefix of request
+// find module where module name is prefix of request, i.e. the request is the module name or continues with ::
+// after it. module names may contain :: themselves, so every :: boundary is tried, longest module name first.
 megamol::core::ModuleList_t::iterator megamol::core::MegaMolGraph::find_module_by_prefix(std::string const& request) {
-    return std::find_if(module_list_.begin(), module_list_.end(),
-        [&](auto const& module) { return check_module_is_prefix(request, module); });
+    auto it = module_index_.find(request);
+    if (it != module_index_.end())
+        return it->second;
+
+    for (auto pos = request.rfind("::"); pos != std::string::npos && pos > 0; pos = request.rfind("::", pos - 1)) {
+        it = module_index_.find(request.substr(0, pos));
+        if (it != module_index_.end())
+            return it->second;
+    }
+
+    return module_list_.end();
 }
 
 megamol::core::ModuleList_t::const_iterator megamol::core::MegaMolGraph::find_module_by_prefix(
     std::string const& request) const {
-    return std::find_if(module_list_.begin(), module_list_.end(),
-        [&](auto const& module) { return check_module_is_prefix(request, module); });
+    return const_cast<MegaMolGraph*>(this)->find_module_by_prefix(request);
 }
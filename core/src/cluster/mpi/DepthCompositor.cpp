@@ -0,0 +1,204 @@
+/*
+ * DepthCompositor.cpp
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "mmcore/cluster/mpi/DepthCompositor.h"
+#include "stdafx.h"
+
+#include <climits>
+#include <utility>
+#include <vector>
+
+#include "mmcore/utility/log/Log.h"
+
+using namespace megamol::core::cluster::mpi;
+
+
+namespace {
+
+/** The minimum number of pixels blended in parallel */
+const size_t parallelBlendSize = 1 << 16;
+
+#ifdef WITH_MPI
+/**
+ * Answer the span of pixels [first, second) a rank owns after binary-swap
+ * among 'pow2' ranks.
+ */
+std::pair<size_t, size_t> swapSpan(int rank, int pow2, size_t count) {
+    size_t begin = 0;
+    size_t end = count;
+    for (int mask = 1; mask < pow2; mask <<= 1) {
+        const size_t mid = begin + (end - begin) / 2;
+        if ((rank & mask) == 0) {
+            end = mid;
+        } else {
+            begin = mid;
+        }
+    }
+    return std::make_pair(begin, end);
+}
+
+/**
+ * Answer the rank holding the image of virtual rank 'vrank' after the first
+ * 'rest' pairs of neighbouring ranks have been folded.
+ */
+inline int realRank(int vrank, int rest) {
+    return (vrank < rest) ? 2 * vrank : vrank + rest;
+}
+#endif /* WITH_MPI */
+
+} // namespace
+
+
+/*
+ * DepthCompositor::Blend
+ */
+void DepthCompositor::Blend(uint32_t* color, float* depth, uint32_t const* otherColor, float const* otherDepth,
+    size_t count, bool otherOnTies) {
+    const int64_t cnt = static_cast<int64_t>(count);
+    if (otherOnTies) {
+#pragma omp parallel for if (count >= parallelBlendSize)
+        for (int64_t i = 0; i < cnt; ++i) {
+            if (otherDepth[i] <= depth[i]) {
+                color[i] = otherColor[i];
+                depth[i] = otherDepth[i];
+            }
+        }
+    } else {
+#pragma omp parallel for if (count >= parallelBlendSize)
+        for (int64_t i = 0; i < cnt; ++i) {
+            if (otherDepth[i] < depth[i]) {
+                color[i] = otherColor[i];
+                depth[i] = otherDepth[i];
+            }
+        }
+    }
+}
+
+#ifdef WITH_MPI
+
+/*
+ * DepthCompositor::Composite
+ */
+bool DepthCompositor::Composite(MPI_Comm comm, uint32_t* color, float* depth, size_t count, int root) {
+    using megamol::core::utility::log::Log;
+
+    int rank = 0;
+    int size = 0;
+    if ((::MPI_Comm_rank(comm, &rank) != MPI_SUCCESS) || (::MPI_Comm_size(comm, &size) != MPI_SUCCESS)) {
+        return false;
+    }
+    if (count > static_cast<size_t>(INT_MAX)) {
+        Log::DefaultLog.WriteError("DepthCompositor: Images with %zu pixels exceed the MPI count range.", count);
+        return false;
+    }
+    if (size == 1) {
+        return true;
+    }
+
+    int pow2 = 1;
+    while (2 * pow2 <= size) {
+        pow2 *= 2;
+    }
+
+    // fold the odd into the even ranks of the first 'rest' pairs, so each remaining (virtual) rank holds a
+    // contiguous range of ranks, and resolving ties by the virtual rank keeps the order of the ranks
+    const int rest = size - pow2;
+    const int vrank = (rank >= 2 * rest) ? (rank - rest) : (((rank % 2) == 0) ? (rank / 2) : -1);
+    if (vrank < 0) {
+        const int partner = rank - 1;
+        if ((::MPI_Send(color, static_cast<int>(count), MPI_UINT32_T, partner, 0, comm) != MPI_SUCCESS) ||
+            (::MPI_Send(depth, static_cast<int>(count), MPI_FLOAT, partner, 1, comm) != MPI_SUCCESS)) {
+            return false;
+        }
+    } else {
+        std::vector<uint32_t> recvColor;
+        std::vector<float> recvDepth;
+        if (rank < 2 * rest) {
+            recvColor.resize(count);
+            recvDepth.resize(count);
+            const int partner = rank + 1;
+            if ((::MPI_Recv(recvColor.data(), static_cast<int>(count), MPI_UINT32_T, partner, 0, comm,
+                     MPI_STATUS_IGNORE) != MPI_SUCCESS) ||
+                (::MPI_Recv(recvDepth.data(), static_cast<int>(count), MPI_FLOAT, partner, 1, comm,
+                     MPI_STATUS_IGNORE) != MPI_SUCCESS)) {
+                return false;
+            }
+            Blend(color, depth, recvColor.data(), recvDepth.data(), count, false);
+        }
+
+        // binary-swap, halving the span in each round
+        recvColor.resize(count - count / 2);
+        recvDepth.resize(count - count / 2);
+        size_t begin = 0;
+        size_t end = count;
+        for (int mask = 1; mask < pow2; mask <<= 1) {
+            const int vpartner = vrank ^ mask;
+            const int partner = realRank(vpartner, rest);
+            const size_t mid = begin + (end - begin) / 2;
+            const bool keepLower = ((vrank & mask) == 0);
+            const size_t keepBegin = keepLower ? begin : mid;
+            const size_t keepEnd = keepLower ? mid : end;
+            const size_t sendBegin = keepLower ? mid : begin;
+            const size_t sendEnd = keepLower ? end : mid;
+            const int keepCnt = static_cast<int>(keepEnd - keepBegin);
+            const int sendCnt = static_cast<int>(sendEnd - sendBegin);
+
+            if ((::MPI_Sendrecv(color + sendBegin, sendCnt, MPI_UINT32_T, partner, 0, recvColor.data(), keepCnt,
+                     MPI_UINT32_T, partner, 0, comm, MPI_STATUS_IGNORE) != MPI_SUCCESS) ||
+                (::MPI_Sendrecv(depth + sendBegin, sendCnt, MPI_FLOAT, partner, 1, recvDepth.data(), keepCnt,
+                     MPI_FLOAT, partner, 1, comm, MPI_STATUS_IGNORE) != MPI_SUCCESS)) {
+                return false;
+            }
+            Blend(color + keepBegin, depth + keepBegin, recvColor.data(), recvDepth.data(), keepCnt, vpartner < vrank);
+
+            begin = keepBegin;
+            end = keepEnd;
+        }
+    }
+
+    // gather the spans at the root, they already lie at their final position
+    std::vector<int> counts;
+    std::vector<int> displs;
+    if (rank == root) {
+        counts.resize(size, 0);
+        displs.resize(size, 0);
+        for (int v = 0; v < pow2; ++v) {
+            const auto span = swapSpan(v, pow2, count);
+            counts[realRank(v, rest)] = static_cast<int>(span.second - span.first);
+            displs[realRank(v, rest)] = static_cast<int>(span.first);
+        }
+    }
+    const auto own = (vrank >= 0) ? swapSpan(vrank, pow2, count) : std::make_pair(size_t(0), size_t(0));
+    const int ownCnt = static_cast<int>(own.second - own.first);
+    if (rank == root) {
+        return (::MPI_Gatherv(MPI_IN_PLACE, 0, MPI_UINT32_T, color, counts.data(), displs.data(), MPI_UINT32_T,
+                    root, comm) == MPI_SUCCESS) &&
+               (::MPI_Gatherv(MPI_IN_PLACE, 0, MPI_FLOAT, depth, counts.data(), displs.data(), MPI_FLOAT, root,
+                    comm) == MPI_SUCCESS);
+    }
+    return (::MPI_Gatherv(color + own.first, ownCnt, MPI_UINT32_T, nullptr, nullptr, nullptr, MPI_UINT32_T, root,
+                comm) == MPI_SUCCESS) &&
+           (::MPI_Gatherv(depth + own.first, ownCnt, MPI_FLOAT, nullptr, nullptr, nullptr, MPI_FLOAT, root, comm) ==
+               MPI_SUCCESS);
+}
+
+
+/*
+ * DepthCompositor::Composite
+ */
+bool DepthCompositor::Composite(MPI_Comm comm, view::CPUFramebuffer& fb, int root) {
+    const size_t count = static_cast<size_t>(fb.width) * fb.height;
+    if ((fb.colorBuffer.size() != count) || (fb.depthBuffer.size() != count)) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(
+            "DepthCompositor: The framebuffer needs colour and depth for all %zu pixels.", count);
+        return false;
+    }
+    return Composite(comm, fb.colorBuffer.data(), fb.depthBuffer.data(), count, root);
+}
+
+#endif /* WITH_MPI */
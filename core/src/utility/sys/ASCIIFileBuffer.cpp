@@ -12,6 +12,8 @@
 #include "vislib/assert.h"
 #include "vislib/memutils.h"
 
+#include <cstring>
+
 
 /*
  * vislib::sys::ASCIIFileBuffer::LineBuffer::LineBuffer
@@ -176,7 +178,18 @@ bool vislib::sys::ASCIIFileBuffer::LoadFile(vislib::sys::File& file, ParsingElem
     if (this->buffer == NULL) {
         throw vislib::Exception("Cannot allocate memory to store file", __FILE__, __LINE__);
     }
-    SIZE_T rl = static_cast<SIZE_T>(file.Read(this->buffer, l));
+    SIZE_T rl = 0;
+    MemmappedFile* mappedFile = dynamic_cast<MemmappedFile*>(&file);
+    if (mappedFile != NULL) {
+        // copy the text from a single view instead of sliding the window of 'Read' over the file
+        MemmappedFile::ConstView view = mappedFile->View(0, l, MemmappedFile::HINT_SEQUENTIAL);
+        rl = static_cast<SIZE_T>(view.Size());
+        if (rl > 0) {
+            ::memcpy(this->buffer, view.Data(), rl);
+        }
+    } else {
+        rl = static_cast<SIZE_T>(file.Read(this->buffer, l));
+    }
     if (rl != l) {
         if (rl == 0) {
             return false; // cannot read from file; "file.read" should have
@@ -16,11 +16,100 @@
 #include "vislib/sys/IOException.h"
 #include "vislib/sys/error.h"
 
+#include <limits>
+
 #ifndef _WIN32
 #include <iostream>
 #include <sys/stat.h>
 #endif
 
+
+/*
+ * vislib::sys::MemmappedFile::ConstView::ConstView
+ */
+vislib::sys::MemmappedFile::ConstView::ConstView(void)
+        : base(NULL), mappedSize(0), data(NULL), offset(0), size(0) {}
+
+
+/*
+ * vislib::sys::MemmappedFile::ConstView::ConstView
+ */
+vislib::sys::MemmappedFile::ConstView::ConstView(ConstView&& rhs)
+        : base(rhs.base), mappedSize(rhs.mappedSize), data(rhs.data), offset(rhs.offset), size(rhs.size) {
+    rhs.base = NULL;
+    rhs.mappedSize = 0;
+    rhs.data = NULL;
+    rhs.offset = 0;
+    rhs.size = 0;
+}
+
+
+/*
+ * vislib::sys::MemmappedFile::ConstView::ConstView
+ */
+vislib::sys::MemmappedFile::ConstView::ConstView(
+    char* base, SIZE_T mappedSize, File::FileSize offset, File::FileSize size)
+        : base(base), mappedSize(mappedSize), data(base + (mappedSize - size)), offset(offset), size(size) {}
+
+
+/*
+ * vislib::sys::MemmappedFile::ConstView::~ConstView
+ */
+vislib::sys::MemmappedFile::ConstView::~ConstView(void) {
+    this->Release();
+}
+
+
+/*
+ * vislib::sys::MemmappedFile::ConstView::operator =
+ */
+vislib::sys::MemmappedFile::ConstView& vislib::sys::MemmappedFile::ConstView::operator=(ConstView&& rhs) {
+    if (this != &rhs) {
+        this->Release();
+        this->base = rhs.base;
+        this->mappedSize = rhs.mappedSize;
+        this->data = rhs.data;
+        this->offset = rhs.offset;
+        this->size = rhs.size;
+        rhs.base = NULL;
+        rhs.mappedSize = 0;
+        rhs.data = NULL;
+        rhs.offset = 0;
+        rhs.size = 0;
+    }
+    return *this;
+}
+
+
+/*
+ * vislib::sys::MemmappedFile::ConstView::Advise
+ */
+void vislib::sys::MemmappedFile::ConstView::Advise(const AccessHint hint) const {
+    if (this->base != NULL) {
+        MemmappedFile::ApplyAccessHint(this->base, this->mappedSize, hint);
+    }
+}
+
+
+/*
+ * vislib::sys::MemmappedFile::ConstView::Release
+ */
+void vislib::sys::MemmappedFile::ConstView::Release(void) {
+    if (this->base != NULL) {
+        // no exceptions here, since this is called from the dtor
+#ifdef _WIN32
+        ::UnmapViewOfFile(this->base);
+#else  /* _WIN32 */
+        ::munmap(this->base, this->mappedSize);
+#endif /* _WIN32 */
+        this->base = NULL;
+    }
+    this->mappedSize = 0;
+    this->data = NULL;
+    this->offset = 0;
+    this->size = 0;
+}
+
 /*
  * vislib::sys::MemmappedFile::MemmappedFile
  */
@@ -31,9 +120,15 @@ vislib::sys::MemmappedFile::MemmappedFile(void)
         , viewSize(SystemInformation::AllocationGranularity())
         , mappedData(NULL)
         , viewDirty(false)
+        , accessHint(HINT_NORMAL)
         , mapping(INVALID_HANDLE_VALUE) {
 #else  /* _WIN32 */
-        : File(), viewStart(0), viewSize(SystemInformation::AllocationGranularity()), mappedData(NULL), viewDirty(false) {
+        : File()
+        , viewStart(0)
+        , viewSize(SystemInformation::AllocationGranularity())
+        , mappedData(NULL)
+        , viewDirty(false)
+        , accessHint(HINT_NORMAL) {
 #endif /* _WIN32 */
 }
 
@@ -135,10 +230,54 @@ inline char* vislib::sys::MemmappedFile::SafeMapView() {
     }
     this->viewStart = fp;
 #endif /* _WIN32 */
+    if (this->accessHint != HINT_NORMAL) {
+        ApplyAccessHint(ret, static_cast<SIZE_T>(vs), this->accessHint);
+    }
     return ret;
 }
 
 
+/*
+ * vislib::sys::MemmappedFile::ApplyAccessHint
+ */
+void vislib::sys::MemmappedFile::ApplyAccessHint(char* addr, SIZE_T size, const AccessHint hint) {
+    // hints are only hints: failures are silently ignored
+    if ((addr == NULL) || (size == 0)) {
+        return;
+    }
+#ifdef _WIN32
+#if (_WIN32_WINNT >= 0x0602)
+    if ((hint == HINT_WILLNEED) || (hint == HINT_SEQUENTIAL)) {
+        WIN32_MEMORY_RANGE_ENTRY range;
+        range.VirtualAddress = addr;
+        range.NumberOfBytes = size;
+        ::PrefetchVirtualMemory(::GetCurrentProcess(), 1, &range, 0);
+    }
+#endif /* (_WIN32_WINNT >= 0x0602) */
+#else  /* _WIN32 */
+    int advice = MADV_NORMAL;
+    switch (hint) {
+    case HINT_SEQUENTIAL:
+        advice = MADV_SEQUENTIAL;
+        break;
+    case HINT_RANDOM:
+        advice = MADV_RANDOM;
+        break;
+    case HINT_WILLNEED:
+        advice = MADV_WILLNEED;
+        break;
+    default:
+        break;
+    }
+    ::madvise(addr, size, advice);
+    if (hint == HINT_SEQUENTIAL) {
+        // start the readahead right away, not only on the first page fault
+        ::madvise(addr, size, MADV_WILLNEED);
+    }
+#endif /* _WIN32 */
+}
+
+
 #ifdef _WIN32
 /*
  * vislib::sys::MemmappedFile::SafeCreateMapping
@@ -462,6 +601,18 @@ vislib::sys::File::FileSize vislib::sys::MemmappedFile::Read(void* outBuf, const
 }
 
 
+/*
+ * vislib::sys::MemmappedFile::SetAccessHint
+ */
+void vislib::sys::MemmappedFile::SetAccessHint(const AccessHint hint) {
+    this->accessHint = hint;
+    if (this->mappedData != NULL) {
+        ApplyAccessHint(
+            this->mappedData, static_cast<SIZE_T>(this->AdjustedViewSize(this->viewStart)), this->accessHint);
+    }
+}
+
+
 /*
  * vislib::sys::MemmappedFile::Seek
  */
@@ -582,6 +733,60 @@ vislib::sys::File::FileSize vislib::sys::MemmappedFile::Write(const void* buf, c
     return bufSize - dataLeft;
 }
 
+/*
+ * vislib::sys::MemmappedFile::View
+ */
+vislib::sys::MemmappedFile::ConstView vislib::sys::MemmappedFile::View(
+    const File::FileSize offset, const File::FileSize length, const AccessHint hint) {
+#ifdef _WIN32
+    if (this->handle == INVALID_HANDLE_VALUE) {
+#else  /* _WIN32 */
+    if (this->handle == -1) {
+#endif /* _WIN32 */
+        throw IllegalStateException("View while file not open", __FILE__, __LINE__);
+    }
+    if (this->access == WRITE_ONLY) {
+        throw IllegalStateException("View on write-only file", __FILE__, __LINE__);
+    }
+    if ((offset >= this->endPos) || (length == 0)) {
+        return ConstView();
+    }
+
+    File::FileSize len = vislib::math::Min(length, this->endPos - offset);
+    File::FileSize start = this->AlignPosition(offset);
+    File::FileSize ms = offset - start + len;
+    if (ms > static_cast<File::FileSize>(std::numeric_limits<SIZE_T>::max())) {
+        // 32 bit address space: the caller needs to use several smaller views
+        throw IllegalParamException("length", __FILE__, __LINE__);
+    }
+
+    // make sure the pages we are about to see are up to date
+    this->Flush();
+
+#ifdef _WIN32
+    if (this->mapping == INVALID_HANDLE_VALUE || this->mapping == NULL) {
+        throw IllegalStateException("View while mapping invalid", __FILE__, __LINE__);
+    }
+    ULARGE_INTEGER fp;
+    fp.QuadPart = start;
+    char* base = static_cast<char*>(
+        ::MapViewOfFile(this->mapping, FILE_MAP_READ, fp.HighPart, fp.LowPart, static_cast<SIZE_T>(ms)));
+    if (base == NULL) {
+        throw IOException(::GetLastError(), __FILE__, __LINE__);
+    }
+#else  /* _WIN32 */
+    char* base = static_cast<char*>(
+        ::mmap(0, static_cast<size_t>(ms), PROT_READ, MAP_SHARED, this->handle, static_cast<off_t>(start)));
+    if (base == MAP_FAILED) {
+        throw IOException(::GetLastError(), __FILE__, __LINE__);
+    }
+#endif /* _WIN32 */
+
+    ApplyAccessHint(base, static_cast<SIZE_T>(ms), hint);
+    return ConstView(base, static_cast<SIZE_T>(ms), offset, len);
+}
+
+
 /*
  * vislib::sys::MemmappedFile::MemmappedFile copy ctor
  */
@@ -0,0 +1,200 @@
+/*
+ * TransferFunctionLUT.cpp
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "mmcore/view/TransferFunctionLUT.h"
+#include "stdafx.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <utility>
+
+using namespace megamol::core::view;
+
+
+namespace {
+
+/** The maximum number of cached tables */
+const size_t maxCachedTables = 32;
+
+/** The number of values mapped per task */
+const int64_t mapBlockSize = 4096;
+
+/** A cached table and the time of its last use */
+struct CacheEntry {
+    std::shared_ptr<const TransferFunctionLUT> lut;
+    uint64_t lastUse;
+};
+
+std::mutex cacheLock;
+std::map<std::pair<uint64_t, unsigned int>, CacheEntry> cache;
+uint64_t cacheClock = 0;
+
+inline uint64_t fnv1a(uint64_t hash, void const* data, size_t size) {
+    auto bytes = static_cast<unsigned char const*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+} // namespace
+
+
+/*
+ * TransferFunctionLUT::Get
+ */
+std::shared_ptr<const TransferFunctionLUT> TransferFunctionLUT::Get(
+    const AbstractCallGetTransferFunction& call, unsigned int resolution) {
+    return Get(call.GetTextureData(), call.TextureSize(), call.TFTextureFormat(), call.Range(), resolution);
+}
+
+
+/*
+ * TransferFunctionLUT::Get
+ */
+std::shared_ptr<const TransferFunctionLUT> TransferFunctionLUT::Get(float const* texture, unsigned int texSize,
+    AbstractCallGetTransferFunction::TextureFormat format, std::array<float, 2> range, unsigned int resolution) {
+    if ((texture == nullptr) || (texSize == 0)) {
+        return nullptr;
+    }
+    resolution = std::max(resolution, 2u);
+
+    uint64_t hash = 0xcbf29ce484222325ull;
+    hash = fnv1a(hash, &texSize, sizeof(texSize));
+    hash = fnv1a(hash, &format, sizeof(format));
+    hash = fnv1a(hash, range.data(), sizeof(range));
+    hash = fnv1a(hash, texture, texSize * 4 * sizeof(float));
+    hash = fnv1a(hash, &resolution, sizeof(resolution));
+    const auto key = std::make_pair(hash, resolution);
+
+    std::lock_guard<std::mutex> guard(cacheLock);
+    auto it = cache.find(key);
+    if (it == cache.end()) {
+        if (cache.size() >= maxCachedTables) {
+            auto oldest = std::min_element(cache.begin(), cache.end(),
+                [](const auto& lhs, const auto& rhs) { return lhs.second.lastUse < rhs.second.lastUse; });
+            cache.erase(oldest);
+        }
+        CacheEntry entry;
+        entry.lut.reset(new TransferFunctionLUT(texture, texSize, format, range, resolution, hash));
+        it = cache.emplace(key, std::move(entry)).first;
+    }
+    it->second.lastUse = ++cacheClock;
+    return it->second.lut;
+}
+
+
+/*
+ * TransferFunctionLUT::ClearCache
+ */
+void TransferFunctionLUT::ClearCache(void) {
+    std::lock_guard<std::mutex> guard(cacheLock);
+    cache.clear();
+}
+
+
+/*
+ * TransferFunctionLUT::Map
+ */
+void TransferFunctionLUT::Map(
+    float const* values, size_t count, std::array<float, 2> range, float* rgba, size_t stride) const {
+    this->map(values, count, range, rgba, stride);
+}
+
+
+/*
+ * TransferFunctionLUT::Map
+ */
+void TransferFunctionLUT::Map(
+    double const* values, size_t count, std::array<float, 2> range, float* rgba, size_t stride) const {
+    this->map(values, count, range, rgba, stride);
+}
+
+
+/*
+ * TransferFunctionLUT::Sample
+ */
+std::array<float, 4> TransferFunctionLUT::Sample(float value, std::array<float, 2> range) const {
+    std::array<float, 4> rgba;
+    this->map(&value, 1, range, rgba.data(), 0);
+    return rgba;
+}
+
+
+/*
+ * TransferFunctionLUT::TransferFunctionLUT
+ */
+TransferFunctionLUT::TransferFunctionLUT(float const* texture, unsigned int texSize,
+    AbstractCallGetTransferFunction::TextureFormat format, std::array<float, 2> range, unsigned int resolution,
+    uint64_t hash)
+        : table(resolution * 4)
+        , range(range)
+        , hash(hash) {
+    const bool hasAlpha = (format == AbstractCallGetTransferFunction::TEXTURE_FORMAT_RGBA);
+    const float last = static_cast<float>(texSize - 1);
+    for (unsigned int i = 0; i < resolution; ++i) {
+        // texel centres like a linearly filtered texture with clamp to edge
+        const float t = static_cast<float>(i) / static_cast<float>(resolution - 1);
+        const float x = std::min(std::max(t * static_cast<float>(texSize) - 0.5f, 0.0f), last);
+        const unsigned int a = static_cast<unsigned int>(x);
+        const unsigned int b = std::min(a + 1, texSize - 1);
+        const float w = x - static_cast<float>(a);
+        for (unsigned int c = 0; c < 4; ++c) {
+            this->table[4 * i + c] = (1.0f - w) * texture[4 * a + c] + w * texture[4 * b + c];
+        }
+        if (!hasAlpha) {
+            this->table[4 * i + 3] = 1.0f;
+        }
+    }
+}
+
+
+/*
+ * TransferFunctionLUT::map
+ */
+template<class T>
+void TransferFunctionLUT::map(
+    T const* values, size_t count, std::array<float, 2> range, float* rgba, size_t stride) const {
+    if (stride == 0) {
+        stride = sizeof(T);
+    }
+    auto const bytes = reinterpret_cast<char const*>(values);
+    float const* entries = this->table.data();
+    const float last = static_cast<float>(this->Resolution() - 1);
+    const float width = range[1] - range[0];
+    const float scale = (width > 0.0f) ? last / width : 0.0f;
+    const float offset = range[0];
+    const int64_t blockCnt = (static_cast<int64_t>(count) + mapBlockSize - 1) / mapBlockSize;
+
+#pragma omp parallel for if (blockCnt > 1)
+    for (int64_t block = 0; block < blockCnt; ++block) {
+        const int64_t first = block * mapBlockSize;
+        const int64_t cnt = std::min(mapBlockSize, static_cast<int64_t>(count) - first);
+        uint32_t index[mapBlockSize];
+
+        // the index computation vectorizes, NaN maps to the first entry
+#pragma omp simd
+        for (int64_t i = 0; i < cnt; ++i) {
+            T value;
+            std::memcpy(&value, bytes + (first + i) * stride, sizeof(T));
+            float x = (static_cast<float>(value) - offset) * scale;
+            x = (x > 0.0f) ? x : 0.0f;
+            x = (x < last) ? x : last;
+            index[i] = static_cast<uint32_t>(x + 0.5f);
+        }
+
+        float* out = rgba + 4 * first;
+        for (int64_t i = 0; i < cnt; ++i) {
+            std::memcpy(out + 4 * i, entries + 4 * index[i], 4 * sizeof(float));
+        }
+    }
+}
@@ -106,6 +106,7 @@ static std::string nodecoration_option = "nodecoration";
 static std::string topmost_option = "topmost";
 static std::string nocursor_option = "nocursor";
 static std::string interactive_option = "i,interactive";
+static std::string concurrent_calls_option = "concurrent-calls";
 static std::string guishow_option = "guishow";
 static std::string nogui_option = "nogui";
 static std::string guiscale_option = "guiscale";
@@ -386,6 +387,10 @@ static void no_opengl_handler(
     config.no_opengl = parsed_options[option_name].as<bool>();
 #endif
 };
+static void concurrent_calls_handler(
+    std::string const& option_name, cxxopts::ParseResult const& parsed_options, RuntimeConfig& config) {
+    config.concurrent_calls = parsed_options[option_name].as<bool>();
+};
 static void fullscreen_handler(
     std::string const& option_name, cxxopts::ParseResult const& parsed_options, RuntimeConfig& config) {
     config.window_mode |= parsed_options[option_name].as<bool>() * RuntimeConfig::WindowMode::fullscreen;
@@ -535,6 +540,8 @@ std::vector<OptionsListEntry> cli_options_list =
         {nocursor_option, "Do not show mouse cursor inside window", cxxopts::value<bool>(), nocursor_handler},
         {interactive_option, "Run MegaMol even if some project file failed to load", cxxopts::value<bool>(),
             interactive_handler},
+        {concurrent_calls_option, "Execute independent CPU-only data calls of a module concurrently",
+            cxxopts::value<bool>(), concurrent_calls_handler},
         {project_files_option, "Project file(s) to load at startup", cxxopts::value<std::vector<std::string>>(),
             project_handler},
         {guishow_option, "Render GUI overlay", cxxopts::value<bool>(), guishow_handler},
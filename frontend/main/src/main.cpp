@@ -4,6 +4,7 @@
 #include "mmcore/utility/log/DefaultTarget.h"
 #include "mmcore/utility/log/Log.h"
 
+#include "mmcore/CallScheduler.h"
 #include "mmcore/CoreInstance.h"
 #include "mmcore/MegaMolGraph.h"
 
@@ -231,6 +232,7 @@ int main(const int argc, const char** argv) {
 
 
     megamol::core::MegaMolGraph graph(core, moduleProvider, callProvider);
+    megamol::core::CallScheduler::SetEnabled(config.concurrent_calls);
 
     // Graph and Config are also a resources that may be accessed by services
     services.getProvidedResources().push_back({"MegaMolGraph", graph});
@@ -5,6 +5,7 @@
 #include <functional>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -213,6 +214,7 @@ public:
 
     void subscribe_to_updates(update_callback cb);
 
+    // thread-safe, calls may be executed off the graph thread (see CallScheduler)
     void start_timer(handle_type h, frame_type frame);
     void stop_timer(handle_type h);
 
@@ -230,6 +232,8 @@ private:
     handle_type current_handle = 0;
     std::vector<handle_type> handle_holes;
     std::unordered_map<handle_type, std::unique_ptr<Itimer>> timers;
+    // guards timers and current_frame
+    std::mutex timers_lock;
     frame_type current_frame = 0;
     std::vector<update_callback> subscribers;
 };
@@ -47,6 +47,7 @@ struct RuntimeConfig {
     // e.g. "--window 100x200" => mmSetCliOption("window", "100x200")
     //      "--fullscreen"     => mmSetCliOption("fullscreen", "on")
     bool interactive = false;
+    bool concurrent_calls = false; // evaluate independent CPU-only graph branches concurrently
     std::string lua_host_address = "tcp://127.0.0.1:33333";
     bool lua_host_port_retry = true;
     // Different default values for a present openGL
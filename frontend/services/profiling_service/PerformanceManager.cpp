@@ -149,6 +149,7 @@ PerformanceManager::handle_vector PerformanceManager::add_timers(megamol::core::
 }
 
 void PerformanceManager::remove_timers(handle_vector handles) {
+    std::lock_guard<std::mutex> lock(timers_lock);
     for (auto handle : handles) {
         timers.erase(handle);
     }
@@ -156,6 +157,7 @@ void PerformanceManager::remove_timers(handle_vector handles) {
 }
 
 std::string PerformanceManager::lookup_parent(handle_type h) {
+    std::lock_guard<std::mutex> lock(timers_lock);
     const auto& conf = timers[h]->get_conf();
     const auto p = conf.parent_pointer;
     switch (conf.parent_type) {
@@ -173,22 +175,27 @@ std::string PerformanceManager::lookup_parent(handle_type h) {
 }
 
 void* PerformanceManager::lookup_parent_pointer(handle_type h) {
+    std::lock_guard<std::mutex> lock(timers_lock);
     return timers[h]->get_conf().parent_pointer;
 }
 
 PerformanceManager::parent_type PerformanceManager::lookup_parent_type(handle_type h) {
+    std::lock_guard<std::mutex> lock(timers_lock);
     return timers[h]->get_conf().parent_type;
 }
 
 std::string PerformanceManager::lookup_name(handle_type h) {
+    std::lock_guard<std::mutex> lock(timers_lock);
     return timers[h]->get_conf().name;
 }
 
 const PerformanceManager::timer_config PerformanceManager::lookup_config(handle_type h) {
+    std::lock_guard<std::mutex> lock(timers_lock);
     return timers[h]->get_conf();
 }
 
 PerformanceManager::handle_vector PerformanceManager::lookup_timers(void* parent) {
+    std::lock_guard<std::mutex> lock(timers_lock);
     handle_vector vec;
     for (auto& t : timers) {
         if (t.second->get_conf().parent_pointer == parent) {
@@ -199,6 +206,7 @@ PerformanceManager::handle_vector PerformanceManager::lookup_timers(void* parent
 }
 
 void PerformanceManager::set_transient_comment(handle_type h, std::string comment) {
+    std::lock_guard<std::mutex> lock(timers_lock);
     if (timers.find(h) != timers.end()) {
         timers[h]->set_comment(comment);
     } else {
@@ -211,11 +219,13 @@ void PerformanceManager::subscribe_to_updates(update_callback cb) {
 }
 
 void PerformanceManager::start_timer(handle_type h, frame_type frame) {
+    std::lock_guard<std::mutex> lock(timers_lock);
     current_frame = frame;
     timers[h]->start(frame);
 }
 
 void PerformanceManager::stop_timer(handle_type h) {
+    std::lock_guard<std::mutex> lock(timers_lock);
     timers[h]->end();
 }
 
@@ -229,6 +239,7 @@ PerformanceManager::handle_type PerformanceManager::add_timer(std::unique_ptr<It
         current_handle++;
     }
     t->h = my_handle;
+    std::lock_guard<std::mutex> lock(timers_lock);
     auto pair = std::make_pair(my_handle, std::move(t));
     timers.insert(std::move(pair));
     return my_handle;
@@ -243,6 +254,7 @@ void PerformanceManager::endFrame() {
 #endif
 
     frame_info this_frame;
+    std::unique_lock<std::mutex> lock(timers_lock);
     this_frame.frame = current_frame;
 
     for (auto& [key, timer] : timers) {
@@ -251,10 +263,12 @@ void PerformanceManager::endFrame() {
             continue;
         } else {
             if (timer->started) {
-                // timer was not ended this frame, that is not nice
-                megamol::core::utility::log::Log::DefaultLog.WriteWarn(
-                    "PerformanceManager: timer %s was not properly ended in frame %u", timer->get_conf().name.c_str(),
-                    this_frame.frame);
+                // cpu timers of background calls may still be running, everything else is not nice
+                if (timer->get_conf().api != query_api::CPU) {
+                    megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+                        "PerformanceManager: timer %s was not properly ended in frame %u",
+                        timer->get_conf().name.c_str(), this_frame.frame);
+                }
                 continue;
             }
         }
@@ -281,6 +295,7 @@ void PerformanceManager::endFrame() {
             this_frame.entries.push_back(e);
         }
     }
+    lock.unlock(); // subscribers may look up timers
 
     for (auto& subscriber : subscribers) {
         subscriber(this_frame);
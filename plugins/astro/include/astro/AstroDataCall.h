@@ -25,6 +25,20 @@ typedef std::shared_ptr<std::vector<glm::vec3>> vec3ArrayPtr;
 typedef std::shared_ptr<std::vector<float>> floatArrayPtr;
 typedef std::shared_ptr<std::vector<bool>> boolArrayPtr;
 typedef std::shared_ptr<std::vector<int64_t>> idArrayPtr;
+typedef std::shared_ptr<std::vector<uint8_t>> flagArrayPtr;
+
+/**
+ * The bits of the packed particle flags, one byte per particle. The flag
+ * column holds the same information as the separate bool arrays, but
+ * allows testing several flags at once in vectorized loops.
+ */
+enum ParticleFlag : uint8_t {
+    PARTICLE_FLAG_BARYON = 1 << 0,
+    PARTICLE_FLAG_STAR = 1 << 1,
+    PARTICLE_FLAG_WIND = 1 << 2,
+    PARTICLE_FLAG_STAR_FORMING_GAS = 1 << 3,
+    PARTICLE_FLAG_AGN = 1 << 4
+};
 
 class AstroDataCall : public core::AbstractGetData3DCall {
 public:
@@ -501,6 +515,26 @@ public:
         return this->isAGNFlags;
     }
 
+    /**
+     * Sets the packed particle flag vector
+     *
+     * @param flagVec Pointer to the new particle flag vector to be set
+     */
+    inline void SetParticleFlags(flagArrayPtr& flagVec) {
+        this->particleFlags = flagVec;
+    }
+
+    /**
+     * Retrieve the pointer to the vector storing the packed particle flags
+     * Each byte is a combination of 'ParticleFlag' bits. The array may be unset, in which case the separate flag
+     * arrays have to be used.
+     *
+     * @return Pointer to the particle flag array
+     */
+    inline const flagArrayPtr GetParticleFlags(void) const {
+        return this->particleFlags;
+    }
+
     /**
      * Sets the particle ID vector
      *
@@ -569,6 +603,7 @@ public:
         this->isWindFlags.reset();
         this->isStarFormingGasFlags.reset();
         this->isAGNFlags.reset();
+        this->particleFlags.reset();
         this->particleIDs.reset();
         this->agnDistances.reset();
 
@@ -652,6 +687,9 @@ private:
     /** Pointer to the AGN flag array */
     boolArrayPtr isAGNFlags;
 
+    /** Pointer to the packed particle flag array */
+    flagArrayPtr particleFlags;
+
     /** Pointer to the particle ID array */
     idArrayPtr particleIDs;
 
@@ -212,13 +212,22 @@ bool AstroParticleConverter::getSpecialData(Call& call) {
         mass_ = *ast->GetMass().get();
         mw_ = *ast->GetMolecularWeights().get();
 
-        auto isBaryon = ast->GetIsBaryonFlags();
-        std::vector<char> ib(isBaryon->size());
-        for (size_t idx = 0; idx < isBaryon->size(); ++idx) {
-            if (isBaryon->operator[](idx)) {
-                ib[idx] = 1;
-            } else {
-                ib[idx] = 0;
+        std::vector<char> ib;
+        auto flags = ast->GetParticleFlags();
+        if ((flags != nullptr) && (flags->size() == particleCount)) {
+            ib.resize(flags->size());
+            for (size_t idx = 0; idx < flags->size(); ++idx) {
+                ib[idx] = static_cast<char>(((*flags)[idx] & PARTICLE_FLAG_BARYON) != 0);
+            }
+        } else {
+            auto isBaryon = ast->GetIsBaryonFlags();
+            ib.resize(isBaryon->size());
+            for (size_t idx = 0; idx < isBaryon->size(); ++idx) {
+                if (isBaryon->operator[](idx)) {
+                    ib[idx] = 1;
+                } else {
+                    ib[idx] = 0;
+                }
             }
         }
 
@@ -442,6 +451,21 @@ void AstroParticleConverter::calcColorTable(const AstroDataCall& ast) {
     auto useMid = this->useMidColorSlot.Param<param::BoolParam>()->Value();
     float denom = this->valmax - this->valmin;
 
+    // the packed flags are preferred over the separate bool arrays if they cover all particles
+    const auto flagColors = [this, &ast](uint8_t flag, const boolArrayPtr& v, const glm::vec4& setCol,
+                                const glm::vec4& clearedCol) {
+        auto flags = ast.GetParticleFlags();
+        if ((flags != nullptr) && (flags->size() == this->usedColors.size())) {
+            for (size_t i = 0; i < this->usedColors.size(); ++i) {
+                this->usedColors[i] = (((*flags)[i] & flag) != 0) ? setCol : clearedCol;
+            }
+        } else {
+            for (size_t i = 0; i < this->usedColors.size(); ++i) {
+                this->usedColors[i] = v->at(i) ? setCol : clearedCol;
+            }
+        }
+    };
+
     switch (colmode) {
     case megamol::astro::AstroParticleConverter::ColoringMode::MASS: {
         auto v = ast.GetMass();
@@ -499,42 +523,24 @@ void AstroParticleConverter::calcColorTable(const AstroDataCall& ast) {
             this->usedColors[i] = this->interpolateColor(minCol, midCol, maxCol, alpha, useMid);
         }
     } break;
-    case megamol::astro::AstroParticleConverter::ColoringMode::IS_BARYON: {
-        auto v = ast.GetIsBaryonFlags();
-        for (size_t i = 0; i < this->usedColors.size(); ++i) {
-            v->at(i) ? this->usedColors[i] = maxCol : this->usedColors[i] = minCol;
-        }
-    } break;
-    case megamol::astro::AstroParticleConverter::ColoringMode::IS_STAR: {
-        auto v = ast.GetIsStarFlags();
-        for (size_t i = 0; i < this->usedColors.size(); ++i) {
-            v->at(i) ? this->usedColors[i] = maxCol : this->usedColors[i] = minCol;
-        }
-    } break;
-    case megamol::astro::AstroParticleConverter::ColoringMode::IS_WIND: {
-        auto v = ast.GetIsWindFlags();
-        for (size_t i = 0; i < this->usedColors.size(); ++i) {
-            v->at(i) ? this->usedColors[i] = maxCol : this->usedColors[i] = minCol;
-        }
-    } break;
-    case megamol::astro::AstroParticleConverter::ColoringMode::IS_STAR_FORMING_GAS: {
-        auto v = ast.GetIsStarFormingGasFlags();
-        for (size_t i = 0; i < this->usedColors.size(); ++i) {
-            v->at(i) ? this->usedColors[i] = maxCol : this->usedColors[i] = minCol;
-        }
-    } break;
-    case megamol::astro::AstroParticleConverter::ColoringMode::IS_AGN: {
-        auto v = ast.GetIsAGNFlags();
-        for (size_t i = 0; i < this->usedColors.size(); ++i) {
-            v->at(i) ? this->usedColors[i] = maxCol : this->usedColors[i] = minCol;
-        }
-    } break;
-    case megamol::astro::AstroParticleConverter::ColoringMode::IS_DARK_MATTER: { // inverse case to IS_BARYON
-        auto v = ast.GetIsBaryonFlags();
-        for (size_t i = 0; i < this->usedColors.size(); ++i) {
-            v->at(i) ? this->usedColors[i] = minCol : this->usedColors[i] = maxCol;
-        }
-    } break;
+    case megamol::astro::AstroParticleConverter::ColoringMode::IS_BARYON:
+        flagColors(PARTICLE_FLAG_BARYON, ast.GetIsBaryonFlags(), maxCol, minCol);
+        break;
+    case megamol::astro::AstroParticleConverter::ColoringMode::IS_STAR:
+        flagColors(PARTICLE_FLAG_STAR, ast.GetIsStarFlags(), maxCol, minCol);
+        break;
+    case megamol::astro::AstroParticleConverter::ColoringMode::IS_WIND:
+        flagColors(PARTICLE_FLAG_WIND, ast.GetIsWindFlags(), maxCol, minCol);
+        break;
+    case megamol::astro::AstroParticleConverter::ColoringMode::IS_STAR_FORMING_GAS:
+        flagColors(PARTICLE_FLAG_STAR_FORMING_GAS, ast.GetIsStarFormingGasFlags(), maxCol, minCol);
+        break;
+    case megamol::astro::AstroParticleConverter::ColoringMode::IS_AGN:
+        flagColors(PARTICLE_FLAG_AGN, ast.GetIsAGNFlags(), maxCol, minCol);
+        break;
+    case megamol::astro::AstroParticleConverter::ColoringMode::IS_DARK_MATTER: // inverse case to IS_BARYON
+        flagColors(PARTICLE_FLAG_BARYON, ast.GetIsBaryonFlags(), minCol, maxCol);
+        break;
     case megamol::astro::AstroParticleConverter::ColoringMode::INTERNAL_ENERGY_DERIVATIVE: {
         auto v = ast.GetInternalEnergyDerivatives();
         for (size_t i = 0; i < this->usedColors.size(); ++i) {
@@ -129,6 +129,9 @@ bool Contest2019DataLoader::Frame::LoadFrame(std::string filepath, unsigned int
     if (this->isAGNFlags == nullptr) {
         this->isAGNFlags = std::make_shared<std::vector<bool>>();
     }
+    if (this->particleFlags == nullptr) {
+        this->particleFlags = std::make_shared<std::vector<uint8_t>>();
+    }
     if (this->particleIDs == nullptr) {
         this->particleIDs = std::make_shared<std::vector<int64_t>>();
     }
@@ -151,6 +154,7 @@ bool Contest2019DataLoader::Frame::LoadFrame(std::string filepath, unsigned int
     this->isWindFlags->resize(partCount);
     this->isStarFormingGasFlags->resize(partCount);
     this->isAGNFlags->resize(partCount);
+    this->particleFlags->resize(partCount);
     this->particleIDs->resize(partCount);
     this->agnDistances->resize(partCount);
 
@@ -183,6 +187,8 @@ bool Contest2019DataLoader::Frame::LoadFrame(std::string filepath, unsigned int
         this->isWindFlags->operator[](i) = (s.bitmask >> 6) & 0x1;
         this->isStarFormingGasFlags->operator[](i) = (s.bitmask >> 7) & 0x1;
         this->isAGNFlags->operator[](i) = (s.bitmask >> 8) & 0x1;
+        this->particleFlags->operator[](i) =
+            static_cast<uint8_t>(((s.bitmask >> 1) & 0x1) | ((s.bitmask >> 4) & 0x1e)); // bits 1, 5, 6, 7, 8
         this->particleIDs->operator[](i) = s.particleID;
 
         // calculate the temperature ourselves
@@ -241,6 +247,7 @@ void Contest2019DataLoader::Frame::SetData(
     call.SetIsWindFlags(this->isWindFlags);
     call.SetIsStarFormingGasFlags(this->isStarFormingGasFlags);
     call.SetIsAGNFlags(this->isAGNFlags);
+    call.SetParticleFlags(this->particleFlags);
     call.SetParticleIDs(this->particleIDs);
     call.SetAGNDistances(this->agnDistances);
 }
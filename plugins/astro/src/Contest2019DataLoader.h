@@ -127,6 +127,7 @@ protected:
             this->isWindFlags.reset();
             this->isStarFormingGasFlags.reset();
             this->isAGNFlags.reset();
+            this->particleFlags.reset();
             this->particleIDs.reset();
 
             this->velocityDerivatives.reset();
@@ -272,6 +273,9 @@ protected:
         /** Pointer to the AGN flag array */
         boolArrayPtr isAGNFlags = nullptr;
 
+        /** Pointer to the packed particle flag array */
+        flagArrayPtr particleFlags = nullptr;
+
         /** Pointer to the particle ID array */
         idArrayPtr particleIDs = nullptr;
 
@@ -12,8 +12,7 @@
 #include "mmcore/param/IntParam.h"
 #include <algorithm>
 #include <climits>
-#include <queue>
-#include <set>
+#include <cstring>
 
 using namespace megamol;
 using namespace megamol::astro;
@@ -175,6 +174,12 @@ bool FilamentFilter::copyContentToOutCall(AstroDataCall& outCall) {
     outCall.SetIsWindFlags(this->isWindFlags);
     outCall.SetIsStarFormingGasFlags(this->isStarFormingGasFlags);
     outCall.SetIsAGNFlags(this->isAGNFlags);
+    // an input without packed flags leaves them empty, consumers then have to use the separate flag arrays
+    flagArrayPtr flags = this->particleFlags;
+    if ((flags != nullptr) && ((this->positions == nullptr) || (flags->size() != this->positions->size()))) {
+        flags = nullptr;
+    }
+    outCall.SetParticleFlags(flags);
     outCall.SetParticleIDs(this->particleIDs);
     return true;
 }
@@ -228,6 +233,9 @@ void FilamentFilter::initFields(void) {
     if (this->isAGNFlags == nullptr) {
         this->isAGNFlags = std::make_shared<std::vector<bool>>();
     }
+    if (this->particleFlags == nullptr) {
+        this->particleFlags = std::make_shared<std::vector<uint8_t>>();
+    }
     if (this->particleIDs == nullptr) {
         this->particleIDs = std::make_shared<std::vector<int64_t>>();
     }
@@ -245,32 +253,25 @@ std::pair<float, float> FilamentFilter::getMinMaxDensity(const AstroDataCall& ca
 }
 
 /*
- * FilamentFilter::getMinMaxDensity
+ * FilamentFilter::retrieveDensityCandidateList
  */
-void FilamentFilter::retrieveDensityCandidateList(
-    const AstroDataCall& call, std::vector<std::pair<float, uint64_t>>& result) {
+void FilamentFilter::retrieveDensityCandidateList(const AstroDataCall& call, std::vector<uint64_t>& result) {
     result.clear();
-    const auto& dens = call.GetDensity();
-    if (dens == nullptr)
+    if (this->sortedDensities.empty())
         return;
-    auto minmax = this->getMinMaxDensity(call);
-    result.resize(dens->size());
-    for (uint64_t i = 0; i < dens->size(); i++) {
-        result[i] = std::make_pair(dens->at(i), i);
-    }
-    // sort all the densities in descending order and only keep a certain percentage
-    std::sort(result.rbegin(), result.rend());
+    // the densities are sorted in descending order once per data set, only a certain percentage is kept
     float percentage = this->densitySeedPercentageSlot.Param<param::FloatParam>()->Value();
     percentage = 100.0f - percentage;
     percentage /= 100.0f;
-    float minDensity = percentage * minmax.second;
-    auto foundval =
-        std::find_if(result.begin(), result.end(), [&minDensity](const auto& x) { return minDensity > x.first; });
-    result.erase(foundval, result.end());
+    float minDensity = percentage * this->sortedDensities.front().first;
+    auto foundval = std::find_if(this->sortedDensities.begin(), this->sortedDensities.end(),
+        [&minDensity](const auto& x) { return minDensity > x.first; });
     const auto maxPartCount = static_cast<uint64_t>(
         call.GetParticleCount() * (this->maxParticlePercentageCuttoff.Param<param::FloatParam>()->Value() / 100.0f));
-    if (result.size() > maxPartCount) {
-        result.resize(maxPartCount);
+    const auto count = std::min(static_cast<uint64_t>(foundval - this->sortedDensities.begin()), maxPartCount);
+    result.resize(count);
+    for (uint64_t i = 0; i < count; ++i) {
+        result[i] = this->sortedDensities[i].second;
     }
 }
 
@@ -279,6 +280,12 @@ void FilamentFilter::retrieveDensityCandidateList(
  */
 void FilamentFilter::initSearchStructure(const AstroDataCall& call) {
     const auto& posPtr = call.GetPositions();
+    if ((this->searchIndexPtr != nullptr) && (this->searchPositions == posPtr->data()) &&
+        (this->searchCount == posPtr->size()) && (this->searchDataHash == call.DataHash()) &&
+        (this->searchFrameID == call.FrameID())) {
+        // only parameters changed, the positions are still indexed
+        return;
+    }
     this->pointCloud.pts.resize(posPtr->size());
     std::memcpy(this->pointCloud.pts.data(), posPtr->data(), posPtr->size() * sizeof(glm::vec3));
     if (this->searchIndexPtr != nullptr) {
@@ -287,133 +294,149 @@ void FilamentFilter::initSearchStructure(const AstroDataCall& call) {
     this->searchIndexPtr =
         std::make_shared<my_kd_tree_t>(3, this->pointCloud, nanoflann::KDTreeSingleIndexAdaptorParams(10));
     this->searchIndexPtr->buildIndex();
+
+    this->sortedDensities.clear();
+    const auto& dens = call.GetDensity();
+    if ((dens != nullptr) && (dens->size() == posPtr->size())) {
+        this->sortedDensities.resize(dens->size());
+        for (uint64_t i = 0; i < dens->size(); i++) {
+            this->sortedDensities[i] = std::make_pair(dens->at(i), i);
+        }
+        std::sort(this->sortedDensities.rbegin(), this->sortedDensities.rend());
+    }
+
+    this->searchPositions = posPtr->data();
+    this->searchCount = posPtr->size();
+    this->searchDataHash = call.DataHash();
+    this->searchFrameID = call.FrameID();
 }
 
 /*
  * FilamentFilter::copyInCallToContent
  */
-bool FilamentFilter::copyInCallToContent(const AstroDataCall& inCall, const std::set<uint64_t>& indexSet) {
-    this->positions->resize(indexSet.size());
-    this->velocities->resize(indexSet.size());
-    this->temperatures->resize(indexSet.size());
-    this->masses->resize(indexSet.size());
-    this->internalEnergies->resize(indexSet.size());
-    this->smoothingLengths->resize(indexSet.size());
-    this->molecularWeights->resize(indexSet.size());
-    this->densities->resize(indexSet.size());
-    this->gravitationalPotentials->resize(indexSet.size());
-    this->entropies->resize(indexSet.size());
-    this->isBaryonFlags->resize(indexSet.size());
-    this->isStarFlags->resize(indexSet.size());
-    this->isWindFlags->resize(indexSet.size());
-    this->isStarFormingGasFlags->resize(indexSet.size());
-    this->isAGNFlags->resize(indexSet.size());
-    this->particleIDs->resize(indexSet.size());
-
-    std::vector<uint64_t> setVec(indexSet.begin(), indexSet.end());
-    std::sort(setVec.begin(), setVec.end());
-
-    uint64_t i = 0;
-    for (const auto id : setVec) {
-        this->positions->at(i) = inCall.GetPositions()->at(id);
-        this->velocities->at(i) = inCall.GetVelocities()->at(id);
-        this->temperatures->at(i) = inCall.GetTemperature()->at(id);
-        this->masses->at(i) = inCall.GetMass()->at(id);
-        this->internalEnergies->at(i) = inCall.GetInternalEnergy()->at(id);
-        this->smoothingLengths->at(i) = inCall.GetSmoothingLength()->at(id);
-        this->molecularWeights->at(i) = inCall.GetMolecularWeights()->at(id);
-        this->densities->at(i) = inCall.GetDensity()->at(id);
-        this->gravitationalPotentials->at(i) = inCall.GetGravitationalPotential()->at(id);
-        this->entropies->at(i) = inCall.GetEntropy()->at(i);
-        this->isBaryonFlags->at(i) = inCall.GetIsBaryonFlags()->at(id);
-        this->isStarFlags->at(i) = inCall.GetIsStarFlags()->at(id);
-        this->isWindFlags->at(i) = inCall.GetIsWindFlags()->at(id);
-        this->isStarFormingGasFlags->at(i) = inCall.GetIsStarFormingGasFlags()->at(id);
-        this->isAGNFlags->at(i) = inCall.GetIsAGNFlags()->at(id);
-        this->particleIDs->at(i) = inCall.GetParticleIDs()->at(id);
-        ++i;
-    }
+bool FilamentFilter::copyInCallToContent(const AstroDataCall& inCall) {
+    const size_t count = this->selection.GetParticleCount();
+    const auto gather = [this, count](const auto& src, auto& dst) {
+        if ((src != nullptr) && (src->size() == count)) {
+            this->selection.Gather(*src, *dst);
+        } else {
+            dst->clear();
+        }
+    };
+    gather(inCall.GetPositions(), this->positions);
+    gather(inCall.GetVelocities(), this->velocities);
+    gather(inCall.GetTemperature(), this->temperatures);
+    gather(inCall.GetMass(), this->masses);
+    gather(inCall.GetInternalEnergy(), this->internalEnergies);
+    gather(inCall.GetSmoothingLength(), this->smoothingLengths);
+    gather(inCall.GetMolecularWeights(), this->molecularWeights);
+    gather(inCall.GetDensity(), this->densities);
+    gather(inCall.GetGravitationalPotential(), this->gravitationalPotentials);
+    gather(inCall.GetEntropy(), this->entropies);
+    gather(inCall.GetIsBaryonFlags(), this->isBaryonFlags);
+    gather(inCall.GetIsStarFlags(), this->isStarFlags);
+    gather(inCall.GetIsWindFlags(), this->isWindFlags);
+    gather(inCall.GetIsStarFormingGasFlags(), this->isStarFormingGasFlags);
+    gather(inCall.GetIsAGNFlags(), this->isAGNFlags);
+    gather(inCall.GetParticleFlags(), this->particleFlags);
+    gather(inCall.GetParticleIDs(), this->particleIDs);
     return true;
 }
 
 /*
- * FilamentFilter::filterFilaments
+ * FilamentFilter::growClusters
  */
-bool FilamentFilter::filterFilaments(const AstroDataCall& call) {
-    if (call.GetPositions() == nullptr)
-        return false;
-    std::vector<std::pair<float, uint64_t>> densityPeaks;
-    this->retrieveDensityCandidateList(call, densityPeaks);
-    std::set<uint64_t> candidateSet;
-    for (const auto& a : densityPeaks) {
-        candidateSet.insert(a.second);
+void FilamentFilter::growClusters(
+    const AstroDataCall& call, const std::vector<uint64_t>& seeds, std::vector<uint8_t>& keep) {
+    const uint32_t noCluster = UINT_MAX;
+    const size_t batchSize = 4096;
+    const auto& positions = *call.GetPositions();
+    const float searchRadius = this->radiusSlot.Param<param::FloatParam>()->Value();
+    nanoflann::SearchParams searchParams;
+    searchParams.sorted = false;
+
+    // each seed starts a cluster, clusters are merged whenever their particles are within the radius
+    std::vector<uint32_t> cluster(positions.size(), noCluster);
+    std::vector<uint32_t> parent;
+    const auto root = [&parent](uint32_t c) {
+        while (parent[c] != c) {
+            parent[c] = parent[parent[c]];
+            c = parent[c];
+        }
+        return c;
+    };
+    std::vector<uint64_t> frontier;
+    std::vector<uint64_t> next;
+    for (const auto s : seeds) {
+        if (cluster[s] == noCluster) {
+            cluster[s] = static_cast<uint32_t>(parent.size());
+            parent.push_back(cluster[s]);
+            frontier.push_back(s);
+        }
     }
-    this->initSearchStructure(call);
-    if (this->searchIndexPtr == nullptr)
-        return false;
-
-    // the following approach is not really performant, but it should work
-    std::vector<std::set<uint64_t>> setVec;
-    std::vector<bool> calculatedFlags(call.GetPositions()->size(), false);
 
-    nanoflann::SearchParams searchParams;
-    float searchRadius = this->radiusSlot.Param<param::FloatParam>()->Value();
-    std::vector<std::pair<size_t, float>> searchResults;
-    std::set<uint64_t> toProcessSet;
-
-    while (!candidateSet.empty()) {
-        auto current = *candidateSet.begin();
-        auto position = call.GetPositions()->at(current);
-        setVec.push_back(std::set<uint64_t>());
-        setVec.back().insert(current);
-        toProcessSet.clear();
-        calculatedFlags[current] = true;
-        const auto nMatches =
-            this->searchIndexPtr->radiusSearch(&position.x, searchRadius * searchRadius, searchResults, searchParams);
-        // insert everything in the vicinity of the current candidate to the queue
-        for (const auto& v : searchResults) {
-            uint64_t index = v.first;
-            if (index == current)
-                continue;
-            if (!calculatedFlags[index]) {
-                toProcessSet.insert(index);
-                setVec.back().insert(index);
-                calculatedFlags[index] = true;
+    // grow all clusters level by level, the radius queries of a batch run in parallel
+    while (!frontier.empty()) {
+        next.clear();
+        for (size_t begin = 0; begin < frontier.size(); begin += batchSize) {
+            const int64_t batch = static_cast<int64_t>(std::min(batchSize, frontier.size() - begin));
+            this->searchResults.resize(batchSize);
+#pragma omp parallel for schedule(dynamic, 16)
+            for (int64_t b = 0; b < batch; ++b) {
+                const auto& pos = positions[frontier[begin + b]];
+                this->searchIndexPtr->radiusSearch(
+                    &pos.x, searchRadius * searchRadius, this->searchResults[b], searchParams);
             }
-        }
-        while (!toProcessSet.empty()) {
-            auto cur = *toProcessSet.begin();
-            auto pos = call.GetPositions()->at(cur);
-            searchResults.clear();
-            const auto matches =
-                this->searchIndexPtr->radiusSearch(&pos.x, searchRadius * searchRadius, searchResults, searchParams);
-            for (const auto& v : searchResults) {
-                uint64_t index = v.first;
-                if (index == cur)
-                    continue;
-                if (!calculatedFlags[index]) {
-                    toProcessSet.insert(index);
-                    setVec.back().insert(index);
-                    calculatedFlags[index] = true;
+            for (int64_t b = 0; b < batch; ++b) {
+                uint32_t c = root(cluster[frontier[begin + b]]);
+                for (const auto& v : this->searchResults[b]) {
+                    const uint64_t index = v.first;
+                    if (cluster[index] == noCluster) {
+                        cluster[index] = c;
+                        next.push_back(index);
+                    } else {
+                        const uint32_t other = root(cluster[index]);
+                        if (other != c) {
+                            parent[std::max(other, c)] = std::min(other, c);
+                            c = std::min(other, c);
+                        }
+                    }
                 }
             }
-            toProcessSet.erase(cur);
-            candidateSet.erase(cur);
         }
-        candidateSet.erase(current);
+        frontier.swap(next);
     }
+
     // erase too small clusters
-    auto minClusterSize = this->minClusterSizeSlot.Param<param::IntParam>()->Value();
-    for (auto it = setVec.begin(); it != setVec.end(); /* intentionally empty*/) {
-        if ((*it).size() < minClusterSize) {
-            it = setVec.erase(it);
-        } else {
-            ++it;
+    std::vector<uint64_t> clusterSizes(parent.size(), 0);
+    for (auto& c : cluster) {
+        if (c != noCluster) {
+            c = root(c);
+            ++clusterSizes[c];
         }
     }
-    std::set<uint64_t> endset;
-    for (const auto& s : setVec) {
-        endset.insert(s.begin(), s.end());
+    const uint64_t minClusterSize = static_cast<uint64_t>(this->minClusterSizeSlot.Param<param::IntParam>()->Value());
+    keep.resize(positions.size());
+    for (size_t i = 0; i < positions.size(); ++i) {
+        keep[i] = static_cast<uint8_t>((cluster[i] != noCluster) && (clusterSizes[cluster[i]] >= minClusterSize));
     }
-    return this->copyInCallToContent(call, endset);
+}
+
+/*
+ * FilamentFilter::filterFilaments
+ */
+bool FilamentFilter::filterFilaments(const AstroDataCall& call) {
+    if (call.GetPositions() == nullptr)
+        return false;
+    this->initSearchStructure(call);
+    if (this->searchIndexPtr == nullptr)
+        return false;
+    std::vector<uint64_t> densityPeaks;
+    this->retrieveDensityCandidateList(call, densityPeaks);
+
+    std::vector<uint8_t> keep;
+    this->growClusters(call, densityPeaks, keep);
+    this->selection.Reset(keep.size());
+    this->selection.RequireMask(keep);
+    return this->copyInCallToContent(call);
 }
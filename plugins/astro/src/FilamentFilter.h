@@ -6,13 +6,13 @@
  */
 #pragma once
 
+#include "ParticleSelection.h"
 #include "astro/AstroDataCall.h"
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/CallerSlot.h"
 #include "mmcore/Module.h"
 #include "mmcore/param/ParamSlot.h"
 #include <nanoflann.hpp>
-#include <set>
 
 
 namespace megamol {
@@ -84,11 +84,12 @@ private:
 
     void initFields(void);
     std::pair<float, float> getMinMaxDensity(const AstroDataCall& call) const;
-    void retrieveDensityCandidateList(const AstroDataCall& call, std::vector<std::pair<float, uint64_t>>& result);
+    void retrieveDensityCandidateList(const AstroDataCall& call, std::vector<uint64_t>& result);
     bool filterFilaments(const AstroDataCall& call);
     bool copyContentToOutCall(AstroDataCall& outCall);
-    bool copyInCallToContent(const AstroDataCall& inCall, const std::set<uint64_t>& indexSet);
+    bool copyInCallToContent(const AstroDataCall& inCall);
     void initSearchStructure(const AstroDataCall& call);
+    void growClusters(const AstroDataCall& call, const std::vector<uint64_t>& seeds, std::vector<uint8_t>& keep);
 
     core::CalleeSlot filamentOutSlot;
     core::CallerSlot particlesInSlot;
@@ -106,6 +107,27 @@ private:
     std::shared_ptr<my_kd_tree_t> searchIndexPtr = nullptr;
     PointCloud<float> pointCloud;
 
+    /** The positions the search structure was built for */
+    const glm::vec3* searchPositions = nullptr;
+
+    /** The number of positions in the search structure */
+    size_t searchCount = 0;
+
+    /** The data hash of the positions in the search structure */
+    uint64_t searchDataHash = 0;
+
+    /** The frame of the positions in the search structure */
+    uint32_t searchFrameID = 0;
+
+    /** The densities and indices of the indexed particles in descending order */
+    std::vector<std::pair<float, uint64_t>> sortedDensities;
+
+    /** The results of the radius queries of one batch */
+    std::vector<std::vector<std::pair<size_t, float>>> searchResults;
+
+    /** The particles in the filaments */
+    ParticleSelection selection;
+
     /** Pointer to the position array */
     vec3ArrayPtr positions = nullptr;
 
@@ -151,6 +173,9 @@ private:
     /** Pointer to the AGN flag array */
     boolArrayPtr isAGNFlags = nullptr;
 
+    /** Pointer to the packed particle flag array */
+    flagArrayPtr particleFlags = nullptr;
+
     /** Pointer to the particle ID array */
     idArrayPtr particleIDs = nullptr;
 
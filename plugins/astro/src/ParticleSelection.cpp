@@ -0,0 +1,145 @@
+/*
+ * ParticleSelection.cpp
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "ParticleSelection.h"
+#include "stdafx.h"
+
+#include <algorithm>
+
+using namespace megamol::astro;
+
+/*
+ * ParticleSelection::Reset
+ */
+void ParticleSelection::Reset(size_t count) {
+    this->mask.assign(count, 1);
+    this->indicesValid = false;
+}
+
+/*
+ * ParticleSelection::RequireFlags
+ */
+bool ParticleSelection::RequireFlags(const std::vector<uint8_t>& flags, uint8_t set, uint8_t cleared) {
+    if (flags.size() != this->mask.size()) {
+        return false;
+    }
+    const uint8_t* f = flags.data();
+    uint8_t* m = this->mask.data();
+    const size_t cnt = this->mask.size();
+#pragma omp simd
+    for (size_t i = 0; i < cnt; ++i) {
+        m[i] &= static_cast<uint8_t>(((f[i] & set) == set) & ((f[i] & cleared) == 0));
+    }
+    this->indicesValid = false;
+    return true;
+}
+
+/*
+ * ParticleSelection::RequireFlag
+ */
+bool ParticleSelection::RequireFlag(const std::vector<bool>& flags, bool value) {
+    if (flags.size() != this->mask.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < this->mask.size(); ++i) {
+        this->mask[i] &= static_cast<uint8_t>(flags[i] == value);
+    }
+    this->indicesValid = false;
+    return true;
+}
+
+/*
+ * ParticleSelection::RequireMask
+ */
+bool ParticleSelection::RequireMask(const std::vector<uint8_t>& keep) {
+    if (keep.size() != this->mask.size()) {
+        return false;
+    }
+    const uint8_t* k = keep.data();
+    uint8_t* m = this->mask.data();
+    const size_t cnt = this->mask.size();
+#pragma omp simd
+    for (size_t i = 0; i < cnt; ++i) {
+        m[i] &= k[i];
+    }
+    this->indicesValid = false;
+    return true;
+}
+
+/*
+ * ParticleSelection::RequireRange
+ */
+bool ParticleSelection::RequireRange(const std::vector<float>& values, float min, float max) {
+    if (values.size() != this->mask.size()) {
+        return false;
+    }
+    const float* v = values.data();
+    uint8_t* m = this->mask.data();
+    const size_t cnt = this->mask.size();
+#pragma omp simd
+    for (size_t i = 0; i < cnt; ++i) {
+        m[i] &= static_cast<uint8_t>(!((v[i] < min) | (v[i] > max)));
+    }
+    this->indicesValid = false;
+    return true;
+}
+
+/*
+ * ParticleSelection::RequireLengthRange
+ */
+bool ParticleSelection::RequireLengthRange(const std::vector<glm::vec3>& values, float min, float max) {
+    if (values.size() != this->mask.size()) {
+        return false;
+    }
+    this->indicesValid = false;
+    if (max < 0.0f) {
+        std::fill(this->mask.begin(), this->mask.end(), 0);
+        return true;
+    }
+    // comparing the squared lengths avoids the square roots
+    const float minSq = (min > 0.0f) ? min * min : 0.0f;
+    const float maxSq = max * max;
+    const glm::vec3* v = values.data();
+    uint8_t* m = this->mask.data();
+    const size_t cnt = this->mask.size();
+#pragma omp simd
+    for (size_t i = 0; i < cnt; ++i) {
+        const float l = v[i].x * v[i].x + v[i].y * v[i].y + v[i].z * v[i].z;
+        m[i] &= static_cast<uint8_t>(!((l < minSq) | (l > maxSq)));
+    }
+    return true;
+}
+
+/*
+ * ParticleSelection::Indices
+ */
+const std::vector<uint64_t>& ParticleSelection::Indices(void) {
+    if (!this->indicesValid) {
+        const size_t cnt = this->mask.size();
+        this->indices.resize(cnt);
+        size_t selected = 0;
+        for (size_t i = 0; i < cnt; ++i) {
+            this->indices[selected] = i;
+            selected += this->mask[i];
+        }
+        this->indices.resize(selected);
+        this->indicesValid = true;
+    }
+    return this->indices;
+}
+
+/*
+ * ParticleSelection::Gather
+ */
+void ParticleSelection::Gather(const std::vector<bool>& src, std::vector<bool>& dst) {
+    const auto& idx = this->Indices();
+    dst.resize(idx.size());
+    for (size_t i = 0; i < idx.size(); ++i) {
+        dst[i] = src[idx[i]];
+    }
+}
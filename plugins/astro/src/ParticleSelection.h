@@ -0,0 +1,146 @@
+/*
+ * ParticleSelection.h
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace megamol {
+namespace astro {
+
+/**
+ * Selection of the particles of an AstroDataCall passing a set of
+ * predicates.
+ *
+ * The selection is kept as one byte per particle, so each predicate is a
+ * branch-free loop over one attribute column that the compiler vectorizes.
+ * The result is a vector of the selected indices, which is used to gather
+ * the attribute columns into buffers that are reused between the frames.
+ */
+class ParticleSelection {
+public:
+    /**
+     * Selects all particles.
+     *
+     * @param count The number of particles.
+     */
+    void Reset(size_t count);
+
+    /**
+     * Deselects the particles missing one of the flags in 'set' or having
+     * one of the flags in 'cleared'.
+     *
+     * @param flags   The packed particle flags.
+     * @param set     The 'ParticleFlag' bits that must be set.
+     * @param cleared The 'ParticleFlag' bits that must not be set.
+     *
+     * @return 'false' if the number of values does not match.
+     */
+    bool RequireFlags(const std::vector<uint8_t>& flags, uint8_t set, uint8_t cleared);
+
+    /**
+     * Deselects the particles with a flag other than 'value'.
+     *
+     * @param flags The particle flags.
+     * @param value The required value.
+     *
+     * @return 'false' if the number of values does not match.
+     */
+    bool RequireFlag(const std::vector<bool>& flags, bool value);
+
+    /**
+     * Deselects the particles with a zero entry in 'keep'.
+     *
+     * @param keep One byte per particle, 0 or 1.
+     *
+     * @return 'false' if the number of values does not match.
+     */
+    bool RequireMask(const std::vector<uint8_t>& keep);
+
+    /**
+     * Deselects the particles with values outside [min, max].
+     *
+     * @param values The attribute values.
+     * @param min    The smallest accepted value.
+     * @param max    The largest accepted value.
+     *
+     * @return 'false' if the number of values does not match.
+     */
+    bool RequireRange(const std::vector<float>& values, float min, float max);
+
+    /**
+     * Deselects the particles with vector lengths outside [min, max].
+     *
+     * @param values The attribute vectors.
+     * @param min    The smallest accepted length.
+     * @param max    The largest accepted length.
+     *
+     * @return 'false' if the number of values does not match.
+     */
+    bool RequireLengthRange(const std::vector<glm::vec3>& values, float min, float max);
+
+    /**
+     * Answer the indices of the selected particles in ascending order.
+     *
+     * @return The selected indices.
+     */
+    const std::vector<uint64_t>& Indices(void);
+
+    /**
+     * Answer the number of particles the selection was reset to.
+     *
+     * @return The number of particles.
+     */
+    inline size_t GetParticleCount(void) const {
+        return this->mask.size();
+    }
+
+    /**
+     * Copies the selected elements of 'src' to 'dst'. The memory of 'dst'
+     * is reused if it is large enough.
+     *
+     * @param src The full attribute column.
+     * @param dst Receives the selected values.
+     */
+    template<class T>
+    void Gather(const std::vector<T>& src, std::vector<T>& dst) {
+        const auto& idx = this->Indices();
+        const int64_t cnt = static_cast<int64_t>(idx.size());
+        dst.resize(idx.size());
+#pragma omp parallel for
+        for (int64_t i = 0; i < cnt; ++i) {
+            dst[i] = src[idx[i]];
+        }
+    }
+
+    /**
+     * Copies the selected elements of 'src' to 'dst'. The bits of
+     * std::vector<bool> share words, so they are copied sequentially.
+     *
+     * @param src The full flag column.
+     * @param dst Receives the selected flags.
+     */
+    void Gather(const std::vector<bool>& src, std::vector<bool>& dst);
+
+private:
+    /** One byte per particle, 1 if the particle is selected */
+    std::vector<uint8_t> mask;
+
+    /** The selected indices */
+    std::vector<uint64_t> indices;
+
+    /** Flag whether 'indices' matches 'mask' */
+    bool indicesValid = false;
+};
+
+} // namespace astro
+} // namespace megamol
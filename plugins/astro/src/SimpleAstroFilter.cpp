@@ -9,8 +9,10 @@
 #include "mmcore/param/BoolParam.h"
 #include "mmcore/param/ButtonParam.h"
 #include "mmcore/param/FloatParam.h"
+#include "mmcore/utility/log/Log.h"
+#include <cfloat>
 #include <climits>
-#include <numeric>
+#include <utility>
 
 using namespace megamol;
 using namespace megamol::astro;
@@ -303,6 +305,9 @@ void SimpleAstroFilter::initFields(void) {
     if (this->particleIDs == nullptr) {
         this->particleIDs = std::make_shared<std::vector<int64_t>>();
     }
+    if (this->particleFlags == nullptr) {
+        this->particleFlags = std::make_shared<std::vector<uint8_t>>();
+    }
     if (this->agnDistances == nullptr) {
         this->agnDistances = std::make_shared<std::vector<float>>();
     }
@@ -312,97 +317,115 @@ void SimpleAstroFilter::initFields(void) {
  * SimpleAstroFilter::filter
  */
 bool SimpleAstroFilter::filter(const AstroDataCall& call) {
-    std::set<uint64_t> filterResult;
-    std::vector<uint64_t> help(call.GetParticleCount());
-    std::iota(help.begin(), help.end(), 0);
-    filterResult.insert(help.begin(), help.end());
-
-    for (uint64_t i = 0; i < call.GetParticleCount(); ++i) {
-        if (this->showOnlyBaryonParam.Param<param::BoolParam>()->Value() && !call.GetIsBaryonFlags()->at(i)) {
-            filterResult.erase(i);
-        }
-        if (this->showOnlyDarkMatterParam.Param<param::BoolParam>()->Value() && call.GetIsBaryonFlags()->at(i)) {
-            filterResult.erase(i);
-        }
-        if (this->showOnlyStarsParam.Param<param::BoolParam>()->Value() && !call.GetIsStarFlags()->at(i)) {
-            filterResult.erase(i);
-        }
-        if (this->showOnlyWindParam.Param<param::BoolParam>()->Value() && !call.GetIsWindFlags()->at(i)) {
-            filterResult.erase(i);
-        }
-        if (this->showOnlyStarFormingGasParam.Param<param::BoolParam>()->Value() &&
-            !call.GetIsStarFormingGasFlags()->at(i)) {
-            filterResult.erase(i);
-        }
-        if (this->showOnlyAGNsParam.Param<param::BoolParam>()->Value() && !call.GetIsAGNFlags()->at(i)) {
-            filterResult.erase(i);
-        }
-        if (this->filterVelocityMagnitudeParam.Param<param::BoolParam>()->Value()) {
-            if (glm::length(call.GetVelocities()->at(i)) <
-                    this->minVelocityMagnitudeParam.Param<param::FloatParam>()->Value() ||
-                glm::length(call.GetVelocities()->at(i)) >
-                    this->maxVelocityMagnitudeParam.Param<param::FloatParam>()->Value()) {
-                filterResult.erase(i);
-            }
-        }
-        if (this->filterTemperatureParam.Param<param::BoolParam>()->Value()) {
-            if (call.GetTemperature()->at(i) < this->minTemperatureParam.Param<param::FloatParam>()->Value() ||
-                call.GetTemperature()->at(i) > this->maxTemperatureParam.Param<param::FloatParam>()->Value()) {
-                filterResult.erase(i);
-            }
-        }
-        if (this->filterMassParam.Param<param::BoolParam>()->Value()) {
-            if (call.GetMass()->at(i) < this->minMassParam.Param<param::FloatParam>()->Value() ||
-                call.GetMass()->at(i) > this->maxMassParam.Param<param::FloatParam>()->Value()) {
-                filterResult.erase(i);
-            }
-        }
-        if (this->filterInternalEnergyParam.Param<param::BoolParam>()->Value()) {
-            if (call.GetInternalEnergy()->at(i) < this->minInternalEnergyParam.Param<param::FloatParam>()->Value() ||
-                call.GetInternalEnergy()->at(i) > this->maxInternalEnergyParam.Param<param::FloatParam>()->Value()) {
-                filterResult.erase(i);
-            }
-        }
-        if (this->filterSmoothingLengthParam.Param<param::BoolParam>()->Value()) {
-            if (call.GetSmoothingLength()->at(i) < this->minSmoothingLengthParam.Param<param::FloatParam>()->Value() ||
-                call.GetSmoothingLength()->at(i) > this->maxSmoothingLengthParam.Param<param::FloatParam>()->Value()) {
-                filterResult.erase(i);
-            }
-        }
-        if (this->filterMolecularWeightParam.Param<param::BoolParam>()->Value()) {
-            if (call.GetMolecularWeights()->at(i) < this->minMolecularWeightParam.Param<param::FloatParam>()->Value() ||
-                call.GetMolecularWeights()->at(i) > this->maxMolecularWeightParam.Param<param::FloatParam>()->Value()) {
-                filterResult.erase(i);
-            }
-        }
-        if (this->filterDensityParam.Param<param::BoolParam>()->Value()) {
-            if (call.GetDensity()->at(i) < this->minDensityParam.Param<param::FloatParam>()->Value() ||
-                call.GetDensity()->at(i) > this->maxDensityParam.Param<param::FloatParam>()->Value()) {
-                filterResult.erase(i);
-            }
-        }
-        if (this->filterGravitationalPotentialParam.Param<param::BoolParam>()->Value()) {
-            if (call.GetGravitationalPotential()->at(i) <
-                    this->minGravitationalPotentialParam.Param<param::FloatParam>()->Value() ||
-                call.GetGravitationalPotential()->at(i) >
-                    this->maxGravitationalPotentialParam.Param<param::FloatParam>()->Value()) {
-                filterResult.erase(i);
-            }
-        }
-        if (this->filterEntropyParam.Param<param::BoolParam>()->Value()) {
-            if (call.GetEntropy()->at(i) < this->minEntropyParam.Param<param::FloatParam>()->Value() ||
-                call.GetEntropy()->at(i) > this->maxEntropyParam.Param<param::FloatParam>()->Value()) {
-                filterResult.erase(i);
-            }
-        }
-        if (this->filterAgnDistanceParam.Param<param::BoolParam>()->Value()) {
-            if (call.GetAgnDistances()->at(i) < this->minAgnDistanceParam.Param<param::FloatParam>()->Value() ||
-                call.GetAgnDistances()->at(i) > this->maxAgnDistanceParam.Param<param::FloatParam>()->Value()) {
-                filterResult.erase(i);
+    const size_t count = call.GetParticleCount();
+    this->selection.Reset(count);
+    bool active = false;
+    const auto require = [&active](bool matching, const char* name) {
+        active = true;
+        if (!matching) {
+            core::utility::log::Log::DefaultLog.WriteWarn(
+                "SimpleAstroFilter: The %s values do not match the particle count and are ignored.", name);
+        }
+    };
+
+    // all flag criteria are tested in one pass over the packed flags
+    uint8_t set = 0;
+    uint8_t cleared = 0;
+    if (this->showOnlyBaryonParam.Param<param::BoolParam>()->Value()) {
+        set |= PARTICLE_FLAG_BARYON;
+    }
+    if (this->showOnlyDarkMatterParam.Param<param::BoolParam>()->Value()) {
+        cleared |= PARTICLE_FLAG_BARYON;
+    }
+    if (this->showOnlyStarsParam.Param<param::BoolParam>()->Value()) {
+        set |= PARTICLE_FLAG_STAR;
+    }
+    if (this->showOnlyWindParam.Param<param::BoolParam>()->Value()) {
+        set |= PARTICLE_FLAG_WIND;
+    }
+    if (this->showOnlyStarFormingGasParam.Param<param::BoolParam>()->Value()) {
+        set |= PARTICLE_FLAG_STAR_FORMING_GAS;
+    }
+    if (this->showOnlyAGNsParam.Param<param::BoolParam>()->Value()) {
+        set |= PARTICLE_FLAG_AGN;
+    }
+    if ((set | cleared) != 0) {
+        const auto flags = call.GetParticleFlags();
+        if ((flags != nullptr) && (flags->size() == count)) {
+            require(this->selection.RequireFlags(*flags, set, cleared), "flag");
+        } else {
+            const std::pair<uint8_t, boolArrayPtr> flagArrays[] = {{PARTICLE_FLAG_BARYON, call.GetIsBaryonFlags()},
+                {PARTICLE_FLAG_STAR, call.GetIsStarFlags()}, {PARTICLE_FLAG_WIND, call.GetIsWindFlags()},
+                {PARTICLE_FLAG_STAR_FORMING_GAS, call.GetIsStarFormingGasFlags()},
+                {PARTICLE_FLAG_AGN, call.GetIsAGNFlags()}};
+            for (const auto& f : flagArrays) {
+                if ((set & f.first) != 0) {
+                    require((f.second != nullptr) && this->selection.RequireFlag(*f.second, true), "flag");
+                }
+                if ((cleared & f.first) != 0) {
+                    require((f.second != nullptr) && this->selection.RequireFlag(*f.second, false), "flag");
+                }
             }
         }
     }
-    return this->copyInCallToContent(call, filterResult);
+
+    if (this->filterVelocityMagnitudeParam.Param<param::BoolParam>()->Value()) {
+        const float min = this->minVelocityMagnitudeParam.Param<param::FloatParam>()->Value();
+        const float max = this->maxVelocityMagnitudeParam.Param<param::FloatParam>()->Value();
+        require((call.GetVelocities() != nullptr) &&
+                    this->selection.RequireLengthRange(*call.GetVelocities(), min, max),
+            "velocity");
+    }
+    const auto requireRange = [&](const floatArrayPtr& values, param::ParamSlot& filterSlot, param::ParamSlot& minSlot,
+                                  param::ParamSlot& maxSlot, const char* name) {
+        if (filterSlot.Param<param::BoolParam>()->Value()) {
+            const float min = minSlot.Param<param::FloatParam>()->Value();
+            const float max = maxSlot.Param<param::FloatParam>()->Value();
+            require((values != nullptr) && this->selection.RequireRange(*values, min, max), name);
+        }
+    };
+    requireRange(call.GetTemperature(), this->filterTemperatureParam, this->minTemperatureParam,
+        this->maxTemperatureParam, "temperature");
+    requireRange(call.GetMass(), this->filterMassParam, this->minMassParam, this->maxMassParam, "mass");
+    requireRange(call.GetInternalEnergy(), this->filterInternalEnergyParam, this->minInternalEnergyParam,
+        this->maxInternalEnergyParam, "internal energy");
+    requireRange(call.GetSmoothingLength(), this->filterSmoothingLengthParam, this->minSmoothingLengthParam,
+        this->maxSmoothingLengthParam, "smoothing length");
+    requireRange(call.GetMolecularWeights(), this->filterMolecularWeightParam, this->minMolecularWeightParam,
+        this->maxMolecularWeightParam, "molecular weight");
+    requireRange(call.GetDensity(), this->filterDensityParam, this->minDensityParam, this->maxDensityParam,
+        "density");
+    requireRange(call.GetGravitationalPotential(), this->filterGravitationalPotentialParam,
+        this->minGravitationalPotentialParam, this->maxGravitationalPotentialParam, "gravitational potential");
+    requireRange(
+        call.GetEntropy(), this->filterEntropyParam, this->minEntropyParam, this->maxEntropyParam, "entropy");
+    requireRange(call.GetAgnDistances(), this->filterAgnDistanceParam, this->minAgnDistanceParam,
+        this->maxAgnDistanceParam, "AGN distance");
+
+    if (!active) {
+        // nothing to filter, the arrays of the incoming call are forwarded without copying
+        this->passThrough = true;
+        this->positions = call.GetPositions();
+        this->velocities = call.GetVelocities();
+        this->temperatures = call.GetTemperature();
+        this->masses = call.GetMass();
+        this->internalEnergies = call.GetInternalEnergy();
+        this->smoothingLengths = call.GetSmoothingLength();
+        this->molecularWeights = call.GetMolecularWeights();
+        this->densities = call.GetDensity();
+        this->gravitationalPotentials = call.GetGravitationalPotential();
+        this->entropies = call.GetEntropy();
+        this->isBaryonFlags = call.GetIsBaryonFlags();
+        this->isStarFlags = call.GetIsStarFlags();
+        this->isWindFlags = call.GetIsWindFlags();
+        this->isStarFormingGasFlags = call.GetIsStarFormingGasFlags();
+        this->isAGNFlags = call.GetIsAGNFlags();
+        this->particleFlags = call.GetParticleFlags();
+        this->particleIDs = call.GetParticleIDs();
+        this->agnDistances = call.GetAgnDistances();
+        return true;
+    }
+    return this->copyInCallToContent(call);
 }
 
 /*
@@ -424,6 +447,12 @@ bool SimpleAstroFilter::copyContentToOutCall(AstroDataCall& outCall) {
     outCall.SetIsWindFlags(this->isWindFlags);
     outCall.SetIsStarFormingGasFlags(this->isStarFormingGasFlags);
     outCall.SetIsAGNFlags(this->isAGNFlags);
+    // an input without packed flags leaves them empty, consumers then have to use the separate flag arrays
+    flagArrayPtr flags = this->particleFlags;
+    if ((flags != nullptr) && ((this->positions == nullptr) || (flags->size() != this->positions->size()))) {
+        flags = nullptr;
+    }
+    outCall.SetParticleFlags(flags);
     outCall.SetParticleIDs(this->particleIDs);
     outCall.SetAGNDistances(this->agnDistances);
     return true;
@@ -432,49 +461,58 @@ bool SimpleAstroFilter::copyContentToOutCall(AstroDataCall& outCall) {
 /*
  * SimpleAstroFilter::copyInCallToContent
  */
-bool SimpleAstroFilter::copyInCallToContent(const AstroDataCall& inCall, const std::set<uint64_t>& indexSet) {
-    this->positions->resize(indexSet.size());
-    this->velocities->resize(indexSet.size());
-    this->temperatures->resize(indexSet.size());
-    this->masses->resize(indexSet.size());
-    this->internalEnergies->resize(indexSet.size());
-    this->smoothingLengths->resize(indexSet.size());
-    this->molecularWeights->resize(indexSet.size());
-    this->densities->resize(indexSet.size());
-    this->gravitationalPotentials->resize(indexSet.size());
-    this->entropies->resize(indexSet.size());
-    this->isBaryonFlags->resize(indexSet.size());
-    this->isStarFlags->resize(indexSet.size());
-    this->isWindFlags->resize(indexSet.size());
-    this->isStarFormingGasFlags->resize(indexSet.size());
-    this->isAGNFlags->resize(indexSet.size());
-    this->particleIDs->resize(indexSet.size());
-    this->agnDistances->resize(indexSet.size());
-
-    std::vector<uint64_t> setVec(indexSet.begin(), indexSet.end());
-    std::sort(setVec.begin(), setVec.end());
-
-    uint64_t i = 0;
-    for (const auto id : setVec) {
-        this->positions->at(i) = inCall.GetPositions()->at(id);
-        this->velocities->at(i) = inCall.GetVelocities()->at(id);
-        this->temperatures->at(i) = inCall.GetTemperature()->at(id);
-        this->masses->at(i) = inCall.GetMass()->at(id);
-        this->internalEnergies->at(i) = inCall.GetInternalEnergy()->at(id);
-        this->smoothingLengths->at(i) = inCall.GetSmoothingLength()->at(id);
-        this->molecularWeights->at(i) = inCall.GetMolecularWeights()->at(id);
-        this->densities->at(i) = inCall.GetDensity()->at(id);
-        this->gravitationalPotentials->at(i) = inCall.GetGravitationalPotential()->at(id);
-        this->entropies->at(i) = inCall.GetEntropy()->at(i);
-        this->isBaryonFlags->at(i) = inCall.GetIsBaryonFlags()->at(id);
-        this->isStarFlags->at(i) = inCall.GetIsStarFlags()->at(id);
-        this->isWindFlags->at(i) = inCall.GetIsWindFlags()->at(id);
-        this->isStarFormingGasFlags->at(i) = inCall.GetIsStarFormingGasFlags()->at(id);
-        this->isAGNFlags->at(i) = inCall.GetIsAGNFlags()->at(id);
-        this->particleIDs->at(i) = inCall.GetParticleIDs()->at(id);
-        this->agnDistances->at(i) = inCall.GetAgnDistances()->at(id);
-        ++i;
+bool SimpleAstroFilter::copyInCallToContent(const AstroDataCall& inCall) {
+    if (this->passThrough) {
+        // the arrays still belong to the incoming call
+        this->passThrough = false;
+        this->positions.reset();
+        this->velocities.reset();
+        this->temperatures.reset();
+        this->masses.reset();
+        this->internalEnergies.reset();
+        this->smoothingLengths.reset();
+        this->molecularWeights.reset();
+        this->densities.reset();
+        this->gravitationalPotentials.reset();
+        this->entropies.reset();
+        this->isBaryonFlags.reset();
+        this->isStarFlags.reset();
+        this->isWindFlags.reset();
+        this->isStarFormingGasFlags.reset();
+        this->isAGNFlags.reset();
+        this->particleFlags.reset();
+        this->particleIDs.reset();
+        this->agnDistances.reset();
+        this->initFields();
     }
+
+    // the output arrays keep their memory, so only growing selections allocate
+    const size_t count = this->selection.GetParticleCount();
+    const auto gather = [this, count](const auto& src, auto& dst) {
+        if ((src != nullptr) && (src->size() == count)) {
+            this->selection.Gather(*src, *dst);
+        } else {
+            dst->clear();
+        }
+    };
+    gather(inCall.GetPositions(), this->positions);
+    gather(inCall.GetVelocities(), this->velocities);
+    gather(inCall.GetTemperature(), this->temperatures);
+    gather(inCall.GetMass(), this->masses);
+    gather(inCall.GetInternalEnergy(), this->internalEnergies);
+    gather(inCall.GetSmoothingLength(), this->smoothingLengths);
+    gather(inCall.GetMolecularWeights(), this->molecularWeights);
+    gather(inCall.GetDensity(), this->densities);
+    gather(inCall.GetGravitationalPotential(), this->gravitationalPotentials);
+    gather(inCall.GetEntropy(), this->entropies);
+    gather(inCall.GetIsBaryonFlags(), this->isBaryonFlags);
+    gather(inCall.GetIsStarFlags(), this->isStarFlags);
+    gather(inCall.GetIsWindFlags(), this->isWindFlags);
+    gather(inCall.GetIsStarFormingGasFlags(), this->isStarFormingGasFlags);
+    gather(inCall.GetIsAGNFlags(), this->isAGNFlags);
+    gather(inCall.GetParticleFlags(), this->particleFlags);
+    gather(inCall.GetParticleIDs(), this->particleIDs);
+    gather(inCall.GetAgnDistances(), this->agnDistances);
     return true;
 }
 
@@ -6,12 +6,12 @@
  */
 #pragma once
 
+#include "ParticleSelection.h"
 #include "astro/AstroDataCall.h"
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/CallerSlot.h"
 #include "mmcore/Module.h"
 #include "mmcore/param/ParamSlot.h"
-#include <set>
 
 namespace megamol {
 namespace astro {
@@ -45,7 +45,7 @@ private:
     void initFields(void);
     bool filter(const AstroDataCall& call);
     bool copyContentToOutCall(AstroDataCall& outCall);
-    bool copyInCallToContent(const AstroDataCall& inCall, const std::set<uint64_t>& indexSet);
+    bool copyInCallToContent(const AstroDataCall& inCall);
     bool isParamDirty(void);
     void resetDirtyParams(void);
     void setDisplayedValues(const AstroDataCall& outCall);
@@ -147,12 +147,21 @@ private:
     /** Pointer to the AGN flag array */
     boolArrayPtr isAGNFlags = nullptr;
 
+    /** Pointer to the packed particle flag array */
+    flagArrayPtr particleFlags = nullptr;
+
     /** Pointer to the particle ID array */
     idArrayPtr particleIDs = nullptr;
 
     /** Pointer to the agn distance array */
     floatArrayPtr agnDistances = nullptr;
 
+    /** The particles passing the filter */
+    ParticleSelection selection;
+
+    /** Flag whether the arrays are the unfiltered ones of the incoming call */
+    bool passThrough = false;
+
     /** flag determining whether the filaments have to be recalculated */
     bool refilter;
 
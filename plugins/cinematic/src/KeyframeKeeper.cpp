@@ -18,6 +18,7 @@
 #include "mmcore/param/Vector3fParam.h"
 #include "stdafx.h"
 
+#include <algorithm>
 #include <fstream>
 #include <imgui.h>
 #include <imgui_internal.h>
@@ -29,6 +30,43 @@ using namespace megamol;
 using namespace megamol::core;
 using namespace megamol::cinematic;
 
+
+namespace {
+
+/**
+ * Catmull-Rom coefficients of the segment between f[1] and f[2], considering the global tangent length.
+ * SOURCE: https://www.cs.cmu.edu/~462/projects/assn2/assn2/catmullRom.pdf
+ */
+template<class T>
+void catmull_rom_coefficients(float tl, const T* f, T* c) {
+    c[0] = f[1];
+    c[1] = -(tl * f[0]) + (tl * f[2]);
+    c[2] = (2.0f * tl * f[0]) + ((tl - 3.0f) * f[1]) + ((3.0f - 2.0f * tl) * f[2]) - (tl * f[3]);
+    c[3] = -(tl * f[0]) + ((2.0f - tl) * f[1]) + ((tl - 2.0f) * f[2]) + (tl * f[3]);
+}
+
+/** Coefficients of a segment staying at f */
+template<class T>
+void constant_coefficients(const T& f, T* c) {
+    c[0] = f;
+    c[1] = c[2] = c[3] = T(0.0f);
+}
+
+template<class T>
+inline T evaluate_cubic(const T* c, float u) {
+    return c[0] + u * (c[1] + u * (c[2] + u * c[3]));
+}
+
+/** Field of view or frustum height, depending on the projection the keyframes are interpolated with */
+inline float camera_aperture(const view::Camera& cam, view::Camera::ProjectionType projection) {
+    if (projection == view::Camera::ORTHOGRAPHIC) {
+        return cam.get<view::Camera::FrustrumHeight>();
+    }
+    return cam.get<view::Camera::FieldOfViewY>();
+}
+
+} // namespace
+
 using namespace vislib;
 using namespace vislib::math;
 
@@ -78,6 +116,9 @@ KeyframeKeeper::KeyframeKeeper(void)
         , fps(24)
         , filename("keyframes.kf")
         , simTangentStatus(false)
+        , splineSegments()
+        , splineSteps(0)
+        , splineSegmentsTangentLength(0.0f)
         , splineTangentLength(0.5f)
         , undoQueue()
         , undoQueueIndex(0)
@@ -998,25 +1039,127 @@ void KeyframeKeeper::refreshInterpolCamPos(unsigned int s) {
         return;
     }
 
-    float startTime;
-    float deltaTimeStep;
-    Keyframe kf;
-    this->interpolCamPos.clear();
-    if (this->keyframes.size() > 1) {
-        for (unsigned int i = 0; i < this->keyframes.size() - 1; i++) {
-            startTime = this->keyframes[i].GetAnimTime();
-            deltaTimeStep = (this->keyframes[i + 1].GetAnimTime() - startTime) / (float)s;
+    if (this->keyframes.size() < 2) {
+        this->splineSegments.clear();
+        this->interpolCamPos.clear();
+        return;
+    }
+
+    // Start over if the layout of the interpolated positions changes, otherwise only the segments whose keyframes
+    // have changed are recomputed
+    const size_t segmentCnt = this->keyframes.size() - 1;
+    if ((s != this->splineSteps) || (this->splineTangentLength != this->splineSegmentsTangentLength) ||
+        (this->splineSegments.size() != segmentCnt) || (this->interpolCamPos.size() != segmentCnt * s + 1)) {
+        this->splineSegments.assign(segmentCnt, SplineSegment());
+        this->interpolCamPos.assign(segmentCnt * s + 1, glm::vec3(0.0f, 0.0f, 0.0f));
+        this->splineSteps = s;
+        this->splineSegmentsTangentLength = this->splineTangentLength;
+    }
+    for (size_t i = 0; i < segmentCnt; i++) {
+        this->updateSplineSegment(i);
+    }
+    // Add last existing camera position
+    auto p = this->keyframes.back().GetCamera().get<view::Camera::Pose>().position;
+    this->interpolCamPos.back() = glm::vec3(p[0], p[1], p[2]);
+}
 
-            for (unsigned int j = 0; j < s; j++) {
-                kf = this->interpolateKeyframe(startTime + deltaTimeStep * (float)j);
-                auto p = kf.GetCamera().get<view::Camera::Pose>().position;
-                this->interpolCamPos.emplace_back(glm::vec3(p[0], p[1], p[2]));
-            }
+
+bool KeyframeKeeper::updateSplineSegment(size_t i) {
+
+    const size_t kfIdxCnt = this->keyframes.size() - 1;
+    const size_t i1 = i;
+    const size_t i2 = i + 1;
+    const size_t i0 = (i1 > 0) ? (i1 - 1) : (0);
+    const size_t i3 = (i2 < kfIdxCnt) ? (i2 + 1) : (kfIdxCnt);
+
+    view::Camera c0 = this->keyframes[i0].GetCamera();
+    view::Camera c1 = this->keyframes[i1].GetCamera();
+    view::Camera c2 = this->keyframes[i2].GetCamera();
+    view::Camera c3 = this->keyframes[i3].GetCamera();
+    const auto projection = Keyframe().GetCamera().getProjectionType();
+
+    SplineSegment next;
+    next.positions[0] = c0.get<view::Camera::Pose>().position;
+    next.positions[1] = c1.get<view::Camera::Pose>().position;
+    next.positions[2] = c2.get<view::Camera::Pose>().position;
+    next.positions[3] = c3.get<view::Camera::Pose>().position;
+    /// Use additional control point positions to manipulate interpolation curve for first and last keyframe
+    if (next.positions[0] == next.positions[1]) {
+        next.positions[0] = this->startCtrllPos;
+    }
+    if (next.positions[2] == next.positions[3]) {
+        next.positions[3] = this->endCtrllPos;
+    }
+    next.apertures[0] = camera_aperture(c0, projection);
+    next.apertures[1] = camera_aperture(c1, projection);
+    next.apertures[2] = camera_aperture(c2, projection);
+    next.apertures[3] = camera_aperture(c3, projection);
+    next.orientations[0] = c1.get<view::Camera::Pose>().to_quat();
+    next.orientations[1] = c2.get<view::Camera::Pose>().to_quat();
+    next.simTimes[0] = this->keyframes[i1].GetSimTime();
+    next.simTimes[1] = this->keyframes[i2].GetSimTime();
+
+    SplineSegment& segment = this->splineSegments[i];
+    if (segment.valid && std::equal(next.positions, next.positions + 4, segment.positions) &&
+        std::equal(next.apertures, next.apertures + 4, segment.apertures) &&
+        std::equal(next.orientations, next.orientations + 2, segment.orientations) &&
+        std::equal(next.simTimes, next.simTimes + 2, segment.simTimes)) {
+        return false;
+    }
+
+    // ! Skip interpolation of camera parameters if they are equal for ?1 and ?2.
+    // => Prevent interpolation loops if time of keyframes is different, but cam params are the same.
+    if (next.positions[1] == next.positions[2]) {
+        constant_coefficients(next.positions[1], next.positionCoeffs);
+    } else {
+        catmull_rom_coefficients(this->splineTangentLength, next.positions, next.positionCoeffs);
+    }
+    if (next.apertures[1] == next.apertures[2]) {
+        constant_coefficients(next.apertures[1], next.apertureCoeffs);
+    } else {
+        catmull_rom_coefficients(this->splineTangentLength, next.apertures, next.apertureCoeffs);
+    }
+    next.valid = true;
+    segment = next;
+
+    // Sample the segment at equidistant steps, the first sample is the position of keyframe i
+    if (this->interpolCamPos.size() == this->splineSegments.size() * this->splineSteps + 1) {
+        for (unsigned int j = 0; j < this->splineSteps; j++) {
+            this->interpolCamPos[i * this->splineSteps + j] = evaluate_cubic(
+                segment.positionCoeffs, static_cast<float>(j) / static_cast<float>(this->splineSteps));
         }
-        // Add last existing camera position
-        auto p = this->keyframes.back().GetCamera().get<view::Camera::Pose>().position;
-        this->interpolCamPos.emplace_back(glm::vec3(p[0], p[1], p[2]));
     }
+
+    return true;
+}
+
+
+void KeyframeKeeper::insertSplineSegment(size_t index) {
+
+    // Only shift a consistent layout, refreshInterpolCamPos starts over otherwise
+    const size_t steps = this->splineSteps;
+    if ((this->splineSegments.size() + 2 != this->keyframes.size()) ||
+        (this->interpolCamPos.size() != this->splineSegments.size() * steps + 1)) {
+        return;
+    }
+    const size_t i = (std::min)(index, this->splineSegments.size());
+    this->splineSegments.insert(this->splineSegments.begin() + i, SplineSegment());
+    this->interpolCamPos.insert(this->interpolCamPos.begin() + i * steps, steps, glm::vec3(0.0f, 0.0f, 0.0f));
+}
+
+
+void KeyframeKeeper::eraseSplineSegment(size_t index) {
+
+    // Only shift a consistent layout, refreshInterpolCamPos starts over otherwise
+    const size_t steps = this->splineSteps;
+    if ((this->splineSegments.size() != this->keyframes.size()) || (this->keyframes.size() < 2) ||
+        (this->interpolCamPos.size() != this->splineSegments.size() * steps + 1)) {
+        return;
+    }
+    const size_t i = (std::min)(index, this->splineSegments.size() - 1);
+    this->splineSegments.erase(this->splineSegments.begin() + i);
+    this->interpolCamPos.erase(
+        this->interpolCamPos.begin() + i * steps, this->interpolCamPos.begin() + (i + 1) * steps);
 }
 
 
@@ -1067,6 +1210,7 @@ bool KeyframeKeeper::deleteKeyframe(Keyframe kf, bool add_undo) {
         if (selIndex >= 0) {
             // DELETE UNDO
             this->keyframes.erase(this->keyframes.begin() + selIndex);
+            this->eraseSplineSegment(selIndex);
             if (add_undo) {
                 // ADD UNDO
                 this->addKeyframeUndoAction(KeyframeKeeper::Undo::Action::UNDO_KEYFRAME_DELETE, kf, kf);
@@ -1103,16 +1247,19 @@ bool KeyframeKeeper::addKeyframe(Keyframe kf, bool add_undo) {
 
     float time = kf.GetAnimTime();
 
+    // Keyframes are sorted by animation time
+    auto insertIt = std::lower_bound(this->keyframes.begin(), this->keyframes.end(), time,
+        [](const Keyframe& k, float t) { return k.GetAnimTime() < t; });
+    const size_t insertIdx = static_cast<size_t>(insertIt - this->keyframes.begin());
+
     // Check if keyframe already exists
-    for (unsigned int i = 0; i < this->keyframes.size(); i++) {
-        if (this->keyframes[i].GetAnimTime() == time) {
-            //megamol::core::utility::log::Log::DefaultLog.WriteInfo("[KEYFRAME KEEPER] [addKeyframe] Keyframe already exists.");
-            return false;
-        }
+    if ((insertIt != this->keyframes.end()) && (insertIt->GetAnimTime() == time)) {
+        //megamol::core::utility::log::Log::DefaultLog.WriteInfo("[KEYFRAME KEEPER] [addKeyframe] Keyframe already exists.");
+        return false;
     }
 
     // Sort new keyframe to keyframe array
-    if (this->keyframes.empty() || (this->keyframes.back().GetAnimTime() < time)) {
+    if (insertIt == this->keyframes.end()) {
         // Reset first/last control point position - ONLY if it is a "real" add and no replace
         if (add_undo) {
             if (this->keyframes.empty()) {
@@ -1122,7 +1269,7 @@ bool KeyframeKeeper::addKeyframe(Keyframe kf, bool add_undo) {
             this->endCtrllPos = glm::vec3(0.0f, 0.0f, 0.0f);
         }
         this->keyframes.emplace_back(kf);
-    } else if (time < this->keyframes.front().GetAnimTime()) {
+    } else if (insertIt == this->keyframes.begin()) {
         // Reset first/last control point position - ONLY if it is a "real" add and no replace
         if (add_undo) {
             if (this->keyframes.empty()) {
@@ -1132,15 +1279,9 @@ bool KeyframeKeeper::addKeyframe(Keyframe kf, bool add_undo) {
         }
         this->keyframes.insert(this->keyframes.begin(), kf);
     } else { // Insert keyframe in-between existing keyframes
-        unsigned int insertIdx = 0;
-        for (unsigned int i = 0; i < this->keyframes.size(); i++) {
-            if (time < this->keyframes[i].GetAnimTime()) {
-                insertIdx = i;
-                break;
-            }
-        }
-        this->keyframes.insert(this->keyframes.begin() + insertIdx, kf);
+        this->keyframes.insert(insertIt, kf);
     }
+    this->insertSplineSegment(insertIdx);
 
     // ADD UNDO
     if (add_undo) {
@@ -1162,11 +1303,13 @@ Keyframe KeyframeKeeper::interpolateKeyframe(float time) {
     t = (t < 0.0f) ? (0.0f) : (t);
     t = (t > this->totalAnimTime) ? (this->totalAnimTime) : (t);
 
+    // Keyframes are sorted by animation time, find the first one not before t
+    auto nextIt = std::lower_bound(this->keyframes.begin(), this->keyframes.end(), t,
+        [](const Keyframe& k, float value) { return k.GetAnimTime() < value; });
+
     // Check if there is an existing keyframe at requested time
-    for (SIZE_T i = 0; i < this->keyframes.size(); i++) {
-        if (t == this->keyframes[i].GetAnimTime()) {
-            return this->keyframes[i];
-        }
+    if ((nextIt != this->keyframes.end()) && (t == nextIt->GetAnimTime())) {
+        return *nextIt;
     }
 
     if (this->keyframes.empty()) {
@@ -1215,103 +1358,48 @@ Keyframe KeyframeKeeper::interpolateKeyframe(float time) {
         // Nothing to do for animation time
         kf.SetAnimTime(t);
 
-        // Determine indices for interpolation
-        int i0 = 0;
-        int i1 = 0;
-        int i2 = 0;
-        int i3 = 0;
-        int kfIdxCnt = (int)this->keyframes.size() - 1;
-        float iT = 0.0f;
-        for (int i = 0; i < kfIdxCnt; i++) {
-            float tMin = this->keyframes[i].GetAnimTime();
-            float tMax = this->keyframes[i + 1].GetAnimTime();
-            if ((tMin < t) && (t < tMax)) {
-                iT = (t - tMin) / (tMax - tMin); // Map current time to [0,1] between two keyframes
-                i1 = i;
-                i2 = i + 1;
-                break;
-            }
-        }
-        i0 = (i1 > 0) ? (i1 - 1) : (0);
-        i3 = (i2 < kfIdxCnt) ? (i2 + 1) : (kfIdxCnt);
+        // Determine segment for interpolation
+        const size_t i2 = static_cast<size_t>(nextIt - this->keyframes.begin());
+        const size_t i1 = i2 - 1;
+        float tMin = this->keyframes[i1].GetAnimTime();
+        float tMax = this->keyframes[i2].GetAnimTime();
+        float iT = (t - tMin) / (tMax - tMin); // Map current time to [0,1] between two keyframes
 
-        view::Camera c0 = this->keyframes[i0].GetCamera();
-        view::Camera c1 = this->keyframes[i1].GetCamera();
-        view::Camera c2 = this->keyframes[i2].GetCamera();
-        view::Camera c3 = this->keyframes[i3].GetCamera();
+        // Only the segment in use is checked, keyframe edits refresh all segments via refreshInterpolCamPos
+        if (this->splineSegments.size() + 1 != this->keyframes.size()) {
+            this->splineSegments.assign(this->keyframes.size() - 1, SplineSegment());
+        }
+        this->updateSplineSegment(i1);
+        const SplineSegment& segment = this->splineSegments[i1];
 
         // Interpolate simulation time linear between i1 and i2
-        float simT1 = this->keyframes[i1].GetSimTime();
-        float simT2 = this->keyframes[i2].GetSimTime();
+        float simT1 = segment.simTimes[0];
+        float simT2 = segment.simTimes[1];
         float simT = simT1 + (simT2 - simT1) * iT;
         kf.SetSimTime(simT);
 
-        // ! Skip interpolation of camera parameters if they are equal for ?1 and ?2.
-        // => Prevent interpolation loops if time of keyframes is different, but cam params are the same.
-
         //interpolate position ------------------------------------------------
-        glm::vec3 p0 = c0.get<view::Camera::Pose>().position;
-        glm::vec3 p1 = c1.get<view::Camera::Pose>().position;
-        glm::vec3 p2 = c2.get<view::Camera::Pose>().position;
-        glm::vec3 p3 = c3.get<view::Camera::Pose>().position;
-        /// Use additional control point positions to manipulate interpolation curve for first and last keyframe
-        if (p0 == p1) {
-            p0 = this->startCtrllPos;
-        }
-        if (p2 == p3) {
-            p3 = this->endCtrllPos;
-        }
-        if (p1 == p2) {
-            cam_kf_pose.position = p1;
-        } else {
-            glm::vec3 pk = this->vec3_interpolation(iT, p0, p1, p2, p3);
-            cam_kf_pose.position = pk;
-        }
+        cam_kf_pose.position = evaluate_cubic(segment.positionCoeffs, iT);
 
         /// TODO XXX Check projection type of all involved keyframes?!
         if (cam_kf.getProjectionType() == view::Camera::PERSPECTIVE) {
             // interpolate fovy ---------------------------------------------------
-
-            float a0 = c0.get<view::Camera::FieldOfViewY>();
-            float a1 = c1.get<view::Camera::FieldOfViewY>();
-            float a2 = c2.get<view::Camera::FieldOfViewY>();
-            float a3 = c3.get<view::Camera::FieldOfViewY>();
-            if (a1 == a2) {
-                auto cam_intrinsics = cam_kf.get<view::Camera::PerspectiveParameters>();
-                cam_intrinsics.fovy = a1;
-                cam_kf.setPerspectiveProjection(cam_intrinsics);
-            } else {
-                float ak = this->float_interpolation(iT, a0, a1, a2, a3);
-                auto cam_intrinsics = cam_kf.get<view::Camera::PerspectiveParameters>();
-                cam_intrinsics.fovy = ak;
-                cam_kf.setPerspectiveProjection(cam_intrinsics);
-            }
+            auto cam_intrinsics = cam_kf.get<view::Camera::PerspectiveParameters>();
+            cam_intrinsics.fovy = evaluate_cubic(segment.apertureCoeffs, iT);
+            cam_kf.setPerspectiveProjection(cam_intrinsics);
         } else if (cam_kf.getProjectionType() == view::Camera::ORTHOGRAPHIC) {
             // interpolate frustum height -----------------------------------------
-
-            float a0 = c0.get<view::Camera::FrustrumHeight>();
-            float a1 = c1.get<view::Camera::FrustrumHeight>();
-            float a2 = c2.get<view::Camera::FrustrumHeight>();
-            float a3 = c3.get<view::Camera::FrustrumHeight>();
-            if (a1 == a2) {
-                auto cam_intrinsics = cam_kf.get<view::Camera::OrthographicParameters>();
-                cam_intrinsics.frustrum_height = a1;
-                cam_kf.setOrthographicProjection(cam_intrinsics);
-            } else {
-                float ak = this->float_interpolation(iT, a0, a1, a2, a3);
-                auto cam_intrinsics = cam_kf.get<view::Camera::OrthographicParameters>();
-                cam_intrinsics.frustrum_height = ak;
-                cam_kf.setOrthographicProjection(cam_intrinsics);
-            }
+            auto cam_intrinsics = cam_kf.get<view::Camera::OrthographicParameters>();
+            cam_intrinsics.frustrum_height = evaluate_cubic(segment.apertureCoeffs, iT);
+            cam_kf.setOrthographicProjection(cam_intrinsics);
         } else {
             megamol::core::utility::log::Log::DefaultLog.WriteError(
                 "[Camera] Found no valid projection. [%s, %s, line %d]\n", __FILE__, __FUNCTION__, __LINE__);
         }
 
         //interpolate orientation ---------------------------------------------
-        glm::quat c1_orient = c1.get<view::Camera::Pose>().to_quat();
-        glm::quat c2_orient = c2.get<view::Camera::Pose>().to_quat();
-        auto interpolated_orientation = this->quaternion_interpolation(iT, c1_orient, c2_orient); // already normalized
+        auto interpolated_orientation =
+            this->quaternion_interpolation(iT, segment.orientations[0], segment.orientations[1]); // already normalized
 
         // Finally set new interpolated camera for keyframe
         cam_kf_pose = view::Camera::Pose(cam_kf_pose.position, interpolated_orientation);
@@ -1332,31 +1420,6 @@ glm::quat KeyframeKeeper::quaternion_interpolation(float u, glm::quat q0, glm::q
 }
 
 
-float KeyframeKeeper::float_interpolation(float u, float f0, float f1, float f2, float f3) {
-
-    /// Catmull-Rom Interpolation
-    // Considering global tangent length
-    // SOURCE: https://www.cs.cmu.edu/~462/projects/assn2/assn2/catmullRom.pdf
-    float tl = this->splineTangentLength;
-    float f = (f1) + (-(tl * f0) + (tl * f2)) * u +
-              ((2.0f * tl * f0) + ((tl - 3.0f) * f1) + ((3.0f - 2.0f * tl) * f2) - (tl * f3)) * u * u +
-              (-(tl * f0) + ((2.0f - tl) * f1) + ((tl - 2.0f) * f2) + (tl * f3)) * u * u * u;
-
-    return f;
-}
-
-
-glm::vec3 KeyframeKeeper::vec3_interpolation(float u, glm::vec3 v0, glm::vec3 v1, glm::vec3 v2, glm::vec3 v3) {
-
-    glm::vec3 v;
-    v.x = this->float_interpolation(u, v0.x, v1.x, v2.x, v3.x);
-    v.y = this->float_interpolation(u, v0.y, v1.y, v2.y, v3.y);
-    v.z = this->float_interpolation(u, v0.z, v1.z, v2.z, v3.z);
-
-    return v;
-}
-
-
 bool KeyframeKeeper::saveKeyframes() {
 
     if (this->filename.empty()) {
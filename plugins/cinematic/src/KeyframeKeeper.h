@@ -154,6 +154,28 @@ private:
         glm::vec3 previous_last_controlpoint;
     };
 
+    // Camera path ---------------------------------------------------------
+
+    /** Cubic segment of the camera path between two consecutive keyframes */
+    struct SplineSegment {
+        // Keyframe parameters the coefficients are derived from
+        glm::vec3 positions[4];
+        float apertures[4];
+        glm::quat orientations[2];
+        float simTimes[2];
+        // Coefficients of c0 + c1 * u + c2 * u^2 + c3 * u^3 for u in [0, 1]
+        glm::vec3 positionCoeffs[4];
+        float apertureCoeffs[4];
+        bool valid = false;
+    };
+
+    /** One segment per pair of consecutive keyframes */
+    std::vector<SplineSegment> splineSegments;
+    /** The interpolation steps per segment in interpolCamPos */
+    unsigned int splineSteps;
+    /** The tangent length the segments were computed with */
+    float splineSegmentsTangentLength;
+
     // Variables only used in keyframe keeper -----------------------------
     std::string filename;
     bool simTangentStatus;
@@ -181,6 +203,32 @@ private:
 
     void refreshInterpolCamPos(unsigned int s);
 
+    /**
+     * Recomputes the coefficients and the interpolated positions of a spline
+     * segment if the keyframes it depends on have changed.
+     *
+     * @param i The index of the segment, i.e. of its first keyframe.
+     *
+     * @return 'true' if the segment has been recomputed.
+     */
+    bool updateSplineSegment(size_t i);
+
+    /**
+     * Shifts the spline segments after a keyframe has been inserted, so only
+     * the segments next to it have to be recomputed.
+     *
+     * @param index The index of the inserted keyframe.
+     */
+    void insertSplineSegment(size_t index);
+
+    /**
+     * Shifts the spline segments after a keyframe has been removed, so only
+     * the segments next to it have to be recomputed.
+     *
+     * @param index The former index of the removed keyframe.
+     */
+    void eraseSplineSegment(size_t index);
+
     void updateEditParameters(Keyframe kf);
 
     void setSameSpeed(void);
@@ -203,10 +251,6 @@ private:
     bool addControlPointUndoAction(KeyframeKeeper::Undo::Action act, glm::vec3 first_controlpoint,
         glm::vec3 last_controlpoint, glm::vec3 previous_first_controlpoint, glm::vec3 previous_last_controlpoint);
 
-    float float_interpolation(float u, float f0, float f1, float f2, float f3);
-
-    glm::vec3 vec3_interpolation(float u, glm::vec3 v0, glm::vec3 v1, glm::vec3 v2, glm::vec3 v3);
-
     glm::quat quaternion_interpolation(float u, glm::quat q0, glm::quat q1);
 
     int getKeyframeIndex(std::vector<Keyframe>& keyframes, Keyframe keyframe);
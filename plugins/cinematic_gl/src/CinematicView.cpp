@@ -14,9 +14,13 @@
 #include "mmcore/param/FilePathParam.h"
 #include "mmcore/param/FloatParam.h"
 #include "mmcore/param/IntParam.h"
+#include "mmcore/param/StringParam.h"
 #include "mmcore/utility/graphics/ScreenShotComments.h"
 #include "stdafx.h"
 
+#include <algorithm>
+#include <fstream>
+
 
 using namespace megamol;
 using namespace megamol::core;
@@ -46,7 +50,16 @@ CinematicView::CinematicView(void)
         , frameFolderParam("cinematic::frameFolder", "Specify folder where the frame files should be stored.")
         , addSBSideToNameParam(
               "cinematic::addSBSideToName", "Toggle whether skybox side should be added to output filename")
+        , workerCountParam("cinematic::workerCount",
+              "Number of processes sharing the rendering of the frame range, each writing a contiguous part of it.")
+        , workerIndexParam("cinematic::workerIndex", "Index of the part of the frame range this process renders.")
+        , runIdParam("cinematic::runId",
+              "Identifier of the export run, shared by all workers. Names the frame folder, which is named after the "
+              "start time if it is empty.")
+        , encoderThreadsParam("cinematic::encoderThreads", "Number of threads encoding the png files.")
+        , exportStateParam("cinematic::exportState", "State of the last export, for scripts waiting for it.")
         , png_data()
+        , png_encoders()
         , utils()
         , deltaAnimTime(clock())
         , shownKeyframe()
@@ -109,6 +122,27 @@ CinematicView::CinematicView(void)
 
     this->addSBSideToNameParam << new param::BoolParam(false);
     this->MakeSlotAvailable(&this->addSBSideToNameParam);
+
+    this->workerCountParam.SetParameter(new param::IntParam(1, 1));
+    this->MakeSlotAvailable(&this->workerCountParam);
+
+    this->workerIndexParam.SetParameter(new param::IntParam(0, 0));
+    this->MakeSlotAvailable(&this->workerIndexParam);
+
+    this->runIdParam.SetParameter(new param::StringParam(""));
+    this->MakeSlotAvailable(&this->runIdParam);
+
+    this->encoderThreadsParam.SetParameter(new param::IntParam(4, 1));
+    this->MakeSlotAvailable(&this->encoderThreadsParam);
+
+    param::EnumParam* state = new param::EnumParam(CinematicView::ExportState::EXPORT_IDLE);
+    state->SetTypePair(CinematicView::ExportState::EXPORT_IDLE, "Idle");
+    state->SetTypePair(CinematicView::ExportState::EXPORT_RUNNING, "Running");
+    state->SetTypePair(CinematicView::ExportState::EXPORT_DONE, "Done");
+    state->SetTypePair(CinematicView::ExportState::EXPORT_FAILED, "Failed");
+    state->SetGUIReadOnly(true);
+    this->exportStateParam << state;
+    this->MakeSlotAvailable(&this->exportStateParam);
 }
 
 
@@ -220,10 +254,14 @@ ImageWrapper CinematicView::Render(double time, double instanceTime) {
                 this->renderParam.ResetDirty();
                 this->rendering = !this->rendering;
                 if (this->rendering) {
-                    this->render_to_file_setup();
+                    if (!this->render_to_file_setup()) {
+                        this->rendering = false;
+                        this->set_export_state(ExportState::EXPORT_FAILED);
+                    }
                 } else {
                     this->render_to_file_cleanup();
-                    megamol::core::utility::log::Log::DefaultLog.WriteInfo("[CINEMATIC VIEW] Finished rendering.");
+                    this->set_export_state(ExportState::EXPORT_FAILED);
+                    megamol::core::utility::log::Log::DefaultLog.WriteInfo("[CINEMATIC VIEW] Rendering cancelled.");
                 }
             }
 
@@ -552,9 +590,6 @@ bool CinematicView::render_to_file_setup() {
     }
     this->png_data.width = static_cast<unsigned int>(this->cineWidth);
     this->png_data.height = static_cast<unsigned int>(this->cineHeight);
-    this->png_data.buffer = nullptr;
-    this->png_data.structptr = nullptr;
-    this->png_data.infoptr = nullptr;
     this->png_data.write_lock = 1;
     this->png_data.start_time = std::chrono::system_clock::now();
 
@@ -576,8 +611,36 @@ bool CinematicView::render_to_file_setup() {
             lastFrame);
         firstFrame = lastFrame;
     }
+    lastFrame = (std::min)(lastFrame, maxFrame);
 
-    this->png_data.cnt = firstFrame;
+    // Split the frame range into contiguous parts, one per worker process. The animation time of a frame only
+    // depends on its number, so all workers loading the same keyframes compute the same camera for each frame.
+    const auto workerCount = static_cast<unsigned int>(this->workerCountParam.Param<param::IntParam>()->Value());
+    const auto workerIndex = static_cast<unsigned int>(this->workerIndexParam.Param<param::IntParam>()->Value());
+    if (workerIndex >= workerCount) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(
+            "[CINEMATIC VIEW] [render_to_file_setup] Worker index %u exceeds worker count %u.", workerIndex,
+            workerCount);
+        this->rendering = false;
+        return false;
+    }
+    const uint64_t frameCount = static_cast<uint64_t>(lastFrame - firstFrame) + 1;
+    const auto partBegin = firstFrame + static_cast<unsigned int>(frameCount * workerIndex / workerCount);
+    const auto partEnd = firstFrame + static_cast<unsigned int>(frameCount * (workerIndex + 1) / workerCount);
+    if (partBegin >= partEnd) {
+        megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+            "[CINEMATIC VIEW] [render_to_file_setup] No frames left for worker %u of %u.", workerIndex, workerCount);
+        this->rendering = false;
+        return false;
+    }
+
+    this->png_data.range_first_frame = firstFrame;
+    this->png_data.range_last_frame = lastFrame;
+    this->png_data.worker_index = workerIndex;
+    this->png_data.worker_count = workerCount;
+    this->png_data.first_frame = partBegin;
+    this->png_data.last_frame = partEnd - 1;
+    this->png_data.cnt = this->png_data.first_frame;
     this->png_data.animTime = (float)this->png_data.cnt / (float)this->fps;
 
     // Calculate pre-decimal point positions for frame counter in filename
@@ -589,18 +652,30 @@ bool CinematicView::render_to_file_setup() {
     }
 
     // Creating new folder
+    const std::string runId = this->runIdParam.Param<param::StringParam>()->Value();
+    this->png_data.run_id = runId.c_str();
     vislib::StringA frameFolder;
-    time_t t = std::time(0); // get time now
-    struct tm* now = nullptr;
+    if (!runId.empty()) {
+        // All workers of a run agree on the folder
+        frameFolder.Format("frames_%s_%02ifps", runId.c_str(), this->fps);
+    } else if (workerCount > 1) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(
+            "[CINEMATIC VIEW] [render_to_file_setup] Several workers need a run identifier shared by all of them.");
+        this->rendering = false;
+        return false;
+    } else {
+        time_t t = std::time(0); // get time now
+        struct tm* now = nullptr;
 #if (defined(_MSC_VER) && (_MSC_VER > 1000))
-    struct tm nowdata;
-    now = &nowdata;
-    localtime_s(now, &t);
+        struct tm nowdata;
+        now = &nowdata;
+        localtime_s(now, &t);
 #else  /* defined(_WIN32) && (_MSC_VER >= 1400) */
-    now = localtime(&t);
+        now = localtime(&t);
 #endif /* (defined(_MSC_VER) && (_MSC_VER > 1000)) */
-    frameFolder.Format("frames_%i%02i%02i-%02i%02i%02i_%02ifps", (now->tm_year + 1900), (now->tm_mon + 1), now->tm_mday,
-        now->tm_hour, now->tm_min, now->tm_sec, this->fps);
+        frameFolder.Format("frames_%i%02i%02i-%02i%02i%02i_%02ifps", (now->tm_year + 1900), (now->tm_mon + 1),
+            now->tm_mday, now->tm_hour, now->tm_min, now->tm_sec, this->fps);
+    }
     this->png_data.path = static_cast<vislib::StringA>(
         this->frameFolderParam.Param<param::FilePathParam>()->Value().generic_u8string().c_str());
     if (this->png_data.path.IsEmpty()) {
@@ -610,19 +685,19 @@ bool CinematicView::render_to_file_setup() {
 
     this->png_data.filename = "frames";
 
-    // Create new byte buffer
-    this->png_data.buffer = new BYTE[this->png_data.width * this->png_data.height * this->png_data.bpp];
-    if (this->png_data.buffer == nullptr) {
-        throw vislib::Exception(
-            "[CINEMATIC VIEW] [render_to_file_setup] Cannot allocate image buffer.", __FILE__, __LINE__);
-    }
+    this->png_encoders_start(static_cast<unsigned int>(this->encoderThreadsParam.Param<param::IntParam>()->Value()));
 
     // Stop accidentially running animation in view
     param::ParamSlot* animParam = static_cast<param::ParamSlot*>(this->_timeCtrl.GetSlot(0)); // animPlaySlot
     animParam->Param<param::BoolParam>()->SetValue(false);
 
+    // A manifest of a previous run of this worker is stale
+    vislib::sys::File::Delete(this->worker_manifest_file(workerIndex));
+    this->set_export_state(ExportState::EXPORT_RUNNING);
+
     megamol::core::utility::log::Log::DefaultLog.WriteInfo(
-        "[CINEMATIC VIEW] Started rendering of complete animation...");
+        "[CINEMATIC VIEW] Started rendering of frames %u to %u (worker %u of %u)...", this->png_data.first_frame,
+        this->png_data.last_frame, workerIndex, workerCount);
 
     return true;
 }
@@ -635,51 +710,33 @@ bool CinematicView::render_to_file_write() {
         if (ccc == nullptr)
             return false;
 
-        vislib::StringA tmpFilename, tmpStr;
-        tmpStr.Format(".%i", this->png_data.exp_frame_cnt);
-        tmpStr.Prepend("%0");
-        tmpStr.Append("i.png");
-        tmpFilename.Format(tmpStr.PeekBuffer(), this->png_data.cnt);
-        if (this->sbSide != CinematicView::SKYBOX_NONE &&
-            this->addSBSideToNameParam.Param<core::param::BoolParam>()->Value()) {
-            if (this->sbSide == CinematicView::SkyboxSides::SKYBOX_FRONT) {
-                tmpFilename.Prepend("_front.");
-            } else if (this->sbSide == CinematicView::SkyboxSides::SKYBOX_BACK) {
-                tmpFilename.Prepend("_back.");
-            } else if (this->sbSide == CinematicView::SkyboxSides::SKYBOX_RIGHT) {
-                tmpFilename.Prepend("_right.");
-            } else if (this->sbSide == CinematicView::SkyboxSides::SKYBOX_LEFT) {
-                tmpFilename.Prepend("_left.");
-            } else if (this->sbSide == CinematicView::SkyboxSides::SKYBOX_UP) {
-                tmpFilename.Prepend("_up.");
-            } else if (this->sbSide == CinematicView::SkyboxSides::SKYBOX_DOWN) {
-                tmpFilename.Prepend("_down.");
+        // Wait for a free slot in the queue of the encoders
+        std::unique_ptr<PngFrame> frame;
+        {
+            std::unique_lock<std::mutex> lock(this->png_encoders.lock);
+            this->png_encoders.changed.wait(lock, [this]() {
+                return (this->png_encoders.queue.size() < this->png_encoders.queue_size) || this->png_encoders.failed;
+            });
+            if (this->png_encoders.failed) {
+                lock.unlock();
+                this->render_to_file_cleanup();
+                this->set_export_state(ExportState::EXPORT_FAILED);
+                megamol::core::utility::log::Log::DefaultLog.WriteError(
+                    "[CINEMATIC VIEW] [render_to_file_write] Writing png files failed. Rendering aborted.");
+                return false;
+            }
+            if (!this->png_encoders.spare.empty()) {
+                frame = std::move(this->png_encoders.spare.back());
+                this->png_encoders.spare.pop_back();
             }
         }
-        tmpFilename.Prepend(this->png_data.filename);
-
-        // Open final image file
-        if (!this->png_data.file.Open(vislib::sys::Path::Concatenate(this->png_data.path, tmpFilename),
-                vislib::sys::File::WRITE_ONLY, vislib::sys::File::SHARE_EXCLUSIVE,
-                vislib::sys::File::CREATE_OVERWRITE)) {
-            throw vislib::Exception(
-                "[CINEMATIC VIEW] [render_to_file_write] Cannot open output file", __FILE__, __LINE__);
-        }
-
-        // Init png lib
-        this->png_data.structptr =
-            png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, &this->pngError, &this->pngWarn);
-        if (this->png_data.structptr == nullptr) {
-            throw vislib::Exception(
-                "[CINEMATIC VIEW] [render_to_file_write] Unable to create png structure. ", __FILE__, __LINE__);
-        }
-        this->png_data.infoptr = png_create_info_struct(this->png_data.structptr);
-        if (this->png_data.infoptr == nullptr) {
-            throw vislib::Exception(
-                "[CINEMATIC VIEW] [render_to_file_write] Unable to create png info. ", __FILE__, __LINE__);
+        if (frame == nullptr) {
+            frame = std::make_unique<PngFrame>();
         }
-        png_set_write_fn(
-            this->png_data.structptr, static_cast<void*>(&this->png_data.file), &this->pngWrite, &this->pngFlush);
+        frame->buffer.resize(static_cast<size_t>(this->png_data.width) * this->png_data.height * this->png_data.bpp);
+        frame->file = vislib::sys::Path::Concatenate(this->png_data.path, this->frame_file_name(this->png_data.cnt));
+        frame->cnt = this->png_data.cnt;
+        frame->animTime = this->png_data.animTime;
 
         std::string project;
         if (this->GetCoreInstance()->IsmmconsoleFrontendCompatible()) {
@@ -688,23 +745,18 @@ bool CinematicView::render_to_file_write() {
             auto& megamolgraph = frontend_resources.get<megamol::core::MegaMolGraph>();
             project = const_cast<megamol::core::MegaMolGraph&>(megamolgraph).Convenience().SerializeGraph();
         }
-
-        megamol::core::utility::graphics::ScreenShotComments ssc(project);
-        png_set_text(
-            this->png_data.structptr, this->png_data.infoptr, ssc.GetComments().data(), ssc.GetComments().size());
-        png_set_IHDR(this->png_data.structptr, this->png_data.infoptr, this->png_data.width, this->png_data.height, 8,
-            PNG_COLOR_TYPE_RGB, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+        frame->comments = std::make_unique<megamol::core::utility::graphics::ScreenShotComments>(project);
 
         {
             /// XXX Throws OpenGL error 1282 (Invalid Operation) - only available since OpenGL 4.5 ...
             /// glGetTextureImage(this->cinematicFbo->getColorAttachment(0)->getName(), 0, GL_RGBA, GL_UNSIGNED_BYTE,
-            /// this->png_data.width * this->png_data.height, this->png_data.buffer);
+            /// this->png_data.width * this->png_data.height, frame->buffer.data());
             auto err = glGetError();
             glEnable(GL_TEXTURE_2D);
             glBindTexture(GL_TEXTURE_2D, this->cinematicFbo->getColorAttachment(0)->getName());
             if (glGetError() == GL_NO_ERROR) {
                 glGetTexImage(GL_TEXTURE_2D, 0, this->cinematicFbo->getColorAttachment(0)->getFormat(),
-                    this->cinematicFbo->getColorAttachment(0)->getType(), this->png_data.buffer);
+                    this->cinematicFbo->getColorAttachment(0)->getType(), frame->buffer.data());
             }
             glBindTexture(GL_TEXTURE_2D, 0);
             glDisable(GL_TEXTURE_2D);
@@ -715,40 +767,12 @@ bool CinematicView::render_to_file_write() {
             }
         }
 
-        BYTE** rows = nullptr;
-        try {
-            rows = new BYTE*[this->cineHeight];
-            for (UINT i = 0; i < this->png_data.height; i++) {
-                rows[this->png_data.height - (1 + i)] =
-                    this->png_data.buffer + this->png_data.bpp * i * this->png_data.width;
-            }
-            png_set_rows(this->png_data.structptr, this->png_data.infoptr, rows);
-
-            png_write_png(this->png_data.structptr, this->png_data.infoptr, PNG_TRANSFORM_IDENTITY, nullptr);
-
-            ARY_SAFE_DELETE(rows);
-        } catch (...) {
-            if (rows != nullptr) {
-                ARY_SAFE_DELETE(rows);
-            }
-            throw;
-        }
-        if (this->png_data.structptr != nullptr) {
-            if (this->png_data.infoptr != nullptr) {
-                png_destroy_write_struct(&this->png_data.structptr, &this->png_data.infoptr);
-            } else {
-                png_destroy_write_struct(&this->png_data.structptr, (png_infopp) nullptr);
-            }
+        // Encoding and writing the file is left to the encoder threads
+        {
+            std::lock_guard<std::mutex> lock(this->png_encoders.lock);
+            this->png_encoders.queue.push_back(std::move(frame));
         }
-        try {
-            this->png_data.file.Flush();
-        } catch (...) {}
-        try {
-            this->png_data.file.Close();
-        } catch (...) {}
-        megamol::core::utility::log::Log::DefaultLog.WriteInfo(
-            "[CINEMATIC VIEW] [render_to_file_write] Wrote png file %d for animation time %f ...\n", this->png_data.cnt,
-            this->png_data.animTime);
+        this->png_encoders.changed.notify_all();
 
         // --------------------------------------------------------------------
 
@@ -769,10 +793,16 @@ bool CinematicView::render_to_file_write() {
         //} else
 
         // Check condition for finishing rendering
-        auto lastFrame = static_cast<unsigned int>(this->lastRenderFrameParam.Param<param::IntParam>()->Value());
-        if ((this->png_data.animTime > ccc->GetTotalAnimTime()) || (this->png_data.cnt > lastFrame)) {
-            this->render_to_file_cleanup();
-            megamol::core::utility::log::Log::DefaultLog.WriteInfo("[CINEMATIC VIEW] Finished rendering.");
+        if ((this->png_data.animTime > ccc->GetTotalAnimTime()) || (this->png_data.cnt > this->png_data.last_frame)) {
+            const bool written = this->render_to_file_cleanup();
+            if (written && this->validate_frame_files()) {
+                this->set_export_state(ExportState::EXPORT_DONE);
+                megamol::core::utility::log::Log::DefaultLog.WriteInfo("[CINEMATIC VIEW] Finished rendering.");
+            } else {
+                this->set_export_state(ExportState::EXPORT_FAILED);
+                megamol::core::utility::log::Log::DefaultLog.WriteError(
+                    "[CINEMATIC VIEW] Finished rendering with missing frames.");
+            }
             return false;
         }
     }
@@ -785,39 +815,238 @@ bool CinematicView::render_to_file_cleanup() {
 
     this->rendering = false;
 
-    if (this->png_data.structptr != nullptr) {
-        if (this->png_data.infoptr != nullptr) {
-            png_destroy_write_struct(&this->png_data.structptr, &this->png_data.infoptr);
-        } else {
-            png_destroy_write_struct(&this->png_data.structptr, (png_infopp) nullptr);
+    return this->png_encoders_stop();
+}
+
+
+vislib::StringA CinematicView::frame_file_name(unsigned int frame) const {
+
+    vislib::StringA tmpFilename, tmpStr;
+    tmpStr.Format(".%i", this->png_data.exp_frame_cnt);
+    tmpStr.Prepend("%0");
+    tmpStr.Append("i.png");
+    tmpFilename.Format(tmpStr.PeekBuffer(), frame);
+    if (this->sbSide != CinematicView::SKYBOX_NONE &&
+        this->addSBSideToNameParam.Param<core::param::BoolParam>()->Value()) {
+        if (this->sbSide == CinematicView::SkyboxSides::SKYBOX_FRONT) {
+            tmpFilename.Prepend("_front.");
+        } else if (this->sbSide == CinematicView::SkyboxSides::SKYBOX_BACK) {
+            tmpFilename.Prepend("_back.");
+        } else if (this->sbSide == CinematicView::SkyboxSides::SKYBOX_RIGHT) {
+            tmpFilename.Prepend("_right.");
+        } else if (this->sbSide == CinematicView::SkyboxSides::SKYBOX_LEFT) {
+            tmpFilename.Prepend("_left.");
+        } else if (this->sbSide == CinematicView::SkyboxSides::SKYBOX_UP) {
+            tmpFilename.Prepend("_up.");
+        } else if (this->sbSide == CinematicView::SkyboxSides::SKYBOX_DOWN) {
+            tmpFilename.Prepend("_down.");
         }
     }
+    tmpFilename.Prepend(this->png_data.filename);
+    return tmpFilename;
+}
+
+
+void CinematicView::png_encoders_start(unsigned int count) {
+
+    this->png_encoders_stop();
+
+    std::lock_guard<std::mutex> lock(this->png_encoders.lock);
+    this->png_encoders.queue_size = 2 * static_cast<size_t>(count);
+    this->png_encoders.finished = false;
+    this->png_encoders.failed = false;
+    for (unsigned int i = 0; i < count; ++i) {
+        this->png_encoders.threads.emplace_back(&CinematicView::png_encoder_run, this);
+    }
+}
 
-    try {
-        this->png_data.file.Flush();
-    } catch (...) {}
+
+bool CinematicView::png_encoders_stop() {
+
+    {
+        std::unique_lock<std::mutex> lock(this->png_encoders.lock);
+        this->png_encoders.finished = true;
+    }
+    this->png_encoders.changed.notify_all();
+    for (auto& t : this->png_encoders.threads) {
+        t.join();
+    }
+    this->png_encoders.threads.clear();
+
+    std::lock_guard<std::mutex> lock(this->png_encoders.lock);
+    this->png_encoders.queue.clear();
+    this->png_encoders.spare.clear();
+    return !this->png_encoders.failed;
+}
+
+
+void CinematicView::png_encoder_run() {
+
+    while (true) {
+        std::unique_ptr<PngFrame> frame;
+        {
+            std::unique_lock<std::mutex> lock(this->png_encoders.lock);
+            this->png_encoders.changed.wait(
+                lock, [this]() { return !this->png_encoders.queue.empty() || this->png_encoders.finished; });
+            if (this->png_encoders.queue.empty() || this->png_encoders.failed) {
+                return;
+            }
+            frame = std::move(this->png_encoders.queue.front());
+            this->png_encoders.queue.pop_front();
+        }
+        this->png_encoders.changed.notify_all();
+
+        bool success = true;
+        try {
+            this->png_write_frame(*frame);
+            megamol::core::utility::log::Log::DefaultLog.WriteInfo(
+                "[CINEMATIC VIEW] [render_to_file_write] Wrote png file %d for animation time %f ...\n", frame->cnt,
+                frame->animTime);
+        } catch (vislib::Exception& ex) {
+            megamol::core::utility::log::Log::DefaultLog.WriteError(
+                "[CINEMATIC VIEW] [render_to_file_write] Unable to write png file %d: %s", frame->cnt, ex.GetMsgA());
+            success = false;
+        } catch (...) {
+            megamol::core::utility::log::Log::DefaultLog.WriteError(
+                "[CINEMATIC VIEW] [render_to_file_write] Unable to write png file %d.", frame->cnt);
+            success = false;
+        }
+
+        frame->comments.reset();
+        {
+            std::lock_guard<std::mutex> lock(this->png_encoders.lock);
+            this->png_encoders.failed |= !success;
+            this->png_encoders.spare.push_back(std::move(frame));
+        }
+        this->png_encoders.changed.notify_all();
+    }
+}
+
+
+void CinematicView::png_write_frame(const PngFrame& frame) const {
+
+    vislib::sys::FastFile file;
+    png_structp structptr = nullptr;
+    png_infop infoptr = nullptr;
+
+    // Open final image file
+    if (!file.Open(frame.file, vislib::sys::File::WRITE_ONLY, vislib::sys::File::SHARE_EXCLUSIVE,
+            vislib::sys::File::CREATE_OVERWRITE)) {
+        throw vislib::Exception("[CINEMATIC VIEW] [png_write_frame] Cannot open output file", __FILE__, __LINE__);
+    }
 
     try {
-        this->png_data.file.Close();
-    } catch (...) {}
+        // Init png lib
+        structptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, &this->pngError, &this->pngWarn);
+        if (structptr == nullptr) {
+            throw vislib::Exception(
+                "[CINEMATIC VIEW] [png_write_frame] Unable to create png structure. ", __FILE__, __LINE__);
+        }
+        infoptr = png_create_info_struct(structptr);
+        if (infoptr == nullptr) {
+            throw vislib::Exception(
+                "[CINEMATIC VIEW] [png_write_frame] Unable to create png info. ", __FILE__, __LINE__);
+        }
+        png_set_write_fn(structptr, static_cast<void*>(&file), &this->pngWrite, &this->pngFlush);
+
+        auto comments = frame.comments->GetComments();
+        png_set_text(structptr, infoptr, comments.data(), comments.size());
+        png_set_IHDR(structptr, infoptr, this->png_data.width, this->png_data.height, 8,
+            (this->png_data.bpp == 4) ? PNG_COLOR_TYPE_RGB_ALPHA : PNG_COLOR_TYPE_RGB, PNG_INTERLACE_NONE,
+            PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+
+        std::vector<png_bytep> rows(this->png_data.height);
+        for (UINT i = 0; i < this->png_data.height; i++) {
+            rows[this->png_data.height - (1 + i)] =
+                const_cast<BYTE*>(frame.buffer.data()) + this->png_data.bpp * i * this->png_data.width;
+        }
+        png_set_rows(structptr, infoptr, rows.data());
+
+        png_write_png(structptr, infoptr, PNG_TRANSFORM_IDENTITY, nullptr);
+    } catch (...) {
+        if (structptr != nullptr) {
+            png_destroy_write_struct(&structptr, (infoptr != nullptr) ? &infoptr : (png_infopp) nullptr);
+        }
+        try {
+            file.Close();
+        } catch (...) {}
+        throw;
+    }
 
-    ARY_SAFE_DELETE(this->png_data.buffer);
+    png_destroy_write_struct(&structptr, &infoptr);
+    file.Flush();
+    file.Close();
+}
 
-    if (this->png_data.buffer != nullptr) {
-        megamol::core::utility::log::Log::DefaultLog.WriteError(
-            "[CINEMATIC VIEW] [render_to_file_cleanup] pngdata.buffer is not nullptr. [%s, %s, line %d]\n", __FILE__,
-            __FUNCTION__, __LINE__);
+
+bool CinematicView::validate_frame_files() const {
+
+    // Frames of this worker
+    unsigned int missing = 0;
+    for (unsigned int f = this->png_data.first_frame; f <= this->png_data.last_frame; ++f) {
+        auto file = vislib::sys::Path::Concatenate(this->png_data.path, this->frame_file_name(f));
+        if (!vislib::sys::File::Exists(file) || (vislib::sys::File::GetSize(file) == 0)) {
+            megamol::core::utility::log::Log::DefaultLog.WriteError(
+                "[CINEMATIC VIEW] [validate_frame_files] Missing frame file %s.", file.PeekBuffer());
+            ++missing;
+        }
     }
-    if (this->png_data.structptr != nullptr) {
-        megamol::core::utility::log::Log::DefaultLog.WriteError(
-            "[CINEMATIC VIEW] [render_to_file_cleanup] pngdata.structptr is not nullptr. [%s, %s, line %d]\n", __FILE__,
-            __FUNCTION__, __LINE__);
+    if ((missing > 0) || this->png_data.run_id.IsEmpty()) {
+        return missing == 0;
     }
-    if (this->png_data.infoptr != nullptr) {
-        megamol::core::utility::log::Log::DefaultLog.WriteError(
-            "[CINEMATIC VIEW] [render_to_file_cleanup] pngdata.infoptr is not nullptr. [%s, %s, line %d]\n", __FILE__,
-            __FUNCTION__, __LINE__);
+
+    // Announce the finished part: the range, then one frame file per line
+    {
+        std::ofstream manifest(this->worker_manifest_file(this->png_data.worker_index).PeekBuffer());
+        manifest << this->png_data.range_first_frame << " " << this->png_data.range_last_frame << "\n";
+        for (unsigned int f = this->png_data.first_frame; f <= this->png_data.last_frame; ++f) {
+            manifest << f << " " << this->frame_file_name(f).PeekBuffer() << "\n";
+        }
+        if (!manifest) {
+            megamol::core::utility::log::Log::DefaultLog.WriteError(
+                "[CINEMATIC VIEW] [validate_frame_files] Unable to write the manifest of worker %u.",
+                this->png_data.worker_index);
+            return false;
+        }
     }
 
-    return true;
+    // The last worker to finish checks the whole range
+    for (unsigned int w = 0; w < this->png_data.worker_count; ++w) {
+        if (!vislib::sys::File::Exists(this->worker_manifest_file(w))) {
+            megamol::core::utility::log::Log::DefaultLog.WriteInfo(
+                "[CINEMATIC VIEW] [validate_frame_files] Worker %u has not finished yet, the whole range is checked "
+                "by the last worker.",
+                w);
+            return true;
+        }
+    }
+    for (unsigned int f = this->png_data.range_first_frame; f <= this->png_data.range_last_frame; ++f) {
+        auto file = vislib::sys::Path::Concatenate(this->png_data.path, this->frame_file_name(f));
+        if (!vislib::sys::File::Exists(file) || (vislib::sys::File::GetSize(file) == 0)) {
+            megamol::core::utility::log::Log::DefaultLog.WriteError(
+                "[CINEMATIC VIEW] [validate_frame_files] Missing frame file %s of the whole range.", file.PeekBuffer());
+            ++missing;
+        }
+    }
+    if (missing == 0) {
+        megamol::core::utility::log::Log::DefaultLog.WriteInfo(
+            "[CINEMATIC VIEW] [validate_frame_files] All %u frames of the run are present in %s.",
+            this->png_data.range_last_frame - this->png_data.range_first_frame + 1, this->png_data.path.PeekBuffer());
+    }
+
+    return missing == 0;
+}
+
+
+vislib::StringA CinematicView::worker_manifest_file(unsigned int worker) const {
+
+    vislib::StringA name;
+    name.Format("%s.worker%u.txt", this->png_data.filename.PeekBuffer(), worker);
+    return vislib::sys::Path::Concatenate(this->png_data.path, name);
+}
+
+
+void CinematicView::set_export_state(ExportState state) {
+
+    this->exportStateParam.Param<param::EnumParam>()->SetValue(state);
 }
@@ -17,6 +17,14 @@
 
 #include "cinematic/Keyframe.h"
 #include "cinematic_gl/CinematicUtils.h"
+#include "mmcore/utility/graphics/ScreenShotComments.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include <glm/gtx/quaternion.hpp>
 #include <png.h>
@@ -86,6 +94,9 @@ private:
      * variables
      **********************************************************************/
 
+    /** State of the export, observed by scripts waiting for a worker */
+    enum ExportState { EXPORT_IDLE = 0, EXPORT_RUNNING = 1, EXPORT_DONE = 2, EXPORT_FAILED = 3 };
+
     enum SkyboxSides {
         SKYBOX_NONE = 0,
         SKYBOX_FRONT = 1,
@@ -97,23 +108,48 @@ private:
     };
 
     struct PngData {
-        BYTE* buffer = nullptr;
-        vislib::sys::FastFile file;
         unsigned int width;
         unsigned int height;
         unsigned int bpp;
         vislib::StringA path;
         vislib::StringA filename;
         unsigned int cnt;
-        png_structp structptr = nullptr;
-        png_infop infoptr = nullptr;
+        unsigned int range_first_frame;
+        unsigned int range_last_frame;
+        unsigned int first_frame;
+        unsigned int last_frame;
         float animTime;
         unsigned int write_lock;
         TimePoint_t start_time;
         unsigned int exp_frame_cnt;
+        unsigned int worker_index;
+        unsigned int worker_count;
+        vislib::StringA run_id;
+    };
+
+    /** A frame read back from the fbo, waiting to be encoded */
+    struct PngFrame {
+        std::vector<BYTE> buffer;
+        vislib::StringA file;
+        std::unique_ptr<megamol::core::utility::graphics::ScreenShotComments> comments;
+        unsigned int cnt;
+        float animTime;
+    };
+
+    /** The encoder threads and the frames passed to them */
+    struct PngEncoders {
+        std::vector<std::thread> threads;
+        std::mutex lock;
+        std::condition_variable changed;
+        std::deque<std::unique_ptr<PngFrame>> queue;
+        std::vector<std::unique_ptr<PngFrame>> spare;
+        size_t queue_size = 0;
+        bool finished = false;
+        bool failed = false;
     };
 
     PngData png_data;
+    PngEncoders png_encoders;
     CinematicUtils utils;
     clock_t deltaAnimTime;
     cinematic::Keyframe shownKeyframe;
@@ -138,6 +174,68 @@ private:
 
     bool render_to_file_cleanup();
 
+    /**
+     * Answer the name of the file of a frame, relative to the frame folder.
+     *
+     * @param frame The frame number.
+     *
+     * @return The file name.
+     */
+    vislib::StringA frame_file_name(unsigned int frame) const;
+
+    /**
+     * Starts the threads encoding the queued frames.
+     *
+     * @param count The number of threads.
+     */
+    void png_encoders_start(unsigned int count);
+
+    /**
+     * Waits until all queued frames are written and stops the encoder threads.
+     *
+     * @return 'false' if writing a frame failed.
+     */
+    bool png_encoders_stop();
+
+    /**
+     * Encodes the queued frames until the encoders are stopped.
+     */
+    void png_encoder_run();
+
+    /**
+     * Writes a frame to a png file.
+     *
+     * @param frame The frame.
+     */
+    void png_write_frame(const PngFrame& frame) const;
+
+    /**
+     * Checks that the frame files of the rendered range exist. For runs
+     * with an identifier, a manifest of the part of this worker is written
+     * to the frame folder, and the worker finding the manifests of all
+     * workers checks the whole range.
+     *
+     * @return 'true' if all frames of the rendered range exist, and all
+     *         frames of the whole range once all workers are finished.
+     */
+    bool validate_frame_files() const;
+
+    /**
+     * Answer the path of the manifest of a worker in the frame folder.
+     *
+     * @param worker The index of the worker.
+     *
+     * @return The path of the manifest.
+     */
+    vislib::StringA worker_manifest_file(unsigned int worker) const;
+
+    /**
+     * Sets the state of the export parameter.
+     *
+     * @param state The new state.
+     */
+    void set_export_state(ExportState state);
+
     /**
      * Error handling function for png export
      *
@@ -203,6 +301,11 @@ private:
     core::param::ParamSlot fpsParam;
     core::param::ParamSlot frameFolderParam;
     core::param::ParamSlot addSBSideToNameParam;
+    core::param::ParamSlot workerCountParam;
+    core::param::ParamSlot workerIndexParam;
+    core::param::ParamSlot runIdParam;
+    core::param::ParamSlot encoderThreadsParam;
+    core::param::ParamSlot exportStateParam;
 };
 
 } // namespace cinematic_gl
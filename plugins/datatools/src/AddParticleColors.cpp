@@ -2,6 +2,7 @@
 #include "stdafx.h"
 
 #include "mmcore/view/CallGetTransferFunction.h"
+#include "mmcore/view/TransferFunctionLUT.h"
 
 
 megamol::datatools::AddParticleColors::AddParticleColors(void)
@@ -17,27 +18,6 @@ megamol::datatools::AddParticleColors::~AddParticleColors(void) {
 }
 
 
-float megamol::datatools::AddParticleColors::lerp(float a, float b, float inter) {
-    return a * (1.0f - inter) + b * inter;
-}
-
-
-glm::vec4 megamol::datatools::AddParticleColors::sample_tf(
-    float const* tf, unsigned int tf_size, int base, float rest) {
-    if (base < 0 || tf_size == 0)
-        return glm::vec4(0);
-    auto const last_el = tf_size - 1;
-    if (base >= last_el)
-        return glm::vec4(tf[last_el * 4], tf[last_el * 4 + 1], tf[last_el * 4 + 2], tf[last_el * 4 + 3]);
-
-    auto const a = base;
-    auto const b = base + 1;
-
-    return glm::vec4(lerp(tf[a * 4], tf[b * 4], rest), lerp(tf[a * 4 + 1], tf[b * 4 + 1], rest),
-        lerp(tf[a * 4 + 2], tf[b * 4 + 2], rest), lerp(tf[a * 4 + 3], tf[b * 4 + 3], rest));
-}
-
-
 bool megamol::datatools::AddParticleColors::manipulateData(
     geocalls::MultiParticleDataCall& outData, geocalls::MultiParticleDataCall& inData) {
 
@@ -50,8 +30,9 @@ bool megamol::datatools::AddParticleColors::manipulateData(
     outData = inData;
 
     if (_frame_id != inData.FrameID() || _in_data_hash != inData.DataHash() || cgtf->IsDirty()) {
-        auto const tf = cgtf->GetTextureData();
-        auto const tf_size = cgtf->TextureSize();
+        auto const lut = core::view::TransferFunctionLUT::Get(*cgtf);
+        if (lut == nullptr)
+            return false;
 
         auto const pl_count = outData.GetParticleListCount();
         _colors.clear();
@@ -59,26 +40,24 @@ bool megamol::datatools::AddParticleColors::manipulateData(
 
         for (unsigned int plidx = 0; plidx < pl_count; ++plidx) {
             auto& parts = outData.AccessParticles(plidx);
-            if (parts.GetColourDataType() != geocalls::SimpleSphericalParticles::COLDATA_FLOAT_I &&
-                parts.GetColourDataType() != geocalls::SimpleSphericalParticles::COLDATA_DOUBLE_I)
+            auto const col_type = parts.GetColourDataType();
+            if (col_type != geocalls::SimpleSphericalParticles::COLDATA_FLOAT_I &&
+                col_type != geocalls::SimpleSphericalParticles::COLDATA_DOUBLE_I)
                 continue;
 
             auto const p_count = parts.GetCount();
             auto& col_vec = _colors[plidx];
             col_vec.resize(p_count);
+            if (p_count == 0)
+                continue;
 
-            auto const min_i = parts.GetMinColourIndexValue();
-            auto const max_i = parts.GetMaxColourIndexValue();
-            auto const fac_i = 1.0f / (max_i - min_i + 1e-8f);
-
-            auto const iAcc = parts.GetParticleStore().GetCRAcc();
-
-            for (std::size_t pidx = 0; pidx < p_count; ++pidx) {
-                auto const col = iAcc->Get_f(pidx);
-                auto const val = (col - min_i) * fac_i * static_cast<float>(tf_size);
-                std::remove_const_t<decltype(val)> main = 0;
-                auto rest = std::modf(val, &main);
-                col_vec[pidx].rgba = sample_tf(tf, tf_size, static_cast<int>(main), rest);
+            std::array<float, 2> const range = {parts.GetMinColourIndexValue(), parts.GetMaxColourIndexValue()};
+            auto const stride = parts.GetColourDataStride();
+            auto const out = glm::value_ptr(col_vec.front().rgba);
+            if (col_type == geocalls::SimpleSphericalParticles::COLDATA_FLOAT_I) {
+                lut->Map(static_cast<float const*>(parts.GetColourData()), p_count, range, out, stride);
+            } else {
+                lut->Map(static_cast<double const*>(parts.GetColourData()), p_count, range, out, stride);
             }
         }
 
@@ -5,6 +5,7 @@
 #include "datatools/AbstractParticleManipulator.h"
 
 #include "glm/glm.hpp"
+#include "glm/gtc/type_ptr.hpp"
 
 namespace megamol::datatools {
 class AddParticleColors : public AbstractParticleManipulator {
@@ -34,14 +35,11 @@ protected:
     bool manipulateData(geocalls::MultiParticleDataCall& outData, geocalls::MultiParticleDataCall& inData) override;
 
 private:
+    /** Tightly packed, so a list is mapped as one RGBA float array */
     struct color {
         glm::vec4 rgba;
     };
 
-    float lerp(float a, float b, float inter);
-
-    glm::vec4 sample_tf(float const* tf, unsigned int tf_size, int base, float rest);
-
     core::CallerSlot _tf_slot;
 
     unsigned int _frame_id = std::numeric_limits<unsigned int>::max();
@@ -0,0 +1,196 @@
+/*
+ * AsyncDataModule.cpp
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "AsyncDataModule.h"
+#include "mmcore/AbstractGetData3DCall.h"
+#include "mmcore/CoreInstance.h"
+#include "mmcore/factories/CallDescriptionManager.h"
+#include "mmcore/param/BoolParam.h"
+#include "stdafx.h"
+
+using namespace megamol;
+
+
+/*
+ * datatools::AsyncDataModule::AsyncDataModule
+ */
+datatools::AsyncDataModule::AsyncDataModule(void)
+        : core::Module()
+        , outDataSlot("outData", "The slot for publishing data")
+        , inDataSlot("inData", "The slot for requesting data from the source")
+        , asyncSlot("async", "Request the data in the background and return the last complete data meanwhile")
+        , waitForFirstSlot("waitForFirst", "Block until the first data is available instead of returning no data")
+        , data() {
+
+    this->asyncSlot.SetParameter(new core::param::BoolParam(true));
+    this->MakeSlotAvailable(&this->asyncSlot);
+
+    this->waitForFirstSlot.SetParameter(new core::param::BoolParam(true));
+    this->MakeSlotAvailable(&this->waitForFirstSlot);
+}
+
+
+/*
+ * datatools::AsyncDataModule::~AsyncDataModule
+ */
+datatools::AsyncDataModule::~AsyncDataModule(void) {
+    this->Release(); // implicitly calls 'release'
+}
+
+
+/*
+ * datatools::AsyncDataModule::create
+ */
+bool datatools::AsyncDataModule::create(void) {
+    for (auto cd : this->GetCoreInstance()->GetCallDescriptionManager()) {
+        if (IsCallDescriptionCompatible(cd)) {
+            this->outDataSlot.SetCallback(cd->ClassName(), "GetData", &AsyncDataModule::getDataCallback);
+            this->outDataSlot.SetCallback(cd->ClassName(), "GetExtent", &AsyncDataModule::getExtentCallback);
+            this->inDataSlot.SetCompatibleCall(cd);
+        }
+    }
+    this->MakeSlotAvailable(&this->outDataSlot);
+    this->MakeSlotAvailable(&this->inDataSlot);
+    return true;
+}
+
+
+/*
+ * datatools::AsyncDataModule::release
+ */
+void datatools::AsyncDataModule::release(void) {
+    this->data.Reset();
+}
+
+
+/*
+ * datatools::AsyncDataModule::IsCallDescriptionCompatible
+ */
+bool datatools::AsyncDataModule::IsCallDescriptionCompatible(core::factories::CallDescription::ptr desc) {
+    return (desc->FunctionCount() == 2) && vislib::StringA("GetData").Equals(desc->FunctionName(0), false) &&
+           vislib::StringA("GetExtent").Equals(desc->FunctionName(1), false);
+}
+
+
+/*
+ * datatools::AsyncDataModule::getDataCallback
+ */
+bool datatools::AsyncDataModule::getDataCallback(core::Call& caller) {
+    using megamol::core::AbstractGetData3DCall;
+    auto desc = this->checkConnections(&caller);
+    if (desc == nullptr)
+        return false;
+
+    AbstractGetData3DCall* pgdc = dynamic_cast<AbstractGetData3DCall*>(&caller);
+    if (pgdc == nullptr)
+        return false;
+
+    AbstractGetData3DCall* ggdc = this->inDataSlot.CallAs<AbstractGetData3DCall>();
+    if (ggdc == nullptr)
+        return false;
+
+    const auto& calls = this->GetCoreInstance()->GetCallDescriptionManager();
+
+    if (!this->asyncSlot.Param<core::param::BoolParam>()->Value()) {
+        this->data.Reset();
+        calls.AssignmentCrowbar(ggdc, pgdc);
+        if (!(*ggdc)(0))
+            return false;
+        calls.AssignmentCrowbar(pgdc, ggdc);
+        ggdc->SetUnlocker(nullptr, false);
+        return true;
+    }
+
+    // collect finished data and keep exactly one request in flight
+    this->data.Update();
+    if (!this->data.IsPending()) {
+        calls.AssignmentCrowbar(ggdc, pgdc);
+        if (this->data.Request(*ggdc, {1, 0}, desc)) {
+            this->data.Update(); // calls which cannot run in the background are ready already
+        }
+    }
+    if ((this->data.LastComplete() == nullptr) && this->waitForFirstSlot.Param<core::param::BoolParam>()->Value()) {
+        this->data.Wait();
+    }
+
+    core::AbstractGetDataCall* last = this->data.LastComplete();
+    if (last == nullptr)
+        return false;
+
+    // the snapshot keeps the unlocker until it is replaced
+    calls.AssignmentCrowbar(pgdc, last);
+    pgdc->SetUnlocker(nullptr, false);
+
+    return true;
+}
+
+
+/*
+ * datatools::AsyncDataModule::getExtentCallback
+ */
+bool datatools::AsyncDataModule::getExtentCallback(core::Call& caller) {
+    using megamol::core::AbstractGetData3DCall;
+    auto desc = this->checkConnections(&caller);
+    if (desc == nullptr)
+        return false;
+
+    AbstractGetData3DCall* pgdc = dynamic_cast<AbstractGetData3DCall*>(&caller);
+    if (pgdc == nullptr)
+        return false;
+
+    AbstractGetData3DCall* ggdc = this->inDataSlot.CallAs<AbstractGetData3DCall>();
+    if (ggdc == nullptr)
+        return false;
+
+    const auto& calls = this->GetCoreInstance()->GetCallDescriptionManager();
+
+    // the source must not be called while it computes data in the background, so the extent of the data
+    // returned meanwhile is answered, which the request fetched together with the data
+    this->data.Update();
+    if (this->data.IsPending()) {
+        core::AbstractGetDataCall* last = this->data.LastComplete();
+        if ((last != nullptr) && desc->IsDescribing(last)) {
+            const unsigned int fid = pgdc->FrameID();
+            const bool forced = pgdc->IsFrameForced();
+            calls.AssignmentCrowbar(pgdc, last);
+            pgdc->SetUnlocker(nullptr, false);
+            pgdc->SetFrameID(fid, forced);
+            return true;
+        }
+        this->data.Wait();
+    }
+
+    calls.AssignmentCrowbar(ggdc, pgdc);
+    if (!(*ggdc)(1))
+        return false;
+    calls.AssignmentCrowbar(pgdc, ggdc);
+    ggdc->SetUnlocker(nullptr, false);
+
+    return true;
+}
+
+
+/*
+ * datatools::AsyncDataModule::checkConnections
+ */
+core::factories::CallDescription::ptr datatools::AsyncDataModule::checkConnections(core::Call* outCall) {
+    if (this->inDataSlot.GetStatus() != core::AbstractSlot::STATUS_CONNECTED)
+        return nullptr;
+    if (this->outDataSlot.GetStatus() != core::AbstractSlot::STATUS_CONNECTED)
+        return nullptr;
+    core::Call* inCall = this->inDataSlot.CallAs<core::Call>();
+    if ((inCall == nullptr) || (outCall == nullptr))
+        return nullptr;
+    for (auto cd : this->GetCoreInstance()->GetCallDescriptionManager()) {
+        if (IsCallDescriptionCompatible(cd)) {
+            if (cd->IsDescribing(inCall) && cd->IsDescribing(outCall))
+                return cd;
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,146 @@
+/*
+ * AsyncDataModule.h
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include "mmcore/AbstractGetDataCall.h"
+#include "mmcore/AsyncGetDataCall.h"
+#include "mmcore/CalleeSlot.h"
+#include "mmcore/CallerSlot.h"
+#include "mmcore/Module.h"
+#include "mmcore/factories/CallDescription.h"
+#include "mmcore/param/ParamSlot.h"
+
+
+namespace megamol {
+namespace datatools {
+
+
+/**
+ * In-Between module decoupling a slow data source from its consumers. The
+ * data is requested in the background, and the last complete answer is
+ * returned meanwhile, so views keep rendering the previous data while the
+ * upstream modules compute. Only sources whose upstream modules support
+ * background calls (see core::Module::SupportsBackgroundCalls) are requested
+ * in the background, all others are called synchronously.
+ */
+class AsyncDataModule : public core::Module {
+public:
+    /**
+     * Answer the name of this module.
+     *
+     * @return The name of this module.
+     */
+    static const char* ClassName(void) {
+        return "AsyncDataModule";
+    }
+
+    /**
+     * Answer a human readable description of this module.
+     *
+     * @return A human readable description of this module.
+     */
+    static const char* Description(void) {
+        return "In-Between module requesting data in the background and returning the last complete data meanwhile. "
+               "Sources which do not support background calls are called synchronously";
+    }
+
+    /**
+     * Answers whether this module is available on the current system.
+     *
+     * @return 'true' if the module is available, 'false' otherwise.
+     */
+    static bool IsAvailable(void) {
+        return true;
+    }
+
+    /**
+     * Disallow usage in quickstarts
+     *
+     * @return false
+     */
+    static bool SupportQuickstart(void) {
+        return false;
+    }
+
+    /** Ctor. */
+    AsyncDataModule(void);
+
+    /** Dtor. */
+    virtual ~AsyncDataModule(void);
+
+protected:
+    /**
+     * Implementation of 'Create'.
+     *
+     * @return 'true' on success, 'false' otherwise.
+     */
+    virtual bool create(void);
+
+    /**
+     * Implementation of 'Release'.
+     */
+    virtual void release(void);
+
+private:
+    /**
+     * Tests if th description of a call seems compatible
+     *
+     * @param desc The description to test
+     *
+     * @return True if description seems compatible
+     */
+    static bool IsCallDescriptionCompatible(core::factories::CallDescription::ptr desc);
+
+    /**
+     * Gets the data from the source.
+     *
+     * @param caller The calling call.
+     *
+     * @return 'true' on success, 'false' on failure.
+     */
+    bool getDataCallback(core::Call& caller);
+
+    /**
+     * Gets the extent from the source.
+     *
+     * @param caller The calling call.
+     *
+     * @return 'true' on success, 'false' on failure.
+     */
+    bool getExtentCallback(core::Call& caller);
+
+    /**
+     * Checks if the callee and the caller slot are connected with the
+     * same call classes
+     *
+     * @param outCall The incoming call requesting data
+     *
+     * @return The description of the call class or 'nullptr' if the
+     *         connections do not match.
+     */
+    core::factories::CallDescription::ptr checkConnections(core::Call* outCall);
+
+    /** The slot for publishing data */
+    core::CalleeSlot outDataSlot;
+
+    /** The slot for requesting data from the source */
+    core::CallerSlot inDataSlot;
+
+    /** Flag whether data is requested in the background */
+    core::param::ParamSlot asyncSlot;
+
+    /** Flag whether to block until the first data is available */
+    core::param::ParamSlot waitForFirstSlot;
+
+    /** The pending and the last complete data request */
+    core::AsyncGetDataCall data;
+};
+
+} /* end namespace datatools */
+} /* end namespace megamol */
@@ -8,6 +8,7 @@
 #include "mmcore/utility/plugins/PluginRegister.h"
 
 #include "AddParticleColors.h"
+#include "AsyncDataModule.h"
 #include "CSVFileSequence.h"
 #include "CSVWriter.h"
 #include "ColorToDir.h"
@@ -105,6 +106,7 @@ public:
 
         // register modules
         this->module_descriptions.RegisterAutoDescription<megamol::datatools::DataSetTimeRewriteModule>();
+        this->module_descriptions.RegisterAutoDescription<megamol::datatools::AsyncDataModule>();
         this->module_descriptions.RegisterAutoDescription<megamol::datatools::DataFileSequenceStepper>();
         this->module_descriptions.RegisterAutoDescription<megamol::datatools::SphereDataUnifier>();
         this->module_descriptions.RegisterAutoDescription<megamol::datatools::ParticleThinner>();
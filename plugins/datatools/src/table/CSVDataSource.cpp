@@ -93,21 +93,29 @@ CSVDataSource::CSVDataSource(void)
         , shuffleSlot("shuffle", "Shuffle data points")
         , getDataSlot("getData", "Slot providing the data")
         , dataHash(0)
+        , reloadPending(false)
+        , shufflePending(false)
+        , clearPending(false)
         , columns()
         , values() {
     this->filenameSlot << new core::param::FilePathParam("");
+    this->filenameSlot.SetUpdateCallback(&CSVDataSource::settingsChanged);
     this->MakeSlotAvailable(&this->filenameSlot);
 
     this->skipPrefaceSlot.SetParameter(new core::param::IntParam(0));
+    this->skipPrefaceSlot.SetUpdateCallback(&CSVDataSource::settingsChanged);
     this->MakeSlotAvailable(&this->skipPrefaceSlot);
 
     this->headerNamesSlot.SetParameter(new core::param::BoolParam(true));
+    this->headerNamesSlot.SetUpdateCallback(&CSVDataSource::settingsChanged);
     this->MakeSlotAvailable(&this->headerNamesSlot);
 
     this->headerTypesSlot.SetParameter(new core::param::BoolParam(false));
+    this->headerTypesSlot.SetUpdateCallback(&CSVDataSource::settingsChanged);
     this->MakeSlotAvailable(&this->headerTypesSlot);
 
     this->commentPrefixSlot.SetParameter(new core::param::StringParam(""));
+    this->commentPrefixSlot.SetUpdateCallback(&CSVDataSource::settingsChanged);
     this->MakeSlotAvailable(&this->commentPrefixSlot);
 
     this->clearSlot << new core::param::ButtonParam();
@@ -115,6 +123,7 @@ CSVDataSource::CSVDataSource(void)
     this->MakeSlotAvailable(&this->clearSlot);
 
     this->colSepSlot << new core::param::StringParam("");
+    this->colSepSlot.SetUpdateCallback(&CSVDataSource::settingsChanged);
     this->MakeSlotAvailable(&this->colSepSlot);
 
     core::param::EnumParam* ep = new core::param::EnumParam(0);
@@ -122,9 +131,11 @@ CSVDataSource::CSVDataSource(void)
     ep->SetTypePair(static_cast<int>(DecimalSeparator::US), "US (3.141)");
     ep->SetTypePair(static_cast<int>(DecimalSeparator::DE), "DE (3,141)");
     this->decSepSlot << ep;
+    this->decSepSlot.SetUpdateCallback(&CSVDataSource::settingsChanged);
     this->MakeSlotAvailable(&this->decSepSlot);
 
     this->shuffleSlot.SetParameter(new core::param::BoolParam(false));
+    this->shuffleSlot.SetUpdateCallback(&CSVDataSource::settingsChanged);
     this->MakeSlotAvailable(&this->shuffleSlot);
 
     this->getDataSlot.SetCallback(TableDataCall::ClassName(), "GetData", &CSVDataSource::getDataCallback);
@@ -142,35 +153,39 @@ bool CSVDataSource::create(void) {
 }
 
 void CSVDataSource::release(void) {
+    std::lock_guard<std::mutex> lock(this->dataLock);
     this->columns.clear();
     this->values.clear();
 }
 
 void CSVDataSource::assertData(void) {
-    if (!this->filenameSlot.IsDirty() && !this->skipPrefaceSlot.IsDirty() && !this->headerNamesSlot.IsDirty() &&
-        !this->headerTypesSlot.IsDirty() && !this->commentPrefixSlot.IsDirty() && !this->colSepSlot.IsDirty() &&
-        !this->decSepSlot.IsDirty()) {
-        if (this->shuffleSlot.IsDirty()) {
-            shuffleData();
-            this->shuffleSlot.ResetDirty();
+    // the parameters are not touched here, the call may run on a worker thread
+    Settings set;
+    bool reload, shuffle, clear;
+    {
+        std::lock_guard<std::mutex> lock(this->settingsLock);
+        set = this->settings;
+        reload = this->reloadPending;
+        shuffle = this->shufflePending;
+        clear = this->clearPending;
+        this->reloadPending = this->shufflePending = this->clearPending = false;
+    }
+    if (clear) {
+        this->columns.clear();
+        this->values.clear();
+    }
+    if (!reload) {
+        if (shuffle) {
+            shuffleData(set.shuffle);
             this->dataHash++;
         }
         return; // nothing to do
     }
 
-    this->filenameSlot.ResetDirty();
-    this->skipPrefaceSlot.ResetDirty();
-    this->headerNamesSlot.ResetDirty();
-    this->headerTypesSlot.ResetDirty();
-    this->commentPrefixSlot.ResetDirty();
-    this->colSepSlot.ResetDirty();
-    this->decSepSlot.ResetDirty();
-    this->shuffleSlot.ResetDirty();
-
     this->columns.clear();
     this->values.clear();
 
-    auto filename = this->filenameSlot.Param<core::param::FilePathParam>()->Value();
+    const auto& filename = set.filename;
 
     try {
         vislib::sys::ASCIIFileBuffer file;
@@ -184,14 +199,14 @@ void CSVDataSource::assertData(void) {
 
         // 2. Determine the first row, column separator, and decimal point
         //////////////////////////////////////////////////////////////////////
-        int firstHeaRow = this->skipPrefaceSlot.Param<core::param::IntParam>()->Value();
-        int firstDatRow = this->skipPrefaceSlot.Param<core::param::IntParam>()->Value();
-        if (headerNamesSlot.Param<core::param::BoolParam>()->Value())
+        int firstHeaRow = set.skipPreface;
+        int firstDatRow = set.skipPreface;
+        if (set.headerNames)
             firstDatRow++;
-        if (headerTypesSlot.Param<core::param::BoolParam>()->Value())
+        if (set.headerTypes)
             firstDatRow++;
 
-        auto comment = vislib::StringA(this->commentPrefixSlot.Param<core::param::StringParam>()->Value().c_str());
+        auto comment = vislib::StringA(set.commentPrefix.c_str());
         if (!comment.IsEmpty()) {
             // Skip comments at the beginning of the file.
             while (firstHeaRow < file.Count()) {
@@ -203,7 +218,7 @@ void CSVDataSource::assertData(void) {
             }
         }
 
-        vislib::StringA colSep(this->colSepSlot.Param<core::param::StringParam>()->Value().c_str());
+        vislib::StringA colSep(set.colSep.c_str());
         if (colSep.IsEmpty()) {
             // Detect column separator
             const char ColSepCanidates[] = {'\t', ';', ',', '|'};
@@ -221,8 +236,7 @@ void CSVDataSource::assertData(void) {
             }
         }
 
-        DecimalSeparator decType =
-            static_cast<DecimalSeparator>(this->decSepSlot.Param<core::param::EnumParam>()->Value());
+        DecimalSeparator decType = static_cast<DecimalSeparator>(set.decSep);
         if (decType == DecimalSeparator::Unknown) {
             // Detect decimal type
             vislib::Array<vislib::StringA> tokens(vislib::StringTokeniserA::Split(file[firstDatRow], colSep, false));
@@ -246,7 +260,7 @@ void CSVDataSource::assertData(void) {
         // 3. Table layout is now clear... determine column headers.
         //////////////////////////////////////////////////////////////////////
         vislib::Array<vislib::StringA> dimNames;
-        if (headerNamesSlot.Param<core::param::BoolParam>()->Value()) {
+        if (set.headerNames) {
             dimNames = vislib::StringTokeniserA::Split(file[firstHeaRow], colSep, false);
             firstHeaRow++;
         } else {
@@ -259,7 +273,7 @@ void CSVDataSource::assertData(void) {
         this->values.clear();
 
         bool hasCatDims = false;
-        if (headerTypesSlot.Param<core::param::BoolParam>()->Value()) {
+        if (set.headerTypes) {
             vislib::Array<vislib::StringA> tokens(vislib::StringTokeniserA::Split(file[firstHeaRow], colSep, false));
             for (SIZE_T i = 0; i < dimNames.Count(); i++) {
                 TableDataCall::ColumnType type = TableDataCall::ColumnType::QUANTITATIVE;
@@ -454,13 +468,13 @@ void CSVDataSource::assertData(void) {
         this->values.clear();
     }
 
-    shuffleData();
+    shuffleData(set.shuffle);
 
     this->dataHash++;
 }
 
-void CSVDataSource::shuffleData() {
-    if (!this->shuffleSlot.Param<core::param::BoolParam>()->Value()) {
+void CSVDataSource::shuffleData(bool shuffle) {
+    if (!shuffle) {
         // Do not shuffle, unless requested
         return;
     }
@@ -482,6 +496,7 @@ bool CSVDataSource::getDataCallback(core::Call& caller) {
     if (tfd == nullptr)
         return false;
 
+    std::lock_guard<std::mutex> lock(this->dataLock);
     this->assertData();
 
     tfd->SetDataHash(this->dataHash);
@@ -501,6 +516,7 @@ bool CSVDataSource::getHashCallback(core::Call& caller) {
     if (tfd == nullptr)
         return false;
 
+    std::lock_guard<std::mutex> lock(this->dataLock);
     this->assertData();
 
     tfd->SetDataHash(this->dataHash);
@@ -512,8 +528,28 @@ bool CSVDataSource::getHashCallback(core::Call& caller) {
 }
 
 bool CSVDataSource::clearData(core::param::ParamSlot& caller) {
-    this->columns.clear();
-    this->values.clear();
+    // applied by the next call, which may be running on a worker thread right now
+    std::lock_guard<std::mutex> lock(this->settingsLock);
+    this->clearPending = true;
+
+    return true;
+}
+
+bool CSVDataSource::settingsChanged(core::param::ParamSlot& caller) {
+    std::lock_guard<std::mutex> lock(this->settingsLock);
+    this->settings.filename = this->filenameSlot.Param<core::param::FilePathParam>()->Value();
+    this->settings.skipPreface = this->skipPrefaceSlot.Param<core::param::IntParam>()->Value();
+    this->settings.headerNames = this->headerNamesSlot.Param<core::param::BoolParam>()->Value();
+    this->settings.headerTypes = this->headerTypesSlot.Param<core::param::BoolParam>()->Value();
+    this->settings.commentPrefix = this->commentPrefixSlot.Param<core::param::StringParam>()->Value();
+    this->settings.colSep = this->colSepSlot.Param<core::param::StringParam>()->Value();
+    this->settings.decSep = this->decSepSlot.Param<core::param::EnumParam>()->Value();
+    this->settings.shuffle = this->shuffleSlot.Param<core::param::BoolParam>()->Value();
+    if (&caller == &this->shuffleSlot) {
+        this->shufflePending = true;
+    } else {
+        this->reloadPending = true;
+    }
 
     return true;
 }
@@ -14,6 +14,9 @@
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/Module.h"
 #include "mmcore/param/ParamSlot.h"
+#include <filesystem>
+#include <mutex>
+#include <string>
 #include <vector>
 
 namespace megamol {
@@ -35,6 +38,14 @@ public:
     CSVDataSource(void);
     virtual ~CSVDataSource(void);
 
+    /**
+     * The parameters are latched by their update callbacks and the data is
+     * guarded by a lock, so the data may be loaded on a worker thread.
+     */
+    bool SupportsBackgroundCalls(void) const override {
+        return true;
+    }
+
 protected:
     virtual bool create(void);
     virtual void release(void);
@@ -45,7 +56,20 @@ private:
     bool getHashCallback(core::Call& caller);
 
     bool clearData(core::param::ParamSlot& caller);
-    void shuffleData();
+    bool settingsChanged(core::param::ParamSlot& caller);
+    void shuffleData(bool shuffle);
+
+    /** The parameter values, copied on the thread setting them */
+    struct Settings {
+        std::filesystem::path filename;
+        int skipPreface = 0;
+        bool headerNames = true;
+        bool headerTypes = false;
+        std::string commentPrefix;
+        std::string colSep;
+        int decSep = 0;
+        bool shuffle = false;
+    };
 
     core::param::ParamSlot filenameSlot;
     core::param::ParamSlot skipPrefaceSlot;
@@ -61,6 +85,16 @@ private:
 
     SIZE_T dataHash;
 
+    /** Guards 'settings' and the pending changes */
+    std::mutex settingsLock;
+    Settings settings;
+    bool reloadPending;
+    bool shufflePending;
+    bool clearPending;
+
+    /** Guards the data and serialises the call functions */
+    std::mutex dataLock;
+
     std::vector<TableDataCall::ColumnInfo> columns;
     std::vector<float> values;
 };
@@ -59,6 +59,7 @@ MMFTDataSource::MMFTDataSource()
         , values_() {
 
     filenameSlot_ << new core::param::FilePathParam("");
+    filenameSlot_.SetUpdateCallback(this, &MMFTDataSource::filenameCallback);
     MakeSlotAvailable(&filenameSlot_);
     reloadSlot_ << new core::param::ButtonParam();
     reloadSlot_.SetUpdateCallback(this, &MMFTDataSource::reloadCallback);
@@ -79,6 +80,7 @@ bool MMFTDataSource::create() {
 }
 
 void MMFTDataSource::release() {
+    std::lock_guard<std::mutex> lock(dataLock_);
     columns_.clear();
     values_.clear();
 }
@@ -86,17 +88,19 @@ void MMFTDataSource::release() {
 void MMFTDataSource::assertData() {
     using namespace std::string_literals;
 
-    if (!filenameSlot_.IsDirty() && !reload_) {
-        return; // nothing to do
+    // the parameters are not touched here, the call may run on a worker thread
+    std::filesystem::path filename;
+    {
+        std::lock_guard<std::mutex> lock(settingsLock_);
+        if (!reload_) {
+            return; // nothing to do
+        }
+        reload_ = false;
+        filename = filename_;
     }
 
-    filenameSlot_.ResetDirty();
-    reload_ = false;
-
     columns_.clear();
     values_.clear();
-
-    auto filename = filenameSlot_.Param<core::param::FilePathParam>()->Value();
     std::ifstream file(filename, std::ios::binary);
     if (!file.is_open()) {
         megamol::core::utility::log::Log::DefaultLog.WriteError(
@@ -147,6 +151,7 @@ bool MMFTDataSource::getDataCallback(core::Call& caller) {
         return false;
     }
 
+    std::lock_guard<std::mutex> lock(dataLock_);
     assertData();
 
     tfd->SetDataHash(dataHash_);
@@ -168,6 +173,7 @@ bool MMFTDataSource::getHashCallback(core::Call& caller) {
         return false;
     }
 
+    std::lock_guard<std::mutex> lock(dataLock_);
     assertData();
 
     tfd->SetFrameCount(1);
@@ -178,6 +184,14 @@ bool MMFTDataSource::getHashCallback(core::Call& caller) {
 }
 
 bool MMFTDataSource::reloadCallback(core::param::ParamSlot& caller) {
+    std::lock_guard<std::mutex> lock(settingsLock_);
+    reload_ = true;
+    return true;
+}
+
+bool MMFTDataSource::filenameCallback(core::param::ParamSlot& caller) {
+    std::lock_guard<std::mutex> lock(settingsLock_);
+    filename_ = filenameSlot_.Param<core::param::FilePathParam>()->Value();
     reload_ = true;
     return true;
 }
@@ -7,6 +7,8 @@
 #ifndef MEGAMOL_DATATOOLS_MMFTDATASOURCE_H_INCLUDED
 #define MEGAMOL_DATATOOLS_MMFTDATASOURCE_H_INCLUDED
 
+#include <filesystem>
+#include <mutex>
 #include <vector>
 
 #include "datatools/table/TableDataCall.h"
@@ -32,12 +34,22 @@ public:
     MMFTDataSource();
     ~MMFTDataSource() override;
 
+    /**
+     * The file name is latched by its update callback and the data is
+     * guarded by a lock, so the data may be loaded on a worker thread.
+     */
+    bool SupportsBackgroundCalls() const override {
+        return true;
+    }
+
 protected:
     bool create() override;
     void release() override;
 
     bool reloadCallback(core::param::ParamSlot& caller);
 
+    bool filenameCallback(core::param::ParamSlot& caller);
+
 private:
     inline void assertData();
     bool getDataCallback(core::Call& caller);
@@ -49,8 +61,15 @@ private:
     core::param::ParamSlot reloadSlot_;
 
     std::size_t dataHash_;
+
+    /** Guards the file name and the reload request */
+    std::mutex settingsLock_;
+    std::filesystem::path filename_;
     bool reload_;
 
+    /** Guards the data and serialises the call functions */
+    std::mutex dataLock_;
+
     std::vector<TableDataCall::ColumnInfo> columns_;
     std::vector<float> values_;
 };
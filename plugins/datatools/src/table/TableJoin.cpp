@@ -6,6 +6,7 @@
  */
 
 #include "TableJoin.h"
+#include "mmcore/CallScheduler.h"
 #include "stdafx.h"
 
 #include <limits>
@@ -64,10 +65,12 @@ bool TableJoin::processData(core::Call& c) {
         if (secondInCall == NULL)
             return false;
 
-        // call getHash before check of frame count
-        if (!(*firstInCall)(1))
-            return false;
-        if (!(*secondInCall)(1))
+        // call getHash before check of frame count, both inputs concurrently if enabled
+        std::vector<core::CallScheduler::Request> inCalls(2);
+        inCalls[0].call = firstInCall;
+        inCalls[1].call = secondInCall;
+        inCalls[0].func = inCalls[1].func = 1;
+        if (!core::CallScheduler::Run(inCalls))
             return false;
 
         // check time compatibility
@@ -83,9 +86,8 @@ bool TableJoin::processData(core::Call& c) {
         secondInCall->SetFrameID(outCall->GetFrameID());
 
         // issue calls
-        if (!(*firstInCall)())
-            return false;
-        if (!(*secondInCall)())
+        inCalls[0].func = inCalls[1].func = 0;
+        if (!core::CallScheduler::Run(inCalls))
             return false;
 
         if (this->firstDataHash != firstInCall->DataHash() || this->secondDataHash != secondInCall->DataHash() ||
@@ -30,6 +30,9 @@ public:
     /** Structure containing all required metadata about a data set. */
     typedef struct VolumetricMetadata_t Metadata;
 
+    /** Hierarchical min/max grid of a frame. */
+    typedef struct VolumetricMacroCells_t MacroCells;
+
     /**
      * Answer the name of this module.
      *
@@ -191,6 +194,24 @@ public:
      */
     GridType GetGridType(void) const;
 
+    /**
+     * Gets the min/max macrocells of the data.
+     *
+     * @return The macrocells if provided by the data source.
+     */
+    inline const MacroCells* GetMacroCells(void) const {
+        return (this->metadata != nullptr) ? this->metadata->MacroCells : nullptr;
+    }
+
+    /**
+     * Gets the requested level of detail.
+     *
+     * @return The requested level, 0 being the full resolution.
+     */
+    inline unsigned int GetLevelOfDetail(void) const {
+        return this->lod;
+    }
+
     /**
      * Gets the metadata record.
      *
@@ -211,6 +232,17 @@ public:
      */
     const size_t GetResolution(const int axis) const;
 
+    /**
+     * Gets the requested region of interest in voxels of the full
+     * resolution, 'lower' inclusive, 'upper' exclusive.
+     *
+     * @param lower Receives the lower corner.
+     * @param upper Receives the upper corner.
+     *
+     * @return false if the region is empty, ie the whole volume is requested.
+     */
+    bool GetRegionOfInterest(size_t lower[3], size_t upper[3]) const;
+
     /**
      * Gets the length of a scalar (component) in bytes.
      *
@@ -291,6 +323,29 @@ public:
         this->vram_volume_name = texture_name;
     }
 
+    /**
+     * Requests a level of detail from sources which support it. Level l
+     * halves the resolution l times. The metadata of the answer describe
+     * the data actually delivered.
+     *
+     * @param lod The requested level, 0 being the full resolution.
+     */
+    inline void SetLevelOfDetail(const unsigned int lod) {
+        this->lod = lod;
+    }
+
+    /**
+     * Requests a region of interest from sources which support it. The
+     * corners are given in voxels of the full resolution, 'lower'
+     * inclusive, 'upper' exclusive. An empty region requests the whole
+     * volume. The metadata of the answer describe the region actually
+     * delivered.
+     *
+     * @param lower The lower corner.
+     * @param upper The upper corner.
+     */
+    void SetRegionOfInterest(const size_t lower[3], const size_t upper[3]);
+
     /**
      * Update the metadata.
      *
@@ -323,6 +378,13 @@ private:
 
     /** Pointer to the metadata descriptor of the data set. */
     const Metadata* metadata;
+
+    /** The requested region of interest, empty for the whole volume. */
+    size_t roiLower[3];
+    size_t roiUpper[3];
+
+    /** The requested level of detail. */
+    unsigned int lod;
 };
 
 /** Call Descriptor.  */
@@ -21,6 +21,78 @@ enum ScalarType_t { UNKNOWN, SIGNED_INTEGER, UNSIGNED_INTEGER, FLOATING_POINT, B
 /** Possible (physical) memory locations */
 enum MemoryLocation { VRAM, RAM };
 
+/**
+ * Hierarchical min/max grid over the voxels of one frame, e.g. for
+ * empty-space skipping and isovalue culling.
+ *
+ * Level 0 divides the volume into bricks of BrickSize^3 voxels. Each brick
+ * also includes the first voxel layer of its successors, so its range bounds
+ * all values which trilinear interpolation can produce inside the brick.
+ * Every further level merges 2^3 cells of the level below, the last level
+ * consists of a single cell. The data source providing the macrocells
+ * remains owner of all arrays.
+ */
+struct VolumetricMacroCells_t {
+
+    /** Initialise a new instance. */
+    VolumetricMacroCells_t(void)
+            : BrickSize(0)
+            , Levels(0)
+            , Components(0)
+            , Resolution(nullptr)
+            , Offsets(nullptr)
+            , MinValues(nullptr)
+            , MaxValues(nullptr) {}
+
+    /**
+     * Answer the index of a cell in MinValues and MaxValues, which must be
+     * multiplied by Components.
+     *
+     * @param level The level of the cell.
+     * @param x     The x-index of the cell on its level.
+     * @param y     The y-index of the cell on its level.
+     * @param z     The z-index of the cell on its level.
+     *
+     * @return The index of the cell.
+     */
+    inline size_t CellIndex(size_t level, size_t x, size_t y, size_t z) const {
+        const size_t* res = this->Resolution + 3 * level;
+        return this->Offsets[level] + (z * res[1] + y) * res[0] + x;
+    }
+
+    /**
+     * Answer whether a cell may contain values of component 'c' within
+     * [lo, hi].
+     *
+     * @return 'false' if the cell can be skipped.
+     */
+    inline bool Overlaps(size_t cell, size_t c, double lo, double hi) const {
+        const size_t i = cell * this->Components + c;
+        return (this->MinValues[i] <= hi) && (this->MaxValues[i] >= lo);
+    }
+
+    /** The edge length of a cell of level 0 in voxels. */
+    size_t BrickSize;
+
+    /** The number of levels. */
+    size_t Levels;
+
+    /** The number of components per cell. */
+    size_t Components;
+
+    /** The number of cells per axis, three entries per level. */
+    const size_t* Resolution;
+
+    /** The index of the first cell of each level. */
+    const size_t* Offsets;
+
+    /** The minimal values per cell and component, rounded down. */
+    const float* MinValues;
+
+    /** The maximal values per cell and component, rounded up. */
+    const float* MaxValues;
+};
+
 /**
  * Structure containing all required metadata about a data set, which are
  * natively stored by the datRaw library (the structure allows for zero-copy
@@ -41,6 +113,7 @@ struct VolumetricMetadata_t {
         MinValues = nullptr;
         MaxValues = nullptr;
         MemLoc = RAM;
+        MacroCells = nullptr;
     }
 
     // creates a deep copy of the instance. beware that the owner of the copy
@@ -73,6 +146,7 @@ struct VolumetricMetadata_t {
         memcpy(clone.MinValues, this->MinValues, sizeof(double) * this->Components);
         memcpy(clone.MaxValues, this->MaxValues, sizeof(double) * this->Components);
         clone.MemLoc = this->MemLoc;
+        clone.MacroCells = nullptr; // owned by the data source, not cloned
         return clone;
     }
 
@@ -131,6 +205,12 @@ struct VolumetricMetadata_t {
      * (Physical) memory location of the volume data.
      */
     enum MemoryLocation MemLoc;
+
+    /**
+     * Optional min/max macrocells of the current frame. The data source
+     * providing the metadata remains owner of the macrocells.
+     */
+    const VolumetricMacroCells_t* MacroCells;
 };
 
 } // namespace megamol::geocalls
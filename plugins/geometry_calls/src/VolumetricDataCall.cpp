@@ -8,6 +8,7 @@
 #include "geometry_calls/VolumetricDataCall.h"
 #include "stdafx.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "vislib/OutOfRangeException.h"
@@ -114,7 +115,13 @@ const unsigned int VolumetricDataCall::IDX_TRY_GET_DATA = 5;
 /*
  * VolumetricDataCall::VolumetricDataCall
  */
-VolumetricDataCall::VolumetricDataCall(void) : data(nullptr), metadata(nullptr), vram_volume_name(0) {}
+VolumetricDataCall::VolumetricDataCall(void)
+        : data(nullptr)
+        , metadata(nullptr)
+        , vram_volume_name(0)
+        , roiLower{0, 0, 0}
+        , roiUpper{0, 0, 0}
+        , lod(0) {}
 
 
 /*
@@ -123,7 +130,10 @@ VolumetricDataCall::VolumetricDataCall(void) : data(nullptr), metadata(nullptr),
 VolumetricDataCall::VolumetricDataCall(const VolumetricDataCall& rhs)
         : data(nullptr)
         , metadata(nullptr)
-        , vram_volume_name(0) {
+        , vram_volume_name(0)
+        , roiLower{0, 0, 0}
+        , roiUpper{0, 0, 0}
+        , lod(0) {
     *this = rhs;
 }
 
@@ -169,6 +179,20 @@ const size_t VolumetricDataCall::GetResolution(const int axis) const {
 }
 
 
+/*
+ * VolumetricDataCall::GetRegionOfInterest
+ */
+bool VolumetricDataCall::GetRegionOfInterest(size_t lower[3], size_t upper[3]) const {
+    bool isEmpty = false;
+    for (int i = 0; i < 3; ++i) {
+        lower[i] = this->roiLower[i];
+        upper[i] = this->roiUpper[i];
+        isEmpty = isEmpty || (upper[i] <= lower[i]);
+    }
+    return !isEmpty;
+}
+
+
 /*
  * VolumetricDataCall::GetScalarLength
  */
@@ -307,6 +331,15 @@ bool VolumetricDataCall::IsUniform(const int axis) const {
 }
 
 
+/*
+ * VolumetricDataCall::SetRegionOfInterest
+ */
+void VolumetricDataCall::SetRegionOfInterest(const size_t lower[3], const size_t upper[3]) {
+    std::copy(lower, lower + 3, this->roiLower);
+    std::copy(upper, upper + 3, this->roiUpper);
+}
+
+
 /*
  * VolumetricDataCall::SetMetadata
  */
@@ -323,6 +356,9 @@ VolumetricDataCall& VolumetricDataCall::operator=(const VolumetricDataCall& rhs)
         Base::operator=(rhs);
         this->data = rhs.data;
         this->metadata = rhs.metadata;
+        std::copy(rhs.roiLower, rhs.roiLower + 3, this->roiLower);
+        std::copy(rhs.roiUpper, rhs.roiUpper + 3, this->roiUpper);
+        this->lod = rhs.lod;
     }
     return *this;
 }
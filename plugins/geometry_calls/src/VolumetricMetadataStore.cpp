@@ -131,5 +131,6 @@ void VolumetricMetadataStore::rewrire(void) {
     for (std::size_t i = 0; i < this->sliceDists.size(); ++i) {
         this->SliceDists[i] = this->sliceDists[i].empty() ? nullptr : this->sliceDists[i].data();
     }
+    this->MacroCells = nullptr; // not stored, would dangle
 }
 } // namespace megamol::geocalls
@@ -11,7 +11,10 @@
 #include "mmcore/factories/CallAutoDescription.h"
 #include "mmcore/utility/log/Log.h"
 #include <algorithm>
+#include <array>
+#include <limits>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -31,6 +34,21 @@ public:
     virtual std::vector<unsigned char> GetAsUChar() = 0;
     virtual std::vector<std::string> GetAsString() = 0;
 
+    /**
+     * Gives access to the stored values without copying them.
+     *
+     * @return The values or nullptr if the container does not store values of type 'T'.
+     */
+    template<typename T>
+    std::vector<T>* GetVec();
+
+    /**
+     * Gives access to the bytes of the stored values without copying them,
+     * i.e. size() * getTypeSize() bytes.
+     *
+     * @return The values or nullptr for strings.
+     */
+    virtual const void* GetRawData() = 0;
 
     virtual const std::string getType() = 0;
     virtual const size_t getTypeSize() = 0;
@@ -86,6 +104,12 @@ private:
     std::vector<value_type> dataVec;
 };
 
+template<typename T>
+std::vector<T>* abstractContainer::GetVec() {
+    auto c = dynamic_cast<containerInterface<T>*>(this);
+    return (c != nullptr) ? &c->getVec() : nullptr;
+}
+
 class DoubleContainer : public abstractContainer, public containerInterface<double> {
     typedef double value_type;
 
@@ -115,6 +139,10 @@ public:
         return this->getAs<std::string>();
     }
 
+    const void* GetRawData() override {
+        return this->getVec().data();
+    }
+
     size_t size() override {
         return getSize();
     }
@@ -155,6 +183,10 @@ public:
         return this->getAs<std::string>();
     }
 
+    const void* GetRawData() override {
+        return this->getVec().data();
+    }
+
     size_t size() override {
         return getSize();
     }
@@ -195,6 +227,10 @@ public:
         return this->getAs<std::string>();
     }
 
+    const void* GetRawData() override {
+        return this->getVec().data();
+    }
+
     size_t size() override {
         return getSize();
     }
@@ -235,6 +271,10 @@ public:
         return this->getAs<std::string>();
     }
 
+    const void* GetRawData() override {
+        return this->getVec().data();
+    }
+
     size_t size() override {
         return getSize();
     }
@@ -275,6 +315,10 @@ public:
         return this->getAs<std::string>();
     }
 
+    const void* GetRawData() override {
+        return this->getVec().data();
+    }
+
     size_t size() override {
         return getSize();
     }
@@ -315,6 +359,10 @@ public:
         return this->getAs<std::string>();
     }
 
+    const void* GetRawData() override {
+        return this->getVec().data();
+    }
+
     size_t size() override {
         return getSize();
     }
@@ -355,6 +403,10 @@ public:
         return this->getAs<std::string>();
     }
 
+    const void* GetRawData() override {
+        return this->getVec().data();
+    }
+
     size_t size() override {
         return getSize();
     }
@@ -425,6 +477,10 @@ public:
         return this->getAs<std::string>();
     }
 
+    const void* GetRawData() override {
+        return nullptr;
+    }
+
     size_t size() override {
         return getSize();
     }
@@ -439,6 +495,60 @@ public:
 
 typedef std::map<std::string, std::shared_ptr<abstractContainer>> adiosDataMap;
 
+/**
+ * Restricts the elements read for some of the inquired variables, so that
+ * the data source can skip the blocks of the file which are not needed.
+ * Positions are counted in elements (e.g. particles) of the one-dimensional
+ * global arrays listed in 'vars'; interleaved arrays (e.g. "xyz") give
+ * the number of values per element. All other variables are read completely.
+ */
+struct adiosSelection {
+    /** The selected variables and their number of values per element */
+    std::map<std::string, size_t> vars;
+
+    /** The first selected element */
+    size_t start = 0;
+
+    /** The number of selected elements, everything up to the end if 0 */
+    size_t count = 0;
+
+    /** Only every 'stride'-th element is kept, counting from 'start' */
+    size_t stride = 1;
+
+    /** Flag whether blocks completely outside of 'box' are skipped */
+    bool useBox = false;
+
+    /** The box as min x, y, z, max x, y, z */
+    std::array<float, 6> box = {std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(),
+        std::numeric_limits<float>::lowest(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+        std::numeric_limits<float>::max()};
+
+    /**
+     * The variables holding the x, y, and z coordinates. The value range of
+     * each block of these is tested against the box. An interleaved variable
+     * can be named for all three axes.
+     */
+    std::array<std::string, 3> boxVars;
+
+    /**
+     * Answer whether the selection restricts anything.
+     *
+     * @return 'true' if not all elements are selected.
+     */
+    bool IsActive() const {
+        return !vars.empty() && ((start != 0) || (count != 0) || (stride > 1) || useBox);
+    }
+
+    bool operator==(const adiosSelection& rhs) const {
+        return (vars == rhs.vars) && (start == rhs.start) && (count == rhs.count) && (stride == rhs.stride) &&
+               (useBox == rhs.useBox) && (box == rhs.box) && (boxVars == rhs.boxVars);
+    }
+
+    bool operator!=(const adiosSelection& rhs) const {
+        return !(*this == rhs);
+    }
+};
+
 class CallADIOSData : public megamol::core::Call {
 public:
     /**
@@ -542,6 +652,19 @@ public:
     bool isInVars(std::string);
     bool isInAttributes(std::string);
 
+    /**
+     * Pushes a selection down to the data source. It is applied to the
+     * next GetData and kept until changed.
+     *
+     * @param sel The selection, an empty selection reads everything.
+     */
+    void setSelection(const adiosSelection& sel) {
+        this->selection = sel;
+    }
+    const adiosSelection& getSelection() const {
+        return this->selection;
+    }
+
 private:
     size_t dataHash;
     float time;
@@ -551,6 +674,7 @@ private:
     std::vector<std::string> availableVars;
     std::vector<std::string> inqAttributes;
     std::vector<std::string> availableAttributes;
+    adiosSelection selection;
 
     std::shared_ptr<adiosDataMap> dataptr;
 };
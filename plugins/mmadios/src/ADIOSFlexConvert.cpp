@@ -8,7 +8,10 @@
 #include "ADIOSFlexConvert.h"
 #include "geometry_calls/MultiParticleDataCall.h"
 #include "mmadios/CallADIOSData.h"
+#include "mmcore/param/BoolParam.h"
 #include "mmcore/param/FlexEnumParam.h"
+#include "mmcore/param/IntParam.h"
+#include "mmcore/param/Vector3fParam.h"
 #include "mmcore/utility/log/Log.h"
 #include "stdafx.h"
 #include <numeric>
@@ -26,7 +29,11 @@ ADIOSFlexConvert::ADIOSFlexConvert()
         , flexXSlot("x", "")
         , flexYSlot("y", "")
         , flexZSlot("z", "")
-        , flexAlignedPosSlot("xyzw", "") {
+        , flexAlignedPosSlot("xyzw", "")
+        , strideSlot("selection::stride", "Reads only every n-th particle.")
+        , useBoxSlot("selection::useBox", "Skips the blocks of the file which lie outside of the box.")
+        , boxMinSlot("selection::boxMin", "The minimum corner of the selection box.")
+        , boxMaxSlot("selection::boxMax", "The maximum corner of the selection box.") {
 
     this->mpSlot.SetCallback(geocalls::MultiParticleDataCall::ClassName(),
         geocalls::MultiParticleDataCall::FunctionName(0), &ADIOSFlexConvert::getDataCallback);
@@ -64,6 +71,22 @@ ADIOSFlexConvert::ADIOSFlexConvert()
     this->flexZSlot << new core::param::FlexEnumParam("undef");
     this->flexZSlot.SetUpdateCallback(&ADIOSFlexConvert::paramChanged);
     this->MakeSlotAvailable(&this->flexZSlot);
+
+    this->strideSlot << new core::param::IntParam(1, 1);
+    this->strideSlot.SetUpdateCallback(&ADIOSFlexConvert::paramChanged);
+    this->MakeSlotAvailable(&this->strideSlot);
+
+    this->useBoxSlot << new core::param::BoolParam(false);
+    this->useBoxSlot.SetUpdateCallback(&ADIOSFlexConvert::paramChanged);
+    this->MakeSlotAvailable(&this->useBoxSlot);
+
+    this->boxMinSlot << new core::param::Vector3fParam(vislib::math::Vector<float, 3>(0.0f, 0.0f, 0.0f));
+    this->boxMinSlot.SetUpdateCallback(&ADIOSFlexConvert::paramChanged);
+    this->MakeSlotAvailable(&this->boxMinSlot);
+
+    this->boxMaxSlot << new core::param::Vector3fParam(vislib::math::Vector<float, 3>(1.0f, 1.0f, 1.0f));
+    this->boxMaxSlot.SetUpdateCallback(&ADIOSFlexConvert::paramChanged);
+    this->MakeSlotAvailable(&this->boxMaxSlot);
 }
 
 ADIOSFlexConvert::~ADIOSFlexConvert() {
@@ -166,39 +189,80 @@ bool ADIOSFlexConvert::getDataCallback(core::Call& call) {
             return false;
         }
 
+        // let the source skip the particles which are not needed
+        adiosSelection sel;
+        sel.stride = this->strideSlot.Param<core::param::IntParam>()->Value();
+        sel.useBox = this->useBoxSlot.Param<core::param::BoolParam>()->Value();
+        auto const& boxMin = this->boxMinSlot.Param<core::param::Vector3fParam>()->Value();
+        auto const& boxMax = this->boxMaxSlot.Param<core::param::Vector3fParam>()->Value();
+        sel.box = {boxMin.X(), boxMin.Y(), boxMin.Z(), boxMax.X(), boxMax.Y(), boxMax.Z()};
+        if (x_str != "undef" || y_str != "undef" || z_str != "undef") {
+            sel.vars[x_str] = 1;
+            sel.vars[y_str] = 1;
+            sel.vars[z_str] = 1;
+            sel.boxVars = {x_str, y_str, z_str};
+        } else if (pos_str != "undef") {
+            sel.vars[pos_str] = 3;
+            sel.boxVars = {pos_str, pos_str, pos_str};
+        } else {
+            sel.vars[apos_str] = 4;
+            sel.boxVars = {apos_str, apos_str, apos_str};
+        }
+        if (col_str != "undef") {
+            sel.vars[col_str] = 1;
+        }
+        cad->setSelection(sel);
+
         if (!(*cad)(0)) {
             megamol::core::utility::log::Log::DefaultLog.WriteError("[ADIOSFlexConvert] Error during GetData");
             return false;
         }
 
-        std::vector<float> XYZ;
-        std::vector<float> XYZW;
-        std::vector<float> X;
-        std::vector<float> Y;
-        std::vector<float> Z;
+        // float data is used in place, everything else is converted
+        auto asFloat = [](std::shared_ptr<abstractContainer> c, std::vector<float>& converted) -> const float* {
+            if (auto vec = c->GetVec<float>()) {
+                return vec->data();
+            }
+            converted = c->GetAsFloat();
+            return converted.data();
+        };
+
+        std::vector<float> converted[4];
+        const float* XYZ = nullptr;
+        const float* XYZW = nullptr;
+        const float* X = nullptr;
+        const float* Y = nullptr;
+        const float* Z = nullptr;
         uint64_t p_count;
         stride = 0;
         if (pos_str != "undef") {
-            XYZ = cad->getData(pos_str)->GetAsFloat();
-            p_count = XYZ.size() / 3;
+            auto c = cad->getData(pos_str);
+            XYZ = asFloat(c, converted[0]);
+            p_count = c->size() / 3;
             stride += 3 * sizeof(float);
         } else if (x_str != "undef" || y_str != "undef" || z_str != "undef") {
-            X = cad->getData(x_str)->GetAsFloat();
-            Y = cad->getData(y_str)->GetAsFloat();
-            Z = cad->getData(z_str)->GetAsFloat();
-            p_count = X.size();
+            auto cx = cad->getData(x_str);
+            auto cy = cad->getData(y_str);
+            auto cz = cad->getData(z_str);
+            X = asFloat(cx, converted[0]);
+            Y = asFloat(cy, converted[1]);
+            Z = asFloat(cz, converted[2]);
+            p_count = std::min({cx->size(), cy->size(), cz->size()});
             stride += 3 * sizeof(float);
         } else if (apos_str != "undef") {
-            XYZW = cad->getData(apos_str)->GetAsFloat();
-            p_count = XYZW.size() / 4;
+            auto c = cad->getData(apos_str);
+            XYZW = asFloat(c, converted[0]);
+            p_count = c->size() / 4;
             stride += 3 * sizeof(float);
         } else {
             return false;
         }
 
-        std::vector<float> col;
+        const float* col = nullptr;
         if (col_str != "undef") {
-            col = cad->getData(col_str)->GetAsFloat();
+            auto c = cad->getData(col_str);
+            col = asFloat(c, converted[3]);
+            p_count = std::min<uint64_t>(p_count, c->size());
             stride += 1 * sizeof(float);
         }
 
@@ -88,6 +88,12 @@ private:
     core::param::ParamSlot flexZSlot;
     core::param::ParamSlot flexAlignedPosSlot;
 
+    /** Selection pushed down to the data source */
+    core::param::ParamSlot strideSlot;
+    core::param::ParamSlot useBoxSlot;
+    core::param::ParamSlot boxMinSlot;
+    core::param::ParamSlot boxMaxSlot;
+
 
     std::vector<float> mix;
 
@@ -1,6 +1,8 @@
 #include "adiosDataSource.h"
 #include "mmcore/cluster/mpi/MpiCall.h"
+#include "mmcore/param/BoolParam.h"
 #include "mmcore/param/FilePathParam.h"
+#include "mmcore/param/FloatParam.h"
 #include "mmcore/utility/log/Log.h"
 #include "mmcore/utility/sys/SystemInformation.h"
 #include "stdafx.h"
@@ -17,12 +19,22 @@ namespace adios {
 adiosDataSource::adiosDataSource()
         : callRequestMpi("requestMpi", "Requests initialization of MPI and the communicator for the view.")
         , getData("getdata", "Slot to request data from this data source.")
-        , filenameSlot("filename", "The path to the ADIOS-based file to load.") {
+        , filenameSlot("filename", "The path to the ADIOS-based file to load.")
+        , streamingSlot("streaming", "Reads the file step by step, following a file that is still being written.")
+        , streamTimeoutSlot("streaming::timeout", "Seconds to wait for the next step of a stream.") {
 
     this->filenameSlot.SetParameter(new core::param::FilePathParam("", core::param::FilePathParam::Flag_Directory));
     this->filenameSlot.SetUpdateCallback(&adiosDataSource::filenameChanged);
     this->MakeSlotAvailable(&this->filenameSlot);
 
+    this->streamingSlot << new core::param::BoolParam(false);
+    this->streamingSlot.SetUpdateCallback(&adiosDataSource::filenameChanged);
+    this->MakeSlotAvailable(&this->streamingSlot);
+
+    this->streamTimeoutSlot << new core::param::FloatParam(0.0f, 0.0f);
+    this->streamTimeoutSlot.SetUpdateCallback(&adiosDataSource::timeoutChanged);
+    this->MakeSlotAvailable(&this->streamTimeoutSlot);
+
 
     this->getData.SetCallback("CallADIOSData", "GetData", &adiosDataSource::getDataCallback);
     this->getData.SetCallback("CallADIOSData", "GetHeader", &adiosDataSource::getHeaderCallback);
@@ -94,6 +106,21 @@ bool adiosDataSource::create() {
 }
 
 
+/*
+ * adiosDataSource::SupportsBackgroundCalls
+ */
+bool adiosDataSource::SupportsBackgroundCalls(void) const {
+#ifdef WITH_MPI
+    if (this->MpiInitialized) {
+        int provided = MPI_THREAD_SINGLE;
+        ::MPI_Query_thread(&provided);
+        return provided == MPI_THREAD_MULTIPLE;
+    }
+#endif
+    return true;
+}
+
+
 /*
  * adiosDataSource::release
  */
@@ -108,7 +135,12 @@ bool adiosDataSource::getDataCallback(core::Call& caller) {
     CallADIOSData* cad = dynamic_cast<CallADIOSData*>(&caller);
     if (cad == nullptr)
         return false;
+    std::lock_guard<std::mutex> lock(this->dataLock);
+    this->applySettings();
 
+    if (cad->getSelection() != this->loadedSelection) {
+        this->inquireChanged = true;
+    }
     if (!this->dataMap.empty()) {
         auto inqV = cad->getVarsToInquire();
         for (auto var : inqV) {
@@ -124,27 +156,23 @@ bool adiosDataSource::getDataCallback(core::Call& caller) {
         }
     }
 
-    if (dataHashChanged || inquireChanged || loadedFrameID != cad->getFrameIDtoLoad()) {
+    // a stream changes frames in the header callback, which clears the data
+    const bool frameChanged = !this->streaming && (loadedFrameID != cad->getFrameIDtoLoad());
+    if (dataHashChanged || inquireChanged || frameChanged) {
 
         try {
-            auto fname = this->filenameSlot.Param<core::param::FilePathParam>()->Value().generic_u8string();
-#ifdef _WIN32
-            std::replace(fname.begin(), fname.end(), '/', '\\');
-#endif
             if (!this->reader) {
                 megamol::core::utility::log::Log::DefaultLog.WriteError(
                     "[adiosDataSource] Header callback not called yet.");
                 return false;
             }
-
-
-            //megamol::core::utility::log::Log::DefaultLog.WriteInfo("[adiosDataSource] Beginning step");
-            //const adios2::StepStatus status = reader->BeginStep();
-            //if (status != adios2::StepStatus::OK) {
-            //    megamol::core::utility::log::Log::DefaultLog.WriteError("[adiosDataSource] BeginStep returned an error.");
-            //    return false;
-            //}
-
+            if (this->streaming && !this->stepOpen) {
+                megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+                    "[adiosDataSource] No step of the stream available, keeping the previous data.");
+                cad->setData(std::make_shared<adiosDataMap>(dataMap));
+                cad->setDataHash(this->data_hash);
+                return true;
+            }
 
             auto toInquire = cad->getVarsToInquire();
             auto attrsToInquire = cad->getAttributesToInquire();
@@ -155,7 +183,12 @@ bool adiosDataSource::getDataCallback(core::Call& caller) {
                 return false;
             }
 
-            auto const frameIDtoLoad = cad->getFrameIDtoLoad();
+            auto const frameIDtoLoad =
+                this->streaming ? static_cast<size_t>(this->streamStep) : cad->getFrameIDtoLoad();
+            this->loadedSelection = cad->getSelection();
+            this->resolveSelection(this->loadedSelection, this->currentStep(frameIDtoLoad));
+            this->afterGets.clear();
+
             std::vector<adios2Params> content = variables;
             content.insert(content.end(), attributes.begin(), attributes.end());
 
@@ -199,12 +232,16 @@ bool adiosDataSource::getDataCallback(core::Call& caller) {
             megamol::core::utility::log::Log::DefaultLog.WriteInfo("[adiosDataSource] PerformGets");
             const auto t1 = std::chrono::high_resolution_clock::now();
             reader->PerformGets();
+            for (auto& f : this->afterGets) {
+                f();
+            }
+            this->afterGets.clear();
             const auto t2 = std::chrono::high_resolution_clock::now();
             const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
             megamol::core::utility::log::Log::DefaultLog.WriteInfo(
                 "[adiosDataSource] Time spent for reading frame: %d ms", duration);
 
-            loadedFrameID = cad->getFrameIDtoLoad();
+            loadedFrameID = frameIDtoLoad;
             // here data is loaded
         } catch (std::invalid_argument& e) {
 #ifdef WITH_MPI
@@ -248,20 +285,53 @@ bool adiosDataSource::getDataCallback(core::Call& caller) {
  * adiosDataSource::filenameChanged
  */
 bool adiosDataSource::filenameChanged(core::param::ParamSlot& slot) {
-    this->dataHashChanged = true;
-    this->frameCount = 1;
+    std::lock_guard<std::mutex> lock(this->settingsLock);
+    this->settingsFilename = this->filenameSlot.Param<core::param::FilePathParam>()->Value().generic_u8string();
+    this->settingsStreaming = this->streamingSlot.Param<core::param::BoolParam>()->Value();
+    this->reopenPending = true;
 
     return true;
 }
 
 
+/*
+ * adiosDataSource::timeoutChanged
+ */
+bool adiosDataSource::timeoutChanged(core::param::ParamSlot& slot) {
+    std::lock_guard<std::mutex> lock(this->settingsLock);
+    this->settingsStreamTimeout = this->streamTimeoutSlot.Param<core::param::FloatParam>()->Value();
+    return true;
+}
+
+
+/*
+ * adiosDataSource::applySettings
+ */
+void adiosDataSource::applySettings(void) {
+    std::lock_guard<std::mutex> lock(this->settingsLock);
+    if (this->reopenPending) {
+        this->dataHashChanged = true;
+        this->frameCount = 1;
+        this->reopenPending = false;
+    }
+    this->filename = this->settingsFilename;
+    this->streamingRequested = this->settingsStreaming;
+    this->streamTimeout = this->settingsStreamTimeout;
+}
+
+
+/*
+ * adiosDataSource::getHeaderCallback
+ */
 bool adiosDataSource::getHeaderCallback(core::Call& caller) {
     CallADIOSData* cad = dynamic_cast<CallADIOSData*>(&caller);
     if (cad == nullptr)
         return false;
+    std::lock_guard<std::mutex> lock(this->dataLock);
+    this->applySettings();
 
     if (dataHashChanged || loadedFrameID != cad->getFrameIDtoLoad()) {
-        if (loadedFrameID != cad->getFrameIDtoLoad())
+        if (!this->streaming && (loadedFrameID != cad->getFrameIDtoLoad()))
             this->dataMap.clear();
 
         try {
@@ -271,70 +341,89 @@ bool adiosDataSource::getHeaderCallback(core::Call& caller) {
             // io->SetEngine("BP3"); this is for v2.4.0
             // adiosInst->AtIO("Input").SetParameters({{"verbose", "4"}});
             io->SetParameter("verbose", "5");
-            auto fname = this->filenameSlot.Param<core::param::FilePathParam>()->Value().generic_u8string();
+            auto fname = this->filename;
 #ifdef _WIN32
             std::replace(fname.begin(), fname.end(), '/', '\\');
 #endif
 
             megamol::core::utility::log::Log::DefaultLog.WriteInfo("[adiosDataSource] Opening File %s", fname.c_str());
 
+            const bool reopen = !this->reader || dataHashChanged;
             if (this->reader && dataHashChanged) {
                 this->reader->Close();
                 io->RemoveAllVariables();
                 io->RemoveAllAttributes();
-                this->reader = std::make_shared<adios2::Engine>(io->Open(fname, adios2::Mode::Read));
-            } else if (!this->reader) {
+            }
+            if (reopen) {
+                this->streaming = this->streamingRequested;
+                this->stepOpen = false;
+                this->streamEnded = false;
+                this->streamStep = -1;
+                if (this->streaming) {
+                    io->SetParameter("OpenTimeoutSecs", std::to_string(this->streamTimeout));
+                }
                 this->reader = std::make_shared<adios2::Engine>(io->Open(fname, adios2::Mode::Read));
             }
 
+            if (this->streaming) {
+                const long long int prevStep = this->streamStep;
+                this->advanceStream(cad->getFrameIDtoLoad());
+                if (this->streamStep != prevStep) {
+                    this->dataMap.clear();
+                }
+            }
+
 
             // megamol::core::utility::log::Log::DefaultLog.WriteInfo("ADIOS2: Reading available attributes");
             // auto availAttrib =io->AvailableAttributes();
             // megamol::core::utility::log::Log::DefaultLog.WriteInfo("ADIOS2: Number of attributes %d", availAttrib.size());
 
-            auto tmp_variables = io->AvailableVariables();
-            megamol::core::utility::log::Log::DefaultLog.WriteInfo(
-                "[adiosDataSource] Number of variables %d", tmp_variables.size());
-            auto tmp_attributes = io->AvailableAttributes();
-            megamol::core::utility::log::Log::DefaultLog.WriteInfo(
-                "[adiosDataSource] Number of attributes %d", tmp_attributes.size());
-
-            availVars.clear();
-            availVars.reserve(tmp_variables.size());
-            variables.clear();
-            variables.reserve(tmp_variables.size());
-            availAttribs.clear();
-            availAttribs.reserve(tmp_attributes.size());
-            attributes.clear();
-            attributes.reserve(tmp_attributes.size());
-            timesteps.clear();
-            for (auto var : tmp_variables) {
-                adios2Params tmp_param;
-                tmp_param.name = var.first;
-                tmp_param.params = var.second;
-                variables.emplace_back(tmp_param);
-                availVars.emplace_back(var.first);
+            // the variables of a stream are only known inside of a step
+            if (!this->streaming || this->stepOpen) {
+                auto tmp_variables = io->AvailableVariables();
                 megamol::core::utility::log::Log::DefaultLog.WriteInfo(
-                    "[adiosDataSource]: Available Variable %s", var.first.c_str());
-                // get timesteps
-                timesteps.push_back(std::stoi(var.second["AvailableStepsCount"]));
-            }
-
-            for (auto atr : tmp_attributes) {
-                adios2Params tmp_param;
-                tmp_param.name = atr.first;
-                tmp_param.params = atr.second;
-                tmp_param.isAttribute = true;
-                attributes.emplace_back(tmp_param);
-                availAttribs.emplace_back(atr.first);
+                    "[adiosDataSource] Number of variables %d", tmp_variables.size());
+                auto tmp_attributes = io->AvailableAttributes();
                 megamol::core::utility::log::Log::DefaultLog.WriteInfo(
-                    "[adiosDataSource]: Available Attribute %s", atr.first.c_str());
-            }
+                    "[adiosDataSource] Number of attributes %d", tmp_attributes.size());
+
+                availVars.clear();
+                availVars.reserve(tmp_variables.size());
+                variables.clear();
+                variables.reserve(tmp_variables.size());
+                availAttribs.clear();
+                availAttribs.reserve(tmp_attributes.size());
+                attributes.clear();
+                attributes.reserve(tmp_attributes.size());
+                timesteps.clear();
+                for (auto var : tmp_variables) {
+                    adios2Params tmp_param;
+                    tmp_param.name = var.first;
+                    tmp_param.params = var.second;
+                    variables.emplace_back(tmp_param);
+                    availVars.emplace_back(var.first);
+                    megamol::core::utility::log::Log::DefaultLog.WriteInfo(
+                        "[adiosDataSource]: Available Variable %s", var.first.c_str());
+                    // get timesteps
+                    timesteps.push_back(std::stoi(var.second["AvailableStepsCount"]));
+                }
 
-            // Check of all variables have same timestep count
-            std::sort(timesteps.begin(), timesteps.end());
-            auto last = std::unique(timesteps.begin(), timesteps.end());
-            timesteps.erase(last, timesteps.end());
+                for (auto atr : tmp_attributes) {
+                    adios2Params tmp_param;
+                    tmp_param.name = atr.first;
+                    tmp_param.params = atr.second;
+                    tmp_param.isAttribute = true;
+                    attributes.emplace_back(tmp_param);
+                    availAttribs.emplace_back(atr.first);
+                    megamol::core::utility::log::Log::DefaultLog.WriteInfo(
+                        "[adiosDataSource]: Available Attribute %s", atr.first.c_str());
+                }
+
+                // Check of all variables have same timestep count
+                std::sort(timesteps.begin(), timesteps.end());
+                auto last = std::unique(timesteps.begin(), timesteps.end());
+                timesteps.erase(last, timesteps.end());
+            }
 
             this->data_hash++;
 
@@ -369,7 +458,10 @@ bool adiosDataSource::getHeaderCallback(core::Call& caller) {
 
     cad->setAvailableVars(availVars);
     cad->setAvailableAttributes(availAttribs);
-    if (timesteps.size() != 1) {
+    if (this->streaming) {
+        // announce the next step until the writer has closed the stream
+        cad->setFrameCount(static_cast<size_t>(this->streamStep + 1) + (this->streamEnded ? 0 : 1));
+    } else if (timesteps.size() != 1) {
         megamol::core::utility::log::Log::DefaultLog.WriteWarn(
             "[adiosDataSource] Detected variables with different count of time steps - Using lowest");
         cad->setFrameCount(*std::min_element(timesteps.begin(), timesteps.end()));
@@ -379,11 +471,134 @@ bool adiosDataSource::getHeaderCallback(core::Call& caller) {
 
     cad->setDataHash(this->data_hash);
     dataHashChanged = false;
-    loadedFrameID = cad->getFrameIDtoLoad();
+    // a stream which has not reached the requested frame yet is polled again
+    loadedFrameID = this->streaming ? this->streamStep : cad->getFrameIDtoLoad();
 
     return true;
 }
 
+/*
+ * adiosDataSource::resolveSelection
+ */
+void adiosDataSource::resolveSelection(const adiosSelection& sel, const size_t step) {
+    this->selectedRanges.clear();
+    this->selectionActive = sel.IsActive();
+    if (!this->selectionActive) {
+        return;
+    }
+
+    const size_t first = sel.start;
+    const size_t last = (sel.count == 0) ? std::numeric_limits<size_t>::max() : sel.start + sel.count;
+
+    std::vector<adiosBlock> blocks;
+    if (sel.useBox) {
+        for (int axis = 0; axis < 3; ++axis) {
+            auto const& name = sel.boxVars[axis];
+            auto const comp = sel.vars.find(name);
+            auto const var = std::find_if(variables.begin(), variables.end(),
+                [&name](const adios2Params& v) { return v.name == name; });
+            const size_t components = (comp != sel.vars.end()) ? comp->second : 1;
+            const float lo = sel.box[axis];
+            const float hi = sel.box[axis + 3];
+
+            std::vector<adiosBlock> axisBlocks;
+            bool valid = false;
+            if (var != variables.end()) {
+                auto params = var->params;
+                if (params["Type"] == "float") {
+                    valid = this->inquireBlocks<float>(name, components, step, lo, hi, axisBlocks);
+                } else if (params["Type"] == "double") {
+                    valid = this->inquireBlocks<double>(name, components, step, lo, hi, axisBlocks);
+                }
+            }
+            // all coordinates need the same decomposition into blocks
+            if (valid && (axis > 0)) {
+                valid = (axisBlocks.size() == blocks.size());
+                for (size_t b = 0; valid && (b < blocks.size()); ++b) {
+                    valid = (axisBlocks[b].start == blocks[b].start) && (axisBlocks[b].count == blocks[b].count);
+                    blocks[b].inBox = blocks[b].inBox && axisBlocks[b].inBox;
+                }
+            } else if (valid) {
+                blocks = std::move(axisBlocks);
+            }
+            if (!valid) {
+                megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+                    "[adiosDataSource] Cannot test the blocks of \"%s\" against the selection box, reading all blocks",
+                    name.c_str());
+                blocks.clear();
+                break;
+            }
+        }
+    }
+
+    if (blocks.empty()) {
+        adiosElementRange range;
+        range.start = first;
+        range.count = last - first;
+        this->selectedRanges.push_back(range);
+        return;
+    }
+
+    size_t skipped = 0;
+    for (auto const& block : blocks) {
+        if (!block.inBox) {
+            ++skipped;
+            continue;
+        }
+        const size_t s = std::max(block.start, first);
+        const size_t e = std::min(block.start + block.count, last);
+        if (s >= e) {
+            continue;
+        }
+        if (!this->selectedRanges.empty() &&
+            (this->selectedRanges.back().start + this->selectedRanges.back().count == s)) {
+            this->selectedRanges.back().count += e - s;
+        } else {
+            adiosElementRange range;
+            range.start = s;
+            range.count = e - s;
+            this->selectedRanges.push_back(range);
+        }
+    }
+    megamol::core::utility::log::Log::DefaultLog.WriteInfo(
+        "[adiosDataSource] Selection box skips %zu of %zu blocks", skipped, blocks.size());
+}
+
+
+/*
+ * adiosDataSource::advanceStream
+ */
+bool adiosDataSource::advanceStream(const size_t frameID) {
+    const float timeout = this->streamTimeout;
+    while (!this->streamEnded && (!this->stepOpen || (this->streamStep < static_cast<long long int>(frameID)))) {
+        if (this->stepOpen) {
+            this->reader->EndStep();
+            this->stepOpen = false;
+        }
+        const adios2::StepStatus status = this->reader->BeginStep(adios2::StepMode::Read, timeout);
+        if (status == adios2::StepStatus::OK) {
+            this->stepOpen = true;
+            ++this->streamStep;
+        } else if (status == adios2::StepStatus::NotReady) {
+            megamol::core::utility::log::Log::DefaultLog.WriteInfo(
+                "[adiosDataSource] Step %lld of the stream is not ready yet", this->streamStep + 1);
+            break;
+        } else {
+            if (status != adios2::StepStatus::EndOfStream) {
+                megamol::core::utility::log::Log::DefaultLog.WriteError(
+                    "[adiosDataSource] BeginStep returned an error.");
+            }
+            this->streamEnded = true;
+        }
+    }
+    if (this->stepOpen && (this->streamStep > static_cast<long long int>(frameID))) {
+        megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+            "[adiosDataSource] A stream cannot go back to frame %zu, showing step %lld", frameID, this->streamStep);
+    }
+    return this->stepOpen;
+}
+
+
 bool adiosDataSource::initMPI() {
 #ifdef WITH_MPI
     if (this->mpi_comm_ == MPI_COMM_NULL) {
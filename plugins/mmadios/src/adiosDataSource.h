@@ -9,6 +9,10 @@
 #include "vislib/String.h"
 #include "vislib/math/Cuboid.h"
 #include <adios2.h>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <string>
 #ifdef WITH_MPI
 #include <mpi.h>
 #endif
@@ -22,6 +26,19 @@ struct adios2Params {
     bool isAttribute = false;
 };
 
+/** A contiguous range of elements of the selected variables */
+struct adiosElementRange {
+    size_t start = 0;
+    size_t count = 0;
+};
+
+/** A block of a global array as written by one writer */
+struct adiosBlock {
+    size_t start = 0;
+    size_t count = 0;
+    bool inBox = true;
+};
+
 class adiosDataSource : public core::Module {
 public:
     /**
@@ -59,6 +76,15 @@ public:
 
     bool create(void);
 
+    /**
+     * The call functions only use copies of the parameters and are
+     * serialised, so they may run off the graph thread. Collective MPI reads
+     * additionally need MPI_THREAD_MULTIPLE.
+     *
+     * @return 'true' if the data may be requested in the background.
+     */
+    bool SupportsBackgroundCalls(void) const override;
+
 protected:
     void release(void);
 
@@ -93,10 +119,58 @@ private:
 
     vislib::StringA getCommandLine(void);
     bool filenameChanged(core::param::ParamSlot& slot);
+    bool timeoutChanged(core::param::ParamSlot& slot);
+
+    /** Takes over parameter changes, called with dataLock held */
+    void applySettings(void);
 
     template<typename T, typename C>
     void inquireRead(C container, const adios2Params var, const size_t frameIDtoLoad, const bool singleValue);
 
+    /**
+     * Schedules the reads of the selected element ranges of a variable.
+     *
+     * @param container The container receiving the values.
+     * @param advar The variable.
+     * @param components The number of values per element.
+     */
+    template<typename T, typename C>
+    void readSelection(C container, adios2::Variable<T>& advar, const size_t components);
+
+    /**
+     * Collects the blocks of a global array and tests their value range
+     * against [lo, hi].
+     *
+     * @return 'false' if the variable is no one-dimensional global array.
+     */
+    template<typename T>
+    bool inquireBlocks(const std::string& name, const size_t components, const size_t step, const float lo,
+        const float hi, std::vector<adiosBlock>& outBlocks);
+
+    /**
+     * Turns the selection into the element ranges to read. Blocks whose
+     * coordinates lie completely outside of the selection box are skipped.
+     *
+     * @param sel The selection requested by the caller.
+     * @param step The step to read.
+     */
+    void resolveSelection(const adiosSelection& sel, const size_t step);
+
+    /**
+     * Steps forward through a stream until the requested frame is reached
+     * or the writer has not finished the next step yet.
+     *
+     * @param frameID The requested frame.
+     *
+     * @return 'true' if a step is open for reading.
+     */
+    bool advanceStream(const size_t frameID);
+
+    /** Answer the step of the file to read for the requested frame */
+    size_t currentStep(const size_t frameIDtoLoad) const {
+        return this->streaming ? this->reader->CurrentStep() : frameIDtoLoad;
+    }
+
     /** The slot for requesting data */
     core::CalleeSlot getData;
 
@@ -111,6 +185,27 @@ private:
     /** The file name */
     core::param::ParamSlot filenameSlot;
 
+    /** Flag whether the file is read step by step while it is written */
+    core::param::ParamSlot streamingSlot;
+
+    /** The time to wait for the next step of a stream */
+    core::param::ParamSlot streamTimeoutSlot;
+
+    /** Copies of the parameters, written by the update callbacks */
+    std::mutex settingsLock;
+    std::string settingsFilename;
+    bool settingsStreaming = false;
+    float settingsStreamTimeout = 0.0f;
+    bool reopenPending = false;
+
+    /** The parameters in use by the call functions */
+    std::string filename;
+    bool streamingRequested = false;
+    float streamTimeout = 0.0f;
+
+    /** Serialises the call functions */
+    std::mutex dataLock;
+
     size_t frameCount = 0;
     long long int loadedFrameID = -1;
 
@@ -125,6 +220,20 @@ private:
     std::vector<std::size_t> timesteps;
     std::vector<std::string> availVars;
     std::vector<std::string> availAttribs;
+
+    /** The selection of the loaded data */
+    adiosSelection loadedSelection;
+    std::vector<adiosElementRange> selectedRanges;
+    bool selectionActive = false;
+
+    /** Post-processing which needs the values, run after PerformGets */
+    std::vector<std::function<void()>> afterGets;
+
+    /** State of the stream if the file is read step by step */
+    bool streaming = false;
+    bool stepOpen = false;
+    bool streamEnded = false;
+    long long int streamStep = -1;
 };
 
 template<typename T, typename C>
@@ -139,11 +248,25 @@ void adiosDataSource::inquireRead(
         tmp_vec = advar.Data();
     } else {
         auto advar = io->InquireVariable<T>(var.name);
-        advar.SetStepSelection({frameIDtoLoad, 1});
-        container->shape = advar.Shape(frameIDtoLoad);
+        if (this->streaming) {
+            container->shape = advar.Shape();
+        } else {
+            advar.SetStepSelection({frameIDtoLoad, 1});
+            container->shape = advar.Shape(frameIDtoLoad);
+        }
+        const bool globalArray = !container->shape.empty();
         if (container->shape.empty()) {
             container->shape = {advar.Count()};
         }
+        if constexpr (!std::is_same_v<T, std::string>) {
+            auto const sel = this->loadedSelection.vars.find(var.name);
+            if (this->selectionActive && !singleValue && globalArray && (container->shape.size() == 1) &&
+                (sel != this->loadedSelection.vars.end()) && (sel->second > 0)) {
+                this->readSelection<T>(container, advar, sel->second);
+                dataMap[var.name] = std::move(container);
+                return;
+            }
+        }
         if (!singleValue) {
             advar.SetSelection({advar.Start(), container->shape});
         }
@@ -154,5 +277,85 @@ void adiosDataSource::inquireRead(
     }
     dataMap[var.name] = std::move(container);
 }
+
+template<typename T, typename C>
+void adiosDataSource::readSelection(C container, adios2::Variable<T>& advar, const size_t components) {
+    std::vector<T>& tmp_vec = container->getVec();
+    const size_t elementCount = container->shape[0] / components;
+
+    // clamp the selected ranges to the elements of this variable
+    std::vector<adiosElementRange> ranges;
+    size_t total = 0;
+    for (auto const& r : this->selectedRanges) {
+        if (r.start >= elementCount) {
+            break;
+        }
+        adiosElementRange range;
+        range.start = r.start;
+        range.count = std::min(r.count, elementCount - r.start);
+        ranges.push_back(range);
+        total += range.count;
+    }
+
+    // one deferred read per range, directly into the container
+    tmp_vec.resize(total * components);
+    size_t offset = 0;
+    for (auto const& r : ranges) {
+        advar.SetSelection({{r.start * components}, {r.count * components}});
+        reader->Get<T>(advar, tmp_vec.data() + offset);
+        offset += r.count * components;
+    }
+    container->shape = {total * components};
+
+    const size_t stride = this->loadedSelection.stride;
+    if (stride > 1) {
+        const size_t first = this->loadedSelection.start;
+        this->afterGets.emplace_back([container, ranges, components, stride, first]() {
+            std::vector<T>& vec = container->getVec();
+            size_t src = 0;
+            size_t dst = 0;
+            for (auto const& r : ranges) {
+                for (size_t e = r.start; e < r.start + r.count; ++e, src += components) {
+                    if ((e - first) % stride == 0) {
+                        for (size_t c = 0; c < components; ++c) {
+                            vec[dst++] = vec[src + c];
+                        }
+                    }
+                }
+            }
+            vec.resize(dst);
+            container->shape = {dst};
+        });
+    }
+}
+
+template<typename T>
+bool adiosDataSource::inquireBlocks(const std::string& name, const size_t components, const size_t step,
+    const float lo, const float hi, std::vector<adiosBlock>& outBlocks) {
+    outBlocks.clear();
+    auto advar = io->InquireVariable<T>(name);
+    if (!advar || (advar.ShapeID() != adios2::ShapeID::GlobalArray)) {
+        return false;
+    }
+    auto const infos = reader->BlocksInfo(advar, step);
+    outBlocks.reserve(infos.size());
+    for (auto const& info : infos) {
+        if ((info.Start.size() != 1) || (info.Count.size() != 1)) {
+            outBlocks.clear();
+            return false;
+        }
+        adiosBlock block;
+        block.start = info.Start[0] / components;
+        block.count = info.Count[0] / components;
+        // equal min and max over several values usually means no statistics were written
+        const bool noStats = (info.Min == info.Max) && (info.Count[0] > 1);
+        block.inBox = noStats || ((static_cast<double>(info.Max) >= lo) && (static_cast<double>(info.Min) <= hi));
+        outBlocks.push_back(block);
+    }
+    std::sort(outBlocks.begin(), outBlocks.end(),
+        [](const adiosBlock& lhs, const adiosBlock& rhs) { return lhs.start < rhs.start; });
+    return !outBlocks.empty();
+}
+
 } /* end namespace adios */
 } /* end namespace megamol */
@@ -4,24 +4,128 @@
  */
 
 #include "Pkd.h"
+#include "mmcore/param/BoolParam.h"
+#include "mmcore/param/FilePathParam.h"
+#include "mmcore/utility/log/Log.h"
 #include "stdafx.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <numeric>
+#include <sstream>
 #include <stdint.h>
-#include <thread>
 
 #define POS(idx, dim) pos(idx, dim)
 
 using namespace megamol;
 
 
+namespace {
+
+/** Subtrees with at least this many nodes are partitioned by all threads */
+constexpr size_t parallelPartitionSize = 1 << 20;
+
+/** The number of nodes of one work item of a parallel partitioning */
+constexpr size_t partitionChunkSize = 1 << 16;
+
+/** The number of particles hashed as one work item for the cache key */
+constexpr size_t hashBlockSize = 1 << 20;
+
+/** The header of a PKD cache file, followed by 'count' vec4f */
+struct PkdCacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t count;
+};
+
+constexpr char pkdCacheMagic[4] = {'M', 'M', 'P', 'K'};
+constexpr uint32_t pkdCacheVersion = 1;
+
+/** A range of nodes on one level of a subtree */
+struct NodeRange {
+    size_t begin;
+    size_t end;
+};
+
+/** Maps a float to an unsigned key of the same order */
+inline uint32_t orderedKey(float f) {
+    uint32_t u;
+    ::memcpy(&u, &f, sizeof(u));
+    return ((u & 0x80000000u) != 0) ? ~u : (u | 0x80000000u);
+}
+
+/** Answers the number of nodes in the subtree of 'nodeID' */
+inline size_t subtreeSize(size_t nodeID, size_t numParticles) {
+    size_t cnt = 0;
+    for (size_t first = nodeID, width = 1; first < numParticles; first = ospray::leftChildOf(first), width *= 2) {
+        cnt += std::min(width, numParticles - first);
+    }
+    return cnt;
+}
+
+/** Collects the nodes of the subtree of 'nodeID', split into work items */
+std::vector<NodeRange> subtreeChunks(size_t nodeID, size_t numParticles) {
+    std::vector<NodeRange> chunks;
+    for (size_t first = nodeID, width = 1; first < numParticles; first = ospray::leftChildOf(first), width *= 2) {
+        const size_t end = std::min(first + width, numParticles);
+        for (size_t b = first; b < end; b += partitionChunkSize) {
+            chunks.push_back({b, std::min(b + partitionChunkSize, end)});
+        }
+    }
+    return chunks;
+}
+
+/** Collects all nodes fulfilling 'pred' in the order of 'chunks' */
+template<class Pred>
+std::vector<uint32_t> collectNodes(const std::vector<NodeRange>& chunks, Pred pred) {
+    const int64_t cnt = static_cast<int64_t>(chunks.size());
+    std::vector<size_t> offsets(chunks.size() + 1, 0);
+#pragma omp parallel for schedule(static)
+    for (int64_t c = 0; c < cnt; ++c) {
+        size_t n = 0;
+        for (size_t i = chunks[c].begin; i < chunks[c].end; ++i) {
+            n += pred(i) ? 1 : 0;
+        }
+        offsets[c + 1] = n;
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    std::vector<uint32_t> nodes(offsets.back());
+#pragma omp parallel for schedule(static)
+    for (int64_t c = 0; c < cnt; ++c) {
+        size_t o = offsets[c];
+        for (size_t i = chunks[c].begin; i < chunks[c].end; ++i) {
+            if (pred(i)) {
+                nodes[o++] = static_cast<uint32_t>(i);
+            }
+        }
+    }
+    return nodes;
+}
+
+} // namespace
+
+
 ospray::PkdBuilder::PkdBuilder()
         : megamol::datatools::AbstractParticleManipulator("outData", "inData")
+        , cacheEnableSlot("cache::enable", "Store the PKD ordering on disk and reuse it for data seen before")
+        , cacheDirectorySlot("cache::directory", "The directory of the PKD cache files")
         , inDataHash(std::numeric_limits<size_t>::max())
         , outDataHash(0)
+        , frameID(std::numeric_limits<unsigned int>::max())
 /*, numParticles(0)
 , numInnerNodes(0)*/
 {
     //model = std::make_shared<ParticleModel>();
+    this->cacheEnableSlot << new core::param::BoolParam(false);
+    this->MakeSlotAvailable(&this->cacheEnableSlot);
+
+    this->cacheDirectorySlot << new core::param::FilePathParam(
+        "", core::param::FilePathParam::Flag_Directory_ToBeCreated);
+    this->MakeSlotAvailable(&this->cacheDirectorySlot);
 }
 
 ospray::PkdBuilder::~PkdBuilder() {
@@ -52,10 +156,23 @@ bool ospray::PkdBuilder::manipulateData(
             // and build the pkd tree
             // this->model->fill(parts);
             models[i].fill(parts);
+            if (models[i].position.empty()) {
+                out.SetCount(0);
+                continue;
+            }
             // this->build();
-            Pkd pkd;
-            pkd.model = &models[i];
-            pkd.build();
+            const auto cache = this->cacheFile(models[i]);
+            if (cache.empty() || !loadCache(cache, models[i])) {
+                if (models[i].position.empty()) {
+                    models[i].fill(parts); // reading the cache file failed midway
+                }
+                Pkd pkd;
+                pkd.model = &models[i];
+                pkd.build();
+                if (!cache.empty()) {
+                    storeCache(cache, models[i]);
+                }
+            }
 
             out.SetCount(parts.GetCount());
             out.SetVertexData(
@@ -72,6 +189,96 @@ bool ospray::PkdBuilder::manipulateData(
 }
 
 
+std::filesystem::path ospray::PkdBuilder::cacheFile(const ParticleModel& model) const {
+    if (!this->cacheEnableSlot.Param<core::param::BoolParam>()->Value()) {
+        return std::filesystem::path();
+    }
+    const auto dir = this->cacheDirectorySlot.Param<core::param::FilePathParam>()->Value();
+    if (dir.empty()) {
+        return std::filesystem::path();
+    }
+
+    // FNV-1a over fixed blocks, combined in order, so the key does not depend on the thread count
+    const size_t cnt = model.position.size();
+    const int64_t blocks = static_cast<int64_t>((cnt + hashBlockSize - 1) / hashBlockSize);
+    std::vector<uint64_t> blockHashes(blocks);
+#pragma omp parallel for schedule(static)
+    for (int64_t b = 0; b < blocks; ++b) {
+        const size_t first = static_cast<size_t>(b) * hashBlockSize;
+        const size_t words = 4 * (std::min(first + hashBlockSize, cnt) - first);
+        const uint32_t* data = reinterpret_cast<const uint32_t*>(model.position.data() + first);
+        uint64_t h = 0xcbf29ce484222325ull;
+        for (size_t w = 0; w < words; ++w) {
+            h = (h ^ data[w]) * 0x100000001b3ull;
+        }
+        blockHashes[b] = h;
+    }
+    uint64_t key = (0xcbf29ce484222325ull ^ cnt) * 0x100000001b3ull;
+    for (auto h : blockHashes) {
+        key = (key ^ h) * 0x100000001b3ull;
+    }
+
+    std::stringstream name;
+    name << "pkd_" << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+    return dir / name.str();
+}
+
+
+bool ospray::PkdBuilder::loadCache(const std::filesystem::path& path, ParticleModel& model) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    PkdCacheHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        (::memcmp(header.magic, pkdCacheMagic, sizeof(pkdCacheMagic)) != 0) || (header.version != pkdCacheVersion) ||
+        (header.count != model.position.size())) {
+        return false;
+    }
+    if (!file.read(reinterpret_cast<char*>(model.position.data()),
+            static_cast<std::streamsize>(header.count * sizeof(rkcommon::math::vec4f)))) {
+        core::utility::log::Log::DefaultLog.WriteWarn(
+            "PkdBuilder: failed to read cache file \"%s\"", path.generic_u8string().c_str());
+        model.position.clear();
+        return false;
+    }
+    core::utility::log::Log::DefaultLog.WriteInfo(
+        "PkdBuilder: loaded %llu particles from cache file \"%s\"", static_cast<unsigned long long>(header.count),
+        path.generic_u8string().c_str());
+    return true;
+}
+
+
+void ospray::PkdBuilder::storeCache(const std::filesystem::path& path, const ParticleModel& model) {
+    std::error_code err;
+    std::filesystem::create_directories(path.parent_path(), err);
+
+    // write to a temporary file first, so concurrent readers never see partial files
+    auto tmpPath = path;
+    tmpPath += ".tmp";
+    bool ok;
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        PkdCacheHeader header;
+        ::memcpy(header.magic, pkdCacheMagic, sizeof(pkdCacheMagic));
+        header.version = pkdCacheVersion;
+        header.count = model.position.size();
+        ok = file.write(reinterpret_cast<const char*>(&header), sizeof(header)) &&
+             file.write(reinterpret_cast<const char*>(model.position.data()),
+                 static_cast<std::streamsize>(header.count * sizeof(rkcommon::math::vec4f)));
+    }
+    if (ok) {
+        std::filesystem::rename(tmpPath, path, err);
+        ok = !err;
+    }
+    if (!ok) {
+        std::filesystem::remove(tmpPath, err);
+        core::utility::log::Log::DefaultLog.WriteWarn(
+            "PkdBuilder: failed to write cache file \"%s\"", path.generic_u8string().c_str());
+    }
+}
+
+
 void ospray::Pkd::setDim(size_t ID, int dim) const {
 #if DIM_FROM_DEPTH
     return;
@@ -134,7 +341,125 @@ void ospray::Pkd::build() {
     const rkcommon::math::box3f& bounds = model->getBounds();
     /*std::cout << "#osp:pkd: bounds of model " << bounds << std::endl;
     std::cout << "#osp:pkd: number of input particles " << numParticles << std::endl;*/
-    this->buildRec(0, bounds, 0);
+
+    struct Subtree {
+        size_t nodeID;
+        rkcommon::math::box3f bounds;
+        size_t depth;
+    };
+
+    // partition the large subtrees level by level, each one using all threads
+    std::vector<Subtree> level(1, Subtree{0, bounds, 0});
+    std::vector<Subtree> small;
+    while (!level.empty()) {
+        std::vector<Subtree> next;
+        for (const auto& t : level) {
+            if (subtreeSize(t.nodeID, numParticles) < parallelPartitionSize) {
+                small.push_back(t);
+                continue;
+            }
+            const size_t dim = this->maxDim(t.bounds.size());
+            this->partitionParallel(t.nodeID, dim);
+            setDim(t.nodeID, dim);
+            Subtree l{leftChildOf(t.nodeID), t.bounds, t.depth + 1};
+            Subtree r{rightChildOf(t.nodeID), t.bounds, t.depth + 1};
+            l.bounds.upper[dim] = r.bounds.lower[dim] = pos(t.nodeID, dim);
+            next.push_back(l);
+            next.push_back(r);
+        }
+        level.swap(next);
+    }
+
+    // the remaining subtrees are independent of each other
+    const int64_t cnt = static_cast<int64_t>(small.size());
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int64_t i = 0; i < cnt; ++i) {
+        this->buildRec(small[i].nodeID, small[i].bounds, small[i].depth);
+    }
+}
+
+
+void ospray::Pkd::partitionParallel(const size_t nodeID, const size_t dim) const {
+    const auto lChunks = subtreeChunks(leftChildOf(nodeID), numParticles);
+    const auto rChunks = subtreeChunks(rightChildOf(nodeID), numParticles);
+    size_t rank = 0;
+    for (const auto& c : lChunks) {
+        rank += c.end - c.begin;
+    }
+
+    std::vector<NodeRange> all(lChunks);
+    all.insert(all.end(), rChunks.begin(), rChunks.end());
+    all.push_back({nodeID, nodeID + 1});
+    const int64_t cnt = static_cast<int64_t>(all.size());
+
+    // radix select the key with the size of the left subtree as rank, which becomes the root
+    uint32_t key = 0;
+    uint32_t mask = 0;
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        std::array<size_t, 256> hist;
+        hist.fill(0);
+#pragma omp parallel
+        {
+            std::array<size_t, 256> local;
+            local.fill(0);
+#pragma omp for schedule(static)
+            for (int64_t c = 0; c < cnt; ++c) {
+                for (size_t i = all[c].begin; i < all[c].end; ++i) {
+                    const uint32_t k = orderedKey(pos(i, dim));
+                    if ((k & mask) == key) {
+                        ++local[(k >> shift) & 0xFFu];
+                    }
+                }
+            }
+#pragma omp critical
+            for (size_t d = 0; d < local.size(); ++d) {
+                hist[d] += local[d];
+            }
+        }
+        uint32_t digit = 0;
+        while (rank >= hist[digit]) {
+            rank -= hist[digit];
+            ++digit;
+        }
+        key |= digit << shift;
+        mask |= 0xFFu << shift;
+    }
+
+    // move an element with that key to the root, the first one for a deterministic result
+    if (orderedKey(pos(nodeID, dim)) != key) {
+        std::vector<size_t> first(all.size(), numParticles);
+#pragma omp parallel for schedule(static)
+        for (int64_t c = 0; c < cnt; ++c) {
+            for (size_t i = all[c].begin; i < all[c].end; ++i) {
+                if (orderedKey(pos(i, dim)) == key) {
+                    first[c] = i;
+                    break;
+                }
+            }
+        }
+        swap(nodeID, *std::find_if(first.begin(), first.end(), [this](size_t i) { return i < numParticles; }));
+    }
+
+    // exchange the misplaced nodes pairwise. The counts may differ by nodes equal to the root, which balance them.
+    const auto lGreater = collectNodes(lChunks, [&](size_t i) { return orderedKey(pos(i, dim)) > key; });
+    const auto rLess = collectNodes(rChunks, [&](size_t i) { return orderedKey(pos(i, dim)) < key; });
+    const auto exchange = [this](const std::vector<uint32_t>& a, size_t aFirst, const std::vector<uint32_t>& b,
+                              size_t bFirst, size_t n) {
+        const int64_t num = static_cast<int64_t>(n);
+#pragma omp parallel for schedule(static)
+        for (int64_t i = 0; i < num; ++i) {
+            swap(a[aFirst + i], b[bFirst + i]);
+        }
+    };
+    const size_t paired = std::min(lGreater.size(), rLess.size());
+    exchange(lGreater, 0, rLess, 0, paired);
+    if (lGreater.size() > paired) {
+        const auto rEqual = collectNodes(rChunks, [&](size_t i) { return orderedKey(pos(i, dim)) == key; });
+        exchange(lGreater, paired, rEqual, 0, lGreater.size() - paired);
+    } else if (rLess.size() > paired) {
+        const auto lEqual = collectNodes(lChunks, [&](size_t i) { return orderedKey(pos(i, dim)) == key; });
+        exchange(lEqual, 0, rLess, paired, rLess.size() - paired);
+    }
 }
 
 
@@ -242,12 +567,6 @@ void ospray::Pkd::buildRec(const size_t nodeID, const rkcommon::math::box3f& bou
 
     lBounds.upper[dim] = rBounds.lower[dim] = pos(nodeID, dim);
 
-    if ((numLevels - depth) > 20) {
-        std::thread lThread(&pkdBuildThread, new PKDBuildJob(this, leftChildOf(nodeID), lBounds, depth + 1));
-        buildRec(rightChildOf(nodeID), rBounds, depth + 1);
-        lThread.join();
-    } else {
-        buildRec(leftChildOf(nodeID), lBounds, depth + 1);
-        buildRec(rightChildOf(nodeID), rBounds, depth + 1);
-    }
+    buildRec(leftChildOf(nodeID), lBounds, depth + 1);
+    buildRec(rightChildOf(nodeID), rBounds, depth + 1);
 }
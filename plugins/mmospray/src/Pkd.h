@@ -8,8 +8,11 @@
 #include "datatools/AbstractParticleManipulator.h"
 #include "geometry_calls/MultiParticleDataCall.h"
 #include "mmcore/CallerSlot.h"
+#include "mmcore/param/ParamSlot.h"
 #include "rkcommon/math/box.h"
 #include "rkcommon/math/vec.h"
+#include <cstdint>
+#include <filesystem>
 #include <map>
 
 
@@ -49,6 +52,43 @@ protected:
     virtual bool manipulateData(geocalls::MultiParticleDataCall& outData, geocalls::MultiParticleDataCall& inData);
 
 private:
+    /**
+     * Answers the cache file for the PKD ordering of a particle list. The
+     * key is computed from the contents of the filled model, so it
+     * identifies the data set and frame without knowing the source file.
+     *
+     * @param model The filled, not yet ordered model.
+     *
+     * @return The path of the cache file or an empty path if caching is off.
+     */
+    std::filesystem::path cacheFile(const ParticleModel& model) const;
+
+    /**
+     * Loads the PKD ordered particles from a cache file.
+     *
+     * @param path  The cache file.
+     * @param model The model to receive the particles. Must hold the
+     *              unordered particles. It is emptied if reading fails
+     *              after the header matched.
+     *
+     * @return 'true' if the cache file matched and was loaded.
+     */
+    static bool loadCache(const std::filesystem::path& path, ParticleModel& model);
+
+    /**
+     * Stores the PKD ordered particles in a cache file.
+     *
+     * @param path  The cache file.
+     * @param model The ordered model.
+     */
+    static void storeCache(const std::filesystem::path& path, const ParticleModel& model);
+
+    /** Flag whether the PKD ordering is cached on disk */
+    core::param::ParamSlot cacheEnableSlot;
+
+    /** The directory of the cache files */
+    core::param::ParamSlot cacheDirectorySlot;
+
     size_t inDataHash;
     size_t outDataHash;
     unsigned int frameID;
@@ -101,6 +141,9 @@ struct Pkd {
     void build();
 
     void buildRec(const size_t nodeID, const rkcommon::math::box3f& bounds, const size_t depth) const;
+
+    //! partition the subtree of a node having two children using all threads
+    void partitionParallel(const size_t nodeID, const size_t dim) const;
 };
 
 
@@ -133,23 +176,5 @@ struct SubtreeIterator {
     }
 };
 
-struct PKDBuildJob {
-    const Pkd* const pkd;
-    const size_t nodeID;
-    const rkcommon::math::box3f bounds;
-    const size_t depth;
-    __forceinline PKDBuildJob(const Pkd* pkd, size_t nodeID, rkcommon::math::box3f bounds, size_t depth)
-            : pkd(pkd)
-            , nodeID(nodeID)
-            , bounds(bounds)
-            , depth(depth){};
-};
-
-static void pkdBuildThread(void* arg) {
-    PKDBuildJob* job = (PKDBuildJob*)arg;
-    job->pkd->buildRec(job->nodeID, job->bounds, job->depth);
-    delete job;
-}
-
 } // namespace ospray
 } // namespace megamol
@@ -53,8 +53,19 @@ inline rkcommon::math::vec3f makeRandomColor(const int i) {
 //! return world bounding box of all particle *positions* (i.e., particles *ex* radius)
 rkcommon::math::box3f ospray::ParticleModel::getBounds() const {
     rkcommon::math::box3f bounds = rkcommon::math::empty;
-    for (size_t i = 0; i < position.size(); ++i)
-        bounds.extend({position[i].x, position[i].y, position[i].z});
+    const int64_t cnt = static_cast<int64_t>(position.size());
+#pragma omp parallel
+    {
+        rkcommon::math::box3f local = rkcommon::math::empty;
+#pragma omp for schedule(static)
+        for (int64_t i = 0; i < cnt; ++i)
+            local.extend({position[i].x, position[i].y, position[i].z});
+#pragma omp critical
+        if (!local.empty()) {
+            bounds.extend(local.lower);
+            bounds.extend(local.upper);
+        }
+    }
     return bounds;
 }
 
@@ -81,7 +92,12 @@ void megamol::ospray::ParticleModel::fill(geocalls::SimpleSphericalParticles par
     auto const& bAcc = parStore.GetCBAcc();
     auto const& aAcc = parStore.GetCAAcc();
 
-    for (size_t loop = 0; loop < parts.GetCount(); ++loop) {
+    const size_t offset = this->position.size();
+    const int64_t cnt = static_cast<int64_t>(parts.GetCount());
+    this->position.resize(offset + cnt);
+
+#pragma omp parallel for schedule(static)
+    for (int64_t loop = 0; loop < cnt; ++loop) {
 
         rkcommon::math::vec3f pos;
 
@@ -98,6 +114,6 @@ void megamol::ospray::ParticleModel::fill(geocalls::SimpleSphericalParticles par
 
         float const color = encodeColorToFloat(col);
 
-        this->position.emplace_back(pos, color);
+        this->position[offset + loop] = rkcommon::math::vec4f(pos, color);
     }
 }
@@ -0,0 +1,223 @@
+/*
+ * ASCIIFieldScanner.h
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "vislib/forceinline.h"
+
+
+namespace megamol {
+namespace moldyn {
+namespace io {
+namespace scanner {
+
+/*
+ * Allocation-free scanning of ASCII data lines for the text based particle
+ * file readers. All functions work on the memory range [p, end), which does
+ * not need to be zero-terminated, e.g. a MemmappedFile::ConstView.
+ */
+
+/**
+ * Answers the end of the line starting at 'p'.
+ *
+ * @return The '\n' terminating the line or 'end'.
+ */
+VISLIB_FORCEINLINE const char* lineEnd(const char* p, const char* end) {
+    const char* e = static_cast<const char*>(::memchr(p, '\n', static_cast<size_t>(end - p)));
+    return (e == nullptr) ? end : e;
+}
+
+/**
+ * Answers whether 'c' separates two fields.
+ */
+VISLIB_FORCEINLINE bool isBlank(char c) {
+    return (c == ' ') || (c == '\t') || (c == '\r');
+}
+
+/**
+ * Skips all field separators.
+ *
+ * @return The first character which is not a separator or 'end'.
+ */
+VISLIB_FORCEINLINE const char* skipBlanks(const char* p, const char* end) {
+    while ((p < end) && isBlank(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+/**
+ * Skips the current field and the following field separators.
+ *
+ * @return The start of the next field or 'end'.
+ */
+VISLIB_FORCEINLINE const char* skipField(const char* p, const char* end) {
+    while ((p < end) && !isBlank(*p)) {
+        ++p;
+    }
+    return skipBlanks(p, end);
+}
+
+/**
+ * Answers whether the line [p, end) is empty or contains blanks only.
+ */
+VISLIB_FORCEINLINE bool isBlankLine(const char* p, const char* end) {
+    return skipBlanks(p, end) == end;
+}
+
+/**
+ * Answers whether the field at 'p' starts with 'token'. 'token' must be
+ * lower case, the field is compared case-insensitive.
+ */
+inline bool startsWithInsensitive(const char* p, const char* end, const char* token) {
+    for (; *token != '\0'; ++p, ++token) {
+        if ((p >= end) || (::tolower(static_cast<unsigned char>(*p)) != *token)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Parses an integer field and skips the following field separators.
+ *
+ * @param p      The start of the field.
+ * @param end    The end of the range.
+ * @param outVal Receives the parsed value.
+ *
+ * @return The start of the next field or 'end'.
+ */
+inline const char* parseIntField(const char* p, const char* end, int& outVal) {
+    bool neg = false;
+    if ((p < end) && ((*p == '-') || (*p == '+'))) {
+        neg = (*p == '-');
+        ++p;
+    }
+    int v = 0;
+    while ((p < end) && (*p >= '0') && (*p <= '9')) {
+        v = v * 10 + (*p - '0');
+        ++p;
+    }
+    outVal = neg ? -v : v;
+    return skipField(p, end);
+}
+
+/**
+ * Parses an unsigned 64 bit integer field, e.g. a particle id, and skips
+ * the following field separators.
+ *
+ * @param p      The start of the field.
+ * @param end    The end of the range.
+ * @param outVal Receives the parsed value.
+ *
+ * @return The start of the next field or 'end'.
+ */
+inline const char* parseUInt64Field(const char* p, const char* end, uint64_t& outVal) {
+    if ((p < end) && (*p == '+')) {
+        ++p;
+    }
+    uint64_t v = 0;
+    while ((p < end) && (*p >= '0') && (*p <= '9')) {
+        v = v * 10 + static_cast<uint64_t>(*p - '0');
+        ++p;
+    }
+    outVal = v;
+    return skipField(p, end);
+}
+
+/**
+ * Parses a floating point field and skips the following field separators.
+ * The result is exact for up to 19 significant digits and exponents within
+ * [-22, 22], which covers all values written with printf-style formatting.
+ *
+ * @param p      The start of the field.
+ * @param end    The end of the range.
+ * @param outVal Receives the parsed value.
+ *
+ * @return The start of the next field or 'end'.
+ */
+inline const char* parseDoubleField(const char* p, const char* end, double& outVal) {
+    // exact powers of ten representable as double
+    static const double pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14,
+        1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    bool neg = false;
+    if ((p < end) && ((*p == '-') || (*p == '+'))) {
+        neg = (*p == '-');
+        ++p;
+    }
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    while ((p < end) && (*p >= '0') && (*p <= '9')) {
+        if (digits < 19) {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+            if (mantissa != 0) {
+                ++digits;
+            }
+        } else {
+            ++exponent; // precision exhausted, keep the magnitude
+        }
+        ++p;
+    }
+    if ((p < end) && (*p == '.')) {
+        ++p;
+        while ((p < end) && (*p >= '0') && (*p <= '9')) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+                if (mantissa != 0) {
+                    ++digits;
+                }
+                --exponent;
+            }
+            ++p;
+        }
+    }
+    if ((p < end) && ((*p == 'e') || (*p == 'E'))) {
+        int e;
+        p = parseIntField(p + 1, end, e);
+        exponent += e;
+    } else {
+        p = skipField(p, end);
+    }
+
+    double v = static_cast<double>(mantissa);
+    if (exponent < 0) {
+        v = (exponent >= -22) ? (v / pow10[-exponent]) : (v * std::pow(10.0, exponent));
+    } else if (exponent > 0) {
+        v = (exponent <= 22) ? (v * pow10[exponent]) : (v * std::pow(10.0, exponent));
+    }
+    outVal = neg ? -v : v;
+    return p;
+}
+
+/**
+ * Parses a floating point field and skips the following field separators.
+ *
+ * @param p      The start of the field.
+ * @param end    The end of the range.
+ * @param outVal Receives the parsed value.
+ *
+ * @return The start of the next field or 'end'.
+ */
+VISLIB_FORCEINLINE const char* parseFloatField(const char* p, const char* end, float& outVal) {
+    double v;
+    p = parseDoubleField(p, end, v);
+    outVal = static_cast<float>(v);
+    return p;
+}
+
+} /* end namespace scanner */
+} /* end namespace io */
+} /* end namespace moldyn */
+} /* end namespace megamol */
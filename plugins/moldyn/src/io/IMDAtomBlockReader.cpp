@@ -0,0 +1,324 @@
+/*
+ * IMDAtomBlockReader.cpp
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "io/IMDAtomBlockReader.h"
+#include "io/ASCIIFieldScanner.h"
+#include "stdafx.h"
+#include "vislib/math/mathfunctions.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace megamol::moldyn::io;
+using namespace megamol::moldyn::io::scanner;
+
+
+/* the (approximate) number of bytes per block */
+#define IMD_BLOCK_SIZE (4 * 1024 * 1024)
+/* the number of blocks processed between two progress reports */
+#define IMD_BLOCK_BATCH 64
+
+
+namespace {
+
+/**
+ * Answers whether the ASCII line [p, end) holds a record.
+ */
+VISLIB_FORCEINLINE bool isRecordLine(const char* p, const char* end) {
+    p = skipBlanks(p, end);
+    return (p != end) && (*p != '#');
+}
+
+/**
+ * Reverses the byte order of a value of 'size' bytes.
+ */
+VISLIB_FORCEINLINE void reverseBytes(unsigned char* ptr, unsigned int size) {
+    std::reverse(ptr, ptr + size);
+}
+
+} /* end anonymous namespace */
+
+
+/*
+ * IMDAtomBlockReader::IMDAtomBlockReader
+ */
+IMDAtomBlockReader::IMDAtomBlockReader(void)
+        : view()
+        , blocks()
+        , count(0)
+        , ascii(true)
+        , switchBytes(false)
+        , valSize(4)
+        , intColumnCnt(0)
+        , columnCnt(0)
+        , recordSize(0) {
+    // intentionally empty
+}
+
+
+/*
+ * IMDAtomBlockReader::~IMDAtomBlockReader
+ */
+IMDAtomBlockReader::~IMDAtomBlockReader(void) {
+    this->Close();
+}
+
+
+/*
+ * IMDAtomBlockReader::Close
+ */
+void IMDAtomBlockReader::Close(void) {
+    this->view.Release();
+    this->blocks.clear();
+    this->count = 0;
+}
+
+
+/*
+ * IMDAtomBlockReader::Decode
+ */
+void IMDAtomBlockReader::Decode(const std::vector<unsigned int>& columns, std::vector<std::vector<float>>& outColumns,
+    const ProgressCallback& progress) {
+    outColumns.resize(columns.size());
+    for (auto& c : outColumns) {
+        c.resize(this->count);
+    }
+    if ((this->count == 0) || columns.empty()) {
+        return;
+    }
+
+    // ASCII: output slot for each column up to the last requested one
+    std::vector<int> slots(*std::max_element(columns.begin(), columns.end()) + 1, -1);
+    for (SIZE_T i = 0; i < columns.size(); ++i) {
+        slots[columns[i]] = static_cast<int>(i);
+    }
+
+    this->forAllBlocks(
+        [this, &columns, &slots, &outColumns](SIZE_T b) {
+            const Block& block = this->blocks[b];
+            std::vector<float*> out(outColumns.size());
+            for (SIZE_T i = 0; i < outColumns.size(); ++i) {
+                out[i] = outColumns[i].data() + block.first;
+            }
+            if (this->ascii) {
+                this->decodeASCII(block, slots, out);
+            } else {
+                this->decodeBinary(block, columns, out);
+            }
+        },
+        progress);
+}
+
+
+/*
+ * IMDAtomBlockReader::FindRecords
+ */
+void IMDAtomBlockReader::FindRecords(const ProgressCallback& progress) {
+    this->blocks.clear();
+    this->count = 0;
+    if (this->view.IsEmpty()) {
+        return;
+    }
+
+    const char* data = this->view.Data();
+    const char* end = this->view.end();
+    const SIZE_T len = static_cast<SIZE_T>(this->view.Size());
+
+    if (!this->ascii) {
+        // fixed record size: blocks follow directly
+        this->count = len / this->recordSize;
+        const SIZE_T recsPerBlock = vislib::math::Max<SIZE_T>(1, IMD_BLOCK_SIZE / this->recordSize);
+        for (SIZE_T first = 0; first < this->count; first += recsPerBlock) {
+            Block block;
+            block.first = first;
+            block.count = vislib::math::Min(recsPerBlock, this->count - first);
+            block.begin = data + first * this->recordSize;
+            block.end = block.begin + block.count * this->recordSize;
+            this->blocks.push_back(block);
+        }
+        if (progress != nullptr) {
+            progress(1.0f);
+        }
+        return;
+    }
+
+    // split at line boundaries
+    for (const char* p = data; p < end;) {
+        Block block;
+        block.begin = p;
+        p = (static_cast<SIZE_T>(end - p) > IMD_BLOCK_SIZE) ? lineEnd(p + IMD_BLOCK_SIZE, end) : end;
+        if (p < end) {
+            ++p; // include the '\n'
+        }
+        block.end = p;
+        block.first = 0;
+        block.count = 0;
+        this->blocks.push_back(block);
+    }
+
+    // count the records of all blocks in parallel
+    this->forAllBlocks(
+        [this](SIZE_T b) {
+            Block& block = this->blocks[b];
+            for (const char* p = block.begin; p < block.end;) {
+                const char* e = lineEnd(p, block.end);
+                if (isRecordLine(p, e)) {
+                    ++block.count;
+                }
+                p = e + 1;
+            }
+        },
+        progress);
+
+    for (auto& block : this->blocks) {
+        block.first = this->count;
+        this->count += block.count;
+    }
+}
+
+
+/*
+ * IMDAtomBlockReader::Open
+ */
+bool IMDAtomBlockReader::Open(vislib::sys::MemmappedFile& file, vislib::sys::File::FileSize dataStart, char format,
+    unsigned int intColumnCnt, unsigned int columnCnt) {
+    this->Close();
+
+    UINT32 endianTestInt = 0x12345678;
+    UINT8 endianTestBytes[4];
+    ::memcpy(endianTestBytes, &endianTestInt, 4);
+    bool machineLittleEndian = (endianTestBytes[0] == 0x78);
+
+    switch (format) {
+    case 'A': // ASCII
+        this->ascii = true;
+        this->switchBytes = false;
+        this->valSize = 0;
+        break;
+    case 'B': // binary, big endian, double
+        this->ascii = false;
+        this->switchBytes = machineLittleEndian;
+        this->valSize = 8;
+        break;
+    case 'b': // binary, big endian, float
+        this->ascii = false;
+        this->switchBytes = machineLittleEndian;
+        this->valSize = 4;
+        break;
+    case 'L': // binary, little endian, double
+        this->ascii = false;
+        this->switchBytes = !machineLittleEndian;
+        this->valSize = 8;
+        break;
+    case 'l': // binary, little endian float
+        this->ascii = false;
+        this->switchBytes = !machineLittleEndian;
+        this->valSize = 4;
+        break;
+    default:
+        return false;
+    }
+    this->intColumnCnt = intColumnCnt;
+    this->columnCnt = columnCnt;
+    this->recordSize = 4 * intColumnCnt + this->valSize * (columnCnt - intColumnCnt);
+    if (!this->ascii && (this->recordSize == 0)) {
+        return false;
+    }
+
+    this->view = file.View(dataStart, file.GetSize() - dataStart, vislib::sys::MemmappedFile::HINT_SEQUENTIAL);
+    return true;
+}
+
+
+/*
+ * IMDAtomBlockReader::forAllBlocks
+ */
+void IMDAtomBlockReader::forAllBlocks(const std::function<void(SIZE_T)>& func, const ProgressCallback& progress) {
+    const INT64 blockCnt = static_cast<INT64>(this->blocks.size());
+    for (INT64 batch = 0; batch < blockCnt; batch += IMD_BLOCK_BATCH) {
+        const INT64 batchEnd = vislib::math::Min<INT64>(batch + IMD_BLOCK_BATCH, blockCnt);
+#pragma omp parallel for schedule(dynamic)
+        for (INT64 b = batch; b < batchEnd; ++b) {
+            func(static_cast<SIZE_T>(b));
+        }
+        if (progress != nullptr) {
+            progress(static_cast<float>(batchEnd) / static_cast<float>(blockCnt));
+        }
+    }
+}
+
+
+/*
+ * IMDAtomBlockReader::decodeASCII
+ */
+void IMDAtomBlockReader::decodeASCII(
+    const Block& block, const std::vector<int>& slots, std::vector<float*>& out) const {
+    const int lastColumn = static_cast<int>(slots.size());
+    for (const char* p = block.begin; p < block.end;) {
+        const char* e = lineEnd(p, block.end);
+        if (isRecordLine(p, e)) {
+            const char* f = skipBlanks(p, e);
+            for (int c = 0; c < lastColumn; ++c) {
+                if (slots[c] >= 0) {
+                    f = parseFloatField(f, e, *out[slots[c]]);
+                } else {
+                    f = skipField(f, e);
+                }
+            }
+            for (auto& o : out) {
+                ++o;
+            }
+        }
+        p = e + 1;
+    }
+}
+
+
+/*
+ * IMDAtomBlockReader::decodeBinary
+ */
+void IMDAtomBlockReader::decodeBinary(
+    const Block& block, const std::vector<unsigned int>& columns, std::vector<float*>& out) const {
+    // byte offsets of the requested columns inside a record
+    std::vector<SIZE_T> offsets(columns.size());
+    for (SIZE_T i = 0; i < columns.size(); ++i) {
+        offsets[i] = (columns[i] < this->intColumnCnt)
+                         ? 4 * columns[i]
+                         : 4 * this->intColumnCnt + this->valSize * (columns[i] - this->intColumnCnt);
+    }
+
+    const unsigned char* rec = reinterpret_cast<const unsigned char*>(block.begin);
+    for (SIZE_T r = 0; r < block.count; ++r, rec += this->recordSize) {
+        for (SIZE_T i = 0; i < columns.size(); ++i) {
+            unsigned char val[8];
+            if (columns[i] < this->intColumnCnt) {
+                UINT32 v;
+                ::memcpy(val, rec + offsets[i], 4);
+                if (this->switchBytes) {
+                    reverseBytes(val, 4);
+                }
+                ::memcpy(&v, val, 4);
+                out[i][r] = static_cast<float>(v);
+            } else if (this->valSize == 8) {
+                double v;
+                ::memcpy(val, rec + offsets[i], 8);
+                if (this->switchBytes) {
+                    reverseBytes(val, 8);
+                }
+                ::memcpy(&v, val, 8);
+                out[i][r] = static_cast<float>(v);
+            } else {
+                ::memcpy(val, rec + offsets[i], 4);
+                if (this->switchBytes) {
+                    reverseBytes(val, 4);
+                }
+                ::memcpy(&out[i][r], val, 4);
+            }
+        }
+    }
+}
@@ -0,0 +1,151 @@
+/*
+ * IMDAtomBlockReader.h
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "mmcore/utility/sys/MemmappedFile.h"
+#include "vislib/types.h"
+
+
+namespace megamol {
+namespace moldyn {
+namespace io {
+
+
+/**
+ * Parallel reader for the data section of IMD atom files.
+ *
+ * The data section is memory-mapped and split into blocks of whole records.
+ * For binary files the blocks follow from the fixed record size; for ASCII
+ * files the record (line) boundaries are searched in parallel. Afterwards,
+ * selected columns are decoded by all threads directly into preallocated
+ * column buffers.
+ */
+class IMDAtomBlockReader {
+public:
+    /**
+     * Callback receiving the progress of the current operation in [0, 1].
+     * It is called from the calling thread between batches of blocks.
+     */
+    typedef std::function<void(float)> ProgressCallback;
+
+    /** Ctor. */
+    IMDAtomBlockReader(void);
+
+    /** Dtor. */
+    ~IMDAtomBlockReader(void);
+
+    /** Unmaps the data section and clears the record index. */
+    void Close(void);
+
+    /**
+     * Answer the number of records found by 'FindRecords'.
+     *
+     * @return The number of records.
+     */
+    inline SIZE_T Count(void) const {
+        return this->count;
+    }
+
+    /**
+     * Decodes the requested columns of all records. Integer columns (atom
+     * ids and types) are converted to float.
+     *
+     * @param columns The indices of the columns to decode. Must not contain
+     *                duplicates.
+     * @param outColumns Receives one buffer with 'Count()' values for each
+     *                   requested column, in the order of 'columns'.
+     * @param progress Optional progress hook.
+     */
+    void Decode(const std::vector<unsigned int>& columns, std::vector<std::vector<float>>& outColumns,
+        const ProgressCallback& progress = nullptr);
+
+    /**
+     * Splits the data section into blocks of complete records and counts
+     * the records in each block.
+     *
+     * @param progress Optional progress hook.
+     */
+    void FindRecords(const ProgressCallback& progress = nullptr);
+
+    /**
+     * Maps the data section of an IMD file.
+     *
+     * @param file The opened IMD file.
+     * @param dataStart The offset of the first record, i.e. the position
+     *                  right behind the '#E' header line.
+     * @param format The format character of the header ('A', 'B', 'b',
+     *               'L', or 'l').
+     * @param intColumnCnt The number of leading integer columns (id, type).
+     * @param columnCnt The total number of columns per record.
+     *
+     * @return 'true' on success, 'false' if the format is not supported.
+     *
+     * @throws IOException if mapping the file fails.
+     */
+    bool Open(vislib::sys::MemmappedFile& file, vislib::sys::File::FileSize dataStart, char format,
+        unsigned int intColumnCnt, unsigned int columnCnt);
+
+private:
+    /** A block of complete records in the mapped data section */
+    typedef struct _block_t {
+        const char* begin; //< first byte of the block
+        const char* end;   //< first byte behind the block
+        SIZE_T first;      //< index of the first record in the block
+        SIZE_T count;      //< number of records in the block
+    } Block;
+
+    /**
+     * Runs 'func' for all blocks in parallel. The blocks are processed in
+     * batches to report the progress from the calling thread.
+     *
+     * @param func The function to be called for each block index.
+     * @param progress Optional progress hook.
+     */
+    void forAllBlocks(const std::function<void(SIZE_T)>& func, const ProgressCallback& progress);
+
+    /** Decodes the columns of one ASCII block */
+    void decodeASCII(const Block& block, const std::vector<int>& slots, std::vector<float*>& out) const;
+
+    /** Decodes the columns of one binary block */
+    void decodeBinary(const Block& block, const std::vector<unsigned int>& columns, std::vector<float*>& out) const;
+
+    /** The mapped data section */
+    vislib::sys::MemmappedFile::ConstView view;
+
+    /** The blocks of records */
+    std::vector<Block> blocks;
+
+    /** The total number of records */
+    SIZE_T count;
+
+    /** Flag whether the data is stored as text */
+    bool ascii;
+
+    /** Flag whether the bytes of binary values need to be switched */
+    bool switchBytes;
+
+    /** The size of binary floating point values (4 or 8) */
+    unsigned int valSize;
+
+    /** The number of leading integer columns */
+    unsigned int intColumnCnt;
+
+    /** The total number of columns */
+    unsigned int columnCnt;
+
+    /** The size of binary records in bytes */
+    SIZE_T recordSize;
+};
+
+} /* end namespace io */
+} /* end namespace moldyn */
+} /* end namespace megamol */
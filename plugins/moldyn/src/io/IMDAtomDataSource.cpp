@@ -16,702 +16,23 @@
 #include "mmcore/param/Vector3fParam.h"
 #include "mmcore/utility/ColourParser.h"
 #include "mmcore/utility/log/Log.h"
+#include "mmcore/utility/sys/ConsoleProgressBar.h"
 #include "mmcore/view/Input.h"
 #include "stdafx.h"
 #include "vislib/Array.h"
 #include "vislib/PtrArray.h"
 #include "vislib/String.h"
 #include "vislib/StringTokeniser.h"
-#include "vislib/forceinline.h"
 #include "vislib/math/ShallowVector.h"
 #include "vislib/math/Vector.h"
 #include "vislib/math/mathfunctions.h"
-#include "vislib/sys/FastFile.h"
+#include "vislib/sys/IOException.h"
 #include "vislib/sys/SystemMessage.h"
 #include "vislib/sys/sysfunctions.h"
 #include <climits>
+#include <vector>
 
 
-namespace {
-
-/**
- * Abstract base class for IMDAtom readers.
- *
- * Note: that no method is virtual. This allows for inline functions for
- * faster data reading.
- */
-class AbstractAtomReader {
-public:
-    // No public methods are defined here (see note in class description)
-
-protected:
-    /**
-     * Ctor
-     *
-     * @param file The file to read from
-     */
-    AbstractAtomReader(vislib::sys::File& file) : file(file), buf(NULL), validBufSize(0), pos(0) {
-        this->buf = new unsigned char[BUFSIZE];
-    }
-
-    /**
-     * Dtor
-     */
-    ~AbstractAtomReader(void) {
-        // Do not close, delete, etc. the file
-        ARY_SAFE_DELETE(this->buf);
-    }
-
-    /**
-     * Copies a number of bytes from the input buffer to 'dst'.
-     *
-     * @param dst Pointer to the memory to receive the data
-     * @param size The number of bytes to read
-     *
-     * @return 'true' on success
-     */
-    VISLIB_FORCEINLINE bool copyData(void* dst, unsigned int size) {
-        if (this->validBufSize - this->pos >= size) {
-            ::memcpy(dst, this->buf + this->pos, size);
-            this->pos += size;
-            return true;
-        } else {
-            return this->loadData(static_cast<unsigned char*>(dst), size);
-        }
-    }
-
-    /**
-     * Skips 'size' bytes from the input buffer
-     *
-     * @param size The number of bytes to skip
-     *
-     * @return 'true' on success
-     */
-    VISLIB_FORCEINLINE bool skipData(unsigned int size) {
-        if (this->validBufSize - this->pos >= size) {
-            this->pos += size;
-            return true;
-        } else {
-            return this->skipDataEx(size);
-        }
-    }
-
-    /**
-     * Switches four bytes (endianess)
-     *
-     * @param ptr The pointer to the memory
-     */
-    VISLIB_FORCEINLINE void switch4Bytes(void* ptr) {
-        char* cp = static_cast<char*>(ptr);
-        char c = cp[0];
-        cp[0] = cp[3];
-        cp[3] = c;
-        c = cp[1];
-        cp[1] = cp[2];
-        cp[2] = c;
-    }
-
-    /**
-     * Switches eight bytes (endianess)
-     *
-     * @param ptr The pointer to the memory
-     */
-    VISLIB_FORCEINLINE void switch8Bytes(void* ptr) {
-        char* cp = static_cast<char*>(ptr);
-        char c = cp[0];
-        cp[0] = cp[7];
-        cp[7] = c;
-        c = cp[1];
-        cp[1] = cp[6];
-        cp[6] = c;
-        c = cp[2];
-        cp[2] = cp[5];
-        cp[5] = c;
-        c = cp[3];
-        cp[3] = cp[4];
-        cp[4] = c;
-    }
-
-    /**
-     * sifts the next ascii block
-     *
-     * @param fail The fail flag is not changed if the method succeeds.
-     *             If the method fails the flag is set to 'true'.
-     *
-     * @return The next ascii block
-     */
-    const char* sift(bool& fail) {
-        static vislib::StringA ebuf;
-        char* cbuf = reinterpret_cast<char*>(this->buf);
-
-        // do we need new data?
-        if (this->pos == this->validBufSize) {
-            try {
-                this->validBufSize = static_cast<unsigned int>(this->file.Read(this->buf, BUFSIZE));
-            } catch (...) {
-                this->pos = this->validBufSize = 0;
-                fail = true;
-                return NULL;
-            }
-            this->pos = 0;
-            if (this->validBufSize == 0) { // eof
-                fail = true;
-                return NULL;
-            }
-        }
-
-        // skip white-spaces
-        if (cbuf[this->pos] == 0) {
-            cbuf[this->pos] = ' '; // because this 0 was proably from a
-                                   // previous sift
-        }
-        while (vislib::CharTraitsA::IsSpace(cbuf[this->pos])) {
-            this->pos++;
-            if (this->pos == this->validBufSize) {
-                try {
-                    this->validBufSize = static_cast<unsigned int>(this->file.Read(this->buf, BUFSIZE));
-                } catch (...) {
-                    this->pos = this->validBufSize = 0;
-                    fail = true;
-                    return NULL;
-                }
-                this->pos = 0;
-                if (this->validBufSize == 0) { // eof
-                    fail = true;
-                    return NULL;
-                }
-            }
-        }
-
-        // collect token
-        unsigned int start = this->pos; // start of the new token
-        while (!vislib::CharTraitsA::IsSpace(cbuf[this->pos])) {
-            this->pos++;
-            if (this->pos == this->validBufSize) {
-                // running out of buffer, so we need to copy!
-                ebuf = vislib::StringA(cbuf + start, this->pos - start);
-
-                while (!this->file.IsEOF()) {
-                    try {
-                        this->validBufSize = static_cast<unsigned int>(this->file.Read(this->buf, BUFSIZE));
-                    } catch (...) {
-                        this->pos = this->validBufSize = 0;
-                        break;
-                    }
-                    this->pos = 0;
-                    if (this->validBufSize == 0) { // eof
-                        break;
-                    }
-
-                    while (!vislib::CharTraitsA::IsSpace(cbuf[this->pos]) && (this->pos < this->validBufSize)) {
-                        this->pos++;
-                    }
-
-                    ebuf += vislib::StringA(cbuf, this->pos);
-                    if (this->pos < this->validBufSize) {
-                        // we did not run out of buffer -> os it's the end of the token
-                        break;
-                    }
-                }
-
-                return ebuf.PeekBuffer();
-            }
-        }
-
-        // token complete in buffer (and there are remaining whitspaces)
-        ASSERT(vislib::CharTraitsA::IsSpace(cbuf[this->pos]));
-        this->buf[this->pos] = 0;
-        return cbuf + start;
-    }
-
-private:
-    /** The size of the input buffer */
-    static const unsigned int BUFSIZE = 4 * 1024;
-
-    /**
-     * Copies a number of bytes from the input buffer to 'dst'.
-     *
-     * @param dst Pointer to the memory to receive the data
-     * @param size The number of bytes to read
-     *
-     * @return 'true' on success
-     */
-    bool loadData(unsigned char* dst, unsigned int size) {
-        unsigned int rem = this->validBufSize - this->pos;
-        ASSERT(size >= rem);
-
-        ::memcpy(dst, this->buf + this->pos, rem);
-        dst += rem;
-        size -= rem;
-
-        if (size > BUFSIZE) { // direct feed
-            this->validBufSize = 0;
-            this->pos = 0;
-            try {
-                return (this->file.Read(dst, size) == size);
-            } catch (...) { return false; }
-        }
-
-        try {
-            this->validBufSize = static_cast<unsigned int>(this->file.Read(this->buf, BUFSIZE));
-
-        } catch (...) {
-            this->pos = this->validBufSize = 0;
-            return false;
-        }
-
-        if (size > this->validBufSize) { // eof
-            this->pos = this->validBufSize;
-            return false;
-        }
-
-        ::memcpy(dst, this->buf, size);
-        this->pos = size;
-        return true;
-    }
-
-    /**
-     * Skips 'size' bytes from the input buffer
-     *
-     * @param size The number of bytes to skip
-     *
-     * @return 'true' on success
-     */
-    bool skipDataEx(unsigned int size) {
-        unsigned int rem = this->validBufSize - this->pos;
-        ASSERT(size >= rem);
-        size -= rem;
-        this->pos = this->validBufSize;
-
-        if (size > BUFSIZE) { // direct seek
-            try {
-                this->file.Seek(size, vislib::sys::File::CURRENT);
-                return true;
-            } catch (...) { return false; }
-        }
-
-        try { // read into buffer
-            this->validBufSize = static_cast<unsigned int>(this->file.Read(this->buf, BUFSIZE));
-        } catch (...) {
-            this->pos = this->validBufSize = 0;
-            return false;
-        }
-
-        if (size > this->validBufSize) { // eof
-            this->pos = this->validBufSize;
-            return false;
-        }
-
-        this->pos = size;
-        return true;
-    }
-
-    /** The file to read from */
-    vislib::sys::File& file;
-
-    /** The input buffer */
-    unsigned char* buf;
-
-    /** The number of bytes of the input buffer that are valid */
-    unsigned int validBufSize;
-
-    /** The reading position in the input buffer */
-    unsigned int pos;
-};
-
-
-/**
- * IMD Atom file reader class for the ASCII file format
- */
-class AtomReaderASCII : public AbstractAtomReader {
-public:
-    /**
-     * Ctor
-     *
-     * @param file The file to read from
-     */
-    AtomReaderASCII(vislib::sys::File& file) : AbstractAtomReader(file) {
-        // Intentionally empty
-    }
-
-    /**
-     * Dtor
-     */
-    ~AtomReaderASCII(void) {
-        // Intentionally empty
-    }
-
-    /**
-     * Reads an integer from the input data
-     *
-     * @param fail The fail flag is not changed if the method succeeds.
-     *             If the method fails the flag is set to 'true'.
-     *
-     * @return The read integer
-     */
-    VISLIB_FORCEINLINE UINT32 ReadInt(bool& fail) {
-        const char* c = this->sift(fail);
-        try {
-            return static_cast<UINT32>(vislib::CharTraitsA::ParseInt(c));
-        } catch (...) { fail = true; }
-        return 0;
-    }
-
-    /**
-     * Reads a float from the input data
-     *
-     * @param fail The fail flag is not changed if the method succeeds.
-     *             If the method fails the flag is set to 'true'.
-     *
-     * @return The read float
-     */
-    VISLIB_FORCEINLINE float ReadFloat(bool& fail) {
-        const char* c = this->sift(fail);
-        try {
-            return static_cast<float>(vislib::CharTraitsA::ParseDouble(c));
-        } catch (...) { fail = true; }
-        return 0.0f;
-    }
-
-    /**
-     * Skips an integer in the input data
-     *
-     * @param fail The fail flag is not changed if the method succeeds.
-     *             If the method fails the flag is set to 'true'.
-     */
-    VISLIB_FORCEINLINE void SkipInt(bool& fail) { /*const char *c =*/
-        this->sift(fail);
-    }
-
-    /**
-     * Skips an float in the input data
-     *
-     * @param fail The fail flag is not changed if the method succeeds.
-     *             If the method fails the flag is set to 'true'.
-     */
-    VISLIB_FORCEINLINE void SkipFloat(bool& fail) { /*const char *c =*/
-        this->sift(fail);
-    }
-};
-
-
-/**
- * IMD Atom file reader class for the float file format
- */
-class AtomReaderFloat : public AbstractAtomReader {
-public:
-    /**
-     * Ctor
-     *
-     * @param file The file to read from
-     */
-    AtomReaderFloat(vislib::sys::File& file) : AbstractAtomReader(file) {
-        // Intentionally empty
-    }
-
-    /**
-     * Dtor
-     */
-    ~AtomReaderFloat(void) {
-        // Intentionally empty
-    }
-
-    /**
-     * Reads an integer from the input data
-     *
-     * @param fail The fail flag is not changed if the method succeeds.
-     *             If the method fails the flag is set to 'true'.
-     *
-     * @return The read integer
-     */
-    VISLIB_FORCEINLINE UINT32 ReadInt(bool& fail) {
-        UINT32 i;
-        if (!this->copyData(&i, 4)) {
-            fail = true;
-        }
-        return i;
-    }
-
-    /**
-     * Reads a float from the input data
-     *
-     * @param fail The fail flag is not changed if the method succeeds.
-     *             If the method fails the flag is set to 'true'.
-     *
-     * @return The read float
-     */
-    VISLIB_FORCEINLINE float ReadFloat(bool& fail) {
-        float f;
-        if (!this->copyData(&f, 4)) {
-            fail = true;
-        }
-        return f;
-    }
-
-    /**
-     * Skips an integer in the input data
-     *
-     * @param fail The fail flag is not changed if the method succeeds.
-     *             If the method fails the flag is set to 'true'.
-     */
-    VISLIB_FORCEINLINE void SkipInt(bool& fail) {
-        if (!this->skipData(4))
-            fail = true;
-    }
-
-    /**
-     * Skips an float in the input data
-     *
-     * @param fail The fail flag is not changed if the method succeeds.
-     *             If the method fails the flag is set to 'true'.
-     */
-    VISLIB_FORCEINLINE void SkipFloat(bool& fail) {
-        if (!this->skipData(4))
-            fail = true;
-    }
-};
-
-
-/**
- * IMD Atom file reader class for the double file format
- */
-class AtomReaderDouble : public AbstractAtomReader {
-public:
-    /**
-     * Ctor
-     *
-     * @param file The file to read from
-     */
-    AtomReaderDouble(vislib::sys::File& file) : AbstractAtomReader(file) {
-        // Intentionally empty
-    }
-
-    /**
-     * Dtor
-     */
-    ~AtomReaderDouble(void) {
-        // Intentionally empty
-    }
-
-    /**
-     * Reads an integer from the input data
-     *
-     * @param fail The fail flag is not changed if the method succeeds.
-     *             If the method fails the flag is set to 'true'.
-     *
-     * @return The read integer
-     */
-    VISLIB_FORCEINLINE UINT32 ReadInt(bool& fail) {
-        UINT32 i;
-        if (!this->copyData(&i, 4)) {
-            fail = true;
-        }
-        return i;
-    }
-
-    /**
-     * Reads a float from the input data
-     *
-     * @param fail The fail flag is not changed if the method succeeds.
-     *             If the method fails the flag is set to 'true'.
-     *
-     * @return The read float
-     */
-    VISLIB_FORCEINLINE float ReadFloat(bool& fail) {
-        double d;
-        if (!this->copyData(&d, 8)) {
-            fail = true;
-        }
-        return static_cast<float>(d);
-    }
-
-    /**
-     * Skips an integer in the input data
-     *
-     * @param fail The fail flag is not changed if the method succeeds.
-     *             If the method fails the flag is set to 'true'.
-     */
-    VISLIB_FORCEINLINE void SkipInt(bool& fail) {
-        if (!this->skipData(4))
-            fail = true;
-    }
-
-    /**
-     * Skips an float in the input data
-     *
-     * @param fail The fail flag is not changed if the method succeeds.
-     *             If the method fails the flag is set to 'true'.
-     */
-    VISLIB_FORCEINLINE void SkipFloat(bool& fail) {
-        if (!this->skipData(8))
-            fail = true;
-    }
-};
-
-
-/**
- * IMD Atom file reader class for the float file format with byte switch
- */
-class AtomReaderFloatSwitched : public AbstractAtomReader {
-public:
-    /**
-     * Ctor
-     *
-     * @param file The file to read from
-     */
-    AtomReaderFloatSwitched(vislib::sys::File& file) : AbstractAtomReader(file) {
-        // Intentionally empty
-    }
-
-    /**
-     * Dtor
-     */
-    ~AtomReaderFloatSwitched(void) {
-        // Intentionally empty
-    }
-
-    /**
-     * Reads an integer from the input data
-     *
-     * @param fail The fail flag is not changed if the method succeeds.
-     *             If the method fails the flag is set to 'true'.
-     *
-     * @return The read integer
-     */
-    VISLIB_FORCEINLINE UINT32 ReadInt(bool& fail) {
-        UINT32 i;
-        if (!this->copyData(&i, 4)) {
-            fail = true;
-        } else {
-            this->switch4Bytes(&i);
-        }
-        return i;
-    }
-
-    /**
-     * Reads a float from the input data
-     *
-     * @param fail The fail flag is not changed if the method succeeds.
-     *             If the method fails the flag is set to 'true'.
-     *
-     * @return The read float
-     */
-    VISLIB_FORCEINLINE float ReadFloat(bool& fail) {
-        float f;
-        if (!this->copyData(&f, 4)) {
-            fail = true;
-        } else {
-            this->switch4Bytes(&f);
-        }
-        return f;
-    }
-
-    /**
-     * Skips an integer in the input data
-     *
-     * @param fail The fail flag is not changed if the method succeeds.
-     *             If the method fails the flag is set to 'true'.
-     */
-    VISLIB_FORCEINLINE void SkipInt(bool& fail) {
-        if (!this->skipData(4))
-            fail = true;
-    }
-
-    /**
-     * Skips an float in the input data
-     *
-     * @param fail The fail flag is not changed if the method succeeds.
-     *             If the method fails the flag is set to 'true'.
-     */
-    VISLIB_FORCEINLINE void SkipFloat(bool& fail) {
-        if (!this->skipData(4))
-            fail = true;
-    }
-};
-
-
-/**
- * IMD Atom file reader class for the double file format with byte switch
- */
-class AtomReaderDoubleSwitched : public AbstractAtomReader {
-public:
-    /**
-     * Ctor
-     *
-     * @param file The file to read from
-     */
-    AtomReaderDoubleSwitched(vislib::sys::File& file) : AbstractAtomReader(file) {
-        // Intentionally empty
-    }
-
-    /**
-     * Dtor
-     */
-    ~AtomReaderDoubleSwitched(void) {
-        // Intentionally empty
-    }
-
-    /**
-     * Reads an integer from the input data
-     *
-     * @param fail The fail flag is not changed if the method succeeds.
-     *             If the method fails the flag is set to 'true'.
-     *
-     * @return The read integer
-     */
-    VISLIB_FORCEINLINE UINT32 ReadInt(bool& fail) {
-        UINT32 i;
-        if (!this->copyData(&i, 4)) {
-            fail = true;
-        } else {
-            this->switch4Bytes(&i);
-        }
-        return i;
-    }
-
-    /**
-     * Reads a float from the input data
-     *
-     * @param fail The fail flag is not changed if the method succeeds.
-     *             If the method fails the flag is set to 'true'.
-     *
-     * @return The read float
-     */
-    VISLIB_FORCEINLINE float ReadFloat(bool& fail) {
-        double d;
-        if (!this->copyData(&d, 8)) {
-            fail = true;
-        } else {
-            this->switch8Bytes(&d);
-        }
-        return static_cast<float>(d);
-    }
-
-    /**
-     * Skips an integer in the input data
-     *
-     * @param fail The fail flag is not changed if the method succeeds.
-     *             If the method fails the flag is set to 'true'.
-     */
-    VISLIB_FORCEINLINE void SkipInt(bool& fail) {
-        if (!this->skipData(4))
-            fail = true;
-    }
-
-    /**
-     * Skips an float in the input data
-     *
-     * @param fail The fail flag is not changed if the method succeeds.
-     *             If the method fails the flag is set to 'true'.
-     */
-    VISLIB_FORCEINLINE void SkipFloat(bool& fail) {
-        if (!this->skipData(8))
-            fail = true;
-    }
-};
-
-} /* end anonymous namespace */
-
 using namespace megamol;
 using namespace megamol::moldyn::io;
 
@@ -1133,7 +454,7 @@ void IMDAtomDataSource::assertData(void) {
 
     this->clear();
 
-    vislib::sys::FastFile file;
+    vislib::sys::MemmappedFile file;
     auto filename = this->filenameSlot.Param<core::param::FilePathParam>()->Value();
     //    Log::DefaultLog.WriteInfo(50, _T("Loading \"%s\""), filename.PeekBuffer());
     // this->datahash = static_cast<SIZE_T>(filename.HashCode());
@@ -1157,12 +478,6 @@ void IMDAtomDataSource::assertData(void) {
     //            "\t%s\n", header.captions[i].PeekBuffer());
     //    }
 
-    UINT32 endianTestInt = 0x12345678;
-    UINT8 endianTestBytes[4];
-    ::memcpy(endianTestBytes, &endianTestInt, 4);
-    bool machineLittleEndian = ((endianTestBytes[0] == 0x78) && (endianTestBytes[1] == 0x56) &&
-                                (endianTestBytes[2] == 0x34) && (endianTestBytes[3] == 0x12));
-
     vislib::StringA dirXColName = this->dirXColNameSlot.Param<core::param::StringParam>()->Value().c_str();
     vislib::StringA dirYColName = this->dirYColNameSlot.Param<core::param::StringParam>()->Value().c_str();
     vislib::StringA dirZColName = this->dirZColNameSlot.Param<core::param::StringParam>()->Value().c_str();
@@ -1174,29 +489,10 @@ void IMDAtomDataSource::assertData(void) {
     bool splitLoadDir = this->splitLoadDiredDataSlot.Param<core::param::BoolParam>()->Value();
 
     bool retval = false;
-    switch (header.format) {
-    case 'A': // ASCII
-        retval = this->readData<AtomReaderASCII>(file, header, loadDir, splitLoadDir);
-        break;
-    case 'B': // binary, big endian, double
-        retval = (machineLittleEndian) ? this->readData<AtomReaderDoubleSwitched>(file, header, loadDir, splitLoadDir)
-                                       : this->readData<AtomReaderDouble>(file, header, loadDir, splitLoadDir);
-        break;
-    case 'b': // binary, big endian, float
-        retval = (machineLittleEndian) ? this->readData<AtomReaderFloatSwitched>(file, header, loadDir, splitLoadDir)
-                                       : this->readData<AtomReaderFloat>(file, header, loadDir, splitLoadDir);
-        break;
-    case 'L': // binary, little endian, double
-        retval = (machineLittleEndian) ? this->readData<AtomReaderDouble>(file, header, loadDir, splitLoadDir)
-                                       : this->readData<AtomReaderDoubleSwitched>(file, header, loadDir, splitLoadDir);
-        break;
-    case 'l': // binary, little endian float
-        retval = (machineLittleEndian) ? this->readData<AtomReaderFloat>(file, header, loadDir, splitLoadDir)
-                                       : this->readData<AtomReaderFloatSwitched>(file, header, loadDir, splitLoadDir);
-        break;
-    default:
-        Log::DefaultLog.WriteMsg(Log::LEVEL_ERROR, "Unable to read imd file: Illegal format\n");
-        break;
+    try {
+        retval = this->readData(file, header, loadDir, splitLoadDir);
+    } catch (vislib::Exception& ex) {
+        Log::DefaultLog.WriteMsg(Log::LEVEL_ERROR, "Unable to read imd file: %s\n", ex.GetMsgA());
     }
 
     if (retval) {
@@ -1408,70 +704,20 @@ bool IMDAtomDataSource::readHeader(vislib::sys::File& file, IMDAtomDataSource::H
         }
         Log::DefaultLog.WriteMsg(Log::LEVEL_ERROR, "Failed to parse IMD header: unexpected end of file\n");
 
-    } catch (vislib::Exception ex) {
+    } catch (vislib::Exception& ex) {
         Log::DefaultLog.WriteMsg(Log::LEVEL_ERROR, "Failed to parse IMD header: %s\n", ex.GetMsgA());
     } catch (...) { Log::DefaultLog.WriteMsg(Log::LEVEL_ERROR, "Failed to parse IMD header: unexpected exception\n"); }
 
     return false;
 }
 
-template<typename T>
-void IMDAtomDataSource::readToIntColumn(T& reader, bool& fail, unsigned int* column, ...) {
-    const int numKnownColumns = 6;
-    float* out;
-    unsigned int col;
-    va_list vl;
-    va_start(vl, column);
-    for (int i = 0; i < numKnownColumns; i++) {
-        col = va_arg(vl, unsigned int);
-        out = va_arg(vl, float*);
-        if (col == *column) {
-            *out = static_cast<float>(reader.ReadInt(fail));
-            va_end(vl);
-            (*column)++;
-            return;
-        }
-    }
-    va_end(vl);
-    reader.SkipInt(fail);
-    (*column)++;
-}
-
-template<typename T>
-void IMDAtomDataSource::readToFloatColumn(T& reader, bool& fail, unsigned int* column, ...) {
-    const int numKnownColumns = 6;
-    float* out;
-    unsigned int col;
-    va_list vl;
-    va_start(vl, column);
-    for (int i = 0; i < numKnownColumns; i++) {
-        col = va_arg(vl, unsigned int);
-        out = va_arg(vl, float*);
-        if (col == *column) {
-            *out = static_cast<float>(reader.ReadFloat(fail));
-            va_end(vl);
-            (*column)++;
-            return;
-        }
-    }
-    va_end(vl);
-    reader.SkipFloat(fail);
-    (*column)++;
-}
-
 /*
  * IMDAtomDataSource::readData
  */
-template<typename T>
 bool IMDAtomDataSource::readData(
-    vislib::sys::File& file, const IMDAtomDataSource::HeaderData& header, bool loadDir, bool splitDir) {
-    T reader(file);
-    bool fail = false;
-    float x = 0.0f, y = 0.0f, z = 0.0f;
+    vislib::sys::MemmappedFile& file, const IMDAtomDataSource::HeaderData& header, bool loadDir, bool splitDir) {
+    using megamol::core::utility::log::Log;
     bool first = true;
-    float c = 0.0f, dc = 0.0f, t = 0.0f;
-    float dx = 0.0f, dy = 0.0f, dz = 0.0f;
-    unsigned int column;
     unsigned int colcolumn = UINT_MAX;
     unsigned int dircolcolumn = UINT_MAX;
     unsigned int typecolumn = UINT_MAX;
@@ -1619,266 +865,186 @@ bool IMDAtomDataSource::readData(
         }
     }
 
-    while (!fail) {
-        column = 0;
-
-        if (header.id) {
-            // these columns can be filled from anything you put into the respective parameters (by column name)
-            // problem: type does not exist!
-            // TODO  refactor, add type column
-            this->readToIntColumn(reader, fail, &column, colcolumn, &c, dirXCol, &dx, dirYCol, &dy, dirZCol, &dz,
-                dircolcolumn, &dc, typecolumn, &t);
-            // if ((column == colcolumn) || (column == dirXCol) || (column == dirYCol) || (column == dirZCol) || (column
-            // == dircolcolumn)){
-            //    float f = static_cast<float>(reader.ReadInt(fail));
-            //    if (column == colcolumn) c = f;
-            //    if (column == dirXCol) dx = f;
-            //    if (column == dirYCol) dy = f;
-            //    if (column == dirZCol) dz = f;
-            //    if (column == dircolcolumn) dc = f;
-            //} else {
-            //    reader.SkipInt(fail);
-            //}
-            // column++;
-        }
-        if (header.type) {
-            this->readToIntColumn(reader, fail, &column, colcolumn, &c, dirXCol, &dx, dirYCol, &dy, dirZCol, &dz,
-                dircolcolumn, &dc, typecolumn, &t);
-            // if ((column == colcolumn) || (column == dirXCol) || (column == dirYCol) || (column == dirZCol) || (column
-            // == dircolcolumn)){
-            //    float f = static_cast<float>(reader.ReadInt(fail));
-            //    if (column == colcolumn) c = f;
-            //    if (column == dirXCol) dx = f;
-            //    if (column == dirYCol) dy = f;
-            //    if (column == dirZCol) dz = f;
-            //    if (column == dircolcolumn) dc = f;
-            //} else {
-            //    reader.SkipInt(fail);
-            //}
-            // column++;
-        }
-        if (header.mass) {
-            this->readToFloatColumn(reader, fail, &column, colcolumn, &c, dirXCol, &dx, dirYCol, &dy, dirZCol, &dz,
-                dircolcolumn, &dc, typecolumn, &t);
-            // if ((column == colcolumn) || (column == dirXCol) || (column == dirYCol) || (column == dirZCol) || (column
-            // == dircolcolumn)){
-            //    float f = reader.ReadFloat(fail);
-            //    if (column == colcolumn) c = f;
-            //    if (column == dirXCol) dx = f;
-            //    if (column == dirYCol) dy = f;
-            //    if (column == dirZCol) dz = f;
-            //    if (column == dircolcolumn) dc = f;
-            //} else {
-            //    reader.SkipFloat(fail);
-            //}
-            // column++;
+    // decode all columns that are actually needed in parallel
+    const unsigned int intColumnCnt = (header.id ? 1 : 0) + (header.type ? 1 : 0);
+    const unsigned int posColumn = intColumnCnt + (header.mass ? 1 : 0);
+    const unsigned int columnCnt = posColumn + header.pos + header.vel + header.dat;
+    std::vector<unsigned int> columns;
+    auto requestColumn = [&columns, columnCnt](INT64 col) -> int {
+        if ((col < 0) || (col >= static_cast<INT64>(columnCnt))) {
+            return -1;
         }
-        for (int i = 0; i < header.pos; i++) {
-            if (i == 0) {
-                x = reader.ReadFloat(fail);
-                if (column == colcolumn)
-                    c = x;
-                if (column == dirXCol)
-                    dx = x;
-                if (column == dirYCol)
-                    dy = x;
-                if (column == dirZCol)
-                    dz = x;
-                if (column == dircolcolumn)
-                    dc = x;
-            }
-            if (i == 1) {
-                y = reader.ReadFloat(fail);
-                if (column == colcolumn)
-                    c = y;
-                if (column == dirXCol)
-                    dx = y;
-                if (column == dirYCol)
-                    dy = y;
-                if (column == dirZCol)
-                    dz = y;
-                if (column == dircolcolumn)
-                    dc = y;
-            }
-            if (i == 2) {
-                z = reader.ReadFloat(fail);
-                if (column == colcolumn)
-                    c = z;
-                if (column == dirXCol)
-                    dx = z;
-                if (column == dirYCol)
-                    dy = z;
-                if (column == dirZCol)
-                    dz = z;
-                if (column == dircolcolumn)
-                    dc = z;
-            }
-            if (i >= 3) {
-                if ((column == colcolumn) || (column == dirXCol) || (column == dirYCol) || (column == dirZCol) ||
-                    (column == dircolcolumn)) {
-                    float f = reader.ReadFloat(fail);
-                    if (column == colcolumn)
-                        c = f;
-                    if (column == dirXCol)
-                        dx = f;
-                    if (column == dirYCol)
-                        dy = f;
-                    if (column == dirZCol)
-                        dz = f;
-                    if (column == dircolcolumn)
-                        dc = f;
-                } else {
-                    reader.SkipFloat(fail);
-                }
+        for (SIZE_T i = 0; i < columns.size(); ++i) {
+            if (columns[i] == static_cast<unsigned int>(col)) {
+                return static_cast<int>(i);
             }
-            column++;
         }
-        for (int i = 0; i < header.vel; i++) {
-            this->readToFloatColumn(reader, fail, &column, colcolumn, &c, dirXCol, &dx, dirYCol, &dy, dirZCol, &dz,
-                dircolcolumn, &dc, typecolumn, &t);
-            // if ((column == colcolumn) || (column == dirXCol) || (column == dirYCol) || (column == dirZCol) || (column
-            // == dircolcolumn)){
-            //    float f = reader.ReadFloat(fail);
-            //    if (column == colcolumn) c = f;
-            //    if (column == dirXCol) dx = f;
-            //    if (column == dirYCol) dy = f;
-            //    if (column == dirZCol) dz = f;
-            //    if (column == dircolcolumn) dc = f;
-            //} else {
-            //    reader.SkipFloat(fail);
-            //}
-            // column++;
+        columns.push_back(static_cast<unsigned int>(col));
+        return static_cast<int>(columns.size() - 1);
+    };
+    const int xIdx = requestColumn(posColumn);
+    const int yIdx = requestColumn(posColumn + 1);
+    const int zIdx = (header.pos > 2) ? requestColumn(posColumn + 2) : -1;
+    const int cIdx = (colcolumn == UINT_MAX) ? -1 : requestColumn(colcolumn);
+    const int dcIdx = (dircolcolumn == UINT_MAX) ? -1 : requestColumn(dircolcolumn);
+    const int tIdx = (typecolumn == UINT_MAX) ? -1 : requestColumn(typecolumn);
+    const int dxIdx = requestColumn(dirXCol);
+    const int dyIdx = requestColumn(dirYCol);
+    const int dzIdx = requestColumn(dirZCol);
+
+    vislib::sys::ConsoleProgressBar cpb;
+    cpb.Start("Loading IMD file", 200);
+    auto progressHook = [&cpb](unsigned int phase) -> IMDAtomBlockReader::ProgressCallback {
+        return [&cpb, phase](float p) {
+            cpb.Set(static_cast<vislib::sys::ConsoleProgressBar::Size>(100.0f * (static_cast<float>(phase) + p)));
+        };
+    };
+
+    IMDAtomBlockReader reader;
+    std::vector<std::vector<float>> columnData;
+    try {
+        if (!reader.Open(file, file.Tell(), header.format, intColumnCnt, columnCnt)) {
+            cpb.Stop();
+            Log::DefaultLog.WriteMsg(Log::LEVEL_ERROR,
+                "Unable to read imd file: Unsupported data format '%c' or no data columns\n", header.format);
+            return false;
         }
-        for (int i = 0; i < header.dat; i++) {
-            this->readToFloatColumn(reader, fail, &column, colcolumn, &c, dirXCol, &dx, dirYCol, &dy, dirZCol, &dz,
-                dircolcolumn, &dc, typecolumn, &t);
-            // if ((column == colcolumn) || (column == dirXCol) || (column == dirYCol) || (column == dirZCol) || (column
-            // == dircolcolumn)){
-            //    float f = reader.ReadFloat(fail);
-            //    if (column == colcolumn) c = f;
-            //    if (column == dirXCol) dx = f;
-            //    if (column == dirYCol) dy = f;
-            //    if (column == dirZCol) dz = f;
-            //    if (column == dircolcolumn) dc = f;
-            //} else {
-            //    reader.SkipFloat(fail);
-            //}
-            // column++;
+        reader.FindRecords(progressHook(0));
+        reader.Decode(columns, columnData, progressHook(1));
+    } catch (vislib::sys::IOException& ex) {
+        cpb.Stop();
+        Log::DefaultLog.WriteMsg(
+            Log::LEVEL_ERROR, "Unable to read imd file: I/O error while mapping the data: %s\n", ex.GetMsgA());
+        return false;
+    }
+    reader.Close();
+    cpb.Stop();
+
+    auto value = [&columnData](int idx, SIZE_T rec) -> float {
+        return (idx < 0) ? 0.0f : columnData[idx][rec];
+    };
+
+    for (SIZE_T rec = 0; rec < reader.Count(); ++rec) {
+        const float x = value(xIdx, rec);
+        const float y = value(yIdx, rec);
+        const float z = value(zIdx, rec);
+        const float c = value(cIdx, rec);
+        const float dc = value(dcIdx, rec);
+        const float t = value(tIdx, rec);
+        float dx = value(dxIdx, rec);
+        float dy = value(dyIdx, rec);
+        float dz = value(dzIdx, rec);
+
+        if (this->bboxEnabledSlot.Param<core::param::BoolParam>()->Value()) {
+            vislib::math::Vector<float, 3> p(x, y, z),
+                minP(this->bboxMinSlot.Param<core::param::Vector3fParam>()->Value()),
+                maxP(this->bboxMaxSlot.Param<core::param::Vector3fParam>()->Value());
+            if ((p.GetX() < minP.GetX() || p.GetY() < minP.GetY() || p.GetZ() < minP.GetZ()) ||
+                (p.GetX() > maxP.GetX() || p.GetY() > maxP.GetY() || p.GetZ() > maxP.GetZ()))
+                continue;
         }
 
-        if (!fail) {
 
-            if (this->bboxEnabledSlot.Param<core::param::BoolParam>()->Value()) {
-                vislib::math::Vector<float, 3> p(x, y, z),
-                    minP(this->bboxMinSlot.Param<core::param::Vector3fParam>()->Value()),
-                    maxP(this->bboxMaxSlot.Param<core::param::Vector3fParam>()->Value());
-                if ((p.GetX() < minP.GetX() || p.GetY() < minP.GetY() || p.GetZ() < minP.GetZ()) ||
-                    (p.GetX() > maxP.GetX() || p.GetY() > maxP.GetY() || p.GetZ() > maxP.GetZ()))
-                    continue;
-            }
+        int rawIdx = 0;
+        if ((rawIdx = static_cast<int>(typeData.IndexOf(static_cast<unsigned int>(t)))) ==
+            static_cast<int>(vislib::Array<unsigned int>::INVALID_POS)) {
+            typeData.Append(static_cast<unsigned int>(t));
+            rawIdx = static_cast<int>(typeData.Count() - 1);
+            this->posData.Append(new vislib::RawStorage());
+            this->colData.Append(new vislib::RawStorage());
+            this->allDirData.Append(new vislib::RawStorage());
+            this->minC.Append(0.0f);
+            this->maxC.Append(1.0f);
+            posWriters.Append(new vislib::RawStorageWriter(*(this->posData[rawIdx]), 0, 0, 10 * 1024 * 1024));
+            colWriters.Append(new vislib::RawStorageWriter(*(this->colData[rawIdx]), 0, 0, 10 * 1024 * 1024));
+            dirWriters.Append(new vislib::RawStorageWriter(*(this->allDirData[rawIdx]), 0, 0, 10 * 1024 * 1024));
+        }
 
+        if (!first) {
+            if (this->minX > x)
+                this->minX = x;
+            else if (this->maxX < x)
+                this->maxX = x;
+            if (this->minY > y)
+                this->minY = y;
+            else if (this->maxY < y)
+                this->maxY = y;
+            if (this->minZ > z)
+                this->minZ = z;
+            else if (this->maxZ < z)
+                this->maxZ = z;
+        } else {
+            first = false;
+            this->minX = this->maxX = x;
+            this->minY = this->maxY = y;
+            this->minZ = this->maxZ = z;
+            this->minC[rawIdx] = this->maxC[rawIdx] = c;
+        }
+        if (colcolumn != UINT_MAX) {
+            if (this->minC[rawIdx] > c)
+                this->minC[rawIdx] = c;
+            else if (this->maxC[rawIdx] < c)
+                this->maxC[rawIdx] = c;
+        }
+        if (dircolcolumn != UINT_MAX) {
+            if (this->minC[rawIdx] > dc)
+                this->minC[rawIdx] = dc;
+            else if (this->maxC[rawIdx] < dc)
+                this->maxC[rawIdx] = dc;
+        }
 
-            int rawIdx = 0;
-            if ((rawIdx = static_cast<int>(typeData.IndexOf(static_cast<unsigned int>(t)))) ==
-                static_cast<int>(vislib::Array<unsigned int>::INVALID_POS)) {
-                typeData.Append(static_cast<unsigned int>(t));
-                rawIdx = static_cast<int>(typeData.Count() - 1);
-                this->posData.Append(new vislib::RawStorage());
-                this->colData.Append(new vislib::RawStorage());
-                this->allDirData.Append(new vislib::RawStorage());
-                this->minC.Append(0.0f);
-                this->maxC.Append(1.0f);
-                posWriters.Append(new vislib::RawStorageWriter(*(this->posData[rawIdx]), 0, 0, 10 * 1024 * 1024));
-                colWriters.Append(new vislib::RawStorageWriter(*(this->colData[rawIdx]), 0, 0, 10 * 1024 * 1024));
-                dirWriters.Append(new vislib::RawStorageWriter(*(this->allDirData[rawIdx]), 0, 0, 10 * 1024 * 1024));
+        if (loadDir) {
+            if (normaliseDir) {
+                vislib::math::Vector<float, 3> dv(dx, dy, dz);
+                dv.Normalise();
+                dx = dv.X();
+                dy = dv.Y();
+                dz = dv.Z();
             }
-
-            if (!first) {
-                if (this->minX > x)
-                    this->minX = x;
-                else if (this->maxX < x)
-                    this->maxX = x;
-                if (this->minY > y)
-                    this->minY = y;
-                else if (this->maxY < y)
-                    this->maxY = y;
-                if (this->minZ > z)
-                    this->minZ = z;
-                else if (this->maxZ < z)
-                    this->maxZ = z;
+            if (splitDir && vislib::math::IsEqual(dx, 0.0f) && vislib::math::IsEqual(dy, 0.0f) &&
+                vislib::math::IsEqual(dz, 0.0f)) {
+                *posWriters[rawIdx] << x << y << z;
+                if (colcolumn != UINT_MAX)
+                    *colWriters[rawIdx] << c;
+                // TODO type column??? vermutlich net
             } else {
-                first = false;
-                this->minX = this->maxX = x;
-                this->minY = this->maxY = y;
-                this->minZ = this->maxZ = z;
-                this->minC[rawIdx] = this->maxC[rawIdx] = c;
-            }
-            if (colcolumn != UINT_MAX) {
-                if (this->minC[rawIdx] > c)
-                    this->minC[rawIdx] = c;
-                else if (this->maxC[rawIdx] < c)
-                    this->maxC[rawIdx] = c;
-            }
-            if (dircolcolumn != UINT_MAX) {
-                if (this->minC[rawIdx] > dc)
-                    this->minC[rawIdx] = dc;
-                else if (this->maxC[rawIdx] < dc)
-                    this->maxC[rawIdx] = dc;
-            }
-
-            if (loadDir) {
-                if (normaliseDir) {
+                *dirWriters[rawIdx] << x << y << z;
+                if (dircolMode == 2) {
                     vislib::math::Vector<float, 3> dv(dx, dy, dz);
                     dv.Normalise();
-                    dx = dv.X();
-                    dy = dv.Y();
-                    dz = dv.Z();
-                }
-                if (splitDir && vislib::math::IsEqual(dx, 0.0f) && vislib::math::IsEqual(dy, 0.0f) &&
-                    vislib::math::IsEqual(dz, 0.0f)) {
-                    *posWriters[rawIdx] << x << y << z;
-                    if (colcolumn != UINT_MAX)
-                        *colWriters[rawIdx] << c;
-                    // TODO type column??? vermutlich net
-                } else {
-                    *dirWriters[rawIdx] << x << y << z;
-                    if (dircolMode == 2) {
-                        vislib::math::Vector<float, 3> dv(dx, dy, dz);
-                        dv.Normalise();
-                        float xr = 1.0f, xg = 0.0f, xb = 0.0f, yr = 0.0f, yg = 1.0f, yb = 0.0f, zr = 0.0f, zg = 0.0f,
-                              zb = 1.0f;
-                        if (dv.X() < 0.0f) {
-                            xr = 1.0f - xr;
-                            xg = 1.0f - xg;
-                            xb = 1.0f - xb;
-                        }
-                        if (dv.Y() < 0.0f) {
-                            yr = 1.0f - yr;
-                            yg = 1.0f - yg;
-                            yb = 1.0f - yb;
-                        }
-                        if (dv.Z() < 0.0f) {
-                            zr = 1.0f - zr;
-                            zg = 1.0f - zg;
-                            zb = 1.0f - zb;
-                        }
-                        dv.Set(dv.X() * dv.X(), dv.Y() * dv.Y(), dv.Z() * dv.Z());
+                    float xr = 1.0f, xg = 0.0f, xb = 0.0f, yr = 0.0f, yg = 1.0f, yb = 0.0f, zr = 0.0f, zg = 0.0f,
+                          zb = 1.0f;
+                    if (dv.X() < 0.0f) {
+                        xr = 1.0f - xr;
+                        xg = 1.0f - xg;
+                        xb = 1.0f - xb;
+                    }
+                    if (dv.Y() < 0.0f) {
+                        yr = 1.0f - yr;
+                        yg = 1.0f - yg;
+                        yb = 1.0f - yb;
+                    }
+                    if (dv.Z() < 0.0f) {
+                        zr = 1.0f - zr;
+                        zg = 1.0f - zg;
+                        zb = 1.0f - zb;
+                    }
+                    dv.Set(dv.X() * dv.X(), dv.Y() * dv.Y(), dv.Z() * dv.Z());
 
-                        *dirWriters[rawIdx] << (xr * dv.X() + yr * dv.Y() + zr * dv.Z());
-                        *dirWriters[rawIdx] << (xg * dv.X() + yg * dv.Y() + zg * dv.Z());
-                        *dirWriters[rawIdx] << (xb * dv.X() + yb * dv.Y() + zb * dv.Z());
+                    *dirWriters[rawIdx] << (xr * dv.X() + yr * dv.Y() + zr * dv.Z());
+                    *dirWriters[rawIdx] << (xg * dv.X() + yg * dv.Y() + zg * dv.Z());
+                    *dirWriters[rawIdx] << (xb * dv.X() + yb * dv.Y() + zb * dv.Z());
 
-                    } else if (dircolcolumn != UINT_MAX)
-                        *dirWriters[rawIdx] << dc;
-                    else if (colcolumn != UINT_MAX)
-                        *dirWriters[rawIdx] << c;
-                    *dirWriters[rawIdx] << dx << dy << dz;
-                }
-            } else {
-                *posWriters[rawIdx] << x << y << z;
-                if (colcolumn != UINT_MAX)
-                    *colWriters[rawIdx] << c;
+                } else if (dircolcolumn != UINT_MAX)
+                    *dirWriters[rawIdx] << dc;
+                else if (colcolumn != UINT_MAX)
+                    *dirWriters[rawIdx] << c;
+                *dirWriters[rawIdx] << dx << dy << dz;
             }
+        } else {
+            *posWriters[rawIdx] << x << y << z;
+            if (colcolumn != UINT_MAX)
+                *colWriters[rawIdx] << c;
         }
     }
 
@@ -1898,6 +1064,7 @@ bool IMDAtomDataSource::readData(
     return !first;
 }
 
+
 // TODO das ist eigentlich kruscht, das sollte wenn dann ein region-filter sein, aber na gut...
 /*
  * IMDAtomDataSource::posXFilterUpdate
@@ -11,9 +11,11 @@
 #pragma once
 #endif /* (defined(_MSC_VER) && (_MSC_VER > 1000)) */
 
+#include "io/IMDAtomBlockReader.h"
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/Module.h"
 #include "mmcore/param/ParamSlot.h"
+#include "mmcore/utility/sys/MemmappedFile.h"
 #include "vislib/Array.h"
 #include "vislib/PtrArray.h"
 #include "vislib/RawStorage.h"
@@ -173,33 +175,23 @@ private:
      */
     bool readHeader(vislib::sys::File& file, HeaderData& header);
 
-    // TODO: document
-    // read a value and ADVANCE column
-    template<typename T>
-    void readToIntColumn(T& reader, bool& fail, unsigned int* column, ...);
-    template<typename T>
-    void readToFloatColumn(T& reader, bool& fail, unsigned int* column, ...);
-
     /**
      * Reads the data of the imd file. This method also calculated the
      * data bounding box and sets the corresponding members.
      *
-     * Use a imdinternal::AtomReader* class as template type.
+     * The records are decoded in parallel by an IMDAtomBlockReader.
      *
-     * @param file The file object to read from
+     * @param file The file object to read from, positioned at the first
+     *             record
      * @param header The struct holding the header data
-     * @param pos The writer receiving the read position data
-     * @param col The writer receiving the read colour data
-     * @param dir The writer receiving all directed particle data
-     * @param loadDir Flag to activate the use of 'dir'
+     * @param loadDir Flag to activate the loading of directional data
      * @param splitDir Particles with direction NULL vector will be stored
      *                 in pos and col, while all others will be stored in
      *                 dir if (loadDir==true)
      *
      * @return 'true' on success
      */
-    template<typename T>
-    bool readData(vislib::sys::File& file, const HeaderData& header, bool loadDir, bool splitDir);
+    bool readData(vislib::sys::MemmappedFile& file, const HeaderData& header, bool loadDir, bool splitDir);
 
     /**
      * Updates the posX filter data (decrese only!)
@@ -6,16 +6,20 @@
  */
 
 #include "MMPLDDataSource.h"
+#include "io/MMPLDPositionCodec.h"
 #include "geometry_calls/MultiParticleDataCall.h"
 #include "mmcore/CoreInstance.h"
 #include "mmcore/param/BoolParam.h"
 #include "mmcore/param/FilePathParam.h"
 #include "mmcore/param/IntParam.h"
+#include "mmcore/param/Vector3fParam.h"
 #include "mmcore/utility/log/Log.h"
 #include "mmcore/utility/sys/SystemInformation.h"
 #include "stdafx.h"
 #include "vislib/String.h"
 #include "vislib/sys/FastFile.h"
+#include <cstring>
+#include <vector>
 
 namespace megamol::moldyn::io {
 
@@ -28,6 +32,108 @@ namespace megamol::moldyn::io {
 // factor multiplied to the frame size for estimating the overhead to the pure data.
 #define CACHE_FRAME_FACTOR 1.15f
 
+namespace {
+
+/** The sizes of the vertex and colour types in bytes, quantized positions (5) vary per chunk */
+const SIZE_T vertexSizes[] = {0, 12, 16, 6, 24, 0};
+const SIZE_T colourSizes[] = {0, 3, 4, 4, 12, 16, 8, 8};
+
+/** The size of a chunk table entry, the particle count and the bounding box (version 1.4) */
+const SIZE_T chunkEntrySize = 8 + 6 * 4;
+
+/** The vertex type of quantized positions (version 1.5) */
+const UINT8 quantizedType = 5;
+
+/** The size of the header of quantized list data, bits, flags, reserved and the key frame (version 1.5) */
+const SIZE_T quantizedHeadSize = 8;
+
+/** Answer the size of a list header up to and including the chunk count (version 1.4) */
+inline SIZE_T listHeadSize(UINT8 vrtType, UINT8 colType) {
+    SIZE_T size = 2 + 8 + 24 + 4;
+    if ((vrtType == 1) || (vrtType == 3) || (vrtType == 4) || (vrtType == quantizedType)) {
+        size += 4;
+    }
+    if (colType == 0) {
+        size += 4;
+    } else if (colType == 3 || colType == 7) {
+        size += 8;
+    }
+    return size;
+}
+
+/** Answer whether a chunk bounding box intersects a region */
+inline bool intersects(const float* box, vislib::math::Cuboid<float> const& region) {
+    return (box[0] <= region.Right()) && (box[3] >= region.Left()) && (box[1] <= region.Top()) &&
+           (box[4] >= region.Bottom()) && (box[2] <= region.Front()) && (box[5] >= region.Back());
+}
+
+/** The position of a particle list within the data of a frame (version 1.4) */
+struct ListLayout {
+    UINT8 vrtType;
+    UINT8 colType;
+    UINT64 cnt;
+    UINT32 chunkCnt;
+    SIZE_T begin;
+    SIZE_T table;
+    SIZE_T data;
+    SIZE_T end;
+};
+
+/** Locates the particle lists of a frame (version 1.4), answers 'false' if the data is malformed */
+bool parseLists(const char* dat, SIZE_T size, std::vector<ListLayout>& lists) {
+    if (size < 8) {
+        return false;
+    }
+    UINT32 plc;
+    std::memcpy(&plc, dat + 4, 4);
+    lists.clear();
+    UINT64 p = 8;
+    for (UINT32 i = 0; i < plc; i++) {
+        ListLayout l;
+        if (p + 2 > size) {
+            return false;
+        }
+        l.vrtType = static_cast<UINT8>(dat[p]);
+        l.colType = static_cast<UINT8>(dat[p + 1]);
+        if ((l.vrtType > quantizedType) || (l.colType > 7)) {
+            return false;
+        }
+        const SIZE_T head = listHeadSize(l.vrtType, l.colType);
+        if (p + head > size) {
+            return false;
+        }
+        std::memcpy(&l.cnt, dat + p + head - 4 - 24 - 8, 8);
+        std::memcpy(&l.chunkCnt, dat + p + head - 4, 4);
+        l.begin = static_cast<SIZE_T>(p);
+        UINT64 end = p + head + static_cast<UINT64>(l.chunkCnt) * chunkEntrySize;
+        l.table = static_cast<SIZE_T>(p + head);
+        l.data = static_cast<SIZE_T>(end);
+        if (l.vrtType == quantizedType) {
+            end += quantizedHeadSize + 8 * static_cast<UINT64>(l.chunkCnt);
+            if (end > size) {
+                return false;
+            }
+            for (UINT32 c = 0; c < l.chunkCnt; ++c) {
+                UINT64 chunkSize;
+                std::memcpy(&chunkSize, dat + l.data + quantizedHeadSize + 8 * c, 8);
+                end += chunkSize;
+            }
+        } else {
+            const SIZE_T stride = vertexSizes[l.vrtType] + ((l.vrtType != 0) ? colourSizes[l.colType] : 0);
+            end += l.cnt * stride;
+        }
+        if ((end > size) || (end < l.data)) {
+            return false;
+        }
+        l.end = static_cast<SIZE_T>(end);
+        lists.push_back(l);
+        p = end;
+    }
+    return true;
+}
+
+} // namespace
+
 /*****************************************************************************/
 
 /*
@@ -57,6 +163,320 @@ bool MMPLDDataSource::Frame::LoadFrame(vislib::sys::File* file, unsigned int idx
 }
 
 
+/*
+ * MMPLDDataSource::Frame::LoadFrameRegion
+ */
+bool MMPLDDataSource::Frame::LoadFrameRegion(vislib::sys::File* file, unsigned int idx, UINT64 size,
+    unsigned int version, vislib::math::Cuboid<float> const& region) {
+    this->frame = idx;
+    this->fileVersion = version;
+    this->dat.EnforceSize(0);
+
+    // the frame is assembled from header bytes and ranges of the file
+    struct Segment {
+        std::vector<char> bytes;
+        UINT64 offset;
+        UINT64 size;
+    };
+    std::vector<Segment> segments;
+    const UINT64 frameEnd = file->Tell() + size;
+
+    Segment frameHead{std::vector<char>(8), 0, 8};
+    if (file->Read(frameHead.bytes.data(), 8) != 8) {
+        return false;
+    }
+    UINT32 plc;
+    std::memcpy(&plc, frameHead.bytes.data() + 4, 4);
+    segments.push_back(std::move(frameHead));
+
+    for (UINT32 i = 0; i < plc; i++) {
+        UINT8 types[2];
+        const UINT8 maxVrtType = (version >= 105) ? quantizedType : 4;
+        if ((file->Read(types, 2) != 2) || (types[0] > maxVrtType) || (types[1] > 7)) {
+            return false;
+        }
+        const UINT8 vrtType = types[0];
+        const UINT8 colType = types[1];
+        const SIZE_T stride = vertexSizes[vrtType] + ((vrtType != 0) ? colourSizes[colType] : 0);
+
+        // radius, colour, count, bbox and chunk count
+        const SIZE_T headSize = listHeadSize(vrtType, colType) - 2;
+        Segment listHead{std::vector<char>(2 + headSize), 0, 2 + headSize};
+        std::memcpy(listHead.bytes.data(), types, 2);
+        if (file->Read(listHead.bytes.data() + 2, headSize) != headSize) {
+            return false;
+        }
+        char* cntPtr = listHead.bytes.data() + listHead.size - 4 - 24 - 8;
+        char* chunkCntPtr = listHead.bytes.data() + listHead.size - 4;
+        UINT64 cnt;
+        UINT32 chunkCnt;
+        std::memcpy(&cnt, cntPtr, 8);
+        std::memcpy(&chunkCnt, chunkCntPtr, 4);
+
+        std::vector<char> table(chunkCnt * chunkEntrySize);
+        if (file->Read(table.data(), table.size()) != table.size()) {
+            return false;
+        }
+        const UINT64 dataBegin = file->Tell();
+        UINT64 dataSize = cnt * stride;
+        if (vrtType == quantizedType) {
+            // the chunk sizes follow the header of the quantized data
+            std::vector<UINT64> sizes(chunkCnt);
+            file->Seek(dataBegin + quantizedHeadSize);
+            if (file->Read(sizes.data(), 8 * chunkCnt) != 8 * chunkCnt) {
+                return false;
+            }
+            dataSize = quantizedHeadSize + 8 * chunkCnt;
+            for (UINT64 s : sizes) {
+                dataSize += s;
+            }
+        }
+        if (dataBegin + dataSize > frameEnd) {
+            return false;
+        }
+
+        if ((chunkCnt == 0) || (vrtType == quantizedType)) {
+            // quantized lists are filtered while decoding
+            const UINT64 tableSize = table.size();
+            segments.push_back(std::move(listHead));
+            segments.push_back(Segment{std::move(table), 0, tableSize});
+            segments.push_back(Segment{std::vector<char>(), dataBegin, dataSize});
+        } else {
+            // keep the intersecting chunks, merging neighbouring ones into one read
+            Segment selected{std::vector<char>(), 0, 0};
+            std::vector<Segment> ranges;
+            UINT64 first = 0;
+            UINT64 selectedCnt = 0;
+            for (UINT32 c = 0; c < chunkCnt; ++c) {
+                const char* entry = table.data() + c * chunkEntrySize;
+                UINT64 chunkSize;
+                float box[6];
+                std::memcpy(&chunkSize, entry, 8);
+                std::memcpy(box, entry + 8, 24);
+                if (intersects(box, region)) {
+                    selected.bytes.insert(selected.bytes.end(), entry, entry + chunkEntrySize);
+                    const UINT64 offset = dataBegin + first * stride;
+                    if (!ranges.empty() && (ranges.back().offset + ranges.back().size == offset)) {
+                        ranges.back().size += chunkSize * stride;
+                    } else {
+                        ranges.push_back(Segment{std::vector<char>(), offset, chunkSize * stride});
+                    }
+                    selectedCnt += chunkSize;
+                }
+                first += chunkSize;
+            }
+            if (first != cnt) {
+                return false;
+            }
+
+            const UINT32 selectedChunks = static_cast<UINT32>(selected.bytes.size() / chunkEntrySize);
+            std::memcpy(cntPtr, &selectedCnt, 8);
+            std::memcpy(chunkCntPtr, &selectedChunks, 4);
+            selected.size = selected.bytes.size();
+            segments.push_back(std::move(listHead));
+            segments.push_back(std::move(selected));
+            for (auto& r : ranges) {
+                segments.push_back(std::move(r));
+            }
+        }
+        file->Seek(dataBegin + dataSize);
+    }
+
+    UINT64 total = 0;
+    for (auto const& s : segments) {
+        total += s.size;
+    }
+    this->dat.EnforceSize(static_cast<SIZE_T>(total));
+    SIZE_T pos = 0;
+    for (auto const& s : segments) {
+        if (!s.bytes.empty()) {
+            std::memcpy(this->dat.At(pos), s.bytes.data(), s.size);
+        } else if (s.size > 0) {
+            file->Seek(s.offset);
+            if (file->Read(this->dat.At(pos), s.size) != s.size) {
+                return false;
+            }
+        }
+        pos += static_cast<SIZE_T>(s.size);
+    }
+    return true;
+}
+
+
+/*
+ * MMPLDDataSource::Frame::Decode
+ */
+bool MMPLDDataSource::Frame::Decode(
+    KeyFrame& key, std::function<bool(unsigned int)> const& loadKey, vislib::math::Cuboid<float> const* region) {
+    const char* src = this->dat.As<char>();
+    std::vector<ListLayout> lists;
+    if (!parseLists(src, this->dat.GetSize(), lists)) {
+        return false;
+    }
+
+    // delta lists need the grid indices of their key frame, key lists provide them
+    bool quantized = false;
+    bool delta = false;
+    UINT32 keyIdx = 0;
+    for (auto const& l : lists) {
+        if (l.vrtType == quantizedType) {
+            quantized = true;
+            if ((src[l.data + 1] & 1) != 0) {
+                delta = true;
+                std::memcpy(&keyIdx, src + l.data + 4, 4);
+            }
+        }
+    }
+    if (!quantized) {
+        return true;
+    }
+    if (delta) {
+        if ((key.frame != keyIdx) && (!loadKey || !loadKey(keyIdx))) {
+            return false;
+        }
+        if (key.q.size() != lists.size()) {
+            return false;
+        }
+    } else {
+        key.frame = UINT_MAX;
+        key.q.assign(lists.size(), std::vector<int32_t>());
+    }
+
+    // select the chunks and lay out the decoded frame
+    struct Task {
+        const char* in;
+        UINT64 size;
+        UINT64 cnt;
+        const int32_t* ref;
+        int32_t* q;
+        SIZE_T colSize;
+        bool keep;
+        SIZE_T out;
+    };
+    std::vector<Task> tasks;
+    std::vector<std::vector<bool>> selected(lists.size());
+    UINT64 size = 8;
+    for (size_t li = 0; li < lists.size(); ++li) {
+        ListLayout const& l = lists[li];
+        if (l.vrtType != quantizedType) {
+            size += l.end - l.begin;
+            continue;
+        }
+        const bool isDelta = ((src[l.data + 1] & 1) != 0);
+        if (isDelta && (key.q[li].size() != 3 * l.cnt)) {
+            return false;
+        }
+        UINT64 first = 0;
+        UINT64 selectedCnt = 0;
+        size += listHeadSize(l.vrtType, l.colType);
+        selected[li].resize(l.chunkCnt);
+        for (UINT32 c = 0; c < l.chunkCnt; ++c) {
+            UINT64 chunkCnt;
+            std::memcpy(&chunkCnt, src + l.table + c * chunkEntrySize, 8);
+            float box[6];
+            std::memcpy(box, src + l.table + c * chunkEntrySize + 8, 24);
+            selected[li][c] = (region == nullptr) || intersects(box, *region);
+            if (selected[li][c]) {
+                size += chunkEntrySize;
+                selectedCnt += chunkCnt;
+            }
+            first += chunkCnt;
+        }
+        if (first != l.cnt) {
+            return false;
+        }
+        size += selectedCnt * (vertexSizes[1] + colourSizes[l.colType]);
+    }
+
+    std::vector<char> decoded(static_cast<size_t>(size));
+    char* dst = decoded.data();
+    std::memcpy(dst, src, 8);
+    SIZE_T pos = 8;
+    for (size_t li = 0; li < lists.size(); ++li) {
+        ListLayout const& l = lists[li];
+        if (l.vrtType != quantizedType) {
+            std::memcpy(dst + pos, src + l.begin, l.end - l.begin);
+            pos += l.end - l.begin;
+            continue;
+        }
+        const bool isDelta = ((src[l.data + 1] & 1) != 0);
+        if (!isDelta) {
+            key.q[li].resize(3 * l.cnt);
+        }
+
+        // the header as VERTDATA_FLOAT_XYZ with the selected chunks
+        const SIZE_T head = listHeadSize(l.vrtType, l.colType);
+        char* listHead = dst + pos;
+        std::memcpy(listHead, src + l.begin, head);
+        listHead[0] = 1;
+        pos += head;
+        UINT64 selectedCnt = 0;
+        UINT32 selectedChunks = 0;
+        for (UINT32 c = 0; c < l.chunkCnt; ++c) {
+            if (selected[li][c]) {
+                UINT64 chunkCnt;
+                std::memcpy(&chunkCnt, src + l.table + c * chunkEntrySize, 8);
+                std::memcpy(dst + pos, src + l.table + c * chunkEntrySize, chunkEntrySize);
+                pos += chunkEntrySize;
+                selectedCnt += chunkCnt;
+                ++selectedChunks;
+            }
+        }
+        std::memcpy(listHead + head - 4 - 24 - 8, &selectedCnt, 8);
+        std::memcpy(listHead + head - 4, &selectedChunks, 4);
+
+        // the chunks of delta lists outside the region need no decoding
+        const char* in = src + l.data + quantizedHeadSize + 8 * l.chunkCnt;
+        const SIZE_T colSize = colourSizes[l.colType];
+        UINT64 first = 0;
+        for (UINT32 c = 0; c < l.chunkCnt; ++c) {
+            UINT64 chunkCnt;
+            UINT64 chunkSize;
+            std::memcpy(&chunkCnt, src + l.table + c * chunkEntrySize, 8);
+            std::memcpy(&chunkSize, src + l.data + quantizedHeadSize + 8 * c, 8);
+            if (selected[li][c] || !isDelta) {
+                tasks.push_back(Task{in, chunkSize, chunkCnt, isDelta ? key.q[li].data() + 3 * first : nullptr,
+                    isDelta ? nullptr : key.q[li].data() + 3 * first, colSize, selected[li][c], pos});
+            }
+            if (selected[li][c]) {
+                pos += chunkCnt * (vertexSizes[1] + colSize);
+            }
+            in += chunkSize;
+            first += chunkCnt;
+        }
+    }
+
+    bool ok = true;
+    const INT64 taskCnt = static_cast<INT64>(tasks.size());
+#pragma omp parallel for reduction(&& : ok)
+    for (INT64 t = 0; t < taskCnt; ++t) {
+        Task const& task = tasks[t];
+        char* out = task.keep ? dst + task.out : nullptr;
+        const SIZE_T stride = vertexSizes[1] + task.colSize;
+        const UINT64 used = MMPLDPositionCodec::Decode(task.in, task.size, task.cnt, task.ref, task.q, out, stride);
+        if ((used == 0) || (used + task.cnt * task.colSize != task.size)) {
+            ok = false;
+            continue;
+        }
+        if ((out != nullptr) && (task.colSize > 0)) {
+            for (UINT64 i = 0; i < task.cnt; ++i) {
+                std::memcpy(out + i * stride + vertexSizes[1], task.in + used + i * task.colSize, task.colSize);
+            }
+        }
+    }
+    if (!ok) {
+        return false;
+    }
+    if (!delta) {
+        key.frame = this->frame;
+    }
+
+    this->dat.EnforceSize(decoded.size());
+    std::memcpy(this->dat.As<char>(), decoded.data(), decoded.size());
+    return true;
+}
+
+
 /*
  * MMPLDDataSource::Frame::SetData
  */
@@ -192,6 +612,11 @@ void MMPLDDataSource::Frame::SetData(
             pts.SetBBox(bbox);
             p += 24;
         }
+        if (this->fileVersion >= 104) {
+            // the chunk table is only needed for loading
+            UINT32 chunkCnt = *this->dat.AsAt<UINT32>(p);
+            p += 4 + chunkCnt * chunkEntrySize;
+        }
         if (overrideBBox) {
             pts.SetBBox(bbox);
         }
@@ -229,12 +654,18 @@ MMPLDDataSource::MMPLDDataSource(void)
         , limitMemorySlot("limitMemory", "Limits the memory cache size")
         , limitMemorySizeSlot("limitMemorySize", "Specifies the size limit (in MegaBytes) of the memory cache")
         , overrideBBoxSlot("overrideLocalBBox", "Override local bbox")
+        , regionSlot("regionOfInterest::enable", "Loads only the particle chunks intersecting the region (MMPLD 1.4)")
+        , regionMinSlot("regionOfInterest::min", "The minimum of the region of interest")
+        , regionMaxSlot("regionOfInterest::max", "The maximum of the region of interest")
         , getData("getdata", "Slot to request data from this data source.")
         , file(NULL)
         , frameIdx(NULL)
         , bbox(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f)
         , clipbox(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f)
-        , data_hash(0) {
+        , useRegion(false)
+        , region(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f)
+        , data_hash(0)
+        , overrideBBox(false) {
 
     this->filename.SetParameter(
         new core::param::FilePathParam("", core::param::FilePathParam::Flag_File_RestrictExtension, {"mmpld"}));
@@ -254,8 +685,21 @@ MMPLDDataSource::MMPLDDataSource(void)
     this->MakeSlotAvailable(&this->limitMemorySizeSlot);
 
     this->overrideBBoxSlot << new core::param::BoolParam(false);
+    this->overrideBBoxSlot.SetUpdateCallback(&MMPLDDataSource::overrideBBoxChanged);
     this->MakeSlotAvailable(&this->overrideBBoxSlot);
 
+    this->regionSlot << new core::param::BoolParam(false);
+    this->regionSlot.SetUpdateCallback(&MMPLDDataSource::regionChanged);
+    this->MakeSlotAvailable(&this->regionSlot);
+
+    this->regionMinSlot << new core::param::Vector3fParam(vislib::math::Vector<float, 3>(-1.0f, -1.0f, -1.0f));
+    this->regionMinSlot.SetUpdateCallback(&MMPLDDataSource::regionChanged);
+    this->MakeSlotAvailable(&this->regionMinSlot);
+
+    this->regionMaxSlot << new core::param::Vector3fParam(vislib::math::Vector<float, 3>(1.0f, 1.0f, 1.0f));
+    this->regionMaxSlot.SetUpdateCallback(&MMPLDDataSource::regionChanged);
+    this->MakeSlotAvailable(&this->regionMaxSlot);
+
     this->getData.SetCallback(geocalls::MultiParticleDataCall::ClassName(),
         geocalls::MultiParticleDataCall::FunctionName(0), &MMPLDDataSource::getDataCallback);
     this->getData.SetCallback(geocalls::MultiParticleDataCall::ClassName(),
@@ -309,17 +753,42 @@ void MMPLDDataSource::loadFrame(AnimDataModule::Frame* frame, unsigned int idx)
     //Log::DefaultLog.WriteMsg(Log::LEVEL_INFO, "Requesting frame %u of %u frames\n", idx, this->FrameCount());
     ASSERT(idx < this->FrameCount());
     this->file->Seek(this->frameIdx[idx]);
-    if (!f->LoadFrame(this->file, idx, this->frameIdx[idx + 1] - this->frameIdx[idx], this->fileVersion)) {
+    const UINT64 size = this->frameIdx[idx + 1] - this->frameIdx[idx];
+    const bool loaded = (this->useRegion && (this->fileVersion >= 104))
+                            ? f->LoadFrameRegion(this->file, idx, size, this->fileVersion, this->region)
+                            : f->LoadFrame(this->file, idx, size, this->fileVersion);
+    if (loaded && (this->fileVersion >= 105)) {
+        auto const loadKey = [this](unsigned int key) { return this->loadKeyFrame(key); };
+        if (!f->Decode(this->keyFrame, loadKey, this->useRegion ? &this->region : nullptr)) {
+            Log::DefaultLog.WriteMsg(Log::LEVEL_ERROR, "Unable to decode frame %d from MMPLD file\n", idx);
+            f->Clear();
+        }
+    } else if (!loaded) {
         // failed
         Log::DefaultLog.WriteMsg(Log::LEVEL_ERROR, "Unable to read frame %d from MMPLD file\n", idx);
     }
 }
 
 
+/*
+ * MMPLDDataSource::loadKeyFrame
+ */
+bool MMPLDDataSource::loadKeyFrame(unsigned int idx) {
+    if ((this->file == NULL) || (idx >= this->FrameCount())) {
+        return false;
+    }
+    Frame key(*this);
+    this->file->Seek(this->frameIdx[idx]);
+    return key.LoadFrame(this->file, idx, this->frameIdx[idx + 1] - this->frameIdx[idx], this->fileVersion) &&
+           key.Decode(this->keyFrame, nullptr, nullptr) && (this->keyFrame.frame == idx);
+}
+
+
 /*
  * MMPLDDataSource::release
  */
 void MMPLDDataSource::release(void) {
+    std::lock_guard<std::mutex> lock(this->stateLock);
     this->resetFrameCache();
     if (this->file != NULL) {
         vislib::sys::File* f = this->file;
@@ -337,6 +806,7 @@ void MMPLDDataSource::release(void) {
 bool MMPLDDataSource::filenameChanged(core::param::ParamSlot& slot) {
     using megamol::core::utility::log::Log;
     using vislib::sys::File;
+    std::lock_guard<std::mutex> lock(this->stateLock);
     this->resetFrameCache();
     this->bbox.Set(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f);
     this->clipbox = this->bbox;
@@ -381,7 +851,7 @@ bool MMPLDDataSource::filenameChanged(core::param::ParamSlot& slot) {
     }
     unsigned short ver;
     _ASSERT_READFILE(&ver, 2);
-    if (ver < 100 || ver > 103) {
+    if (ver < 100 || ver > 105) {
         _ERROR_OUT("MMPLD file header version wrong");
     }
     this->fileVersion = ver;
@@ -407,6 +877,17 @@ bool MMPLDDataSource::filenameChanged(core::param::ParamSlot& slot) {
     }
     size /= static_cast<double>(frmCnt);
     size *= CACHE_FRAME_FACTOR;
+    this->keyFrame = KeyFrame();
+    if (ver >= 105) {
+        // quantized frames grow when decoded, the first frame is always a key frame
+        Frame first(*this);
+        const UINT64 firstSize = this->frameIdx[1] - this->frameIdx[0];
+        this->file->Seek(this->frameIdx[0]);
+        if ((firstSize > 0) && first.LoadFrame(this->file, 0, firstSize, ver) &&
+            first.Decode(this->keyFrame, nullptr, nullptr)) {
+            size *= static_cast<double>(first.GetSize()) / static_cast<double>(firstSize);
+        }
+    }
 
     UINT64 mem = vislib::sys::SystemInformation::AvailableMemorySize();
     if (this->limitMemorySlot.Param<core::param::BoolParam>()->Value()) {
@@ -439,6 +920,42 @@ bool MMPLDDataSource::filenameChanged(core::param::ParamSlot& slot) {
 }
 
 
+/*
+ * MMPLDDataSource::regionChanged
+ */
+bool MMPLDDataSource::regionChanged(core::param::ParamSlot& slot) {
+    auto const& lo = this->regionMinSlot.Param<core::param::Vector3fParam>()->Value();
+    auto const& hi = this->regionMaxSlot.Param<core::param::Vector3fParam>()->Value();
+    std::lock_guard<std::mutex> lock(this->stateLock);
+    const bool reload = (this->file != NULL) && (this->fileVersion >= 104);
+
+    // the cached frames hold the chunks of the previous region
+    const unsigned int frameCnt = this->FrameCount();
+    const unsigned int cacheSize = this->CacheSize();
+    if (reload) {
+        this->resetFrameCache();
+    }
+    this->useRegion = this->regionSlot.Param<core::param::BoolParam>()->Value();
+    this->region.Set(lo.X(), lo.Y(), lo.Z(), hi.X(), hi.Y(), hi.Z());
+    if (reload) {
+        this->setFrameCount(frameCnt);
+        this->initFrameCache(cacheSize);
+        this->data_hash++;
+    }
+    return true;
+}
+
+
+/*
+ * MMPLDDataSource::overrideBBoxChanged
+ */
+bool MMPLDDataSource::overrideBBoxChanged(core::param::ParamSlot& slot) {
+    std::lock_guard<std::mutex> lock(this->stateLock);
+    this->overrideBBox = this->overrideBBoxSlot.Param<core::param::BoolParam>()->Value();
+    return true;
+}
+
+
 /*
  * MMPLDDataSource::getDataCallback
  */
@@ -447,6 +964,7 @@ bool MMPLDDataSource::getDataCallback(core::Call& caller) {
     if (c2 == NULL)
         return false;
 
+    std::lock_guard<std::mutex> lock(this->stateLock);
     Frame* f = NULL;
     if (c2 != NULL) {
         f = dynamic_cast<Frame*>(this->requestLockedFrame(c2->FrameID(), c2->IsFrameForced()));
@@ -455,8 +973,7 @@ bool MMPLDDataSource::getDataCallback(core::Call& caller) {
         c2->SetUnlocker(new Unlocker(*f));
         c2->SetFrameID(f->FrameNumber());
         c2->SetDataHash(this->data_hash);
-        auto overrideBBox = this->overrideBBoxSlot.Param<core::param::BoolParam>()->Value();
-        f->SetData(*c2, this->bbox, overrideBBox);
+        f->SetData(*c2, this->bbox, this->overrideBBox);
     }
 
     return true;
@@ -470,6 +987,7 @@ bool MMPLDDataSource::getExtentCallback(core::Call& caller) {
     geocalls::MultiParticleDataCall* c2 = dynamic_cast<geocalls::MultiParticleDataCall*>(&caller);
 
     if (c2 != NULL) {
+        std::lock_guard<std::mutex> lock(this->stateLock);
         c2->SetFrameCount(this->FrameCount());
         c2->AccessBoundingBoxes().Clear();
         c2->AccessBoundingBoxes().SetObjectSpaceBBox(this->bbox);
@@ -7,6 +7,12 @@
 
 #pragma once
 
+#include <climits>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
 #include "geometry_calls/MultiParticleDataCall.h"
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/param/ParamSlot.h"
@@ -58,6 +64,17 @@ public:
     /** Dtor. */
     virtual ~MMPLDDataSource(void);
 
+    /**
+     * The parameters are only evaluated by their update callbacks, and the
+     * state these change is guarded by 'stateLock', so the call functions
+     * may run on a worker thread.
+     *
+     * @return 'true'
+     */
+    bool SupportsBackgroundCalls(void) const override {
+        return true;
+    }
+
 protected:
     /**
      * Creates a frame to be used in the frame cache. This method will be
@@ -90,6 +107,15 @@ protected:
      */
     virtual void release(void);
 
+    /** The grid indices of the quantized particle lists of a key frame (version 1.5) */
+    struct KeyFrame {
+        /** The index of the frame, UINT_MAX if none is loaded */
+        unsigned int frame = UINT_MAX;
+
+        /** The planar grid indices per list, empty for lists which are not quantized */
+        std::vector<std::vector<int32_t>> q;
+    };
+
     /** Nested class of frame data */
     class Frame : public core::view::AnimDataModule::Frame {
     public:
@@ -123,6 +149,48 @@ protected:
          */
         bool LoadFrame(vislib::sys::File* file, unsigned int idx, UINT64 size, unsigned int version);
 
+        /**
+         * Loads only the chunks of a frame intersecting a region (version
+         * 1.4). Lists without chunk table are loaded completely.
+         *
+         * @param file The file stream to load from. The stream is assumed
+         *             to be at the correct location
+         * @param idx The zero-based index of the frame
+         * @param size The size of the frame data in bytes
+         * @param version File version, at least 104
+         * @param region The region of interest
+         *
+         * @return True on success
+         */
+        bool LoadFrameRegion(vislib::sys::File* file, unsigned int idx, UINT64 size, unsigned int version,
+            vislib::math::Cuboid<float> const& region);
+
+        /**
+         * Decodes the quantized particle lists of a loaded frame (version
+         * 1.5) into lists of VERTDATA_FLOAT_XYZ. The chunks of a list are
+         * decoded in parallel. Key frames replace the content of 'key',
+         * delta frames reference it.
+         *
+         * @param key     The grid indices of the last decoded key frame.
+         * @param loadKey Loads the key frame with the given index into
+         *                'key', may be empty for key frames.
+         * @param region  The region of interest or 'nullptr' to keep all
+         *                chunks.
+         *
+         * @return True on success
+         */
+        bool Decode(KeyFrame& key, std::function<bool(unsigned int)> const& loadKey,
+            vislib::math::Cuboid<float> const* region);
+
+        /**
+         * Answer the size of the loaded data.
+         *
+         * @return The size of the loaded data in bytes
+         */
+        inline SIZE_T GetSize(void) const {
+            return this->dat.GetSize();
+        }
+
         /**
          * Sets the data into the call
          *
@@ -181,6 +249,33 @@ protected:
      */
     bool filenameChanged(core::param::ParamSlot& slot);
 
+    /**
+     * Callback receiving the update of the region of interest parameters.
+     *
+     * @param slot The updated ParamSlot.
+     *
+     * @return Always 'true' to reset the dirty flag.
+     */
+    bool regionChanged(core::param::ParamSlot& slot);
+
+    /**
+     * Callback receiving the update of the bounding box override parameter.
+     *
+     * @param slot The updated ParamSlot.
+     *
+     * @return Always 'true' to reset the dirty flag.
+     */
+    bool overrideBBoxChanged(core::param::ParamSlot& slot);
+
+    /**
+     * Loads a key frame of a version 1.5 file into 'keyFrame'.
+     *
+     * @param idx The index of the key frame.
+     *
+     * @return 'true' on success, 'false' on failure.
+     */
+    bool loadKeyFrame(unsigned int idx);
+
     /**
      * Gets the data from the source.
      *
@@ -211,6 +306,15 @@ protected:
     /** Override local bbox */
     core::param::ParamSlot overrideBBoxSlot;
 
+    /** Loads only the chunks intersecting the region of interest */
+    core::param::ParamSlot regionSlot;
+
+    /** The minimum of the region of interest */
+    core::param::ParamSlot regionMinSlot;
+
+    /** The maximum of the region of interest */
+    core::param::ParamSlot regionMaxSlot;
+
     /** The slot for requesting data */
     core::CalleeSlot getData;
 
@@ -229,8 +333,26 @@ protected:
     /** file version */
     unsigned int fileVersion;
 
+    /** Flag whether the frames are loaded from the region of interest only */
+    bool useRegion;
+
+    /** The region of interest */
+    vislib::math::Cuboid<float> region;
+
+    /** The key frame referenced by delta frames, only used by the loader */
+    KeyFrame keyFrame;
+
     /** Data file load id counter */
     size_t data_hash;
+
+    /** The value of 'overrideBBoxSlot' */
+    bool overrideBBox;
+
+    /**
+     * Guards the file, the frame cache setup and the values derived from the
+     * parameters against the call functions
+     */
+    std::mutex stateLock;
 };
 
 
@@ -0,0 +1,124 @@
+/*
+ * MMPLDPositionCodec.cpp
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "io/MMPLDPositionCodec.h"
+#include "stdafx.h"
+
+#include "mmcore/utility/BlockBitPacker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace megamol::moldyn::io;
+using megamol::core::utility::BlockBitPacker;
+
+
+namespace {
+
+/** The largest magnitude of a grid index */
+const double indexLimit = 1073741824.0;
+
+} // namespace
+
+
+/*
+ * MMPLDPositionCodec::MakeGrid
+ */
+MMPLDPositionCodec::Grid MMPLDPositionCodec::MakeGrid(double const* lo, double const* hi, unsigned int bits) {
+    const double steps = static_cast<double>((1u << std::min(std::max(bits, 1u), MaxBits)) - 1);
+    Grid grid;
+    float largest = 0.0f;
+    for (int c = 0; c < 3; ++c) {
+        grid.origin[c] = static_cast<float>(lo[c]);
+        const float step = static_cast<float>((hi[c] - lo[c]) / steps);
+        grid.step[c] = (std::isfinite(step) && (step > 0.0f)) ? step : 0.0f;
+        largest = std::max(largest, grid.step[c]);
+    }
+    // flat boxes borrow the resolution of the other axes, so delta frames can represent motion
+    for (int c = 0; c < 3; ++c) {
+        if (grid.step[c] == 0.0f) {
+            grid.step[c] =
+                (largest > 0.0f) ? largest : static_cast<float>(std::max(std::fabs(lo[c]), 1.0) / steps);
+        }
+    }
+    return grid;
+}
+
+
+/*
+ * MMPLDPositionCodec::Quantize
+ */
+void MMPLDPositionCodec::Quantize(Grid const& grid, double const* pos, int32_t* q) {
+    for (int c = 0; c < 3; ++c) {
+        const double i = std::round((pos[c] - grid.origin[c]) / grid.step[c]);
+        q[c] = static_cast<int32_t>(std::isfinite(i) ? std::min(std::max(i, -indexLimit), indexLimit) : 0.0);
+    }
+}
+
+
+/*
+ * MMPLDPositionCodec::Encode
+ */
+void MMPLDPositionCodec::Encode(
+    Grid const& grid, int32_t const* q, int32_t const* ref, UINT64 cnt, std::vector<char>& out) {
+    std::vector<UINT64> values(3 * cnt);
+    std::vector<UINT8> widths(3 * BlockBitPacker::BlockCount(cnt));
+    for (UINT64 i = 0; i < 3 * cnt; ++i) {
+        values[i] = BlockBitPacker::ZigZag(static_cast<INT64>(q[i]) - ((ref != nullptr) ? ref[i] : 0));
+    }
+    const size_t size = BlockBitPacker::Measure(values.data(), cnt, 3, widths.data());
+
+    const size_t begin = out.size();
+    out.resize(begin + sizeof(Grid) + size);
+    std::memcpy(out.data() + begin, &grid, sizeof(Grid));
+    BlockBitPacker::Pack(values.data(), cnt, 3, widths.data(), size, out.data() + begin + sizeof(Grid));
+}
+
+
+/*
+ * MMPLDPositionCodec::Decode
+ */
+UINT64 MMPLDPositionCodec::Decode(
+    char const* in, UINT64 size, UINT64 cnt, int32_t const* ref, int32_t* q, char* pos, SIZE_T stride) {
+    if (size < sizeof(Grid)) {
+        return 0;
+    }
+    Grid grid;
+    std::memcpy(&grid, in, sizeof(Grid));
+
+    thread_local std::vector<int32_t> indices;
+    if (q == nullptr) {
+        indices.resize(3 * cnt);
+        q = indices.data();
+    }
+    const size_t packed = BlockBitPacker::Unpack(in + sizeof(Grid), size - sizeof(Grid), cnt, 3, q);
+    if (packed == 0) {
+        return 0;
+    }
+
+    if (ref != nullptr) {
+        // the differences wrap like the indices, so 32 bit arithmetic restores them
+#pragma omp simd
+        for (UINT64 i = 0; i < 3 * cnt; ++i) {
+            q[i] = static_cast<int32_t>(static_cast<UINT32>(q[i]) + static_cast<UINT32>(ref[i]));
+        }
+    }
+
+    if (pos != nullptr) {
+        for (int c = 0; c < 3; ++c) {
+            int32_t const* axis = q + c * cnt;
+            char* out = pos + c * sizeof(float);
+            for (UINT64 i = 0; i < cnt; ++i) {
+                const float v = grid.origin[c] + grid.step[c] * static_cast<float>(axis[i]);
+                std::memcpy(out + i * stride, &v, sizeof(float));
+            }
+        }
+    }
+    return sizeof(Grid) + packed;
+}
@@ -0,0 +1,110 @@
+/*
+ * MMPLDPositionCodec.h
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "vislib/types.h"
+
+
+namespace megamol {
+namespace moldyn {
+namespace io {
+
+
+/**
+ * Codec for the quantized particle positions of MMPLD 1.5 chunks.
+ *
+ * The positions of a chunk are quantized on a regular grid spanning the
+ * chunk bounds. The grid indices are either stored as they are (key frames)
+ * or as differences to the indices of the same particles in a reference
+ * frame (delta frames). The zigzag coded values of each axis are bit packed
+ * in blocks of 16 with one width byte per block, so slowly moving particles
+ * cost only a few bits. Blocks and chunks are independent and are unpacked
+ * with vectorized loops. The packing is done by BlockBitPacker, with the
+ * three axes as its streams.
+ *
+ * Layout of an encoded chunk with n particles:
+ *   float    grid origin [3]
+ *   float    grid step [3]
+ *   uint8    bit widths of the blocks of x, y and z [3 * ceil(n / 16)]
+ *   ...      packed values of x, y and z, padded by 8 zero bytes
+ */
+class MMPLDPositionCodec {
+public:
+    /** The largest supported number of bits per axis */
+    static const unsigned int MaxBits = 24;
+
+    /** The quantization grid of a chunk */
+    struct Grid {
+        float origin[3];
+        float step[3];
+    };
+
+    /**
+     * Answer the grid quantizing the positions within a box with 'bits' bits
+     * per axis.
+     *
+     * @param lo   The minimum of the box.
+     * @param hi   The maximum of the box.
+     * @param bits The number of bits per axis, at most 'MaxBits'.
+     *
+     * @return The grid.
+     */
+    static Grid MakeGrid(double const* lo, double const* hi, unsigned int bits);
+
+    /**
+     * Quantizes a position. Positions outside the grid bounds yield indices
+     * outside [0, 2^bits), which delta frames can still represent.
+     *
+     * @param grid The grid.
+     * @param pos  The position.
+     * @param q    Receives the grid indices.
+     */
+    static void Quantize(Grid const& grid, double const* pos, int32_t* q);
+
+    /**
+     * Encodes the grid indices of a chunk and appends them to 'out'.
+     *
+     * @param grid The grid of the chunk.
+     * @param q    The planar grid indices, all x, then all y, then all z.
+     * @param ref  The planar grid indices of the reference frame or
+     *             'nullptr' for a key frame.
+     * @param cnt  The number of particles.
+     * @param out  Receives the encoded chunk.
+     */
+    static void Encode(Grid const& grid, int32_t const* q, int32_t const* ref, UINT64 cnt, std::vector<char>& out);
+
+    /**
+     * Decodes a chunk.
+     *
+     * @param in     The encoded chunk.
+     * @param size   The number of bytes available at 'in'.
+     * @param cnt    The number of particles.
+     * @param ref    The planar grid indices of the reference frame or
+     *               'nullptr' for a key frame.
+     * @param q      Receives the planar grid indices, may be 'nullptr'.
+     * @param pos    Receives the positions as float triplets, may be
+     *               'nullptr' and need not be aligned.
+     * @param stride The distance of the positions in bytes.
+     *
+     * @return The size of the encoded chunk in bytes, 0 if the data is
+     *         malformed.
+     */
+    static UINT64 Decode(
+        char const* in, UINT64 size, UINT64 cnt, int32_t const* ref, int32_t* q, char* pos, SIZE_T stride);
+
+    MMPLDPositionCodec(void) = delete;
+};
+
+
+} /* end namespace io */
+} /* end namespace moldyn */
+} /* end namespace megamol */
@@ -9,6 +9,15 @@
 #include "mmcore/BoundingBoxes.h"
 #include "stdafx.h"
 #include <algorithm>
+#include <cfloat>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "mmcore/param/BoolParam.h"
 #include "mmcore/param/EnumParam.h"
@@ -18,9 +27,164 @@
 #include "mmcore/utility/sys/Thread.h"
 #include "vislib/String.h"
 #include "vislib/sys/FastFile.h"
+#include "vislib/sys/MemoryFile.h"
 
 namespace megamol::moldyn::io {
 
+namespace {
+
+/** Spreads the lower 21 bits of a value to every third bit */
+inline UINT64 spreadBits(UINT64 v) {
+    v &= 0x1fffff;
+    v = (v | (v << 32)) & 0x1f00000000ffffull;
+    v = (v | (v << 16)) & 0x1f0000ff0000ffull;
+    v = (v | (v << 8)) & 0x100f00f00f00f00full;
+    v = (v | (v << 4)) & 0x10c30c30c30c30c3ull;
+    v = (v | (v << 2)) & 0x1249249249249249ull;
+    return v;
+}
+
+/** Answer the position of a particle */
+inline void particlePosition(
+    geocalls::MultiParticleDataCall::Particles& points, UINT8 vt, unsigned int vo, UINT64 i, double* pos) {
+    const unsigned char* vp = static_cast<const unsigned char*>(points.GetVertexData()) + i * vo;
+    for (int c = 0; c < 3; ++c) {
+        switch (vt) {
+        case 3:
+            pos[c] = reinterpret_cast<const short*>(vp)[c];
+            break;
+        case 4:
+            pos[c] = reinterpret_cast<const double*>(vp)[c];
+            break;
+        default:
+            pos[c] = reinterpret_cast<const float*>(vp)[c];
+            break;
+        }
+    }
+}
+
+/**
+ * Computes the bounding boxes of the chunks including the radii for a given
+ * particle order and the number of particles per chunk.
+ */
+void chunkBounds(geocalls::MultiParticleDataCall::Particles& points, UINT8 vt, unsigned int vo,
+    std::vector<UINT64> const& order, std::vector<UINT64> const& chunkCnts, std::vector<float>& chunkBoxes) {
+    const INT64 chunkCnt = static_cast<INT64>(chunkCnts.size());
+    std::vector<UINT64> firsts(chunkCnts.size(), 0);
+    for (INT64 c = 1; c < chunkCnt; ++c) {
+        firsts[c] = firsts[c - 1] + chunkCnts[c - 1];
+    }
+    chunkBoxes.resize(6 * chunkCnt);
+    const float globalRad = points.GetGlobalRadius();
+#pragma omp parallel for
+    for (INT64 c = 0; c < chunkCnt; ++c) {
+        float* box = chunkBoxes.data() + 6 * c;
+        for (int d = 0; d < 3; ++d) {
+            box[d] = FLT_MAX;
+            box[d + 3] = -FLT_MAX;
+        }
+        for (UINT64 i = firsts[c]; i < firsts[c] + chunkCnts[c]; ++i) {
+            double pos[3];
+            particlePosition(points, vt, vo, order[i], pos);
+            const unsigned char* vp = static_cast<const unsigned char*>(points.GetVertexData()) + order[i] * vo;
+            const double rad = (vt == 2) ? reinterpret_cast<const float*>(vp)[3] : globalRad;
+            for (int d = 0; d < 3; ++d) {
+                box[d] = std::min(box[d], static_cast<float>(pos[d] - rad));
+                box[d + 3] = std::max(box[d + 3], static_cast<float>(pos[d] + rad));
+            }
+        }
+    }
+}
+
+/**
+ * Sorts the particles of a list along a Morton curve and splits them into
+ * chunks of 'chunkSize' consecutive particles. Answers the particle order
+ * and the chunk table, the particle count and the bounding box of each
+ * chunk including the radii.
+ */
+void buildChunks(geocalls::MultiParticleDataCall::Particles& points, UINT8 vt, unsigned int vo, UINT64 cnt,
+    UINT64 chunkSize, std::vector<UINT64>& order, std::vector<UINT64>& chunkCnts, std::vector<float>& chunkBoxes) {
+    double lo[3] = {DBL_MAX, DBL_MAX, DBL_MAX};
+    double hi[3] = {-DBL_MAX, -DBL_MAX, -DBL_MAX};
+    for (UINT64 i = 0; i < cnt; ++i) {
+        double pos[3];
+        particlePosition(points, vt, vo, i, pos);
+        for (int c = 0; c < 3; ++c) {
+            lo[c] = std::min(lo[c], pos[c]);
+            hi[c] = std::max(hi[c], pos[c]);
+        }
+    }
+
+    std::vector<std::pair<UINT64, UINT64>> keys(cnt);
+#pragma omp parallel for
+    for (INT64 i = 0; i < static_cast<INT64>(cnt); ++i) {
+        double pos[3];
+        particlePosition(points, vt, vo, i, pos);
+        UINT64 key = 0;
+        for (int c = 0; c < 3; ++c) {
+            const double ext = hi[c] - lo[c];
+            const UINT64 cell = (ext > 0.0) ? static_cast<UINT64>((pos[c] - lo[c]) / ext * 2097151.0) : 0;
+            key |= spreadBits(cell) << c;
+        }
+        keys[i] = std::make_pair(key, static_cast<UINT64>(i));
+    }
+    std::sort(keys.begin(), keys.end());
+    order.resize(cnt);
+    for (UINT64 i = 0; i < cnt; ++i) {
+        order[i] = keys[i].second;
+    }
+    keys.clear();
+    keys.shrink_to_fit();
+
+    const UINT64 chunkCnt = (cnt + chunkSize - 1) / chunkSize;
+    chunkCnts.resize(chunkCnt);
+    for (UINT64 c = 0; c < chunkCnt; ++c) {
+        chunkCnts[c] = std::min(chunkSize, cnt - c * chunkSize);
+    }
+    chunkBounds(points, vt, vo, order, chunkCnts, chunkBoxes);
+}
+
+/** Answer whether the positions of a list are quantized (version 1.5) */
+inline bool isQuantizable(geocalls::MultiParticleDataCall::Particles& points) {
+    switch (points.GetVertexDataType()) {
+    case geocalls::MultiParticleDataCall::Particles::VERTDATA_FLOAT_XYZ:
+    case geocalls::MultiParticleDataCall::Particles::VERTDATA_SHORT_XYZ:
+    case geocalls::MultiParticleDataCall::Particles::VERTDATA_DOUBLE_XYZ:
+        return points.GetCount() > 0;
+    default:
+        return false;
+    }
+}
+
+/**
+ * Answer the expected size of a serialized frame from the vertex and colour
+ * sizes of its lists, including the colours widened on writing. The memory
+ * file grows if the estimate is exceeded.
+ */
+SIZE_T frameSizeEstimate(geocalls::MultiParticleDataCall& data, UINT64 chunkSize) {
+    typedef geocalls::MultiParticleDataCall::Particles Particles;
+    SIZE_T size = 8;
+    for (unsigned int li = 0; li < data.GetParticleListCount(); ++li) {
+        Particles& points = data.AccessParticles(li);
+        const UINT64 cnt = points.GetCount();
+        const auto vt = points.GetVertexDataType();
+        const auto ct = points.GetColourDataType();
+        const UINT64 vs = Particles::VertexDataSize[vt];
+        UINT64 cs = Particles::ColorDataSize[ct];
+        if (vt == Particles::VERTDATA_NONE) {
+            cs = 0; // lists without positions have no colours
+        } else if (ct == Particles::COLDATA_UINT8_RGB) {
+            cs = 4; // written as UINT8_RGBA
+        } else if (vt == Particles::VERTDATA_DOUBLE_XYZ) {
+            cs = std::max<UINT64>(cs, 8); // aligned to the double positions
+        }
+        size += static_cast<SIZE_T>(128 + cnt * (vs + cs) + (cnt + chunkSize - 1) / chunkSize * 32);
+    }
+    return size;
+}
+
+} // namespace
+
 /*
  * :MMPLDWriter::MMPLDWriter
  */
@@ -31,7 +195,14 @@ MMPLDWriter::MMPLDWriter(void)
         , dataSlot("data", "The slot requesting the data to be written")
         , startFrameSlot("startFrame", "the first frame to write")
         , endFrameSlot("endFrame", "the last frame to write")
-        , subsetSlot("writeSubset", "use the specified start and end") {
+        , subsetSlot("writeSubset", "use the specified start and end")
+        , chunkSizeSlot("chunkSize", "The number of particles per spatial chunk (version 1.4)")
+        , quantizationBitsSlot("quantizationBits", "The number of bits per axis of quantized positions (version 1.5)")
+        , keyFrameIntervalSlot("keyFrameInterval",
+              "The distance of the key frames, the frames in between store position differences (version 1.5)")
+        , queueSizeSlot("writeQueueSize", "The number of serialized frames waiting to be written")
+        , keyFrame(0)
+        , keyLists() {
 
     this->filenameSlot << new core::param::FilePathParam(
         "", megamol::core::param::FilePathParam::Flag_File_ToBeCreatedWithRestrExts, {"mmpld"});
@@ -44,6 +215,8 @@ MMPLDWriter::MMPLDWriter(void)
 #endif
     verPar->SetTypePair(102, "1.2");
     verPar->SetTypePair(103, "1.3");
+    verPar->SetTypePair(104, "1.4");
+    verPar->SetTypePair(105, "1.5");
     this->versionSlot.SetParameter(verPar);
     this->MakeSlotAvailable(&this->versionSlot);
 
@@ -53,6 +226,14 @@ MMPLDWriter::MMPLDWriter(void)
     this->MakeSlotAvailable(&this->endFrameSlot);
     this->subsetSlot << new core::param::BoolParam(false);
     this->MakeSlotAvailable(&this->subsetSlot);
+    this->chunkSizeSlot << new core::param::IntParam(64 * 1024, 1);
+    this->MakeSlotAvailable(&this->chunkSizeSlot);
+    this->quantizationBitsSlot << new core::param::IntParam(16, 1, MMPLDPositionCodec::MaxBits);
+    this->MakeSlotAvailable(&this->quantizationBitsSlot);
+    this->keyFrameIntervalSlot << new core::param::IntParam(1, 1);
+    this->MakeSlotAvailable(&this->keyFrameIntervalSlot);
+    this->queueSizeSlot << new core::param::IntParam(4, 1);
+    this->MakeSlotAvailable(&this->queueSizeSlot);
 
     this->dataSlot.SetCompatibleCall<geocalls::MultiParticleDataCallDescription>();
     this->MakeSlotAvailable(&this->dataSlot);
@@ -179,11 +360,67 @@ bool MMPLDWriter::run(void) {
     }
 
     mpdc->Unlock();
-    for (UINT32 i = theStart; i < theEnd; i++) {
-        frameOffset = static_cast<UINT64>(file.Tell());
-        file.Seek(seekTable + (i - theStart) * 8);
-        ASSERT_WRITEOUT(&frameOffset, 8);
-        file.Seek(frameOffset);
+    this->keyFrame = 0;
+    this->keyLists.clear();
+
+    // the frames are serialized into memory here and written to the file by a second thread, so fetching and
+    // serializing the next frames overlaps with the output of the previous ones
+    const size_t queueSize = static_cast<size_t>(this->queueSizeSlot.Param<core::param::IntParam>()->Value());
+    const UINT64 chunkSize = static_cast<UINT64>(this->chunkSizeSlot.Param<core::param::IntParam>()->Value());
+    std::mutex queueLock;
+    std::condition_variable queueChanged;
+    std::deque<std::unique_ptr<SerializedFrame>> queue;
+    std::vector<std::unique_ptr<SerializedFrame>> spare;
+    std::vector<UINT64> frameOffsets;
+    frameOffsets.reserve(frameCnt + 1);
+    bool finished = false;
+    bool writeFailed = false;
+    std::thread output([&]() {
+        for (;;) {
+            std::unique_ptr<SerializedFrame> frame;
+            {
+                std::unique_lock<std::mutex> lock(queueLock);
+                queueChanged.wait(lock, [&]() { return !queue.empty() || finished; });
+                if (queue.empty()) {
+                    return;
+                }
+                frame = std::move(queue.front());
+                queue.pop_front();
+            }
+            queueChanged.notify_all();
+
+            const UINT64 offset = static_cast<UINT64>(file.Tell());
+            const bool written = (file.Write(frame->data, frame->size) == frame->size);
+            {
+                std::lock_guard<std::mutex> lock(queueLock);
+                frameOffsets.push_back(offset);
+                spare.push_back(std::move(frame));
+                writeFailed = !written;
+            }
+            queueChanged.notify_all();
+            if (!written) {
+                return;
+            }
+        }
+    });
+
+    bool success = true;
+    for (UINT32 i = theStart; success && (i < theEnd); i++) {
+        std::unique_ptr<SerializedFrame> frame;
+        {
+            std::unique_lock<std::mutex> lock(queueLock);
+            queueChanged.wait(lock, [&]() { return (queue.size() < queueSize) || writeFailed; });
+            if (writeFailed) {
+                break;
+            }
+            if (!spare.empty()) {
+                frame = std::move(spare.back());
+                spare.pop_back();
+            }
+        }
+        if (!frame) {
+            frame = std::make_unique<SerializedFrame>();
+        }
 
         Log::DefaultLog.WriteMsg(Log::LEVEL_INFO, "Started writing data frame %u\n", i);
 
@@ -193,13 +430,13 @@ bool MMPLDWriter::run(void) {
             mpdc->SetFrameID(i, true);
             if (!(*mpdc)(1)) {
                 Log::DefaultLog.WriteMsg(Log::LEVEL_ERROR, "Cannot request frame %u. Abort.\n", i);
-                file.Close();
-                return false;
+                success = false;
+                break;
             }
             if (!(*mpdc)(0)) {
                 Log::DefaultLog.WriteMsg(Log::LEVEL_ERROR, "Cannot get data frame %u. Abort.\n", i);
-                file.Close();
-                return false;
+                success = false;
+                break;
             }
             if (mpdc->FrameID() != i) {
                 if ((missCnt % 10) == 0) {
@@ -210,19 +447,52 @@ bool MMPLDWriter::run(void) {
                 vislib::sys::Thread::Sleep(static_cast<DWORD>(1 + std::max<int>(missCnt, 0) * 100));
             }
         } while (mpdc->FrameID() != i);
+        if (!success) {
+            break;
+        }
 
-        if (!this->writeFrame(file, *mpdc)) {
-            mpdc->Unlock();
+        // reserving the expected size avoids growing the buffer with every particle
+        frame->data.AssertSize(frameSizeEstimate(*mpdc, chunkSize));
+        vislib::sys::MemoryFile mem;
+        mem.Open(frame->data, vislib::sys::File::WRITE_ONLY);
+        if (!this->writeFrame(mem, *mpdc, i - theStart)) {
             Log::DefaultLog.WriteMsg(Log::LEVEL_ERROR, "Cannot write data frame %u. Abort.\n", i);
-            file.Close();
-            return false;
+            success = false;
+            break;
         }
+        frame->size = static_cast<SIZE_T>(mem.Tell());
+        mem.Close();
         mpdc->Unlock();
+
+        {
+            std::lock_guard<std::mutex> lock(queueLock);
+            queue.push_back(std::move(frame));
+        }
+        queueChanged.notify_all();
     }
 
+    {
+        std::lock_guard<std::mutex> lock(queueLock);
+        finished = true;
+    }
+    queueChanged.notify_all();
+    output.join();
+    mpdc->Unlock();
+    this->keyLists.clear();
+    if (writeFailed) {
+        Log::DefaultLog.WriteMsg(Log::LEVEL_ERROR, "Write error. Abort.\n");
+        success = false;
+    }
+    if (!success) {
+        file.Close();
+        return false;
+    }
+
+    // the offsets of all frames and the end of the last one
     frameOffset = static_cast<UINT64>(file.Tell());
-    file.Seek(seekTable + frameCnt * 8);
-    ASSERT_WRITEOUT(&frameOffset, 8);
+    frameOffsets.push_back(frameOffset);
+    file.Seek(seekTable);
+    ASSERT_WRITEOUT(frameOffsets.data(), 8 * frameOffsets.size());
 
     file.Seek(6); // set correct version to show that file is complete
     version = this->versionSlot.Param<core::param::EnumParam>()->Value();
@@ -250,7 +520,7 @@ bool MMPLDWriter::getCapabilities(core::DataWriterCtrlCall& call) {
 /*
  * MMPLDWriter::writeFrame
  */
-bool MMPLDWriter::writeFrame(vislib::sys::File& file, geocalls::MultiParticleDataCall& data) {
+bool MMPLDWriter::writeFrame(vislib::sys::File& file, geocalls::MultiParticleDataCall& data, UINT32 idx) {
 #define ASSERT_WRITEOUT(A, S)                                                   \
     if (file.Write((A), (S)) != (S)) {                                          \
         Log::DefaultLog.WriteMsg(Log::LEVEL_ERROR, "Write error %d", __LINE__); \
@@ -271,6 +541,21 @@ bool MMPLDWriter::writeFrame(vislib::sys::File& file, geocalls::MultiParticleDat
     UINT32 listCnt = data.GetParticleListCount();
     ASSERT_WRITEOUT(&listCnt, 4);
 
+    // 1.5: the frames between key frames store the position differences to the key frame
+    bool delta = false;
+    if (ver >= 105) {
+        const UINT32 interval = this->keyFrameIntervalSlot.Param<core::param::IntParam>()->Value();
+        delta = (idx > this->keyFrame) && (idx - this->keyFrame < interval) && (this->keyLists.size() == listCnt);
+        for (UINT32 li = 0; delta && (li < listCnt); li++) {
+            geocalls::MultiParticleDataCall::Particles& points = data.AccessParticles(li);
+            delta = (this->keyLists[li].cnt == (isQuantizable(points) ? points.GetCount() : 0));
+        }
+        if (!delta) {
+            this->keyFrame = idx;
+            this->keyLists.assign(listCnt, KeyList());
+        }
+    }
+
     for (UINT32 li = 0; li < listCnt; li++) {
         geocalls::MultiParticleDataCall::Particles& points = data.AccessParticles(li);
         UINT8 vt = 0, ct = 0;
@@ -343,10 +628,13 @@ bool MMPLDWriter::writeFrame(vislib::sys::File& file, geocalls::MultiParticleDat
         } else {
             ct = 0;
         }
-        ASSERT_WRITEOUT(&vt, 1);
+        // 1.5: quantized positions are stored as vertex type 5 and read as VERTDATA_FLOAT_XYZ
+        const bool quantized = (ver >= 105) && isQuantizable(points);
+        const UINT8 fileVt = quantized ? 5 : vt;
+        ASSERT_WRITEOUT(&fileVt, 1);
         if (ct == 1)
-            ct = 2;              // UINT8_RGB is unaligned and will never be written again.
-        if (vt == 4 && ct < 5) { // TODO: fragile if we add another color type beyond DOUBLE_I!
+            ct = 2;                             // UINT8_RGB is unaligned and will never be written again.
+        if (vt == 4 && ct < 5 && !quantized) { // TODO: fragile if we add another color type beyond DOUBLE_I!
             if (ct ==
                 3) { // VERTDATA_DOUBLE_XYZ needs COLDATA_DOUBLE_I instead of COLDATA_FLOAT_I to be aligned for modern renderers (NG and OPSRay)
                 UINT8 x = 7;
@@ -393,69 +681,165 @@ bool MMPLDWriter::writeFrame(vislib::sys::File& file, geocalls::MultiParticleDat
             ASSERT_WRITEOUT(points.GetBBox().PeekBounds(), 24);
         }
 
+        // 1.4: the particles are written in chunks of neighbouring particles, each with its bounding box
+        std::vector<UINT64> order;
+        std::vector<UINT64> chunkCnts;
+        if (ver >= 104) {
+            std::vector<float> chunkBoxes;
+            if (quantized && delta) {
+                // the particles keep the order and the chunks of the key frame
+                order = this->keyLists[li].order;
+                chunkCnts = this->keyLists[li].chunkCnts;
+                chunkBounds(points, vt, vo, order, chunkCnts, chunkBoxes);
+            } else if (cnt > 0) {
+                buildChunks(points, vt, vo, cnt, this->chunkSizeSlot.Param<core::param::IntParam>()->Value(), order,
+                    chunkCnts, chunkBoxes);
+            }
+            UINT32 chunkCnt = static_cast<UINT32>(chunkCnts.size());
+            ASSERT_WRITEOUT(&chunkCnt, 4);
+            for (UINT32 ci = 0; ci < chunkCnt; ++ci) {
+                ASSERT_WRITEOUT(&chunkCnts[ci], 8);
+                ASSERT_WRITEOUT(chunkBoxes.data() + 6 * ci, 24);
+            }
+        }
+        auto const particle = [&order](UINT64 i) { return order.empty() ? i : order[i]; };
+
+        if (quantized) {
+            KeyList& key = this->keyLists[li];
+            if (!delta) {
+                key.cnt = cnt;
+                key.order = order;
+                key.chunkCnts = chunkCnts;
+                key.grids.resize(chunkCnts.size());
+                key.q.resize(3 * cnt);
+            }
+            const INT64 chunkCnt = static_cast<INT64>(chunkCnts.size());
+            std::vector<UINT64> firsts(chunkCnts.size(), 0);
+            for (INT64 c = 1; c < chunkCnt; ++c) {
+                firsts[c] = firsts[c - 1] + chunkCnts[c - 1];
+            }
+            const unsigned int bits = this->quantizationBitsSlot.Param<core::param::IntParam>()->Value();
+            const unsigned char* cb = static_cast<const unsigned char*>(points.GetColourData());
+
+            // the chunks are encoded independently, each followed by its colours
+            std::vector<std::vector<char>> chunks(chunkCnts.size());
+#pragma omp parallel for
+            for (INT64 c = 0; c < chunkCnt; ++c) {
+                const UINT64 first = firsts[c];
+                const UINT64 n = chunkCnts[c];
+                std::vector<double> pos(3 * n);
+                for (UINT64 i = 0; i < n; ++i) {
+                    particlePosition(points, vt, vo, order[first + i], pos.data() + 3 * i);
+                }
+                if (!delta) {
+                    double lo[3] = {DBL_MAX, DBL_MAX, DBL_MAX};
+                    double hi[3] = {-DBL_MAX, -DBL_MAX, -DBL_MAX};
+                    for (UINT64 i = 0; i < 3 * n; ++i) {
+                        lo[i % 3] = std::min(lo[i % 3], pos[i]);
+                        hi[i % 3] = std::max(hi[i % 3], pos[i]);
+                    }
+                    key.grids[c] = MMPLDPositionCodec::MakeGrid(lo, hi, bits);
+                }
+                std::vector<int32_t> deltaQ(delta ? 3 * n : 0);
+                int32_t* q = delta ? deltaQ.data() : key.q.data() + 3 * first;
+                for (UINT64 i = 0; i < n; ++i) {
+                    int32_t t[3];
+                    MMPLDPositionCodec::Quantize(key.grids[c], pos.data() + 3 * i, t);
+                    q[i] = t[0];
+                    q[n + i] = t[1];
+                    q[2 * n + i] = t[2];
+                }
+                MMPLDPositionCodec::Encode(
+                    key.grids[c], q, delta ? key.q.data() + 3 * first : nullptr, n, chunks[c]);
+                if (ct != 0) {
+                    for (UINT64 i = 0; i < n; ++i) {
+                        const char* cp = reinterpret_cast<const char*>(cb + order[first + i] * co);
+                        chunks[c].insert(chunks[c].end(), cp, cp + cs);
+                        if (cs == 3) {
+                            chunks[c].push_back(static_cast<char>(alpha));
+                        }
+                    }
+                }
+            }
+
+            UINT8 encHead[8] = {static_cast<UINT8>(bits), static_cast<UINT8>(delta ? 1 : 0), 0, 0};
+            std::memcpy(encHead + 4, &this->keyFrame, 4);
+            ASSERT_WRITEOUT(encHead, 8);
+            for (INT64 c = 0; c < chunkCnt; ++c) {
+                UINT64 chunkSize = chunks[c].size();
+                ASSERT_WRITEOUT(&chunkSize, 8);
+            }
+            for (INT64 c = 0; c < chunkCnt; ++c) {
+                ASSERT_WRITEOUT(chunks[c].data(), chunks[c].size());
+            }
+            continue;
+        }
+
         if (vt == 0)
             continue;
-        const unsigned char* vp = static_cast<const unsigned char*>(points.GetVertexData());
-        const unsigned char* cp = static_cast<const unsigned char*>(points.GetColourData());
+        const unsigned char* vb = static_cast<const unsigned char*>(points.GetVertexData());
+        const unsigned char* cb = static_cast<const unsigned char*>(points.GetColourData());
+        const unsigned char* vp = nullptr;
+        const unsigned char* cp = nullptr;
         if (vt == 4 && ct < 5) {
             switch (points.GetColourDataType()) {
             case geocalls::MultiParticleDataCall::Particles::COLDATA_NONE: {
                 auto col = points.GetGlobalColour();
                 uint16_t colNew[4] = {col[0] * 257, col[1] * 257, col[2] * 257, col[3] * 257};
                 for (UINT64 i = 0; i < cnt; ++i) {
+                    vp = vb + particle(i) * vo;
                     ASSERT_WRITEOUT(vp, vs);
-                    vp += vo;
                     ASSERT_WRITEOUT(colNew, 8);
                 }
             } break;
             case geocalls::MultiParticleDataCall::Particles::COLDATA_UINT8_RGB: {
                 uint16_t colNew[4];
                 for (UINT64 i = 0; i < cnt; ++i) {
+                    vp = vb + particle(i) * vo;
+                    cp = cb + particle(i) * co;
                     ASSERT_WRITEOUT(vp, vs);
-                    vp += vo;
                     colNew[0] = cp[0] * 257;
                     colNew[1] = cp[1] * 257;
                     colNew[2] = cp[2] * 257;
                     colNew[3] = 65535;
                     ASSERT_WRITEOUT(colNew, 8);
-                    cp += co;
                 }
             } break;
             case geocalls::MultiParticleDataCall::Particles::COLDATA_UINT8_RGBA: {
                 uint16_t colNew[4];
                 for (UINT64 i = 0; i < cnt; ++i) {
+                    vp = vb + particle(i) * vo;
+                    cp = cb + particle(i) * co;
                     ASSERT_WRITEOUT(vp, vs);
-                    vp += vo;
                     colNew[0] = cp[0] * 257;
                     colNew[1] = cp[1] * 257;
                     colNew[2] = cp[2] * 257;
                     colNew[3] = cp[3] * 257;
                     ASSERT_WRITEOUT(colNew, 8);
-                    cp += co;
                 }
             } break;
             case geocalls::MultiParticleDataCall::Particles::COLDATA_FLOAT_I: {
                 double iNew;
                 for (UINT64 i = 0; i < cnt; ++i) {
+                    vp = vb + particle(i) * vo;
+                    cp = cb + particle(i) * co;
                     ASSERT_WRITEOUT(vp, vs);
-                    vp += vo;
                     iNew = *(reinterpret_cast<const float*>(cp));
                     ASSERT_WRITEOUT(&iNew, 8);
-                    cp += co;
                 }
             } break;
             case geocalls::MultiParticleDataCall::Particles::COLDATA_FLOAT_RGB: {
                 uint16_t colNew[4];
                 for (UINT64 i = 0; i < cnt; ++i) {
+                    vp = vb + particle(i) * vo;
+                    cp = cb + particle(i) * co;
                     ASSERT_WRITEOUT(vp, vs);
-                    vp += vo;
                     const auto* col = reinterpret_cast<const float*>(cp);
                     colNew[0] = col[0] * 65535.0f;
                     colNew[1] = col[1] * 65535.0f;
                     colNew[2] = col[2] * 65535.0f;
                     colNew[3] = 65535.0f;
                     ASSERT_WRITEOUT(colNew, 8);
-                    cp += co;
                 }
             } break;
             default:
@@ -465,15 +849,15 @@ bool MMPLDWriter::writeFrame(vislib::sys::File& file, geocalls::MultiParticleDat
             }
         } else {
             for (UINT64 i = 0; i < cnt; i++) {
+                vp = vb + particle(i) * vo;
                 ASSERT_WRITEOUT(vp, vs);
-                vp += vo;
                 if (ct != 0) {
+                    cp = cb + particle(i) * co;
                     ASSERT_WRITEOUT(cp, cs);
                     // warning: this only works since only one format is 3 bytes long, the illegal ct = 1
                     if (cs == 3) { // the unaligned ct == 1, UINT8_RGB, will be silently upgraded to ct 2 / cs 4
                         ASSERT_WRITEOUT(&alpha, 1);
                     }
-                    cp += co;
                 }
             }
         }
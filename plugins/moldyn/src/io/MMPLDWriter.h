@@ -7,10 +7,14 @@
 
 #pragma once
 
+#include <vector>
+
 #include "geometry_calls/MultiParticleDataCall.h"
+#include "io/MMPLDPositionCodec.h"
 #include "mmcore/AbstractDataWriter.h"
 #include "mmcore/CallerSlot.h"
 #include "mmcore/param/ParamSlot.h"
+#include "vislib/RawStorage.h"
 #include "vislib/sys/File.h"
 
 
@@ -99,10 +103,38 @@ private:
      *
      * @param file The output data file
      * @param data The data of the current frame
+     * @param idx The zero-based index of the frame in the file
      *
      * @return True on success
      */
-    bool writeFrame(vislib::sys::File& file, geocalls::MultiParticleDataCall& data);
+    bool writeFrame(vislib::sys::File& file, geocalls::MultiParticleDataCall& data, UINT32 idx);
+
+    /** The state of a particle list in the last key frame (version 1.5) */
+    struct KeyList {
+        /** The number of particles, 0 if the list is not quantized */
+        UINT64 cnt = 0;
+
+        /** The order of the particles in the file */
+        std::vector<UINT64> order;
+
+        /** The number of particles per chunk */
+        std::vector<UINT64> chunkCnts;
+
+        /** The quantization grids of the chunks */
+        std::vector<MMPLDPositionCodec::Grid> grids;
+
+        /** The planar grid indices of the particles, chunk by chunk */
+        std::vector<int32_t> q;
+    };
+
+    /** A frame serialized into memory, waiting to be written to the file */
+    struct SerializedFrame {
+        /** The buffer holding the frame */
+        vislib::RawStorage data;
+
+        /** The size of the frame in bytes */
+        SIZE_T size = 0;
+    };
 
     /** The file name of the file to be written */
     core::param::ParamSlot filenameSlot;
@@ -114,8 +146,26 @@ private:
     core::param::ParamSlot endFrameSlot;
     core::param::ParamSlot subsetSlot;
 
+    /** The number of particles per spatial chunk (version 1.4) */
+    core::param::ParamSlot chunkSizeSlot;
+
+    /** The number of bits per axis of quantized positions (version 1.5) */
+    core::param::ParamSlot quantizationBitsSlot;
+
+    /** The distance of the key frames, the frames between store differences (version 1.5) */
+    core::param::ParamSlot keyFrameIntervalSlot;
+
+    /** The number of serialized frames waiting to be written */
+    core::param::ParamSlot queueSizeSlot;
+
     /** The slot asking for data */
     core::CallerSlot dataSlot;
+
+    /** The index of the last key frame */
+    UINT32 keyFrame;
+
+    /** The particle lists of the last key frame */
+    std::vector<KeyList> keyLists;
 };
 
 
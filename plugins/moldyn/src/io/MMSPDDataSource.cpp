@@ -7,31 +7,34 @@
 
 #include "io/MMSPDDataSource.h"
 #include "geometry_calls/MultiParticleDataCall.h"
+#include "io/ASCIIFieldScanner.h"
 #include "mmcore/CoreInstance.h"
+#include "mmcore/param/BoolParam.h"
 #include "mmcore/param/FilePathParam.h"
 #include "mmcore/utility/log/Log.h"
-#include "mmcore/utility/sys/ASCIIFileBuffer.h"
 #include "mmcore/utility/sys/SystemInformation.h"
 #include "stdafx.h"
-#include "vislib/ArrayAllocator.h"
 #include "vislib/MissingImplementationException.h"
-#include "vislib/PtrArray.h"
 #include "vislib/RawStorageWriter.h"
-#include "vislib/SmartPtr.h"
 #include "vislib/String.h"
 #include "vislib/StringTokeniser.h"
 #include "vislib/UTF8Encoder.h"
 #include "vislib/VersionNumber.h"
+#include "vislib/forceinline.h"
 #include "vislib/math/mathfunctions.h"
 #include "vislib/memutils.h"
 #include "vislib/sys/AutoLock.h"
 #include "vislib/sys/File.h"
-#include "vislib/sys/MemoryFile.h"
 #include "vislib/sys/sysfunctions.h"
 #include "vislib/utils.h"
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+#include <vector>
 
 using namespace megamol;
 using namespace megamol::moldyn::io;
+using namespace megamol::moldyn::io::scanner;
 
 
 /* defines for the frame cache size */
@@ -42,6 +45,176 @@ using namespace megamol::moldyn::io;
 // factor multiplied to the frame size for estimating the overhead to the pure data.
 #define CACHE_FRAME_FACTOR 1.2f
 
+/* defines for the parallel frame decoding */
+// number of bytes of particle records decoded per chunk
+#define DECODE_CHUNK_SIZE (1 << 20)
+// maximum number of chunks per text frame
+#define DECODE_CHUNK_COUNT_MAX 256
+
+/* defines for the frame index cache file */
+// the file name extension appended to the data file name
+#define FRAME_INDEX_CACHE_EXT ".frameidx"
+// the file format marker
+#define FRAME_INDEX_CACHE_MAGIC "MMSPDIDX"
+// the file format version
+#define FRAME_INDEX_CACHE_VERSION 1
+
+
+namespace {
+
+/** A run of consecutive particles of the same type */
+typedef std::pair<UINT32, UINT64> TypeRun;
+
+/** A chunk of consecutive particle records of a frame */
+typedef struct _frame_chunk_t {
+    const char* begin;              //< first byte of the first record
+    const char* end;                //< first byte behind the chunk
+    UINT64 count;                   //< number of records in the chunk
+    std::vector<UINT64> typeCount;  //< number of records of each type
+    std::vector<UINT64> typeOffset; //< index of the first record of each type in the particle data
+    std::vector<TypeRun> runs;      //< the types of the records, run-length encoded
+    const char* error;              //< error message or NULL
+} FrameChunk;
+
+/**
+ * Answers the 32 bit value at 'p', optionally with reversed byte order.
+ */
+VISLIB_FORCEINLINE UINT32 readUInt32(const char* p, bool swap) {
+    UINT32 v;
+    ::memcpy(&v, p, 4);
+#ifdef _MSC_VER
+    return swap ? _byteswap_ulong(v) : v;
+#else  /* _MSC_VER */
+    return swap ? __builtin_bswap32(v) : v;
+#endif /* _MSC_VER */
+}
+
+/**
+ * Answers the 64 bit value at 'p', optionally with reversed byte order.
+ */
+VISLIB_FORCEINLINE UINT64 readUInt64(const char* p, bool swap) {
+    UINT64 v;
+    ::memcpy(&v, p, 8);
+#ifdef _MSC_VER
+    return swap ? _byteswap_uint64(v) : v;
+#else  /* _MSC_VER */
+    return swap ? __builtin_bswap64(v) : v;
+#endif /* _MSC_VER */
+}
+
+/**
+ * Appends 'cnt' particles of type 'type' to a run-length encoded type
+ * sequence.
+ */
+VISLIB_FORCEINLINE void appendTypeRun(std::vector<TypeRun>& runs, UINT32 type, UINT64 cnt) {
+    if (!runs.empty() && (runs.back().first == type)) {
+        runs.back().second += cnt;
+    } else {
+        runs.push_back(TypeRun(type, cnt));
+    }
+}
+
+/**
+ * Answers a chunk without records starting at 'begin'.
+ */
+FrameChunk emptyChunk(const char* begin, SIZE_T typeCnt) {
+    FrameChunk chunk;
+    chunk.begin = begin;
+    chunk.end = begin;
+    chunk.count = 0;
+    chunk.typeCount.assign(typeCnt, 0);
+    chunk.error = NULL;
+    return chunk;
+}
+
+/**
+ * Throws the first error reported by any chunk.
+ */
+void checkChunks(const std::vector<FrameChunk>& chunks) {
+    for (const FrameChunk& chunk : chunks) {
+        if (chunk.error != NULL) {
+            throw vislib::Exception(chunk.error, __FILE__, __LINE__);
+        }
+    }
+}
+
+/**
+ * Answers the field types of all particle types.
+ */
+std::vector<std::vector<MMSPDHeader::Field::TypeID>> fieldTypes(const MMSPDHeader& header) {
+    std::vector<std::vector<MMSPDHeader::Field::TypeID>> types(header.GetTypes().Count());
+    for (SIZE_T ti = 0; ti < types.size(); ti++) {
+        const MMSPDHeader::TypeDefinition& type = header.GetTypes()[ti];
+        for (SIZE_T fi = 0; fi < type.GetFields().Count(); fi++) {
+            types[ti].push_back(type.GetFields()[fi].GetType());
+        }
+    }
+    return types;
+}
+
+/**
+ * Assigns the position in the particle data to the records of each chunk
+ * and allocates the particle data of all types.
+ *
+ * @param chunks The chunks with their counts of records per type.
+ * @param header The data set header.
+ * @param data The frame data receiving the particles.
+ * @param outTypeData Receives the particle data of each type.
+ *
+ * @return The size of a particle in the particle data of each type.
+ */
+std::vector<SIZE_T> allocateParticles(std::vector<FrameChunk>& chunks, const MMSPDHeader& header,
+    MMSPDFrameData& data, std::vector<char*>& outTypeData) {
+    const SIZE_T typeCnt = header.GetTypes().Count();
+    std::vector<UINT64> total(typeCnt, 0);
+    for (FrameChunk& chunk : chunks) {
+        chunk.typeOffset = total;
+        for (SIZE_T ti = 0; ti < typeCnt; ti++) {
+            total[ti] += chunk.typeCount[ti];
+        }
+    }
+
+    std::vector<SIZE_T> stride(typeCnt);
+    outTypeData.resize(typeCnt);
+    for (SIZE_T ti = 0; ti < typeCnt; ti++) {
+        // TODO: decide whether to ignore IDs or don't! (current: don't, interleave with pos)
+        stride[ti] = header.GetTypes()[ti].GetFields().Count() * sizeof(float) + (header.HasIDs() ? 8 : 0);
+        data.Data()[ti].Data().EnforceSize(static_cast<SIZE_T>(total[ti]) * stride[ti]);
+        outTypeData[ti] = data.Data()[ti].Data().As<char>();
+    }
+    return stride;
+}
+
+/**
+ * Stores the type sequence of all chunks as index reconstruction data, i.e.
+ * as pairs of RLE-encoded type and particle count.
+ */
+void storeIndexReconstruction(const std::vector<FrameChunk>& chunks, vislib::RawStorage& data) {
+    std::vector<TypeRun> runs;
+    for (const FrameChunk& chunk : chunks) {
+        for (const TypeRun& run : chunk.runs) {
+            appendTypeRun(runs, run.first, run.second);
+        }
+    }
+
+    vislib::RawStorageWriter wrtr(data);
+    unsigned char dat[10];
+    unsigned int datLen;
+    for (const TypeRun& run : runs) {
+        datLen = 10;
+        if (!vislib::UIntRLEEncode(dat, datLen, run.first))
+            throw vislib::Exception(__FILE__, __LINE__);
+        wrtr.Write(dat, datLen);
+        datLen = 10;
+        if (!vislib::UIntRLEEncode(dat, datLen, run.second))
+            throw vislib::Exception(__FILE__, __LINE__);
+        wrtr.Write(dat, datLen);
+    }
+    data.EnforceSize(wrtr.End(), true);
+}
+
+} /* end anonymous namespace */
+
 /*****************************************************************************/
 
 /*
@@ -65,15 +238,10 @@ MMSPDDataSource::Frame::~Frame() {
 /*
  * MMSPDDataSource::Frame::LoadFrame
  */
-bool MMSPDDataSource::Frame::LoadFrame(vislib::sys::File* file, unsigned int idx, UINT64 size,
+bool MMSPDDataSource::Frame::LoadFrame(const char* begin, const char* end, unsigned int idx,
     const MMSPDHeader& header, bool isBinary, bool isBigEndian) {
     this->frame = idx;
-    char* buf = new char[static_cast<SIZE_T>(size)];
     try {
-        if (file->Read(buf, size) != size) {
-            throw vislib::Exception("Frame data truncated", __FILE__, __LINE__);
-        }
-
         // prepare the frame object
         this->Clear();
         SIZE_T typeCnt = header.GetTypes().Count();
@@ -211,14 +379,13 @@ bool MMSPDDataSource::Frame::LoadFrame(vislib::sys::File* file, unsigned int idx
         }
 
         // now actually load the data
+        if (typeCnt == 0) {
+            return true; // no particle types, nothing to load
+        }
         if (isBinary) {
-            if (!isBigEndian) {
-                this->loadFrameBinary(buf, size, header);
-            } else {
-                this->loadFrameBinaryBE(buf, size, header);
-            }
+            this->loadFrameBinary(begin, end, header, isBigEndian);
         } else {
-            this->loadFrameText(buf, size, header);
+            this->loadFrameText(begin, end, header);
         }
 
         for (SIZE_T ti = 0; ti < typeCnt; ti++) {
@@ -238,13 +405,11 @@ bool MMSPDDataSource::Frame::LoadFrame(vislib::sys::File* file, unsigned int idx
         }
 
     } catch (...) {
-        delete[] buf;
         this->Clear();
         throw;
         //return false;
     }
 
-    delete[] buf;
     return true;
 }
 
@@ -476,306 +641,278 @@ void MMSPDDataSource::Frame::SetDirData(geocalls::MultiParticleDataCall& call, c
 /*
  * MMSPDDataSource::Frame::loadFrameText
  */
-void MMSPDDataSource::Frame::loadFrameText(char* buffer, UINT64 size, const MMSPDHeader& header) {
+void MMSPDDataSource::Frame::loadFrameText(const char* begin, const char* end, const MMSPDHeader& header) {
     // We don't have to brother with unicode here, because there is no string data allowed.
     // All characters must be white space, line breaks, '>' and characters forming numbers (digits, dots, plus, minus, 'e').
-    vislib::sys::MemoryFile mem;
-    mem.Open(static_cast<void*>(buffer), static_cast<SIZE_T>(size), vislib::sys::File::READ_ONLY);
-    vislib::sys::ASCIIFileBuffer txt(vislib::sys::ASCIIFileBuffer::PARSING_WORDS);
-    if (!txt.LoadFile(mem))
-        throw vislib::Exception(__FILE__, __LINE__);
-
-    if (txt.Count() <= 0)
-        throw vislib::Exception("Unable to load frame data", __FILE__, __LINE__);
-    if (txt.Line(0).Count() < 2)
-        throw vislib::Exception("Illegal time frame marker", __FILE__, __LINE__);
-    UINT64 partCnt = vislib::CharTraitsA::ParseUInt64(txt.Line(0).Word(1));
-    if (txt.Count() < partCnt + 1)
-        throw vislib::Exception("Data frame truncated", __FILE__, __LINE__);
+    const SIZE_T typeCnt = header.GetTypes().Count();
+    const bool hasIDs = header.HasIDs();
 
-    SIZE_T typeCnt = header.GetTypes().Count();
-    vislib::PtrArray<vislib::RawStorageWriter> typeData;
-    typeData.SetCount(typeCnt);
-    for (SIZE_T i = 0; i < typeCnt; i++) {
-        typeData[i] = new vislib::RawStorageWriter(this->Data()[i].Data());
-        typeData[i]->SetIncrement(vislib::math::Max<SIZE_T>(
-            static_cast<SIZE_T>((header.GetTypes()[i].GetFields().Count() * sizeof(float) * partCnt) / (2 * typeCnt)),
-            1024 * 1024));
-    }
-    vislib::RawStorageWriter idxRecDat(this->IndexReconstructionData());
-    if (typeCnt > 1)
-        idxRecDat.SetIncrement(vislib::math::Max<SIZE_T>(static_cast<SIZE_T>(partCnt / 10), 10 * 1024));
-    UINT32 irdLastType = static_cast<UINT32>(typeCnt);
-    UINT64 irdLastCount;
-
-    SIZE_T type = 0;
-    for (UINT64 pi = 0; pi < partCnt; pi++) {
-        const vislib::sys::ASCIIFileBuffer::LineBuffer& line = txt.Line(static_cast<SIZE_T>(1 + pi));
-        unsigned int off = 0;
-        if (typeCnt > 1) {
-            if (header.HasIDs()) {
-                if (line.Count() < 2)
-                    throw vislib::Exception("line truncated", __FILE__, __LINE__);
-                type = static_cast<SIZE_T>(vislib::CharTraitsA::ParseInt(line.Word(1)));
-                if (type >= typeCnt)
-                    throw vislib::Exception("Illegal type encountered", __FILE__, __LINE__);
-                typeData[type]->Write(vislib::CharTraitsA::ParseUInt64(line.Word(0)));
-                off = 2;
-            } else {
-                if (line.Count() < 1)
-                    throw vislib::Exception("line truncated", __FILE__, __LINE__);
-                type = static_cast<SIZE_T>(vislib::CharTraitsA::ParseInt(line.Word(0)));
-                if (type >= typeCnt)
-                    throw vislib::Exception("Illegal type encountered", __FILE__, __LINE__);
-                off = 1;
-            }
-        } else if (header.HasIDs()) {
-            // type remains 0
-            if (line.Count() < 1)
-                throw vislib::Exception("line truncated", __FILE__, __LINE__);
-            typeData[type]->Write(vislib::CharTraitsA::ParseUInt64(line.Word(0)));
-            off = 1;
+    // time frame marker: '>' followed by the number of particles
+    const char* line = lineEnd(begin, end);
+    const char* p = skipBlanks(begin, line);
+    if ((p == line) || (*p != '>'))
+        throw vislib::Exception("Illegal time frame marker", __FILE__, __LINE__);
+    p = skipBlanks(p + 1, line);
+    if (p == line)
+        throw vislib::Exception("Illegal time frame marker", __FILE__, __LINE__);
+    uint64_t partCnt;
+    parseUInt64Field(p, line, partCnt);
+    begin = (line < end) ? line + 1 : end;
+
+    // split the particle lines into chunks starting at line boundaries
+    const SIZE_T len = static_cast<SIZE_T>(end - begin);
+    const int chunkCnt = static_cast<int>(
+        vislib::math::Max<SIZE_T>(1, vislib::math::Min<SIZE_T>(DECODE_CHUNK_COUNT_MAX, len / DECODE_CHUNK_SIZE)));
+    std::vector<FrameChunk> chunks;
+    const char* chunkBegin = begin;
+    for (int c = 0; c < chunkCnt; c++) {
+        chunks.push_back(emptyChunk(chunkBegin, typeCnt));
+        if (c + 1 < chunkCnt) {
+            p = lineEnd(vislib::math::Max(chunkBegin, begin + (len / chunkCnt) * (c + 1)), end);
+            chunkBegin = (p < end) ? p + 1 : end;
+        } else {
+            chunkBegin = end;
         }
+        chunks.back().end = chunkBegin;
+    }
 
-        this->addIndexForReconstruction(
-            static_cast<UINT32>(type), idxRecDat, this->IndexReconstructionData(), irdLastType, irdLastCount);
-
-        SIZE_T fieldCnt = header.GetTypes()[type].GetFields().Count();
-        if (line.Count() < fieldCnt + off)
-            throw vislib::Exception("line truncated", __FILE__, __LINE__);
-
-        for (SIZE_T fi = 0; fi < fieldCnt; fi++) {
-            //float val = static_cast<float>(vislib::CharTraitsA::ParseDouble(line.Word(off + this->GetData()[type].FieldMap()[fi])));
-            //if (header.GetTypes()[type].GetFields()[this->GetData()[type].FieldMap()[fi]].GetType() ==
-            //    MMSPDHeader::Field::TYPE_BYTE) {
-            //    val /= 255.0f;
-            //}
-            float val = vislib::CharTraitsA::ParseDouble(line.Word(off + fi));
-            if (header.GetTypes()[type].GetFields()[fi].GetType() == MMSPDHeader::Field::TYPE_BYTE) {
-                val /= 255.0f;
-            }
-
-            //megamol::core::utility::log::Log::DefaultLog.WriteInfo("read: %f", val);
-            typeData[type]->Write(val);
+    // first pass: count the lines of each chunk
+#pragma omp parallel for
+    for (int c = 0; c < chunkCnt; c++) {
+        UINT64 cnt = 0;
+        for (const char* l = chunks[c].begin; l < chunks[c].end; l = lineEnd(l, chunks[c].end) + 1) {
+            cnt++;
         }
+        chunks[c].count = cnt;
     }
-
-    for (SIZE_T i = 0; i < typeCnt; i++) {
-        this->Data()[i].Data().EnforceSize(typeData[i]->End(), true);
+    UINT64 remaining = partCnt; // only the first lines hold particles
+    for (FrameChunk& chunk : chunks) {
+        chunk.count = vislib::math::Min(chunk.count, remaining);
+        remaining -= chunk.count;
     }
-    this->IndexReconstructionData().EnforceSize(idxRecDat.End(), true);
-}
-
+    if (remaining > 0)
+        throw vislib::Exception("Data frame truncated", __FILE__, __LINE__);
 
-/*
- * MMSPDDataSource::Frame::loadFrameBinary
- */
-void MMSPDDataSource::Frame::loadFrameBinary(char* buffer, UINT64 size, const MMSPDHeader& header) {
-    UINT64& partCnt = *reinterpret_cast<UINT64*>(&buffer[0]);
-    SIZE_T pos = 8;
-    SIZE_T typeCnt = header.GetTypes().Count();
-    vislib::PtrArray<vislib::RawStorageWriter> typeData;
-    typeData.SetCount(typeCnt);
-    SIZE_T valuesCount = 0;
-    for (SIZE_T i = 0; i < typeCnt; i++) {
-        typeData[i] = new vislib::RawStorageWriter(this->Data()[i].Data());
-        valuesCount = vislib::math::Max(valuesCount, header.GetTypes()[i].GetFields().Count());
-        typeData[i]->SetIncrement(vislib::math::Max<SIZE_T>(
-            static_cast<SIZE_T>((header.GetTypes()[i].GetFields().Count() * sizeof(float) * partCnt) / (2 * typeCnt)),
-            1024 * 1024));
-    }
-    vislib::SmartPtr<float, vislib::ArrayAllocator<float>> values = new float[valuesCount];
-    vislib::RawStorageWriter idxRecDat(this->IndexReconstructionData());
-    if (typeCnt > 1)
-        idxRecDat.SetIncrement(vislib::math::Max<SIZE_T>(static_cast<SIZE_T>(partCnt / 10), 10 * 1024));
-    UINT32 irdLastType = static_cast<UINT32>(typeCnt);
-    UINT64 irdLastCount;
-
-    SIZE_T type = 0;
-    for (UINT64 pi = 0; pi < partCnt; pi++) {
-
-        // TODO: decide whether to ignore IDs or don't! (current: don't, interleave with pos) [#128]
-        if (header.HasIDs())
-            pos += 8;
-
-        if (typeCnt > 1) {
-            type = *reinterpret_cast<UINT32*>(&buffer[pos]);
-            if (type >= typeCnt)
-                throw vislib::Exception("Illegal type encountered", __FILE__, __LINE__);
-            if (header.HasIDs()) {
-                typeData[type]->Write(*reinterpret_cast<UINT64*>(&buffer[pos - 8]));
-            }
-            pos += 4;
-        } else {
-            if (header.HasIDs()) {
-                typeData[type]->Write(*reinterpret_cast<UINT64*>(&buffer[pos - 8]));
-            }
+    // second pass: count the particles of each type
+#pragma omp parallel for
+    for (int c = 0; c < chunkCnt; c++) {
+        FrameChunk& chunk = chunks[c];
+        if (typeCnt == 1) {
+            chunk.typeCount[0] = chunk.count;
+            appendTypeRun(chunk.runs, 0, chunk.count);
+            continue;
         }
-
-        this->addIndexForReconstruction(
-            static_cast<UINT32>(type), idxRecDat, this->IndexReconstructionData(), irdLastType, irdLastCount);
-
-        SIZE_T fieldCnt = header.GetTypes()[type].GetFields().Count();
-
-        for (SIZE_T fi = 0; fi < fieldCnt; fi++) {
-            MMSPDHeader::Field::TypeID typeID = header.GetTypes()[type].GetFields()[fi].GetType();
-            switch (typeID) {
-            case MMSPDHeader::Field::TYPE_BYTE:
-                values.operator->()[fi] = static_cast<float>(*reinterpret_cast<unsigned char*>(&buffer[pos])) / 255.0f;
-                pos += 1;
-                break;
-            case MMSPDHeader::Field::TYPE_FLOAT:
-                values.operator->()[fi] = *reinterpret_cast<float*>(&buffer[pos]);
-                pos += 4;
+        const char* l = chunk.begin;
+        for (UINT64 pi = 0; pi < chunk.count; pi++) {
+            const char* e = lineEnd(l, chunk.end);
+            const char* f = skipBlanks(l, e);
+            if (hasIDs) {
+                f = skipField(f, e);
+            }
+            int type;
+            if (f == e) {
+                chunk.error = "line truncated";
                 break;
-            case MMSPDHeader::Field::TYPE_DOUBLE:
-                values.operator->()[fi] = static_cast<float>(*reinterpret_cast<double*>(&buffer[pos]));
-                pos += 8;
+            }
+            parseIntField(f, e, type);
+            if ((type < 0) || (static_cast<SIZE_T>(type) >= typeCnt)) {
+                chunk.error = "Illegal type encountered";
                 break;
             }
+            chunk.typeCount[type]++;
+            appendTypeRun(chunk.runs, static_cast<UINT32>(type), 1);
+            l = e + 1;
         }
+    }
+    checkChunks(chunks);
+
+    std::vector<char*> typeData;
+    const std::vector<SIZE_T> stride = allocateParticles(chunks, header, *this, typeData);
+    const std::vector<std::vector<MMSPDHeader::Field::TypeID>> types = fieldTypes(header);
+
+    // third pass: parse the particles directly into the particle data
+#pragma omp parallel for
+    for (int c = 0; c < chunkCnt; c++) {
+        FrameChunk& chunk = chunks[c];
+        std::vector<UINT64> next(chunk.typeOffset);
+        const char* l = chunk.begin;
+        for (UINT64 pi = 0; (pi < chunk.count) && (chunk.error == NULL); pi++) {
+            const char* e = lineEnd(l, chunk.end);
+            const char* f = skipBlanks(l, e);
+            uint64_t id = 0;
+            int type = 0;
+            if (hasIDs) {
+                f = parseUInt64Field(f, e, id);
+            }
+            if (typeCnt > 1) {
+                f = parseIntField(f, e, type);
+            }
 
-        for (SIZE_T fi = 0; fi < fieldCnt; fi++) {
-            //typeData[type]->Write(values.operator->()[this->GetData()[type].FieldMap()[fi]]);
-            typeData[type]->Write(values.operator->()[fi]);
+            char* out = typeData[type] + static_cast<SIZE_T>(next[type]++) * stride[type];
+            if (hasIDs) {
+                ::memcpy(out, &id, 8);
+                out += 8;
+            }
+            float* vals = reinterpret_cast<float*>(out);
+            for (SIZE_T fi = 0; fi < types[type].size(); fi++) {
+                if (f == e) {
+                    chunk.error = "line truncated";
+                    break;
+                }
+                f = parseFloatField(f, e, vals[fi]);
+                if (types[type][fi] == MMSPDHeader::Field::TYPE_BYTE) {
+                    vals[fi] /= 255.0f;
+                }
+            }
+            l = e + 1;
         }
     }
+    checkChunks(chunks);
 
-    for (SIZE_T i = 0; i < typeCnt; i++) {
-        this->Data()[i].Data().EnforceSize(typeData[i]->End(), true);
-    }
-    this->IndexReconstructionData().EnforceSize(idxRecDat.End(), true);
+    storeIndexReconstruction(chunks, this->IndexReconstructionData());
 }
 
 
 /*
- * MMSPDDataSource::Frame::loadFrameBinaryBE
+ * MMSPDDataSource::Frame::loadFrameBinary
  */
-void MMSPDDataSource::Frame::loadFrameBinaryBE(char* buffer, UINT64 size, const MMSPDHeader& header) {
-    UINT64& partCnt = *reinterpret_cast<UINT64*>(&buffer[0]);
-    SIZE_T pos = 8;
-    SIZE_T typeCnt = header.GetTypes().Count();
-    vislib::PtrArray<vislib::RawStorageWriter> typeData;
-    typeData.SetCount(typeCnt);
-    SIZE_T valuesCount = 0;
-    for (SIZE_T i = 0; i < typeCnt; i++) {
-        typeData[i] = new vislib::RawStorageWriter(this->Data()[i].Data());
-        valuesCount = vislib::math::Max(valuesCount, header.GetTypes()[i].GetFields().Count());
-        typeData[i]->SetIncrement(vislib::math::Max<SIZE_T>(
-            static_cast<SIZE_T>((header.GetTypes()[i].GetFields().Count() * sizeof(float) * partCnt) / (2 * typeCnt)),
-            1024 * 1024));
+void MMSPDDataSource::Frame::loadFrameBinary(
+    const char* begin, const char* end, const MMSPDHeader& header, bool isBigEndian) {
+    const SIZE_T typeCnt = header.GetTypes().Count();
+    const bool hasIDs = header.HasIDs();
+
+    if (end - begin < 8)
+        throw vislib::Exception("Frame data truncated", __FILE__, __LINE__);
+    const UINT64 partCnt = readUInt64(begin, isBigEndian);
+    begin += 8;
+
+    // sizes of a particle in the file
+    // TODO: decide whether to ignore IDs or don't! (current: don't, interleave with pos) [#128]
+    const SIZE_T headSize = (hasIDs ? 8 : 0) + ((typeCnt > 1) ? 4 : 0);
+    std::vector<SIZE_T> recSize(typeCnt);
+    for (SIZE_T ti = 0; ti < typeCnt; ti++) {
+        recSize[ti] = headSize + header.GetTypes()[ti].GetDataSize();
     }
-    vislib::SmartPtr<float, vislib::ArrayAllocator<float>> values = new float[valuesCount];
-    vislib::RawStorageWriter idxRecDat(this->IndexReconstructionData());
-    if (typeCnt > 1)
-        idxRecDat.SetIncrement(vislib::math::Max<SIZE_T>(static_cast<SIZE_T>(partCnt / 10), 10 * 1024));
-    UINT32 irdLastType = static_cast<UINT32>(typeCnt);
-    UINT64 irdLastCount;
-
-    SIZE_T type = 0;
-    for (UINT64 pi = 0; pi < partCnt; pi++) {
-
-        // see loadframe
-        if (header.HasIDs())
-            pos += 8;
-
-        if (typeCnt > 1) {
-            vislib::Swap(buffer[pos + 0], buffer[pos + 3]);
-            vislib::Swap(buffer[pos + 1], buffer[pos + 2]);
-            type = *reinterpret_cast<UINT32*>(&buffer[pos]);
+
+    std::vector<FrameChunk> chunks;
+    if (typeCnt == 1) {
+        // one type only: the chunks follow from the fixed record size
+        const SIZE_T size = vislib::math::Max<SIZE_T>(1, recSize[0]);
+        if (partCnt > static_cast<UINT64>(end - begin) / size)
+            throw vislib::Exception("Frame data truncated", __FILE__, __LINE__);
+        const UINT64 chunkRecs = vislib::math::Max<UINT64>(1, DECODE_CHUNK_SIZE / size);
+        for (UINT64 first = 0; first < partCnt; first += chunkRecs) {
+            chunks.push_back(emptyChunk(begin + static_cast<SIZE_T>(first) * recSize[0], typeCnt));
+            FrameChunk& chunk = chunks.back();
+            chunk.count = vislib::math::Min(chunkRecs, partCnt - first);
+            chunk.end = chunk.begin + static_cast<SIZE_T>(chunk.count) * recSize[0];
+            chunk.typeCount[0] = chunk.count;
+            appendTypeRun(chunk.runs, 0, chunk.count);
+        }
+
+    } else {
+        // the record size depends on the type: find the chunk boundaries in
+        // a sequential pass only touching the type of each particle
+        const char* p = begin;
+        for (UINT64 pi = 0; pi < partCnt; pi++) {
+            if (chunks.empty() || (static_cast<SIZE_T>(p - chunks.back().begin) >= DECODE_CHUNK_SIZE)) {
+                chunks.push_back(emptyChunk(p, typeCnt));
+            }
+            if (static_cast<SIZE_T>(end - p) < headSize)
+                throw vislib::Exception("Frame data truncated", __FILE__, __LINE__);
+            const UINT32 type = readUInt32(p + (hasIDs ? 8 : 0), isBigEndian);
             if (type >= typeCnt)
                 throw vislib::Exception("Illegal type encountered", __FILE__, __LINE__);
-            // see loadframe
-            if (header.HasIDs()) {
-                vislib::Swap(buffer[pos - 8 + 0], buffer[pos - 8 + 7]);
-                vislib::Swap(buffer[pos - 8 + 1], buffer[pos - 8 + 6]);
-                vislib::Swap(buffer[pos - 8 + 2], buffer[pos - 8 + 5]);
-                vislib::Swap(buffer[pos - 8 + 3], buffer[pos - 8 + 4]);
-                typeData[type]->Write(*reinterpret_cast<UINT64*>(&buffer[pos - 8]));
-            }
-            pos += 4;
-        } else {
-            if (header.HasIDs()) {
-                vislib::Swap(buffer[pos - 8 + 0], buffer[pos - 8 + 7]);
-                vislib::Swap(buffer[pos - 8 + 1], buffer[pos - 8 + 6]);
-                vislib::Swap(buffer[pos - 8 + 2], buffer[pos - 8 + 5]);
-                vislib::Swap(buffer[pos - 8 + 3], buffer[pos - 8 + 4]);
-                typeData[type]->Write(*reinterpret_cast<UINT64*>(&buffer[pos - 8]));
-            }
+            if (static_cast<SIZE_T>(end - p) < recSize[type])
+                throw vislib::Exception("Frame data truncated", __FILE__, __LINE__);
+            p += recSize[type];
+
+            FrameChunk& chunk = chunks.back();
+            chunk.end = p;
+            chunk.count++;
+            chunk.typeCount[type]++;
+            appendTypeRun(chunk.runs, type, 1);
         }
+    }
 
-        this->addIndexForReconstruction(
-            static_cast<UINT32>(type), idxRecDat, this->IndexReconstructionData(), irdLastType, irdLastCount);
+    std::vector<char*> typeData;
+    const std::vector<SIZE_T> stride = allocateParticles(chunks, header, *this, typeData);
+    const std::vector<std::vector<MMSPDHeader::Field::TypeID>> types = fieldTypes(header);
 
-        SIZE_T fieldCnt = header.GetTypes()[type].GetFields().Count();
+    // particles made of floats only are stored exactly as in the file
+    bool plainFloats = (typeCnt == 1) && !hasIDs;
+    for (SIZE_T fi = 0; plainFloats && (fi < types[0].size()); fi++) {
+        plainFloats = (types[0][fi] == MMSPDHeader::Field::TYPE_FLOAT);
+    }
 
-        for (SIZE_T fi = 0; fi < fieldCnt; fi++) {
-            MMSPDHeader::Field::TypeID typeID = header.GetTypes()[type].GetFields()[fi].GetType();
-            switch (typeID) {
-            case MMSPDHeader::Field::TYPE_BYTE:
-                values.operator->()[fi] = static_cast<float>(*reinterpret_cast<unsigned char*>(&buffer[pos])) / 255.0f;
-                pos += 1;
-                break;
-            case MMSPDHeader::Field::TYPE_FLOAT:
-                vislib::Swap(buffer[pos + 0], buffer[pos + 3]);
-                vislib::Swap(buffer[pos + 1], buffer[pos + 2]);
-                values.operator->()[fi] = *reinterpret_cast<float*>(&buffer[pos]);
-                pos += 4;
-                break;
-            case MMSPDHeader::Field::TYPE_DOUBLE:
-                vislib::Swap(buffer[pos + 0], buffer[pos + 7]);
-                vislib::Swap(buffer[pos + 1], buffer[pos + 6]);
-                vislib::Swap(buffer[pos + 2], buffer[pos + 5]);
-                vislib::Swap(buffer[pos + 3], buffer[pos + 4]);
-                values.operator->()[fi] = static_cast<float>(*reinterpret_cast<double*>(&buffer[pos]));
-                pos += 8;
-                break;
+    const int chunkCnt = static_cast<int>(chunks.size());
+#pragma omp parallel for
+    for (int c = 0; c < chunkCnt; c++) {
+        const FrameChunk& chunk = chunks[c];
+
+        if (plainFloats) {
+            char* out = typeData[0] + static_cast<SIZE_T>(chunk.typeOffset[0]) * stride[0];
+            const SIZE_T size = static_cast<SIZE_T>(chunk.end - chunk.begin);
+            if (!isBigEndian) {
+                ::memcpy(out, chunk.begin, size);
+            } else {
+                // tight loop over 32 bit words, which the compiler vectorizes
+                for (SIZE_T i = 0; i < size; i += 4) {
+                    const UINT32 v = readUInt32(chunk.begin + i, true);
+                    ::memcpy(out + i, &v, 4);
+                }
             }
+            continue;
         }
 
-        for (SIZE_T fi = 0; fi < fieldCnt; fi++) {
-            //typeData[type]->Write(values.operator->()[this->GetData()[type].FieldMap()[fi]]);
-            typeData[type]->Write(values.operator->()[fi]);
+        std::vector<UINT64> next(chunk.typeOffset);
+        const char* p = chunk.begin;
+        for (UINT64 pi = 0; pi < chunk.count; pi++) {
+            UINT64 id = 0;
+            UINT32 type = 0;
+            if (hasIDs) {
+                id = readUInt64(p, isBigEndian);
+                p += 8;
+            }
+            if (typeCnt > 1) {
+                type = readUInt32(p, isBigEndian);
+                p += 4;
+            }
+
+            char* out = typeData[type] + static_cast<SIZE_T>(next[type]++) * stride[type];
+            if (hasIDs) {
+                ::memcpy(out, &id, 8);
+                out += 8;
+            }
+            for (SIZE_T fi = 0; fi < types[type].size(); fi++, out += sizeof(float)) {
+                float val = 0.0f;
+                switch (types[type][fi]) {
+                case MMSPDHeader::Field::TYPE_BYTE:
+                    val = static_cast<float>(*reinterpret_cast<const unsigned char*>(p)) / 255.0f;
+                    p += 1;
+                    break;
+                case MMSPDHeader::Field::TYPE_FLOAT: {
+                    const UINT32 v = readUInt32(p, isBigEndian);
+                    ::memcpy(&val, &v, 4);
+                    p += 4;
+                } break;
+                case MMSPDHeader::Field::TYPE_DOUBLE: {
+                    const UINT64 v = readUInt64(p, isBigEndian);
+                    double d;
+                    ::memcpy(&d, &v, 8);
+                    val = static_cast<float>(d);
+                    p += 8;
+                } break;
+                }
+                ::memcpy(out, &val, sizeof(float));
+            }
         }
     }
 
-    for (SIZE_T i = 0; i < typeCnt; i++) {
-        this->Data()[i].Data().EnforceSize(typeData[i]->End(), true);
-    }
-    this->IndexReconstructionData().EnforceSize(idxRecDat.End(), true);
+    storeIndexReconstruction(chunks, this->IndexReconstructionData());
 }
 
 
-/*
- * MMSPDDataSource::Frame::addIndexForReconstruction
- */
-void MMSPDDataSource::Frame::addIndexForReconstruction(UINT32 type, class vislib::RawStorageWriter& wrtr,
-    class vislib::RawStorage& data, UINT32& lastType, UINT64& lastCount) {
-    unsigned char dat[10];
-    unsigned int datLen;
-
-    if (type != lastType) {
-        lastType = type;
-        lastCount = 1;
-        datLen = 10;
-        if (!vislib::UIntRLEEncode(dat, datLen, type))
-            throw vislib::Exception(__FILE__, __LINE__);
-        wrtr.Write(dat, datLen);
-        datLen = 10;
-        if (!vislib::UIntRLEEncode(dat, datLen, lastCount))
-            throw vislib::Exception(__FILE__, __LINE__);
-        wrtr.Write(dat, datLen);
-
-    } else {
-        wrtr.SetPosition(wrtr.Position() - vislib::UIntRLELength(lastCount));
-        datLen = 10;
-        lastCount++;
-        if (!vislib::UIntRLEEncode(dat, datLen, lastCount))
-            throw vislib::Exception(__FILE__, __LINE__);
-        wrtr.Write(dat, datLen);
-    }
-}
-
 /*****************************************************************************/
 
 /*
@@ -796,6 +933,9 @@ float MMSPDDataSource::FileFormatAutoDetect(const unsigned char* data, SIZE_T da
 MMSPDDataSource::MMSPDDataSource(void)
         : core::view::AnimDataModule()
         , filename("filename", "The path to the MMSPD file to load.")
+        , frameIndexCacheSlot("frameIndexCache",
+              "Stores the frame index next to the data file to skip indexing when the file is loaded again. "
+              "Needs write access to the folder of the data file.")
         , getData("getdata", "Slot to request data from this data source.")
         , getDirData("getdirdata", "(optional) Slot to request directional data from this data source.")
         , dataHeader()
@@ -807,12 +947,16 @@ MMSPDDataSource::MMSPDDataSource(void)
         , frameIdxLock()
         , frameIdxEvent(true)
         , frameIdxThread(&MMSPDDataSource::buildFrameIndex)
+        , frameIdxCacheFile()
         , dataHash(0) {
 
     this->filename.SetParameter(new core::param::FilePathParam(""));
     this->filename.SetUpdateCallback(&MMSPDDataSource::filenameChanged);
     this->MakeSlotAvailable(&this->filename);
 
+    this->frameIndexCacheSlot << new core::param::BoolParam(false);
+    this->MakeSlotAvailable(&this->frameIndexCacheSlot);
+
     this->getData.SetCallback("MultiParticleDataCall", "GetData", &MMSPDDataSource::getDataCallback);
     this->getData.SetCallback("MultiParticleDataCall", "GetExtent", &MMSPDDataSource::getExtentCallback);
     this->MakeSlotAvailable(&this->getData);
@@ -896,11 +1040,12 @@ void MMSPDDataSource::loadFrame(core::view::AnimDataModule::Frame* frame, unsign
         }
     }
 
-    this->file->Seek(fromSeek);
     bool res = false;
     vislib::StringA errMsg;
     try {
-        res = f->LoadFrame(this->file, idx, toSeek - fromSeek, this->dataHeader, this->isBinaryFile, this->isBigEndian);
+        vislib::sys::MemmappedFile::ConstView view =
+            this->file->View(fromSeek, (toSeek > fromSeek) ? (toSeek - fromSeek) : 0);
+        res = f->LoadFrame(view.begin(), view.end(), idx, this->dataHeader, this->isBinaryFile, this->isBigEndian);
         if (!res)
             errMsg = "Unknown error";
     } catch (vislib::Exception e) {
@@ -925,7 +1070,7 @@ void MMSPDDataSource::release(void) {
     this->clearData();
     this->resetFrameCache();
     if (this->file != NULL) {
-        vislib::sys::File* f = this->file;
+        vislib::sys::MemmappedFile* f = this->file;
         this->file = NULL;
         f->Close();
         delete f;
@@ -1277,6 +1422,10 @@ DWORD MMSPDDataSource::buildFrameIndex(void* userdata) {
 #endif /* DEBUG || _DEBUG */
         }
 
+        if (!that->frameIdxCacheFile.empty()) {
+            that->writeFrameIndexCache(static_cast<UINT64>(f.GetSize()));
+        }
+
     } catch (vislib::Exception e) {
         // sort of failed ...
         that->frameIdxLock.Lock();
@@ -1341,7 +1490,7 @@ bool MMSPDDataSource::filenameChanged(core::param::ParamSlot& slot) {
     this->resetFrameCache();
 
     if (this->file == NULL) {
-        this->file = new vislib::sys::File();
+        this->file = new vislib::sys::MemmappedFile();
     } else {
         this->file->Close();
     }
@@ -1808,7 +1957,14 @@ bool MMSPDDataSource::filenameChanged(core::param::ParamSlot& slot) {
         this->initFrameCache(1);
     } else {
         this->setFrameCount(this->dataHeader.GetTimeCount());
-        this->frameIdxThread.Start(static_cast<void*>(this));
+        this->frameIdxCacheFile.clear();
+        if (this->frameIndexCacheSlot.Param<core::param::BoolParam>()->Value()) {
+            this->frameIdxCacheFile = this->filename.Param<core::param::FilePathParam>()->Value();
+            this->frameIdxCacheFile += FRAME_INDEX_CACHE_EXT;
+        }
+        if (!this->readFrameIndexCache()) {
+            this->frameIdxThread.Start(static_cast<void*>(this));
+        }
         // this->frameIdxThread.Join(); // Use this pause the main thread for debugging
 
         // estimate data set frame memory foot print
@@ -1943,6 +2099,89 @@ bool MMSPDDataSource::filenameChanged(core::param::ParamSlot& slot) {
 }
 
 
+/*
+ * MMSPDDataSource::readFrameIndexCache
+ */
+bool MMSPDDataSource::readFrameIndexCache(void) {
+    using megamol::core::utility::log::Log;
+    using vislib::sys::File;
+    if (this->frameIdxCacheFile.empty()) {
+        return false;
+    }
+
+    // the cache must have been written after the last change of the data file
+    std::error_code err;
+    const std::filesystem::file_time_type dataTime =
+        std::filesystem::last_write_time(this->filename.Param<core::param::FilePathParam>()->Value(), err);
+    if (err || (std::filesystem::last_write_time(this->frameIdxCacheFile, err) < dataTime) || err) {
+        return false;
+    }
+
+    File f;
+    if (!f.Open(this->frameIdxCacheFile.native().c_str(), File::READ_ONLY, File::SHARE_READ, File::OPEN_ONLY)) {
+        return false;
+    }
+    const UINT32 frameCount = this->dataHeader.GetTimeCount();
+    const File::FileSize idxSize = sizeof(UINT64) * (frameCount + 1);
+    std::vector<UINT64> idx(frameCount + 1);
+    char magic[8];
+    UINT32 version, cnt;
+    UINT64 dataSize;
+    bool valid = (f.Read(magic, 8) == 8) && (::memcmp(magic, FRAME_INDEX_CACHE_MAGIC, 8) == 0) &&
+                 (f.Read(&version, 4) == 4) && (version == FRAME_INDEX_CACHE_VERSION) && (f.Read(&cnt, 4) == 4) &&
+                 (cnt == frameCount) && (f.Read(&dataSize, 8) == 8) &&
+                 (dataSize == static_cast<UINT64>(this->file->GetSize())) &&
+                 (f.Read(idx.data(), idxSize) == idxSize) && (idx[0] == this->frameIdx[0]);
+    f.Close();
+    if (!valid) {
+        Log::DefaultLog.WriteWarn(
+            "Ignoring outdated frame index cache \"%s\"", this->frameIdxCacheFile.generic_u8string().c_str());
+        return false;
+    }
+
+    this->frameIdxLock.Lock();
+    ::memcpy(this->frameIdx, idx.data(), static_cast<SIZE_T>(idxSize));
+    this->frameIdxEvent.Set();
+    this->frameIdxLock.Unlock();
+    Log::DefaultLog.WriteInfo(50, "Frame index of %u frames loaded from cache", static_cast<unsigned int>(frameCount));
+    return true;
+}
+
+
+/*
+ * MMSPDDataSource::writeFrameIndexCache
+ */
+void MMSPDDataSource::writeFrameIndexCache(UINT64 dataSize) {
+    using megamol::core::utility::log::Log;
+    using vislib::sys::File;
+    const UINT32 frameCount = this->dataHeader.GetTimeCount();
+    const File::FileSize idxSize = sizeof(UINT64) * (frameCount + 1);
+    std::vector<UINT64> idx(frameCount + 1);
+
+    this->frameIdxLock.Lock();
+    if (this->frameIdx == NULL) {
+        this->frameIdxLock.Unlock();
+        return; // aborted
+    }
+    ::memcpy(idx.data(), this->frameIdx, static_cast<SIZE_T>(idxSize));
+    this->frameIdxLock.Unlock();
+
+    const UINT32 version = FRAME_INDEX_CACHE_VERSION;
+    File f;
+    bool written = f.Open(
+        this->frameIdxCacheFile.native().c_str(), File::WRITE_ONLY, File::SHARE_EXCLUSIVE, File::CREATE_OVERWRITE);
+    written = written && (f.Write(FRAME_INDEX_CACHE_MAGIC, 8) == 8) && (f.Write(&version, 4) == 4) &&
+              (f.Write(&frameCount, 4) == 4) && (f.Write(&dataSize, 8) == 8) &&
+              (f.Write(idx.data(), idxSize) == idxSize);
+    f.Close();
+    if (!written) {
+        File::Delete(this->frameIdxCacheFile.native().c_str());
+        Log::DefaultLog.WriteInfo(
+            "Unable to write frame index cache \"%s\"", this->frameIdxCacheFile.generic_u8string().c_str());
+    }
+}
+
+
 /*
  * MMSPDDataSource::getDataCallback
  */
@@ -14,6 +14,7 @@
 #include "io/MMSPDHeader.h"
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/param/ParamSlot.h"
+#include "mmcore/utility/sys/MemmappedFile.h"
 #include "mmcore/utility/sys/Thread.h"
 #include "mmcore/view/AnimDataModule.h"
 #include "vislib/RawStorage.h"
@@ -23,6 +24,7 @@
 #include "vislib/sys/Event.h"
 #include "vislib/sys/File.h"
 #include "vislib/types.h"
+#include <filesystem>
 
 
 namespace megamol {
@@ -160,20 +162,20 @@ private:
         }
 
         /**
-         * Loads a frame from 'file' into this object
+         * Loads a frame from the memory range [begin, end) into this object
          *
-         * @param file The file stream to load from. The stream is assumed
-         *             to be at the correct location
+         * @param begin The first byte of the frame data, i. e. the Time
+         *              Frame Marker
+         * @param end The first byte behind the frame data
          * @param idx The zero-based index of the frame
-         * @param size The size of the frame data in bytes
          * @param header The data set header
          * @param isBinary Flag whether or not the data set is binary
          * @param isBigEndian Flag whether or not the binary data set is big endian
          *
          * @return True on success
          */
-        bool LoadFrame(vislib::sys::File* file, unsigned int idx, UINT64 size, const MMSPDHeader& header, bool isBinary,
-            bool isBigEndian);
+        bool LoadFrame(const char* begin, const char* end, unsigned int idx, const MMSPDHeader& header,
+            bool isBinary, bool isBigEndian);
 
         /**
          * Sets the data into the call
@@ -193,52 +195,29 @@ private:
 
     private:
         /**
-         * Loads a frame from 'buffer' into this object assuming that
-         * 'buffer' holds the data in 7-Bit ASCII form.
+         * Loads a frame from [begin, end) into this object assuming that
+         * the data is stored in 7-Bit ASCII form.
          *
-         * @param buffer The frame data in main memory
-         * @param size The size of 'buffer'
+         * @param begin The first byte of the frame data
+         * @param end The first byte behind the frame data
          * @param header The data set header
          *
          * @throws vislib::Exception on any error
          */
-        void loadFrameText(char* buffer, UINT64 size, const MMSPDHeader& header);
+        void loadFrameText(const char* begin, const char* end, const MMSPDHeader& header);
 
         /**
-         * Loads a frame from 'buffer' into this object assuming that
-         * 'buffer' holds the data in binary form.
+         * Loads a frame from [begin, end) into this object assuming that
+         * the data is stored in binary form.
          *
-         * @param buffer The frame data in main memory
-         * @param size The size of 'buffer'
+         * @param begin The first byte of the frame data
+         * @param end The first byte behind the frame data
          * @param header The data set header
+         * @param isBigEndian Flag whether or not the data is big endian
          *
          * @throws vislib::Exception on any error
          */
-        void loadFrameBinary(char* buffer, UINT64 size, const MMSPDHeader& header);
-
-        /**
-         * Loads a frame from 'buffer' into this object assuming that
-         * 'buffer' holds the data in binary (big endian) form.
-         *
-         * @param buffer The frame data in main memory
-         * @param size The size of 'buffer'
-         * @param header The data set header
-         *
-         * @throws vislib::Exception on any error
-         */
-        void loadFrameBinaryBE(char* buffer, UINT64 size, const MMSPDHeader& header);
-
-        /**
-         * Appends a particle of type 'type' to the index-reconstruction data
-         *
-         * @param type The type of the particle
-         * @param wrtr The index data writer
-         * @param data The index data store
-         * @param lastType The type of the last particle added
-         * @param lastCount The number of the last particles of 'lastType' added
-         */
-        void addIndexForReconstruction(UINT32 type, class vislib::RawStorageWriter& wrtr,
-            class vislib::RawStorage& data, UINT32& lastType, UINT64& lastCount);
+        void loadFrameBinary(const char* begin, const char* end, const MMSPDHeader& header, bool isBigEndian);
     };
 
     /**
@@ -289,6 +268,22 @@ private:
      */
     void clearData(void);
 
+    /**
+     * Tries to fill the frame index from the frame index cache file. The
+     * cache is only used if it has been written for the current state of
+     * the data file.
+     *
+     * @return 'true' if the frame index has been completely restored.
+     */
+    bool readFrameIndexCache(void);
+
+    /**
+     * Writes the completed frame index to the frame index cache file.
+     *
+     * @param dataSize The size of the data file in bytes
+     */
+    void writeFrameIndexCache(UINT64 dataSize);
+
     /**
      * Callback receiving the update of the file name parameter.
      *
@@ -328,6 +323,9 @@ private:
     /** The file name */
     core::param::ParamSlot filename;
 
+    /** Flag whether or not to keep the frame index in a cache file */
+    core::param::ParamSlot frameIndexCacheSlot;
+
     /** The slot for requesting data */
     core::CalleeSlot getData;
 
@@ -338,7 +336,7 @@ private:
     MMSPDHeader dataHeader;
 
     /** The opened data file */
-    vislib::sys::File* file;
+    vislib::sys::MemmappedFile* file;
 
     /**
      * The frame index table, that is the seek positions within the file
@@ -366,6 +364,9 @@ private:
     /** The thread constructing the frame index */
     vislib::sys::Thread frameIdxThread;
 
+    /** The path of the frame index cache file or empty if not used */
+    std::filesystem::path frameIdxCacheFile;
+
     /** The data set data hash */
     SIZE_T dataHash;
 };
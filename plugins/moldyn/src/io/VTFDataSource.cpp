@@ -6,6 +6,7 @@
  */
 
 #include "io/VTFDataSource.h"
+#include "io/ASCIIFieldScanner.h"
 #include "mmcore/CoreInstance.h"
 #include "mmcore/param/BoolParam.h"
 #include "mmcore/param/FilePathParam.h"
@@ -14,6 +15,7 @@
 #include "mmcore/utility/sys/ConsoleProgressBar.h"
 #include "mmcore/utility/sys/SystemInformation.h"
 #include "stdafx.h"
+#include "vislib/Exception.h"
 #include "vislib/PtrArray.h"
 #include "vislib/RawStorageWriter.h"
 #include "vislib/String.h"
@@ -27,10 +29,14 @@
 #include "vislib/sys/Path.h"
 #include "vislib/sys/error.h"
 #include "vislib/sys/sysfunctions.h"
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
+#include <vector>
 
 using namespace megamol::core;
 using namespace megamol::moldyn;
+using namespace megamol::moldyn::io::scanner;
 
 
 /* defines for the frame cache size */
@@ -40,6 +46,25 @@ using namespace megamol::moldyn;
 #define CACHE_SIZE_MAX 100000
 // factor multiplied to the frame size for estimating the overhead to the pure data.
 #define CACHE_FRAME_FACTOR 1.15f
+// minimum number of bytes of particle lines per parallel parsing chunk
+#define PARSE_CHUNK_SIZE_MIN (1 << 20)
+// maximum number of parallel parsing chunks per frame
+#define PARSE_CHUNK_COUNT_MAX 256
+
+
+namespace {
+
+/**
+ * Answers whether the line [p, end) describes a particle, i.e. starts with a
+ * numeric id. Other lines of a frame, like "pbc" or "unitcell" records and
+ * comments, are skipped.
+ */
+inline bool isParticleLine(const char* p, const char* end) {
+    p = skipBlanks(p, end);
+    return (p != end) && (*p >= '0') && (*p <= '9');
+}
+
+} // namespace
 
 /*****************************************************************************/
 
@@ -96,7 +121,8 @@ void io::VTFDataSource::Frame::Clear(void) {
 /*
  * io::VTFDataSource::Frame::LoadFrame
  */
-bool io::VTFDataSource::Frame::LoadFrame(vislib::sys::File* file, unsigned int idx, vislib::Array<SimpleType>& types) {
+bool io::VTFDataSource::Frame::LoadFrame(
+    const char* begin, const char* end, unsigned int idx, vislib::Array<SimpleType>& types) {
     /*
             timestep indexed
             0 -1 88.08974923911063 93.53975290469917 41.0842180843088940
@@ -107,43 +133,92 @@ bool io::VTFDataSource::Frame::LoadFrame(vislib::sys::File* file, unsigned int i
     */
 
     this->frame = idx;
-    this->partCnt.Resize(types.Count());
-    this->pos[0].EnforceSize(sizeof(float) * 3 * types[0].GetCount());
-    this->col[0].EnforceSize(sizeof(float) * 4 * types[0].GetCount());
-
-    unsigned int id = 0;
 
-    while (!file->IsEOF()) {
-        vislib::StringA line = vislib::sys::ReadLineFromFileA(*file);
-        line.TrimSpaces();
-
-        vislib::Array<vislib::StringA> shreds = vislib::StringTokeniserA::Split(line, ' ', true);
+    // split the frame into chunks starting at line boundaries
+    const SIZE_T len = static_cast<SIZE_T>(end - begin);
+    const int chunkCnt = static_cast<int>(
+        vislib::math::Max<SIZE_T>(1, vislib::math::Min<SIZE_T>(PARSE_CHUNK_COUNT_MAX, len / PARSE_CHUNK_SIZE_MIN)));
+    std::vector<const char*> chunkStart(chunkCnt + 1);
+    chunkStart[0] = begin;
+    chunkStart[chunkCnt] = end;
+    for (int c = 1; c < chunkCnt; ++c) {
+        const char* p = vislib::math::Max(chunkStart[c - 1], begin + (len / chunkCnt) * c);
+        p = lineEnd(p, end);
+        chunkStart[c] = (p < end) ? p + 1 : end;
+    }
 
-        if (line.IsEmpty() || line.StartsWithInsensitive("time")) {
+    // first pass: count the particle lines of each chunk up to the first blank or "time" line, which ends the frame
+    std::vector<unsigned int> chunkOffset(chunkCnt + 1, 0);
+    std::vector<const char*> chunkStop(chunkCnt);
+#pragma omp parallel for
+    for (int c = 0; c < chunkCnt; ++c) {
+        unsigned int cnt = 0;
+        const char* p = chunkStart[c];
+        while (p < chunkStart[c + 1]) {
+            const char* e = lineEnd(p, chunkStart[c + 1]);
+            if (isBlankLine(p, e) || startsWithInsensitive(skipBlanks(p, e), e, "time")) {
+                break;
+            }
+            if (isParticleLine(p, e)) {
+                ++cnt;
+            }
+            p = e + 1;
+        }
+        chunkStop[c] = vislib::math::Min(p, chunkStart[c + 1]);
+        chunkOffset[c + 1] = cnt;
+    }
+    int usedChunkCnt = chunkCnt;
+    for (int c = 0; c < chunkCnt; ++c) {
+        chunkOffset[c + 1] += chunkOffset[c];
+        if (chunkStop[c] < chunkStart[c + 1]) {
+            chunkStart[c + 1] = chunkStop[c];
+            usedChunkCnt = c + 1;
             break;
         }
+    }
+    const unsigned int cnt = chunkOffset[usedChunkCnt];
 
-        int clusterId = (int)vislib::CharTraitsA::ParseInt(shreds[1]);
-        this->clusterInfos.data[clusterId].Append(id);
-
-        vislib::math::Vector<float, 3> pos;
-        pos.Set((float)vislib::CharTraitsA::ParseDouble(shreds[2]), (float)vislib::CharTraitsA::ParseDouble(shreds[3]),
-            (float)vislib::CharTraitsA::ParseDouble(shreds[4]));
-
-        vislib::math::Vector<float, 4> col;
-        col.Set(0.0f, // type
-            static_cast<float>(clusterId), 0.0f, 0.0f);
-
-
-        //this->pos[0].Append(pos.PeekComponents(), 3 * sizeof(float));
-
-        memcpy(this->pos[0].At(4 * 3 * this->partCnt[0]), pos.PeekComponents(), 3 * sizeof(float));
-        memcpy(this->col[0].At(4 * 4 * this->partCnt[0]), col.PeekComponents(), 4 * sizeof(float));
+    // the frame buffers are gone after Clear
+    const unsigned int typeCnt = vislib::math::Max<unsigned int>(static_cast<unsigned int>(types.Count()), 1);
+    if ((this->partCnt.Count() < typeCnt) || (this->typeCnt != typeCnt)) {
+        this->SetTypeCount(typeCnt);
+    }
+    this->partCnt[0] = cnt;
+    this->pos[0].EnforceSize(sizeof(float) * 3 * cnt);
+    this->col[0].EnforceSize(sizeof(float) * 4 * cnt);
+    std::vector<int> clusterIds(cnt);
+
+    // second pass: parse the particles directly into the output buffers
+    float* posData = this->pos[0].As<float>();
+    float* colData = this->col[0].As<float>();
+#pragma omp parallel for
+    for (int c = 0; c < usedChunkCnt; ++c) {
+        unsigned int i = chunkOffset[c];
+        for (const char* p = chunkStart[c]; p < chunkStart[c + 1];) {
+            const char* e = lineEnd(p, chunkStart[c + 1]);
+            if (isParticleLine(p, e)) {
+                const char* f = skipField(skipBlanks(p, e), e); // particle id
+                f = parseIntField(f, e, clusterIds[i]);
+                f = parseFloatField(f, e, posData[3 * i + 0]);
+                f = parseFloatField(f, e, posData[3 * i + 1]);
+                parseFloatField(f, e, posData[3 * i + 2]);
+                colData[4 * i + 0] = 0.0f; // type
+                colData[4 * i + 1] = static_cast<float>(clusterIds[i]);
+                colData[4 * i + 2] = 0.0f;
+                colData[4 * i + 3] = 0.0f;
+                ++i;
+            }
+            p = e + 1;
+        }
+    }
 
-        ++this->partCnt[0];
-        ++id;
+    this->clusterInfos.data.Clear();
+    for (unsigned int id = 0; id < cnt; ++id) {
+        this->clusterInfos.data[clusterIds[id]].Append(id);
     }
+
     // count + start + data
+    ::free(this->clusterInfos.plainData);
     this->clusterInfos.sizeofPlainData =
         2 * this->clusterInfos.data.Count() * sizeof(int) + this->partCnt[0] * sizeof(int);
     this->clusterInfos.plainData = (unsigned int*)malloc(this->clusterInfos.sizeofPlainData);
@@ -161,16 +236,6 @@ bool io::VTFDataSource::Frame::LoadFrame(vislib::sys::File* file, unsigned int i
         summedSizesSoFar += static_cast<unsigned int>(arr.Count());
     }
 
-    /*
-    this->col[0].AssertSize(this->partCnt[0] * sizeof(float) * 4);
-    for(unsigned int i = 0; i < this->partCnt[0]; ++i)
-    {
-            *this->col[0].AsAt<float>(4*(4*i + 0)) = 0.5f;
-            *this->col[0].AsAt<float>(4*(4*i + 1)) = 0.5f;
-            *this->col[0].AsAt<float>(4*(4*i + 2)) = 0.5f;
-            *this->col[0].AsAt<float>(4*(4*i + 3)) = 1.0f;
-    }
-    */
     VLTRACE(VISLIB_TRCELVL_INFO, "Frame %u loaded\n", this->frame);
 
     return true;
@@ -320,7 +385,9 @@ io::VTFDataSource::VTFDataSource(void)
         , preprocessSlot("preprocess", "aggregation preprocessing")
         , types()
         , frameIdx()
+        , frameEnd()
         , file(NULL)
+        , fileView()
         , datahash(0) {
 
     this->filename.SetParameter(new param::FilePathParam(""));
@@ -377,8 +444,8 @@ void io::VTFDataSource::loadFrame(view::AnimDataModule::Frame* frame, unsigned i
     }
     ASSERT(idx < this->FrameCount());
 
-    this->file->Seek(this->frameIdx[idx]);
-    f->LoadFrame(this->file, idx, this->types);
+    const char* data = this->fileView.Data();
+    f->LoadFrame(data + this->frameIdx[idx], data + this->frameEnd[idx], idx, this->types);
 
     if (this->preprocessSlot.Param<param::BoolParam>()->Value())
         preprocessFrame(*f);
@@ -445,6 +512,7 @@ void io::VTFDataSource::preprocessFrame(Frame& frame) {
  */
 void io::VTFDataSource::release(void) {
     this->resetFrameCache();
+    this->fileView.Release();
     if (this->file != NULL) {
         vislib::sys::File* f = this->file;
         this->file = NULL;
@@ -453,6 +521,7 @@ void io::VTFDataSource::release(void) {
     }
     this->types.Clear();
     this->frameIdx.Clear();
+    this->frameEnd.Clear();
 }
 
 /*
@@ -462,14 +531,14 @@ bool io::VTFDataSource::filenameChanged(param::ParamSlot& slot) {
 
     this->types.Clear();
     this->frameIdx.Clear();
+    this->frameEnd.Clear();
     this->resetFrameCache();
+    this->fileView.Release();
 
     this->datahash++;
 
     if (this->file == NULL) {
-        //this->file = new vislib::sys::FastFile();
-        this->file = new vislib::sys::BufferedFile();
-        dynamic_cast<vislib::sys::BufferedFile*>(this->file)->SetBufferSize(2 << 30);
+        this->file = new vislib::sys::MemmappedFile();
     } else {
         this->file->Close();
     }
@@ -496,6 +565,7 @@ bool io::VTFDataSource::filenameChanged(param::ParamSlot& slot) {
             "Unable to read VTF-Header from file \"%s\". Wrong format?",
             this->filename.Param<param::FilePathParam>()->Value().generic_u8string().c_str());
 
+        this->fileView.Release();
         this->file->Close();
         SAFE_DELETE(this->file);
         this->setFrameCount(1);
@@ -560,18 +630,53 @@ bool io::VTFDataSource::parseHeaderAndFrameIndices(const vislib::TString& filena
     bool haveAtomType = false;
 
     this->types.Clear();
+    this->frameIdx.Clear();
+    this->frameEnd.Clear();
+
+    // map the whole file once; frames are parsed straight from this view later on
+    try {
+        this->fileView = this->file->View(0, this->file->GetSize(), vislib::sys::MemmappedFile::HINT_SEQUENTIAL);
+    } catch (vislib::Exception& ex) {
+        megamol::core::utility::log::Log::DefaultLog.WriteMsg(
+            megamol::core::utility::log::Log::LEVEL_ERROR, "Unable to map VTF-File: %s", ex.GetMsgA());
+        return false;
+    }
+    const char* const data = this->fileView.Data();
+    const char* const dataEnd = this->fileView.end();
 
     vislib::sys::ConsoleProgressBar cpb;
     cpb.Start("Progress Loading VTF File", static_cast<vislib::sys::ConsoleProgressBar::Size>(this->file->GetSize()));
 
-    // read the header
-    while (!this->file->IsEOF()) {
-        vislib::sys::File::FileSize currentFileCursor = this->file->Tell();
-        vislib::StringA line = vislib::sys::ReadLineFromFileA(*this->file);
-        line.TrimSpaces();
+    // read the header and build the frame index
+    for (const char* lineStart = data; lineStart < dataEnd;) {
+        const char* lineStop = lineEnd(lineStart, dataEnd);
+        const char* p = skipBlanks(lineStart, lineStop);
+        const char* nextLine = (lineStop < dataEnd) ? lineStop + 1 : dataEnd;
 
-        if (line.IsEmpty())
+        if (p == lineStop) {
+            lineStart = nextLine;
             continue;
+        }
+
+        if (haveBoundingBox && haveAtomType) {
+            // only "time index" lines are of interest in the body, so do not tokenise anything else
+            if (startsWithInsensitive(p, lineStop, "time")) {
+                const char* second = skipField(p, lineStop);
+                if (startsWithInsensitive(second, lineStop, "index")) {
+                    if (this->frameIdx.Count() > this->frameEnd.Count()) {
+                        this->frameEnd.Append(static_cast<vislib::sys::File::FileSize>(lineStart - data));
+                    }
+                    this->frameIdx.Append(static_cast<vislib::sys::File::FileSize>(nextLine - data));
+                    cpb.Set(static_cast<vislib::sys::ConsoleProgressBar::Size>(nextLine - data));
+                }
+            }
+            lineStart = nextLine;
+            continue;
+        }
+
+        vislib::StringA line(p, static_cast<vislib::StringA::Size>(lineStop - p));
+        line.TrimSpaces();
+        lineStart = nextLine;
 
         vislib::Array<vislib::StringA> shreds = vislib::StringTokeniserA::Split(line, ' ', true);
 
@@ -599,13 +704,6 @@ bool io::VTFDataSource::parseHeaderAndFrameIndices(const vislib::TString& filena
             }
         }
 
-        if (haveBoundingBox && haveAtomType) {
-            if (shreds[0].Compare("time", false) && shreds[1].Compare("index", false)) {
-                this->frameIdx.Append(this->file->Tell());
-                cpb.Set(static_cast<vislib::sys::ConsoleProgressBar::Size>(this->file->Tell()));
-            }
-        }
-
         /*
 vislib::StringA line = vislib::sys::ReadLineFromFileA(*this->file);
 line.TrimSpaces();
@@ -667,6 +765,13 @@ if (line.IsEmpty()) {
 }
         */
     }
+    if (this->frameIdx.Count() > this->frameEnd.Count()) {
+        this->frameEnd.Append(static_cast<vislib::sys::File::FileSize>(dataEnd - data));
+    }
+    cpb.Stop();
+    // frames are requested in arbitrary order from now on
+    this->fileView.Advise(vislib::sys::MemmappedFile::HINT_NORMAL);
+
     this->setFrameCount((unsigned int)this->frameIdx.Count());
     //this->initFrameCache(1);
 
@@ -10,6 +10,7 @@
 #include "geometry_calls/MultiParticleDataCall.h"
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/param/ParamSlot.h"
+#include "mmcore/utility/sys/MemmappedFile.h"
 #include "mmcore/view/AnimDataModule.h"
 #include "vislib/Array.h"
 #include "vislib/Map.h"
@@ -289,15 +290,18 @@ private:
         void Clear(void);
 
         /**
-         * Loads a frame from 'file' to this object.
+         * Loads a frame from the memory range [begin, end) to this object.
+         * The range must contain the particle lines of the frame only. The
+         * lines are parsed in parallel without allocating any strings.
          *
-         * @param file The data file.
+         * @param begin The first byte of the particle lines of the frame.
+         * @param end The first byte behind the particle lines of the frame.
          * @param idx The index number of the frame.
          * @param types The types array of the data.
          *
          * @return 'true' on success, 'false' on failure.
          */
-        bool LoadFrame(vislib::sys::File* file, unsigned int idx, vislib::Array<SimpleType>& types);
+        bool LoadFrame(const char* begin, const char* end, unsigned int idx, vislib::Array<SimpleType>& types);
 
         /**
          * Sets the number of types of the data set.
@@ -497,14 +501,20 @@ private:
     core::CalleeSlot getData;
 
     /** The opened data file */
-    vislib::sys::File* file;
+    vislib::sys::MemmappedFile* file;
+
+    /** The whole content of the opened data file */
+    vislib::sys::MemmappedFile::ConstView fileView;
 
     /** The types */
     vislib::Array<SimpleType> types;
 
-    /** The frame index table */
+    /** The frame index table (offset of the first particle line of each frame) */
     vislib::Array<vislib::sys::File::FileSize> frameIdx;
 
+    /** The offset behind the last particle line of each frame */
+    vislib::Array<vislib::sys::File::FileSize> frameEnd;
+
     /** The data file hash */
     SIZE_T datahash;
 
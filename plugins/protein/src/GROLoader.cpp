@@ -12,7 +12,6 @@
 #include "mmcore/param/IntParam.h"
 #include "mmcore/param/StringParam.h"
 #include "mmcore/utility/log/Log.h"
-#include "mmcore/utility/sys/ASCIIFileBuffer.h"
 #include "mmcore/utility/sys/MemmappedFile.h"
 #include "stdafx.h"
 #include "vislib/ArrayAllocator.h"
@@ -25,6 +24,8 @@
 #include <ctime>
 #include <fstream>
 #include <iostream>
+#include <utility>
+#include <vector>
 
 using namespace megamol;
 using namespace megamol::core;
@@ -33,6 +34,38 @@ using namespace megamol::protein_calls;
 
 #define SOLVENT_CHAIN_IDENTIFIER 127
 
+namespace {
+
+/** A line of a mapped text file: its first character and its length without the line break */
+typedef std::pair<const char*, SIZE_T> MappedLine;
+
+/**
+ * Splits a mapped text file into lines. The lines are not copied and not
+ * terminated, they point into the view and stay valid as long as it does.
+ * '\n', '\r', "\r\n" and "\n\r" end a line.
+ *
+ * @param view  The mapped file contents.
+ * @param lines Receives the lines of the view.
+ */
+void splitMappedLines(const vislib::sys::MemmappedFile::ConstView& view, std::vector<MappedLine>& lines) {
+    lines.clear();
+    const char* lsp = view.begin(); // line start pointer
+    for (const char* p = view.begin(); p != view.end(); ++p) {
+        if ((*p == '\n') || (*p == '\r')) {
+            lines.emplace_back(lsp, static_cast<SIZE_T>(p - lsp));
+            if ((p + 1 != view.end()) && (p[1] != p[0]) && ((p[1] == '\n') || (p[1] == '\r'))) {
+                ++p;
+            }
+            lsp = p + 1;
+        }
+    }
+    if (lsp != view.end()) {
+        lines.emplace_back(lsp, static_cast<SIZE_T>(view.end() - lsp));
+    }
+}
+
+} // namespace
+
 /*
  * GROLoader::Frame::Frame
  */
@@ -1166,16 +1199,38 @@ void GROLoader::loadFile(const vislib::TString& filename) {
 
     t = clock(); // DEBUG
 
-    vislib::sys::ASCIIFileBuffer file;
     SIZE_T frameCapacity = 10000;
 
-    // try to load the file
-    if (file.LoadFile(T2A(filename))) {
-        // file successfully loaded
-        if (file.Count() > 2) {
-            // read number of atoms
-            totalAtomCnt = atoi(file[1]);
+    // map the file and parse the lines in place instead of copying it into a buffer first
+    vislib::sys::MemmappedFile file;
+    vislib::sys::MemmappedFile::ConstView view;
+    std::vector<MappedLine> lines;
+    try {
+        if (file.Open(filename, vislib::sys::File::READ_ONLY, vislib::sys::File::SHARE_READ,
+                vislib::sys::File::OPEN_ONLY)) {
+            view = file.View(0, file.GetSize(), vislib::sys::MemmappedFile::HINT_SEQUENTIAL);
+            file.Close();
+            splitMappedLines(view, lines);
+        }
+    } catch (vislib::Exception& ex) {
+        Log::DefaultLog.WriteMsg(Log::LEVEL_ERROR, "Could not map file %s: %s (%s, %d)", (const char*)T2A(filename),
+            ex.GetMsgA(), ex.GetFile(), ex.GetLine());
+        lines.clear();
+    }
+
+    // the title, the number of atoms and one line per atom
+    totalAtomCnt = 0;
+    if (lines.size() > 2) {
+        // read number of atoms
+        totalAtomCnt = atoi(vislib::StringA(lines[1].first, lines[1].second));
+        if (lines.size() < totalAtomCnt + 2) {
+            Log::DefaultLog.WriteMsg(Log::LEVEL_ERROR, "File %s lists %u atoms but contains only %u atom lines",
+                (const char*)T2A(filename), totalAtomCnt, static_cast<unsigned int>(lines.size() - 2));
+            lines.clear();
         }
+    }
+
+    if (lines.size() > 2) {
         Log::DefaultLog.WriteMsg(Log::LEVEL_INFO, "Atom count: %i", totalAtomCnt); // DEBUG
 
         // Init atom filter array with 1 (= 'visible')
@@ -1214,7 +1269,7 @@ void GROLoader::loadFile(const vislib::TString& filename) {
         // parse all atoms
         vislib::StringA line;
         for (atomCnt = 0; atomCnt < totalAtomCnt; ++atomCnt) {
-            line = file[atomCnt + 2];
+            line = vislib::StringA(lines[atomCnt + 2].first, lines[atomCnt + 2].second);
             this->parseAtomEntry(line, atomCnt, frameCnt, solventResidueNames);
         }
         Log::DefaultLog.WriteMsg(Log::LEVEL_INFO, "Time for parsing first frame: %f",
@@ -0,0 +1,253 @@
+/*
+ * HydroBondCache.cpp
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "HydroBondCache.h"
+#include "stdafx.h"
+
+#include <cstring>
+#include <system_error>
+
+#include "mmcore/utility/log/Log.h"
+
+using namespace megamol::protein;
+using megamol::core::utility::log::Log;
+
+
+namespace {
+
+const char magic[4] = {'M', 'M', 'H', 'B'};
+const uint32_t version = 2;
+
+template<class T>
+inline void writeValue(std::ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<class T>
+inline bool readValue(std::istream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+} // namespace
+
+
+/*
+ * HydroBondCache::headerSize
+ */
+const uint64_t HydroBondCache::headerSize = sizeof(magic) + 3 * sizeof(uint32_t) + sizeof(uint64_t) + 2 * sizeof(float);
+
+
+/*
+ * HydroBondCache::HydroBondCache
+ */
+HydroBondCache::HydroBondCache(void) : key(), complete(false) {}
+
+
+/*
+ * HydroBondCache::~HydroBondCache
+ */
+HydroBondCache::~HydroBondCache(void) {
+    this->Clear();
+}
+
+
+/*
+ * HydroBondCache::Append
+ */
+bool HydroBondCache::Append(const BondList& bonds) {
+    if (this->complete || this->offsets.empty() || (this->offsets.size() > this->key.frameCount)) {
+        return false;
+    }
+    if (this->out.is_open()) {
+        this->out.write(reinterpret_cast<const char*>(bonds.data()), bonds.size() * sizeof(int32_t));
+        if (!this->out) {
+            return false;
+        }
+        this->offsets.push_back(this->offsets.back() + bonds.size() * sizeof(int32_t));
+    } else {
+        this->memory.insert(this->memory.end(), bonds.begin(), bonds.end());
+        this->offsets.push_back(this->memory.size());
+    }
+    return true;
+}
+
+
+/*
+ * HydroBondCache::BeginWrite
+ */
+bool HydroBondCache::BeginWrite(const std::filesystem::path& path, const Key& key) {
+    this->Clear();
+    this->key = key;
+    this->offsets.reserve(key.frameCount + 1);
+    if (path.empty()) {
+        this->offsets.push_back(0);
+        return true;
+    }
+
+    this->path = path;
+    this->tmpPath = path;
+    this->tmpPath += ".tmp";
+    this->out.open(this->tmpPath, std::ios::binary | std::ios::trunc);
+    if (!this->out) {
+        Log::DefaultLog.WriteError("Cannot create hydrogen bond cache \"%s\".", this->tmpPath.string().c_str());
+        this->Clear();
+        return false;
+    }
+    this->out.write(magic, sizeof(magic));
+    writeValue(this->out, version);
+    writeValue(this->out, key.atomCount);
+    writeValue(this->out, key.frameCount);
+    writeValue(this->out, key.contentHash);
+    writeValue(this->out, key.donorAcceptorDistance);
+    writeValue(this->out, key.donorAcceptorAngle);
+    // placeholder for the offset table, written in 'EndWrite'
+    const std::vector<uint64_t> table(key.frameCount + 1, 0);
+    this->out.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(uint64_t));
+    this->offsets.push_back(headerSize + table.size() * sizeof(uint64_t));
+    return static_cast<bool>(this->out);
+}
+
+
+/*
+ * HydroBondCache::Clear
+ */
+void HydroBondCache::Clear(void) {
+    if (this->out.is_open()) {
+        this->out.close();
+        std::error_code err;
+        std::filesystem::remove(this->tmpPath, err);
+    }
+    this->in.close();
+    this->in.clear();
+    this->out.clear();
+    this->offsets.clear();
+    this->memory.clear();
+    this->memory.shrink_to_fit();
+    this->path.clear();
+    this->tmpPath.clear();
+    this->key = Key();
+    this->complete = false;
+}
+
+
+/*
+ * HydroBondCache::EndWrite
+ */
+bool HydroBondCache::EndWrite(void) {
+    if (this->complete || (this->offsets.size() != this->key.frameCount + 1)) {
+        return false;
+    }
+    if (!this->out.is_open()) {
+        this->complete = true;
+        return true;
+    }
+
+    this->out.seekp(headerSize);
+    this->out.write(reinterpret_cast<const char*>(this->offsets.data()), this->offsets.size() * sizeof(uint64_t));
+    this->out.close();
+    const bool written = !this->out.fail();
+    std::error_code err;
+    if (written) {
+        std::filesystem::rename(this->tmpPath, this->path, err);
+    }
+    if (!written || err) {
+        Log::DefaultLog.WriteError("Cannot write hydrogen bond cache \"%s\".", this->path.string().c_str());
+        std::filesystem::remove(this->tmpPath, err);
+        this->Clear();
+        return false;
+    }
+
+    this->in.open(this->path, std::ios::binary);
+    this->complete = this->in.is_open();
+    return this->complete;
+}
+
+
+/*
+ * HydroBondCache::Hash
+ */
+uint64_t HydroBondCache::Hash(const void* data, size_t size, uint64_t hash) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+
+/*
+ * HydroBondCache::Open
+ */
+bool HydroBondCache::Open(const std::filesystem::path& path, const Key& key) {
+    this->Clear();
+    this->in.open(path, std::ios::binary);
+    if (!this->in) {
+        this->Clear();
+        return false;
+    }
+
+    char fileMagic[sizeof(magic)];
+    uint32_t fileVersion = 0;
+    Key fileKey;
+    bool ok = static_cast<bool>(this->in.read(fileMagic, sizeof(fileMagic))) &&
+              (std::memcmp(fileMagic, magic, sizeof(magic)) == 0) && readValue(this->in, fileVersion) &&
+              (fileVersion == version) && readValue(this->in, fileKey.atomCount) &&
+              readValue(this->in, fileKey.frameCount) && readValue(this->in, fileKey.contentHash) &&
+              readValue(this->in, fileKey.donorAcceptorDistance) && readValue(this->in, fileKey.donorAcceptorAngle);
+    if (ok && !(fileKey == key)) {
+        Log::DefaultLog.WriteWarn(
+            "Hydrogen bond cache \"%s\" belongs to another data set or other parameters.", path.string().c_str());
+        ok = false;
+    }
+    if (ok) {
+        this->offsets.resize(key.frameCount + 1);
+        ok = static_cast<bool>(
+            this->in.read(reinterpret_cast<char*>(this->offsets.data()), this->offsets.size() * sizeof(uint64_t)));
+    }
+    if (ok) {
+        // an interrupted write leaves the table empty
+        this->in.seekg(0, std::ios::end);
+        const uint64_t fileSize = static_cast<uint64_t>(this->in.tellg());
+        ok = (this->offsets.front() == headerSize + this->offsets.size() * sizeof(uint64_t)) &&
+             (this->offsets.back() == fileSize);
+        for (size_t i = 1; ok && (i < this->offsets.size()); ++i) {
+            ok = (this->offsets[i - 1] <= this->offsets[i]) &&
+                 ((this->offsets[i] - this->offsets[i - 1]) % (2 * sizeof(int32_t)) == 0);
+        }
+    }
+    if (!ok) {
+        this->Clear();
+        return false;
+    }
+
+    this->key = key;
+    this->path = path;
+    this->complete = true;
+    return true;
+}
+
+
+/*
+ * HydroBondCache::Read
+ */
+bool HydroBondCache::Read(unsigned int frame, BondList& bonds) {
+    if (!this->complete || (frame >= this->key.frameCount)) {
+        return false;
+    }
+    const uint64_t begin = this->offsets[frame];
+    const uint64_t end = this->offsets[frame + 1];
+    if (!this->in.is_open()) {
+        bonds.assign(this->memory.begin() + begin, this->memory.begin() + end);
+        return true;
+    }
+
+    bonds.resize((end - begin) / sizeof(int32_t));
+    this->in.clear();
+    this->in.seekg(begin);
+    return static_cast<bool>(this->in.read(reinterpret_cast<char*>(bonds.data()), end - begin));
+}
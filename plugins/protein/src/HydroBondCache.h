@@ -0,0 +1,180 @@
+/*
+ * HydroBondCache.h
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace megamol {
+namespace protein {
+
+/**
+ * Stores the hydrogen bonds of all frames of a trajectory as compact
+ * per-frame lists. The lists are either kept in memory or written to a
+ * seekable cache file, which can be reopened later.
+ *
+ * File layout (little endian):
+ *   char[4]  magic "MMHB"
+ *   uint32   version
+ *   uint32   atom count
+ *   uint32   frame count
+ *   uint64   content hash of the data set (see 'Key')
+ *   float    donor-acceptor distance
+ *   float    donor-acceptor angle
+ *   uint64   byte offsets of the frames [frame count + 1]
+ *   int32    (acceptor, hydrogen) index pairs of all frames
+ *
+ * The offset table allows reading any frame with a single seek. The lists
+ * must be appended in frame order.
+ */
+class HydroBondCache {
+public:
+    /**
+     * The data set and the parameters the bonds were computed with. The data
+     * set is identified by a hash of its content, as the data hash of the
+     * source only counts the changes within one session.
+     */
+    struct Key {
+        uint32_t atomCount;
+        uint32_t frameCount;
+        uint64_t contentHash;
+        float donorAcceptorDistance;
+        float donorAcceptorAngle;
+
+        bool operator==(const Key& rhs) const {
+            return (this->atomCount == rhs.atomCount) && (this->frameCount == rhs.frameCount) &&
+                   (this->contentHash == rhs.contentHash) &&
+                   (this->donorAcceptorDistance == rhs.donorAcceptorDistance) &&
+                   (this->donorAcceptorAngle == rhs.donorAcceptorAngle);
+        }
+    };
+
+    /** The bonds of one frame as (acceptor, hydrogen) index pairs */
+    typedef std::vector<int32_t> BondList;
+
+    /** Ctor. */
+    HydroBondCache(void);
+
+    /** Dtor. */
+    ~HydroBondCache(void);
+
+    /**
+     * Appends the bonds of the next frame.
+     *
+     * @param bonds The bonds of the frame.
+     *
+     * @return 'true' on success, 'false' on failure.
+     */
+    bool Append(const BondList& bonds);
+
+    /**
+     * Continues a 64 bit FNV-1a hash over a block of memory.
+     *
+     * @param data The memory to hash.
+     * @param size The size of 'data' in bytes.
+     * @param hash The hash of the preceding data.
+     *
+     * @return The updated hash.
+     */
+    static uint64_t Hash(const void* data, size_t size, uint64_t hash = 14695981039346656037ull);
+
+    /**
+     * Starts writing a new cache, dropping the current one. If 'path' is
+     * empty the lists are kept in memory, otherwise they are written to a
+     * temporary file which replaces 'path' in 'EndWrite'.
+     *
+     * @param path The cache file or an empty path.
+     * @param key  The parameters the bonds are computed with.
+     *
+     * @return 'true' on success, 'false' on failure.
+     */
+    bool BeginWrite(const std::filesystem::path& path, const Key& key);
+
+    /**
+     * Drops the cache and closes the files.
+     */
+    void Clear(void);
+
+    /**
+     * Finishes writing, after the lists of all frames have been appended.
+     *
+     * @return 'true' on success, 'false' on failure.
+     */
+    bool EndWrite(void);
+
+    /**
+     * Answer the parameters of the cache.
+     *
+     * @return The parameters.
+     */
+    inline const Key& GetKey(void) const {
+        return this->key;
+    }
+
+    /**
+     * Answer whether the cache holds the bonds of all frames.
+     *
+     * @return 'true' if the cache is complete.
+     */
+    inline bool IsComplete(void) const {
+        return this->complete;
+    }
+
+    /**
+     * Opens an existing cache file.
+     *
+     * @param path The cache file.
+     * @param key  The expected parameters.
+     *
+     * @return 'true' if the file is complete and matches 'key'. A file of
+     *         another data set or other parameters is rejected.
+     */
+    bool Open(const std::filesystem::path& path, const Key& key);
+
+    /**
+     * Reads the bonds of a frame. The cache must be complete. Not thread safe,
+     * as the reads share one file handle.
+     *
+     * @param frame The frame index.
+     * @param bonds Receives the bonds of the frame.
+     *
+     * @return 'true' on success, 'false' on failure.
+     */
+    bool Read(unsigned int frame, BondList& bonds);
+
+private:
+    /** The size of the file header in bytes */
+    static const uint64_t headerSize;
+
+    /** The parameters of the cache */
+    Key key;
+
+    /** The start of the frames, in bytes or in elements of 'memory' */
+    std::vector<uint64_t> offsets;
+
+    /** The lists of all frames, if no file is used */
+    std::vector<int32_t> memory;
+
+    /** The cache file and the temporary file while writing */
+    std::filesystem::path path, tmpPath;
+
+    /** The cache file opened for reading */
+    std::ifstream in;
+
+    /** The temporary file opened for writing */
+    std::ofstream out;
+
+    /** Flag whether the cache holds all frames */
+    bool complete;
+};
+
+} /* end namespace protein */
+} /* end namespace megamol */
@@ -740,6 +740,8 @@ PDBLoader::PDBLoader(void)
         , calcBondsSlot("calculateBonds", "Calculate covalent bonds when loading the file")
         , recomputeStridePerFrameSlot(
               "recomputeSTRIDEeachFrame", "If STRIDE is used, should it be recomputed each frame?")
+        , precomputeStrideSlot("precomputeSTRIDE",
+              "If STRIDE is recomputed each frame, compute all frames of the trajectory on a background thread")
         , bbox(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f)
         , datahash(0)
         , stride(0)
@@ -784,6 +786,9 @@ PDBLoader::PDBLoader(void)
     this->recomputeStridePerFrameSlot << new param::BoolParam(false);
     this->MakeSlotAvailable(&this->recomputeStridePerFrameSlot);
 
+    this->precomputeStrideSlot << new param::BoolParam(false);
+    this->MakeSlotAvailable(&this->precomputeStrideSlot);
+
     mdd = NULL; // no mdd object
 }
 
@@ -846,6 +851,9 @@ bool PDBLoader::getData(core::Call& call) {
         dc->SetFrameCount(vislib::math::Max(1U, static_cast<unsigned int>(this->numXTCFrames)));
     }
 
+    // the frame the atom positions are taken from
+    unsigned int posFrame = 0;
+
     // if no xtc-filename has been set
     if (!this->xtcFileValid) {
 
@@ -867,6 +875,7 @@ bool PDBLoader::getData(core::Call& call) {
         dc->SetChargeRange(this->data[dc->FrameID()]->MinCharge(), this->data[dc->FrameID()]->MaxCharge());
         dc->SetOccupancyRange(this->data[dc->FrameID()]->MinOccupancy(), this->data[dc->FrameID()]->MaxOccupancy());
         dc->SetFormerAtomIndices(this->atomFormerIdx.PeekElements());
+        posFrame = dc->FrameID();
     } else {
 
         if (dc->FrameID() >= vislib::math::Max(1U, static_cast<unsigned int>(this->numXTCFrames))) {
@@ -919,6 +928,7 @@ bool PDBLoader::getData(core::Call& call) {
         dc->SetChargeRange(this->data[0]->MinCharge(), this->data[0]->MaxCharge());
         dc->SetOccupancyRange(this->data[0]->MinOccupancy(), this->data[0]->MaxOccupancy());
         dc->SetFormerAtomIndices(this->atomFormerIdx.PeekElements());
+        posFrame = fr->FrameNumber();
     }
 
     dc->SetConnections(
@@ -935,8 +945,36 @@ bool PDBLoader::getData(core::Call& call) {
     dc->SetChains(
         static_cast<unsigned int>(this->chain.Count()), (MolecularDataCall::Chain*)this->chain.PeekElements());
 
-    if ((!this->secStructAvailable || this->recomputeStridePerFrameSlot.Param<param::BoolParam>()->Value()) &&
+    const bool precompute = this->precomputeStrideSlot.Param<param::BoolParam>()->Value();
+    if (!precompute || !this->strideFlagSlot.Param<param::BoolParam>()->Value() ||
+        !this->recomputeStridePerFrameSlot.Param<param::BoolParam>()->Value()) {
+        this->strideCache.Stop();
+    }
+
+    if (this->recomputeStridePerFrameSlot.Param<param::BoolParam>()->Value() &&
         this->strideFlagSlot.Param<param::BoolParam>()->Value()) {
+        // reuse the assignment if the frame was computed before
+        this->strideAssignment = this->strideCache.Get(posFrame);
+        if (this->strideAssignment == nullptr) {
+            time_t t = clock(); // DEBUG
+            Stride frameStride(dc);
+            this->strideAssignment = std::make_shared<const Stride::Assignment>(frameStride.GetAssignment());
+            this->strideCache.Put(posFrame, this->strideAssignment);
+            Log::DefaultLog.WriteMsg(Log::LEVEL_INFO,
+                "Secondary Structure of frame %u computed via STRIDE in %f seconds.", posFrame,
+                (double(clock() - t) / double(CLOCKS_PER_SEC))); // DEBUG
+        }
+        Stride::WriteToInterface(*this->strideAssignment, dc);
+
+        const unsigned int frameCnt =
+            this->xtcFileValid ? this->numXTCFrames : static_cast<unsigned int>(this->data.Count());
+        if (precompute && !this->strideCache.IsPrecomputing() && (this->strideCache.CachedFrameCount() < frameCnt)) {
+            // the thread works on a copy, and is stopped by 'resetAllData' before the data is reloaded
+            const std::shared_ptr<const StrideInput> input = this->snapshotStrideInput();
+            this->strideCache.Precompute(frameCnt, posFrame,
+                [this, input](unsigned int idx) { return this->computeSecStructure(*input, idx); });
+        }
+    } else if (!this->secStructAvailable && this->strideFlagSlot.Param<param::BoolParam>()->Value()) {
         time_t t = clock(); // DEBUG
         if (this->stride)
             delete this->stride;
@@ -1011,6 +1049,8 @@ bool PDBLoader::getExtent(core::Call& call) {
 void PDBLoader::release(void) {
     // stop frame-loading thread before clearing data array
     resetFrameCache();
+    this->strideCache.Clear();
+    this->strideAssignment.reset();
 
     for (int i = 0; i < (int)this->data.Count(); i++)
         delete data[i];
@@ -1984,8 +2024,9 @@ bool PDBLoader::IsAminoAcid(vislib::StringA resName) {
  * reset all data containers.
  */
 void PDBLoader::resetAllData() {
-    // stop frame-loading thread before clearing data array
+    // stop frame-loading and STRIDE threads before clearing data array
     resetFrameCache();
+    this->strideCache.Clear();
 
     unsigned int cnt;
     //this->data.Clear();
@@ -2220,6 +2261,89 @@ void PDBLoader::writeToXtcFile(const vislib::TString& filename) {
     outfile.close();
 }
 
+/*
+ * PDBLoader::computeSecStructure
+ */
+StrideTrajectoryCache::AssignmentPtr PDBLoader::computeSecStructure(const StrideInput& input, unsigned int idx) const {
+    const float* positions = nullptr;
+    std::unique_ptr<Frame> xtcFrame;
+    if (!input.xtcPath.empty()) {
+        // the frame is read into a private buffer, the frame cache belongs to the loading thread
+        if (idx >= input.xtcFrameOffset.Count()) {
+            return nullptr;
+        }
+        std::fstream xtcFile;
+        xtcFile.open(input.xtcPath, std::ios::in | std::ios::binary);
+        if (!xtcFile) {
+            return nullptr;
+        }
+        xtcFile.seekg(input.xtcFrameOffset[idx]);
+        xtcFrame = std::make_unique<Frame>(*const_cast<PDBLoader*>(this));
+        xtcFrame->SetAtomCount(input.atomCount);
+        xtcFrame->readFrame(&xtcFile);
+        xtcFile.close();
+        positions = xtcFrame->AtomPositions();
+    } else {
+        if (idx >= input.positions.size()) {
+            return nullptr;
+        }
+        positions = input.positions[idx].data();
+    }
+
+    MolecularDataCall dc;
+    dc.SetAtoms(input.atomCount, static_cast<unsigned int>(input.atomType.Count()), input.atomTypeIdx.PeekElements(),
+        positions, input.atomType.PeekElements(), input.atomResidueIdx.PeekElements(),
+        const_cast<float*>(input.bfactor.data()), input.charge.data(), input.occupancy.data());
+    dc.SetResidues(static_cast<unsigned int>(input.residuePtr.Count()),
+        (const MolecularDataCall::Residue**)input.residuePtr.PeekElements());
+    dc.SetResidueTypeNames(static_cast<unsigned int>(input.residueTypeName.Count()),
+        (vislib::StringA*)input.residueTypeName.PeekElements());
+    dc.SetMolecules(static_cast<unsigned int>(input.molecule.Count()),
+        (MolecularDataCall::Molecule*)input.molecule.PeekElements());
+    dc.SetChains(
+        static_cast<unsigned int>(input.chain.Count()), (MolecularDataCall::Chain*)input.chain.PeekElements());
+
+    Stride frameStride(&dc);
+    return std::make_shared<const Stride::Assignment>(frameStride.GetAssignment());
+}
+
+/*
+ * PDBLoader::snapshotStrideInput
+ */
+std::shared_ptr<const PDBLoader::StrideInput> PDBLoader::snapshotStrideInput(void) const {
+    auto input = std::make_shared<StrideInput>();
+    Frame* first = this->data[0];
+    input->atomCount = first->AtomCount();
+    input->atomTypeIdx = this->atomTypeIdx;
+    input->atomType = this->atomType;
+    input->atomResidueIdx = this->atomResidueIdx;
+    input->residue.SetCount(this->residue.Count());
+    input->residuePtr.SetCount(this->residue.Count());
+    for (SIZE_T i = 0; i < this->residue.Count(); i++) {
+        input->residue[i] = *this->residue[i];
+        input->residuePtr[i] = &input->residue[i];
+    }
+    input->residueTypeName = this->residueTypeName;
+    input->molecule = this->molecule;
+    input->chain = this->chain;
+
+    input->bfactor.assign(first->AtomBFactor(), first->AtomBFactor() + input->atomCount);
+    input->charge.assign(first->AtomCharge(), first->AtomCharge() + input->atomCount);
+    input->occupancy.assign(first->AtomOccupancy(), first->AtomOccupancy() + input->atomCount);
+
+    if (this->xtcFileValid) {
+        input->xtcPath = this->xtcFilenameSlot.Param<core::param::FilePathParam>()->Value();
+        input->xtcFrameOffset = this->XTCFrameOffset;
+    } else {
+        input->positions.resize(this->data.Count());
+        for (SIZE_T i = 0; i < this->data.Count(); i++) {
+            const float* pos = this->data[i]->AtomPositions();
+            input->positions[i].assign(pos, pos + 3 * input->atomCount);
+        }
+    }
+    return input;
+}
+
 
 void PDBLoader::parseBBoxEntry(vislib::StringA& bboxEntry) {
     float bboxLeft = float(atof(bboxEntry.Substring(5, 12)));
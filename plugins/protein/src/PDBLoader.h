@@ -14,6 +14,7 @@
 #include "MDDriverConnector.h"
 #include "MultiPDBLoader.h"
 #include "Stride.h"
+#include "StrideTrajectoryCache.h"
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/CallerSlot.h"
 #include "mmcore/param/ParamSlot.h"
@@ -24,7 +25,10 @@
 #include "vislib/Array.h"
 #include "vislib/math/Cuboid.h"
 #include "vislib/math/Vector.h"
+#include <filesystem>
 #include <fstream>
+#include <memory>
+#include <vector>
 
 #ifdef WITH_CURL
 #include <curl/curl.h>
@@ -655,6 +659,52 @@ private:
      */
     void writeToXtcFile(const vislib::TString& filename);
 
+    /**
+     * The inputs of the STRIDE precomputation. They are copied when the
+     * precomputation starts, so the loader may change its data meanwhile.
+     */
+    struct StrideInput {
+        /** The topology */
+        unsigned int atomCount;
+        vislib::Array<unsigned int> atomTypeIdx;
+        vislib::Array<megamol::protein_calls::MolecularDataCall::AtomType> atomType;
+        vislib::Array<int> atomResidueIdx;
+        vislib::Array<megamol::protein_calls::MolecularDataCall::Residue> residue;
+        vislib::Array<const megamol::protein_calls::MolecularDataCall::Residue*> residuePtr;
+        vislib::Array<vislib::StringA> residueTypeName;
+        vislib::Array<megamol::protein_calls::MolecularDataCall::Molecule> molecule;
+        vislib::Array<megamol::protein_calls::MolecularDataCall::Chain> chain;
+
+        /** The b-factors, charges and occupancies of the first frame */
+        std::vector<float> bfactor, charge, occupancy;
+
+        /** The atom positions of all frames, if no XTC file is loaded */
+        std::vector<std::vector<float>> positions;
+
+        /** The XTC file and the offsets of its frames, if one is loaded */
+        std::filesystem::path xtcPath;
+        vislib::Array<unsigned int> xtcFrameOffset;
+    };
+
+    /**
+     * Copies the inputs of the STRIDE precomputation.
+     *
+     * @return The inputs.
+     */
+    std::shared_ptr<const StrideInput> snapshotStrideInput(void) const;
+
+    /**
+     * Computes the secondary structure of one frame from a copy of the
+     * inputs, so it can run on the STRIDE precomputation thread. The loader
+     * itself is only used as the owner of the temporary XTC frame.
+     *
+     * @param input The copied inputs.
+     * @param idx   The index of the frame.
+     *
+     * @return The assignment or nullptr if the frame could not be read.
+     */
+    StrideTrajectoryCache::AssignmentPtr computeSecStructure(const StrideInput& input, unsigned int idx) const;
+
 
     // -------------------- variables --------------------
 
@@ -681,6 +731,8 @@ private:
     core::param::ParamSlot calcBondsSlot;
     /** Determine whether to recompute STRIDE each frame */
     core::param::ParamSlot recomputeStridePerFrameSlot;
+    /** Determine whether to precompute STRIDE for all frames in the background */
+    core::param::ParamSlot precomputeStrideSlot;
 
     /** The data */
     vislib::Array<Frame*> data;
@@ -738,6 +790,10 @@ private:
     Stride* stride;
     /** Flag whether secondary structure is available */
     bool secStructAvailable;
+    /** The STRIDE assignments per frame if STRIDE is recomputed each frame */
+    StrideTrajectoryCache strideCache;
+    /** The assignment of the current frame, referenced by the call */
+    StrideTrajectoryCache::AssignmentPtr strideAssignment;
 
     // Temporary variables for molecular chains
     vislib::Array<unsigned int> chainFirstRes;
@@ -20,6 +20,7 @@
 #include <cfloat>
 #include <climits>
 #include <cmath>
+#include <cstring>
 
 #include "mmcore/BoundingBoxes_2.h"
 
@@ -225,15 +226,21 @@ void SolPathDataSource::loadData(void) {
             this->filenameslot.Param<param::FilePathParam>()->Value().generic_u8string().c_str());
         return;
     }
-    file.Seek(blockInfo->start, File::BEGIN);
+    // parse the block directly from the mapping instead of copying it value by value
+    vislib::sys::MemmappedFile::ConstView block = file.View(blockInfo->start, blockInfo->size);
+    const char* pos = block.Data();
+    const char* blockEnd = block.end();
 
     // load data
-    unsigned int atomCount;
-    file.Read(&atomCount, 4);
+    unsigned int atomCount = 0;
+    if (pos + 4 <= blockEnd) {
+        ::memcpy(&atomCount, pos, 4);
+        pos += 4;
+    }
 
     this->pathlines.AssertCapacity(atomCount);
 
-    for (SIZE_T a = 0; a < atomCount; a++) {
+    for (SIZE_T a = 0; (a < atomCount) && (pos + 8 <= blockEnd); a++) {
         unsigned int tmp, framesCount;
         SolPathDataCall::Vertex vertex;
         SolPathDataCall::Pathline path;
@@ -243,15 +250,19 @@ void SolPathDataSource::loadData(void) {
         path.length = 0;
         path.data = NULL; // will be set later
 
-        file.Read(&tmp, 4);
+        ::memcpy(&tmp, pos, 4);
         path.id = tmp;
-        file.Read(&framesCount, 4);
+        ::memcpy(&framesCount, pos + 4, 4);
+        pos += 8;
+        if (static_cast<SIZE_T>(blockEnd - pos) / 16 < framesCount) {
+            framesCount = static_cast<unsigned int>((blockEnd - pos) / 16);
+        }
 
         this->vertices.AssertCapacity(this->vertices.Count() + framesCount);
 
-        for (SIZE_T e = 0; e < framesCount; e++) {
-            file.Read(&tmp, 4);
-            file.Read(&vertex.x, 12);
+        for (SIZE_T e = 0; e < framesCount; e++, pos += 16) {
+            ::memcpy(&tmp, pos, 4);
+            ::memcpy(&vertex.x, pos + 4, 12);
 
             if (tmp != static_cast<unsigned int>(vertex.time) + 1) {
                 // start a new path
@@ -272,6 +283,7 @@ void SolPathDataSource::loadData(void) {
             this->pathlines.Add(path);
         }
     }
+    block.Release();
 
     Log::DefaultLog.WriteMsg(Log::LEVEL_INFO + 1000, "Finished solpath file IO");
 
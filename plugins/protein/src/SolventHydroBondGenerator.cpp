@@ -25,8 +25,10 @@
 #include "vislib/sys/PerformanceCounter.h"
 #include "vislib/sys/sysfunctions.h"
 #include "vislib/types.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
 #include <fstream>
-#include <iostream>
 #include <omp.h>
 
 using namespace megamol;
@@ -45,7 +47,9 @@ megamol::protein::SolventHydroBondGenerator::SolventHydroBondGenerator()
               "hBondDonorAcceptorDistance", "distance between donor and acceptor of the hydrogen bonds")
         , hBondDonorAcceptorAngle(
               "hBondDonorAcceptorAngle", "angle between donor-acceptor and donor-hydrogen in degrees")
-        , showMiddlePositions("showMiddlePositions", "show the middle of all atom positions over time") {
+        , hBondCacheFile("hBondCacheFile", "file caching the hydrogen bonds of all frames (empty: keep in memory)")
+        , showMiddlePositions("showMiddlePositions", "show the middle of all atom positions over time")
+        , hBondDataHash(0) {
     this->molDataInputCallerSlot.SetCompatibleCall<MolecularDataCallDescription>();
     this->MakeSlotAvailable(&this->molDataInputCallerSlot);
 
@@ -67,8 +71,8 @@ megamol::protein::SolventHydroBondGenerator::SolventHydroBondGenerator()
     this->hBondDonorAcceptorAngle.SetParameter(new param::FloatParam(30.0f, 0.0f));
     this->MakeSlotAvailable(&this->hBondDonorAcceptorAngle);
 
-    //this->hBondDataFile.SetParameter(new param::StringParam("hbond.dat"));
-    //this->MakeSlotAvailable( &this->hBondDataFile);
+    this->hBondCacheFile.SetParameter(new param::FilePathParam("", param::FilePathParam::Flag_File_ToBeCreated));
+    this->MakeSlotAvailable(&this->hBondCacheFile);
 
     this->showMiddlePositions.SetParameter(new param::BoolParam(false));
     this->MakeSlotAvailable(&this->showMiddlePositions);
@@ -77,12 +81,9 @@ megamol::protein::SolventHydroBondGenerator::SolventHydroBondGenerator()
         curHBondFrame[i] = -1;
 
     this->maxOMPThreads = omp_get_max_threads();
-    this->neighbourIndices = new vislib::Array<unsigned int>[this->maxOMPThreads];
-    //this->neighbHydrogenIndices = new vislib::Array<unsigned int>[this->maxOMPThreads];
 }
 
 megamol::protein::SolventHydroBondGenerator::~SolventHydroBondGenerator() {
-    delete[] this->neighbourIndices;
     this->Release();
 }
 
@@ -93,6 +94,7 @@ bool megamol::protein::SolventHydroBondGenerator::create(void) {
 
 void megamol::protein::SolventHydroBondGenerator::release(void) {
     // hier alles freigeben was in create() initialisiert wird!
+    this->hBondCache.Clear();
 }
 
 /**
@@ -113,13 +115,13 @@ void megamol::protein::SolventHydroBondGenerator::calcSpatialProbabilities(
     memset(&this->middleAtomPos[0], 0, this->middleAtomPos.Count() * sizeof(float));
 
     float* middlePosPtr = &this->middleAtomPos[0];
-    const float* atomPositions = src->AtomPositions();
 
-    //#pragma omp parallel for private( ??? )
+    // the frames can only be fetched one after the other, so only the accumulation is parallel
     for (int i = 0; i < nFrames; i++) {
         src->SetFrameID(i, true);
         if (!(*src)(MolecularDataCall::CallForGetData))
             continue; // return false;
+        const float* atomPositions = src->AtomPositions();
 
 #pragma omp parallel for
         for (int aIdx = 0; aIdx < nAtoms * 3; aIdx += 3) {
@@ -149,401 +151,395 @@ void megamol::protein::SolventDataGenerator::findDonors(MolecularDataCall *data)
 */
 
 
-#if 0
-class HbondIO {
-private:
-    vislib::sys::File *readHandle, *writeHandle;
+void megamol::protein::SolventHydroBondGenerator::prepareHydroBonds(MolecularDataCall* data) {
+    const unsigned int atomCnt = data->AtomCount();
+    if ((this->atomResidues.size() == atomCnt) && (this->hydrogenConnections.Count() > 0))
+        return;
 
-    /*vislib::sys::File::FileSize*/
-    unsigned int dataStartOffset, atomCount, frameCount, frameSizeInBytes;
+    const MolecularDataCall::AtomType* atomTypes = data->AtomTypes();
+    const unsigned int* atomTypeIndices = data->AtomTypeIndices();
 
-public:
-    HbondIO(unsigned int atomCount, unsigned int frameCount, const vislib::StringA& fname, bool read)
-        : dataStartOffset(0), atomCount(atomCount), frameCount(frameCount) {
-        if (read) {
-            readHandle = new vislib::sys::MemmappedFile();
-            if (!readHandle->Open(fname, vislib::sys::File::READ_ONLY, vislib::sys::File::SHARE_READ, vislib::sys::File::OPEN_ONLY)) {
-                delete readHandle;
-                readHandle = 0;
-            }
-            writeHandle = 0;
-        } else {
-            writeHandle = new vislib::sys::MemmappedFile();
-            if (!writeHandle->Open(fname, vislib::sys::File::WRITE_ONLY, vislib::sys::File::SHARE_READ, vislib::sys::File::CREATE_OVERWRITE)) {
-                delete writeHandle;
-                writeHandle = 0;
-            }
-            readHandle = 0;
+    /* create hydrogen connections */
+    this->hydrogenConnections.SetCount(atomCnt * MAX_HYDROGENS_PER_ATOM + 1);
+    memset(&this->hydrogenConnections[0], -1, this->hydrogenConnections.Count() * sizeof(int));
+    int count = data->ConnectionCount();
+    for (int i = 0; i < count; i++) {
+        int idx0 = data->Connection()[2 * i];
+        int idx1 = data->Connection()[2 * i + 1];
+        char element0 = atomTypes[atomTypeIndices[idx0]].Name()[0];
+        char element1 = atomTypes[atomTypeIndices[idx1]].Name()[0];
+
+        /* make sure the hydrogen atom is 'idx1' */
+        if (element0 == 'H') {
+            vislib::math::Swap(idx0, idx1);
+            vislib::math::Swap(element0, element1);
         }
-    }
-    ~HbondIO() {
-        delete readHandle;
-        delete writeHandle;
-    }
 
-    bool writeFrame(int *frame, unsigned int frameId) {
-        if (!writeHandle)
-            return false;
+        // check if we have a possible donor/acceptor here ...
+        if (element0 != 'O' && element0 != 'N')
+            continue;
 
-        // write header at first
-        if ( dataStartOffset == 0) {
-            dataStartOffset = 4*sizeof(dataStartOffset); // store 4 ineteger entries as header for now ...
-            frameSizeInBytes = atomCount * sizeof(int); // 1 signed integer per atom specifying the hbond connection to another atom
-            writeHandle->Write(&dataStartOffset, sizeof(dataStartOffset));
-            writeHandle->Write(&atomCount, sizeof(atomCount));
-            writeHandle->Write(&frameCount, sizeof(frameCount));
-            writeHandle->Write(&frameSizeInBytes, sizeof(frameSizeInBytes));
-            ASSERT(writeHandle->Tell()==dataStartOffset);
-            if (writeHandle->Tell()!=dataStartOffset)
-                return false;
+        // add hydrogen connection if present ...
+        if (element1 == 'H') {
+            int hydrogenConnIdx = idx0 * MAX_HYDROGENS_PER_ATOM;
+            for (int j = 0; j < MAX_HYDROGENS_PER_ATOM; j++) {
+                if (hydrogenConnections[hydrogenConnIdx] == -1) {
+                    hydrogenConnections[hydrogenConnIdx] = idx1;
+                    break;
+                }
+                hydrogenConnIdx++;
+            }
         }
-
-        ASSERT(frameId < frameCount);
-        writeHandle->Seek(dataStartOffset + frameId*frameSizeInBytes);
-        if (writeHandle->Write(frame, frameSizeInBytes) != frameSizeInBytes)
-            return false;
-        return true;
     }
 
-    bool readFrame(int *frame, unsigned int frameId) {
-        if (!readHandle)
-            return false;
-
-        // read header at first
-        if ( dataStartOffset == 0) {
-            readHandle->Read(&dataStartOffset, sizeof(dataStartOffset));
-            readHandle->Read(&atomCount, sizeof(atomCount));
-            readHandle->Read(&frameCount, sizeof(frameCount));
-            readHandle->Read(&frameSizeInBytes, sizeof(frameSizeInBytes));
-            ASSERT(frameSizeInBytes==atomCount * sizeof(int)); // this is some sort of file type/integrity check ...
-            if (frameSizeInBytes!=atomCount * sizeof(int))
-                return false;
-        }
-
-        ASSERT(frameId < frameCount);
-        readHandle->Seek(dataStartOffset + frameId*frameSizeInBytes);
-        if (readHandle->Read(frame, frameSizeInBytes) != frameSizeInBytes)
-            return false;
-        return true;
+    this->donorAcceptors.SetCount(atomCnt + 1);
+    memset(&this->donorAcceptors[0], -1, this->donorAcceptors.Count() * sizeof(int));
+    for (unsigned int i = 0; i < atomCnt; i++) {
+        char element = atomTypes[atomTypeIndices[i]].Name()[0];
+        if (element == 'O' || element == 'N')
+            donorAcceptors[i] = 1;
     }
-};
-#endif
-
-
-void megamol::protein::SolventHydroBondGenerator::calcHydroBondsForCurFrame(
-    MolecularDataCall* data, const float* atomPositions, int* atomHydroBondsIndicesPtr) {
-    //const float *atomPositions = data->AtomPositions();
-    const MolecularDataCall::AtomType* atomTypes = data->AtomTypes();
-    const unsigned int* atomTypeIndices = data->AtomTypeIndices();
-    const int* atomResidueIndices = data->AtomResidueIndices();
 
-    // set all entries to "not connected"
-    memset(atomHydroBondsIndicesPtr, -1, sizeof(int) * data->AtomCount());
-
-    if (reverseConnection.Count() < data->AtomCount())
-        reverseConnection.SetCount(data->AtomCount());
-    int* reverseConnectionPtr = &reverseConnection[0];
-    memset(reverseConnectionPtr, -1, reverseConnection.Count() * sizeof(int));
-
-    vislib::sys::PerformanceCounter timer(true);
-    //timer.SetMark();
-
-#if 0
-    float hbondDist = hBondDistance.Param<param::FloatParam>()->Value();
-    neighbourFinder.SetPointData(atomPositions, data->AtomCount(), data->AccessBoundingBoxes().ObjectSpaceBBox(), hbondDist);
-
-    // looping over residues may not be a good idea?! (index-traversal?) loop over all possible acceptors ...
-#pragma omp parallel for
-    for( int rIdx = 0; rIdx < data->ResidueCount(); rIdx++ ) {
-        const MolecularDataCall::Residue *residue = data->Residues()[rIdx];
+    this->atomResidues.assign(data->AtomResidueIndices(), data->AtomResidueIndices() + atomCnt);
 
-        // we're only interested in hydrogen bonds between polymer/protein molecule and surounding solvent
+    // we're only interested in hydrogen bonds between polymer/protein molecule and surounding solvent
+    this->polymerResidues.clear();
+    for (unsigned int rIdx = 0; rIdx < data->ResidueCount(); rIdx++) {
+        const MolecularDataCall::Residue* residue = data->Residues()[rIdx];
         if (data->IsSolvent(residue))
             continue;
+        PolymerResidue polymerResidue = {static_cast<int>(rIdx), residue->FirstAtomIndex(),
+            residue->FirstAtomIndex() + residue->AtomCount()};
+        this->polymerResidues.push_back(polymerResidue);
+    }
+}
 
-        // find possible acceptor atoms in the current residuum (for now just O, N, C(?)
-
-        // vorerst nur Sauerstoff und Stickstoff als Akzeptor/Donator (N, O)
-        int lastAtomIdx = residue->FirstAtomIndex()+residue->AtomCount();
-        for(int aIdx = residue->FirstAtomIndex(); aIdx < lastAtomIdx; aIdx++) {
-            // is this atom already connected?
-            if (reverseConnectionPtr[aIdx] != -1)
-                continue;
 
-            const MolecularDataCall::AtomType& t = atomTypes[atomTypeIndices[aIdx]];
-            const vislib::StringA& name = t.Name();
-            char element = name[0];
+void megamol::protein::SolventHydroBondGenerator::calcHydroBonds(
+    const float* atomPositions, float distance, float angle, int* atomHydroBondsIndicesPtr) const {
+    const unsigned int atomCnt = static_cast<unsigned int>(this->atomResidues.size());
 
-/*
-JW: ich fuerchte fuer eine allgemeine Deffinition der Wasserstoffbruecken muss man ueber die Bindungsenergien gehen und diese berechnen.
-Fuer meine Simulationen und alle Bio-Geschichten reicht die Annahme, dass Sauerstoff, Stickstoff und Fluor (was fast nie vorkommt)
-Wasserstoffbruecken bilden und dabei als Donor und Aktzeptor dienen koenne. Dabei ist der Wasserstoff am Donor gebunden und bildet die Bruecke zum Akzeptor.
-*/
-            if (element=='N' || element=='O' /*|| element=='F' || element=='C'??*/) {
-                int ompThreadID = omp_get_thread_num();
-                neighbourIndices[ompThreadID].Clear(); // clear, keep capacity ...
-                neighbourIndices[ompThreadID].SetCapacityIncrement( 100); // set capacity increment
-                neighbourFinder.FindNeighboursInRange(&atomPositions[aIdx*3], hbondDist, neighbourIndices[ompThreadID]);
-                for(int nIdx = 0; nIdx<neighbourIndices[ompThreadID].Count(); nIdx++) {
-                    int neighbIndex = neighbourIndices[ompThreadID][nIdx];
-                    // atom from the current residue?
-                    if (atomResidueIndices[neighbIndex]==rIdx)
-                        continue;
-                    // check if a H-atom is in range and add a h-bond...
-                    if (atomTypes[atomTypeIndices[neighbIndex]].Name()[0]=='H') {
-                        atomHydroBondsIndicesPtr[aIdx] = neighbIndex;
-                        // avoid double checks - only one hydrogen bond per atom?!
-                        reverseConnectionPtr[neighbIndex] = aIdx;
-                        // TODO: maybe mark double time? or double with negative index?
-                    }
-                }
-            } else if (element=='H') {
-                // TODO !?
-            }
+    // set all entries to "not connected"
+    memset(atomHydroBondsIndicesPtr, -1, sizeof(int) * atomCnt);
+
+    const int* donorAcceptorsPtr = this->donorAcceptors.PeekElements();
+    const int* hydrogenConnectionsPtr = this->hydrogenConnections.PeekElements();
+    const int* atomResiduesPtr = this->atomResidues.data();
+
+    // only fill in donors/acceptors into the cell list, the cells are at least as large as 'distance'
+    float bboxMin[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+    float bboxMax[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    unsigned int donorAcceptorCnt = 0;
+    for (unsigned int atomIndex = 0; atomIndex < atomCnt; atomIndex++) {
+        if (donorAcceptorsPtr[atomIndex] == -1)
+            continue;
+        for (int i = 0; i < 3; i++) {
+            bboxMin[i] = std::min(bboxMin[i], atomPositions[atomIndex * 3 + i]);
+            bboxMax[i] = std::max(bboxMax[i], atomPositions[atomIndex * 3 + i]);
+        }
+        donorAcceptorCnt++;
+    }
+    if (donorAcceptorCnt == 0)
+        return;
+
+    const int maxCellsPerAxis = 128;
+    float cellSize[3];
+    int cells[3];
+    for (int i = 0; i < 3; i++) {
+        cellSize[i] = std::max(std::max(distance, (bboxMax[i] - bboxMin[i]) / maxCellsPerAxis), 1.0e-3f);
+        cells[i] = std::min(static_cast<int>((bboxMax[i] - bboxMin[i]) / cellSize[i]) + 1, maxCellsPerAxis);
+    }
+    auto cellCoord = [&](const float* pos, int i) -> int {
+        return std::min(static_cast<int>((pos[i] - bboxMin[i]) / cellSize[i]), cells[i] - 1);
+    };
+    auto cellIndex = [&](const float* pos) -> unsigned int {
+        return (cellCoord(pos, 2) * cells[1] + cellCoord(pos, 1)) * cells[0] + cellCoord(pos, 0);
+    };
+
+    // counting sort of the donors/acceptors into the cells
+    std::vector<unsigned int> cellStart(cells[0] * cells[1] * cells[2] + 1, 0);
+    std::vector<unsigned int> cellAtoms(donorAcceptorCnt);
+    for (unsigned int atomIndex = 0; atomIndex < atomCnt; atomIndex++) {
+        if (donorAcceptorsPtr[atomIndex] != -1)
+            cellStart[cellIndex(&atomPositions[atomIndex * 3]) + 1]++;
+    }
+    for (size_t c = 1; c < cellStart.size(); c++)
+        cellStart[c] += cellStart[c - 1];
+    {
+        std::vector<unsigned int> cellFill(cellStart.begin(), cellStart.end() - 1);
+        for (unsigned int atomIndex = 0; atomIndex < atomCnt; atomIndex++) {
+            if (donorAcceptorsPtr[atomIndex] != -1)
+                cellAtoms[cellFill[cellIndex(&atomPositions[atomIndex * 3])]++] = atomIndex;
         }
     }
-#else
 
-    /* create hydrogen connections */
-    if (this->hydrogenConnections.Count() <= data->AtomCount() * MAX_HYDROGENS_PER_ATOM) {
-        this->hydrogenConnections.SetCount(data->AtomCount() * MAX_HYDROGENS_PER_ATOM);
-        memset(&this->hydrogenConnections[0], -1, this->hydrogenConnections.Count() * sizeof(int));
-        int count = data->ConnectionCount();
-        for (int i = 0; i < count; i++) {
-            int idx0 = data->Connection()[2 * i];
-            int idx1 = data->Connection()[2 * i + 1];
-            char element0 = atomTypes[atomTypeIndices[idx0]].Name()[0];
-            char element1 = atomTypes[atomTypeIndices[idx1]].Name()[0];
-
-            /* make sure the hydrogen atom is 'idx1' */
-            if (element0 == 'H') {
-                vislib::math::Swap(idx0, idx1);
-                vislib::math::Swap(element0, element1);
+    const float distanceSq = distance * distance;
+
+    // check for a hydrogen bond between the donor/acceptor pair in both directions
+    auto checkPair = [&](int atomIndex, int neighbIndex) {
+        // loop over hydrogen atoms from donor 'atomIndex' - 'neighbIndex' is the acceptor
+        int hydrogenConnIdx = atomIndex * MAX_HYDROGENS_PER_ATOM;
+        for (int j = 0; j < MAX_HYDROGENS_PER_ATOM; j++) {
+            int hydrogenAtomIdx = hydrogenConnectionsPtr[hydrogenConnIdx];
+            if (hydrogenAtomIdx != -1 &&
+                validHydrogenBond(atomIndex, hydrogenAtomIdx, neighbIndex, atomPositions, angle)) {
+                atomHydroBondsIndicesPtr[neighbIndex] = hydrogenAtomIdx;
+                // TODO: maybe mark double time? or double with negative index?
+                break;
             }
+            hydrogenConnIdx++;
+        }
+        // loop over hydrogen atoms from donor 'neighbIndex' - 'atomIndex' is the acceptor
+        hydrogenConnIdx = neighbIndex * MAX_HYDROGENS_PER_ATOM;
+        for (int j = 0; j < MAX_HYDROGENS_PER_ATOM; j++) {
+            int hydrogenAtomIdx = hydrogenConnectionsPtr[hydrogenConnIdx];
+            if (hydrogenAtomIdx != -1 &&
+                validHydrogenBond(neighbIndex, hydrogenAtomIdx, atomIndex, atomPositions, angle)) {
+                atomHydroBondsIndicesPtr[atomIndex] = hydrogenAtomIdx;
+                // TODO: maybe mark double time? or double with negative index?
+                break;
+            }
+            hydrogenConnIdx++;
+        }
+    };
+
+    /*
+    JW: ich fuerchte fuer eine allgemeine Deffinition der Wasserstoffbruecken muss man ueber die Bindungsenergien gehen und diese berechnen.
+    Fuer meine Simulationen und alle Bio-Geschichten reicht die Annahme, dass Sauerstoff, Stickstoff und Fluor (was fast nie vorkommt)
+    Wasserstoffbruecken bilden und dabei als Donor und Aktzeptor dienen koenne. Dabei ist der Wasserstoff am Donor gebunden und bildet die Bruecke zum Akzeptor.
+    */
 
-            // check if we have a possible donor/acceptor here ...
-            if (element0 != 'O' && element0 != 'N')
+    // runs single threaded if several frames are already computed in parallel
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t prIdx = 0; prIdx < static_cast<int64_t>(this->polymerResidues.size()); prIdx++) {
+        const PolymerResidue& residue = this->polymerResidues[prIdx];
+
+        for (unsigned int atomIndex = residue.firstAtom; atomIndex < residue.lastAtom; atomIndex++) {
+            // nitrogen and oxygen can be donors and acceptors here ...
+            if (donorAcceptorsPtr[atomIndex] == -1)
                 continue;
 
-            // add hydrogen connection if present ...
-            if (element1 == 'H') {
-                int hydrogenConnIdx = idx0 * MAX_HYDROGENS_PER_ATOM;
-                for (int j = 0; j < MAX_HYDROGENS_PER_ATOM; j++) {
-                    if (hydrogenConnections[hydrogenConnIdx] == -1) {
-                        hydrogenConnections[hydrogenConnIdx] = idx1;
-                        break;
+            const float* pos = &atomPositions[atomIndex * 3];
+            int cell[3], lo[3], hi[3];
+            for (int i = 0; i < 3; i++) {
+                cell[i] = cellCoord(pos, i);
+                lo[i] = std::max(cell[i] - 1, 0);
+                hi[i] = std::min(cell[i] + 1, cells[i] - 1);
+            }
+            for (int z = lo[2]; z <= hi[2]; z++) {
+                for (int y = lo[1]; y <= hi[1]; y++) {
+                    for (int x = lo[0]; x <= hi[0]; x++) {
+                        const unsigned int c = (z * cells[1] + y) * cells[0] + x;
+                        for (unsigned int k = cellStart[c]; k < cellStart[c + 1]; k++) {
+                            const int neighbIndex = cellAtoms[k];
+                            // atom from the current residue?
+                            if (atomResiduesPtr[neighbIndex] == residue.residue)
+                                continue;
+                            const float* neighbPos = &atomPositions[neighbIndex * 3];
+                            const float dx = neighbPos[0] - pos[0];
+                            const float dy = neighbPos[1] - pos[1];
+                            const float dz = neighbPos[2] - pos[2];
+                            if (dx * dx + dy * dy + dz * dz > distanceSq)
+                                continue;
+                            checkPair(atomIndex, neighbIndex);
+                        }
                     }
-                    hydrogenConnIdx++;
                 }
             }
         }
-
-        this->donorAcceptors.SetCount(data->AtomCount());
-        memset(&this->donorAcceptors[0], -1, this->donorAcceptors.Count() * sizeof(int));
-        for (unsigned int i = 0; i < data->AtomCount(); i++) {
-            char element = atomTypes[atomTypeIndices[i]].Name()[0];
-            if (element == 'O' || element == 'N')
-                donorAcceptors[i] = 1;
-        }
     }
+}
+
+
+void megamol::protein::SolventHydroBondGenerator::calcHydroBondsForCurFrame(
+    MolecularDataCall* data, const float* atomPositions, int* atomHydroBondsIndicesPtr) {
+    vislib::sys::PerformanceCounter timer(true);
 
-    // only fill in donors/acceptors into the neighbour finder grid ...
     float hbondDonorAcceptorDist = hBondDonorAcceptorDistance.Param<param::FloatParam>()->Value();
     float hbondDonorAcceptorAngle = hBondDonorAcceptorAngle.Param<param::FloatParam>()->Value() *
                                     static_cast<float>(vislib::math::PI_DOUBLE / 180.0);
-    neighbourFinder.SetPointData(atomPositions, data->AtomCount(), data->AccessBoundingBoxes().ObjectSpaceBBox(),
-        hbondDonorAcceptorDist, &donorAcceptors[0]);
+    this->prepareHydroBonds(data);
+    this->calcHydroBonds(atomPositions, hbondDonorAcceptorDist, hbondDonorAcceptorAngle, atomHydroBondsIndicesPtr);
 
-    const int* hydrogenConnectionsPtr = hydrogenConnections.PeekElements();
+    core::utility::log::Log::DefaultLog.WriteInfo(
+        "Hydrogen bonds computed in %.3f ms.", timer.ToMillis(timer.Difference()));
+}
 
-    // looping over residues may not be a good idea?! (index-traversal?) loop over all possible acceptors ...
-#pragma omp parallel for
-    for (int rIdx = 0; rIdx < static_cast<int>(data->ResidueCount()); rIdx++) {
-        const MolecularDataCall::Residue* residue = data->Residues()[rIdx];
 
-        // we're only interested in hydrogen bonds between polymer/protein molecule and surounding solvent
-        //#error großes Problem: es werden so nicht alle Wasserstoffbrücken gefunden?!
-        if (data->IsSolvent(residue))
-            continue;
+bool megamol::protein::SolventHydroBondGenerator::buildHBondCache(MolecularDataCall* dataSource) {
+    float hbondDonorAcceptorDist = hBondDonorAcceptorDistance.Param<param::FloatParam>()->Value();
+    float hbondDonorAcceptorAngleDeg = hBondDonorAcceptorAngle.Param<param::FloatParam>()->Value();
+
+    const unsigned int savedFrameId = dataSource->FrameID();
+    HydroBondCache::Key key;
+    key.atomCount = dataSource->AtomCount();
+    key.frameCount = dataSource->FrameCount();
+    key.donorAcceptorDistance = hbondDonorAcceptorDist;
+    key.donorAcceptorAngle = hbondDonorAcceptorAngleDeg;
+    const unsigned int atomCnt = key.atomCount;
+
+    // identify the data set by the atom types and the positions of its first and last frame
+    bool ok = (key.frameCount > 0);
+    key.contentHash = HydroBondCache::Hash(&key.atomCount, sizeof(key.atomCount));
+    for (unsigned int frame : {0u, key.frameCount - 1}) {
+        if (!ok)
+            break;
+        dataSource->SetFrameID(frame, true);
+        ok = (*dataSource)(MolecularDataCall::CallForGetData) && (dataSource->AtomCount() == atomCnt);
+        if (ok) {
+            key.contentHash = HydroBondCache::Hash(
+                dataSource->AtomTypeIndices(), atomCnt * sizeof(unsigned int), key.contentHash);
+            key.contentHash =
+                HydroBondCache::Hash(dataSource->AtomPositions(), atomCnt * 3 * sizeof(float), key.contentHash);
+        }
+        dataSource->Unlock();
+    }
+    if (ok && !(this->hBondCache.IsComplete() && (this->hBondCache.GetKey() == key))) {
+        ok = this->computeHBondCache(dataSource, key);
+    }
 
-        // find possible acceptor atoms in the current residuum (for now just O, N, C(?)
+    // fetch the frame requested by the caller again
+    dataSource->SetFrameID(savedFrameId, true);
+    ok = (*dataSource)(MolecularDataCall::CallForGetData) && ok;
+    if (!ok) {
+        core::utility::log::Log::DefaultLog.WriteError("Failed to compute the hydrogen bonds of all frames.");
+        this->hBondCache.Clear();
+        return false;
+    }
+    return true;
+}
 
-        // vorerst nur Sauerstoff und Stickstoff als Akzeptor/Donator (N, O)
-        unsigned int lastAtomIdx = residue->FirstAtomIndex() + residue->AtomCount();
-        for (unsigned int atomIndex = residue->FirstAtomIndex(); atomIndex < lastAtomIdx; atomIndex++) {
-            // is this atom already connected?
-            //if (reverseConnectionPtr[atomIndex] >= 0 continue;
 
-            /*
-            JW: ich fuerchte fuer eine allgemeine Deffinition der Wasserstoffbruecken muss man ueber die Bindungsenergien gehen und diese berechnen.
-            Fuer meine Simulationen und alle Bio-Geschichten reicht die Annahme, dass Sauerstoff, Stickstoff und Fluor (was fast nie vorkommt)
-            Wasserstoffbruecken bilden und dabei als Donor und Aktzeptor dienen koenne. Dabei ist der Wasserstoff am Donor gebunden und bildet die Bruecke zum Akzeptor.
-            */
+bool megamol::protein::SolventHydroBondGenerator::computeHBondCache(
+    MolecularDataCall* dataSource, const HydroBondCache::Key& key) {
+    this->prepareHydroBonds(dataSource);
 
-            //#error poly->solv, solv->poly! und poly->poly! solv->solv auf keine fall auf der oberfläche! (zumindest unterscheiden)
+    const std::filesystem::path cacheFile = this->hBondCacheFile.Param<param::FilePathParam>()->Value();
+    if (!cacheFile.empty() && this->hBondCache.Open(cacheFile, key)) {
+        core::utility::log::Log::DefaultLog.WriteInfo(
+            "Hydrogen bonds of %u frames loaded from \"%s\".", key.frameCount, cacheFile.string().c_str());
+        return true;
+    }
+    if (!this->hBondCache.BeginWrite(cacheFile, key))
+        return false;
 
-            // nitrogen and oxygen can be donors and acceptors here ...
-            if (donorAcceptors[atomIndex] != -1 /*element=='N' || element=='O'*/) {
-                // access a private array for this parallel thread ...
-                vislib::Array<unsigned int>& privateNeighbourIndices = neighbourIndices[omp_get_thread_num()];
-                privateNeighbourIndices.Clear();                   // clear, keep capacity ...
-                privateNeighbourIndices.SetCapacityIncrement(100); // set capacity increment
-                neighbourFinder.FindNeighboursInRange(
-                    &atomPositions[atomIndex * 3], hbondDonorAcceptorDist, privateNeighbourIndices);
-
-                for (int nIdx = 0; nIdx < (int)privateNeighbourIndices.Count(); nIdx++) {
-                    int neighbIndex = privateNeighbourIndices[nIdx];
-                    //char elementNeighb = atomTypes[atomTypeIndices[neighbIndex]].Name()[0];
-
-                    // atom from the current residue?
-                    if (atomResidueIndices[neighbIndex] == rIdx)
-                        continue;
-
-                    //ASSERT(donorAcceptors[neighbIndex] != -1);
-                    //if ( elementNeighb=='O' || elementNeighb=='N' ) { ... }
-
-
-                    // DEBUG
-                    //atomHydroBondsIndicesPtr[atomIndex] = neighbIndex;
-                    //atomHydroBondsIndicesPtr[neighbIndex] = atomIndex;
-
-                    // check for other acceptor/donor - all atoms inside 'neighbourFinder' only consist of donor/acceptor atoms ..
-                    // loop over hydrogen atoms from donor 'atomIndex'-  - 'neighbIndex' is the acceptor
-                    int hydrogenConnIdx = atomIndex * MAX_HYDROGENS_PER_ATOM;
-                    for (int j = 0; j < MAX_HYDROGENS_PER_ATOM; j++) {
-                        int hydrogenAtomIdx = hydrogenConnectionsPtr[hydrogenConnIdx];
-                        if (hydrogenAtomIdx != -1 && validHydrogenBond(atomIndex, hydrogenAtomIdx, neighbIndex,
-                                                         atomPositions, hbondDonorAcceptorAngle)) {
-                            atomHydroBondsIndicesPtr[neighbIndex] = hydrogenAtomIdx;
-                            // mark this donor/acceptor pair as already connetected with a hydrogen bond
-                            //reverseConnectionPtr[atomIndex] = neighbIndex;
-                            // TODO: maybe mark double time? or double with negative index?
-                            break;
-                        }
-                        hydrogenConnIdx++;
-                    }
-                    // loop over hydrogen atoms from donor 'neighbIndex' - 'atomIndex' is the acceptor
-                    hydrogenConnIdx = neighbIndex * MAX_HYDROGENS_PER_ATOM;
-                    for (int j = 0; j < MAX_HYDROGENS_PER_ATOM; j++) {
-                        int hydrogenAtomIdx = hydrogenConnectionsPtr[hydrogenConnIdx];
-                        if (hydrogenAtomIdx != -1 && validHydrogenBond(neighbIndex, hydrogenAtomIdx, atomIndex,
-                                                         atomPositions, hbondDonorAcceptorAngle)) {
-                            atomHydroBondsIndicesPtr[atomIndex] = hydrogenAtomIdx;
-                            // mark this donor/acceptor pair as already connetected with a hydrogen bond
-                            //reverseConnectionPtr[neighbIndex] = atomIndex;
-                            // TODO: maybe mark double time? or double with negative index?
-                            break;
-                        }
-                        hydrogenConnIdx++;
+    vislib::sys::PerformanceCounter timer(true);
+    const unsigned int atomCnt = key.atomCount;
+    const float hbondDonorAcceptorDist = key.donorAcceptorDistance;
+    const float hbondDonorAcceptorAngle = key.donorAcceptorAngle * static_cast<float>(vislib::math::PI_DOUBLE / 180.0);
+
+    // the frames can only be fetched one after the other, so a batch of frames is fetched and then computed in parallel
+    const unsigned int batchSize = static_cast<unsigned int>(std::max(2 * this->maxOMPThreads, 1));
+    std::vector<std::vector<float>> batchPositions(batchSize);
+    std::vector<HydroBondCache::BondList> batchBonds(batchSize);
+    bool ok = true;
+    for (unsigned int firstFrame = 0; ok && (firstFrame < key.frameCount); firstFrame += batchSize) {
+        const unsigned int frameCnt = std::min(batchSize, key.frameCount - firstFrame);
+        for (unsigned int i = 0; ok && (i < frameCnt); i++) {
+            dataSource->SetFrameID(firstFrame + i, true);
+            ok = (*dataSource)(MolecularDataCall::CallForGetData) && (dataSource->AtomCount() == atomCnt);
+            if (ok)
+                batchPositions[i].assign(dataSource->AtomPositions(), dataSource->AtomPositions() + atomCnt * 3);
+            dataSource->Unlock();
+        }
+        if (!ok)
+            break;
+
+#pragma omp parallel
+        {
+            std::vector<int> atomHydroBonds(atomCnt);
+#pragma omp for schedule(dynamic)
+            for (int64_t i = 0; i < static_cast<int64_t>(frameCnt); i++) {
+                this->calcHydroBonds(
+                    batchPositions[i].data(), hbondDonorAcceptorDist, hbondDonorAcceptorAngle, atomHydroBonds.data());
+                // store (acceptor, hydrogen) pairs instead of one entry per atom
+                HydroBondCache::BondList& bonds = batchBonds[i];
+                bonds.clear();
+                for (unsigned int atomIndex = 0; atomIndex < atomCnt; atomIndex++) {
+                    if (atomHydroBonds[atomIndex] != -1) {
+                        bonds.push_back(static_cast<int32_t>(atomIndex));
+                        bonds.push_back(atomHydroBonds[atomIndex]);
                     }
                 }
             }
         }
+
+        for (unsigned int i = 0; ok && (i < frameCnt); i++)
+            ok = this->hBondCache.Append(batchBonds[i]);
     }
-#endif
+    if (!ok || !this->hBondCache.EndWrite())
+        return false;
 
-    std::cout << "Hydrogen bonds computed in " << std::fixed << timer.ToMillis(timer.Difference()) << " ms."
-              << std::endl;
+    core::utility::log::Log::DefaultLog.WriteInfo("Hydrogen bonds of %u frames computed in %.3f s.", key.frameCount,
+        timer.ToMillis(timer.Difference()) / 1000.0);
+    return true;
 }
 
 
-#if 1
-bool megamol::protein::SolventHydroBondGenerator::calcHydrogenBondStatistics(
-    MolecularDataCall* dataTarget, MolecularDataCall* dataSource) {
-    int savedSrcFrameId = dataSource->FrameID();
-    int savedTargetFrameId = dataTarget->FrameID();
+bool megamol::protein::SolventHydroBondGenerator::calcHydrogenBondStatistics(MolecularDataCall* dataSource) {
+    if (!this->buildHBondCache(dataSource))
+        return false;
 
     int solvResCount = dataSource->AtomSolventResidueCount();
     const unsigned int* solventResidueIndices = dataSource->SolventResidueIndices();
 
-    if (this->hydrogenBondStatistics.Count() < solvResCount * dataSource->AtomCount()) {
-        this->hydrogenBondStatistics.SetCount(solvResCount * dataSource->AtomCount());
-        memset(&this->hydrogenBondStatistics[0], 0, hydrogenBondStatistics.Count() * sizeof(unsigned int));
-    }
+    this->hydrogenBondStatistics.SetCount(solvResCount * dataSource->AtomCount());
+    if (!this->hydrogenBondStatistics.Count())
+        return true;
+    memset(&this->hydrogenBondStatistics[0], 0, hydrogenBondStatistics.Count() * sizeof(unsigned int));
     unsigned int* hydrogenBondStatisticsPtr = &this->hydrogenBondStatistics[0];
 
     unsigned int solventAtoms = 0;
     unsigned int polymerAtoms = 0;
 
+    // solvent flag and solvent type of each residue
+    std::vector<char> isSolvent(dataSource->ResidueCount(), 0);
+    std::vector<int> solventType(dataSource->ResidueCount(), -1);
+    for (unsigned int rIdx = 0; rIdx < dataSource->ResidueCount(); rIdx++) {
+        const MolecularDataCall::Residue* residue = dataSource->Residues()[rIdx];
+        if (dataSource->IsSolvent(residue)) {
+            isSolvent[rIdx] = 1;
+            solventAtoms += residue->AtomCount();
+            for (int srIdx = 0; srIdx < solvResCount; srIdx++) {
+                if (solventResidueIndices[srIdx] == residue->Type()) {
+                    solventType[rIdx] = srIdx;
+                    break;
+                }
+            }
+        } else {
+            polymerAtoms += residue->AtomCount();
+        }
+    }
+
     for (unsigned int frameId = 0; frameId < dataSource->FrameCount(); frameId++) {
-        dataSource->SetFrameID(frameId);
-        dataTarget->SetFrameID(frameId);
-        if (!(*dataSource)(MolecularDataCall::CallForGetData))
-            return false;
-        if (!this->getHBonds(dataTarget, dataSource))
+        if (!this->hBondCache.Read(frameId, this->frameBonds))
             return false;
-        int atomCnt = dataTarget->AtomCount();
-        const int* hydrogenBonds = dataTarget->AtomHydrogenBondIndices();
-        const int* residueIndices = dataTarget->AtomResidueIndices();
-        /*#pragma omp parallel for
-                        for(int atomIdx = 0; atomIdx < atomCnt; atomIdx++) {
-                                int residueIdx = residueIndices[atomIdx];
-                                if (dataTarget->IsSolvent(dataTarget->Residues()[residueIdx]))
-                                        continue;
-                        }*/
-
-        //#pragma omp parallel for
-        for (unsigned int rIdx = 0; rIdx < dataSource->ResidueCount(); rIdx++) {
-            const MolecularDataCall::Residue* residue = dataSource->Residues()[rIdx];
-
-            //if (dataSource->IsSolvent(residue)) continue;
-            bool isSolvent = dataSource->IsSolvent(residue);
-
-            if (frameId == 0) {
-                if (isSolvent)
-                    solventAtoms += residue->AtomCount();
-                else
-                    polymerAtoms += residue->AtomCount();
-            }
 
-            // vorerst nur Sauerstoff und Stickstoff als Akzeptor/Donator (N, O)
-            int lastAtomIdx = residue->FirstAtomIndex() + residue->AtomCount();
-            for (int atomIndex = residue->FirstAtomIndex(); atomIndex < lastAtomIdx; atomIndex++) {
-                if (hydrogenBonds[atomIndex] == -1)
-                    continue;
-                int otherAtomIndex = hydrogenBonds[atomIndex];
-                int otherResidueIdx = residueIndices[otherAtomIndex];
-                const MolecularDataCall::Residue* otherResidue = dataSource->Residues()[otherResidueIdx];
-                bool isOtherSolvent = dataTarget->IsSolvent(otherResidue);
-#if 1
-
-                if (isSolvent != isOtherSolvent) {
-                    // polymer/solvent HBond ...
-                    if (!isSolvent) {
-                        for (int srIdx = 0; srIdx < solvResCount; srIdx++) {
-                            if (solventResidueIndices[srIdx] == otherResidue->Type())
-                                hydrogenBondStatisticsPtr[solvResCount * atomIndex + srIdx]++;
-                        }
-                        //hydrogenBondStatisticsPtr[solvResCount*atomIndex + (rIdx%this->solvResCount)]++;
-                    } else /*if (!isOtherSolvent)*/ {
-                        for (int srIdx = 0; srIdx < solvResCount; srIdx++) {
-                            if (solventResidueIndices[srIdx] == residue->Type())
-                                hydrogenBondStatisticsPtr[solvResCount * otherAtomIndex + srIdx]++;
-                        }
-                        //hydrogenBondStatisticsPtr[solvResCount*otherAtomIndex + (otherResidueIdx%this->solvResCount)]++;
-                    }
-                } else {
-                    // both atoms solvent or both polymer?
-                }
-#else
-                if (!isSolvent)
-                    hydrogenBondStatisticsPtr[atomIndex]++;
-                if (!isOtherSolvent)
-                    hydrogenBondStatisticsPtr[otherAtomIndex]++;
-#endif
+        for (size_t bIdx = 0; bIdx + 1 < this->frameBonds.size(); bIdx += 2) {
+            int atomIndex = this->frameBonds[bIdx];
+            int otherAtomIndex = this->frameBonds[bIdx + 1];
+            int residueIdx = this->atomResidues[atomIndex];
+            int otherResidueIdx = this->atomResidues[otherAtomIndex];
+
+            // both atoms solvent or both polymer?
+            if (isSolvent[residueIdx] == isSolvent[otherResidueIdx])
+                continue;
+
+            // polymer/solvent HBond ...
+            if (!isSolvent[residueIdx]) {
+                if (solventType[otherResidueIdx] >= 0)
+                    hydrogenBondStatisticsPtr[solvResCount * atomIndex + solventType[otherResidueIdx]]++;
+            } else {
+                if (solventType[residueIdx] >= 0)
+                    hydrogenBondStatisticsPtr[solvResCount * otherAtomIndex + solventType[residueIdx]]++;
             }
         }
     }
 
-    /*dataSource*/ dataTarget->SetAtomHydrogenBondStatistics(hydrogenBondStatisticsPtr /*, this->solvResCount*/);
-    dataSource->SetFrameID(savedSrcFrameId);
-    dataTarget->SetFrameID(savedTargetFrameId);
-
-    std::cout << "solvent atoms: " << solventAtoms << " polymer atoms: " << polymerAtoms << std::endl;
+    core::utility::log::Log::DefaultLog.WriteInfo("solvent atoms: %u polymer atoms: %u", solventAtoms, polymerAtoms);
 
     return true;
 }
-#endif
 
 bool megamol::protein::SolventHydroBondGenerator::getHBonds(
     MolecularDataCall* dataTarget, MolecularDataCall* dataSource) {
@@ -552,8 +548,6 @@ bool megamol::protein::SolventHydroBondGenerator::getHBonds(
     float hbondDist = hBondDistance.Param<param::FloatParam>()->Value();
 
     if (curHBondFrame[cacheIndex] == reqFrame) {
-        // recalc hbonds if 'hBondDistance' has changed?!
-        //if( this->hBondDistance.IsDirty() )
         dataTarget->SetAtomHydrogenBondIndices(atomHydroBondsIndices[cacheIndex].PeekElements());
         dataTarget->SetAtomHydrogenBondDistance(hbondDist);
         return true;
@@ -563,59 +557,17 @@ bool megamol::protein::SolventHydroBondGenerator::getHBonds(
     if (atomHydroBonds.Count() < dataSource->AtomCount())
         atomHydroBonds.SetCount(dataSource->AtomCount());
 
-#if 0
-    const vislib::TString fileName = hBondDataFile.Param<param::StringParam>()->Value();
-    if (fileName.IsEmpty())
-        return false;
-
-    if (vislib::sys::File::Exists(fileName)) {
-        HbondIO input(dataSource->AtomCount(), dataSource->FrameCount(), fileName, true);
-        if (input.readFrame(&atomHydroBonds[0], reqFrame)) {
-            curHBondFrame[cacheIndex] = reqFrame;
-            dataTarget->SetAtomHydrogenBondIndices(atomHydroBonds.PeekElements());
-            dataTarget->SetAtomHydrogenBondDistance(hbondDist);
-            return true;
-        }
-        return false;
-    }
-
-    HbondIO *output = new HbondIO(data->AtomCount(), data->FrameCount(), fileName, false);
-
-    int *tmpArray = new int[data->AtomCount()];
-
-    // calculate hydrogen bounds for all frames and store them in a file ...
-    for(int frameId = 0; frameId < data->FrameCount(); frameId++) {
-        int *atomHydroBondsIndicesPtr = (frameId == reqFrame ? &atomHydroBonds[0] : tmpArray);
-
-#if 0
-        // workaround to avoid recursion ...
-        {
-            int tmp = curHBondFrame[frameId % HYDROGEN_BOND_IN_CORE];
-            curHBondFrame[frameId % HYDROGEN_BOND_IN_CORE] = frameId;
-            data->SetFrameID(frameId);
-            if( !(*dataTarget)(MolecularDataCall::CallForGetData))
-                return false;
-            curHBondFrame[frameId % HYDROGEN_BOND_IN_CORE] = tmp;
-            calcHydroBondsForCurFrame(dataTarget, atomHydroBondsIndicesPtr);
-        }
-#else
-        dataSource->SetFrameId(frameId);
-        if( !(*dataSource)(MolecularDataCall::CallForGetData))
+    if (this->hBondCache.IsComplete() && this->hBondCache.Read(reqFrame, this->frameBonds)) {
+        // expand the (acceptor, hydrogen) pairs of the cache
+        memset(&atomHydroBonds[0], -1, atomHydroBonds.Count() * sizeof(int));
+        for (size_t bIdx = 0; bIdx + 1 < this->frameBonds.size(); bIdx += 2)
+            atomHydroBonds[this->frameBonds[bIdx]] = this->frameBonds[bIdx + 1];
+    } else {
+        dataSource->SetFrameID(reqFrame);
+        if (!(*dataSource)(MolecularDataCall::CallForGetData))
             return false;
-        calcHydroBondsForCurFrame(dataSource, atomHydroBondsIndicesPtr);
-#endif
-
-        output->writeFrame(atomHydroBondsIndicesPtr, frameId);
+        calcHydroBondsForCurFrame(dataSource, &atomHydroBonds[0]);
     }
-    delete output;
-    delete tmpArray;
-
-#else
-    dataSource->SetFrameID(reqFrame);
-    if (!(*dataSource)(MolecularDataCall::CallForGetData))
-        return false;
-    calcHydroBondsForCurFrame(dataSource, &atomHydroBonds[0]);
-#endif
 
     curHBondFrame[cacheIndex] = reqFrame;
     dataTarget->SetFrameID(reqFrame);
@@ -655,15 +607,35 @@ bool megamol::protein::SolventHydroBondGenerator::getData(core::Call& call) {
     if (!(*molSource)(MolecularDataCall::CallForGetData))
         return false;
 
-    *molDest = *molSource;
+    // reset all hbond data if the data or one of these parameters changes ...
+    bool hBondsChanged = false;
+    if ((this->hBondDataHash != molSource->DataHash()) || this->hBondDistance.IsDirty() ||
+        this->hBondDonorAcceptorDistance.IsDirty() || this->hBondDonorAcceptorAngle.IsDirty() ||
+        this->hBondCacheFile.IsDirty()) {
+        this->hBondDistance.ResetDirty();
+        this->hBondDonorAcceptorDistance.ResetDirty();
+        this->hBondDonorAcceptorAngle.ResetDirty();
+        this->hBondCacheFile.ResetDirty();
+        this->hBondDataHash = molSource->DataHash();
+        for (int i = 0; i < HYDROGEN_BOND_IN_CORE; i++)
+            this->curHBondFrame[i] = -1;
+        this->hBondCache.Clear();
+        this->hydrogenBondStatistics.Clear();
+        this->middleAtomPos.Clear();
+        this->atomResidues.clear();
+        this->polymerResidues.clear();
+        this->hydrogenConnections.Clear();
+        hBondsChanged = true;
+    }
 
-    // testing?
-    if (!this->hydrogenBondStatistics.Count()) {
-        this->calcHydrogenBondStatistics(molDest, molSource);
-    } else {
-        molDest->SetAtomHydrogenBondStatistics(this->hydrogenBondStatistics.PeekElements());
+    // computes the hydrogen bonds of all frames on the first call
+    if (!this->hBondCache.IsComplete()) {
+        this->calcHydrogenBondStatistics(molSource);
     }
 
+    *molDest = *molSource;
+    molDest->SetAtomHydrogenBondStatistics(this->hydrogenBondStatistics.PeekElements());
+
     if (this->showMiddlePositions.Param<param::BoolParam>()->Value()) {
         if (!middleAtomPos.Count()) {
             calcSpatialProbabilities(molSource, molDest);
@@ -678,17 +650,8 @@ bool megamol::protein::SolventHydroBondGenerator::getData(core::Call& call) {
         molDest->SetAtomHydrogenBondIndices(middleAtomPosHBonds.PeekElements());
         molDest->SetDataHash(molSource->DataHash() * 666);
     } else {
-
-        // reset all hbond data if this parameter changes ...
-        if (this->hBondDistance.IsDirty() || this->hBondDonorAcceptorDistance.IsDirty() ||
-            this->hBondDonorAcceptorAngle.IsDirty()) {
-            this->hBondDistance.ResetDirty();
-            this->hBondDonorAcceptorDistance.ResetDirty();
-            this->hBondDonorAcceptorAngle.ResetDirty();
-            for (int i = 0; i < HYDROGEN_BOND_IN_CORE; i++)
-                this->curHBondFrame[i] = -1;
+        if (hBondsChanged)
             molDest->SetDataHash(molSource->DataHash() * 666); // hacky ?
-        }
 
         getHBonds(molDest, molSource);
     }
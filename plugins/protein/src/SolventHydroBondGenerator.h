@@ -11,17 +11,19 @@
 #pragma once
 #endif /* (defined(_MSC_VER) && (_MSC_VER > 1000)) */
 
+#include "HydroBondCache.h"
 #include "Stride.h"
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/CallerSlot.h"
 #include "mmcore/param/ParamSlot.h"
 #include "mmcore/view/AnimDataModule.h"
-#include "protein/GridNeighbourFinder.h"
 #include "protein_calls/MolecularDataCall.h"
 #include "vislib/Array.h"
 #include "vislib/math/Cuboid.h"
+#include "vislib/math/ShallowPoint.h"
 #include "vislib/math/Vector.h"
 #include <fstream>
+#include <vector>
 
 namespace megamol {
 namespace protein {
@@ -97,7 +99,7 @@ protected:
 
     /**
      * Get the hydrogen bonds for the current frameID of 'dataSource' and store the result in 'dataTarget'.
-     * The hydrogen-bonds may be already precomputed (in core or file-IO) so this function won't take much time.
+     * The hydrogen-bonds may be already precomputed (in core or in the cache) so this function won't take much time.
      */
     bool getHBonds(
         megamol::protein_calls::MolecularDataCall* dataTarget, megamol::protein_calls::MolecularDataCall* dataSource);
@@ -112,11 +114,47 @@ protected:
         calcHydroBondsForCurFrame(data, data->AtomPositions(), atomHydroBondsIndicesPtr);
     }
 
+    /**
+     * Calculates the hydrogen bonds of one set of atom positions. Only reads the members set up by
+     * 'prepareHydroBonds' and builds its own cell list, so several frames can be processed in parallel.
+     *
+     * @param atomPositions            The atom positions.
+     * @param distance                 The maximum distance between donor and acceptor.
+     * @param angle                    The maximum angle between donor-acceptor and donor-hydrogen in radians.
+     * @param atomHydroBondsIndicesPtr Receives the index of the bonding hydrogen per acceptor atom or -1.
+     */
+    void calcHydroBonds(const float* atomPositions, float distance, float angle, int* atomHydroBondsIndicesPtr) const;
+
+    /**
+     * Collects the hydrogens, donors/acceptors and polymer residues of the molecule, if not done yet.
+     */
+    void prepareHydroBonds(megamol::protein_calls::MolecularDataCall* data);
+
+    /**
+     * Makes 'hBondCache' hold the hydrogen bonds of all frames, unless it already holds them for the
+     * current data and parameters. The data set is identified by a hash of its first and last frame.
+     * Fetches other frames, the current frame of 'dataSource' is fetched again at the end.
+     *
+     * @return 'true' on success, 'false' on failure.
+     */
+    bool buildHBondCache(megamol::protein_calls::MolecularDataCall* dataSource);
+
+    /**
+     * Opens the cache file if it matches 'key', or computes the hydrogen bonds of all frames into
+     * 'hBondCache'. Frames are fetched one after the other and computed in parallel batches.
+     *
+     * @param dataSource The source of the frames.
+     * @param key The data set and parameters to compute the bonds for.
+     *
+     * @return 'true' on success, 'false' on failure.
+     */
+    bool computeHBondCache(megamol::protein_calls::MolecularDataCall* dataSource, const HydroBondCache::Key& key);
+
     /**
      * create hydrogen-bond statistics for the polymer atoms ...
+     * Fetches other frames, the current frame of 'dataSource' is fetched again at the end.
      */
-    bool calcHydrogenBondStatistics(
-        megamol::protein_calls::MolecularDataCall* dataTarget, megamol::protein_calls::MolecularDataCall* dataSource);
+    bool calcHydrogenBondStatistics(megamol::protein_calls::MolecularDataCall* dataSource);
 
     /**
      * Implementation of 'Release'.
@@ -169,19 +207,14 @@ private:
     megamol::core::param::ParamSlot hBondDistance;
     megamol::core::param::ParamSlot hBondDonorAcceptorDistance;
     megamol::core::param::ParamSlot hBondDonorAcceptorAngle;
-    //megamol::core::param::ParamSlot hBondDataFile;
+    /** File caching the hydrogen bonds of all frames */
+    megamol::core::param::ParamSlot hBondCacheFile;
     megamol::core::param::ParamSlot showMiddlePositions;
 
     /** temporary variable to store a set of atom positions */
     vislib::Array<float> middleAtomPos;
     vislib::Array<int> middleAtomPosHBonds;
 
-    /** our grid based neighbour finder ... */
-    GridNeighbourFinder<float> neighbourFinder;
-
-    /** temporary variable to store the neighbour indices for the hydrogen-bound search ...*/
-    vislib::Array<unsigned int>* neighbourIndices;
-    //vislib::Array<unsigned int> *neighbHydrogenIndices;
     /** store hydrogen connections per atom ... */
     vislib::Array<int> hydrogenConnections;
     vislib::Array<int> donorAcceptors;
@@ -190,10 +223,25 @@ private:
     //enum { DONOR_ACCEPTOR_TYPE_COUNT = 2 /* only 'O' and 'N' can be donor/acceptor*/};
     int maxOMPThreads;
 
-    /** array to check atoms already connected ... */
-    vislib::Array<int> reverseConnection;
+    /** residue index per atom */
+    std::vector<int> atomResidues;
+
+    /** the atom range of each polymer residue ... */
+    struct PolymerResidue {
+        int residue;
+        unsigned int firstAtom;
+        unsigned int lastAtom;
+    };
+    std::vector<PolymerResidue> polymerResidues;
+
+    /** the hydrogen bonds of all frames */
+    HydroBondCache hBondCache;
+    HydroBondCache::BondList frameBonds;
+
+    /** the data hash the hydrogen bonds were computed for */
+    SIZE_T hBondDataHash;
 
-    /* store 2 hydrogen bounds in core so interpolating between two frames can be done without file-access */
+    /* store 2 hydrogen bounds in core so interpolating between two frames can be done without cache access */
     enum { HYDROGEN_BOND_IN_CORE = 3 /*20*/ /*2*/ };
 
     /** store hydrogen bounds ...*/
@@ -1,8 +1,11 @@
 #include "Stride.h"
 #include "stdafx.h"
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <cstdio>
 #include <iostream>
+#include <utility>
 
 
 using namespace megamol::protein;
@@ -37,6 +40,8 @@ Stride::Stride(MolecularDataCall* mol) : Successful(false) {
     ComputeSecondaryStructure();
     // compute the indices of the hydrogen bonds
     PostProcessHBonds(mol);
+    // keep the per-residue assignment
+    ExtractAssignment(mol);
 }
 
 Stride::~Stride(void) {
@@ -209,10 +214,12 @@ bool Stride::ComputeSecondaryStructure() {
     PhiPsiMapHelix = DefaultHelixMap(StrideCmd);
     PhiPsiMapSheet = DefaultSheetMap(StrideCmd);
 
-    for (Cn = 0; Cn < ProteinChainCnt; ++Cn)
-        PlaceHydrogens(ProteinChain[Cn]);
+    // the chains are independent up to the hydrogen bond search
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t c = 0; c < ProteinChainCnt; ++c)
+        PlaceHydrogens(ProteinChain[c]);
 
-    if ((HydroBondCnt = FindHydrogenBonds(ProteinChain, Cn, HydroBond, StrideCmd)) == 0) {
+    if ((HydroBondCnt = FindHydrogenBonds(ProteinChain, ProteinChainCnt, HydroBond, StrideCmd)) == 0) {
         //die( "No hydrogen bonds found in %s\n", StrideCmd->InputFile );
         printf("No hydrogen bonds found.\n");
         return false;
@@ -248,70 +255,68 @@ bool Stride::ComputeSecondaryStructure() {
 }
 
 bool Stride::WriteToInterface(MolecularDataCall* mol) {
+    return WriteToInterface(this->assignment, mol);
+}
+
+bool Stride::WriteToInterface(const Assignment& asn, MolecularDataCall* mol) {
     if (mol) {
-        int Cn, i;
+        unsigned int i;
         char type;
-        int firstRes;
-        int resCnt;
-        int idx = 0;
+        unsigned int firstRes;
+        unsigned int resCnt;
+        unsigned int idx = 0;
 
         std::vector<MolecularDataCall::SecStructure> sec;
 
-        if (!ExistsSecStr(ProteinChain, ProteinChainCnt))
+        if (asn.Chains.empty())
             return false;
 
-        for (Cn = 0; Cn < ProteinChainCnt; ++Cn) {
-            // do nothing if the current chain is not valid
-            if (!ProteinChain[Cn]->Valid)
+        const auto pushSecStruct = [&sec](unsigned int first, unsigned int cnt, char code) {
+            sec.push_back(MolecularDataCall::SecStructure());
+            sec.back().SetPosition(first, cnt);
+            if (code == 'G' || code == 'H' || code == 'I')
+                sec.back().SetType(MolecularDataCall::SecStructure::TYPE_HELIX);
+            else if (code == 'E')
+                sec.back().SetType(MolecularDataCall::SecStructure::TYPE_SHEET);
+            else
+                sec.back().SetType(MolecularDataCall::SecStructure::TYPE_COIL);
+        };
+
+        for (const auto& chain : asn.Chains) {
+            if (chain.Asn.empty())
                 continue;
 
             // set initial values for first sec struct elem
-            firstRes = mol->Molecules()[Cn].FirstResidueIndex();
+            firstRes = chain.FirstResidue;
             resCnt = 1;
-            type = ProteinChain[Cn]->Rsd[0]->Prop->Asn;
+            type = chain.Asn[0];
 
-            for (i = 1; i < ProteinChain[Cn]->NRes; i++) {
+            for (i = 1; i < static_cast<unsigned int>(chain.Asn.size()); i++) {
                 // update values if type did not change
-                if (ProteinChain[Cn]->Rsd[i]->Prop->Asn == type) {
+                if (chain.Asn[i] == type) {
                     resCnt++;
                 } else {
                     // write sec struct elem to vector if new elem starts
-                    sec.push_back(MolecularDataCall::SecStructure());
-                    sec.back().SetPosition(firstRes, resCnt);
-                    if (type == 'G' || type == 'H' || type == 'I')
-                        sec.back().SetType(MolecularDataCall::SecStructure::TYPE_HELIX);
-                    else if (type == 'E')
-                        sec.back().SetType(MolecularDataCall::SecStructure::TYPE_SHEET);
-                    else
-                        sec.back().SetType(MolecularDataCall::SecStructure::TYPE_COIL);
+                    pushSecStruct(firstRes, resCnt, type);
                     // start new sec struct elem
-                    firstRes = i + mol->Molecules()[Cn].FirstResidueIndex();
+                    firstRes = i + chain.FirstResidue;
                     resCnt = 1;
-                    type = ProteinChain[Cn]->Rsd[i]->Prop->Asn;
+                    type = chain.Asn[i];
                 }
-
-                //printf( "CHAIN %4i RES %5i ASN %c\n", Cn, i, ProteinChain[Cn]->Rsd[i]->Prop->Asn);
             }
             // write last sec struct elem to vector
-            sec.push_back(MolecularDataCall::SecStructure());
-            sec.back().SetPosition(firstRes, resCnt);
-            if (type == 'G' || type == 'H' || type == 'I')
-                sec.back().SetType(MolecularDataCall::SecStructure::TYPE_HELIX);
-            else if (type == 'E')
-                sec.back().SetType(MolecularDataCall::SecStructure::TYPE_SHEET);
-            else
-                sec.back().SetType(MolecularDataCall::SecStructure::TYPE_COIL);
-            mol->SetMoleculeSecondaryStructure(Cn, idx, (unsigned int)sec.size() - idx);
-            idx = (int)sec.size();
+            pushSecStruct(firstRes, resCnt, type);
+            mol->SetMoleculeSecondaryStructure(chain.Molecule, idx, (unsigned int)sec.size() - idx);
+            idx = (unsigned int)sec.size();
         }
         // handled all residues of current chain, copy sec struct to interface
         mol->SetSecondaryStructureCount((unsigned int)sec.size());
-        for (i = 0; i < (int)sec.size(); ++i) {
+        for (i = 0; i < (unsigned int)sec.size(); ++i) {
             mol->SetSecondaryStructure(i, sec[i]);
         }
 
         // set the found hydrogen bonds
-        mol->SetHydrogenBonds(this->ownHydroBonds.data(), static_cast<unsigned int>(HydroBondCnt));
+        mol->SetHydrogenBonds(asn.HydroBonds.data(), static_cast<unsigned int>(asn.HydroBonds.size() / 2));
 
     } else {
         return false;
@@ -460,11 +465,10 @@ int Stride::CheckChain(CHAIN* Chain, COMMAND* Cmd) {
 }
 
 void Stride::BackboneAngles(CHAIN** Chain, int NChain) {
-    int Res, Cn;
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t Cn = 0; Cn < NChain; Cn++) {
 
-    for (Cn = 0; Cn < NChain; Cn++) {
-
-        for (Res = 0; Res < Chain[Cn]->NRes; Res++) {
+        for (int Res = 0; Res < Chain[Cn]->NRes; Res++) {
             PHI(Chain[Cn], Res);
             PSI(Chain[Cn], Res);
         }
@@ -679,158 +683,126 @@ int Stride::FindHydrogenBonds(CHAIN** Chain, int NChain, HBOND** HBond, COMMAND*
     for (i = 0; i < NAcc; i++)
         BondedAcceptor[i] = STRIDE_NO;
 
-    for (dc = 0; dc < NDnr; dc++) {
-
-        if (Dnr[dc]->Group != Peptide && !Cmd->SideChainHBond)
+    // Sort the acceptor atoms into a uniform grid with cells of the cut-off
+    // distance, so a donor only needs to test the acceptors of the 27 cells
+    // around it. Positions outside the grid are clamped to the border cells,
+    // which keeps the search conservative.
+    float GridMin[3] = {0.0f, 0.0f, 0.0f}, GridMax[3] = {0.0f, 0.0f, 0.0f};
+    for (ac = 0; ac < NAcc; ac++) {
+        const float* Pos = Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At];
+        for (i = 0; i < 3; i++) {
+            GridMin[i] = (ac == 0) ? Pos[i] : Minimum(GridMin[i], Pos[i]);
+            GridMax[i] = (ac == 0) ? Pos[i] : Maximum(GridMax[i], Pos[i]);
+        }
+    }
+    const float CellSize = Maximum(Cmd->DistCutOff, 1.0f);
+    int GridDim[3];
+    for (i = 0; i < 3; i++)
+        GridDim[i] = Minimum(static_cast<int>((GridMax[i] - GridMin[i]) / CellSize) + 1, 128);
+    const auto CellCoord = [&](const float* Pos, int Axis) -> int {
+        const int c = static_cast<int>(std::floor((Pos[Axis] - GridMin[Axis]) / CellSize));
+        return std::max(0, std::min(c, GridDim[Axis] - 1));
+    };
+
+    std::vector<int> CellStart(GridDim[0] * GridDim[1] * GridDim[2] + 1, 0);
+    std::vector<int> AccCell(NAcc), CellAcc(NAcc);
+    for (ac = 0; ac < NAcc; ac++) {
+        const float* Pos = Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At];
+        AccCell[ac] = (CellCoord(Pos, 2) * GridDim[1] + CellCoord(Pos, 1)) * GridDim[0] + CellCoord(Pos, 0);
+        CellStart[AccCell[ac] + 1]++;
+    }
+    for (i = 1; i < static_cast<int>(CellStart.size()); i++)
+        CellStart[i] += CellStart[i - 1];
+    std::vector<int> CellFill(CellStart.begin(), CellStart.end() - 1);
+    for (ac = 0; ac < NAcc; ac++)
+        CellAcc[CellFill[AccCell[ac]]++] = ac;
+
+    // Evaluate the donors in parallel. The bonds of each donor are kept in
+    // acceptor order, so the bonds are numbered exactly as by testing all
+    // donor-acceptor pairs in sequence.
+    std::vector<std::vector<std::pair<int, HBOND*>>> Found(NDnr);
+#pragma omp parallel for schedule(dynamic, 16)
+    for (int64_t d = 0; d < NDnr; d++) {
+        DONOR* D = Dnr[d];
+
+        if (D->Group != Peptide && !Cmd->SideChainHBond)
             continue;
 
-        for (ac = 0; ac < NAcc; ac++) {
+        const float* Pos = D->Chain->Rsd[D->D_Res]->Coord[D->D_At];
+        int Lo[3], Hi[3];
+        for (int a = 0; a < 3; a++) {
+            Lo[a] = Maximum(CellCoord(Pos, a) - 1, 0);
+            Hi[a] = Minimum(CellCoord(Pos, a) + 1, GridDim[a] - 1);
+        }
+        std::vector<int> Candidates;
+        for (int z = Lo[2]; z <= Hi[2]; z++)
+            for (int y = Lo[1]; y <= Hi[1]; y++)
+                for (int x = Lo[0]; x <= Hi[0]; x++) {
+                    const int Cell = (z * GridDim[1] + y) * GridDim[0] + x;
+                    Candidates.insert(Candidates.end(), CellAcc.begin() + CellStart[Cell],
+                        CellAcc.begin() + CellStart[Cell + 1]);
+                }
+        std::sort(Candidates.begin(), Candidates.end());
+
+        for (int a : Candidates) {
+            ACCEPTOR* A = Acc[a];
 
-            if (abs(Acc[ac]->A_Res - Dnr[dc]->D_Res) < 2 && Acc[ac]->Chain->Id == Dnr[dc]->Chain->Id)
+            if (abs(A->A_Res - D->D_Res) < 2 && A->Chain->Id == D->Chain->Id)
                 continue;
 
-            if (Acc[ac]->Group != Peptide && !Cmd->SideChainHBond)
+            if (A->Group != Peptide && !Cmd->SideChainHBond)
                 continue;
 
+            HBOND Bond = {};
+            if (EvaluateHBond(D, A, Cmd, &Bond)) {
+                HBOND* h = (HBOND*)ckalloc(sizeof(HBOND));
+                *h = Bond;
+                Found[d].push_back(std::make_pair(a, h));
+            }
+        }
+    }
+
+    // number the bonds and register them with their residues
+    for (dc = 0; dc < NDnr; dc++) {
+        for (const auto& f : Found[dc]) {
             if (hc == MAXHYDRBOND)
                 die("Number of hydrogen bonds exceeds current limit of %d in %s\n", MAXHYDRBOND, Chain[0]->File);
-            HBond[hc] = (HBOND*)ckalloc(sizeof(HBOND));
-
-            HBond[hc]->ExistHydrBondRose = STRIDE_NO;
-            HBond[hc]->ExistHydrBondBaker = STRIDE_NO;
-            HBond[hc]->ExistPolarInter = STRIDE_NO;
-
-            if ((HBond[hc]->AccDonDist = Dist(Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->D_At],
-                     Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At])) <= Cmd->DistCutOff) {
-
-
-                if (Cmd->MainChainPolarInt && Dnr[dc]->Group == Peptide && Acc[ac]->Group == Peptide &&
-                    Dnr[dc]->H != ERR) {
-                    GRID_Energy(Acc[ac]->Chain->Rsd[Acc[ac]->AA2_Res]->Coord[Acc[ac]->AA2_At],
-                        Acc[ac]->Chain->Rsd[Acc[ac]->AA_Res]->Coord[Acc[ac]->AA_At],
-                        Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At],
-                        Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->H],
-                        Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->D_At], Cmd, HBond[hc]);
-
-                    if (HBond[hc]->Energy < -10.0 &&
-                        ((Cmd->EnergyType == 'G' && fabs(HBond[hc]->Et) > Eps && fabs(HBond[hc]->Ep) > Eps) ||
-                            Cmd->EnergyType != 'G'))
-                        HBond[hc]->ExistPolarInter = STRIDE_YES;
-                }
-
-                if (Cmd->MainChainHBond &&
-                    (HBond[hc]->OHDist = Dist(Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->H],
-                         Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At])) <= 2.5 &&
-                    (HBond[hc]->AngNHO = Ang(Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->D_At],
-                         Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->H],
-                         Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At])) >= 90.0 &&
-                    HBond[hc]->AngNHO <= 180.0 &&
-                    (HBond[hc]->AngCOH = Ang(Acc[ac]->Chain->Rsd[Acc[ac]->AA_Res]->Coord[Acc[ac]->AA_At],
-                         Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At],
-                         Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->H])) >= 90.0 &&
-
-                    HBond[hc]->AngCOH <= 180.0)
-                    HBond[hc]->ExistHydrBondBaker = STRIDE_YES;
-
-                if (Cmd->MainChainHBond && HBond[hc]->AccDonDist <= Dnr[dc]->HB_Radius + Acc[ac]->HB_Radius) {
-
-                    HBond[hc]->AccAng = Ang(Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->D_At],
-                        Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At],
-                        Acc[ac]->Chain->Rsd[Acc[ac]->AA_Res]->Coord[Acc[ac]->AA_At]);
-
-                    if (((Acc[ac]->Hybrid == Nsp2 || Acc[ac]->Hybrid == Osp2) &&
-                            (HBond[hc]->AccAng >= MINACCANG_SP2 && HBond[hc]->AccAng <= MAXACCANG_SP2)) ||
-                        ((Acc[ac]->Hybrid == Ssp3 || Acc[ac]->Hybrid == Osp3) &&
-                            (HBond[hc]->AccAng >= MINACCANG_SP3 && HBond[hc]->AccAng <= MAXACCANG_SP3))) {
-
-                        HBond[hc]->DonAng = Ang(Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At],
-                            Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->D_At],
-                            Dnr[dc]->Chain->Rsd[Dnr[dc]->DD_Res]->Coord[Dnr[dc]->DD_At]);
-
-                        if (((Dnr[dc]->Hybrid == Nsp2 || Dnr[dc]->Hybrid == Osp2) &&
-                                (HBond[hc]->DonAng >= MINDONANG_SP2 && HBond[hc]->DonAng <= MAXDONANG_SP2)) ||
-                            ((Dnr[dc]->Hybrid == Nsp3 || Dnr[dc]->Hybrid == Osp3) &&
-                                (HBond[hc]->DonAng >= MINDONANG_SP3 && HBond[hc]->DonAng <= MAXDONANG_SP3))) {
-
-                            if (Dnr[dc]->Hybrid == Nsp2 || Dnr[dc]->Hybrid == Osp2) {
-                                HBond[hc]->AccDonAng =
-                                    fabs(Torsion(Dnr[dc]->Chain->Rsd[Dnr[dc]->DDI_Res]->Coord[Dnr[dc]->DDI_At],
-                                        Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->D_At],
-                                        Dnr[dc]->Chain->Rsd[Dnr[dc]->DD_Res]->Coord[Dnr[dc]->DD_At],
-                                        Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At]));
-
-                                if (HBond[hc]->AccDonAng > 90.0f && HBond[hc]->AccDonAng < 270.0f)
-                                    HBond[hc]->AccDonAng = fabs(180.0f - HBond[hc]->AccDonAng);
-                            }
-
-                            if (Acc[ac]->Hybrid == Nsp2 || Acc[ac]->Hybrid == Osp2) {
-                                HBond[hc]->DonAccAng =
-                                    fabs(Torsion(Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->D_At],
-                                        Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At],
-                                        Acc[ac]->Chain->Rsd[Acc[ac]->AA_Res]->Coord[Acc[ac]->AA_At],
-                                        Acc[ac]->Chain->Rsd[Acc[ac]->AA2_Res]->Coord[Acc[ac]->AA2_At]));
-
-                                if (HBond[hc]->DonAccAng > 90.0f && HBond[hc]->DonAccAng < 270.0f)
-                                    HBond[hc]->DonAccAng = fabs(180.0f - HBond[hc]->DonAccAng);
-                            }
-
-                            if ((Dnr[dc]->Hybrid != Nsp2 && Dnr[dc]->Hybrid != Osp2 && Acc[ac]->Hybrid != Nsp2 &&
-                                    Acc[ac]->Hybrid != Osp2) ||
-                                (Acc[ac]->Hybrid != Nsp2 && Acc[ac]->Hybrid != Osp2 &&
-                                    (Dnr[dc]->Hybrid == Nsp2 || Dnr[dc]->Hybrid == Osp2) &&
-                                    HBond[hc]->AccDonAng <= ACCDONANG) ||
-                                (Dnr[dc]->Hybrid != Nsp2 && Dnr[dc]->Hybrid != Osp2 &&
-                                    (Acc[ac]->Hybrid == Nsp2 || Acc[ac]->Hybrid == Osp2) &&
-                                    HBond[hc]->DonAccAng <= DONACCANG) ||
-                                ((Dnr[dc]->Hybrid == Nsp2 || Dnr[dc]->Hybrid == Osp2) &&
-                                    (Acc[ac]->Hybrid == Nsp2 || Acc[ac]->Hybrid == Osp2) &&
-                                    HBond[hc]->AccDonAng <= ACCDONANG && HBond[hc]->DonAccAng <= DONACCANG))
-                                HBond[hc]->ExistHydrBondRose = STRIDE_YES;
-                        }
-                    }
-                }
+            ac = f.first;
+            HBond[hc] = f.second;
+            BondedDonor[dc] = STRIDE_YES;
+            BondedAcceptor[ac] = STRIDE_YES;
+            if ((ccd = FindChain(Chain, NChain, Dnr[dc]->Chain->Id)) != ERR) {
+                if (Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->NBondDnr < MAXRESDNR)
+                    Chain[ccd]
+                        ->Rsd[Dnr[dc]->D_Res]
+                        ->Inv->HBondDnr[Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->NBondDnr++] = hc;
+                else
+                    printf("Residue %s %s of chain %i is involved in more than %d hydrogen bonds (%d)\n",
+                        Chain[ccd]->Rsd[Dnr[dc]->D_Res]->ResType, Chain[ccd]->Rsd[Dnr[dc]->D_Res]->PDB_ResNumb,
+                        Chain[ccd]->ChainId, MAXRESDNR, Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->NBondDnr);
             }
-
-            if ((HBond[hc]->ExistPolarInter && HBond[hc]->Energy < 0.0) || HBond[hc]->ExistHydrBondRose ||
-                HBond[hc]->ExistHydrBondBaker) {
-                HBond[hc]->Dnr = Dnr[dc];
-                HBond[hc]->Acc = Acc[ac];
-                BondedDonor[dc] = STRIDE_YES;
-                BondedAcceptor[ac] = STRIDE_YES;
-                if ((ccd = FindChain(Chain, NChain, Dnr[dc]->Chain->Id)) != ERR) {
-                    if (Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->NBondDnr < MAXRESDNR)
-                        Chain[ccd]
-                            ->Rsd[Dnr[dc]->D_Res]
-                            ->Inv->HBondDnr[Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->NBondDnr++] = hc;
-                    else
-                        printf("Residue %s %s of chain %i is involved in more than %d hydrogen bonds (%d)\n",
-                            Chain[ccd]->Rsd[Dnr[dc]->D_Res]->ResType, Chain[ccd]->Rsd[Dnr[dc]->D_Res]->PDB_ResNumb,
-                            Chain[ccd]->ChainId, MAXRESDNR, Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->NBondDnr);
-                }
-                if ((cca = FindChain(Chain, NChain, Acc[ac]->Chain->Id)) != ERR) {
-                    if (Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->NBondAcc < MAXRESACC)
-                        Chain[cca]
-                            ->Rsd[Acc[ac]->A_Res]
-                            ->Inv->HBondAcc[Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->NBondAcc++] = hc;
-                    else
-                        printf("Residue %s %s of chain %i is involved in more than %d hydrogen bonds (%d)\n",
-                            Chain[cca]->Rsd[Acc[ac]->A_Res]->ResType, Chain[cca]->Rsd[Acc[ac]->A_Res]->PDB_ResNumb,
-                            Chain[cca]->ChainId, MAXRESDNR, Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->NBondAcc);
-                }
-                if (ccd != cca && ccd != ERR) {
-                    Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->InterchainHBonds = STRIDE_YES;
-                    Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->InterchainHBonds = STRIDE_YES;
-                    if (HBond[hc]->ExistHydrBondRose) {
-                        Chain[0]->NHydrBondInterchain++;
-                        Chain[0]->NHydrBondTotal++;
-                    }
-                } else if (ccd == cca && ccd != ERR && HBond[hc]->ExistHydrBondRose) {
-                    Chain[ccd]->NHydrBond++;
+            if ((cca = FindChain(Chain, NChain, Acc[ac]->Chain->Id)) != ERR) {
+                if (Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->NBondAcc < MAXRESACC)
+                    Chain[cca]
+                        ->Rsd[Acc[ac]->A_Res]
+                        ->Inv->HBondAcc[Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->NBondAcc++] = hc;
+                else
+                    printf("Residue %s %s of chain %i is involved in more than %d hydrogen bonds (%d)\n",
+                        Chain[cca]->Rsd[Acc[ac]->A_Res]->ResType, Chain[cca]->Rsd[Acc[ac]->A_Res]->PDB_ResNumb,
+                        Chain[cca]->ChainId, MAXRESDNR, Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->NBondAcc);
+            }
+            if (ccd != cca && ccd != ERR) {
+                Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->InterchainHBonds = STRIDE_YES;
+                Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->InterchainHBonds = STRIDE_YES;
+                if (HBond[hc]->ExistHydrBondRose) {
+                    Chain[0]->NHydrBondInterchain++;
                     Chain[0]->NHydrBondTotal++;
                 }
-                hc++;
-            } else
-                free(HBond[hc]);
+            } else if (ccd == cca && ccd != ERR && HBond[hc]->ExistHydrBondRose) {
+                Chain[ccd]->NHydrBond++;
+                Chain[0]->NHydrBondTotal++;
+            }
+            hc++;
         }
     }
 
@@ -852,6 +824,97 @@ int Stride::FindHydrogenBonds(CHAIN** Chain, int NChain, HBOND** HBond, COMMAND*
     return (hc);
 }
 
+Stride::BOOLEAN Stride::EvaluateHBond(DONOR* Dnr, ACCEPTOR* Acc, COMMAND* Cmd, HBOND* HBond) {
+    HBond->Dnr = Dnr;
+    HBond->Acc = Acc;
+
+    HBond->ExistHydrBondRose = STRIDE_NO;
+    HBond->ExistHydrBondBaker = STRIDE_NO;
+    HBond->ExistPolarInter = STRIDE_NO;
+
+    if ((HBond->AccDonDist = Dist(Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->D_At],
+             Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At])) <= Cmd->DistCutOff) {
+
+
+        if (Cmd->MainChainPolarInt && Dnr->Group == Peptide && Acc->Group == Peptide && Dnr->H != ERR) {
+            GRID_Energy(Acc->Chain->Rsd[Acc->AA2_Res]->Coord[Acc->AA2_At],
+                Acc->Chain->Rsd[Acc->AA_Res]->Coord[Acc->AA_At], Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At],
+                Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->H], Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->D_At], Cmd,
+                HBond);
+
+            if (HBond->Energy < -10.0 &&
+                ((Cmd->EnergyType == 'G' && fabs(HBond->Et) > Eps && fabs(HBond->Ep) > Eps) || Cmd->EnergyType != 'G'))
+                HBond->ExistPolarInter = STRIDE_YES;
+        }
+
+        if (Cmd->MainChainHBond &&
+            (HBond->OHDist = Dist(Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->H],
+                 Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At])) <= 2.5 &&
+            (HBond->AngNHO = Ang(Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->D_At],
+                 Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->H], Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At])) >=
+                90.0 &&
+            HBond->AngNHO <= 180.0 &&
+            (HBond->AngCOH = Ang(Acc->Chain->Rsd[Acc->AA_Res]->Coord[Acc->AA_At],
+                 Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At], Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->H])) >=
+                90.0 &&
+
+            HBond->AngCOH <= 180.0)
+            HBond->ExistHydrBondBaker = STRIDE_YES;
+
+        if (Cmd->MainChainHBond && HBond->AccDonDist <= Dnr->HB_Radius + Acc->HB_Radius) {
+
+            HBond->AccAng = Ang(Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->D_At],
+                Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At], Acc->Chain->Rsd[Acc->AA_Res]->Coord[Acc->AA_At]);
+
+            if (((Acc->Hybrid == Nsp2 || Acc->Hybrid == Osp2) &&
+                    (HBond->AccAng >= MINACCANG_SP2 && HBond->AccAng <= MAXACCANG_SP2)) ||
+                ((Acc->Hybrid == Ssp3 || Acc->Hybrid == Osp3) &&
+                    (HBond->AccAng >= MINACCANG_SP3 && HBond->AccAng <= MAXACCANG_SP3))) {
+
+                HBond->DonAng = Ang(Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At],
+                    Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->D_At], Dnr->Chain->Rsd[Dnr->DD_Res]->Coord[Dnr->DD_At]);
+
+                if (((Dnr->Hybrid == Nsp2 || Dnr->Hybrid == Osp2) &&
+                        (HBond->DonAng >= MINDONANG_SP2 && HBond->DonAng <= MAXDONANG_SP2)) ||
+                    ((Dnr->Hybrid == Nsp3 || Dnr->Hybrid == Osp3) &&
+                        (HBond->DonAng >= MINDONANG_SP3 && HBond->DonAng <= MAXDONANG_SP3))) {
+
+                    if (Dnr->Hybrid == Nsp2 || Dnr->Hybrid == Osp2) {
+                        HBond->AccDonAng = fabs(Torsion(Dnr->Chain->Rsd[Dnr->DDI_Res]->Coord[Dnr->DDI_At],
+                            Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->D_At],
+                            Dnr->Chain->Rsd[Dnr->DD_Res]->Coord[Dnr->DD_At],
+                            Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At]));
+
+                        if (HBond->AccDonAng > 90.0f && HBond->AccDonAng < 270.0f)
+                            HBond->AccDonAng = fabs(180.0f - HBond->AccDonAng);
+                    }
+
+                    if (Acc->Hybrid == Nsp2 || Acc->Hybrid == Osp2) {
+                        HBond->DonAccAng = fabs(Torsion(Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->D_At],
+                            Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At],
+                            Acc->Chain->Rsd[Acc->AA_Res]->Coord[Acc->AA_At],
+                            Acc->Chain->Rsd[Acc->AA2_Res]->Coord[Acc->AA2_At]));
+
+                        if (HBond->DonAccAng > 90.0f && HBond->DonAccAng < 270.0f)
+                            HBond->DonAccAng = fabs(180.0f - HBond->DonAccAng);
+                    }
+
+                    if ((Dnr->Hybrid != Nsp2 && Dnr->Hybrid != Osp2 && Acc->Hybrid != Nsp2 && Acc->Hybrid != Osp2) ||
+                        (Acc->Hybrid != Nsp2 && Acc->Hybrid != Osp2 && (Dnr->Hybrid == Nsp2 || Dnr->Hybrid == Osp2) &&
+                            HBond->AccDonAng <= ACCDONANG) ||
+                        (Dnr->Hybrid != Nsp2 && Dnr->Hybrid != Osp2 && (Acc->Hybrid == Nsp2 || Acc->Hybrid == Osp2) &&
+                            HBond->DonAccAng <= DONACCANG) ||
+                        ((Dnr->Hybrid == Nsp2 || Dnr->Hybrid == Osp2) && (Acc->Hybrid == Nsp2 || Acc->Hybrid == Osp2) &&
+                            HBond->AccDonAng <= ACCDONANG && HBond->DonAccAng <= DONACCANG))
+                        HBond->ExistHydrBondRose = STRIDE_YES;
+                }
+            }
+        }
+    }
+
+    return ((HBond->ExistPolarInter && HBond->Energy < 0.0) || HBond->ExistHydrBondRose || HBond->ExistHydrBondBaker);
+}
+
 int Stride::NoDoubleHBond(HBOND** HBond, int NHBond) {
 
     int i, j, NExcl = 0;
@@ -873,10 +936,10 @@ int Stride::NoDoubleHBond(HBOND** HBond, int NHBond) {
 }
 
 void Stride::DiscrPhiPsi(CHAIN** Chain, int NChain, COMMAND* Cmd) {
-    int i, Res, Cn;
-    RESIDUE* r;
-
-    for (Cn = 0; Cn < NChain; Cn++) {
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t Cn = 0; Cn < NChain; Cn++) {
+        int i, Res;
+        RESIDUE* r;
 
         for (Res = 0; Res < Chain[Cn]->NRes; Res++) {
 
@@ -1471,7 +1534,8 @@ int Stride::Process_ATOM(BUFFER Buffer, CHAIN** Chain, int* ChainNumber, BOOLEAN
     char* Field[MAX_FIELD];
     BUFFER Tmp;
     int CC, NR, NA;
-    static char LastRes[MAX_CHAIN][RES_FIELD];
+    // per thread, the STRIDE precomputation runs next to the loading thread
+    thread_local char LastRes[MAX_CHAIN][RES_FIELD];
     RESIDUE* r;
 
     // 'chainID' -- ??? --> not exectuted for 1RWE
@@ -1590,7 +1654,7 @@ int Stride::FindAtom(CHAIN* Chain, int ResNumb, const char* Atom, int* AtNumb) {
 }
 
 char Stride::SpaceToDash(char Id) {
-    static char NewId;
+    char NewId;
 
     if (Id == ' ')
         NewId = '-';
@@ -3107,7 +3171,7 @@ void Stride::InitChain(CHAIN** Chain) {
 
 int Stride::SplitString(char* Buffer, char** Fields, int MaxField) {
     int FieldCnt, SymbCnt, FieldFlag, BuffLen;
-    static char LocalBuffer[BUFSZ];
+    thread_local char LocalBuffer[BUFSZ];
 
 
     FieldCnt = 0;
@@ -3265,17 +3329,39 @@ float Stride::VectorProduct(float* Vector1, float* Vector2, float* Product) {
 }
 
 void Stride::PostProcessHBonds(megamol::protein_calls::MolecularDataCall* mol) {
-    this->ownHydroBonds.resize(HydroBondCnt * 2);
+    auto& hydroBonds = this->assignment.HydroBonds;
+    hydroBonds.resize(HydroBondCnt * 2);
 
     for (unsigned int bondIdx = 0; bondIdx < static_cast<unsigned int>(HydroBondCnt); bondIdx++) {
         auto bond = HydroBond[bondIdx];
         unsigned int donor = GetMoleculeIndex(bond->Dnr->Chain->ChainId, bond->Dnr->D_Res, bond->Dnr->D_At, mol);
         unsigned int acceptor = GetMoleculeIndex(bond->Acc->Chain->ChainId, bond->Acc->A_Res, bond->Acc->A_At, mol);
-        this->ownHydroBonds[bondIdx * 2 + 0] = donor;
-        this->ownHydroBonds[bondIdx * 2 + 1] = acceptor;
+        hydroBonds[bondIdx * 2 + 0] = donor;
+        hydroBonds[bondIdx * 2 + 1] = acceptor;
     }
 
-    mol->SetHydrogenBonds(this->ownHydroBonds.data(), static_cast<unsigned int>(HydroBondCnt));
+    mol->SetHydrogenBonds(hydroBonds.data(), static_cast<unsigned int>(HydroBondCnt));
+}
+
+void Stride::ExtractAssignment(megamol::protein_calls::MolecularDataCall* mol) {
+    this->assignment.Chains.clear();
+
+    // an empty assignment marks that no secondary structure was found
+    if (!ExistsSecStr(ProteinChain, ProteinChainCnt))
+        return;
+
+    for (int Cn = 0; Cn < ProteinChainCnt; ++Cn) {
+        // skip the chains which are not valid
+        if (!ProteinChain[Cn]->Valid)
+            continue;
+
+        this->assignment.Chains.push_back(Assignment::ChainAsn());
+        auto& chain = this->assignment.Chains.back();
+        chain.Molecule = static_cast<unsigned int>(Cn);
+        chain.FirstResidue = mol->Molecules()[Cn].FirstResidueIndex();
+        chain.Asn.resize(ProteinChain[Cn]->NRes);
+        ExtractAsn(ProteinChain, Cn, chain.Asn.data());
+    }
 }
 
 unsigned int Stride::GetMoleculeIndex(unsigned int ChainIdx, unsigned int ResidueIdx, unsigned int InternalIdx,
@@ -279,11 +279,54 @@ public:
         BUFFER Type;
     } PATTERN;
 
+    /**
+     * The secondary structure assignment of one frame. It is independent of
+     * the internal STRIDE data structures, so it can be kept per frame of a
+     * trajectory without keeping the Stride object.
+     */
+    struct Assignment {
+        /** The assignment of one valid chain */
+        struct ChainAsn {
+            /** The index of the molecule the chain was built from */
+            unsigned int Molecule;
+            /** The index of the first residue of the molecule */
+            unsigned int FirstResidue;
+            /** The STRIDE code per residue */
+            std::vector<char> Asn;
+        };
+
+        /** The valid chains, empty if no secondary structure was found */
+        std::vector<ChainAsn> Chains;
+
+        /** Donor and acceptor atom index of each hydrogen bond */
+        std::vector<unsigned int> HydroBonds;
+    };
+
     Stride(megamol::protein_calls::MolecularDataCall* mol);
     virtual ~Stride(void);
 
     bool WriteToInterface(megamol::protein_calls::MolecularDataCall* mol);
 
+    /**
+     * Writes an assignment to the interface. The hydrogen bonds of the call
+     * reference the assignment, so it must outlive the use of the call.
+     *
+     * @param asn The assignment.
+     * @param mol The call to write to.
+     *
+     * @return 'true' if secondary structure was written.
+     */
+    static bool WriteToInterface(const Assignment& asn, megamol::protein_calls::MolecularDataCall* mol);
+
+    /**
+     * Answer the assignment computed on construction.
+     *
+     * @return The assignment.
+     */
+    inline const Assignment& GetAssignment(void) const {
+        return this->assignment;
+    }
+
 protected:
     typedef struct // OWNBOND
     {
@@ -295,6 +338,7 @@ protected:
     bool ComputeSecondaryStructure();
 
     void PostProcessHBonds(megamol::protein_calls::MolecularDataCall* mol);
+    void ExtractAssignment(megamol::protein_calls::MolecularDataCall* mol);
     unsigned int GetMoleculeIndex(unsigned int ChainIdx, unsigned int ResidueIdx, unsigned int InternalIndex,
         megamol::protein_calls::MolecularDataCall* mol);
 
@@ -307,6 +351,7 @@ protected:
     float** DefaultSheetMap(COMMAND* Cmd);
     int PlaceHydrogens(CHAIN* Chain);
     int FindHydrogenBonds(CHAIN** Chain, int NChain, HBOND** HBond, COMMAND* Cmd);
+    BOOLEAN EvaluateHBond(DONOR* Dnr, ACCEPTOR* Acc, COMMAND* Cmd, HBOND* HBond);
     int NoDoubleHBond(HBOND** HBond, int NHBond);
     void DiscrPhiPsi(CHAIN** Chain, int NChain, COMMAND* Cmd);
     void Helix(CHAIN** Chain, int Cn, HBOND** HBond, COMMAND* Cmd, float** PhiPsiMap);
@@ -386,7 +431,8 @@ private:
     int ProteinChainCnt;
     HBOND** HydroBond;
     int HydroBondCnt;
-    std::vector<unsigned int> ownHydroBonds;
+    // the per-residue assignment and the hydrogen bonds
+    Assignment assignment;
 
     // was the computation successful?
     bool Successful;
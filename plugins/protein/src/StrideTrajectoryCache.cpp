@@ -0,0 +1,127 @@
+/*
+ * StrideTrajectoryCache.cpp
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "StrideTrajectoryCache.h"
+#include "stdafx.h"
+
+#include "mmcore/utility/log/Log.h"
+
+using namespace megamol::protein;
+
+
+/*
+ * StrideTrajectoryCache::StrideTrajectoryCache
+ */
+StrideTrajectoryCache::StrideTrajectoryCache(void) : cachedCnt(0), cancel(false), running(false) {}
+
+
+/*
+ * StrideTrajectoryCache::~StrideTrajectoryCache
+ */
+StrideTrajectoryCache::~StrideTrajectoryCache(void) {
+    this->Stop();
+}
+
+
+/*
+ * StrideTrajectoryCache::Clear
+ */
+void StrideTrajectoryCache::Clear(void) {
+    this->Stop();
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->frames.clear();
+    this->cachedCnt = 0;
+}
+
+
+/*
+ * StrideTrajectoryCache::CachedFrameCount
+ */
+unsigned int StrideTrajectoryCache::CachedFrameCount(void) const {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->cachedCnt;
+}
+
+
+/*
+ * StrideTrajectoryCache::Get
+ */
+StrideTrajectoryCache::AssignmentPtr StrideTrajectoryCache::Get(unsigned int frame) const {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return (frame < this->frames.size()) ? this->frames[frame] : nullptr;
+}
+
+
+/*
+ * StrideTrajectoryCache::IsPrecomputing
+ */
+bool StrideTrajectoryCache::IsPrecomputing(void) const {
+    return this->running;
+}
+
+
+/*
+ * StrideTrajectoryCache::Precompute
+ */
+void StrideTrajectoryCache::Precompute(unsigned int frameCnt, unsigned int first, ComputeFunc compute) {
+    if (this->running || (frameCnt == 0) || !compute) {
+        return;
+    }
+    // join a thread which has finished on its own
+    this->Stop();
+
+    this->cancel = false;
+    this->running = true;
+    this->worker = std::thread([this, frameCnt, first, compute]() {
+        unsigned int computed = 0;
+        for (unsigned int i = 0; (i < frameCnt) && !this->cancel; ++i) {
+            const unsigned int frame = (first + i) % frameCnt;
+            if (this->Get(frame) != nullptr) {
+                continue;
+            }
+            AssignmentPtr asn = compute(frame);
+            if (asn != nullptr) {
+                this->Put(frame, asn);
+                ++computed;
+            }
+        }
+        megamol::core::utility::log::Log::DefaultLog.WriteInfo(
+            "STRIDE precomputation %s after %u frames.", this->cancel ? "cancelled" : "finished", computed);
+        this->running = false;
+    });
+}
+
+
+/*
+ * StrideTrajectoryCache::Put
+ */
+void StrideTrajectoryCache::Put(unsigned int frame, AssignmentPtr asn) {
+    if (asn == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(this->lock);
+    if (frame >= this->frames.size()) {
+        this->frames.resize(frame + 1);
+    }
+    if (this->frames[frame] == nullptr) {
+        ++this->cachedCnt;
+    }
+    this->frames[frame] = asn;
+}
+
+
+/*
+ * StrideTrajectoryCache::Stop
+ */
+void StrideTrajectoryCache::Stop(void) {
+    this->cancel = true;
+    if (this->worker.joinable()) {
+        this->worker.join();
+    }
+    this->running = false;
+}
@@ -0,0 +1,119 @@
+/*
+ * StrideTrajectoryCache.h
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Stride.h"
+
+namespace megamol {
+namespace protein {
+
+/**
+ * Stores the STRIDE secondary structure assignment per frame of a
+ * trajectory, so scrubbing through the frames only recomputes frames not
+ * seen before. The missing frames can be precomputed on a background thread.
+ */
+class StrideTrajectoryCache {
+public:
+    /** The assignment of one frame */
+    typedef std::shared_ptr<const Stride::Assignment> AssignmentPtr;
+
+    /**
+     * Computes the assignment of a frame. Called from the background thread,
+     * so it must not touch the state of the calling module which may change
+     * while the precomputation runs.
+     */
+    typedef std::function<AssignmentPtr(unsigned int frame)> ComputeFunc;
+
+    /** Ctor. */
+    StrideTrajectoryCache(void);
+
+    /** Dtor. */
+    ~StrideTrajectoryCache(void);
+
+    /**
+     * Stops the precomputation and drops all frames.
+     */
+    void Clear(void);
+
+    /**
+     * Answer the number of frames stored in the cache.
+     *
+     * @return The number of stored frames.
+     */
+    unsigned int CachedFrameCount(void) const;
+
+    /**
+     * Answer the assignment of a frame.
+     *
+     * @param frame The frame index.
+     *
+     * @return The assignment or nullptr if the frame is not stored.
+     */
+    AssignmentPtr Get(unsigned int frame) const;
+
+    /**
+     * Answer whether the background thread is still computing frames.
+     *
+     * @return 'true' if the precomputation is running.
+     */
+    bool IsPrecomputing(void) const;
+
+    /**
+     * Starts computing all missing frames on a background thread, beginning
+     * with 'first' and wrapping around at the end of the trajectory. Does
+     * nothing if a precomputation is already running.
+     *
+     * @param frameCnt The number of frames of the trajectory.
+     * @param first    The frame to start with, usually the current one.
+     * @param compute  The function computing a frame.
+     */
+    void Precompute(unsigned int frameCnt, unsigned int first, ComputeFunc compute);
+
+    /**
+     * Stores the assignment of a frame.
+     *
+     * @param frame The frame index.
+     * @param asn   The assignment.
+     */
+    void Put(unsigned int frame, AssignmentPtr asn);
+
+    /**
+     * Stops the precomputation, keeping the frames computed so far.
+     */
+    void Stop(void);
+
+private:
+    /** The assignments per frame */
+    std::vector<AssignmentPtr> frames;
+
+    /** The number of frames stored */
+    unsigned int cachedCnt;
+
+    /** Guards 'frames' and 'cachedCnt' */
+    mutable std::mutex lock;
+
+    /** The precomputation thread */
+    std::thread worker;
+
+    /** Flag requesting the precomputation to stop */
+    std::atomic<bool> cancel;
+
+    /** Flag whether the precomputation is running */
+    std::atomic<bool> running;
+};
+
+} /* end namespace protein */
+} /* end namespace megamol */
@@ -0,0 +1,219 @@
+#include "DepthCodec.h"
+#include "stdafx.h"
+
+#include "mmcore/utility/BlockBitPacker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using megamol::core::utility::BlockBitPacker;
+
+namespace {
+
+enum predictor : uint8_t { PREDICTOR_NONE = 0, PREDICTOR_PLANE = 1, PREDICTOR_ROWS = 2 };
+
+constexpr size_t header_size = 8 + 3 * sizeof(int64_t);
+
+/** the largest quantized value, 2^24 - 1 */
+constexpr uint32_t quant_max = (1u << 24) - 1;
+
+constexpr int64_t value_max = 0xffffffffll;
+
+inline int64_t clamp_value(int64_t v) {
+    return std::min(std::max(v, int64_t(0)), value_max);
+}
+
+/** evaluates the 16.16 fixed point plane, identical in encoder and decoder */
+inline int64_t plane_value(int64_t const* plane, int64_t x, int64_t y) {
+    int64_t const p = plane[0] + plane[1] * x + plane[2] * y;
+    return (p < 0) ? 0 : std::min(p >> 16, value_max);
+}
+
+/** residuals of the row extrapolation, exact for affine values */
+void rows_residuals(uint32_t const* v, int width, int height, uint64_t* res) {
+    for (int x = 0; x < width; ++x) {
+        int64_t const pred = (x == 0) ? 0 : (x == 1) ? v[0] : clamp_value(2 * int64_t(v[x - 1]) - v[x - 2]);
+        res[x] = BlockBitPacker::ZigZag(v[x] - pred);
+    }
+    for (int y = 1; y < height; ++y) {
+        uint32_t const* row = v + static_cast<size_t>(y) * width;
+        uint32_t const* up = row - width;
+        uint32_t const* up2 = (y > 1) ? up - width : up;
+        uint64_t* out = res + static_cast<size_t>(y) * width;
+        for (int x = 0; x < width; ++x) {
+            out[x] = BlockBitPacker::ZigZag(row[x] - clamp_value(2 * int64_t(up[x]) - up2[x]));
+        }
+    }
+}
+
+} // namespace
+
+
+size_t megamol::remote::DepthCodec::Encode(
+    float const* depth, int width, int height, Format format, float error_bound, char* out) {
+    size_t const count = static_cast<size_t>(width) * height;
+    size_t const blocks = BlockBitPacker::BlockCount(count);
+    thread_local std::vector<uint32_t> values;
+    thread_local std::vector<uint64_t> plane_res, rows_res;
+    thread_local std::vector<uint8_t> plane_widths, rows_widths;
+    values.resize(count);
+    plane_res.resize(count);
+    rows_res.resize(count);
+    plane_widths.resize(blocks);
+    rows_widths.resize(blocks);
+
+    // values as uint32, float bits keep the order of non-negative depths
+    uint32_t step = 1;
+    if (format == FORMAT_QUANTIZED) {
+        double const s = std::floor(2.0 * std::max(error_bound, 0.0f) * quant_max);
+        step = static_cast<uint32_t>(std::min(std::max(s, 1.0), static_cast<double>(quant_max)));
+        // the largest code decodes to exactly 1, so the far plane is mapped to it explicitly, as
+        // rounding 1 * quant_max / step can end one code below
+        uint32_t const q_max = (quant_max + step - 1) / step;
+        double const scale = static_cast<double>(quant_max) / step;
+        for (size_t i = 0; i < count; ++i) {
+            double const d = std::max(static_cast<double>(depth[i]), 0.0);
+            values[i] = (d >= 1.0) ? q_max : std::min(static_cast<uint32_t>(d * scale + 0.5), q_max);
+        }
+    } else {
+        std::memcpy(values.data(), depth, count * sizeof(float));
+    }
+
+    // least squares plane, the regular grid decouples the slopes
+    double const cx = 0.5 * (width - 1);
+    double const cy = 0.5 * (height - 1);
+    double sum = 0.0, sum_x = 0.0, sum_y = 0.0, sum_xx = 0.0, sum_yy = 0.0;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            double const v = values[static_cast<size_t>(y) * width + x];
+            sum += v;
+            sum_x += (x - cx) * v;
+            sum_y += (y - cy) * v;
+            sum_xx += (x - cx) * (x - cx);
+            sum_yy += (y - cy) * (y - cy);
+        }
+    }
+    double const slope_x = (sum_xx > 0.0) ? sum_x / sum_xx : 0.0;
+    double const slope_y = (sum_yy > 0.0) ? sum_y / sum_yy : 0.0;
+    double const offset = (count > 0) ? sum / count - slope_x * cx - slope_y * cy : 0.0;
+    auto const fixed = [](double v) {
+        return static_cast<int64_t>(std::llround(std::min(std::max(v, -1.0e12), 1.0e12) * 65536.0));
+    };
+    int64_t const plane[3] = {fixed(offset), fixed(slope_x), fixed(slope_y)};
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            size_t const i = static_cast<size_t>(y) * width + x;
+            plane_res[i] = BlockBitPacker::ZigZag(values[i] - plane_value(plane, x, y));
+        }
+    }
+    rows_residuals(values.data(), width, height, rows_res.data());
+
+    size_t const plane_size = BlockBitPacker::Measure(plane_res.data(), count, 1, plane_widths.data());
+    size_t const rows_size = BlockBitPacker::Measure(rows_res.data(), count, 1, rows_widths.data());
+    uint8_t pred = (plane_size <= rows_size) ? PREDICTOR_PLANE : PREDICTOR_ROWS;
+    if (std::min(plane_size, rows_size) >= count * sizeof(uint32_t)) {
+        pred = PREDICTOR_NONE;
+    }
+
+    out[0] = static_cast<char>(format);
+    out[1] = static_cast<char>(pred);
+    out[2] = out[3] = 0;
+    std::memcpy(out + 4, &step, sizeof(step));
+    std::memcpy(out + 8, plane, sizeof(plane));
+    char* data = out + header_size;
+    if (pred == PREDICTOR_NONE) {
+        std::memcpy(data, values.data(), count * sizeof(uint32_t));
+        return header_size + count * sizeof(uint32_t);
+    }
+
+    uint64_t const* res = (pred == PREDICTOR_PLANE) ? plane_res.data() : rows_res.data();
+    uint8_t const* widths = (pred == PREDICTOR_PLANE) ? plane_widths.data() : rows_widths.data();
+    size_t const size = (pred == PREDICTOR_PLANE) ? plane_size : rows_size;
+    BlockBitPacker::Pack(res, count, 1, widths, size, data);
+    return header_size + size;
+}
+
+
+bool megamol::remote::DepthCodec::Decode(char const* in, size_t size, int width, int height, float* depth) {
+    size_t const count = static_cast<size_t>(width) * height;
+    if ((width < 0) || (height < 0) || (size < header_size)) {
+        return false;
+    }
+    uint8_t const format = static_cast<uint8_t>(in[0]);
+    uint8_t const pred = static_cast<uint8_t>(in[1]);
+    uint32_t step;
+    int64_t plane[3];
+    std::memcpy(&step, in + 4, sizeof(step));
+    std::memcpy(plane, in + 8, sizeof(plane));
+    char const* data = in + header_size;
+    size -= header_size;
+    if ((format > FORMAT_QUANTIZED) || (pred > PREDICTOR_ROWS) || (step == 0)) {
+        return false;
+    }
+
+    thread_local std::vector<uint32_t> values;
+    thread_local std::vector<int64_t> res;
+    values.resize(count);
+
+    if (pred == PREDICTOR_NONE) {
+        if (size != count * sizeof(uint32_t)) {
+            return false;
+        }
+        std::memcpy(values.data(), data, size);
+    } else {
+        // each block unpacks independently
+        res.resize(count);
+        size_t const packed = BlockBitPacker::Unpack(data, size, count, 1, res.data());
+        if ((packed == 0) || (packed != size)) {
+            return false;
+        }
+
+        if (pred == PREDICTOR_PLANE) {
+            for (int y = 0; y < height; ++y) {
+                uint32_t* row = values.data() + static_cast<size_t>(y) * width;
+                int64_t const* r = res.data() + static_cast<size_t>(y) * width;
+#pragma omp simd
+                for (int x = 0; x < width; ++x) {
+                    row[x] = static_cast<uint32_t>(plane_value(plane, x, y) + r[x]);
+                }
+            }
+        } else {
+            uint32_t* row = values.data();
+            for (int x = 0; x < width; ++x) {
+                int64_t const p = (x == 0) ? 0 : (x == 1) ? row[0] : clamp_value(2 * int64_t(row[x - 1]) - row[x - 2]);
+                row[x] = static_cast<uint32_t>(p + res[x]);
+            }
+            // the rows depend only on the rows above and vectorize
+            for (int y = 1; y < height; ++y) {
+                row = values.data() + static_cast<size_t>(y) * width;
+                uint32_t const* up = row - width;
+                uint32_t const* up2 = (y > 1) ? up - width : up;
+                int64_t const* r = res.data() + static_cast<size_t>(y) * width;
+#pragma omp simd
+                for (int x = 0; x < width; ++x) {
+                    row[x] = static_cast<uint32_t>(clamp_value(2 * int64_t(up[x]) - up2[x]) + r[x]);
+                }
+            }
+        }
+    }
+
+    if (format == FORMAT_QUANTIZED) {
+        uint32_t const q_max = (quant_max + step - 1) / step;
+        double const scale = static_cast<double>(step) / quant_max;
+#pragma omp simd
+        for (size_t i = 0; i < count; ++i) {
+            depth[i] = (values[i] >= q_max) ? 1.0f : static_cast<float>(values[i] * scale);
+        }
+    } else {
+        std::memcpy(depth, values.data(), count * sizeof(float));
+    }
+    return true;
+}
+
+
+size_t megamol::remote::DepthCodec::MaxEncodedLength(size_t count) {
+    // packed residuals are only used if smaller than the raw values
+    return header_size + count * sizeof(uint32_t);
+}
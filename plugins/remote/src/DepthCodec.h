@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace megamol {
+namespace remote {
+
+/**
+ * Codec for float depth buffers in [0, 1], used for the tiles of the remote
+ * frame transfer.
+ *
+ * The depths are either taken bit exact or quantized to 24 bit with a
+ * configurable error bound. Each tile is predicted by a least squares plane
+ * or, if that fits worse, by extrapolating the two rows above, which is
+ * exact for planar surfaces as screen space depth is affine on them. The
+ * zigzag coded residuals are bit packed in blocks of 16 with one width per
+ * block, so flat regions cost one byte per block. Blocks are independent,
+ * which lets the decoder unpack and reconstruct with vectorized loops.
+ *
+ * Layout:
+ *   uint8    value format, 0 = float bits, 1 = quantized
+ *   uint8    predictor, 0 = none (raw uint32 values), 1 = plane, 2 = rows
+ *   uint16   reserved
+ *   uint32   quantization step in units of 2^-24
+ *   int64    plane coefficients [3], 16 fractional bits (plane only)
+ *   uint8    bit widths of the blocks [ceil(count / 16)]
+ *   ...      packed residuals, padded by 8 zero bytes
+ */
+class DepthCodec {
+public:
+    /** Value formats */
+    enum Format : uint8_t { FORMAT_FLOAT_BITS = 0, FORMAT_QUANTIZED = 1 };
+
+    /**
+     * Encodes a tile.
+     *
+     * @param depth       The row major depths.
+     * @param width       The width of the tile.
+     * @param height      The height of the tile.
+     * @param format      The value format.
+     * @param error_bound The maximum absolute error for quantized values, 0
+     *                    for the 24 bit resolution.
+     * @param out         Receives the encoded tile, at least
+     *                    'MaxEncodedLength' bytes.
+     *
+     * @return The size of the encoded tile in bytes.
+     */
+    static size_t Encode(float const* depth, int width, int height, Format format, float error_bound, char* out);
+
+    /**
+     * Decodes a tile.
+     *
+     * @param in     The encoded tile.
+     * @param size   The size of the encoded tile.
+     * @param width  The width of the tile.
+     * @param height The height of the tile.
+     * @param depth  Receives the 'width' * 'height' row major depths.
+     *
+     * @return 'true' on success, 'false' if the data is malformed.
+     */
+    static bool Decode(char const* in, size_t size, int width, int height, float* depth);
+
+    /**
+     * Answer the maximum size of an encoded tile.
+     *
+     * @param count The number of pixels of the tile.
+     *
+     * @return The size in bytes.
+     */
+    static size_t MaxEncodedLength(size_t count);
+
+    DepthCodec(void) = delete;
+};
+
+} // end namespace remote
+} // end namespace megamol
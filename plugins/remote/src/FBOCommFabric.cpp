@@ -1,11 +1,58 @@
 #include "FBOCommFabric.h"
 #include "stdafx.h"
 
+#include <cstdint>
+#include <cstring>
+
 #ifdef WITH_MPI
 #include <mpi.h>
 #endif // WITH_MPI
 
 
+bool megamol::remote::AbstractCommFabric::SendParts(std::vector<send_part> const& parts, send_type const type) {
+    // [part count][part sizes][part data]
+    size_t size = sizeof(uint64_t) * (parts.size() + 1);
+    for (auto const& part : parts) {
+        size += part.size;
+    }
+    std::vector<char> buf(size);
+    auto table = reinterpret_cast<uint64_t*>(buf.data());
+    table[0] = parts.size();
+    char* data = buf.data() + sizeof(uint64_t) * (parts.size() + 1);
+    for (size_t i = 0; i < parts.size(); ++i) {
+        table[i + 1] = parts[i].size;
+        std::memcpy(data, parts[i].data, parts[i].size);
+        data += parts[i].size;
+    }
+    return this->Send(buf, type);
+}
+
+
+bool megamol::remote::AbstractCommFabric::RecvParts(std::vector<std::vector<char>>& parts, recv_type const type) {
+    std::vector<char> buf;
+    if (!this->Recv(buf, type) || (buf.size() < sizeof(uint64_t))) {
+        return false;
+    }
+    uint64_t count = 0;
+    std::memcpy(&count, buf.data(), sizeof(uint64_t));
+    if (count > buf.size() / sizeof(uint64_t) - 1) {
+        return false;
+    }
+    std::vector<uint64_t> sizes(count);
+    std::memcpy(sizes.data(), buf.data() + sizeof(uint64_t), count * sizeof(uint64_t));
+    size_t offset = sizeof(uint64_t) * (count + 1);
+    parts.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (sizes[i] > buf.size() - offset) {
+            return false;
+        }
+        parts[i].assign(buf.data() + offset, buf.data() + offset + sizes[i]);
+        offset += sizes[i];
+    }
+    return true;
+}
+
+
 megamol::remote::MPICommFabric::MPICommFabric(int target_rank, int source_rank)
         : my_rank_{0}
         , target_rank_{target_rank}
@@ -119,6 +166,43 @@ bool megamol::remote::ZMQCommFabric::Recv(std::vector<char>& buf, recv_type cons
 }
 
 
+bool megamol::remote::ZMQCommFabric::SendParts(std::vector<send_part> const& parts, send_type const type) {
+    for (size_t i = 0; i < parts.size(); ++i) {
+        auto const& part = parts[i];
+        zmq::message_t msg;
+        if (part.owner != nullptr) {
+            // zero copy, the message holds a reference to the owner until ZMQ has sent it
+            auto hint = new std::shared_ptr<void const>(part.owner);
+            msg.rebuild(
+                const_cast<char*>(part.data), part.size,
+                [](void*, void* hint) { delete static_cast<std::shared_ptr<void const>*>(hint); }, hint);
+        } else {
+            msg.rebuild(part.data, part.size);
+        }
+        if (!this->socket_.send(msg, (i + 1 < parts.size()) ? ZMQ_SNDMORE : 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+bool megamol::remote::ZMQCommFabric::RecvParts(std::vector<std::vector<char>>& parts, recv_type const type) {
+    zmq::message_t msg;
+    if (!this->socket_.recv(&msg, ZMQ_DONTWAIT))
+        return false;
+    // the remaining parts of a multipart message are available once the first one is
+    parts.clear();
+    while (true) {
+        parts.emplace_back(static_cast<char*>(msg.data()), static_cast<char*>(msg.data()) + msg.size());
+        if (!msg.more())
+            break;
+        this->socket_.recv(&msg);
+    }
+    return true;
+}
+
+
 bool megamol::remote::ZMQCommFabric::Disconnect() {
     // if (this->socket_.connected()) {
     if (!this->address_.empty()) {
@@ -169,6 +253,16 @@ bool megamol::remote::FBOCommFabric::Recv(std::vector<char>& buf, recv_type cons
 }
 
 
+bool megamol::remote::FBOCommFabric::SendParts(std::vector<send_part> const& parts, send_type const type) {
+    return this->pimpl_->SendParts(parts, type);
+}
+
+
+bool megamol::remote::FBOCommFabric::RecvParts(std::vector<std::vector<char>>& parts, recv_type const type) {
+    return this->pimpl_->RecvParts(parts, type);
+}
+
+
 bool megamol::remote::FBOCommFabric::Disconnect() {
     return this->pimpl_->Disconnect();
 }
@@ -15,12 +15,28 @@ enum send_type : unsigned int { ST_UNDEF = 0, BCAST, SCATTER, SEND, ISEND };
 enum recv_type : unsigned int { RT_UNDEF = 0, RECV, IRECV };
 
 
+/**
+ * Part of a multipart message. 'owner' keeps 'data' alive until the part
+ * has been sent, which may be after 'SendParts' returned. Without owner the
+ * data is copied.
+ */
+struct send_part {
+    char const* data;
+    size_t size;
+    std::shared_ptr<void const> owner;
+};
+
+
 class AbstractCommFabric {
 public:
     virtual bool Connect(std::string const& address) = 0;
     virtual bool Bind(std::string const& address) = 0;
     virtual bool Send(std::vector<char> const& buf, send_type const type = ST_UNDEF) = 0;
     virtual bool Recv(std::vector<char>& buf, recv_type const type = RT_UNDEF) = 0;
+    /** Sends a multipart message, by default packed into one buffer with a table of the part sizes */
+    virtual bool SendParts(std::vector<send_part> const& parts, send_type const type = ST_UNDEF);
+    /** Receives a multipart message sent by 'SendParts' */
+    virtual bool RecvParts(std::vector<std::vector<char>>& parts, recv_type const type = RT_UNDEF);
     virtual bool Disconnect(void) = 0;
     virtual ~AbstractCommFabric(void) = default;
 };
@@ -63,6 +79,8 @@ public:
     bool Bind(std::string const& address) override;
     bool Send(std::vector<char> const& buf, send_type const type = ST_UNDEF) override;
     bool Recv(std::vector<char>& buf, recv_type const type = RT_UNDEF) override;
+    bool SendParts(std::vector<send_part> const& parts, send_type const type = ST_UNDEF) override;
+    bool RecvParts(std::vector<std::vector<char>>& parts, recv_type const type = RT_UNDEF) override;
     bool Disconnect(void) override;
     virtual ~ZMQCommFabric(void);
 
@@ -103,6 +121,10 @@ public:
 
     bool Recv(std::vector<char>& buf, recv_type const type = RT_UNDEF) override;
 
+    bool SendParts(std::vector<send_part> const& parts, send_type const type = ST_UNDEF) override;
+
+    bool RecvParts(std::vector<std::vector<char>>& parts, recv_type const type = RT_UNDEF) override;
+
     bool Disconnect(void) override;
 
     virtual ~FBOCommFabric(void) = default;
@@ -1,6 +1,8 @@
 #include "FBOCompositor2.h"
 #include "stdafx.h"
 
+#include <algorithm>
+#include <array>
 #include <fstream>
 #include <sstream>
 
@@ -17,6 +19,8 @@
 
 #include "snappy.h"
 
+#include "DepthCodec.h"
+
 #include "vislib/Exception.h"
 #include <exception>
 
@@ -399,13 +403,21 @@ bool megamol::remote::FBOCompositor2::initThreads() {
 void megamol::remote::FBOCompositor2::receiverJob(
     FBOCommFabric& comm, core::utility::sys::FutureReset<fbo_msg_t>* fbo_msg_future, std::future<bool>&& close) {
     try {
+        // the frame the deltas of the transmitter are applied to
+        std::vector<char> col_base;
+        std::vector<char> depth_base;
+        int base_width = 0;
+        int base_height = 0;
+        bool need_key = true;
+        std::vector<std::vector<char>> parts;
+
         while (!shutdown_) {
             auto const status = close.wait_for(std::chrono::milliseconds(1));
             if (status == std::future_status::ready)
                 break;
 
-            // send a request for data
-            std::vector<char> buf{'r', 'e', 'q'};
+            // send a request for data, asking for all tiles if there is no valid base
+            std::vector<char> buf = need_key ? std::vector<char>{'k', 'e', 'y'} : std::vector<char>{'r', 'e', 'q'};
             try {
 #if _DEBUG
                 megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOCompositor2: Sending request\n");
@@ -433,7 +445,7 @@ void megamol::remote::FBOCompositor2::receiverJob(
                     megamol::core::utility::log::Log::DefaultLog.WriteError("FBOCompositor2: Exception during recv in 'receiverJob'\n");
                 }*/
                 // std::future_status status;
-                while (!comm.Recv(buf, recv_type::RECV) && !shutdown_) {
+                while (!comm.RecvParts(parts, recv_type::RECV) && !shutdown_) {
                     // status = close.wait_for(std::chrono::milliseconds(1));
                     // if (status == std::future_status::ready) break;
 #if _DEBUG
@@ -454,48 +466,108 @@ void megamol::remote::FBOCompositor2::receiverJob(
             }
 
             fbo_msg_header_t header;
-            char* buf_ptr = buf.data();
-            std::copy(buf_ptr, buf_ptr + sizeof(fbo_msg_header_t), reinterpret_cast<char*>(&header));
-            buf_ptr += sizeof(fbo_msg_header_t);
-            size_t fbo_depth_size;
-            auto vol =
-                (header.updated_area[2] - header.updated_area[0]) * (header.updated_area[3] - header.updated_area[1]);
-            size_t fbo_col_size = fbo_depth_size = static_cast<size_t>(vol);
-            fbo_col_size *= static_cast<size_t>(col_buf_el_size_);
-            fbo_depth_size *= static_cast<size_t>(depth_buf_el_size_);
-
-            if (header.depth_buf_size <= 1 || header.color_buf_size <= 1) {
+            if (parts.empty() || (parts[0].size() != sizeof(fbo_msg_header_t))) {
+                megamol::core::utility::log::Log::DefaultLog.WriteError("FBOCompositor2: Received malformed message\n");
+                need_key = true;
+                continue;
+            }
+            std::copy(parts[0].begin(), parts[0].end(), reinterpret_cast<char*>(&header));
+            int const width = header.updated_area[2] - header.updated_area[0];
+            int const height = header.updated_area[3] - header.updated_area[1];
+            size_t const pixels = static_cast<size_t>(std::max(width, 0)) * static_cast<size_t>(std::max(height, 0));
+            size_t const col_el = static_cast<size_t>(col_buf_el_size_);
+            size_t const depth_el = static_cast<size_t>(depth_buf_el_size_);
+
+            if (header.tile_size == 0 || pixels == 0) {
+                // the transmitter has not rendered a frame yet
 #if _DEBUG
-                megamol::core::utility::log::Log::DefaultLog.WriteWarn(
-                    "FBOCompositor2: Bad size for alloc color/depth; col_buf size: %d; col_comp_buf size: %d; "
-                    "depth_buf size: %d; depth_comp_buf size: %d;\n",
-                    fbo_col_size, header.color_buf_size, fbo_depth_size, header.depth_buf_size);
+                megamol::core::utility::log::Log::DefaultLog.WriteWarn("FBOCompositor2: Received empty frame\n");
 #endif
                 continue;
             }
+            if ((parts.size() != 2 + 2 * static_cast<size_t>(header.tile_count)) ||
+                (parts[1].size() != header.tile_count * sizeof(fbo_tile_t))) {
+                megamol::core::utility::log::Log::DefaultLog.WriteError(
+                    "FBOCompositor2: Received malformed message with %d tiles\n", header.tile_count);
+                need_key = true;
+                continue;
+            }
 
-            std::vector<char> col_buf(fbo_col_size);
-            std::vector<char> col_comp_buf(header.color_buf_size);
-            std::copy(buf_ptr, buf_ptr + header.color_buf_size, col_comp_buf.begin());
-            buf_ptr += header.color_buf_size;
-            std::vector<char> depth_buf(fbo_depth_size);
-            std::vector<char> depth_comp_buf(header.depth_buf_size);
-            std::copy(buf_ptr, buf_ptr + header.depth_buf_size, depth_comp_buf.begin());
+            if (header.key_frame != 0) {
+                col_base.assign(pixels * col_el, 0);
+                depth_base.assign(pixels * depth_el, 0);
+                base_width = width;
+                base_height = height;
+            } else if (need_key || (width != base_width) || (height != base_height)) {
+                // a delta without a matching base, wait for the key frame
+                need_key = true;
+                continue;
+            }
 
-            // snappy uncompress
-            snappy::RawUncompress(col_comp_buf.data(), col_comp_buf.size(), col_buf.data());
-            snappy::RawUncompress(depth_comp_buf.data(), depth_comp_buf.size(), depth_buf.data());
+            // decompress the tiles into the base in parallel
+            auto const table = reinterpret_cast<fbo_tile_t const*>(parts[1].data());
+            int const tile_size = static_cast<int>(header.tile_size);
+            int const tiles_x = (width + tile_size - 1) / tile_size;
+            int const tiles_y = (height + tile_size - 1) / tile_size;
+            int64_t const tile_cnt = static_cast<int64_t>(header.tile_count);
+            bool failed = false;
+#pragma omp parallel
+            {
+                std::vector<char> raw(static_cast<size_t>(tile_size) * tile_size * std::max(col_el, depth_el));
+                bool const depth_codec = (header.depth_codec == fbo_depth_codec::DEPTH_CODEC);
+                // scatters the rows of a decompressed tile into the base
+                auto const scatter = [&](std::vector<char> const& comp, std::array<int, 4> const& rect,
+                                         std::vector<char>& base, size_t el, bool is_depth) {
+                    size_t const size = static_cast<size_t>(rect[2]) * rect[3] * el;
+                    size_t length = 0;
+                    if (is_depth && depth_codec) {
+                        if ((el != sizeof(float)) || !DepthCodec::Decode(comp.data(), comp.size(), rect[2], rect[3],
+                                                         reinterpret_cast<float*>(raw.data()))) {
+                            return false;
+                        }
+                    } else if (!snappy::GetUncompressedLength(comp.data(), comp.size(), &length) || (length != size) ||
+                               !snappy::RawUncompress(comp.data(), comp.size(), raw.data())) {
+                        return false;
+                    }
+                    for (int r = 0; r < rect[3]; ++r) {
+                        size_t const offset = (static_cast<size_t>(rect[1] + r) * width + rect[0]) * el;
+                        std::copy(raw.data() + r * rect[2] * el, raw.data() + (r + 1) * rect[2] * el,
+                            base.data() + offset);
+                    }
+                    return true;
+                };
+#pragma omp for schedule(dynamic)
+                for (int64_t i = 0; i < tile_cnt; ++i) {
+                    auto const& tile = table[i];
+                    bool ok = (tile.index < static_cast<unsigned int>(tiles_x * tiles_y)) &&
+                              (parts[2 + 2 * i].size() == tile.color_size) &&
+                              (parts[3 + 2 * i].size() == tile.depth_size);
+                    if (ok) {
+                        auto const rect = fbo_tile_rect(tile.index, tile_size, width, height);
+                        ok = scatter(parts[2 + 2 * i], rect, col_base, col_el, false) &&
+                             scatter(parts[3 + 2 * i], rect, depth_base, depth_el, true);
+                    }
+                    if (!ok) {
+#pragma omp atomic write
+                        failed = true;
+                    }
+                }
+            }
+            if (failed) {
+                megamol::core::utility::log::Log::DefaultLog.WriteError(
+                    "FBOCompositor2: Could not decode tiles, requesting key frame\n");
+                need_key = true;
+                continue;
+            }
+            need_key = false;
 
-            /*std::vector<char> col_buf(fbo_col_size);
-            std::copy(buf_ptr, buf_ptr + fbo_col_size, col_buf.begin());
-            buf_ptr += fbo_col_size;
-            std::vector<char> depth_buf(fbo_depth_size);
-            std::copy(buf_ptr, buf_ptr + fbo_depth_size, depth_buf.begin());*/
+            std::vector<char> col_buf(col_base);
+            std::vector<char> depth_buf(depth_base);
 
 #ifdef _DEBUG
             megamol::core::utility::log::Log::DefaultLog.WriteInfo(
-                "FBOCompositor2: Got message with col_buf size %d and depth_buf size %d\n", col_buf.size(),
-                depth_buf.size());
+                "FBOCompositor2: Got message with %d of %d tiles, col_buf size %d and depth_buf size %d\n",
+                header.tile_count, tiles_x * tiles_y, col_buf.size(), depth_buf.size());
 #endif
 
             auto const msg = fbo_msg{std::move(header), std::move(col_buf), std::move(depth_buf)};
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <memory>
+#include <vector>
 
 
 namespace megamol {
@@ -83,6 +86,8 @@ enum fbo_color_type : unsigned int { RGBAf, RGBAu8, RGBf, RGBu8 };
 
 enum fbo_depth_type : unsigned int { Df, Du16, Du24, Du32 };
 
+enum fbo_depth_codec : unsigned int { DEPTH_SNAPPY, DEPTH_CODEC };
+
 using data_ptr = char*;
 
 using id_t = unsigned int;
@@ -112,10 +117,43 @@ struct fbo_msg_header {
     size_t color_buf_size;
     // depth buf size
     size_t depth_buf_size;
+    // edge length of the tiles in pixel, 0 if the message holds no frame
+    unsigned int tile_size;
+    // number of tiles in the message
+    unsigned int tile_count;
+    // 1 if the message holds all tiles, 0 if only the tiles changed since the previous message
+    unsigned int key_frame;
+    // compression of the depth tiles
+    fbo_depth_codec depth_codec;
 };
 
 using fbo_msg_header_t = fbo_msg_header;
 
+/**
+ * Entry of the tile table following the header. The compressed color and
+ * depth data of each tile follow as separate message parts.
+ */
+struct fbo_tile {
+    // row major index of the tile
+    unsigned int index;
+    // compressed color size
+    unsigned int color_size;
+    // compressed depth size
+    unsigned int depth_size;
+};
+
+using fbo_tile_t = fbo_tile;
+
+/**
+ * Answer the pixel rectangle {x, y, width, height} of a tile of an image.
+ */
+inline std::array<int, 4> fbo_tile_rect(unsigned int index, int tile_size, int width, int height) {
+    int const tiles_x = (width + tile_size - 1) / tile_size;
+    int const x = static_cast<int>(index % tiles_x) * tile_size;
+    int const y = static_cast<int>(index / tiles_x) * tile_size;
+    return {x, y, std::min(tile_size, width - x), std::min(tile_size, height - y)};
+}
+
 struct fbo_msg {
     fbo_msg() = default;
 
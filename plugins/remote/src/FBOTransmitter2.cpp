@@ -1,20 +1,26 @@
 #include "FBOTransmitter2.h"
 #include "stdafx.h"
 
+#include <algorithm>
 #include <array>
+#include <cstring>
 
 #include "glad/glad.h"
 
 #include "snappy.h"
 
+#include "DepthCodec.h"
+
 #include "mmcore/utility/log/Log.h"
 
 #include "mmcore/CallerSlot.h"
 #include "mmcore/CoreInstance.h"
+#include "mmcore/cluster/mpi/DepthCompositor.h"
 #include "mmcore/cluster/mpi/MpiCall.h"
 #include "mmcore/param/BoolParam.h"
 #include "mmcore/param/ButtonParam.h"
 #include "mmcore/param/EnumParam.h"
+#include "mmcore/param/FloatParam.h"
 #include "mmcore/param/IntParam.h"
 #include "mmcore/param/StringParam.h"
 #include "mmcore/utility/sys/SystemInformation.h"
@@ -39,10 +45,14 @@ megamol::remote::FBOTransmitter2::FBOTransmitter2()
         , handshake_port_slot_{"handshakePort", "Port for zmq handshake"}
         , reconnect_slot_{"reconnect", "Reconnect comm threads"}
         , tiled_slot_("tiledDisplay", "True if rendering on a tiled display")
+        , tile_size_slot_("tileSize", "Edge length of the tiles, only tiles changed since the last frame are sent")
+        , depth_codec_slot_("depthCodec", "Compression of the depth buffer")
+        , depth_error_slot_("depthErrorBound", "Maximum depth error of the quantized depth codec, 0 for 24 bit")
 #ifdef WITH_MPI
         , callRequestMpi("requestMpi", "Requests initialisation of MPI and the communicator for the view.")
         , toggle_aggregate_slot_{"aggregate", "Toggle whether to aggregate and composite FBOs prior to transmission"}
         , render_comp_img_slot_("renderCompImage", "Renders the complete composited image on the broadcast master")
+        , aggregate_method_slot_("aggregateMethod", "Compositing used for the aggregation")
 #endif // WITH_MPI
         , aggregate_{false}
         , frame_id_{0}
@@ -56,7 +66,13 @@ megamol::remote::FBOTransmitter2::FBOTransmitter2()
         , col_buf_el_size_{4}
         , depth_buf_el_size_{4}
         , connected_{false}
-        , validViewport(false) {
+        , validViewport(false)
+        , tile_size_{128}
+        , depth_codec_{DEPTH_LOSSLESS}
+        , depth_error_{0.0f}
+        , sent_width_{0}
+        , sent_height_{0}
+        , sent_tile_size_{0} {
     this->address_slot_ << new megamol::core::param::StringParam{"34242"};
     this->MakeSlotAvailable(&this->address_slot_);
     this->handshake_port_slot_ << new megamol::core::param::IntParam(42000);
@@ -84,6 +100,11 @@ megamol::remote::FBOTransmitter2::FBOTransmitter2()
     render_comp_img_slot_ << new megamol::core::param::BoolParam{false};
     this->render_comp_img_slot_.SetUpdateCallback(&FBOTransmitter2::renderCompChanged);
     this->MakeSlotAvailable(&render_comp_img_slot_);
+    auto method_ep = new megamol::core::param::EnumParam(ICET);
+    method_ep->SetTypePair(ICET, "IceT");
+    method_ep->SetTypePair(BINARY_SWAP, "BinarySwap");
+    aggregate_method_slot_ << method_ep;
+    this->MakeSlotAvailable(&aggregate_method_slot_);
 #endif // WITH_MPI
     reconnect_slot_ << new megamol::core::param::ButtonParam{};
     reconnect_slot_.SetUpdateCallback(&FBOTransmitter2::reconnectCallback);
@@ -91,6 +112,19 @@ megamol::remote::FBOTransmitter2::FBOTransmitter2()
 
     tiled_slot_ << new megamol::core::param::BoolParam(false);
     this->MakeSlotAvailable(&tiled_slot_);
+
+    tile_size_slot_ << new megamol::core::param::IntParam(128, 16, 4096);
+    this->MakeSlotAvailable(&tile_size_slot_);
+
+    auto depth_ep = new megamol::core::param::EnumParam(DEPTH_LOSSLESS);
+    depth_ep->SetTypePair(DEPTH_SNAPPY, "Snappy");
+    depth_ep->SetTypePair(DEPTH_LOSSLESS, "Lossless");
+    depth_ep->SetTypePair(DEPTH_QUANTIZED, "Quantized");
+    depth_codec_slot_ << depth_ep;
+    this->MakeSlotAvailable(&depth_codec_slot_);
+
+    depth_error_slot_ << new megamol::core::param::FloatParam(0.0f, 0.0f, 0.5f);
+    this->MakeSlotAvailable(&depth_error_slot_);
 }
 
 
@@ -136,6 +170,10 @@ void megamol::remote::FBOTransmitter2::AfterRender(megamol::core::view::Abstract
             this->viewport[5] = glvp[3];
         }
     }
+    this->tile_size_ = this->tile_size_slot_.Param<core::param::IntParam>()->Value();
+    this->depth_codec_ = this->depth_codec_slot_.Param<core::param::EnumParam>()->Value();
+    this->depth_error_ = this->depth_error_slot_.Param<core::param::FloatParam>()->Value();
+
     int xoff = this->viewport[0];
     int yoff = this->viewport[1];
     int tile_width = this->viewport[2];
@@ -157,6 +195,8 @@ void megamol::remote::FBOTransmitter2::AfterRender(megamol::core::view::Abstract
     } else {
         std::vector<char> col_buf_tile(tile_width * tile_height * col_buf_el_size_);
         std::vector<char> depth_buf_tile(tile_width * tile_height * depth_buf_el_size_);
+        // pixels outside of the tile are at the far plane, so any rank covering them wins the depth test
+        std::fill_n(reinterpret_cast<float*>(depth_buf.data()), width * height, 1.0f);
 
         glReadPixels(0, 0, tile_width, tile_height, GL_RGBA, GL_UNSIGNED_BYTE, col_buf_tile.data());
         glReadPixels(0, 0, tile_width, tile_height, GL_DEPTH_COMPONENT, GL_FLOAT, depth_buf_tile.data());
@@ -186,7 +226,20 @@ void megamol::remote::FBOTransmitter2::AfterRender(megamol::core::view::Abstract
     IceTUByte* icet_col_buf = reinterpret_cast<IceTUByte*>(col_buf.data());
     IceTFloat* icet_depth_buf = reinterpret_cast<IceTFloat*>(depth_buf.data());
 
-    if (aggregate_) {
+    bool const binary_swap =
+        this->aggregate_method_slot_.Param<megamol::core::param::EnumParam>()->Value() == BINARY_SWAP;
+    if (aggregate_ && binary_swap) {
+        // the full images are composited in place, only rank 0 holds the result afterwards
+        if (!core::cluster::mpi::DepthCompositor::Composite(this->mpi_comm_,
+                reinterpret_cast<uint32_t*>(col_buf.data()), reinterpret_cast<float*>(depth_buf.data()),
+                static_cast<size_t>(width) * height, 0)) {
+            megamol::core::utility::log::Log::DefaultLog.WriteError(
+                "FBOTransmitter2: Binary-swap compositing failed at rank %d\n", mpiRank);
+        }
+        if ((mpiRank == 0) && this->render_comp_img_slot_.Param<core::param::BoolParam>()->Value()) {
+            glDrawPixels(width, height, GL_RGBA, GL_UNSIGNED_BYTE, col_buf.data());
+        }
+    } else if (aggregate_) {
 #if _DEBUG
         megamol::core::utility::log::Log::DefaultLog.WriteInfo(
             "FBOTransmitter2: Simple IceT commit at rank %d\n", mpiRank);
@@ -341,45 +394,16 @@ void megamol::remote::FBOTransmitter2::transmitterJob() {
                 //            }
                 //#endif
 
-                // snappy compression
-                std::vector<char> col_comp_buf(snappy::MaxCompressedLength(this->color_buf_send_->size()));
-                std::vector<char> depth_comp_buf(snappy::MaxCompressedLength(this->depth_buf_send_->size()));
-                size_t col_comp_size = 0;
-                size_t depth_comp_size = 0;
-
-                // if (aggregate_) {
-                //    snappy::RawCompress(reinterpret_cast<char*>(icet_col_buf), this->color_buf_send_->size(),
-                //        col_comp_buf.data(), &col_comp_size);
-                //    snappy::RawCompress(reinterpret_cast<char*>(icet_depth_buf), this->depth_buf_send_->size(),
-                //        depth_comp_buf.data(), &depth_comp_size);
-                //} else {
-                snappy::RawCompress(
-                    this->color_buf_send_->data(), this->color_buf_send_->size(), col_comp_buf.data(), &col_comp_size);
-                snappy::RawCompress(this->depth_buf_send_->data(), this->depth_buf_send_->size(), depth_comp_buf.data(),
-                    &depth_comp_size);
-                //}
-
-                fbo_msg_send_->color_buf_size = col_comp_size;
-                fbo_msg_send_->depth_buf_size = depth_comp_size;
-                // compose message from header, color_buf, and depth_buf
-                buf.resize(sizeof(fbo_msg_header_t) + col_comp_size + depth_comp_size);
-                std::copy(reinterpret_cast<char*>(&(*fbo_msg_send_)),
-                    reinterpret_cast<char*>(&(*fbo_msg_send_)) + sizeof(fbo_msg_header_t), buf.data());
-                /*std::copy(
-                    this->color_buf_send_->begin(), this->color_buf_send_->end(), buf.data() +
-                sizeof(fbo_msg_header_t)); std::copy(this->depth_buf_send_->begin(), this->depth_buf_send_->end(),
-                    buf.data() + sizeof(fbo_msg_header_t) + this->color_buf_send_->size());*/
-                std::copy(
-                    col_comp_buf.data(), col_comp_buf.data() + col_comp_size, buf.data() + sizeof(fbo_msg_header_t));
-                std::copy(depth_comp_buf.data(), depth_comp_buf.data() + depth_comp_size,
-                    buf.data() + sizeof(fbo_msg_header_t) + col_comp_size);
-
                 // send data
                 try {
 #if _DEBUG
                     megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: Sending answer\n");
 #endif
-                    if (!this->comm_->Send(buf, send_type::SEND)) {
+                    // the receiver asks for all tiles if it has no base for a delta
+                    bool const key_frame = (buf.size() == 3) && std::equal(buf.begin(), buf.end(), "key");
+                    if (!this->sendTiles(key_frame)) {
+                        // the receiver might lack the tiles, start over with a key frame
+                        this->sent_width_ = 0;
                         megamol::core::utility::log::Log::DefaultLog.WriteError(
                             "FBOTransmitter2: Error during send in 'transmitterJob'\n");
                     }
@@ -401,6 +425,155 @@ void megamol::remote::FBOTransmitter2::transmitterJob() {
 }
 
 
+bool megamol::remote::FBOTransmitter2::sendTiles(bool key_frame) {
+    fbo_msg_header_t header = *this->fbo_msg_send_;
+    int const width = header.screen_area[2] - header.screen_area[0];
+    int const height = header.screen_area[3] - header.screen_area[1];
+    size_t const col_el = col_buf_el_size_;
+    size_t const depth_el = depth_buf_el_size_;
+    size_t const pixels = static_cast<size_t>(std::max(width, 0)) * static_cast<size_t>(std::max(height, 0));
+    char const* color = this->color_buf_send_->data();
+    char const* depth = this->depth_buf_send_->data();
+
+    // reuse a compression buffer no longer referenced by ZMQ
+    std::shared_ptr<std::vector<char>> comp_buf;
+    for (auto const& b : this->comp_bufs_) {
+        if (b.use_count() == 1) {
+            comp_buf = b;
+            break;
+        }
+    }
+    if (comp_buf == nullptr) {
+        comp_buf = std::make_shared<std::vector<char>>();
+        this->comp_bufs_.push_back(comp_buf);
+    }
+
+    if ((pixels == 0) || (this->color_buf_send_->size() != pixels * col_el) ||
+        (this->depth_buf_send_->size() != pixels * depth_el)) {
+        // nothing rendered yet, answer with an empty message
+        header.tile_size = header.tile_count = header.key_frame = 0;
+        header.depth_codec = fbo_depth_codec::DEPTH_SNAPPY;
+        header.color_buf_size = header.depth_buf_size = 0;
+        comp_buf->resize(sizeof(fbo_msg_header_t));
+        std::memcpy(comp_buf->data(), &header, sizeof(fbo_msg_header_t));
+        return this->comm_->SendParts({{comp_buf->data(), comp_buf->size(), comp_buf}}, send_type::SEND);
+    }
+
+    int const tile_size = this->tile_size_;
+    int const tiles_x = (width + tile_size - 1) / tile_size;
+    int const tiles_y = (height + tile_size - 1) / tile_size;
+    int64_t const tile_cnt = static_cast<int64_t>(tiles_x) * tiles_y;
+
+    key_frame = key_frame || (this->sent_width_ != width) || (this->sent_height_ != height) ||
+                (this->sent_tile_size_ != tile_size);
+    if (key_frame) {
+        this->sent_color_buf_.resize(pixels * col_el);
+        this->sent_depth_buf_.resize(pixels * depth_el);
+    }
+
+    // find the tiles which differ from the frame last sent
+    std::vector<char> changed(tile_cnt, key_frame ? 1 : 0);
+    if (!key_frame) {
+#pragma omp parallel for schedule(dynamic)
+        for (int64_t t = 0; t < tile_cnt; ++t) {
+            auto const rect = fbo_tile_rect(t, tile_size, width, height);
+            for (int y = rect[1]; (y < rect[1] + rect[3]) && !changed[t]; ++y) {
+                size_t const offset = static_cast<size_t>(y) * width + rect[0];
+                changed[t] = (std::memcmp(color + offset * col_el, this->sent_color_buf_.data() + offset * col_el,
+                                  rect[2] * col_el) != 0) ||
+                             (std::memcmp(depth + offset * depth_el, this->sent_depth_buf_.data() + offset * depth_el,
+                                  rect[2] * depth_el) != 0);
+            }
+        }
+    }
+    std::vector<unsigned int> indices;
+    for (int64_t t = 0; t < tile_cnt; ++t) {
+        if (changed[t]) {
+            indices.push_back(static_cast<unsigned int>(t));
+        }
+    }
+    int64_t const cnt = static_cast<int64_t>(indices.size());
+
+    // [header][tile table][color and depth slot per tile]
+    size_t const tile_pixels = static_cast<size_t>(tile_size) * tile_size;
+    size_t const col_slot = snappy::MaxCompressedLength(tile_pixels * col_el);
+    int const depth_codec = this->depth_codec_;
+    auto const depth_format =
+        (depth_codec == DEPTH_QUANTIZED) ? DepthCodec::FORMAT_QUANTIZED : DepthCodec::FORMAT_FLOAT_BITS;
+    float const depth_error = this->depth_error_;
+    size_t const depth_slot = (depth_codec == DEPTH_SNAPPY) ? snappy::MaxCompressedLength(tile_pixels * depth_el)
+                                                            : DepthCodec::MaxEncodedLength(tile_pixels);
+    size_t const table_offset = sizeof(fbo_msg_header_t);
+    size_t const slot_offset = table_offset + cnt * sizeof(fbo_tile_t);
+    comp_buf->resize(slot_offset + cnt * (col_slot + depth_slot));
+    auto const table = reinterpret_cast<fbo_tile_t*>(comp_buf->data() + table_offset);
+    char* const slots = comp_buf->data() + slot_offset;
+
+#pragma omp parallel
+    {
+        std::vector<char> raw(tile_pixels * std::max(col_el, depth_el));
+        // gathers the rows of a tile and remembers them as sent
+        auto const gather = [&](std::array<int, 4> const& rect, char const* src, std::vector<char>& sent, size_t el) {
+            for (int r = 0; r < rect[3]; ++r) {
+                size_t const offset = (static_cast<size_t>(rect[1] + r) * width + rect[0]) * el;
+                std::memcpy(raw.data() + r * rect[2] * el, src + offset, rect[2] * el);
+                std::memcpy(sent.data() + offset, src + offset, rect[2] * el);
+            }
+        };
+#pragma omp for schedule(dynamic)
+        for (int64_t i = 0; i < cnt; ++i) {
+            auto const rect = fbo_tile_rect(indices[i], tile_size, width, height);
+            size_t const size = static_cast<size_t>(rect[2]) * rect[3];
+            char* const col_dst = slots + i * (col_slot + depth_slot);
+            char* const depth_dst = col_dst + col_slot;
+            size_t col_size = 0;
+            size_t depth_size = 0;
+            gather(rect, color, this->sent_color_buf_, col_el);
+            snappy::RawCompress(raw.data(), size * col_el, col_dst, &col_size);
+            gather(rect, depth, this->sent_depth_buf_, depth_el);
+            if (depth_codec == DEPTH_SNAPPY) {
+                snappy::RawCompress(raw.data(), size * depth_el, depth_dst, &depth_size);
+            } else {
+                depth_size = DepthCodec::Encode(
+                    reinterpret_cast<float const*>(raw.data()), rect[2], rect[3], depth_format, depth_error, depth_dst);
+            }
+            table[i] =
+                fbo_tile_t{indices[i], static_cast<unsigned int>(col_size), static_cast<unsigned int>(depth_size)};
+        }
+    }
+
+    header.tile_size = tile_size;
+    header.tile_count = static_cast<unsigned int>(cnt);
+    header.key_frame = key_frame ? 1 : 0;
+    header.depth_codec = (depth_codec == DEPTH_SNAPPY) ? fbo_depth_codec::DEPTH_SNAPPY : fbo_depth_codec::DEPTH_CODEC;
+    header.color_buf_size = header.depth_buf_size = 0;
+    for (int64_t i = 0; i < cnt; ++i) {
+        header.color_buf_size += table[i].color_size;
+        header.depth_buf_size += table[i].depth_size;
+    }
+    std::memcpy(comp_buf->data(), &header, sizeof(fbo_msg_header_t));
+
+    // the parts reference the compression buffer, no concatenation
+    std::vector<send_part> parts;
+    parts.reserve(2 + 2 * cnt);
+    parts.push_back({comp_buf->data(), sizeof(fbo_msg_header_t), comp_buf});
+    parts.push_back({comp_buf->data() + table_offset, cnt * sizeof(fbo_tile_t), comp_buf});
+    for (int64_t i = 0; i < cnt; ++i) {
+        char const* const col_src = slots + i * (col_slot + depth_slot);
+        parts.push_back({col_src, table[i].color_size, comp_buf});
+        parts.push_back({col_src + col_slot, table[i].depth_size, comp_buf});
+    }
+    if (!this->comm_->SendParts(parts, send_type::SEND)) {
+        return false;
+    }
+
+    this->sent_width_ = width;
+    this->sent_height_ = height;
+    this->sent_tile_size_ = tile_size;
+    return true;
+}
+
+
 bool megamol::remote::FBOTransmitter2::triggerButtonClicked(megamol::core::param::ParamSlot& slot) {
     // happy trigger finger hit button action happened
     using megamol::core::utility::log::Log;
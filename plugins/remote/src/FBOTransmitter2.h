@@ -89,6 +89,16 @@ private:
 
     void transmitterJob();
 
+    /**
+     * Sends the tiles of the send buffers which changed since the last sent
+     * frame, or all tiles for a key frame. The tiles are compressed in
+     * parallel and sent as multipart message. Must be called with the send
+     * buffers locked.
+     */
+    bool sendTiles(bool key_frame);
+
+    enum depth_codec_mode { DEPTH_SNAPPY = 0, DEPTH_LOSSLESS = 1, DEPTH_QUANTIZED = 2 };
+
     bool triggerButtonClicked(core::param::ParamSlot& slot);
 
     bool extractMetaData(float bbox[6], float frame_times[2], float cam_params[9]);
@@ -123,6 +133,12 @@ private:
 
     megamol::core::param::ParamSlot tiled_slot_;
 
+    megamol::core::param::ParamSlot tile_size_slot_;
+
+    megamol::core::param::ParamSlot depth_codec_slot_;
+
+    megamol::core::param::ParamSlot depth_error_slot_;
+
     bool aggregate_;
 
 #ifdef WITH_MPI
@@ -133,6 +149,8 @@ private:
 
     megamol::core::param::ParamSlot render_comp_img_slot_;
 
+    /** selects IceT or the CPU binary-swap compositor for aggregation */
+    megamol::core::param::ParamSlot aggregate_method_slot_;
 
     bool useMpi = false;
     int mpiRank = -1, mpiSize = -1;
@@ -142,6 +160,8 @@ private:
     IceTCommunicator icet_comm_;
 
     MPI_Comm mpi_comm_ = MPI_COMM_NULL;
+
+    enum aggregate_method { ICET = 0, BINARY_SWAP = 1 };
 #endif // WITH_MPI
 
     bool renderCompChanged(core::param::ParamSlot& slot);
@@ -174,6 +194,28 @@ private:
 
     std::unique_ptr<FBOCommFabric> comm_;
 
+    /** edge length of the transmitted tiles, set from the render thread */
+    std::atomic<int> tile_size_;
+
+    /** compression of the depth tiles, see 'depth_codec_mode', set from the render thread */
+    std::atomic<int> depth_codec_;
+
+    std::atomic<float> depth_error_;
+
+    /** the frame last sent, i.e. the base of the receiver for the next delta */
+    std::vector<char> sent_color_buf_;
+
+    std::vector<char> sent_depth_buf_;
+
+    int sent_width_;
+
+    int sent_height_;
+
+    int sent_tile_size_;
+
+    /** compression buffers, reused once ZMQ has released all parts referencing them */
+    std::vector<std::shared_ptr<std::vector<char>>> comp_bufs_;
+
     int col_buf_el_size_;
 
     int depth_buf_el_size_;
@@ -0,0 +1,89 @@
+/*
+ * BrickedIsoSurface.h
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace megamol {
+namespace trisoup {
+namespace volumetrics {
+
+/**
+ * Extracts an iso-surface from a scalar field with marching cubes. The grid
+ * is split into bricks which are sampled and marched in parallel. Vertices
+ * are welded through hash maps keyed by the grid edge they lie on. Every
+ * edge is owned by exactly one brick, so triangles crossing brick borders
+ * are stitched by looking up the owning brick after a prefix sum over the
+ * vertex counts, without a serial pass over the surface.
+ *
+ * The surface encloses the values greater than or equal to the iso value;
+ * normals point towards decreasing values.
+ */
+class BrickedIsoSurface {
+public:
+    /**
+     * Samples the scalar field on a block of grid points. The samples are
+     * stored x-fastest. The block may extend one point beyond the grid on
+     * every side, and the same point must always yield the same value.
+     *
+     * @param first   The first grid point of the block.
+     * @param count   The number of grid points per axis.
+     * @param samples Receives count[0] * count[1] * count[2] values.
+     */
+    typedef std::function<void(
+        const std::array<int64_t, 3>& first, const std::array<size_t, 3>& count, float* samples)>
+        Sampler;
+
+    /** Ctor. */
+    BrickedIsoSurface(void);
+
+    /** Dtor. */
+    ~BrickedIsoSurface(void);
+
+    /**
+     * Extracts the surface, replacing the previous one.
+     *
+     * @param cells     The number of cells per axis, i.e. the number of grid
+     *                  points minus one.
+     * @param brickSize The edge length of the bricks in cells.
+     * @param sampler   The function sampling the field.
+     * @param isoValue  The iso value.
+     * @param origin    The position of grid point (0, 0, 0).
+     * @param spacing   The distance between grid points per axis.
+     */
+    void Extract(const std::array<size_t, 3>& cells, size_t brickSize, const Sampler& sampler, float isoValue,
+        const std::array<float, 3>& origin, const std::array<float, 3>& spacing);
+
+    /** Answer the vertex normals. */
+    inline const std::vector<std::array<float, 3>>& Normals(void) const {
+        return this->normals;
+    }
+
+    /** Answer the vertex positions. */
+    inline const std::vector<std::array<float, 3>>& Positions(void) const {
+        return this->positions;
+    }
+
+    /** Answer the vertex indices of the triangles. */
+    inline const std::vector<std::array<uint32_t, 3>>& Triangles(void) const {
+        return this->triangles;
+    }
+
+private:
+    std::vector<std::array<float, 3>> positions;
+    std::vector<std::array<float, 3>> normals;
+    std::vector<std::array<uint32_t, 3>> triangles;
+};
+
+} /* end namespace volumetrics */
+} /* end namespace trisoup */
+} /* end namespace megamol */
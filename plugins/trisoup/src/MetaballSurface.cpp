@@ -0,0 +1,345 @@
+/*
+ * MetaballSurface.cpp
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "MetaballSurface.h"
+#include "mmcore/param/FloatParam.h"
+#include "mmcore/param/IntParam.h"
+#include "mmcore/utility/log/Log.h"
+#include "stdafx.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+using namespace megamol;
+using namespace megamol::core;
+
+
+/*
+ * trisoup::MetaballSurface::MetaballSurface
+ */
+trisoup::MetaballSurface::MetaballSurface(void)
+        : Module()
+        , getDataSlot("getData", "Fetches the particles")
+        , deployMeshSlot("mesh", "Provides the surfaces of the particle lists as meshes")
+        , radiusScaleSlot("radiusScale", "The influence radius of a particle relative to its radius")
+        , isoValueSlot("isoValue", "The iso value; 1 reproduces the radius of isolated particles, lower values blend "
+                                   "neighbouring particles more")
+        , cellSizeRatioSlot("cellSizeRatio", "Fraction of the minimal particle radius that is used as cell size")
+        , brickSizeSlot("brickSize", "The edge length in cells of the bricks processed in parallel")
+        , dataHash(0)
+        , frameID(0)
+        , version(0) {
+
+    this->getDataSlot.SetCompatibleCall<geocalls::MultiParticleDataCallDescription>();
+    this->MakeSlotAvailable(&this->getDataSlot);
+
+    this->deployMeshSlot.SetCallback(mesh::CallMesh::ClassName(),
+        mesh::CallMesh::FunctionName(mesh::CallMesh::CallGetData), &MetaballSurface::getDataCallback);
+    this->deployMeshSlot.SetCallback(mesh::CallMesh::ClassName(),
+        mesh::CallMesh::FunctionName(mesh::CallMesh::CallGetMetaData), &MetaballSurface::getMetaDataCallback);
+    this->MakeSlotAvailable(&this->deployMeshSlot);
+
+    this->radiusScaleSlot << new param::FloatParam(2.0f, 1.1f, 10.0f);
+    this->MakeSlotAvailable(&this->radiusScaleSlot);
+
+    this->isoValueSlot << new param::FloatParam(1.0f, 0.01f);
+    this->MakeSlotAvailable(&this->isoValueSlot);
+
+    this->cellSizeRatioSlot << new param::FloatParam(0.5f, 0.01f, 10.0f);
+    this->MakeSlotAvailable(&this->cellSizeRatioSlot);
+
+    this->brickSizeSlot << new param::IntParam(32, 4, 256);
+    this->MakeSlotAvailable(&this->brickSizeSlot);
+}
+
+
+/*
+ * trisoup::MetaballSurface::~MetaballSurface
+ */
+trisoup::MetaballSurface::~MetaballSurface(void) {
+    this->Release();
+}
+
+
+/*
+ * trisoup::MetaballSurface::create
+ */
+bool trisoup::MetaballSurface::create(void) {
+    return true;
+}
+
+
+/*
+ * trisoup::MetaballSurface::release
+ */
+void trisoup::MetaballSurface::release(void) {
+    this->meshes.reset();
+    this->surfaces.clear();
+}
+
+
+/*
+ * trisoup::MetaballSurface::extract
+ */
+void trisoup::MetaballSurface::extract(geocalls::MultiParticleDataCall& dat) {
+    using geocalls::SimpleSphericalParticles;
+    using megamol::core::utility::log::Log;
+    const float scale = this->radiusScaleSlot.Param<param::FloatParam>()->Value();
+    const float isoValue = this->isoValueSlot.Param<param::FloatParam>()->Value();
+    const float cellRatio = this->cellSizeRatioSlot.Param<param::FloatParam>()->Value();
+    const size_t brickSize = static_cast<size_t>(this->brickSizeSlot.Param<param::IntParam>()->Value());
+    // normalises the kernel to reach 1 at the radius of an isolated particle
+    const float norm = std::pow(1.0f - 1.0f / (scale * scale), 3.0f);
+    // limits the grid per axis and in total, as the vertex indices are 32 bit
+    const size_t maxCells = 1024;
+    const size_t maxTotalCells = size_t(1) << 27;
+
+    this->surfaces.clear();
+    this->meshes = std::make_shared<mesh::MeshDataAccessCollection>();
+    this->bboxs.Clear();
+    vislib::math::Cuboid<float> total;
+    bool hasTotal = false;
+
+    for (unsigned int l = 0; l < dat.GetParticleListCount(); ++l) {
+        auto& parts = dat.AccessParticles(l);
+        const size_t cnt = static_cast<size_t>(parts.GetCount());
+        if ((parts.GetVertexDataType() == SimpleSphericalParticles::VERTDATA_NONE) || (cnt == 0)) {
+            continue;
+        }
+
+        // fetch the particles
+        const auto& store = parts.GetParticleStore();
+        const bool perParticleRadius = (parts.GetVertexDataType() == SimpleSphericalParticles::VERTDATA_FLOAT_XYZR);
+        const float globalRadius = parts.GetGlobalRadius();
+        std::vector<std::array<float, 4>> particles(cnt);
+#pragma omp parallel for
+        for (int64_t i = 0; i < static_cast<int64_t>(cnt); ++i) {
+            particles[i] = {store.GetXAcc()->Get_f(i), store.GetYAcc()->Get_f(i), store.GetZAcc()->Get_f(i),
+                scale * (perParticleRadius ? store.GetRAcc()->Get_f(i) : globalRadius)};
+        }
+
+        float minRad = particles[0][3], maxRad = particles[0][3];
+        std::array<float, 3> lo = {particles[0][0], particles[0][1], particles[0][2]}, hi = lo;
+        for (const auto& p : particles) {
+            minRad = std::min(minRad, p[3]);
+            maxRad = std::max(maxRad, p[3]);
+            for (int i = 0; i < 3; ++i) {
+                lo[i] = std::min(lo[i], p[i]);
+                hi[i] = std::max(hi[i], p[i]);
+            }
+        }
+        if (minRad <= 0.0f) {
+            Log::DefaultLog.WriteWarn("MetaballSurface: particle list %u has no positive radius, skipped.", l);
+            continue;
+        }
+
+        // the grid covers the influence of all particles
+        float cellSize = cellRatio * minRad / scale;
+        std::array<float, 3> origin;
+        std::array<size_t, 3> cells;
+        for (int i = 0; i < 3; ++i) {
+            cellSize = std::max(cellSize, (hi[i] - lo[i] + 2.0f * maxRad) / static_cast<float>(maxCells - 2));
+        }
+        for (;;) {
+            for (int i = 0; i < 3; ++i) {
+                origin[i] = lo[i] - maxRad - cellSize;
+                cells[i] = static_cast<size_t>(std::ceil((hi[i] - lo[i] + 2.0f * maxRad) / cellSize)) + 2;
+            }
+            const double total = static_cast<double>(cells[0]) * cells[1] * cells[2];
+            if (total <= static_cast<double>(maxTotalCells)) {
+                break;
+            }
+            cellSize *= std::max(1.01f, static_cast<float>(std::cbrt(total / static_cast<double>(maxTotalCells))));
+        }
+        if (cellSize > cellRatio * minRad / scale) {
+            Log::DefaultLog.WriteWarn(
+                "MetaballSurface: cell size of particle list %u increased to %f to limit the grid.", l, cellSize);
+        }
+
+        // sort the particles into bins of the maximum influence radius
+        std::array<size_t, 3> bins;
+        for (int i = 0; i < 3; ++i) {
+            bins[i] = static_cast<size_t>((cells[i] * cellSize) / maxRad) + 1;
+        }
+        const auto binCoord = [&](float v, int axis) -> int64_t {
+            const auto b = static_cast<int64_t>(std::floor((v - origin[axis]) / maxRad));
+            return std::min<int64_t>(std::max<int64_t>(b, 0), static_cast<int64_t>(bins[axis]) - 1);
+        };
+        std::vector<size_t> binOf(cnt);
+        std::vector<size_t> binStart(bins[0] * bins[1] * bins[2] + 1, 0);
+#pragma omp parallel for
+        for (int64_t i = 0; i < static_cast<int64_t>(cnt); ++i) {
+            const auto& p = particles[i];
+            binOf[i] = (binCoord(p[2], 2) * bins[1] + binCoord(p[1], 1)) * bins[0] + binCoord(p[0], 0);
+        }
+        for (size_t i = 0; i < cnt; ++i) {
+            ++binStart[binOf[i] + 1];
+        }
+        for (size_t b = 1; b < binStart.size(); ++b) {
+            binStart[b] += binStart[b - 1];
+        }
+        std::vector<uint32_t> sorted(cnt);
+        {
+            std::vector<size_t> fill(binStart.begin(), binStart.end() - 1);
+            for (size_t i = 0; i < cnt; ++i) {
+                sorted[fill[binOf[i]]++] = static_cast<uint32_t>(i);
+            }
+        }
+
+        // splats the particles near the block, always in the same order per grid point
+        const auto sampler = [&](const std::array<int64_t, 3>& first, const std::array<size_t, 3>& count,
+                                 float* samples) {
+            std::fill(samples, samples + count[0] * count[1] * count[2], 0.0f);
+            std::array<int64_t, 3> b0, b1;
+            for (int i = 0; i < 3; ++i) {
+                b0[i] = binCoord(origin[i] + first[i] * cellSize - maxRad, i);
+                b1[i] = binCoord(origin[i] + (first[i] + static_cast<int64_t>(count[i]) - 1) * cellSize + maxRad, i);
+            }
+            for (int64_t bz = b0[2]; bz <= b1[2]; ++bz) {
+                for (int64_t by = b0[1]; by <= b1[1]; ++by) {
+                    for (int64_t bx = b0[0]; bx <= b1[0]; ++bx) {
+                        const size_t bin = (bz * bins[1] + by) * bins[0] + bx;
+                        for (size_t s = binStart[bin]; s < binStart[bin + 1]; ++s) {
+                            const auto& p = particles[sorted[s]];
+                            const float r2 = p[3] * p[3];
+                            std::array<int64_t, 3> g0, g1;
+                            for (int i = 0; i < 3; ++i) {
+                                g0[i] = std::max(first[i],
+                                    static_cast<int64_t>(std::ceil((p[i] - p[3] - origin[i]) / cellSize)));
+                                g1[i] = std::min(first[i] + static_cast<int64_t>(count[i]) - 1,
+                                    static_cast<int64_t>(std::floor((p[i] + p[3] - origin[i]) / cellSize)));
+                            }
+                            for (int64_t z = g0[2]; z <= g1[2]; ++z) {
+                                const float dz = origin[2] + z * cellSize - p[2];
+                                for (int64_t y = g0[1]; y <= g1[1]; ++y) {
+                                    const float dy = origin[1] + y * cellSize - p[1];
+                                    float* row = samples + ((z - first[2]) * count[1] + (y - first[1])) * count[0];
+                                    for (int64_t x = g0[0]; x <= g1[0]; ++x) {
+                                        const float dx = origin[0] + x * cellSize - p[0];
+                                        const float d2 = (dx * dx + dy * dy + dz * dz) / r2;
+                                        if (d2 < 1.0f) {
+                                            const float w = 1.0f - d2;
+                                            row[x - first[0]] += w * w * w / norm;
+                                        }
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        };
+
+        this->surfaces.push_back(std::make_unique<volumetrics::BrickedIsoSurface>());
+        auto& surf = *this->surfaces.back();
+        surf.Extract(cells, brickSize, sampler, isoValue, origin, {cellSize, cellSize, cellSize});
+        Log::DefaultLog.WriteInfo("MetaballSurface: particle list %u yields %zu vertices and %zu triangles.", l,
+            surf.Positions().size(), surf.Triangles().size());
+
+        // publish the surface
+        std::vector<mesh::MeshDataAccessCollection::VertexAttribute> attribs(2);
+        attribs[0].data = reinterpret_cast<uint8_t*>(const_cast<std::array<float, 3>*>(surf.Positions().data()));
+        attribs[0].byte_size = surf.Positions().size() * sizeof(std::array<float, 3>);
+        attribs[0].component_cnt = 3;
+        attribs[0].component_type = mesh::MeshDataAccessCollection::ValueType::FLOAT;
+        attribs[0].stride = sizeof(std::array<float, 3>);
+        attribs[0].offset = 0;
+        attribs[0].semantic = mesh::MeshDataAccessCollection::POSITION;
+        attribs[1] = attribs[0];
+        attribs[1].data = reinterpret_cast<uint8_t*>(const_cast<std::array<float, 3>*>(surf.Normals().data()));
+        attribs[1].semantic = mesh::MeshDataAccessCollection::NORMAL;
+
+        mesh::MeshDataAccessCollection::IndexData indices;
+        indices.data = reinterpret_cast<uint8_t*>(const_cast<std::array<uint32_t, 3>*>(surf.Triangles().data()));
+        indices.byte_size = surf.Triangles().size() * sizeof(std::array<uint32_t, 3>);
+        indices.type = mesh::MeshDataAccessCollection::ValueType::UNSIGNED_INT;
+        this->meshes->addMesh(std::string(this->FullName()) + "_" + std::to_string(l), std::move(attribs), indices,
+            mesh::MeshDataAccessCollection::PrimitiveType::TRIANGLES);
+
+        const vislib::math::Cuboid<float> box(origin[0], origin[1], origin[2], origin[0] + cells[0] * cellSize,
+            origin[1] + cells[1] * cellSize, origin[2] + cells[2] * cellSize);
+        if (hasTotal) {
+            total.Union(box);
+        } else {
+            total = box;
+            hasTotal = true;
+        }
+    }
+
+    if (hasTotal) {
+        this->bboxs.SetBoundingBox(total);
+        this->bboxs.SetClipBox(total);
+    }
+    ++this->version;
+}
+
+
+/*
+ * trisoup::MetaballSurface::getDataCallback
+ */
+bool trisoup::MetaballSurface::getDataCallback(core::Call& caller) {
+    auto cm = dynamic_cast<mesh::CallMesh*>(&caller);
+    if (cm == nullptr)
+        return false;
+    auto dat = this->getDataSlot.CallAs<geocalls::MultiParticleDataCall>();
+    if (dat == nullptr)
+        return false;
+
+    auto meta = cm->getMetaData();
+    dat->SetFrameID(meta.m_frame_ID, true);
+    if (!(*dat)(1) || !(*dat)(0))
+        return false;
+
+    const bool dirty = this->radiusScaleSlot.IsDirty() || this->isoValueSlot.IsDirty() ||
+                       this->cellSizeRatioSlot.IsDirty() || this->brickSizeSlot.IsDirty();
+    if (dirty || (this->meshes == nullptr) || (dat->DataHash() != this->dataHash) ||
+        (dat->FrameID() != this->frameID)) {
+        this->radiusScaleSlot.ResetDirty();
+        this->isoValueSlot.ResetDirty();
+        this->cellSizeRatioSlot.ResetDirty();
+        this->brickSizeSlot.ResetDirty();
+        this->extract(*dat);
+        this->dataHash = dat->DataHash();
+        this->frameID = dat->FrameID();
+    }
+    meta.m_frame_cnt = dat->FrameCount();
+    dat->Unlock();
+
+    meta.m_bboxs = this->bboxs;
+    cm->setMetaData(meta);
+    cm->setData(this->meshes, this->version);
+    return true;
+}
+
+
+/*
+ * trisoup::MetaballSurface::getMetaDataCallback
+ */
+bool trisoup::MetaballSurface::getMetaDataCallback(core::Call& caller) {
+    auto cm = dynamic_cast<mesh::CallMesh*>(&caller);
+    if (cm == nullptr)
+        return false;
+    auto dat = this->getDataSlot.CallAs<geocalls::MultiParticleDataCall>();
+    if (dat == nullptr)
+        return false;
+
+    auto meta = cm->getMetaData();
+    dat->SetFrameID(meta.m_frame_ID, true);
+    if (!(*dat)(1))
+        return false;
+
+    meta.m_frame_cnt = dat->FrameCount();
+    if (this->bboxs.IsBoundingBoxValid()) {
+        meta.m_bboxs = this->bboxs;
+    } else {
+        meta.m_bboxs = dat->AccessBoundingBoxes();
+    }
+    cm->setMetaData(meta);
+    return true;
+}
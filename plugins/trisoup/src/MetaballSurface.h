@@ -0,0 +1,144 @@
+/*
+ * MetaballSurface.h
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "geometry_calls/MultiParticleDataCall.h"
+#include "mesh/MeshCalls.h"
+#include "mmcore/BoundingBoxes_2.h"
+#include "mmcore/CalleeSlot.h"
+#include "mmcore/CallerSlot.h"
+#include "mmcore/Module.h"
+#include "mmcore/param/ParamSlot.h"
+#include "trisoup/volumetrics/BrickedIsoSurface.h"
+
+namespace megamol {
+namespace trisoup {
+
+/**
+ * Extracts the metaball surface of every particle list of the requested
+ * frame and provides the surfaces as meshes. The field is sampled and
+ * marched brick-wise in parallel (see volumetrics::BrickedIsoSurface).
+ * The cell size is increased where needed to keep the grid at no more than
+ * 1024 cells per axis and 2^27 cells in total.
+ */
+class MetaballSurface : public core::Module {
+public:
+    /**
+     * Answer the name of this module.
+     *
+     * @return The name of this module.
+     */
+    static const char* ClassName(void) {
+        return "MetaballSurface";
+    }
+
+    /**
+     * Answer a human readable description of this module.
+     *
+     * @return A human readable description of this module.
+     */
+    static const char* Description(void) {
+        return "Extracts the metaball surface of each particle list of the requested frame as mesh. Supersedes the "
+               "surface extraction of VoluMetricJob, which remains for its volume and surface statistics";
+    }
+
+    /**
+     * Answers whether this module is available on the current system.
+     *
+     * @return 'true' if the module is available, 'false' otherwise.
+     */
+    static bool IsAvailable(void) {
+        return true;
+    }
+
+    /** Ctor. */
+    MetaballSurface(void);
+
+    /** Dtor. */
+    virtual ~MetaballSurface(void);
+
+protected:
+    /**
+     * Implementation of 'Create'.
+     *
+     * @return 'true' on success, 'false' otherwise.
+     */
+    virtual bool create(void);
+
+    /**
+     * Implementation of 'Release'.
+     */
+    virtual void release(void);
+
+private:
+    /**
+     * Extracts the surfaces of all particle lists.
+     *
+     * @param dat The call holding the particles.
+     */
+    void extract(geocalls::MultiParticleDataCall& dat);
+
+    /**
+     * Provides the meshes of the requested frame.
+     *
+     * @param caller The calling call.
+     *
+     * @return 'true' on success, 'false' on failure.
+     */
+    bool getDataCallback(core::Call& caller);
+
+    /**
+     * Provides the frame count and the bounding box.
+     *
+     * @param caller The calling call.
+     *
+     * @return 'true' on success, 'false' on failure.
+     */
+    bool getMetaDataCallback(core::Call& caller);
+
+    /** The slot fetching the particles */
+    core::CallerSlot getDataSlot;
+
+    /** The slot providing the meshes */
+    core::CalleeSlot deployMeshSlot;
+
+    /** The influence radius of a particle relative to its radius */
+    core::param::ParamSlot radiusScaleSlot;
+
+    /** The iso value, 1 reproducing the radius of isolated particles */
+    core::param::ParamSlot isoValueSlot;
+
+    /** The cell size relative to the minimal particle radius */
+    core::param::ParamSlot cellSizeRatioSlot;
+
+    /** The edge length of the bricks processed in parallel */
+    core::param::ParamSlot brickSizeSlot;
+
+    /** The surfaces per particle list */
+    std::vector<std::unique_ptr<volumetrics::BrickedIsoSurface>> surfaces;
+
+    /** The meshes referencing the surfaces */
+    std::shared_ptr<mesh::MeshDataAccessCollection> meshes;
+
+    /** The bounding box of the surfaces */
+    core::BoundingBoxes_2 bboxs;
+
+    /** The hash and frame of the particles the surfaces were extracted from */
+    size_t dataHash;
+    unsigned int frameID;
+
+    /** The version of the meshes */
+    uint32_t version;
+};
+
+} /* end namespace trisoup */
+} /* end namespace megamol */
@@ -7,6 +7,7 @@
 #include "mmcore/utility/plugins/AbstractPluginInstance.h"
 #include "mmcore/utility/plugins/PluginRegister.h"
 
+#include "MetaballSurface.h"
 #include "OSCBFix.h"
 #include "WavefrontObjWriter.h"
 #include "trisoup/CallBinaryVolumeData.h"
@@ -31,6 +32,7 @@ public:
 
         // register modules
         this->module_descriptions.RegisterAutoDescription<megamol::trisoup::WavefrontObjWriter>();
+        this->module_descriptions.RegisterAutoDescription<megamol::trisoup::MetaballSurface>();
         this->module_descriptions.RegisterAutoDescription<megamol::quartz::OSCBFix>();
 
         // register calls
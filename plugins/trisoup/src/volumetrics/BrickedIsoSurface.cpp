@@ -0,0 +1,211 @@
+/*
+ * BrickedIsoSurface.cpp
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "trisoup/volumetrics/BrickedIsoSurface.h"
+#include "stdafx.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+#include "trisoup/volumetrics/MarchingCubeTables.h"
+
+using namespace megamol::trisoup::volumetrics;
+
+
+namespace {
+
+/** The partial surface of one brick. */
+struct Brick {
+    std::vector<std::array<float, 3>> positions;
+    std::vector<std::array<float, 3>> normals;
+    std::unordered_map<uint64_t, uint32_t> edges; // owned edge -> local vertex
+    std::vector<uint64_t> triangles;              // three edge keys per triangle
+    size_t firstVertex = 0;
+    size_t firstTriangle = 0;
+};
+
+} // namespace
+
+
+/*
+ * BrickedIsoSurface::BrickedIsoSurface
+ */
+BrickedIsoSurface::BrickedIsoSurface(void) {}
+
+
+/*
+ * BrickedIsoSurface::~BrickedIsoSurface
+ */
+BrickedIsoSurface::~BrickedIsoSurface(void) {}
+
+
+/*
+ * BrickedIsoSurface::Extract
+ */
+void BrickedIsoSurface::Extract(const std::array<size_t, 3>& cells, size_t brickSize, const Sampler& sampler,
+    float isoValue, const std::array<float, 3>& origin, const std::array<float, 3>& spacing) {
+    this->positions.clear();
+    this->normals.clear();
+    this->triangles.clear();
+    if ((cells[0] == 0) || (cells[1] == 0) || (cells[2] == 0) || (brickSize == 0)) {
+        return;
+    }
+
+    std::array<size_t, 3> bricks;
+    for (int i = 0; i < 3; ++i) {
+        bricks[i] = (cells[i] + brickSize - 1) / brickSize;
+    }
+    const uint64_t pointsX = cells[0] + 1, pointsY = cells[1] + 1;
+
+    // an edge is identified by its lower grid point and its axis
+    const auto edgeKey = [pointsX, pointsY](const std::array<size_t, 3>& p, unsigned int axis) -> uint64_t {
+        return ((p[2] * pointsY + p[1]) * pointsX + p[0]) * 3 + axis;
+    };
+    // the owner is the brick containing the lower point, the last brick owns the upper border
+    const auto owner = [&](uint64_t key) -> size_t {
+        uint64_t p = key / 3;
+        std::array<size_t, 3> b;
+        b[0] = std::min<size_t>((p % pointsX) / brickSize, bricks[0] - 1);
+        p /= pointsX;
+        b[1] = std::min<size_t>((p % pointsY) / brickSize, bricks[1] - 1);
+        b[2] = std::min<size_t>((p / pointsY) / brickSize, bricks[2] - 1);
+        return (b[2] * bricks[1] + b[1]) * bricks[0] + b[0];
+    };
+
+    std::vector<Brick> partial(bricks[0] * bricks[1] * bricks[2]);
+
+    // sample and march all bricks independently
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t bi = 0; bi < static_cast<int64_t>(partial.size()); ++bi) {
+        Brick& brick = partial[bi];
+        const std::array<size_t, 3> b = {bi % bricks[0], (bi / bricks[0]) % bricks[1], bi / (bricks[0] * bricks[1])};
+        std::array<size_t, 3> lo, hi, own;
+        std::array<int64_t, 3> first;
+        std::array<size_t, 3> count;
+        for (int i = 0; i < 3; ++i) {
+            lo[i] = b[i] * brickSize;
+            hi[i] = std::min(lo[i] + brickSize, cells[i]);
+            own[i] = (b[i] + 1 == bricks[i]) ? hi[i] : hi[i] - 1;
+            first[i] = static_cast<int64_t>(lo[i]) - 1; // one point of apron for the gradients
+            count[i] = hi[i] - lo[i] + 3;
+        }
+
+        std::vector<float> samples(count[0] * count[1] * count[2]);
+        sampler(first, count, samples.data());
+        const auto value = [&](size_t x, size_t y, size_t z) -> float {
+            return samples[((z - lo[2] + 1) * count[1] + (y - lo[1] + 1)) * count[0] + (x - lo[0] + 1)];
+        };
+        const auto gradient = [&](const std::array<size_t, 3>& p) -> std::array<float, 3> {
+            return {(value(p[0] + 1, p[1], p[2]) - value(p[0] - 1, p[1], p[2])) / (2.0f * spacing[0]),
+                (value(p[0], p[1] + 1, p[2]) - value(p[0], p[1] - 1, p[2])) / (2.0f * spacing[1]),
+                (value(p[0], p[1], p[2] + 1) - value(p[0], p[1], p[2] - 1)) / (2.0f * spacing[2])};
+        };
+
+        // vertices on the owned edges crossing the surface
+        std::array<size_t, 3> p;
+        for (p[2] = lo[2]; p[2] <= own[2]; ++p[2]) {
+            for (p[1] = lo[1]; p[1] <= own[1]; ++p[1]) {
+                for (p[0] = lo[0]; p[0] <= own[0]; ++p[0]) {
+                    const float v0 = value(p[0], p[1], p[2]);
+                    for (unsigned int axis = 0; axis < 3; ++axis) {
+                        if (p[axis] >= cells[axis]) {
+                            continue;
+                        }
+                        std::array<size_t, 3> q = p;
+                        ++q[axis];
+                        const float v1 = value(q[0], q[1], q[2]);
+                        if ((v0 >= isoValue) == (v1 >= isoValue)) {
+                            continue;
+                        }
+                        const float t = (isoValue - v0) / (v1 - v0);
+                        const auto g0 = gradient(p);
+                        const auto g1 = gradient(q);
+                        std::array<float, 3> pos, nrm;
+                        for (int i = 0; i < 3; ++i) {
+                            pos[i] = origin[i] + spacing[i] * (static_cast<float>(p[i]) + ((i == axis) ? t : 0.0f));
+                            nrm[i] = -(g0[i] + t * (g1[i] - g0[i]));
+                        }
+                        const float len = std::sqrt(nrm[0] * nrm[0] + nrm[1] * nrm[1] + nrm[2] * nrm[2]);
+                        if (len > 0.0f) {
+                            for (int i = 0; i < 3; ++i) {
+                                nrm[i] /= len;
+                            }
+                        }
+                        brick.edges.emplace(edgeKey(p, axis), static_cast<uint32_t>(brick.positions.size()));
+                        brick.positions.push_back(pos);
+                        brick.normals.push_back(nrm);
+                    }
+                }
+            }
+        }
+
+        // triangles of the cells, referencing their edges by key
+        for (p[2] = lo[2]; p[2] < hi[2]; ++p[2]) {
+            for (p[1] = lo[1]; p[1] < hi[1]; ++p[1]) {
+                for (p[0] = lo[0]; p[0] < hi[0]; ++p[0]) {
+                    unsigned int cube = 0;
+                    for (unsigned int c = 0; c < 8; ++c) {
+                        const auto* o = MarchingCubeTables::a2fVertexOffset[c];
+                        if (value(p[0] + o[0], p[1] + o[1], p[2] + o[2]) < isoValue) {
+                            cube |= 1u << c;
+                        }
+                    }
+                    if (MarchingCubeTables::aiCubeEdgeFlags[cube] == 0) {
+                        continue;
+                    }
+                    const int* tris = MarchingCubeTables::a2iTriangleConnectionTable[cube];
+                    for (int t = 0; (t < 16) && (tris[t] >= 0); ++t) {
+                        const auto* edge = MarchingCubeTables::a2iEdgeConnection[tris[t]];
+                        const auto* c0 = MarchingCubeTables::a2fVertexOffset[edge[0]];
+                        const auto* c1 = MarchingCubeTables::a2fVertexOffset[edge[1]];
+                        std::array<size_t, 3> lower;
+                        unsigned int axis = 0;
+                        for (unsigned int i = 0; i < 3; ++i) {
+                            lower[i] = p[i] + std::min(c0[i], c1[i]);
+                            if (c0[i] != c1[i]) {
+                                axis = i;
+                            }
+                        }
+                        brick.triangles.push_back(edgeKey(lower, axis));
+                    }
+                }
+            }
+        }
+    }
+
+    // place the bricks in the output
+    size_t vertexCnt = 0, triangleCnt = 0;
+    for (auto& brick : partial) {
+        brick.firstVertex = vertexCnt;
+        brick.firstTriangle = triangleCnt;
+        vertexCnt += brick.positions.size();
+        triangleCnt += brick.triangles.size() / 3;
+    }
+    this->positions.resize(vertexCnt);
+    this->normals.resize(vertexCnt);
+    this->triangles.resize(triangleCnt);
+
+    // resolve the edge keys to global indices, stitching the bricks
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t bi = 0; bi < static_cast<int64_t>(partial.size()); ++bi) {
+        const Brick& brick = partial[bi];
+        std::copy(brick.positions.begin(), brick.positions.end(), this->positions.begin() + brick.firstVertex);
+        std::copy(brick.normals.begin(), brick.normals.end(), this->normals.begin() + brick.firstVertex);
+        for (size_t t = 0; t < brick.triangles.size() / 3; ++t) {
+            auto& tri = this->triangles[brick.firstTriangle + t];
+            for (int i = 0; i < 3; ++i) {
+                const uint64_t key = brick.triangles[3 * t + i];
+                const Brick& o = partial[owner(key)];
+                const auto it = o.edges.find(key);
+                // the sampler is deterministic, so the owner always has the vertex
+                tri[i] = (it != o.edges.end()) ? static_cast<uint32_t>(o.firstVertex + it->second) : 0;
+            }
+        }
+    }
+}
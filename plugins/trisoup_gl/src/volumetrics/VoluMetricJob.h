@@ -49,7 +49,8 @@ public:
      */
     static const char* Description(void) {
         return "Computes volumetric metrics of a multiparticle dataset, i.e. surface and volume"
-               ", assuming a spacefilling spheres geometry";
+               ", assuming a spacefilling spheres geometry. For the surface meshes alone, use the "
+               "faster MetaballSurface";
     }
 
     /**
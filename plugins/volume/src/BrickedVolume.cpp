@@ -0,0 +1,205 @@
+/*
+ * BrickedVolume.cpp
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "BrickedVolume.h"
+#include "stdafx.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "mmcore/utility/log/Log.h"
+
+
+/*
+ * megamol::volume::BrickedVolumeHeader::MAGIC
+ */
+const char megamol::volume::BrickedVolumeHeader::MAGIC[4] = {'M', 'M', 'B', 'V'};
+
+
+/*
+ * megamol::volume::BrickedVolumeHeader::VERSION
+ */
+const uint32_t megamol::volume::BrickedVolumeHeader::VERSION = 1;
+
+
+/*
+ * megamol::volume::BrickedVolumeLayout::BrickedVolumeLayout
+ */
+megamol::volume::BrickedVolumeLayout::BrickedVolumeLayout(const uint32_t resolution[3], uint32_t brickSize)
+        : bricksPerFrame(0) {
+    std::array<size_t, 3> res = {std::max<size_t>(resolution[0], 1), std::max<size_t>(resolution[1], 1),
+        std::max<size_t>(resolution[2], 1)};
+    while (true) {
+        std::array<size_t, 3> b;
+        for (int i = 0; i < 3; ++i) {
+            b[i] = (res[i] + brickSize - 1) / brickSize;
+        }
+        this->resolution.push_back(res);
+        this->bricks.push_back(b);
+        this->firstBrick.push_back(this->bricksPerFrame);
+        this->bricksPerFrame += b[0] * b[1] * b[2];
+        if ((b[0] == 1) && (b[1] == 1) && (b[2] == 1)) {
+            break;
+        }
+        for (int i = 0; i < 3; ++i) {
+            res[i] = (res[i] + 1) / 2;
+        }
+    }
+}
+
+
+/*
+ * megamol::volume::BrickedVolumeFile::BrickedVolumeFile
+ */
+megamol::volume::BrickedVolumeFile::BrickedVolumeFile(void) {
+    ::memset(&this->header, 0, sizeof(this->header));
+}
+
+
+/*
+ * megamol::volume::BrickedVolumeFile::Close
+ */
+void megamol::volume::BrickedVolumeFile::Close(void) {
+    if (this->file.is_open()) {
+        this->file.close();
+    }
+    this->layout.reset();
+    this->minValues.clear();
+    this->maxValues.clear();
+    this->offsets.clear();
+}
+
+
+/*
+ * megamol::volume::BrickedVolumeFile::Open
+ */
+bool megamol::volume::BrickedVolumeFile::Open(const std::filesystem::path& path) {
+    using megamol::core::utility::log::Log;
+    this->Close();
+
+    this->file.open(path, std::ios::binary);
+    if (!this->file.is_open()) {
+        Log::DefaultLog.WriteError("Cannot open bricked volume \"%s\".", path.generic_u8string().c_str());
+        return false;
+    }
+    if (!this->file.read(reinterpret_cast<char*>(&this->header), sizeof(this->header)) ||
+        (::memcmp(this->header.Magic, BrickedVolumeHeader::MAGIC, sizeof(BrickedVolumeHeader::MAGIC)) != 0) ||
+        (this->header.Version != BrickedVolumeHeader::VERSION) || (this->header.BrickSize == 0) ||
+        (this->header.Components == 0) || (this->header.Frames == 0)) {
+        Log::DefaultLog.WriteError("\"%s\" is not a bricked volume of version %u.", path.generic_u8string().c_str(),
+            BrickedVolumeHeader::VERSION);
+        this->Close();
+        return false;
+    }
+
+    this->layout = std::make_unique<BrickedVolumeLayout>(this->header.Resolution, this->header.BrickSize);
+    if (this->layout->Levels() != this->header.Levels) {
+        Log::DefaultLog.WriteError("The levels of bricked volume \"%s\" do not match its resolution.",
+            path.generic_u8string().c_str());
+        this->Close();
+        return false;
+    }
+
+    this->minValues.resize(this->header.Components);
+    this->maxValues.resize(this->header.Components);
+    this->offsets.resize(this->layout->BricksPerFrame() * this->header.Frames);
+    const auto bytes = [](const auto& v) {
+        return static_cast<std::streamsize>(v.size() * sizeof(typename std::decay_t<decltype(v)>::value_type));
+    };
+    if (!this->file.read(reinterpret_cast<char*>(this->minValues.data()), bytes(this->minValues)) ||
+        !this->file.read(reinterpret_cast<char*>(this->maxValues.data()), bytes(this->maxValues)) ||
+        !this->file.read(reinterpret_cast<char*>(this->offsets.data()), bytes(this->offsets))) {
+        Log::DefaultLog.WriteError("The brick table of \"%s\" is truncated.", path.generic_u8string().c_str());
+        this->Close();
+        return false;
+    }
+
+    return true;
+}
+
+
+/*
+ * megamol::volume::BrickedVolumeFile::ReadBrick
+ */
+bool megamol::volume::BrickedVolumeFile::ReadBrick(size_t brick, void* dst) {
+    if (!this->file.is_open() || (brick >= this->offsets.size())) {
+        return false;
+    }
+    this->file.clear();
+    this->file.seekg(static_cast<std::streamoff>(this->offsets[brick]));
+    return static_cast<bool>(
+        this->file.read(static_cast<char*>(dst), static_cast<std::streamsize>(this->BrickBytes())));
+}
+
+
+/*
+ * megamol::volume::BrickCache::BrickCache
+ */
+megamol::volume::BrickCache::BrickCache(size_t capacity) : capacity(capacity), size(0) {}
+
+
+/*
+ * megamol::volume::BrickCache::Clear
+ */
+void megamol::volume::BrickCache::Clear(void) {
+    this->index.clear();
+    this->lru.clear();
+    this->size = 0;
+}
+
+
+/*
+ * megamol::volume::BrickCache::Get
+ */
+const char* megamol::volume::BrickCache::Get(uint64_t key) {
+    auto it = this->index.find(key);
+    if (it == this->index.end()) {
+        return nullptr;
+    }
+    this->lru.splice(this->lru.begin(), this->lru, it->second);
+    return it->second->second.data();
+}
+
+
+/*
+ * megamol::volume::BrickCache::Insert
+ */
+char* megamol::volume::BrickCache::Insert(uint64_t key, size_t size) {
+    auto it = this->index.find(key);
+    if (it != this->index.end()) {
+        this->size -= it->second->second.size();
+        this->lru.erase(it->second);
+        this->index.erase(it);
+    }
+    this->evict(size);
+    this->lru.emplace_front(key, std::vector<char>(size));
+    this->index[key] = this->lru.begin();
+    this->size += size;
+    return this->lru.front().second.data();
+}
+
+
+/*
+ * megamol::volume::BrickCache::SetCapacity
+ */
+void megamol::volume::BrickCache::SetCapacity(size_t capacity) {
+    this->capacity = capacity;
+    this->evict(0);
+}
+
+
+/*
+ * megamol::volume::BrickCache::evict
+ */
+void megamol::volume::BrickCache::evict(size_t required) {
+    while (!this->lru.empty() && (this->size + required > this->capacity)) {
+        this->size -= this->lru.back().second.size();
+        this->index.erase(this->lru.back().first);
+        this->lru.pop_back();
+    }
+}
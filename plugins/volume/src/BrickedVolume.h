@@ -0,0 +1,242 @@
+/*
+ * BrickedVolume.h
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+
+namespace megamol {
+namespace volume {
+
+/**
+ * The header of a bricked volume file.
+ *
+ * The file stores every frame as a pyramid of levels, level 0 being the
+ * full resolution and every further level halving the resolution by
+ * averaging 2^3 voxels, until one brick covers the whole level. Each level
+ * is split into bricks of BrickSize^3 voxels, which are padded with zeros at
+ * the border of the level. The header is followed by the minimum and the
+ * maximum per component (double each) and the file offsets of all bricks
+ * (uint64_t each) in the order frame, level, z, y, x.
+ */
+struct BrickedVolumeHeader {
+    char Magic[4];
+    uint32_t Version;
+    uint32_t Resolution[3];
+    uint32_t Components;
+    uint32_t ScalarType;
+    uint32_t ScalarLength;
+    uint32_t Frames;
+    uint32_t BrickSize;
+    uint32_t Levels;
+    float Origin[3];
+    float SliceDists[3];
+
+    /** The expected magic number. */
+    static const char MAGIC[4];
+
+    /** The current version of the format. */
+    static const uint32_t VERSION;
+};
+
+
+/**
+ * The layout of the levels and bricks of a bricked volume.
+ */
+class BrickedVolumeLayout {
+public:
+    /**
+     * Computes the layout.
+     *
+     * @param resolution The resolution of level 0.
+     * @param brickSize  The edge length of the bricks, a power of two.
+     */
+    BrickedVolumeLayout(const uint32_t resolution[3], uint32_t brickSize);
+
+    /** Answer the number of bricks per axis of a level. */
+    inline const std::array<size_t, 3>& Bricks(size_t level) const {
+        return this->bricks[level];
+    }
+
+    /** Answer the number of bricks of one frame. */
+    inline size_t BricksPerFrame(void) const {
+        return this->bricksPerFrame;
+    }
+
+    /**
+     * Answer the index of a brick within its frame.
+     *
+     * @param level The level.
+     * @param x     The x-index of the brick on its level.
+     * @param y     The y-index of the brick on its level.
+     * @param z     The z-index of the brick on its level.
+     */
+    inline size_t BrickIndex(size_t level, size_t x, size_t y, size_t z) const {
+        const auto& b = this->bricks[level];
+        return this->firstBrick[level] + (z * b[1] + y) * b[0] + x;
+    }
+
+    /** Answer the number of levels. */
+    inline size_t Levels(void) const {
+        return this->resolution.size();
+    }
+
+    /** Answer the resolution of a level. */
+    inline const std::array<size_t, 3>& Resolution(size_t level) const {
+        return this->resolution[level];
+    }
+
+private:
+    std::vector<std::array<size_t, 3>> resolution;
+    std::vector<std::array<size_t, 3>> bricks;
+    std::vector<size_t> firstBrick;
+    size_t bricksPerFrame;
+};
+
+
+/**
+ * Read access to a bricked volume file.
+ */
+class BrickedVolumeFile {
+public:
+    /** Ctor. */
+    BrickedVolumeFile(void);
+
+    /** Answer the number of bytes of a brick. */
+    inline size_t BrickBytes(void) const {
+        return static_cast<size_t>(this->header.BrickSize) * this->header.BrickSize * this->header.BrickSize *
+               this->header.Components * this->header.ScalarLength;
+    }
+
+    /** Closes the file. */
+    void Close(void);
+
+    /** Answer the header of the open file. */
+    inline const BrickedVolumeHeader& Header(void) const {
+        return this->header;
+    }
+
+    /** Answer whether a file is open. */
+    inline bool IsOpen(void) const {
+        return this->file.is_open();
+    }
+
+    /** Answer the layout of the open file. */
+    inline const BrickedVolumeLayout& Layout(void) const {
+        return *this->layout;
+    }
+
+    /** Answer the maximum per component. */
+    inline const std::vector<double>& MaxValues(void) const {
+        return this->maxValues;
+    }
+
+    /** Answer the minimum per component. */
+    inline const std::vector<double>& MinValues(void) const {
+        return this->minValues;
+    }
+
+    /**
+     * Opens a file and reads its header and brick table.
+     *
+     * @param path The path of the file.
+     *
+     * @return 'true' on success.
+     */
+    bool Open(const std::filesystem::path& path);
+
+    /**
+     * Reads one brick.
+     *
+     * @param brick The index of the brick in the whole file, i.e. including
+     *              the preceding frames.
+     * @param dst   Receives BrickBytes() bytes.
+     *
+     * @return 'true' on success.
+     */
+    bool ReadBrick(size_t brick, void* dst);
+
+private:
+    std::ifstream file;
+    BrickedVolumeHeader header;
+    std::unique_ptr<BrickedVolumeLayout> layout;
+    std::vector<double> minValues;
+    std::vector<double> maxValues;
+    std::vector<uint64_t> offsets;
+};
+
+
+/**
+ * Least-recently-used cache of bricks with a limited capacity in bytes.
+ */
+class BrickCache {
+public:
+    /**
+     * Ctor.
+     *
+     * @param capacity The capacity in bytes.
+     */
+    explicit BrickCache(size_t capacity = 0);
+
+    /** Removes all bricks. */
+    void Clear(void);
+
+    /**
+     * Answer a cached brick and marks it as most recently used.
+     *
+     * @param key The key of the brick.
+     *
+     * @return The data of the brick or 'nullptr' if not cached.
+     */
+    const char* Get(uint64_t key);
+
+    /**
+     * Adds a brick, evicting the least recently used ones if necessary.
+     * A single brick is kept even if it exceeds the capacity.
+     *
+     * @param key  The key of the brick.
+     * @param size The size of the brick in bytes.
+     *
+     * @return The memory to fill with the brick data.
+     */
+    char* Insert(uint64_t key, size_t size);
+
+    /**
+     * Changes the capacity, evicting bricks if necessary.
+     *
+     * @param capacity The capacity in bytes.
+     */
+    void SetCapacity(size_t capacity);
+
+    /** Answer the number of bytes currently cached. */
+    inline size_t Size(void) const {
+        return this->size;
+    }
+
+private:
+    typedef std::list<std::pair<uint64_t, std::vector<char>>> LruList;
+
+    /** Evicts bricks until 'required' more bytes fit. */
+    void evict(size_t required);
+
+    size_t capacity;
+    size_t size;
+    LruList lru;
+    std::unordered_map<uint64_t, LruList::iterator> index;
+};
+
+} /* end namespace volume */
+} /* end namespace megamol */
@@ -0,0 +1,334 @@
+/*
+ * BrickedVolumeDataSource.cpp
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "BrickedVolumeDataSource.h"
+#include "stdafx.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "mmcore/param/FilePathParam.h"
+#include "mmcore/param/IntParam.h"
+#include "mmcore/utility/log/Log.h"
+
+
+/*
+ * megamol::volume::BrickedVolumeDataSource::BrickedVolumeDataSource
+ */
+megamol::volume::BrickedVolumeDataSource::BrickedVolumeDataSource(void)
+        : core::Module()
+        , loaded()
+        , isLoaded(false)
+        , dataHash(0)
+        , paramFileName("FileName", "The path to the bricked volume file to load.")
+        , paramCacheSize("CacheSize", "The maximum size of the brick cache in megabytes.")
+        , paramOutputBudget("OutputBudget", "The maximum size of the delivered data in megabytes; coarser levels "
+                                            "are delivered if a request exceeds it. Zero disables the budget.")
+        , paramLevel("LevelOfDetail", "Forces a level of detail, 0 being the full resolution. -1 delivers the "
+                                      "level requested by the caller.")
+        , slotGetData("GetData", "Slot for requesting data from the source.") {
+    using geocalls::VolumetricDataCall;
+    ::memset(this->sliceDists, 0, sizeof(this->sliceDists));
+    ::memset(this->querySliceDists, 0, sizeof(this->querySliceDists));
+
+    this->paramFileName.SetParameter(new core::param::FilePathParam(""));
+    this->MakeSlotAvailable(&this->paramFileName);
+
+    this->paramCacheSize.SetParameter(new core::param::IntParam(1024, 1));
+    this->MakeSlotAvailable(&this->paramCacheSize);
+
+    this->paramOutputBudget.SetParameter(new core::param::IntParam(512, 0));
+    this->MakeSlotAvailable(&this->paramOutputBudget);
+
+    this->paramLevel.SetParameter(new core::param::IntParam(-1, -1));
+    this->MakeSlotAvailable(&this->paramLevel);
+
+    this->slotGetData.SetCallback(VolumetricDataCall::ClassName(),
+        VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_GET_DATA), &BrickedVolumeDataSource::onGetData);
+    this->slotGetData.SetCallback(VolumetricDataCall::ClassName(),
+        VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_GET_EXTENTS), &BrickedVolumeDataSource::onGetExtents);
+    this->slotGetData.SetCallback(VolumetricDataCall::ClassName(),
+        VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_GET_METADATA),
+        &BrickedVolumeDataSource::onGetMetadata);
+    this->slotGetData.SetCallback(VolumetricDataCall::ClassName(),
+        VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_START_ASYNC), &BrickedVolumeDataSource::onIgnore);
+    this->slotGetData.SetCallback(VolumetricDataCall::ClassName(),
+        VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_STOP_ASYNC), &BrickedVolumeDataSource::onIgnore);
+    this->slotGetData.SetCallback(VolumetricDataCall::ClassName(),
+        VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_TRY_GET_DATA), &BrickedVolumeDataSource::onGetData);
+    this->MakeSlotAvailable(&this->slotGetData);
+}
+
+
+/*
+ * megamol::volume::BrickedVolumeDataSource::~BrickedVolumeDataSource
+ */
+megamol::volume::BrickedVolumeDataSource::~BrickedVolumeDataSource(void) {
+    this->Release();
+}
+
+
+/*
+ * megamol::volume::BrickedVolumeDataSource::create
+ */
+bool megamol::volume::BrickedVolumeDataSource::create(void) {
+    return true;
+}
+
+
+/*
+ * megamol::volume::BrickedVolumeDataSource::release
+ */
+void megamol::volume::BrickedVolumeDataSource::release(void) {
+    this->file.Close();
+    this->cache.Clear();
+    this->output.clear();
+    this->output.shrink_to_fit();
+    this->isLoaded = false;
+}
+
+
+/*
+ * megamol::volume::BrickedVolumeDataSource::assemble
+ */
+bool megamol::volume::BrickedVolumeDataSource::assemble(const Request& request) {
+    using megamol::core::utility::log::Log;
+    const auto& header = this->file.Header();
+    const auto& layout = this->file.Layout();
+    const size_t bs = header.BrickSize;
+    const size_t voxelSize = static_cast<size_t>(header.Components) * header.ScalarLength;
+    const size_t brickBytes = this->file.BrickBytes();
+    const size_t frameFirst = static_cast<size_t>(request.Frame) * layout.BricksPerFrame();
+
+    std::array<size_t, 3> size;
+    for (int i = 0; i < 3; ++i) {
+        size[i] = request.Upper[i] - request.Lower[i];
+    }
+    this->output.resize(size[0] * size[1] * size[2] * voxelSize);
+    this->cache.SetCapacity(static_cast<size_t>(this->paramCacheSize.Param<core::param::IntParam>()->Value()) << 20);
+
+    for (size_t bz = request.Lower[2] / bs; bz * bs < request.Upper[2]; ++bz) {
+        for (size_t by = request.Lower[1] / bs; by * bs < request.Upper[1]; ++by) {
+            for (size_t bx = request.Lower[0] / bs; bx * bs < request.Upper[0]; ++bx) {
+                const uint64_t key = frameFirst + layout.BrickIndex(request.Level, bx, by, bz);
+                const char* brick = this->cache.Get(key);
+                if (brick == nullptr) {
+                    char* dst = this->cache.Insert(key, brickBytes);
+                    if (!this->file.ReadBrick(key, dst)) {
+                        Log::DefaultLog.WriteError("Reading brick %llu of the bricked volume failed.",
+                            static_cast<unsigned long long>(key));
+                        this->cache.Clear();
+                        return false;
+                    }
+                    brick = dst;
+                }
+
+                // copy the rows of the brick inside the region
+                const size_t x0 = std::max(bx * bs, request.Lower[0]), x1 = std::min((bx + 1) * bs, request.Upper[0]);
+                const size_t y0 = std::max(by * bs, request.Lower[1]), y1 = std::min((by + 1) * bs, request.Upper[1]);
+                const size_t z0 = std::max(bz * bs, request.Lower[2]), z1 = std::min((bz + 1) * bs, request.Upper[2]);
+                for (size_t z = z0; z < z1; ++z) {
+                    for (size_t y = y0; y < y1; ++y) {
+                        const size_t srcIdx = ((z - bz * bs) * bs + (y - by * bs)) * bs + (x0 - bx * bs);
+                        const size_t dstIdx = ((z - request.Lower[2]) * size[1] + (y - request.Lower[1])) * size[0] +
+                                              (x0 - request.Lower[0]);
+                        const char* src = brick + srcIdx * voxelSize;
+                        char* dst = this->output.data() + dstIdx * voxelSize;
+                        ::memcpy(dst, src, (x1 - x0) * voxelSize);
+                    }
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+
+/*
+ * megamol::volume::BrickedVolumeDataSource::assertFile
+ */
+bool megamol::volume::BrickedVolumeDataSource::assertFile(void) {
+    if (this->paramFileName.IsDirty()) {
+        this->paramFileName.ResetDirty();
+        this->cache.Clear();
+        this->isLoaded = false;
+        ++this->dataHash;
+
+        const auto path = this->paramFileName.Param<core::param::FilePathParam>()->Value();
+        if (this->file.Open(path)) {
+            const auto& header = this->file.Header();
+            this->minValues = this->file.MinValues();
+            this->maxValues = this->file.MaxValues();
+
+            this->metadata = geocalls::VolumetricDataCall::Metadata();
+            this->metadata.GridType = geocalls::CARTESIAN;
+            this->metadata.ScalarType = static_cast<geocalls::ScalarType_t>(header.ScalarType);
+            this->metadata.ScalarLength = header.ScalarLength;
+            this->metadata.Components = header.Components;
+            this->metadata.NumberOfFrames = header.Frames;
+            this->metadata.MinValues = this->minValues.data();
+            this->metadata.MaxValues = this->maxValues.data();
+            for (int i = 0; i < 3; ++i) {
+                this->metadata.SliceDists[i] = &this->sliceDists[i];
+                this->metadata.IsUniform[i] = true;
+            }
+            megamol::core::utility::log::Log::DefaultLog.WriteInfo(
+                "Opened bricked volume \"%s\" of %u x %u x %u voxels with %u levels.",
+                path.generic_u8string().c_str(), header.Resolution[0], header.Resolution[1], header.Resolution[2],
+                header.Levels);
+        }
+    }
+    return this->file.IsOpen();
+}
+
+
+/*
+ * megamol::volume::BrickedVolumeDataSource::describe
+ */
+void megamol::volume::BrickedVolumeDataSource::describe(
+    const Request& request, geocalls::VolumetricDataCall::Metadata& outMetadata, float* outSliceDists) const {
+    const auto& header = this->file.Header();
+    const auto& res = this->file.Layout().Resolution(request.Level);
+
+    // the coarser levels span the same extents as level 0
+    for (int i = 0; i < 3; ++i) {
+        const float extent = header.SliceDists[i] * static_cast<float>(header.Resolution[i] - 1);
+        const size_t cnt = request.Upper[i] - request.Lower[i];
+        outSliceDists[i] = (res[i] > 1) ? extent / static_cast<float>(res[i] - 1) : header.SliceDists[i];
+        outMetadata.SliceDists[i] = &outSliceDists[i];
+        outMetadata.Resolution[i] = cnt;
+        outMetadata.Origin[i] = header.Origin[i] + static_cast<float>(request.Lower[i]) * outSliceDists[i];
+        outMetadata.Extents[i] = static_cast<float>(cnt - 1) * outSliceDists[i];
+    }
+}
+
+
+/*
+ * megamol::volume::BrickedVolumeDataSource::onGetData
+ */
+bool megamol::volume::BrickedVolumeDataSource::onGetData(core::Call& call) {
+    using geocalls::VolumetricDataCall;
+    auto c = dynamic_cast<VolumetricDataCall*>(&call);
+    if ((c == nullptr) || !this->assertFile()) {
+        return false;
+    }
+
+    const Request request = this->resolve(*c);
+    if (!this->isLoaded || !(request == this->loaded)) {
+        this->isLoaded = this->assemble(request);
+        if (!this->isLoaded) {
+            return false;
+        }
+        this->loaded = request;
+        this->describe(request, this->metadata, this->sliceDists);
+        ++this->dataHash;
+    }
+
+    c->SetMetadata(&this->metadata);
+    c->SetData(this->output.data());
+    c->SetDataHash(this->dataHash);
+    return true;
+}
+
+
+/*
+ * megamol::volume::BrickedVolumeDataSource::onGetExtents
+ */
+bool megamol::volume::BrickedVolumeDataSource::onGetExtents(core::Call& call) {
+    using geocalls::VolumetricDataCall;
+    auto c = dynamic_cast<VolumetricDataCall*>(&call);
+    if ((c == nullptr) || !this->assertFile()) {
+        return false;
+    }
+
+    const auto& header = this->file.Header();
+    float extents[3];
+    for (int i = 0; i < 3; ++i) {
+        extents[i] = header.SliceDists[i] * static_cast<float>(header.Resolution[i] - 1);
+    }
+    c->SetExtent(header.Frames, header.Origin[0], header.Origin[1], header.Origin[2], header.Origin[0] + extents[0],
+        header.Origin[1] + extents[1], header.Origin[2] + extents[2]);
+    c->SetDataHash(this->dataHash);
+    return true;
+}
+
+
+/*
+ * megamol::volume::BrickedVolumeDataSource::onGetMetadata
+ */
+bool megamol::volume::BrickedVolumeDataSource::onGetMetadata(core::Call& call) {
+    using geocalls::VolumetricDataCall;
+    auto c = dynamic_cast<VolumetricDataCall*>(&call);
+    if ((c == nullptr) || !this->assertFile()) {
+        return false;
+    }
+
+    // describes the requested data without touching the metadata of the loaded data
+    this->queryMetadata = this->metadata;
+    this->describe(this->resolve(*c), this->queryMetadata, this->querySliceDists);
+    c->SetMetadata(&this->queryMetadata);
+    return true;
+}
+
+
+/*
+ * megamol::volume::BrickedVolumeDataSource::onIgnore
+ */
+bool megamol::volume::BrickedVolumeDataSource::onIgnore(core::Call& call) {
+    return true;
+}
+
+
+/*
+ * megamol::volume::BrickedVolumeDataSource::resolve
+ */
+megamol::volume::BrickedVolumeDataSource::Request megamol::volume::BrickedVolumeDataSource::resolve(
+    const geocalls::VolumetricDataCall& call) const {
+    const auto& header = this->file.Header();
+    const auto& layout = this->file.Layout();
+    const size_t voxelSize = static_cast<size_t>(header.Components) * header.ScalarLength;
+    const size_t budget =
+        static_cast<size_t>(this->paramOutputBudget.Param<core::param::IntParam>()->Value()) << 20;
+    const int forced = this->paramLevel.Param<core::param::IntParam>()->Value();
+
+    Request retval;
+    retval.Frame = std::min(call.FrameID(), header.Frames - 1);
+    retval.Level = std::min<size_t>((forced >= 0) ? forced : call.GetLevelOfDetail(), layout.Levels() - 1);
+
+    // the region of interest on level 0, the whole volume if empty
+    size_t lower[3], upper[3];
+    bool isRegion = call.GetRegionOfInterest(lower, upper);
+    for (int i = 0; i < 3; ++i) {
+        upper[i] = std::min<size_t>(upper[i], header.Resolution[i]);
+        isRegion = isRegion && (lower[i] < upper[i]);
+    }
+    if (!isRegion) {
+        for (int i = 0; i < 3; ++i) {
+            lower[i] = 0;
+            upper[i] = header.Resolution[i];
+        }
+    }
+
+    // coarsen until the region fits the budget
+    while (true) {
+        const auto& res = layout.Resolution(retval.Level);
+        size_t bytes = voxelSize;
+        for (int i = 0; i < 3; ++i) {
+            retval.Lower[i] = std::min(lower[i] >> retval.Level, res[i] - 1);
+            retval.Upper[i] = std::min(((upper[i] - 1) >> retval.Level) + 1, res[i]);
+            bytes *= retval.Upper[i] - retval.Lower[i];
+        }
+        if ((budget == 0) || (bytes <= budget) || (retval.Level + 1 >= layout.Levels())) {
+            break;
+        }
+        ++retval.Level;
+    }
+
+    return retval;
+}
@@ -0,0 +1,219 @@
+/*
+ * BrickedVolumeDataSource.h
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "BrickedVolume.h"
+#include "geometry_calls/VolumetricDataCall.h"
+#include "mmcore/CalleeSlot.h"
+#include "mmcore/Module.h"
+#include "mmcore/param/ParamSlot.h"
+
+
+namespace megamol {
+namespace volume {
+
+/**
+ * Out-of-core data source for bricked volumes written by
+ * BrickedVolumeWriter. Only the bricks covering the requested region of
+ * interest on the requested level of detail are read; recently used bricks
+ * are kept in a cache of limited size. If the requested region exceeds the
+ * output budget, a coarser level is delivered.
+ */
+class BrickedVolumeDataSource : public core::Module {
+public:
+    /**
+     * Answer the name of this module.
+     *
+     * @return The name of this module.
+     */
+    static inline const char* ClassName(void) {
+        return "BrickedVolumeDataSource";
+    }
+
+    /**
+     * Answer a human readable description of this module.
+     *
+     * @return A human readable description of this module.
+     */
+    static inline const char* Description(void) {
+        return "Out-of-core data source for bricked volumes with a level-of-detail pyramid";
+    }
+
+    /**
+     * Answers whether this module is available on the current system.
+     *
+     * @return 'true' if the module is available, 'false' otherwise.
+     */
+    static inline bool IsAvailable(void) {
+        return true;
+    }
+
+    /** Ctor. */
+    BrickedVolumeDataSource(void);
+
+    /** Dtor. */
+    virtual ~BrickedVolumeDataSource(void);
+
+protected:
+    /**
+     * Implementation of 'Create'.
+     *
+     * @return 'true' on success, 'false' otherwise.
+     */
+    virtual bool create(void);
+
+    /**
+     * Implementation of 'Release'.
+     */
+    virtual void release(void);
+
+private:
+    /** A resolved request: frame, level and region on that level. */
+    struct Request {
+        unsigned int Frame;
+        size_t Level;
+        std::array<size_t, 3> Lower;
+        std::array<size_t, 3> Upper;
+
+        inline bool operator==(const Request& rhs) const {
+            return (this->Frame == rhs.Frame) && (this->Level == rhs.Level) && (this->Lower == rhs.Lower) &&
+                   (this->Upper == rhs.Upper);
+        }
+    };
+
+    /**
+     * Copies the bricks overlapping the request into the output buffer.
+     *
+     * @param request The resolved request.
+     *
+     * @return 'true' on success.
+     */
+    bool assemble(const Request& request);
+
+    /**
+     * Opens the file if the file name has changed.
+     *
+     * @return 'true' if a file is open.
+     */
+    bool assertFile(void);
+
+    /**
+     * Sets the resolution, origin, extents and slice distances of the
+     * region of a resolved request.
+     *
+     * @param request       The resolved request.
+     * @param outMetadata   The metadata to update.
+     * @param outSliceDists Receives the three slice distances referenced by
+     *                      'outMetadata'.
+     */
+    void describe(const Request& request, geocalls::VolumetricDataCall::Metadata& outMetadata,
+        float* outSliceDists) const;
+
+    /**
+     * Callback receiving the data request.
+     *
+     * @param call The call being executed.
+     *
+     * @return true in case of success, false otherwise.
+     */
+    bool onGetData(core::Call& call);
+
+    /**
+     * Callback receiving the extent request.
+     *
+     * @param call The call being executed.
+     *
+     * @return true in case of success, false otherwise.
+     */
+    bool onGetExtents(core::Call& call);
+
+    /**
+     * Callback receiving the metadata request.
+     *
+     * @param call The call being executed.
+     *
+     * @return true in case of success, false otherwise.
+     */
+    bool onGetMetadata(core::Call& call);
+
+    /**
+     * Callback for starting and stopping asynchronous loading, which is
+     * not required as bricks are loaded on demand.
+     *
+     * @param call The call being executed.
+     *
+     * @return true.
+     */
+    bool onIgnore(core::Call& call);
+
+    /**
+     * Resolves the frame, the level of detail and the region of interest
+     * requested by a call.
+     *
+     * @param call The call being executed.
+     *
+     * @return The resolved request.
+     */
+    Request resolve(const geocalls::VolumetricDataCall& call) const;
+
+    /** The bricked volume file. */
+    BrickedVolumeFile file;
+
+    /** The cached bricks. */
+    BrickCache cache;
+
+    /** The metadata describing the data delivered last. */
+    geocalls::VolumetricDataCall::Metadata metadata;
+
+    /** The storage of the slice distances referenced by the metadata. */
+    float sliceDists[3];
+
+    /** The metadata answered to a metadata request, which may differ from the loaded data. */
+    geocalls::VolumetricDataCall::Metadata queryMetadata;
+
+    /** The storage of the slice distances referenced by 'queryMetadata'. */
+    float querySliceDists[3];
+
+    /** The storage of the value range referenced by the metadata. */
+    std::vector<double> minValues;
+    std::vector<double> maxValues;
+
+    /** The data delivered last. */
+    std::vector<char> output;
+
+    /** The request the output buffer holds. */
+    Request loaded;
+
+    /** Flag whether the output buffer holds valid data. */
+    bool isLoaded;
+
+    /** The hash of the data delivered last. */
+    size_t dataHash;
+
+    /** The path of the bricked volume file. */
+    core::param::ParamSlot paramFileName;
+
+    /** The maximum size of the brick cache in megabytes. */
+    core::param::ParamSlot paramCacheSize;
+
+    /** The maximum size of the delivered data in megabytes. */
+    core::param::ParamSlot paramOutputBudget;
+
+    /** Forces a level of detail instead of the one requested. */
+    core::param::ParamSlot paramLevel;
+
+    /** The slot providing the data. */
+    core::CalleeSlot slotGetData;
+};
+
+} // namespace volume
+} // namespace megamol
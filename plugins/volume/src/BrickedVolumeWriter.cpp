@@ -0,0 +1,469 @@
+/*
+ * BrickedVolumeWriter.cpp
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "BrickedVolumeWriter.h"
+#include "stdafx.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "datRaw.h"
+
+#include "BrickedVolume.h"
+#include "geometry_calls/VolumetricDataCallTypes.h"
+#include "mmcore/param/FilePathParam.h"
+#include "mmcore/param/IntParam.h"
+#include "mmcore/utility/log/Log.h"
+
+using namespace megamol;
+using namespace megamol::core;
+using namespace megamol::volume;
+
+
+namespace {
+
+/**
+ * Answer whether the machine stores numbers in little endian byte order.
+ */
+bool isLittleEndian(void) {
+    const uint16_t probe = 1;
+    return *reinterpret_cast<const uint8_t*>(&probe) == 1;
+}
+
+
+/**
+ * Streams the slices of one frame into the bricks of all levels. Only one
+ * slab of BrickSize slices is held in memory per level; whenever a slab is
+ * complete, its bricks are written and the slab is downsampled into the
+ * next level.
+ */
+template<class T>
+class PyramidBuilder {
+public:
+    PyramidBuilder(const BrickedVolumeLayout& layout, size_t brickSize, size_t components, std::ofstream& out,
+        uint64_t* offsets)
+            : layout(layout)
+            , brickSize(brickSize)
+            , components(components)
+            , out(out)
+            , offsets(offsets)
+            , levels(layout.Levels())
+            , brick(brickSize * brickSize * brickSize * components) {
+        for (size_t l = 0; l < this->levels.size(); ++l) {
+            this->levels[l].slab.resize(this->sliceSize(l) * brickSize);
+        }
+    }
+
+    /**
+     * Hands the next slices of level 0, which must have been written to
+     * Slab() before, to the pyramid.
+     *
+     * @param cnt The number of slices, BrickSize except for the last slab.
+     */
+    void CommitSlab(size_t cnt) {
+        this->levels[0].filled = cnt;
+        this->flush(0);
+    }
+
+    /**
+     * Writes the incomplete slabs of all levels.
+     *
+     * @return 'true' if all bricks have been written.
+     */
+    bool Finish(void) {
+        for (size_t l = 0; l < this->levels.size(); ++l) {
+            if (this->levels[l].filled > 0) {
+                this->flush(l);
+            }
+        }
+        return static_cast<bool>(this->out);
+    }
+
+    /** Answer the memory receiving the next slab of level 0. */
+    inline T* Slab(void) {
+        return this->levels[0].slab.data();
+    }
+
+private:
+    struct Level {
+        std::vector<T> slab;
+        size_t filled = 0;
+        size_t z = 0;
+    };
+
+    static inline T convert(double value) {
+        if (std::is_integral<T>::value) {
+            return static_cast<T>(std::round(value));
+        } else {
+            return static_cast<T>(value);
+        }
+    }
+
+    inline size_t sliceSize(size_t level) const {
+        const auto& res = this->layout.Resolution(level);
+        return res[0] * res[1] * this->components;
+    }
+
+    void add(size_t level, const T* slice) {
+        auto& lv = this->levels[level];
+        const size_t size = this->sliceSize(level);
+        std::copy(slice, slice + size, lv.slab.data() + lv.filled * size);
+        if (++lv.filled == this->brickSize) {
+            this->flush(level);
+        }
+    }
+
+    void flush(size_t level) {
+        auto& lv = this->levels[level];
+        const auto& res = this->layout.Resolution(level);
+        const auto& bricks = this->layout.Bricks(level);
+        const size_t bs = this->brickSize;
+        const size_t comps = this->components;
+
+        for (size_t by = 0; by < bricks[1]; ++by) {
+            for (size_t bx = 0; bx < bricks[0]; ++bx) {
+                const size_t x0 = bx * bs, x1 = std::min(x0 + bs, res[0]);
+                const size_t y0 = by * bs, y1 = std::min(y0 + bs, res[1]);
+                std::fill(this->brick.begin(), this->brick.end(), T(0));
+                for (size_t z = 0; z < lv.filled; ++z) {
+                    for (size_t y = y0; y < y1; ++y) {
+                        const T* src = lv.slab.data() + ((z * res[1] + y) * res[0] + x0) * comps;
+                        T* dst = this->brick.data() + ((z * bs + (y - y0)) * bs) * comps;
+                        std::copy(src, src + (x1 - x0) * comps, dst);
+                    }
+                }
+                this->offsets[this->layout.BrickIndex(level, bx, by, lv.z)] =
+                    static_cast<uint64_t>(this->out.tellp());
+                this->out.write(reinterpret_cast<const char*>(this->brick.data()),
+                    static_cast<std::streamsize>(this->brick.size() * sizeof(T)));
+            }
+        }
+
+        if (level + 1 < this->levels.size()) {
+            const auto& half = this->layout.Resolution(level + 1);
+            std::vector<T> slice(this->sliceSize(level + 1));
+            for (size_t z = 0; z < lv.filled; z += 2) {
+                const size_t zCnt = std::min<size_t>(2, lv.filled - z);
+#pragma omp parallel for
+                for (int64_t y = 0; y < static_cast<int64_t>(half[1]); ++y) {
+                    const size_t sy = 2 * y, yCnt = std::min<size_t>(2, res[1] - sy);
+                    for (size_t x = 0; x < half[0]; ++x) {
+                        const size_t sx = 2 * x, xCnt = std::min<size_t>(2, res[0] - sx);
+                        for (size_t c = 0; c < comps; ++c) {
+                            double sum = 0.0;
+                            for (size_t dz = 0; dz < zCnt; ++dz) {
+                                for (size_t dy = 0; dy < yCnt; ++dy) {
+                                    for (size_t dx = 0; dx < xCnt; ++dx) {
+                                        sum += static_cast<double>(
+                                            lv.slab[(((z + dz) * res[1] + sy + dy) * res[0] + sx + dx) * comps + c]);
+                                    }
+                                }
+                            }
+                            slice[(y * half[0] + x) * comps + c] = convert(sum / (zCnt * yCnt * xCnt));
+                        }
+                    }
+                }
+                this->add(level + 1, slice.data());
+            }
+        }
+
+        lv.filled = 0;
+        ++lv.z;
+    }
+
+    const BrickedVolumeLayout& layout;
+    size_t brickSize;
+    size_t components;
+    std::ofstream& out;
+    uint64_t* offsets;
+    std::vector<Level> levels;
+    std::vector<T> brick;
+};
+
+
+/**
+ * Converts all frames of the raw file 'in' and updates the value range.
+ */
+template<class T>
+bool convert(std::ifstream& in, std::ofstream& out, const DatRawFileInfo& info, const BrickedVolumeHeader& header,
+    const BrickedVolumeLayout& layout, std::vector<uint64_t>& offsets, std::vector<double>& mins,
+    std::vector<double>& maxes) {
+    using megamol::core::utility::log::Log;
+    const size_t comps = header.Components;
+    const size_t sliceVoxels = static_cast<size_t>(header.Resolution[0]) * header.Resolution[1];
+    const size_t frameBytes = sliceVoxels * header.Resolution[2] * comps * sizeof(T);
+    const bool swap = (info.byteOrder == DR_LITTLE_ENDIAN) != isLittleEndian();
+
+    for (uint32_t f = 0; f < header.Frames; ++f) {
+        PyramidBuilder<T> builder(layout, header.BrickSize, comps, out, offsets.data() + f * layout.BricksPerFrame());
+        in.seekg(static_cast<std::streamoff>(info.dataOffset + f * frameBytes));
+
+        for (size_t z = 0; z < header.Resolution[2]; z += header.BrickSize) {
+            const size_t cnt = std::min<size_t>(header.BrickSize, header.Resolution[2] - z);
+            const int64_t values = static_cast<int64_t>(cnt * sliceVoxels * comps);
+            T* slab = builder.Slab();
+            if (!in.read(reinterpret_cast<char*>(slab), static_cast<std::streamsize>(values * sizeof(T)))) {
+                Log::DefaultLog.WriteError("The raw file ends within frame %u.", f);
+                return false;
+            }
+
+#pragma omp parallel
+            {
+                std::vector<double> lo(comps, std::numeric_limits<double>::max());
+                std::vector<double> hi(comps, std::numeric_limits<double>::lowest());
+#pragma omp for nowait
+                for (int64_t i = 0; i < values; ++i) {
+                    if (swap) {
+                        char* bytes = reinterpret_cast<char*>(slab + i);
+                        std::reverse(bytes, bytes + sizeof(T));
+                    }
+                    const double v = static_cast<double>(slab[i]);
+                    const size_t c = static_cast<size_t>(i) % comps;
+                    if (v < lo[c]) {
+                        lo[c] = v;
+                    }
+                    if (v > hi[c]) {
+                        hi[c] = v;
+                    }
+                }
+#pragma omp critical
+                for (size_t c = 0; c < comps; ++c) {
+                    mins[c] = std::min(mins[c], lo[c]);
+                    maxes[c] = std::max(maxes[c], hi[c]);
+                }
+            }
+
+            builder.CommitSlab(cnt);
+            if (!out) {
+                break;
+            }
+        }
+
+        if (!builder.Finish()) {
+            Log::DefaultLog.WriteError("Writing the bricks of frame %u failed.", f);
+            return false;
+        }
+        Log::DefaultLog.WriteInfo("Bricked frame %u of %u.", f + 1, header.Frames);
+    }
+    return true;
+}
+
+} // namespace
+
+
+/*
+ * BrickedVolumeWriter::BrickedVolumeWriter
+ */
+BrickedVolumeWriter::BrickedVolumeWriter(void)
+        : AbstractDataWriter()
+        , inputSlot("input", "The dat file of the volume to be converted")
+        , outputSlot("output", "The bricked volume file to be written")
+        , brickSizeSlot("brickSize", "The edge length of the bricks in voxels, a power of two") {
+
+    this->inputSlot.SetParameter(new param::FilePathParam("", param::FilePathParam::Flag_File, {"dat"}));
+    this->MakeSlotAvailable(&this->inputSlot);
+
+    this->outputSlot.SetParameter(new param::FilePathParam("", param::FilePathParam::Flag_File_ToBeCreated));
+    this->MakeSlotAvailable(&this->outputSlot);
+
+    this->brickSizeSlot.SetParameter(new param::IntParam(32, 2, 1024));
+    this->MakeSlotAvailable(&this->brickSizeSlot);
+}
+
+
+/*
+ * BrickedVolumeWriter::~BrickedVolumeWriter
+ */
+BrickedVolumeWriter::~BrickedVolumeWriter(void) {
+    this->Release();
+}
+
+
+/*
+ * BrickedVolumeWriter::create
+ */
+bool BrickedVolumeWriter::create(void) {
+    return true;
+}
+
+
+/*
+ * BrickedVolumeWriter::release
+ */
+void BrickedVolumeWriter::release(void) {}
+
+
+/*
+ * BrickedVolumeWriter::run
+ */
+bool BrickedVolumeWriter::run(void) {
+    using megamol::core::utility::log::Log;
+    const auto inPath = this->inputSlot.Param<param::FilePathParam>()->Value();
+    const auto outPath = this->outputSlot.Param<param::FilePathParam>()->Value();
+    if (inPath.empty() || outPath.empty()) {
+        Log::DefaultLog.WriteError("No input or output file specified. Abort.");
+        return false;
+    }
+    const int brickSize = this->brickSizeSlot.Param<param::IntParam>()->Value();
+    if ((brickSize < 2) || ((brickSize & (brickSize - 1)) != 0)) {
+        Log::DefaultLog.WriteError("The brick size %d is not a power of two. Abort.", brickSize);
+        return false;
+    }
+
+    DatRawFileInfo info;
+    ::memset(&info, 0, sizeof(info));
+    if (::datRaw_readHeader(inPath.generic_u8string().c_str(), &info, nullptr) == 0) {
+        Log::DefaultLog.WriteError(
+            "Failed to read and parse dat file \"%s\". Abort.", inPath.generic_u8string().c_str());
+        return false;
+    }
+
+    BrickedVolumeHeader header;
+    ::memset(&header, 0, sizeof(header));
+    ::memcpy(header.Magic, BrickedVolumeHeader::MAGIC, sizeof(header.Magic));
+    header.Version = BrickedVolumeHeader::VERSION;
+    for (int d = 0; d < 3; ++d) {
+        const bool valid = (d < info.dimensions);
+        header.Resolution[d] = valid ? static_cast<uint32_t>(info.resolution[d]) : 1;
+        header.SliceDists[d] = valid ? info.sliceDist[d] : 1.0f;
+        header.Origin[d] = (valid && (info.origin != nullptr)) ? info.origin[d] : 0.0f;
+    }
+    header.Components = static_cast<uint32_t>(info.numComponents);
+    header.ScalarLength = static_cast<uint32_t>(::datRaw_getFormatSize(info.dataFormat));
+    header.Frames = static_cast<uint32_t>(info.timeSteps);
+    header.BrickSize = static_cast<uint32_t>(brickSize);
+
+    bool retval = true;
+    switch (info.dataFormat) {
+    case DR_FORMAT_CHAR:
+    case DR_FORMAT_SHORT:
+    case DR_FORMAT_INT:
+        header.ScalarType = geocalls::SIGNED_INTEGER;
+        break;
+    case DR_FORMAT_UCHAR:
+    case DR_FORMAT_USHORT:
+    case DR_FORMAT_UINT:
+        header.ScalarType = geocalls::UNSIGNED_INTEGER;
+        break;
+    case DR_FORMAT_FLOAT:
+    case DR_FORMAT_DOUBLE:
+        header.ScalarType = geocalls::FLOATING_POINT;
+        break;
+    default:
+        Log::DefaultLog.WriteError("The data format of \"%s\" is not supported. Abort.", info.dataFileName);
+        retval = false;
+        break;
+    }
+    if (retval && (info.gridType != DR_GRID_CARTESIAN)) {
+        Log::DefaultLog.WriteError("Only cartesian grids can be bricked. Abort.");
+        retval = false;
+    }
+    if (retval && (info.multiDataFiles != 0)) {
+        Log::DefaultLog.WriteError("Volumes split into multiple raw files are not supported. Abort.");
+        retval = false;
+    }
+
+    std::ifstream in;
+    if (retval) {
+        in.open(info.dataFileName, std::ios::binary);
+        char magic[2] = {0, 0};
+        if (!in.is_open() || !in.read(magic, sizeof(magic))) {
+            Log::DefaultLog.WriteError("Cannot read raw file \"%s\". Abort.", info.dataFileName);
+            retval = false;
+        } else if ((static_cast<uint8_t>(magic[0]) == 0x1f) && (static_cast<uint8_t>(magic[1]) == 0x8b)) {
+            Log::DefaultLog.WriteError("Compressed raw file \"%s\" cannot be streamed. Abort.", info.dataFileName);
+            retval = false;
+        }
+    }
+
+    if (retval) {
+        const BrickedVolumeLayout layout(header.Resolution, header.BrickSize);
+        header.Levels = static_cast<uint32_t>(layout.Levels());
+        std::vector<double> mins(header.Components, std::numeric_limits<double>::max());
+        std::vector<double> maxes(header.Components, std::numeric_limits<double>::lowest());
+        std::vector<uint64_t> offsets(layout.BricksPerFrame() * header.Frames, 0);
+        const auto bytes = [](const auto& v) {
+            return static_cast<std::streamsize>(v.size() * sizeof(typename std::decay_t<decltype(v)>::value_type));
+        };
+
+        // reserve the header and the brick table, which are written at the end
+        std::ofstream out(outPath, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(mins.data()), bytes(mins));
+        out.write(reinterpret_cast<const char*>(maxes.data()), bytes(maxes));
+        out.write(reinterpret_cast<const char*>(offsets.data()), bytes(offsets));
+        if (!out) {
+            Log::DefaultLog.WriteError("Cannot write \"%s\". Abort.", outPath.generic_u8string().c_str());
+            retval = false;
+        }
+
+        if (retval) {
+            Log::DefaultLog.WriteInfo("Bricking \"%s\" into %u levels of %u^3 bricks.",
+                inPath.generic_u8string().c_str(), header.Levels, header.BrickSize);
+            switch (info.dataFormat) {
+            case DR_FORMAT_CHAR:
+                retval = convert<int8_t>(in, out, info, header, layout, offsets, mins, maxes);
+                break;
+            case DR_FORMAT_UCHAR:
+                retval = convert<uint8_t>(in, out, info, header, layout, offsets, mins, maxes);
+                break;
+            case DR_FORMAT_SHORT:
+                retval = convert<int16_t>(in, out, info, header, layout, offsets, mins, maxes);
+                break;
+            case DR_FORMAT_USHORT:
+                retval = convert<uint16_t>(in, out, info, header, layout, offsets, mins, maxes);
+                break;
+            case DR_FORMAT_INT:
+                retval = convert<int32_t>(in, out, info, header, layout, offsets, mins, maxes);
+                break;
+            case DR_FORMAT_UINT:
+                retval = convert<uint32_t>(in, out, info, header, layout, offsets, mins, maxes);
+                break;
+            case DR_FORMAT_FLOAT:
+                retval = convert<float>(in, out, info, header, layout, offsets, mins, maxes);
+                break;
+            case DR_FORMAT_DOUBLE:
+                retval = convert<double>(in, out, info, header, layout, offsets, mins, maxes);
+                break;
+            }
+        }
+
+        if (retval) {
+            out.seekp(0);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(mins.data()), bytes(mins));
+            out.write(reinterpret_cast<const char*>(maxes.data()), bytes(maxes));
+            out.write(reinterpret_cast<const char*>(offsets.data()), bytes(offsets));
+            out.close();
+            retval = static_cast<bool>(out);
+        }
+        if (retval) {
+            Log::DefaultLog.WriteInfo("Bricked volume successfully written to \"%s\".",
+                outPath.generic_u8string().c_str());
+        } else {
+            Log::DefaultLog.WriteError("Bricking \"%s\" failed.", inPath.generic_u8string().c_str());
+        }
+    }
+
+    ::datRaw_freeInfo(&info);
+    return retval;
+}
+
+
+/*
+ * BrickedVolumeWriter::getCapabilities
+ */
+bool BrickedVolumeWriter::getCapabilities(DataWriterCtrlCall& call) {
+    call.SetAbortable(false);
+    return true;
+}
@@ -0,0 +1,109 @@
+/*
+ * BrickedVolumeWriter.h
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include "mmcore/AbstractDataWriter.h"
+#include "mmcore/DataWriterCtrlCall.h"
+#include "mmcore/param/ParamSlot.h"
+
+
+namespace megamol {
+namespace volume {
+
+/**
+ * Converts a dat/raw volume into a bricked volume with a level-of-detail
+ * pyramid (see BrickedVolumeHeader). The raw file is streamed slab-wise,
+ * so volumes larger than the main memory can be converted.
+ */
+class BrickedVolumeWriter : public megamol::core::AbstractDataWriter {
+public:
+    /**
+     * Answer the name of this module.
+     *
+     * @return The name of this module.
+     */
+    static const char* ClassName(void) {
+        return "BrickedVolumeWriter";
+    }
+
+    /**
+     * Answer a human readable description of this module.
+     *
+     * @return A human readable description of this module.
+     */
+    static const char* Description(void) {
+        return "Converts a dat/raw volume into a bricked volume with a level-of-detail pyramid";
+    }
+
+    /**
+     * Answers whether this module is available on the current system.
+     *
+     * @return 'true' if the module is available, 'false' otherwise.
+     */
+    static bool IsAvailable(void) {
+        return true;
+    }
+
+    /**
+     * Disallow usage in quickstarts
+     *
+     * @return false
+     */
+    static bool SupportQuickstart(void) {
+        return false;
+    }
+
+    /** Ctor. */
+    BrickedVolumeWriter(void);
+
+    /** Dtor. */
+    virtual ~BrickedVolumeWriter(void);
+
+protected:
+    /**
+     * Implementation of 'Create'.
+     *
+     * @return 'true' on success, 'false' otherwise.
+     */
+    virtual bool create(void);
+
+    /**
+     * Implementation of 'Release'.
+     */
+    virtual void release(void);
+
+    /**
+     * The main function
+     *
+     * @return True on success
+     */
+    virtual bool run(void);
+
+    /**
+     * Function querying the writers capabilities
+     *
+     * @param call The call to receive the capabilities
+     *
+     * @return True on success
+     */
+    virtual bool getCapabilities(core::DataWriterCtrlCall& call);
+
+private:
+    /** The dat file of the volume to be converted */
+    core::param::ParamSlot inputSlot;
+
+    /** The bricked volume file to be written */
+    core::param::ParamSlot outputSlot;
+
+    /** The edge length of the bricks */
+    core::param::ParamSlot brickSizeSlot;
+};
+
+} // namespace volume
+} // namespace megamol
@@ -46,19 +46,25 @@ megamol::volume::VolumetricDataSource::VolumetricDataSource(void)
         , paramOutputDataSize("OutputDataSize", "Forces the scalar type to the specified size.")
         , paramOutputDataType("OutputDataType", "Enforces the type of a scalar during loading.")
         , paramLoadAsync("LoadAsync", "Start asynchronous loading of frames.")
-        , slotGetData("GetData", "Slot for requesting data from the source.") {
+        , slotGetData("GetData", "Slot for requesting data from the source.")
+        , paramMacroCellSize("MacroCellSize",
+              "The edge length in voxels of the bricks of the published min/max macrocells, 0 disables them.")
+        , minMaxKey{0, 0, nullptr, DR_FORMAT_NONE, 0} {
     using geocalls::VolumetricDataCall;
     core::param::EnumParam* enumParam = nullptr;
 
     this->loaderStatus.store(LOADER_STATUS_STOPPED);
 
     this->paramAsyncSleep.SetParameter(new core::param::IntParam(0, 0));
+    this->paramAsyncSleep.SetUpdateCallback(&VolumetricDataSource::onSettingsChanged);
     this->MakeSlotAvailable(&this->paramAsyncSleep);
 
     this->paramAsyncWake.SetParameter(new core::param::IntParam(0, 0));
+    this->paramAsyncWake.SetUpdateCallback(&VolumetricDataSource::onSettingsChanged);
     this->MakeSlotAvailable(&this->paramAsyncWake);
 
     this->paramBuffers.SetParameter(new core::param::IntParam(2, 2));
+    this->paramBuffers.SetUpdateCallback(&VolumetricDataSource::onSettingsChanged);
     this->MakeSlotAvailable(&this->paramBuffers);
 
     this->paramFileName.SetParameter(new core::param::FilePathParam(""));
@@ -72,6 +78,7 @@ megamol::volume::VolumetricDataSource::VolumetricDataSource(void)
     enumParam->SetTypePair(4, _T("4 Bytes/Scalar"));
     enumParam->SetTypePair(8, _T("8 Bytes/Scalar"));
     this->paramOutputDataSize.SetParameter(enumParam);
+    this->paramOutputDataSize.SetUpdateCallback(&VolumetricDataSource::onSettingsChanged);
     this->MakeSlotAvailable(&this->paramOutputDataSize);
 
     enumParam = new core::param::EnumParam(-1);
@@ -80,13 +87,19 @@ megamol::volume::VolumetricDataSource::VolumetricDataSource(void)
     enumParam->SetTypePair(VolumetricDataCall::ScalarType::UNSIGNED_INTEGER, _T("uint"));
     enumParam->SetTypePair(VolumetricDataCall::ScalarType::FLOATING_POINT, _T("float"));
     this->paramOutputDataType.SetParameter(enumParam);
+    this->paramOutputDataType.SetUpdateCallback(&VolumetricDataSource::onSettingsChanged);
     this->MakeSlotAvailable(&this->paramOutputDataType);
 
     this->paramLoadAsync.SetParameter(new core::param::BoolParam(FALSE));
     // this->paramLoadAsync.SetUpdateCallback(
     //    &VolumetricDataSource::onLoadAsyncChanged);
+    this->paramLoadAsync.SetUpdateCallback(&VolumetricDataSource::onSettingsChanged);
     this->MakeSlotAvailable(&this->paramLoadAsync);
 
+    this->paramMacroCellSize.SetParameter(new core::param::IntParam(16, 0));
+    this->paramMacroCellSize.SetUpdateCallback(&VolumetricDataSource::onSettingsChanged);
+    this->MakeSlotAvailable(&this->paramMacroCellSize);
+
     this->slotGetData.SetCallback(VolumetricDataCall::ClassName(),
         VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_GET_DATA), &VolumetricDataSource::onGetData);
     this->slotGetData.SetCallback(VolumetricDataCall::ClassName(),
@@ -100,6 +113,8 @@ megamol::volume::VolumetricDataSource::VolumetricDataSource(void)
     this->slotGetData.SetCallback(VolumetricDataCall::ClassName(),
         VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_TRY_GET_DATA), &VolumetricDataSource::onTryGetData);
     this->MakeSlotAvailable(&this->slotGetData);
+
+    this->onSettingsChanged(this->paramLoadAsync);
 }
 
 
@@ -139,13 +154,12 @@ DatRawDataFormat megamol::volume::VolumetricDataSource::getOutputDataFormat(void
     using geocalls::VolumetricDataCall;
     using megamol::core::utility::log::Log;
 
-    auto sizeParam = this->paramOutputDataSize.Param<core::param::EnumParam>();
-    auto typeParam = this->paramOutputDataType.Param<core::param::EnumParam>();
+    const int outputSize = this->settingOutputDataSize.load();
+    const int outputType = this->settingOutputDataType.load();
 
-    VolumetricDataCall::ScalarType scalarType = (typeParam->Value() >= 0)
-                                                    ? static_cast<VolumetricDataCall::ScalarType>(typeParam->Value())
-                                                    : this->metadata.ScalarType;
-    size_t scalarLength = (sizeParam->Value() >= 0) ? sizeParam->Value() : this->metadata.ScalarLength;
+    VolumetricDataCall::ScalarType scalarType =
+        (outputType >= 0) ? static_cast<VolumetricDataCall::ScalarType>(outputType) : this->metadata.ScalarType;
+    size_t scalarLength = (outputSize >= 0) ? outputSize : this->metadata.ScalarLength;
 
     switch (scalarType) {
     case VolumetricDataCall::ScalarType::SIGNED_INTEGER:
@@ -214,6 +228,8 @@ bool megamol::volume::VolumetricDataSource::onFileNameChanged(core::param::Param
     using geocalls::VolumetricDataCall;
     using megamol::core::utility::log::Log;
 
+    std::lock_guard<std::mutex> lock(this->stateLock);
+
     /* Allocate header or prepare it for re-use. */
     if (this->fileInfo == nullptr) {
         this->fileInfo = new DatRawFileInfo();
@@ -221,7 +237,7 @@ bool megamol::volume::VolumetricDataSource::onFileNameChanged(core::param::Param
         ::datRaw_freeInfo(this->fileInfo);
     }
 
-    bool isAsync = this->paramLoadAsync.Param<core::param::BoolParam>()->Value();
+    bool isAsync = this->settingLoadAsync.load();
     if (isAsync) {
         // Cancel loading the previous data set before settings a new one.
         Log::DefaultLog.WriteInfo(_T("Halting asynchronous loading thread ")
@@ -419,8 +435,6 @@ bool megamol::volume::VolumetricDataSource::onFileNameChanged(core::param::Param
  * megamol::volume::VolumetricDataSource::onGetData
  */
 bool megamol::volume::VolumetricDataSource::onGetData(core::Call& call) {
-    using core::param::BoolParam;
-    using core::param::IntParam;
     using geocalls::VolumetricDataCall;
     using megamol::core::utility::log::Log;
 
@@ -428,12 +442,13 @@ bool megamol::volume::VolumetricDataSource::onGetData(core::Call& call) {
     bool retval = false;
 
     VolumetricDataCall& c = dynamic_cast<VolumetricDataCall&>(call);
+    std::lock_guard<std::mutex> lock(this->stateLock);
 
     if (c.DataHash() != this->dataHash) {
         try {
             /* Evaluate parameter changes. */
-            bool isAsync = this->paramLoadAsync.Param<BoolParam>()->Value();
-            size_t cntBuffers = this->paramBuffers.Param<IntParam>()->Value();
+            bool isAsync = this->settingLoadAsync.load();
+            size_t cntBuffers = this->settingBuffers.load();
 
             if (cntBuffers != this->buffers.Count()) {
                 bool isResume = this->suspendAsyncLoad(true);
@@ -671,7 +686,7 @@ bool megamol::volume::VolumetricDataSource::onGetData(core::Call& call) {
                         break;
                     }
                 } /* end for (size_t i = 0; i < dst.Count(); ++i) */
-            }     /* end if (this->paramLoadAsync.Param<BoolParam>()->Value()) */
+            }     /* end if (isAsync) */
 
         } catch (vislib::Exception& e) {
             Log::DefaultLog.WriteError(1, e.GetMsg());
@@ -684,34 +699,53 @@ bool megamol::volume::VolumetricDataSource::onGetData(core::Call& call) {
 
         if (retval) {
             const VolumetricDataCall& vdc = dynamic_cast<VolumetricDataCall&>(call);
-            switch (this->getOutputDataFormat()) {
-            case DR_FORMAT_UCHAR:
-                this->calcMinMax<uint8_t>(vdc.GetData(), this->mins, this->maxes, *fileInfo, metadata);
-                break;
-            case DR_FORMAT_FLOAT:
-                this->calcMinMax<float>(vdc.GetData(), this->mins, this->maxes, *fileInfo, metadata);
-                break;
-            case DR_FORMAT_DOUBLE:
-                this->calcMinMax<double>(vdc.GetData(), this->mins, this->maxes, *fileInfo, metadata);
-                break;
-            case DR_FORMAT_USHORT:
-                this->calcMinMax<uint16_t>(vdc.GetData(), this->mins, this->maxes, *fileInfo, metadata);
-                break;
-            case DR_FORMAT_SHORT:
-                this->calcMinMax<int16_t>(vdc.GetData(), this->mins, this->maxes, *fileInfo, metadata);
-                break;
-            case DR_FORMAT_RAW:
-                megamol::core::utility::log::Log::DefaultLog.WriteWarn(
-                    "Cannot determine min/max of BITS volume. Setting to [0,1].");
-                this->mins.resize(this->metadata.Components, 0.0);
-                this->maxes.resize(this->metadata.Components, 1.0);
-                break;
-            default:
-                megamol::core::utility::log::Log::DefaultLog.WriteWarn(
-                    "Cannot determine min/max of unknown volume. Setting to [0,1].");
-                this->mins.resize(this->metadata.Components, 0.0);
-                this->maxes.resize(this->metadata.Components, 1.0);
-                break;
+            const int macroCellSize = this->settingMacroCellSize.load();
+            // without published macrocells, bricks only serve the parallel min/max computation
+            const size_t brickSize = (macroCellSize > 0) ? static_cast<size_t>(macroCellSize) : 32;
+            const MinMaxKey key{this->dataHash, c.FrameID(), vdc.GetData(), this->getOutputDataFormat(),
+                static_cast<size_t>(macroCellSize)};
+            if (!(key == this->minMaxKey)) {
+                this->minMaxKey = key;
+                this->metadata.MacroCells = nullptr;
+                bool haveCells = true;
+                switch (this->getOutputDataFormat()) {
+                case DR_FORMAT_UCHAR:
+                    this->calcMinMax<uint8_t>(vdc.GetData(), this->mins, this->maxes, *fileInfo, metadata, brickSize);
+                    break;
+                case DR_FORMAT_FLOAT:
+                    this->calcMinMax<float>(vdc.GetData(), this->mins, this->maxes, *fileInfo, metadata, brickSize);
+                    break;
+                case DR_FORMAT_DOUBLE:
+                    this->calcMinMax<double>(vdc.GetData(), this->mins, this->maxes, *fileInfo, metadata, brickSize);
+                    break;
+                case DR_FORMAT_USHORT:
+                    this->calcMinMax<uint16_t>(
+                        vdc.GetData(), this->mins, this->maxes, *fileInfo, metadata, brickSize);
+                    break;
+                case DR_FORMAT_SHORT:
+                    this->calcMinMax<int16_t>(vdc.GetData(), this->mins, this->maxes, *fileInfo, metadata, brickSize);
+                    break;
+                case DR_FORMAT_RAW:
+                    megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+                        "Cannot determine min/max of BITS volume. Setting to [0,1].");
+                    this->mins.resize(this->metadata.Components, 0.0);
+                    this->maxes.resize(this->metadata.Components, 1.0);
+                    haveCells = false;
+                    break;
+                default:
+                    megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+                        "Cannot determine min/max of unknown volume. Setting to [0,1].");
+                    this->mins.resize(this->metadata.Components, 0.0);
+                    this->maxes.resize(this->metadata.Components, 1.0);
+                    haveCells = false;
+                    break;
+                }
+                if (haveCells && (macroCellSize > 0)) {
+                    this->buildMacroCellLevels(brickSize);
+                } else {
+                    this->macroCellMins.clear();
+                    this->macroCellMaxes.clear();
+                }
             }
             this->metadata.MinValues = this->mins.data();
             this->metadata.MaxValues = this->maxes.data();
@@ -724,6 +758,64 @@ bool megamol::volume::VolumetricDataSource::onGetData(core::Call& call) {
 }
 
 
+/*
+ * megamol::volume::VolumetricDataSource::buildMacroCellLevels
+ */
+void megamol::volume::VolumetricDataSource::buildMacroCellLevels(size_t brickSize) {
+    const size_t comps = this->metadata.Components;
+
+    // layout of the coarser levels, each one halves the cells per axis
+    size_t total = this->macroCellResolution[0] * this->macroCellResolution[1] * this->macroCellResolution[2];
+    while (total - this->macroCellOffsets.back() > 1) {
+        const size_t* prev = this->macroCellResolution.data() + this->macroCellResolution.size() - 3;
+        const size_t next[3] = {(prev[0] + 1) / 2, (prev[1] + 1) / 2, (prev[2] + 1) / 2};
+        this->macroCellOffsets.push_back(total);
+        this->macroCellResolution.insert(this->macroCellResolution.end(), next, next + 3);
+        total += next[0] * next[1] * next[2];
+    }
+    this->macroCellMins.resize(total * comps);
+    this->macroCellMaxes.resize(total * comps);
+
+    for (size_t l = 1; l < this->macroCellOffsets.size(); ++l) {
+        const size_t* src = this->macroCellResolution.data() + 3 * (l - 1);
+        const size_t* dst = this->macroCellResolution.data() + 3 * l;
+        const size_t srcOffset = this->macroCellOffsets[l - 1];
+        const size_t dstOffset = this->macroCellOffsets[l];
+        const int64_t cnt = static_cast<int64_t>(dst[0] * dst[1] * dst[2]);
+#pragma omp parallel for schedule(static)
+        for (int64_t cell = 0; cell < cnt; ++cell) {
+            const size_t cx = cell % dst[0];
+            const size_t cy = (cell / dst[0]) % dst[1];
+            const size_t cz = cell / (dst[0] * dst[1]);
+            float* cellMin = this->macroCellMins.data() + (dstOffset + cell) * comps;
+            float* cellMax = this->macroCellMaxes.data() + (dstOffset + cell) * comps;
+            std::fill(cellMin, cellMin + comps, std::numeric_limits<float>::infinity());
+            std::fill(cellMax, cellMax + comps, -std::numeric_limits<float>::infinity());
+            for (size_t z = 2 * cz; z < std::min(2 * cz + 2, src[2]); ++z) {
+                for (size_t y = 2 * cy; y < std::min(2 * cy + 2, src[1]); ++y) {
+                    for (size_t x = 2 * cx; x < std::min(2 * cx + 2, src[0]); ++x) {
+                        const size_t child = (srcOffset + (z * src[1] + y) * src[0] + x) * comps;
+                        for (size_t c = 0; c < comps; ++c) {
+                            cellMin[c] = std::min(cellMin[c], this->macroCellMins[child + c]);
+                            cellMax[c] = std::max(cellMax[c], this->macroCellMaxes[child + c]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    this->macroCells.BrickSize = brickSize;
+    this->macroCells.Levels = this->macroCellOffsets.size();
+    this->macroCells.Components = comps;
+    this->macroCells.Resolution = this->macroCellResolution.data();
+    this->macroCells.Offsets = this->macroCellOffsets.data();
+    this->macroCells.MinValues = this->macroCellMins.data();
+    this->macroCells.MaxValues = this->macroCellMaxes.data();
+    this->metadata.MacroCells = &this->macroCells;
+}
+
+
 /*
  * megamol::volume::VolumetricDataSource::onGetExtents
  */
@@ -731,6 +823,7 @@ bool megamol::volume::VolumetricDataSource::onGetExtents(core::Call& call) {
     using geocalls::VolumetricDataCall;
     using megamol::core::utility::log::Log;
 
+    std::lock_guard<std::mutex> lock(this->stateLock);
     try {
         VolumetricDataCall& c = dynamic_cast<VolumetricDataCall&>(call);
 
@@ -774,6 +867,7 @@ bool megamol::volume::VolumetricDataSource::onGetMetadata(core::Call& call) {
     using geocalls::VolumetricDataCall;
     using megamol::core::utility::log::Log;
 
+    std::lock_guard<std::mutex> lock(this->stateLock);
     try {
         VolumetricDataCall& c = dynamic_cast<VolumetricDataCall&>(call);
 
@@ -812,6 +906,7 @@ bool megamol::volume::VolumetricDataSource::onTryGetData(core::Call& call) {
     int expected = 0;
     bool retval = true;
 
+    std::lock_guard<std::mutex> lock(this->stateLock);
     try {
         VolumetricDataCall& c = dynamic_cast<VolumetricDataCall&>(call);
         c.SetDataHash(this->dataHash);
@@ -984,11 +1079,29 @@ bool megamol::volume::VolumetricDataSource::onMemorySaturationChanged(core::para
 }
 
 
+/*
+ * megamol::volume::VolumetricDataSource::onSettingsChanged
+ */
+bool megamol::volume::VolumetricDataSource::onSettingsChanged(core::param::ParamSlot& slot) {
+    using core::param::EnumParam;
+    using core::param::IntParam;
+    this->settingAsyncSleep.store(this->paramAsyncSleep.Param<IntParam>()->Value());
+    this->settingAsyncWake.store(this->paramAsyncWake.Param<IntParam>()->Value());
+    this->settingBuffers.store(this->paramBuffers.Param<IntParam>()->Value());
+    this->settingOutputDataSize.store(this->paramOutputDataSize.Param<EnumParam>()->Value());
+    this->settingOutputDataType.store(this->paramOutputDataType.Param<EnumParam>()->Value());
+    this->settingLoadAsync.store(this->paramLoadAsync.Param<core::param::BoolParam>()->Value());
+    this->settingMacroCellSize.store(this->paramMacroCellSize.Param<IntParam>()->Value());
+    return true;
+}
+
+
 /*
  * megamol::volume::VolumetricDataSource::onStartAsync
  */
 bool megamol::volume::VolumetricDataSource::onStartAsync(core::Call& call) {
-    this->paramLoadAsync.Param<core::param::BoolParam>()->SetValue(true);
+    // parameters must not be written off the graph thread, the next GetData picks this up
+    this->settingLoadAsync.store(true);
     return true;
 }
 
@@ -997,7 +1110,7 @@ bool megamol::volume::VolumetricDataSource::onStartAsync(core::Call& call) {
  * megamol::volume::VolumetricDataSource::onStopAsync
  */
 bool megamol::volume::VolumetricDataSource::onStopAsync(core::Call& call) {
-    this->paramLoadAsync.Param<core::param::BoolParam>()->SetValue(false);
+    this->settingLoadAsync.store(false);
     return true;
 }
 
@@ -1128,7 +1241,6 @@ void megamol::volume::VolumetricDataSource::BufferSlotUnlocker::Unlock(void) {
  * megamol::volume::VolumetricDataSource::loadAsync
  */
 DWORD megamol::volume::VolumetricDataSource::loadAsync(void* userData) {
-    using core::param::IntParam;
     using geocalls::VolumetricDataCall;
     using megamol::core::utility::log::Log;
 
@@ -1171,7 +1283,7 @@ DWORD megamol::volume::VolumetricDataSource::loadAsync(void* userData) {
                     ::datRaw_close(that->fileInfo);
 
                     /* Sleep if requested by user. */
-                    auto asyncSleep = that->paramAsyncSleep.Param<IntParam>()->Value();
+                    auto asyncSleep = that->settingAsyncSleep.load();
                     if (asyncSleep > 0) {
                         vislib::sys::Thread::Sleep(asyncSleep);
                     }
@@ -1189,7 +1301,7 @@ DWORD megamol::volume::VolumetricDataSource::loadAsync(void* userData) {
              * Wait until we have something to do. If requested, wake the thread
              * automatically to check for status updates after some time.
              */
-            auto asyncWake = that->paramAsyncWake.Param<IntParam>()->Value();
+            auto asyncWake = that->settingAsyncWake.load();
             if (asyncWake > 0) {
                 that->evtStartLoading.Wait(asyncWake);
             } else {
@@ -1266,14 +1378,13 @@ bool megamol::volume::VolumetricDataSource::spinExchange(
  * megamol::volume::VolumetricDataSource::assertBuffersUnsafe
  */
 size_t megamol::volume::VolumetricDataSource::assertBuffersUnsafe(size_t cntFrames, bool doNotFree) {
-    using core::param::IntParam;
     using megamol::core::utility::log::Log;
 
     size_t frameSize = this->calcFrameSize();
     size_t retval = 0;
 
     if (cntFrames < 2) {
-        cntFrames = this->paramBuffers.Param<IntParam>()->Value();
+        cntFrames = this->settingBuffers.load();
     }
     ASSERT(cntFrames >= 2);
 
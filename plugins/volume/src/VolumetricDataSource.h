@@ -7,8 +7,12 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
+#include <cmath>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #include "datRaw.h"
@@ -70,6 +74,17 @@ public:
      */
     virtual ~VolumetricDataSource(void);
 
+    /**
+     * The call functions and the loader thread only use copies of the
+     * parameters, and the call functions and changes of the data set are
+     * serialised by 'stateLock'.
+     *
+     * @return true, unconditionally.
+     */
+    bool SupportsBackgroundCalls(void) const override {
+        return true;
+    }
+
 protected:
     /** Superclass typedef. */
     typedef core::Module Base;
@@ -143,6 +158,16 @@ protected:
      */
     bool onMemorySaturationChanged(core::param::ParamSlot& slot);
 
+    /**
+     * Copies the parameters used by the call functions and the loader
+     * thread.
+     *
+     * @param slot The updated ParamSlot.
+     *
+     * @return true, unconditionally.
+     */
+    bool onSettingsChanged(core::param::ParamSlot& slot);
+
     /**
      * Gets the meta data.
      *
@@ -399,29 +424,146 @@ private:
     /** The slot that requests the data. */
     core::CalleeSlot slotGetData;
 
+    /** The edge length of the bricks of the published macrocells. */
+    core::param::ParamSlot paramMacroCellSize;
+
+    /**
+     * The values of the parameters, which are only read on the graph
+     * thread. Requests of the call may override 'settingLoadAsync'.
+     */
+    std::atomic_int settingAsyncSleep;
+    std::atomic_int settingAsyncWake;
+    std::atomic_int settingBuffers;
+    std::atomic_int settingOutputDataSize;
+    std::atomic_int settingOutputDataType;
+    std::atomic_bool settingLoadAsync;
+    std::atomic_int settingMacroCellSize;
+
+    /** Serialises the call functions and changes of the data set. */
+    std::mutex stateLock;
+
     std::vector<double> mins, maxes;
 
+    /** The published min/max macrocells of the current frame. */
+    geocalls::VolumetricDataCall::MacroCells macroCells;
+
+    /** The minimal values of all macrocells. */
+    std::vector<float> macroCellMins;
+
+    /** The maximal values of all macrocells. */
+    std::vector<float> macroCellMaxes;
+
+    /** The number of macrocells per axis of each level. */
+    std::vector<size_t> macroCellResolution;
+
+    /** The index of the first macrocell of each level. */
+    std::vector<size_t> macroCellOffsets;
+
+    /** Identifies the data min/max and macrocells were computed for. */
+    struct MinMaxKey {
+        unsigned int dataHash;
+        unsigned int frameID;
+        const void* data;
+        DatRawDataFormat format;
+        size_t brickSize;
+
+        inline bool operator==(const MinMaxKey& rhs) const {
+            return (this->dataHash == rhs.dataHash) && (this->frameID == rhs.frameID) && (this->data == rhs.data) &&
+                   (this->format == rhs.format) && (this->brickSize == rhs.brickSize);
+        }
+    } minMaxKey;
+
+    /** Rounds 'v' to the largest float not greater than 'v'. */
+    static inline float floatBelow(double v) {
+        const float f = static_cast<float>(v);
+        return (static_cast<double>(f) > v) ? std::nextafter(f, -std::numeric_limits<float>::infinity()) : f;
+    }
+
+    /** Rounds 'v' to the smallest float not less than 'v'. */
+    static inline float floatAbove(double v) {
+        const float f = static_cast<float>(v);
+        return (static_cast<double>(f) < v) ? std::nextafter(f, std::numeric_limits<float>::infinity()) : f;
+    }
+
+    /**
+     * Merges the macrocells of level 0 into the coarser levels until a
+     * single cell remains and publishes them via the metadata.
+     *
+     * @param brickSize The edge length of the cells of level 0.
+     */
+    void buildMacroCellLevels(size_t brickSize);
+
+    /**
+     * Computes the min/max per component and the macrocells of level 0 in
+     * parallel. The bricks are scanned independently, the global range is
+     * merged from the per-thread ranges.
+     *
+     * @param brickSize The edge length of the bricks in voxels.
+     */
     template<class T>
     void calcMinMax(void const* vol_ptr, std::vector<double>& mins, std::vector<double>& maxes,
-        DatRawFileInfo const& fileinfo, geocalls::VolumetricDataCall::Metadata const& metadata) {
-        mins.resize(metadata.Components);
-        maxes.resize(metadata.Components);
-        for (auto c = 0; c < metadata.Components; ++c) {
-            double min = std::numeric_limits<double>::max();
-            double max = std::numeric_limits<double>::lowest();
-            size_t totalLength = 1;
-            for (int i = 0; i < fileinfo.dimensions; ++i) {
-                totalLength *= fileinfo.resolution[i];
+        DatRawFileInfo const& fileinfo, geocalls::VolumetricDataCall::Metadata const& metadata, size_t brickSize) {
+        const size_t comps = metadata.Components;
+        size_t res[3] = {1, 1, 1};
+        for (int i = 0; (i < fileinfo.dimensions) && (i < 3); ++i) {
+            res[i] = std::max(1, fileinfo.resolution[i]);
+        }
+        size_t cells[3];
+        for (int i = 0; i < 3; ++i) {
+            cells[i] = (res[i] + brickSize - 1) / brickSize;
+        }
+        const int64_t cntCells = static_cast<int64_t>(cells[0] * cells[1] * cells[2]);
+
+        this->macroCellResolution.assign(cells, cells + 3);
+        this->macroCellOffsets.assign(1, 0);
+        this->macroCellMins.resize(cntCells * comps);
+        this->macroCellMaxes.resize(cntCells * comps);
+        mins.assign(comps, std::numeric_limits<double>::max());
+        maxes.assign(comps, std::numeric_limits<double>::lowest());
+
+        auto* vol = reinterpret_cast<const T*>(vol_ptr);
+#pragma omp parallel
+        {
+            std::vector<double> cellMin(comps), cellMax(comps);
+            std::vector<double> threadMin(comps, std::numeric_limits<double>::max());
+            std::vector<double> threadMax(comps, std::numeric_limits<double>::lowest());
+#pragma omp for schedule(dynamic, 16)
+            for (int64_t cell = 0; cell < cntCells; ++cell) {
+                const size_t cx = cell % cells[0];
+                const size_t cy = (cell / cells[0]) % cells[1];
+                const size_t cz = cell / (cells[0] * cells[1]);
+                // bricks include the first voxels of their successors
+                const size_t x0 = cx * brickSize, x1 = std::min(x0 + brickSize, res[0] - 1);
+                const size_t y0 = cy * brickSize, y1 = std::min(y0 + brickSize, res[1] - 1);
+                const size_t z0 = cz * brickSize, z1 = std::min(z0 + brickSize, res[2] - 1);
+                std::fill(cellMin.begin(), cellMin.end(), std::numeric_limits<double>::max());
+                std::fill(cellMax.begin(), cellMax.end(), std::numeric_limits<double>::lowest());
+                for (size_t z = z0; z <= z1; ++z) {
+                    for (size_t y = y0; y <= y1; ++y) {
+                        const T* v = vol + ((z * res[1] + y) * res[0] + x0) * comps;
+                        for (size_t x = x0; x <= x1; ++x) {
+                            for (size_t c = 0; c < comps; ++c, ++v) {
+                                const double d = static_cast<double>(*v);
+                                if (d < cellMin[c])
+                                    cellMin[c] = d;
+                                if (d > cellMax[c])
+                                    cellMax[c] = d;
+                            }
+                        }
+                    }
+                }
+                for (size_t c = 0; c < comps; ++c) {
+                    this->macroCellMins[cell * comps + c] = floatBelow(cellMin[c]);
+                    this->macroCellMaxes[cell * comps + c] = floatAbove(cellMax[c]);
+                    threadMin[c] = std::min(threadMin[c], cellMin[c]);
+                    threadMax[c] = std::max(threadMax[c], cellMax[c]);
+                }
             }
-            auto* vol = reinterpret_cast<const T*>(vol_ptr);
-            for (size_t x = c; x < totalLength; x += metadata.Components) {
-                if (vol[x] < min)
-                    min = vol[x];
-                if (vol[x] > max)
-                    max = vol[x];
+#pragma omp critical
+            for (size_t c = 0; c < comps; ++c) {
+                mins[c] = std::min(mins[c], threadMin[c]);
+                maxes[c] = std::max(maxes[c], threadMax[c]);
             }
-            mins[c] = min;
-            maxes[c] = max;
         }
     }
 };
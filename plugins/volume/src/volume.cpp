@@ -7,6 +7,8 @@
 #include "mmcore/utility/plugins/AbstractPluginInstance.h"
 #include "mmcore/utility/plugins/PluginRegister.h"
 
+#include "BrickedVolumeDataSource.h"
+#include "BrickedVolumeWriter.h"
 #include "BuckyBall.h"
 #include "DatRawWriter.h"
 #include "DifferenceVolume.h"
@@ -27,6 +29,8 @@ public:
     void registerClasses() override {
 
         // register modules
+        this->module_descriptions.RegisterAutoDescription<megamol::volume::BrickedVolumeDataSource>();
+        this->module_descriptions.RegisterAutoDescription<megamol::volume::BrickedVolumeWriter>();
         this->module_descriptions.RegisterAutoDescription<megamol::volume::BuckyBall>();
         this->module_descriptions.RegisterAutoDescription<megamol::volume::DatRawWriter>();
         this->module_descriptions.RegisterAutoDescription<megamol::volume::DifferenceVolume>();
@@ -86,13 +86,17 @@ def readListHeader(file):
 
     listFramedata(parseResult, fi) and print("    #%u: %s, %s" % (li, vertexNames[vertType], colorNames[colType]))
     stride = vertexSizes[vertType] + colorSizes[colType]
-    listFramedata(parseResult, fi) and print("        %u byte%s per particle" % pluralTuple(stride))
+    if (vertType == 5):
+        # the colours are stored in the encoded chunks
+        stride = 0
+    else:
+        listFramedata(parseResult, fi) and print("        %u byte%s per particle" % pluralTuple(stride))
 
     globalRad = 0.05
     globalCol = (0.0, 0.0, 0.0, 0.0)
     intensityRange = (0.0, 0.0)
     listBBox = (0.0, 0.0, 0.0, 0.0, 0.0, 0.0)
-    if (vertType == 1 or vertType == 3 or vertType == 4):
+    if (vertType == 1 or vertType == 3 or vertType == 4 or vertType == 5):
         globalRad = getFloat(f)
         listFramedata(parseResult, fi) and print("        global radius: %f" % (globalRad))
 
@@ -109,13 +113,35 @@ def readListHeader(file):
 
     if (version >= 103):
         listBBox = [getFloat(f) for x in range(6)]
-        listFramedata(parseResult, fi) and print("        list bounding box: (%f, %f, %f) - (%f, %f, %f)" % (tuple(box)))
+        listFramedata(parseResult, fi) and print("        list bounding box: (%f, %f, %f) - (%f, %f, %f)" % (tuple(listBBox)))
+    if (version >= 104):
+        numChunks = getUInt(f)
+        listFramedata(parseResult, fi) and print("        {0} chunk{1}".format(*pluralTuple(numChunks)))
+        for ci in range(numChunks):
+            chunkNumParts = getUInt64(f)
+            chunkBBox = [getFloat(f) for x in range(6)]
+            (parseResult.v and parseResult.v > 1) and print("            #%u: %u particle%s, (%f, %f, %f) - (%f, %f, %f)"
+                % ((ci,) + pluralTuple(chunkNumParts) + tuple(chunkBBox)))
+    if (vertType == 5):
+        # the encoded chunks are skipped, their particles cannot be listed
+        bits = getByte(f)
+        flags = getByte(f)
+        getUShort(f)
+        keyFrame = getUInt(f)
+        chunkSizes = [getUInt64(f) for x in range(numChunks)]
+        if (flags & 1):
+            listFramedata(parseResult, fi) and print("        %u bit positions, difference to key frame %u, %u bytes" % (bits, keyFrame, sum(chunkSizes)))
+        else:
+            listFramedata(parseResult, fi) and print("        %u bit positions, key frame, %u bytes" % (bits, sum(chunkSizes)))
+        f.seek(sum(chunkSizes), os.SEEK_CUR)
     return vertType, colType, stride, globalRad, globalCol, intensityRange, listNumParts, listBBox
 
 def readParticles(number, vertType, colType, file, listIndex):
     mins = [sys.float_info.max, sys.float_info.max, sys.float_info.max]
     maxs = [-sys.float_info.max, -sys.float_info.max, -sys.float_info.max]
     consoleSilent = parseResult.bboxonly or parseResult.dumpxyz
+    if (vertType == 5):
+        number = 0
     for p in range(number):
         if (vertType == 0):
             consoleSilent or print("        no position", end ='')
@@ -166,8 +192,8 @@ def readParticles(number, vertType, colType, file, listIndex):
     if (number > 0):
         consoleSilent or print("        bounding box of these particles: (%f, %f, %f) - (%f, %f, %f)" % tuple(mins + maxs))
 
-vertexSizes = [0, 12, 16, 6, 24]
-vertexNames = ["VERTDATA_NONE", "VERTDATA_FLOAT_XYZ", "VERTDATA_FLOAT_XYZR", "VERTDATA_SHORT_XYZ", "VERTDATA_DOUBLE_XYZ"]
+vertexSizes = [0, 12, 16, 6, 24, 0]
+vertexNames = ["VERTDATA_NONE", "VERTDATA_FLOAT_XYZ", "VERTDATA_FLOAT_XYZR", "VERTDATA_SHORT_XYZ", "VERTDATA_DOUBLE_XYZ", "VERTDATA_QUANTIZED_XYZ"]
 colorSizes = [0, 3, 4, 4, 12, 16, 8, 8]
 colorNames = ["COLDATA_NONE", "COLDATA_UINT8_RGB", "COLDATA_UINT8_RGBA", "COLDATA_FLOAT_I", "COLDATA_FLOAT_RGB", "COLDATA_FLOAT_RGBA", "COLDATA_USHORT_RGBA", "COLDATA_DOUBLE_I"]
 
@@ -216,6 +242,10 @@ for filename in parseResult.inputfiles:
             hideVersion or print("mmpld version 1.2")
         elif (version == 103):
             hideVersion or print("mmpld version 1.3")
+        elif (version == 104):
+            hideVersion or print("mmpld version 1.4")
+        elif (version == 105):
+            hideVersion or print("mmpld version 1.5")
         else:
             print("unsupported mmpld version " + str(version / 100) + "." + str(version % 100))
             exit(1)
@@ -298,6 +328,8 @@ for filename in parseResult.inputfiles:
                                 numTail = min(int(parseResult.tail), listNumParts)
                         else:
                             numTail = 0
+                        if (vertType == 5):
+                            numHead = numTail = 0
                         if (numHead > 0):
                             print("        list head (%d particles):" % numHead)
                         readParticles(numHead, vertType, colType, f, li)
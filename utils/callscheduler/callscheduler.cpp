@@ -0,0 +1,207 @@
+/*
+ * callscheduler.cpp
+ *
+ * Checks that CallScheduler executes the inputs of a module concurrently.
+ * A join module with two inputs is connected to two sources, each of which
+ * takes a fixed time to answer. The inputs must overlap if both sources
+ * support background calls, and must run one after the other otherwise.
+ *
+ *   ./callscheduler [milliseconds per source]
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "mmcore/Call.h"
+#include "mmcore/CallScheduler.h"
+#include "mmcore/CalleeSlot.h"
+#include "mmcore/CallerSlot.h"
+#include "mmcore/CoreInstance.h"
+#include "mmcore/Module.h"
+#include "mmcore/RootModuleNamespace.h"
+#include "mmcore/factories/CallAutoDescription.h"
+
+using namespace megamol::core;
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * Call recording when and where the source answered.
+ */
+class TimedCall : public Call {
+public:
+    static const char* ClassName(void) {
+        return "TimedCall";
+    }
+    static const char* Description(void) {
+        return "Call recording the execution of its source";
+    }
+    static unsigned int FunctionCount(void) {
+        return 1;
+    }
+    static const char* FunctionName(unsigned int idx) {
+        return "GetData";
+    }
+
+    Clock::time_point start, end;
+    std::thread::id thread;
+};
+typedef factories::CallAutoDescription<TimedCall> TimedCallDescription;
+
+/**
+ * Source taking a fixed time to answer.
+ */
+class SlowSource : public Module {
+public:
+    SlowSource(std::chrono::milliseconds duration, bool background)
+            : dataOutSlot("dataOut", "Output")
+            , duration(duration)
+            , background(background) {
+        this->dataOutSlot.SetCallback(TimedCall::ClassName(), "GetData", &SlowSource::getData);
+        this->MakeSlotAvailable(&this->dataOutSlot);
+    }
+
+    ~SlowSource(void) override {
+        this->Release();
+    }
+
+    bool SupportsBackgroundCalls(void) const override {
+        return this->background;
+    }
+
+    CalleeSlot dataOutSlot;
+
+protected:
+    bool create(void) override {
+        return true;
+    }
+
+    void release(void) override {}
+
+private:
+    bool getData(Call& call) {
+        TimedCall& tc = dynamic_cast<TimedCall&>(call);
+        tc.start = Clock::now();
+        std::this_thread::sleep_for(this->duration);
+        tc.end = Clock::now();
+        tc.thread = std::this_thread::get_id();
+        return true;
+    }
+
+    std::chrono::milliseconds duration;
+    bool background;
+};
+
+/**
+ * Module requesting its two inputs through the scheduler, like TableJoin.
+ */
+class Join : public Module {
+public:
+    Join(void) : firstInSlot("firstIn", "First input"), secondInSlot("secondIn", "Second input") {
+        this->firstInSlot.SetCompatibleCall<TimedCallDescription>();
+        this->MakeSlotAvailable(&this->firstInSlot);
+        this->secondInSlot.SetCompatibleCall<TimedCallDescription>();
+        this->MakeSlotAvailable(&this->secondInSlot);
+    }
+
+    ~Join(void) override {
+        this->Release();
+    }
+
+    bool Fetch(void) {
+        std::vector<CallScheduler::Request> requests(2);
+        requests[0].call = this->firstInSlot.CallAs<Call>();
+        requests[1].call = this->secondInSlot.CallAs<Call>();
+        return CallScheduler::Run(requests);
+    }
+
+    CallerSlot firstInSlot, secondInSlot;
+
+protected:
+    bool create(void) override {
+        return true;
+    }
+
+    void release(void) override {}
+};
+
+/** Connects a caller slot to a callee slot, like MegaMolGraph::AddCall */
+std::unique_ptr<Call> connect(CallerSlot& caller, CalleeSlot& callee) {
+    auto desc = std::make_shared<TimedCallDescription>();
+    std::unique_ptr<Call> call(desc->CreateCall());
+    if (!callee.ConnectCall(call.get(), desc) || !caller.ConnectCall(call.get())) {
+        return nullptr;
+    }
+    return call;
+}
+
+/**
+ * Runs the two-input graph once.
+ *
+ * @param core          The core instance of the graph.
+ * @param duration      The time each source takes to answer.
+ * @param background    Whether the first source supports background calls.
+ * @param expectOverlap Whether the inputs must overlap.
+ *
+ * @return 'true' if the inputs were executed as expected.
+ */
+bool check(CoreInstance& core, std::chrono::milliseconds duration, bool background, bool expectOverlap) {
+    auto root = std::make_shared<RootModuleNamespace>();
+    root->SetCoreInstance(core);
+    auto join = std::make_shared<Join>();
+    auto first = std::make_shared<SlowSource>(duration, background);
+    auto second = std::make_shared<SlowSource>(duration, true);
+    root->AddChild(join);
+    root->AddChild(first);
+    root->AddChild(second);
+    if (!join->Create() || !first->Create() || !second->Create()) {
+        std::cerr << "Unable to create the modules" << std::endl;
+        return false;
+    }
+    auto firstCall = connect(join->firstInSlot, first->dataOutSlot);
+    auto secondCall = connect(join->secondInSlot, second->dataOutSlot);
+    if (!firstCall || !secondCall) {
+        std::cerr << "Unable to connect the modules" << std::endl;
+        return false;
+    }
+
+    const Clock::time_point start = Clock::now();
+    const bool ok = join->Fetch();
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start);
+
+    const TimedCall& a = dynamic_cast<const TimedCall&>(*firstCall);
+    const TimedCall& b = dynamic_cast<const TimedCall&>(*secondCall);
+    const bool overlap = (a.start < b.end) && (b.start < a.end);
+    const bool firstLocal = (a.thread == std::this_thread::get_id());
+    std::cout << "scheduler " << (CallScheduler::IsEnabled() ? "enabled" : "disabled") << ", "
+              << (background ? "both sources support" : "one source supports") << " background calls: "
+              << elapsed.count() << " ms for two inputs of " << duration.count() << " ms, inputs "
+              << (overlap ? "overlapped" : "ran one after the other") << std::endl;
+
+    join->firstInSlot.SetCleanupMark(true);
+    join->secondInSlot.SetCleanupMark(true);
+    join->firstInSlot.DisconnectCalls();
+    join->secondInSlot.DisconnectCalls();
+    return ok && (overlap == expectOverlap) && (background || firstLocal);
+}
+
+int main(int argc, char* argv[]) {
+    const std::chrono::milliseconds duration((argc > 1) ? std::strtol(argv[1], nullptr, 10) : 200);
+
+    CoreInstance core;
+    CallScheduler::SetEnabled(true);
+    bool ok = check(core, duration, true, true);
+    ok = check(core, duration, false, true) && ok;
+    CallScheduler::SetEnabled(false);
+    ok = check(core, duration, true, false) && ok;
+
+    std::cout << (ok ? "passed" : "FAILED") << std::endl;
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
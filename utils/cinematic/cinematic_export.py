@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+#
+# cinematic_export.py
+#
+# Renders the frames of a CinematicView with several MegaMol processes and
+# checks that the run is complete. Each worker renders a contiguous part of
+# [first, last] into a frame folder named after the run identifier, writes
+# a manifest of its part and quits. The export fails if a worker fails or a
+# frame of the range is missing afterwards.
+#
+#   cinematic_export.py --megamol <megamol> --view <module> --workers <n>
+#                       [--first <frame>] [--last <frame>] [--run-id <id>]
+#                       [--frame-folder <dir>] <project> [<megamol args> ...]
+#
+# MegaMol
+# Copyright (c) 2026, MegaMol Dev Team
+# All rights reserved.
+#
+
+import argparse
+import datetime
+import os
+import subprocess
+import sys
+import tempfile
+
+WORKER_SCRIPT = """\
+local view = "{view}::cinematic::"
+mmSetParamValue(view .. "workerCount", "{count}")
+mmSetParamValue(view .. "workerIndex", "{index}")
+mmSetParamValue(view .. "runId", "{run_id}")
+mmSetParamValue(view .. "frameFolder", [[{folder}]])
+{range}mmSetParamValue(view .. "renderAnim", "click")
+local state = mmGetParamValue(view .. "exportState")
+while (state ~= "Done") and (state ~= "Failed") do
+    mmRenderNextFrame()
+    state = mmGetParamValue(view .. "exportState")
+end
+print("cinematic_export: worker {index} " .. state)
+mmQuit()
+"""
+
+
+def lua_range(args):
+    lines = ""
+    if args.first is not None:
+        lines += 'mmSetParamValue(view .. "firstFrame", "{}")\n'.format(args.first)
+    if args.last is not None:
+        lines += 'mmSetParamValue(view .. "lastFrame", "{}")\n'.format(args.last)
+    return lines
+
+
+def read_manifest(path):
+    """Answer the range and the frame files listed in a worker manifest."""
+    with open(path) as f:
+        first, last = (int(v) for v in f.readline().split())
+        files = {}
+        for line in f:
+            frame, name = line.rstrip("\n").split(" ", 1)
+            files[int(frame)] = name
+    return (first, last), files
+
+
+def check_run(folder, count):
+    """Answer the missing frames of a finished run, or None if the manifests disagree."""
+    ranges = set()
+    files = {}
+    for worker in range(count):
+        path = os.path.join(folder, "frames.worker{}.txt".format(worker))
+        if not os.path.isfile(path):
+            print("Worker {} wrote no manifest to {}".format(worker, folder))
+            return None
+        frame_range, worker_files = read_manifest(path)
+        ranges.add(frame_range)
+        files.update(worker_files)
+    if len(ranges) != 1:
+        print("The workers rendered different frame ranges: {}".format(sorted(ranges)))
+        return None
+    first, last = ranges.pop()
+    missing = []
+    for frame in range(first, last + 1):
+        name = files.get(frame)
+        path = os.path.join(folder, name) if name is not None else None
+        if (path is None) or (not os.path.isfile(path)) or (os.path.getsize(path) == 0):
+            missing.append(frame)
+    print("Checked frames {} to {} in {}".format(first, last, folder))
+    return missing
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Render a CinematicView animation with several MegaMol processes.")
+    parser.add_argument("--megamol", required=True, help="MegaMol executable")
+    parser.add_argument("--view", required=True, help="Name of the CinematicView module, e.g. ::CinematicView_1")
+    parser.add_argument("--workers", type=int, required=True, help="Number of worker processes")
+    parser.add_argument("--first", type=int, help="First frame of the range")
+    parser.add_argument("--last", type=int, help="Last frame of the range")
+    parser.add_argument("--run-id", help="Identifier of the run, defaults to the start time")
+    parser.add_argument("--frame-folder", help="Folder receiving the frames, defaults to frames_<run id>")
+    parser.add_argument("project", help="Project file containing the CinematicView")
+    parser.add_argument("megamol_args", nargs=argparse.REMAINDER, help="Further arguments passed to MegaMol")
+    args = parser.parse_args()
+
+    if args.workers < 1:
+        parser.error("--workers must be at least 1")
+    run_id = args.run_id or datetime.datetime.now().strftime("%Y%m%d-%H%M%S")
+    folder = os.path.abspath(args.frame_folder or "frames_{}".format(run_id))
+    os.makedirs(folder, exist_ok=True)
+    for worker in range(args.workers):
+        stale = os.path.join(folder, "frames.worker{}.txt".format(worker))
+        if os.path.isfile(stale):
+            os.remove(stale)
+
+    with tempfile.TemporaryDirectory() as scripts:
+        workers = []
+        for index in range(args.workers):
+            script = os.path.join(scripts, "worker{}.lua".format(index))
+            with open(script, "w") as f:
+                f.write(WORKER_SCRIPT.format(view=args.view, count=args.workers, index=index, run_id=run_id,
+                                             folder=folder, range=lua_range(args)))
+            command = [args.megamol, args.project, script] + args.megamol_args
+            print("Starting worker {}: {}".format(index, " ".join(command)))
+            workers.append(subprocess.Popen(command))
+
+        failed = [index for index, worker in enumerate(workers) if worker.wait() != 0]
+
+    for index in failed:
+        print("Worker {} exited with code {}".format(index, workers[index].returncode))
+    missing = check_run(folder, args.workers)
+    if missing is None:
+        return 1
+    if missing:
+        print("{} frames are missing: {}".format(len(missing), ", ".join(str(f) for f in missing)))
+        return 1
+    if failed:
+        return 1
+    print("All workers finished, the frames are in {}".format(folder))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,95 @@
+/*
+ * depthcompositor.cpp
+ *
+ * Checks the binary-swap DepthCompositor against a brute-force reference.
+ * Runs with any number of ranks, e.g.:
+ *
+ *   mpirun -np 8 ./depthcompositor 1920 1081
+ *
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include <mpi.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "mmcore/cluster/mpi/DepthCompositor.h"
+
+using megamol::core::cluster::mpi::DepthCompositor;
+
+/**
+ * Generates the image of a rank. The depths are coarse, so many pixels tie
+ * between the ranks, and some pixels are on the far plane, like the pixels
+ * outside the tile of a rank.
+ */
+void makeImage(int rank, size_t count, std::vector<uint32_t>& color, std::vector<float>& depth) {
+    std::mt19937 rng(4711u + static_cast<unsigned int>(rank));
+    color.resize(count);
+    depth.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        color[i] = (static_cast<uint32_t>(rank) << 24) | static_cast<uint32_t>(i & 0xFFFFFF);
+        depth[i] = ((rng() % 8) == 0) ? 1.0f : static_cast<float>(rng() % 16) / 16.0f;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    ::MPI_Init(&argc, &argv);
+    int rank = 0;
+    int size = 0;
+    ::MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    ::MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    const size_t width = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 1920;
+    const size_t height = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 1081;
+    const size_t count = width * height;
+
+    int failed = 0;
+    std::vector<uint32_t> color, refColor, otherColor;
+    std::vector<float> depth, refDepth, otherDepth;
+    for (int root : {0, size - 1}) {
+        makeImage(rank, count, color, depth);
+        if (!DepthCompositor::Composite(MPI_COMM_WORLD, color.data(), depth.data(), count, root)) {
+            std::cerr << "Rank " << rank << ": compositing at root " << root << " failed" << std::endl;
+            failed = 1;
+            continue;
+        }
+        if (rank != root) {
+            continue;
+        }
+
+        // the nearest pixel wins, ties go to the lowest rank
+        makeImage(0, count, refColor, refDepth);
+        for (int r = 1; r < size; ++r) {
+            makeImage(r, count, otherColor, otherDepth);
+            for (size_t i = 0; i < count; ++i) {
+                if (otherDepth[i] < refDepth[i]) {
+                    refColor[i] = otherColor[i];
+                    refDepth[i] = otherDepth[i];
+                }
+            }
+        }
+
+        size_t mismatches = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if ((color[i] != refColor[i]) || (depth[i] != refDepth[i])) {
+                ++mismatches;
+            }
+        }
+        std::cout << size << " ranks, " << width << " x " << height << " pixels, root " << root << ": "
+                  << mismatches << " pixels differ from the reference" << std::endl;
+        if (mismatches > 0) {
+            failed = 1;
+        }
+    }
+
+    int anyFailed = 0;
+    ::MPI_Allreduce(&failed, &anyFailed, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    ::MPI_Finalize();
+    return anyFailed;
+}